@@ -0,0 +1,23 @@
+#ifndef CORE_INC_PRESENTERS_HISTORY_PRESENTER_H
+#define CORE_INC_PRESENTERS_HISTORY_PRESENTER_H
+
+#include "history_view.h"
+#include "input_task.h"
+#include "system_task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct HistoryPresenter HistoryPresenter_t;
+
+HistoryPresenter_t* HistoryPresenter_Init(HistoryView_t *view, HistoryModel_t *history_model);
+void HistoryPresenter_Deinit(HistoryPresenter_t *presenter);
+void HistoryPresenter_HandleEvent(HistoryPresenter_t *presenter, const Input2VPEvent_t *event);
+void HistoryPresenter_Run(HistoryPresenter_t *presenter, uint32_t current_tick);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_PRESENTERS_HISTORY_PRESENTER_H */
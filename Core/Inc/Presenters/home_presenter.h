@@ -13,6 +13,12 @@
 extern "C" {
 #endif
 
+/* Sensor changes the home screen is re-rendered for: the 0.1 degC and the
+   percent it shows, and a day of projected battery life */
+#define HOME_PRESENTER_TEMPERATURE_STEP_CDEG 10U
+#define HOME_PRESENTER_SOC_STEP 1U
+#define HOME_PRESENTER_BATTERY_DAYS_STEP 1U
+
 typedef struct HomePresenter HomePresenter_t;
 
 HomePresenter_t* HomePresenter_Init(HomeView_t *view, SystemModel_t *system_model, ConfigModel_t *config_model, SensorModel_t *sensor_model);
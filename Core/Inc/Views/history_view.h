@@ -0,0 +1,56 @@
+#ifndef CORE_INC_VIEWS_HISTORY_VIEW_H
+#define CORE_INC_VIEWS_HISTORY_VIEW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Plot width in pixels, one column per pixel */
+#define HISTORY_VIEW_COLUMNS 128U
+/** Plot height in pixels, row 0 at the top */
+#define HISTORY_VIEW_ROWS 34U
+/** Rows the temperatures are scaled to; the bottom row shows the valve */
+#define HISTORY_VIEW_PLOT_ROWS (HISTORY_VIEW_ROWS - 2U)
+/** Row value of a column without data */
+#define HISTORY_VIEW_NO_ROW 0xFFU
+
+/**
+ * @typedef HistoryViewColumn_t
+ * @brief One plotted column, already scaled to rows
+ */
+typedef struct
+{
+    uint8_t top_row;     /* Highest temperature, or HISTORY_VIEW_NO_ROW */
+    uint8_t bottom_row;  /* Lowest temperature */
+    uint8_t target_row;  /* Target, or HISTORY_VIEW_NO_ROW off the scale */
+    bool valve;          /* Motor moved in the column */
+} HistoryViewColumn_t;
+
+/**
+ * @typedef HistoryViewData_t
+ * @brief View data for the temperature history screen
+ */
+typedef struct
+{
+    const char *range;   /* "24h", "7d" or "30d" */
+    int16_t min_cdeg;    /* Bottom of the scale */
+    int16_t max_cdeg;    /* Top of the scale */
+    bool empty;          /* Nothing recorded in the range yet */
+    uint32_t revision;   /* Changes whenever the columns change */
+    const HistoryViewColumn_t *columns; /* HISTORY_VIEW_COLUMNS, oldest first */
+} HistoryViewData_t;
+
+typedef struct HistoryView HistoryView_t;
+
+HistoryView_t* HistoryView_Init(void);
+void HistoryView_Deinit(HistoryView_t *view);
+void HistoryView_Render(HistoryView_t *view, const HistoryViewData_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_VIEWS_HISTORY_VIEW_H */
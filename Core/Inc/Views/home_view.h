@@ -21,9 +21,10 @@ typedef struct
     uint8_t slot_end_hour;
     uint8_t slot_end_minute;
     uint8_t battery_percentage;
+    uint16_t battery_days; /* projected battery life, 0 if unknown */
     bool is_off_mode;   /* true if target_temp == 4.5 (OFF) */
     bool is_on_mode;    /* true if target_temp == 30.0 (ON) */
-    int mode;           /* 0 = MODE_AUTO, 1 = MODE_MANUAL */
+    int mode;           /* 0 = MODE_AUTO, 1 = MODE_MANUAL, 3 = window */
 } HomeViewData_t;
 
 typedef struct HomeView HomeView_t;
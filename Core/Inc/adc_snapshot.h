@@ -0,0 +1,80 @@
+/**
+ ******************************************************************************
+ * @file           :  adc_snapshot.h
+ * @brief          :  Sequence-consistent snapshots of the ADC channels
+ *
+ * @details        :  The ADC DMA buffer holds two complete sequences, one
+ *                    per half. While the DMA fills one half, the half and
+ *                    full transfer interrupts publish the other one here,
+ *                    with a sequence number and the kernel tick. Readers
+ *                    copy the latest snapshot without locking: the
+ *                    snapshots alternate between two slots, so the one a
+ *                    reader copies is only overwritten after two further
+ *                    sequences, and the sequence number tells the reader
+ *                    to copy again in that case. A reader never waits for
+ *                    the interrupt and never gets channels of different
+ *                    sequences.
+ *
+ *                    One writer, in interrupt context or with the DMA
+ *                    stopped; any number of task readers.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_ADC_SNAPSHOT_H
+#define CORE_INC_ADC_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Channels of one sequence: VREF, motor, temperature, VBAT */
+#define ADC_SNAPSHOT_CHANNELS 4U
+
+/**
+ * @brief  One complete conversion sequence
+ */
+typedef struct {
+  uint16_t samples[ADC_SNAPSHOT_CHANNELS]; /**< Raw values, channel order */
+  uint32_t sequence; /**< Sequences published before this one */
+  uint32_t tick;     /**< Kernel tick at the end of the sequence */
+} AdcSnapshot_t;
+
+/**
+ * @brief  Forget all snapshots; call before the DMA is started the first
+ *         time
+ */
+void AdcSnapshot_Init(void);
+
+/**
+ * @brief  Publish a completed sequence; DMA interrupt context
+ * @param  samples  ADC_SNAPSHOT_CHANNELS raw values, copied
+ */
+void AdcSnapshot_Publish(const uint16_t *samples);
+
+/**
+ * @brief  Copy the latest snapshot without blocking
+ * @return false if no sequence has completed since AdcSnapshot_Init()
+ */
+bool AdcSnapshot_Read(AdcSnapshot_t *snapshot);
+
+/**
+ * @brief  Copies repeated because two sequences completed during one,
+ *         for diagnostics
+ */
+uint32_t AdcSnapshot_GetRetries(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_ADC_SNAPSHOT_H */
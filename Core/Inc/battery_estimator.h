@@ -0,0 +1,198 @@
+/**
+ ******************************************************************************
+ * @file           :  battery_estimator.h
+ * @brief          :  Load-compensated battery state of charge
+ *
+ * @details        :  The battery voltage sags while the valve motor draws
+ *                    current and recovers for a while after it stops, so
+ *                    reading the alkaline curve (SensorCalc_BatterySoc()) on
+ *                    every sample makes the SoC dip during actuation and
+ *                    jump back afterwards. The estimator instead
+ *                    - reads the curve only from rest voltages, taken with
+ *                      the motor idle and at least
+ *                      BATTERY_ESTIMATOR_RECOVERY_MS after it last ran, and
+ *                      averages them;
+ *                    - learns the internal resistance of the cells from the
+ *                      sag under load: (rest voltage - loaded voltage) /
+ *                      motor current;
+ *                    - counts the charge the motor draws and takes it off the
+ *                      SoC at once, so a run shows up before the cells have
+ *                      recovered;
+ *                    - pulls the counted SoC slowly toward the rest-voltage
+ *                      SoC, and jumps to it only when fresh cells raise it
+ *                      by BATTERY_ESTIMATOR_RESET_STEP or more;
+ *                    - moves the published percent only once the SoC is
+ *                      BATTERY_ESTIMATOR_HYSTERESIS_MPCT away from it.
+ *                    The sensor task publishes the result and projects the
+ *                    battery life from it (energy.h). Integer arithmetic
+ *                    only, like sensor_filter.h.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_BATTERY_ESTIMATOR_H
+#define CORE_INC_BATTERY_ESTIMATOR_H
+
+#include "energy.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def BATTERY_ESTIMATOR_CAPACITY_MAH
+ * @brief Usable capacity of the cells the counted charge is scaled to
+ */
+#ifndef BATTERY_ESTIMATOR_CAPACITY_MAH
+#define BATTERY_ESTIMATOR_CAPACITY_MAH ENERGY_BATTERY_CAPACITY_MAH
+#endif
+
+/**
+ * @def BATTERY_ESTIMATOR_DEFAULT_R_MOHM
+ * @brief Internal resistance assumed until a motor run measured it (two
+ *        fresh alkaline AA cells and contacts)
+ */
+#ifndef BATTERY_ESTIMATOR_DEFAULT_R_MOHM
+#define BATTERY_ESTIMATOR_DEFAULT_R_MOHM 400U
+#endif
+
+/**
+ * @def BATTERY_ESTIMATOR_MIN_LOAD_MA
+ * @brief Smallest motor current the resistance is learned from; below it
+ *        the sag drowns in the conversion noise
+ */
+#ifndef BATTERY_ESTIMATOR_MIN_LOAD_MA
+#define BATTERY_ESTIMATOR_MIN_LOAD_MA 30U
+#endif
+
+/**
+ * @def BATTERY_ESTIMATOR_RECOVERY_MS
+ * @brief Time after a motor run during which the voltage is still
+ *        recovering and not taken as a rest voltage
+ */
+#ifndef BATTERY_ESTIMATOR_RECOVERY_MS
+#define BATTERY_ESTIMATOR_RECOVERY_MS 60000U
+#endif
+
+/**
+ * @def BATTERY_ESTIMATOR_REST_SHIFT
+ * @brief Rest voltage averaging: each sample moves the average by
+ *        1/2^SHIFT of the difference
+ */
+#ifndef BATTERY_ESTIMATOR_REST_SHIFT
+#define BATTERY_ESTIMATOR_REST_SHIFT 2U
+#endif
+
+/**
+ * @def BATTERY_ESTIMATOR_R_SHIFT
+ * @brief Resistance learning: each loaded sample moves the estimate by
+ *        1/2^SHIFT of the difference
+ */
+#ifndef BATTERY_ESTIMATOR_R_SHIFT
+#define BATTERY_ESTIMATOR_R_SHIFT 4U
+#endif
+
+/**
+ * @def BATTERY_ESTIMATOR_SOC_SHIFT
+ * @brief Correction of the counted SoC: each rest sample moves it by
+ *        1/2^SHIFT of its difference to the rest-voltage SoC
+ */
+#ifndef BATTERY_ESTIMATOR_SOC_SHIFT
+#define BATTERY_ESTIMATOR_SOC_SHIFT 4U
+#endif
+
+/**
+ * @def BATTERY_ESTIMATOR_RESET_STEP
+ * @brief Rise of the rest-voltage SoC, in percent, taken as fresh cells
+ */
+#ifndef BATTERY_ESTIMATOR_RESET_STEP
+#define BATTERY_ESTIMATOR_RESET_STEP 20U
+#endif
+
+/**
+ * @def BATTERY_ESTIMATOR_HYSTERESIS_MPCT
+ * @brief Distance of the SoC from the published percent, in thousandths of
+ *        a percent, before the published value follows
+ */
+#ifndef BATTERY_ESTIMATOR_HYSTERESIS_MPCT
+#define BATTERY_ESTIMATOR_HYSTERESIS_MPCT 700U
+#endif
+
+/** Resistance estimates outside this range are measurement errors */
+#define BATTERY_ESTIMATOR_MIN_R_MOHM 50U
+#define BATTERY_ESTIMATOR_MAX_R_MOHM 5000U
+
+/**
+ * @brief  One battery voltage sample
+ */
+typedef struct {
+  uint32_t battery_mv; /**< Measured battery voltage */
+  uint32_t current_ma; /**< Motor current at the same time */
+  uint32_t period_ms;  /**< Time the current sample stands for */
+  bool motor_running;  /**< Motor driven forward or backward */
+} BatteryEstimatorInput_t;
+
+/**
+ * @brief  Estimator state and results
+ */
+typedef struct {
+  uint32_t rest_mv;        /**< Averaged rest voltage */
+  uint32_t loaded_mv;      /**< Last voltage under load */
+  uint32_t r_mohm;         /**< Learned internal resistance */
+  uint32_t soc_mpct;       /**< State of charge in thousandths of percent */
+  uint64_t motor_nc;       /**< Motor charge since init, in nC (uA * ms) */
+  uint64_t pending_nc;     /**< Motor charge not yet taken off the SoC */
+  uint32_t last_load_ms;   /**< Time of the last loaded sample */
+  uint16_t r_samples;      /**< Loaded samples the resistance learned from */
+  uint8_t soc;             /**< Published state of charge in percent */
+  bool loaded;             /**< A motor run has been seen */
+  bool primed;             /**< A rest voltage has been seen */
+} BatteryEstimator_t;
+
+/**
+ * @brief  Start with no rest voltage and the default resistance
+ */
+void BatteryEstimator_Init(BatteryEstimator_t *estimator);
+
+/**
+ * @brief  Take one battery voltage sample into account
+ *
+ * @param  estimator  Estimator state
+ * @param  input      Sample and the motor load at the time
+ * @param  now_ms     Time of the sample
+ * @return Published state of charge in percent (0-100). A first sample
+ *         under load is compensated with the default resistance.
+ */
+uint8_t BatteryEstimator_Update(BatteryEstimator_t *estimator,
+                                const BatteryEstimatorInput_t *input,
+                                uint32_t now_ms);
+
+/**
+ * @brief  Charge left in the cells in microampere-hours
+ */
+uint32_t BatteryEstimator_RemainingUah(const BatteryEstimator_t *estimator);
+
+/**
+ * @brief  Hours the remaining charge lasts at an average current
+ *
+ * @param  estimator   Estimator state
+ * @param  average_ua  Average drain in microamperes
+ * @return Remaining runtime in hours, UINT32_MAX for no drain
+ */
+uint32_t BatteryEstimator_RuntimeHours(const BatteryEstimator_t *estimator,
+                                       uint32_t average_ua);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_BATTERY_ESTIMATOR_H */
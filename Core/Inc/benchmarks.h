@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file           :  benchmarks.h
+ * @brief          :  Micro-benchmarks of the pure firmware kernels
+ *
+ * @details        :  Times the sensor conversions, a full sensor sample
+ *                    through the integer pipeline and through the float
+ *                    chain it replaced, the temperature index helpers,
+ *                    schedule slot search, configuration checksum, roller
+ *                    option generation and display pixel packing with
+ *                    the cycle counter (DWT on target, monotonic clock on the
+ *                    host build) and prints one JSON object per kernel:
+ *                    @code
+ *                    BENCH {"platform":"stm32wb55","kernel":"battery_soc","calls":1201,"cycles":91234,"cycles_per_call":75.970}
+ *                    @endcode
+ *                    Tools/bench_compare.py checks these lines against the
+ *                    baselines in Tools/bench_baseline.json.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_BENCHMARKS_H
+#define CORE_INC_BENCHMARKS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def BENCHMARKS_REPEATS
+ *
+ * @brief  Timed runs per kernel; the fastest run is reported
+ */
+
+/**
+ * @def BENCHMARKS_LOOPS
+ *
+ * @brief  Passes over the input set per timed run
+ *
+ * @details  The host clock is scaled to 32 MHz cycles, so a single pass of
+ *           the short kernels would only measure a few dozen counts there,
+ *           and host runs are disturbed by other processes far more often
+ *           than DWT counts on target.
+ */
+#ifdef MIRATHERM_HOST
+#define BENCHMARKS_REPEATS 31U
+#define BENCHMARKS_LOOPS 100U
+#else
+#define BENCHMARKS_REPEATS 7U
+#define BENCHMARKS_LOOPS 1U
+#endif
+
+/**
+ * @brief  Run every benchmark and print the results
+ *
+ * @details  Works with or without a running scheduler. When the scheduler
+ *           runs, each timed run executes with the scheduler suspended so
+ *           other tasks do not inflate the result (interrupts stay enabled).
+ *
+ * @return Number of benchmarks run
+ */
+uint32_t Benchmarks_Run(void);
+
+/**
+ * @brief  Check the integer sensor pipeline against the float chain it
+ *         replaced
+ *
+ * @details  Runs every conversion code of every channel at VDDA steps of
+ *           100 mV through both chains and prints one JSON object per
+ *           quantity:
+ *           @code
+ *           CHECK {"platform":"host","check":"battery_soc","cases":77824,"mismatches":0}
+ *           @endcode
+ *           Motor current, state of charge and whole-degree temperature
+ *           must match exactly. The battery voltage may exceed the float
+ *           result by 1 mV, which the float chain lost to truncation.
+ *
+ * @return Total number of mismatches
+ */
+uint32_t Benchmarks_Check(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_BENCHMARKS_H */
@@ -0,0 +1,84 @@
+/**
+ ******************************************************************************
+ * @file           :  config_codec.h
+ * @brief          :  Bit-packed serialisation of the configuration
+ *
+ * @details        :  The flash record holds the configuration in this
+ *                    encoding instead of a memory image of ConfigData_t, so
+ *                    it does not depend on the compiler's padding, float
+ *                    format or byte order, and saves program only the bits
+ *                    the values carry. Fields, least significant bit first
+ *                    in each byte:
+ *                      7 bits   temperature offset in signed 0.5 °C steps
+ *                      6 bits   manual target, Utils_TempToIndex() index
+ *                      8 bits   heat-up rate in 5 cdeg/h steps, 0 = none
+ *                      per day, Monday first:
+ *                        3 bits   number of slots - 1
+ *                        6 bits   temperature index of the first slot
+ *                        per further slot:
+ *                          9 bits   start in SCHEDULE_STEP_MIN steps
+ *                          6 bits   temperature index
+ *                    The first slot always starts at midnight, so its start
+ *                    is not stored. The encoding of the default schedule
+ *                    takes 37 bytes, five slots on every day 63.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_CONFIG_CODEC_H
+#define CORE_INC_CONFIG_CODEC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "storage_task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Bytes of the longest encoding (five slots on every day) */
+#define CONFIG_CODEC_MAX_SIZE 63U
+
+/** Temperature offset range in 0.5 °C steps, as the offset editor offers */
+#define CONFIG_CODEC_OFFSET_MAX_STEPS 30
+
+/**
+ * @brief  Encode a configuration
+ * @details Temperatures are rounded to their index and the offset to
+ *          0.5 °C, which loses nothing for the values the editors set, and
+ *          the heat-up rate to 5 cdeg/h. The schedule must pass
+ *          Schedule_IsValid().
+ * @param  buffer  At least CONFIG_CODEC_MAX_SIZE bytes
+ * @return Encoded length in bytes, 0 if the configuration cannot be encoded
+ */
+uint32_t ConfigCodec_Encode(const ConfigData_t *config, uint8_t *buffer,
+                            uint32_t size);
+
+/**
+ * @brief  Decode a configuration
+ * @details The configuration is cleared first, padding included, and only
+ *          written if the whole encoding is valid.
+ * @param  length  Exact length returned by ConfigCodec_Encode()
+ * @return false on a malformed encoding or out-of-range value
+ */
+bool ConfigCodec_Decode(const uint8_t *buffer, uint32_t length,
+                        ConfigData_t *config);
+
+/**
+ * @brief  Checksum of an encoded configuration
+ * @details Byte sum with a rotate-left after every byte.
+ */
+uint32_t ConfigCodec_Checksum(const uint8_t *data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_CONFIG_CODEC_H */
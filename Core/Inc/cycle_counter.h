@@ -0,0 +1,81 @@
+/**
+ ******************************************************************************
+ * @file           :  cycle_counter.h
+ * @brief          :  Core clock cycle counter for profiling
+ *
+ * @details        :  Wraps the Cortex-M4 DWT cycle counter (CYCCNT), which
+ *                    counts core clock cycles and wraps every
+ *                    2^32 / SystemCoreClock seconds. The host build derives an
+ *                    equivalent count from the monotonic clock so profiling
+ *                    code runs unchanged in the simulation.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_CYCLE_COUNTER_H
+#define CORE_INC_CYCLE_COUNTER_H
+
+#include <stdint.h>
+
+#include "stm32wbxx.h"
+
+#ifdef MIRATHERM_HOST
+#include <time.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Enable the DWT cycle counter
+ *
+ * @details  Enables trace in CoreDebug->DEMCR, resets and starts CYCCNT.
+ *           Safe to call more than once. No-op on the host.
+ */
+static inline void CycleCounter_Init(void) {
+#ifndef MIRATHERM_HOST
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U) {
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  }
+#endif
+}
+
+/**
+ * @brief  Read the free-running cycle counter
+ *
+ * @return Core clock cycles (modulo 2^32); use unsigned subtraction for
+ *         intervals shorter than one wrap period
+ */
+static inline uint32_t CycleCounter_Get(void) {
+#ifdef MIRATHERM_HOST
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t ns =
+      (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+  return (uint32_t)(ns * (SystemCoreClock / 1000000U) / 1000U);
+#else
+  return DWT->CYCCNT;
+#endif
+}
+
+/**
+ * @brief  Convert a cycle count to microseconds at the current core clock
+ */
+static inline uint32_t CycleCounter_ToUs(uint32_t cycles) {
+  return cycles / (SystemCoreClock / 1000000U);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_CYCLE_COUNTER_H */
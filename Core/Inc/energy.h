@@ -0,0 +1,290 @@
+/**
+ ******************************************************************************
+ * @file           :  energy.h
+ * @brief          :  Energy accounting and battery-life projection
+ *
+ * @details        :  Charges the battery drain to its sinks from counters the
+ *                    firmware already has at hand:
+ *                    - motor on-time times the measured shunt current,
+ *                    - ADC conversion sequences,
+ *                    - bytes written to the display over I2C,
+ *                    - flash page erases and programmed double-words,
+ *                    - awake and idle time of the CPU (FreeRTOS run-time
+ *                      statistics of the idle task),
+ *                    - a constant base load (regulator, display panel).
+ *                    Every sink but the motor is priced with a tunable
+ *                    constant below; calibrate them once against a bench
+ *                    supply.
+ *
+ *                    The remaining battery life blends two estimates: the
+ *                    charge left at the current state of charge divided by
+ *                    the average current since boot, and the slope of the
+ *                    hourly state-of-charge trend of the last week. The
+ *                    trend gains weight as its window fills, since the SoC
+ *                    of an alkaline cell moves by single percents over days.
+ *
+ *                    The sensor task feeds the counters and updates the
+ *                    projection on every battery measurement; the home
+ *                    screen shows the result and Energy_Report() exports
+ *                    the accounting as a JSON line.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_ENERGY_H
+#define CORE_INC_ENERGY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def ENERGY_BATTERY_CAPACITY_MAH
+ *
+ * @brief  Usable capacity of the battery (two alkaline AA cells in series)
+ */
+#ifndef ENERGY_BATTERY_CAPACITY_MAH
+#define ENERGY_BATTERY_CAPACITY_MAH 2500U
+#endif
+
+/**
+ * @def ENERGY_BASE_UA
+ *
+ * @brief  Constant load in microamperes (regulator, display panel, pull-ups)
+ */
+#ifndef ENERGY_BASE_UA
+#define ENERGY_BASE_UA 150U
+#endif
+
+/**
+ * @def ENERGY_RUN_UA
+ *
+ * @brief  CPU current in microamperes while a task other than idle runs
+ *         (Run mode at 32 MHz)
+ */
+#ifndef ENERGY_RUN_UA
+#define ENERGY_RUN_UA 1800U
+#endif
+
+/**
+ * @def ENERGY_IDLE_UA
+ *
+ * @brief  CPU current in microamperes while the idle task runs
+ *
+ * @details  The idle task spins without WFI today, so idle time costs run
+ *           current. Lower this to the Sleep or Stop mode current once an
+ *           idle hook or tickless idle puts the core to sleep.
+ */
+#ifndef ENERGY_IDLE_UA
+#define ENERGY_IDLE_UA ENERGY_RUN_UA
+#endif
+
+/**
+ * @def ENERGY_ADC_SEQUENCE_US
+ *
+ * @brief  Duration of one ADC sequence in microseconds
+ *
+ * @details  4 channels * (12.5 + 640.5 cycles) * 256 oversampling / 32 MHz,
+ *           see SENSOR_TASK_MIN_SAMPLING_PERIOD_MS.
+ */
+#define ENERGY_ADC_SEQUENCE_US 20896U
+
+/**
+ * @def ENERGY_ADC_SEQUENCE_NC
+ *
+ * @brief  Charge of one ADC sequence in nanocoulombs (about 300 uA for the
+ *         converter, the VREFINT buffer and the temperature sensor)
+ */
+#ifndef ENERGY_ADC_SEQUENCE_NC
+#define ENERGY_ADC_SEQUENCE_NC 6300U
+#endif
+
+/**
+ * @def ENERGY_DISPLAY_BYTE_NC
+ *
+ * @brief  Charge of one I2C byte to the display in nanocoulombs (pull-up
+ *         current and controller write at 1 MHz)
+ */
+#ifndef ENERGY_DISPLAY_BYTE_NC
+#define ENERGY_DISPLAY_BYTE_NC 5U
+#endif
+
+/**
+ * @def ENERGY_FLASH_ERASE_NC
+ *
+ * @brief  Charge of one flash page erase in nanocoulombs (about 7 mA for
+ *         22 ms)
+ */
+#ifndef ENERGY_FLASH_ERASE_NC
+#define ENERGY_FLASH_ERASE_NC 154000U
+#endif
+
+/**
+ * @def ENERGY_FLASH_DWORD_US
+ *
+ * @brief  Time to program one flash double-word in microseconds (typical
+ *         value of the STM32WB55 datasheet)
+ */
+#define ENERGY_FLASH_DWORD_US 82U
+
+/**
+ * @def ENERGY_FLASH_DWORD_NC
+ *
+ * @brief  Charge of programming one flash double-word in nanocoulombs
+ *         (about 7 mA for ENERGY_FLASH_DWORD_US)
+ */
+#ifndef ENERGY_FLASH_DWORD_NC
+#define ENERGY_FLASH_DWORD_NC 574U
+#endif
+
+/**
+ * @def ENERGY_TREND_HOURS
+ *
+ * @brief  Length of the hourly state-of-charge trend window
+ */
+#define ENERGY_TREND_HOURS 168U
+
+/**
+ * @def ENERGY_TREND_MIN_HOURS
+ *
+ * @brief  Trend samples needed before the trend enters the projection
+ */
+#define ENERGY_TREND_MIN_HOURS 12U
+
+/** Largest projection in days; longer projections are clamped */
+#define ENERGY_DAYS_MAX 999U
+
+/** Projection value while no estimate exists yet */
+#define ENERGY_DAYS_UNKNOWN 0U
+
+/**
+ * @brief  Consumers the drain is charged to
+ */
+typedef enum {
+  ENERGY_SINK_BASE = 0, /**< Constant load */
+  ENERGY_SINK_RUN,      /**< CPU running tasks */
+  ENERGY_SINK_IDLE,     /**< CPU in the idle task */
+  ENERGY_SINK_MOTOR,    /**< Valve motor */
+  ENERGY_SINK_ADC,      /**< ADC sequences */
+  ENERGY_SINK_DISPLAY,  /**< I2C transfers to the display */
+  ENERGY_SINK_FLASH,    /**< Flash page erases and programming */
+  ENERGY_SINK_COUNT
+} EnergySink_t;
+
+/**
+ * @brief  Accounting since boot and the latest projection
+ */
+typedef struct {
+  uint32_t elapsed_s;     /**< Time accounted */
+  uint32_t awake_s;       /**< Time spent outside the idle task */
+  uint32_t motor_ms;      /**< Time the motor was driven */
+  uint32_t adc_sequences; /**< ADC conversion sequences */
+  uint32_t display_bytes; /**< Bytes written to the display */
+  uint32_t flash_erases;  /**< Flash page erases */
+  uint32_t flash_dwords;  /**< Flash double-words programmed */
+  uint32_t charge_uah[ENERGY_SINK_COUNT]; /**< Charge drawn per sink */
+  uint32_t average_ua;    /**< Average current since boot */
+  uint8_t soc;            /**< Latest state of charge in percent */
+  uint16_t trend_hours;   /**< Samples in the SoC trend window */
+  uint16_t model_days;    /**< Projection from the average current */
+  uint16_t trend_days;    /**< Projection from the SoC trend (0 if none) */
+  uint16_t days;          /**< Blended projection (ENERGY_DAYS_UNKNOWN) */
+} EnergyStats_t;
+
+/**
+ * @brief  Running totals of the activity counters, for the self-heating
+ *         model (self_heating.h)
+ */
+typedef struct {
+  uint64_t elapsed_ms;    /**< Time accounted */
+  uint64_t awake_ms;      /**< Time spent outside the idle task */
+  uint64_t motor_nc;      /**< Charge drawn by the motor */
+  uint32_t display_bytes; /**< Bytes written to the display */
+} EnergyCounters_t;
+
+/**
+ * @brief  Charge one motor current sample
+ *
+ * @param  current_ma  Measured shunt current
+ * @param  period_ms   Time the sample stands for
+ */
+void Energy_AddMotor(uint32_t current_ma, uint32_t period_ms);
+
+/**
+ * @brief  Count completed ADC conversion sequences
+ */
+void Energy_AddAdcSequences(uint32_t count);
+
+/**
+ * @brief  Count the sequences of a free-running ADC over @p period_ms
+ *
+ * @details  Keeps the remainder, so consecutive periods add up exactly.
+ */
+void Energy_AddAdcRunTime(uint32_t period_ms);
+
+/**
+ * @brief  Count bytes written to the display (callable from any task)
+ */
+void Energy_AddDisplayBytes(uint32_t bytes);
+
+/**
+ * @brief  Count one flash page erase
+ */
+void Energy_AddFlashErase(void);
+
+/**
+ * @brief  Count programmed flash double-words
+ */
+void Energy_AddFlashProgram(uint32_t double_words);
+
+/**
+ * @brief  Account the time since the previous call and update the projection
+ *
+ * @details  Must be called from task context, at least once per run-time
+ *           counter wrap (71 minutes on target); the sensor task calls it on
+ *           every battery measurement. Suspends the scheduler while reading
+ *           the run-time statistics.
+ *
+ * @param  soc  Battery state of charge in percent
+ * @return Remaining battery life in days, or ENERGY_DAYS_UNKNOWN
+ */
+uint16_t Energy_Update(uint8_t soc);
+
+/**
+ * @brief  Read the accounting and the latest projection
+ */
+void Energy_GetStats(EnergyStats_t *stats);
+
+/**
+ * @brief  Read the activity counters as of the last Energy_Update()
+ */
+void Energy_GetCounters(EnergyCounters_t *counters);
+
+/**
+ * @brief  Print the accounting table and its JSON export line
+ *
+ * @details  Output format (charge in uAh since boot):
+ *           @code
+ *           Energy: 86400 s, awake 3%, avg 2370 uA, SoC 87%, 212 days
+ *                   (model 220, trend 205 over 48 h)
+ *           Sink          uAh
+ *           base         3600
+ *           ...
+ *           ENERGY {"elapsed_s":86400,"awake_s":2592,...,"days":212}
+ *           @endcode
+ */
+void Energy_Report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_ENERGY_H */
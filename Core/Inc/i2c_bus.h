@@ -0,0 +1,184 @@
+/**
+ ******************************************************************************
+ * @file           :  i2c_bus.h
+ * @brief          :  Shared I2C bus with queued DMA transactions
+ *
+ * @details        :  All users of hi2c1 go through the bus task instead of
+ *                    calling the blocking HAL functions. A client registers
+ *                    once with a priority and then submits transaction
+ *                    descriptors: one register (or control byte) write or
+ *                    read each. The bus task runs the pending transaction of
+ *                    the highest priority next, in submission order within
+ *                    a priority, with DMA, and signals its completion with
+ *                    thread flags. A client that splits a long transfer
+ *                    (the display writes one page per transaction) thereby
+ *                    lets a more urgent client, e.g. a sensor read, use the
+ *                    bus between its parts.
+ *
+ *                    Bus time, queue wait and bytes are counted per client
+ *                    (I2CBus_GetStats(), I2CBus_Report()).
+ *
+ *                    Descriptors are owned by the caller and must stay
+ *                    valid, with the data they point to, until the
+ *                    transaction has completed.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_I2C_BUS_H
+#define CORE_INC_I2C_BUS_H
+
+#include "cmsis_os2.h"
+#include "stm32wbxx_hal.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define I2C_BUS_TASK_STACK_SIZE (512U * 4U)
+
+/**
+ * @def I2C_BUS_MAX_CLIENTS
+ * @brief Number of clients that can register
+ */
+#ifndef I2C_BUS_MAX_CLIENTS
+#define I2C_BUS_MAX_CLIENTS 4U
+#endif
+
+/**
+ * @def I2C_BUS_TIMEOUT_MS
+ * @brief Time a transaction may take on the bus before it is aborted and
+ *        the peripheral is initialised again; a 1 KB transfer takes about
+ *        10 ms at 1 MHz
+ */
+#ifndef I2C_BUS_TIMEOUT_MS
+#define I2C_BUS_TIMEOUT_MS 50U
+#endif
+
+/**
+ * @def I2C_BUS_FLAG_DONE
+ * @brief Thread flag I2CBus_Transfer() waits for; kept clear of the flags
+ *        the tasks use for their own events
+ */
+#define I2C_BUS_FLAG_DONE 0x8000U
+
+/**
+ * @brief  Client priority; a higher priority transaction runs first
+ */
+typedef enum {
+  I2C_BUS_PRIORITY_HIGH = 0,
+  I2C_BUS_PRIORITY_NORMAL,
+  I2C_BUS_PRIORITY_LOW,
+  I2C_BUS_PRIORITY_COUNT,
+} I2CBusPriority_t;
+
+/**
+ * @brief  Transaction state
+ */
+typedef enum {
+  I2C_BUS_PENDING = 0, /**< Queued or on the bus */
+  I2C_BUS_OK,          /**< Completed */
+  I2C_BUS_ERROR,       /**< NACK, arbitration loss or bus error */
+  I2C_BUS_TIMEOUT,     /**< Not completed within I2C_BUS_TIMEOUT_MS */
+} I2CBusStatus_t;
+
+/**
+ * @brief  One register write or read on the bus
+ */
+typedef struct I2CBusTransaction {
+  int32_t client;        /**< From I2CBus_RegisterClient() */
+  uint16_t dev_addr;     /**< Device address, shifted left as for the HAL */
+  uint8_t mem_addr;      /**< Register or control byte sent first */
+  bool read;             /**< Read @p size bytes instead of writing them */
+  uint8_t *data;         /**< Data to write or buffer to read into */
+  uint16_t size;         /**< Bytes after the register byte */
+  osThreadId_t notify;   /**< Thread to signal on completion, or NULL */
+  uint32_t notify_flags; /**< Flags set on @p notify */
+  volatile I2CBusStatus_t status; /**< Result, set before the signal */
+
+  /* Owned by the bus while the transaction is pending */
+  uint32_t submit_cycles;
+  struct I2CBusTransaction *next;
+} I2CBusTransaction_t;
+
+/**
+ * @brief  Bus usage of one client
+ */
+typedef struct {
+  const char *name;
+  I2CBusPriority_t priority;
+  uint32_t transactions; /**< Completed, including failed ones */
+  uint32_t errors;       /**< Failed or timed out */
+  uint32_t bytes;        /**< Bytes on the bus: address, register, data */
+  uint64_t bus_us;       /**< Time on the bus */
+  uint64_t wait_us;      /**< Time queued behind other transactions */
+  uint32_t max_wait_us;  /**< Longest time queued */
+} I2CBusStats_t;
+
+/**
+ * @brief  Set the bus the task drives; call before the scheduler starts
+ * @param  hi2c  Initialised I2C handle with its DMA channels linked
+ */
+void I2CBus_Init(I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief  Bus task entry point: runs the queued transactions
+ * @param  argument: Unused
+ */
+void StartI2CBusTask(void *argument);
+
+/**
+ * @brief  Register a client
+ * @param  name      Name for the statistics, static storage
+ * @param  priority  Priority of all transactions of the client
+ * @return Client id, or -1 if I2C_BUS_MAX_CLIENTS are registered
+ */
+int32_t I2CBus_RegisterClient(const char *name, I2CBusPriority_t priority);
+
+/**
+ * @brief  Queue a transaction and return
+ *
+ * @details  @p txn->status is I2C_BUS_PENDING until the transaction has
+ *           completed; then @p txn->notify_flags are set on @p txn->notify.
+ *           Task context.
+ * @return false if the descriptor is invalid or the bus is not initialised
+ */
+bool I2CBus_Submit(I2CBusTransaction_t *txn);
+
+/**
+ * @brief  Run a transaction and wait for it
+ *
+ * @details  Waits on I2C_BUS_FLAG_DONE of the calling thread; the bus task
+ *           completes every transaction within I2C_BUS_TIMEOUT_MS of
+ *           starting it. Before the scheduler runs, the transfer is made
+ *           directly in polling mode.
+ * @return Final status of @p txn
+ */
+I2CBusStatus_t I2CBus_Transfer(I2CBusTransaction_t *txn);
+
+/**
+ * @brief  Copy the statistics of one client
+ * @return false for an unknown client
+ */
+bool I2CBus_GetStats(int32_t client, I2CBusStats_t *stats);
+
+/**
+ * @brief  Print the statistics of all clients, as a table and one
+ *         "I2C_BUS {...}" JSON line per client
+ */
+void I2CBus_Report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_I2C_BUS_H */
@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ * @file           :  ipc_profile.h
+ * @brief          :  Contention profiler for model mutexes and event queues
+ *
+ * @details        :  IPC_MUTEX_ACQUIRE, IPC_MUTEX_RELEASE and IPC_QUEUE_PUT
+ *                    wrap the CMSIS-RTOS2 calls used for the config, sensor,
+ *                    system and LVGL mutexes and the inter-task queues. With
+ *                    IPC_PROFILE_ENABLED each call site gets its own static
+ *                    record (registered on first use) collecting:
+ *                    - mutex wait time and hold time (DWT cycles),
+ *                    - failed acquisitions (timeouts),
+ *                    - queue depth high-water mark and dropped puts.
+ *                    IpcProfile_Report() prints all sites over the UART.
+ *
+ *                    Without IPC_PROFILE_ENABLED the macros are the plain
+ *                    CMSIS calls (mutex acquisitions still go through
+ *                    TRACE_MUTEX_ACQUIRE, see trace.h).
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_IPC_PROFILE_H
+#define CORE_INC_IPC_PROFILE_H
+
+#include <stdint.h>
+
+#include "cmsis_os2.h"
+#include "task_debug.h"
+#include "trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def IPC_PROFILE_MAX_MUTEXES
+ *
+ * @brief  Number of distinct mutexes whose holder is tracked for hold time
+ */
+#define IPC_PROFILE_MAX_MUTEXES 8U
+
+typedef enum { IPC_SITE_MUTEX = 0, IPC_SITE_QUEUE_PUT } IpcSiteKind_t;
+
+/**
+ * @brief  Statistics of one call site (static storage inside the macro)
+ */
+typedef struct IpcSite {
+  const char *file;      /**< __FILE__ of the call site */
+  uint32_t line;         /**< __LINE__ of the call site */
+  IpcSiteKind_t kind;    /**< Mutex acquire or queue put */
+  struct IpcSite *next;  /**< Registration list, NULL until first use */
+  uint32_t calls;        /**< Number of calls */
+  uint32_t failures;     /**< Acquire timeouts / dropped puts */
+  uint32_t wait_total;   /**< Sum of wait times (cycles, saturating) */
+  uint32_t wait_max;     /**< Longest wait (cycles) */
+  uint32_t holds;        /**< Completed hold periods (mutex sites) */
+  uint32_t hold_total;   /**< Sum of hold times (cycles, saturating) */
+  uint32_t hold_max;     /**< Longest hold (cycles) */
+  uint32_t depth_max;    /**< Queue depth high-water after a put */
+  uint32_t capacity;     /**< Queue capacity */
+  uint8_t registered;    /**< Non-zero once linked into the site list */
+} IpcSite_t;
+
+#define IPC_SITE_INIT(site_kind)                                               \
+  {.file = __FILE__, .line = __LINE__, .kind = (site_kind)}
+
+#if IPC_PROFILE_ENABLED
+
+osStatus_t IpcProfile_MutexAcquire(IpcSite_t *site, osMutexId_t mutex,
+                                   uint32_t timeout);
+osStatus_t IpcProfile_MutexRelease(osMutexId_t mutex);
+osStatus_t IpcProfile_QueuePut(IpcSite_t *site, osMessageQueueId_t queue,
+                               const void *msg, uint8_t prio,
+                               uint32_t timeout);
+
+/**
+ * @brief  Print the statistics of every call site used so far
+ *
+ * @details  Output format (times in microseconds, totals since boot):
+ *           @code
+ *           IPC site                       calls  fail wait avg/max  hold avg/max  depth
+ *           home_presenter.c:56             1021     3     2/   310     41/   95
+ *           input_task.c:66                  312     0     0/     0          -  3/8
+ *           @endcode
+ *           The depth column of queue sites shows the high-water mark and
+ *           the capacity; fail counts dropped puts there.
+ */
+void IpcProfile_Report(void);
+
+#define IPC_MUTEX_ACQUIRE(mutex, timeout)                                      \
+  __extension__({                                                              \
+    static IpcSite_t ipc_site_ = IPC_SITE_INIT(IPC_SITE_MUTEX);                \
+    IpcProfile_MutexAcquire(&ipc_site_, (mutex), (timeout));                   \
+  })
+#define IPC_MUTEX_RELEASE(mutex) IpcProfile_MutexRelease((mutex))
+#define IPC_QUEUE_PUT(queue, msg, prio, timeout)                               \
+  __extension__({                                                              \
+    static IpcSite_t ipc_site_ = IPC_SITE_INIT(IPC_SITE_QUEUE_PUT);            \
+    IpcProfile_QueuePut(&ipc_site_, (queue), (msg), (prio), (timeout));        \
+  })
+
+#else
+
+#define IPC_MUTEX_ACQUIRE(mutex, timeout) TRACE_MUTEX_ACQUIRE((mutex), (timeout))
+#define IPC_MUTEX_RELEASE(mutex) osMutexRelease((mutex))
+#define IPC_QUEUE_PUT(queue, msg, prio, timeout)                               \
+  osMessageQueuePut((queue), (msg), (prio), (timeout))
+
+#endif /* IPC_PROFILE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_IPC_PROFILE_H */
@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * @file           :  log_task.h
+ * @brief          :  Deferred binary logging
+ *
+ * @details        :  DLOG() stores a pointer to its format string plus the
+ *                    raw argument words in a lock-free ring and returns; no
+ *                    formatting or UART output happens in the caller. The
+ *                    low-priority log task drains the ring every
+ *                    LOG_TASK_PERIOD_MS and either formats the messages
+ *                    (same text as printf) or, with DEFERRED_LOG_BINARY, emits
+ *                    compact "DL" lines that Tools/dlog_decode.py turns back
+ *                    into text using the firmware ELF.
+ *
+ *                    Arguments are captured as machine words: integers and
+ *                    pointers as-is, float/double as 32-bit float. %s
+ *                    arguments must point to strings that outlive the call
+ *                    (string literals or other constant data).
+ *
+ *                    With DEFERRED_LOG_ENABLED = 0, DLOG() is plain printf().
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_LOG_TASK_H
+#define CORE_INC_LOG_TASK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "task_debug.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOG_TASK_STACK_SIZE (512U * 4U)
+
+/** Ring capacity in messages (power of two) */
+#define LOG_TASK_QUEUE_LEN 32U
+
+/** Maximum number of arguments per message */
+#define LOG_TASK_MAX_ARGS 6U
+
+/** Drain period of the log task */
+#define LOG_TASK_PERIOD_MS 20U
+
+/**
+ * @brief  Log task entry point, drains the ring periodically
+ * @param  argument: Unused
+ */
+void StartLogTask(void *argument);
+
+/**
+ * @brief  Queue one message (task or ISR context, never blocks)
+ *
+ * @param  fmt    printf format string with static storage duration
+ * @param  nargs  Number of argument words in @p args
+ * @param  args   Argument words (see DLOG_ARG)
+ * @return false if the ring was full and the message was dropped
+ */
+bool LogTask_Write(const char *fmt, uint32_t nargs, const uintptr_t *args);
+
+/**
+ * @brief  Output all queued messages from the calling task
+ *
+ * @details  Use before a reset or halt. Returns immediately if the log task
+ *           is draining at the same time.
+ */
+void LogTask_Flush(void);
+
+/* Argument capture ---------------------------------------------------------*/
+static inline uintptr_t LogTask_ArgFloat(double value) {
+  const union {
+    float f;
+    uint32_t u;
+  } bits = {.f = (float)value};
+  return (uintptr_t)bits.u;
+}
+
+static inline uintptr_t LogTask_ArgPointer(const volatile void *value) {
+  return (uintptr_t)value;
+}
+
+static inline uintptr_t LogTask_ArgInteger(uintptr_t value) { return value; }
+
+/** Convert one DLOG argument to a machine word */
+#define DLOG_ARG(x)                                                            \
+  _Generic((x),                                                                \
+      float: LogTask_ArgFloat,                                                 \
+      double: LogTask_ArgFloat,                                                \
+      char *: LogTask_ArgPointer,                                              \
+      const char *: LogTask_ArgPointer,                                        \
+      void *: LogTask_ArgPointer,                                              \
+      const void *: LogTask_ArgPointer,                                        \
+      default: LogTask_ArgInteger)(x)
+
+#define DLOG_NARGS(...) DLOG_NARGS_(_, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(_, a1, a2, a3, a4, a5, a6, n, ...) n
+#define DLOG_CAT(a, b) DLOG_CAT_(a, b)
+#define DLOG_CAT_(a, b) a##b
+#define DLOG_ARGS_0()
+#define DLOG_ARGS_1(a) , DLOG_ARG(a)
+#define DLOG_ARGS_2(a, ...) , DLOG_ARG(a) DLOG_ARGS_1(__VA_ARGS__)
+#define DLOG_ARGS_3(a, ...) , DLOG_ARG(a) DLOG_ARGS_2(__VA_ARGS__)
+#define DLOG_ARGS_4(a, ...) , DLOG_ARG(a) DLOG_ARGS_3(__VA_ARGS__)
+#define DLOG_ARGS_5(a, ...) , DLOG_ARG(a) DLOG_ARGS_4(__VA_ARGS__)
+#define DLOG_ARGS_6(a, ...) , DLOG_ARG(a) DLOG_ARGS_5(__VA_ARGS__)
+
+#if DEFERRED_LOG_ENABLED
+/**
+ * @brief  printf-compatible deferred log call (at most LOG_TASK_MAX_ARGS
+ *         arguments)
+ */
+#define DLOG(fmt, ...)                                                         \
+  ((void)LogTask_Write(                                                        \
+      (fmt), DLOG_NARGS(__VA_ARGS__),                                          \
+      &((const uintptr_t[]){0U DLOG_CAT(DLOG_ARGS_, DLOG_NARGS(__VA_ARGS__))(  \
+          __VA_ARGS__)})[1]))
+#define DLOG_FLUSH() LogTask_Flush()
+#else
+#define DLOG(...) ((void)printf(__VA_ARGS__))
+#define DLOG_FLUSH() ((void)0)
+#endif /* DEFERRED_LOG_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_LOG_TASK_H */
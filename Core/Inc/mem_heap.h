@@ -0,0 +1,175 @@
+/**
+ ******************************************************************************
+ * @file           :  mem_heap.h
+ * @brief          :  Unified TLSF heap for FreeRTOS, LVGL and the application
+ *
+ * @details        :  One two-level segregated fit allocator serves:
+ *                    - the FreeRTOS port allocator (pvPortMalloc/vPortFree:
+ *                      task stacks, TCBs, queues, mutexes),
+ *                    - LVGL (LV_MEM_CUSTOM in lv_conf.h),
+ *                    - malloc/free of the presenters, views and newlib
+ *                      (target build only; the host build keeps the C
+ *                      library allocator for the application).
+ *                    Allocation and free are O(1); blocks are 8-byte
+ *                    aligned and carry a two-word header with the owner.
+ *
+ *                    Every block is charged to its owner, so the current and
+ *                    peak usage of each owner, the largest free block, the
+ *                    fragmentation and the peak usage per UI route can be
+ *                    reported. The route is set by the router on every
+ *                    transition; since the next screen is created before
+ *                    the previous one is torn down, a route's peak includes
+ *                    the transition into it.
+ *
+ *                    Replaces heap_4.c (configTOTAL_HEAP_SIZE is unused) and
+ *                    the LVGL LV_MEM_SIZE pool.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_MEM_HEAP_H
+#define CORE_INC_MEM_HEAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def MEM_HEAP_SIZE
+ *
+ * @brief  Size of the unified heap in bytes
+ *
+ * @details  Sum of the former FreeRTOS heap (48 KB) and LVGL pool (16 KB).
+ *           Tune it from the route peaks printed by MemHeap_Report(). The
+ *           host build uses 1 MB since its stacks and kernel objects are
+ *           built from 64-bit words.
+ */
+#ifndef MEM_HEAP_SIZE
+#ifdef MIRATHERM_HOST
+#define MEM_HEAP_SIZE (1024U * 1024U)
+#else
+#define MEM_HEAP_SIZE (64U * 1024U)
+#endif
+#endif
+
+/** Number of route slots in the per-route peak table */
+#define MEM_HEAP_MAX_ROUTES 16U
+
+/**
+ * @brief  Owner a block is charged to
+ */
+typedef enum {
+  MEM_OWNER_RTOS = 0, /**< pvPortMalloc (kernel objects, task stacks) */
+  MEM_OWNER_LVGL,     /**< lv_mem_alloc (widgets, styles, draw buffers) */
+  MEM_OWNER_APP,      /**< malloc (presenters, views, newlib) */
+  MEM_OWNER_COUNT
+} MemOwner_t;
+
+/**
+ * @brief  Usage of one owner (bytes include the block headers)
+ */
+typedef struct {
+  uint32_t current;  /**< Bytes allocated now */
+  uint32_t peak;     /**< Highest value of current since boot */
+  uint32_t allocs;   /**< Successful allocations */
+  uint32_t frees;    /**< Frees */
+  uint32_t failures; /**< Failed allocations */
+} MemOwnerStats_t;
+
+/**
+ * @brief  Heap-wide figures
+ */
+typedef struct {
+  uint32_t total;             /**< Usable heap size */
+  uint32_t free;              /**< Bytes not allocated */
+  uint32_t min_free;          /**< Lowest value of free since boot */
+  uint32_t largest_free;      /**< Largest allocation that would succeed */
+  uint32_t smallest_free;     /**< Smallest free block */
+  uint32_t free_blocks;       /**< Number of free blocks */
+  uint32_t fragmentation_pct; /**< 100 * (1 - largest_free / free) */
+} MemHeapStats_t;
+
+/**
+ * @brief  Allocate from the unified heap
+ *
+ * @details  Must not be called from an ISR. Takes the heap lock by
+ *           suspending the scheduler, like heap_4.
+ *
+ * @param  size   Requested size in bytes
+ * @param  owner  Owner the block is charged to
+ * @return 8-byte aligned block, or NULL if size is 0 or no block fits
+ */
+void *MemHeap_Alloc(size_t size, MemOwner_t owner);
+
+/**
+ * @brief  Return a block to the unified heap (NULL is ignored)
+ */
+void MemHeap_Free(void *ptr);
+
+/**
+ * @brief  Resize a block, in place when the following block is free
+ *
+ * @param  ptr    Block to resize, or NULL to allocate
+ * @param  size   New size in bytes, 0 to free
+ * @param  owner  Owner of a new block (an existing block keeps its owner)
+ * @return Resized block, or NULL on failure (ptr is then still valid)
+ */
+void *MemHeap_Realloc(void *ptr, size_t size, MemOwner_t owner);
+
+/**
+ * @brief  Read the heap-wide figures
+ */
+void MemHeap_GetStats(MemHeapStats_t *stats);
+
+/**
+ * @brief  Read the usage of one owner
+ */
+void MemHeap_GetOwnerStats(MemOwner_t owner, MemOwnerStats_t *stats);
+
+/**
+ * @brief  Charge subsequent peaks to a UI route
+ *
+ * @param  route  Route index (RouteTypeDef), ignored if >= MEM_HEAP_MAX_ROUTES
+ * @param  name   Route name for the report (static storage)
+ */
+void MemHeap_SetRoute(uint32_t route, const char *name);
+
+/**
+ * @brief  Print the owner, fragmentation and per-route peak tables
+ *
+ * @details  Output format (bytes):
+ *           @code
+ *           Heap: 65528 total, 27312 free (min 25104), largest 26880, 3 blocks, frag 1%
+ *           Owner       current     peak  allocs   frees  fail
+ *           rtos          24896    24896      38       0     0
+ *           lvgl          11032    13440    1530    1392     0
+ *           app            2288     3104      61      44     0
+ *           Route            peak     rtos     lvgl      app
+ *           HOME            40424    24896    13440     2112
+ *           @endcode
+ */
+void MemHeap_Report(void);
+
+/* LVGL hooks (LV_MEM_CUSTOM_ALLOC / _FREE / _REALLOC) ----------------------*/
+static inline void *MemHeap_LvglAlloc(size_t size) {
+  return MemHeap_Alloc(size, MEM_OWNER_LVGL);
+}
+
+static inline void *MemHeap_LvglRealloc(void *ptr, size_t size) {
+  return MemHeap_Realloc(ptr, size, MEM_OWNER_LVGL);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_MEM_HEAP_H */
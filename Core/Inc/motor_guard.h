@@ -0,0 +1,145 @@
+/**
+ ******************************************************************************
+ * @file           :  motor_guard.h
+ * @brief          :  Motor overcurrent and stall cut-off
+ *
+ * @details        :  Checks every motor current sample while the motor is
+ *                    driven and reports when it has to be stopped:
+ *                    - overcurrent: a single sample at or above limit_ma
+ *                      (short circuit, driver fault);
+ *                    - stall: samples at or above stall_ma for debounce_us
+ *                      without a break, e.g. the pin on the valve seat.
+ *                    A DC motor draws its stall current while it starts, so
+ *                    the stall check is blanked for blanking_us after each
+ *                    start. The sensor task feeds it from the DMA interrupt
+ *                    of each ADC sequence and brakes the motor there
+ *                    (SensorTask_SetMotorGuardOwner()). Integer arithmetic
+ *                    and no RTOS calls, so it is safe in interrupt context.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_MOTOR_GUARD_H
+#define CORE_INC_MOTOR_GUARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def MOTOR_GUARD_STALL_MA
+ * @brief Current above the running current of the valve drive that means
+ *        the motor is blocked
+ */
+#ifndef MOTOR_GUARD_STALL_MA
+#define MOTOR_GUARD_STALL_MA 150U
+#endif
+
+/**
+ * @def MOTOR_GUARD_LIMIT_MA
+ * @brief Current the motor is cut off at without debouncing or blanking
+ */
+#ifndef MOTOR_GUARD_LIMIT_MA
+#define MOTOR_GUARD_LIMIT_MA 500U
+#endif
+
+/**
+ * @def MOTOR_GUARD_DEBOUNCE_US
+ * @brief Time from the first to the last of the samples above the stall
+ *        threshold that trip it; shorter peaks (commutation, gear
+ *        backlash) are ignored
+ */
+#ifndef MOTOR_GUARD_DEBOUNCE_US
+#define MOTOR_GUARD_DEBOUNCE_US 2500U
+#endif
+
+/**
+ * @def MOTOR_GUARD_BLANKING_US
+ * @brief Time after a start during which the inrush current is not taken
+ *        as a stall
+ */
+#ifndef MOTOR_GUARD_BLANKING_US
+#define MOTOR_GUARD_BLANKING_US 50000U
+#endif
+
+/**
+ * @brief  Why the motor was cut off
+ */
+typedef enum {
+  MOTOR_GUARD_OK = 0,      /**< Not tripped */
+  MOTOR_GUARD_STALL,       /**< Stall current for the debounce time */
+  MOTOR_GUARD_OVERCURRENT, /**< A sample at the hard limit */
+} MotorGuardReason_t;
+
+/**
+ * @brief  Thresholds; a threshold of 0 disables its check
+ */
+typedef struct {
+  uint16_t stall_ma;    /**< Stall threshold */
+  uint16_t limit_ma;    /**< Hard limit */
+  uint32_t debounce_us; /**< Time above the stall threshold to trip */
+  uint32_t blanking_us; /**< Stall check blanked after a start */
+} MotorGuardConfig_t;
+
+/**
+ * @brief  Guard state of one motor run
+ */
+typedef struct {
+  MotorGuardConfig_t config;
+  uint32_t run_us;           /**< Time since the start, saturating */
+  uint32_t over_us;          /**< Time above the stall threshold */
+  bool sampled;              /**< A sample of this run has been seen */
+  bool over;                 /**< The last sample was above it */
+  MotorGuardReason_t reason; /**< Trip of this run, sticky until a start */
+} MotorGuard_t;
+
+/**
+ * @brief  Set the thresholds and wait for a start
+ * @param  guard   Guard state
+ * @param  config  Thresholds, NULL for the MOTOR_GUARD_* defaults
+ */
+void MotorGuard_Init(MotorGuard_t *guard, const MotorGuardConfig_t *config);
+
+/**
+ * @brief  Replace the thresholds; the state of the run is kept
+ */
+void MotorGuard_SetConfig(MotorGuard_t *guard,
+                          const MotorGuardConfig_t *config);
+
+/**
+ * @brief  The motor was started or reversed: blank the stall check again
+ *         and clear a trip
+ */
+void MotorGuard_Start(MotorGuard_t *guard);
+
+/**
+ * @brief  Check one current sample of a driven motor
+ *
+ * @param  guard       Guard state
+ * @param  current_ma  Motor current
+ * @param  dt_us       Time since the previous sample
+ * @return Reason to cut the motor off, MOTOR_GUARD_OK to keep it running.
+ *         Reported once per run; later samples return MOTOR_GUARD_OK.
+ */
+MotorGuardReason_t MotorGuard_Update(MotorGuard_t *guard, uint32_t current_ma,
+                                     uint32_t dt_us);
+
+/**
+ * @brief  Short name of a reason for logs
+ */
+const char *MotorGuard_ReasonName(MotorGuardReason_t reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_MOTOR_GUARD_H */
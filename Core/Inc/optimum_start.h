@@ -0,0 +1,175 @@
+/**
+ ******************************************************************************
+ * @file           :  optimum_start.h
+ * @brief          :  Learned preheating ahead of schedule transitions
+ *
+ * @details        :  A slot of the schedule gives the temperature the room
+ *                    should have when the slot starts, but the radiator only
+ *                    starts heating when it does, so the room is cold for
+ *                    the first part of every warmer slot. Optimum start
+ *                    raises the target early by the time the room needs to
+ *                    heat up, predicted from a heat-up rate in 0.01 °C per
+ *                    hour:
+ *                      lead = (next target - ambient) / rate
+ *
+ *                    The rate is learned from the heat-ups the device sees:
+ *                    whenever the effective target rises at least
+ *                    OPTIMUM_START_MIN_RISE_CDEG above the room, the rise
+ *                    and time until the room comes within
+ *                    OPTIMUM_START_REACHED_CDEG of the target give one
+ *                    measurement, folded into the rate with an exponential
+ *                    average. The system state machine stores the rate in
+ *                    the configuration, so it survives a power cycle.
+ *                    Integer arithmetic and no RTOS calls.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_OPTIMUM_START_H
+#define CORE_INC_OPTIMUM_START_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "schedule.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def OPTIMUM_START_DEFAULT_RATE_CDEG_H
+ * @brief Heat-up rate used until the first measurement, in 0.01 °C per
+ *        hour; a radiator in a living room typically manages 1-3 °C/h
+ */
+#ifndef OPTIMUM_START_DEFAULT_RATE_CDEG_H
+#define OPTIMUM_START_DEFAULT_RATE_CDEG_H 200U
+#endif
+
+/**
+ * @def OPTIMUM_START_MIN_RATE_CDEG_H
+ * @brief Lowest rate a measurement is clamped to, which bounds the lead
+ */
+#ifndef OPTIMUM_START_MIN_RATE_CDEG_H
+#define OPTIMUM_START_MIN_RATE_CDEG_H 25U
+#endif
+
+/**
+ * @def OPTIMUM_START_MAX_RATE_CDEG_H
+ * @brief Highest rate a measurement is clamped to; must fit the 8-bit
+ *        field of the configuration encoding (5 cdeg/h steps)
+ */
+#ifndef OPTIMUM_START_MAX_RATE_CDEG_H
+#define OPTIMUM_START_MAX_RATE_CDEG_H 1275U
+#endif
+
+/**
+ * @def OPTIMUM_START_MAX_LEAD_MIN
+ * @brief Longest time a transition is moved forward, in minutes
+ */
+#ifndef OPTIMUM_START_MAX_LEAD_MIN
+#define OPTIMUM_START_MAX_LEAD_MIN 180U
+#endif
+
+/**
+ * @def OPTIMUM_START_MIN_RISE_CDEG
+ * @brief Smallest heat-up that is measured; smaller steps are dominated by
+ *        the sensor's resolution and the valve's dead time
+ */
+#ifndef OPTIMUM_START_MIN_RISE_CDEG
+#define OPTIMUM_START_MIN_RISE_CDEG 50
+#endif
+
+/**
+ * @def OPTIMUM_START_REACHED_CDEG
+ * @brief Distance below the target at which a heat-up counts as done; the
+ *        valve closes gradually over the last part of the rise
+ */
+#ifndef OPTIMUM_START_REACHED_CDEG
+#define OPTIMUM_START_REACHED_CDEG 20
+#endif
+
+/**
+ * @def OPTIMUM_START_MAX_MEASURE_MIN
+ * @brief Heat-ups taking longer are abandoned (window open, radiator off)
+ */
+#ifndef OPTIMUM_START_MAX_MEASURE_MIN
+#define OPTIMUM_START_MAX_MEASURE_MIN 360U
+#endif
+
+/**
+ * @def OPTIMUM_START_LEARN_SHIFT
+ * @brief Weight of a new measurement in the rate, 1 / 2^shift
+ */
+#ifndef OPTIMUM_START_LEARN_SHIFT
+#define OPTIMUM_START_LEARN_SHIFT 2U
+#endif
+
+/**
+ * @brief  Learned rate and the heat-up being measured
+ */
+typedef struct {
+  uint16_t rate_cdeg_h;     /**< Learned rate, 0 = none yet */
+  bool primed;              /**< last_target_cdeg holds a target */
+  bool measuring;           /**< A heat-up is being measured */
+  int32_t last_target_cdeg; /**< Effective target of the last call */
+  int32_t start_cdeg;       /**< Room temperature when it started */
+  uint32_t start_ms;        /**< Time the heat-up started */
+  bool preheating;          /**< Heating for the transition below */
+  uint16_t preheat_key;     /**< Minute of the week of that transition */
+} OptimumStart_t;
+
+/**
+ * @brief  Start from a stored rate
+ * @param  rate_cdeg_h  Rate from the configuration, 0 if none was learned
+ */
+void OptimumStart_Init(OptimumStart_t *model, uint16_t rate_cdeg_h);
+
+/**
+ * @brief  Rate the lead is predicted with: the learned one, else
+ *         OPTIMUM_START_DEFAULT_RATE_CDEG_H
+ */
+uint16_t OptimumStart_GetRate(const OptimumStart_t *model);
+
+/**
+ * @brief  Minutes the room needs to heat up to a target
+ * @return 0 if the room is already there, at most
+ *         OPTIMUM_START_MAX_LEAD_MIN
+ */
+uint32_t OptimumStart_LeadMinutes(const OptimumStart_t *model,
+                                  int32_t ambient_cdeg, int32_t target_cdeg);
+
+/**
+ * @brief  Check whether to heat to the next slot's target already
+ * @details True if the next change of target is upward, to a temperature
+ *          rather than ON, and no further away than the lead it needs.
+ *          Once true it stays so until that transition, as the lead shrinks
+ *          while the room warms.
+ * @param  state  Result of Schedule_Evaluate() for now
+ */
+bool OptimumStart_ShouldPreheat(OptimumStart_t *model,
+                                const ScheduleState_t *state,
+                                int32_t ambient_cdeg);
+
+/**
+ * @brief  Feed the room temperature and effective target
+ * @details Call periodically. A rise of the target starts a measurement,
+ *          any other change of the target abandons it.
+ * @param  now_ms  Free-running millisecond time, may wrap
+ * @return true if a measurement completed and the rate changed, so the
+ *         caller can store it
+ */
+bool OptimumStart_Observe(OptimumStart_t *model, uint32_t now_ms,
+                          int32_t ambient_cdeg, int32_t target_cdeg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_OPTIMUM_START_H */
@@ -0,0 +1,261 @@
+/**
+ ******************************************************************************
+ * @file           :  replay.h
+ * @brief          :  Deterministic record/replay of inputs, ADC samples, RTC
+ *                    reads, activity and the loaded configuration
+ *
+ * @details        :  The recorder appends every input event posted to the
+ *                    view presenter, every ADC sequence the sensor task
+ *                    publishes from, the activity behind every temperature
+ *                    sample, every RTC read whose minute changed and the
+ *                    configuration loaded at boot to a byte ring. The
+ *                    ring is drained as a compact binary trace: over the UART
+ *                    as "RPL" hex lines on target (REPLAY_RECORD_ENABLED,
+ *                    see Tools/replay_tool.py) or into a file by the host
+ *                    build (--record).
+ *
+ *                    The host build replays a trace with --replay: the same
+ *                    hooks then substitute the recorded values at their
+ *                    recorded kernel ticks, time advances only while all
+ *                    tasks are blocked, and the cost of every replayed event
+ *                    is reported at the end of the trace.
+ *
+ *                    Trace layout (little-endian):
+ *                    - header: magic "MTRP", version (u16), size of
+ *                      ConfigData_t (u16), kernel tick rate in Hz (u32),
+ *                    - records: type (u8), ticks since the previous record
+ *                      (u16), payload of a size fixed by the type.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_REPLAY_H
+#define CORE_INC_REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cycle_counter.h"
+#include "input_task.h"
+#include "main.h"
+#include "self_heating.h"
+#include "storage_task.h"
+#include "task_debug.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define REPLAY_MAGIC 0x5052544DUL /* "MTRP" */
+#define REPLAY_VERSION 2U
+#define REPLAY_HEADER_SIZE 12U
+#define REPLAY_RECORD_HEADER_SIZE 3U
+
+/**
+ * @def REPLAY_BUFFER_SIZE
+ *
+ * @brief  Size of the recording ring in bytes (power of two)
+ *
+ * @details  On target the default task drains the ring once per report
+ *           period; an ADC sample every 100 ms while the motor runs takes
+ *           about 6.6 KB per minute. Records that do not fit are dropped and
+ *           the loss is marked in the trace. The host drains it every tick.
+ */
+#ifndef REPLAY_BUFFER_SIZE
+#ifdef MIRATHERM_HOST
+#define REPLAY_BUFFER_SIZE (64U * 1024U)
+#else
+#define REPLAY_BUFFER_SIZE (8U * 1024U)
+#endif
+#endif
+
+/** ADC words per sample, the sensor task's conversion sequence */
+#define REPLAY_ADC_CHANNELS 4U
+
+/* The host build can always record and replay */
+#if REPLAY_RECORD_ENABLED || defined(MIRATHERM_HOST)
+#define REPLAY_HOOKS_ENABLED 1
+#else
+#define REPLAY_HOOKS_ENABLED 0
+#endif
+
+/**
+ * @brief  Record types and their payloads
+ */
+typedef enum {
+  REPLAY_REC_INPUT = 1, /**< type, action (u8), delta (i16), age (u16) */
+  REPLAY_REC_ADC,       /**< REPLAY_ADC_CHANNELS raw conversions (u16) */
+  REPLAY_REC_RTC,       /**< h, min, s, weekday, day, month, year (u8) */
+  REPLAY_REC_CONFIG,    /**< valid (u8), ConfigData_t as stored */
+  REPLAY_REC_TICK,      /**< absolute kernel tick (u32), for long gaps */
+  REPLAY_REC_DROP,      /**< bytes lost to a full ring before this (u32) */
+  REPLAY_REC_ACTIVITY   /**< period_ms (u32), cpu_permille, display_bps,
+                             motor_ma (u16) */
+} ReplayRecordType_t;
+
+/**
+ * @brief  Event classes whose processing cost is reported by a replay
+ */
+typedef enum {
+  REPLAY_COST_LEFT = EVT_LEFT_BTN,
+  REPLAY_COST_MIDDLE = EVT_MIDDLE_BTN,
+  REPLAY_COST_RIGHT = EVT_RIGHT_BTN,
+  REPLAY_COST_WHEEL = EVT_CTRL_WHEEL_DELTA,
+  REPLAY_COST_SENSOR,
+  REPLAY_COST_COUNT
+} ReplayCost_t;
+
+#if REPLAY_HOOKS_ENABLED
+
+/**
+ * @brief  Start recording (idempotent)
+ *
+ * @details  Writes the trace header into the ring. Call before the scheduler
+ *           starts so the configuration and the first events are captured.
+ */
+void Replay_StartRecording(void);
+
+/**
+ * @brief  Move recorded trace bytes out of the ring
+ *
+ * @return Number of bytes copied to @p dst
+ */
+uint32_t Replay_ReadRecording(uint8_t *dst, uint32_t size);
+
+/**
+ * @brief  Print the recorded bytes not yet drained as "RPL <hex>" lines
+ */
+void Replay_Dump(void);
+
+/**
+ * @brief  Replay a trace (kept by reference, must outlive the replay)
+ *
+ * @return false if the header or a record is malformed
+ */
+bool Replay_Load(const uint8_t *data, uint32_t size);
+
+/** True while a trace is loaded */
+bool Replay_IsActive(void);
+
+/** Kernel tick of the last record of the loaded trace */
+uint32_t Replay_GetEndTick(void);
+
+/**
+ * @brief  Read the ADC records of the loaded trace in order, ignoring time
+ *
+ * @details  For offline analysis of a trace without running the firmware
+ *           (the host's --filter-eval). Independent of the replay hooks.
+ *
+ * @param  tick     Kernel tick the sequence was recorded at
+ * @param  samples  Recorded sequence
+ * @return false after the last ADC record
+ */
+bool Replay_ScanAdc(uint32_t *tick, uint16_t samples[REPLAY_ADC_CHANNELS]);
+
+/**
+ * @brief  Read the activity records of the loaded trace in order, like
+ *         Replay_ScanAdc() (the host's --self-heating-fit)
+ *
+ * @return false after the last activity record
+ */
+bool Replay_ScanActivity(uint32_t *tick, SelfHeatingActivity_t *activity);
+
+/**
+ * @brief  Input hooks of the input task
+ *
+ * @details  Replay_RecordInput() records an event being posted.
+ *           Replay_NextInput() returns the next replayed event that is due,
+ *           false when there is none.
+ */
+void Replay_RecordInput(const Input2VPEvent_t *event);
+bool Replay_NextInput(Input2VPEvent_t *event);
+
+/**
+ * @brief  ADC hook of the sensor task
+ *
+ * @details  Replaces @p samples with the latest due recorded sequence while
+ *           replaying, then records them.
+ */
+void Replay_Adc(uint16_t samples[REPLAY_ADC_CHANNELS]);
+
+/**
+ * @brief  Activity hook of the sensor task, called with the activity of
+ *         each temperature sample
+ *
+ * @details  Replaces @p activity with the latest due recorded one while
+ *           replaying, so the self-heating compensation replays exactly,
+ *           then records it.
+ */
+void Replay_Activity(SelfHeatingActivity_t *activity);
+
+/**
+ * @brief  RTC hook, called after HAL_RTC_GetTime()/HAL_RTC_GetDate()
+ *
+ * @details  Replays the latest due calendar, advancing the seconds by the
+ *           ticks elapsed since it was recorded. A read is recorded only when
+ *           anything but the seconds changed.
+ */
+void Replay_Rtc(RTC_TimeTypeDef *time, RTC_DateTypeDef *date);
+
+/**
+ * @brief  Configuration hook of the storage task
+ *
+ * @param  config  Configuration read from flash, replaced while replaying
+ * @param  valid   Whether flash held a valid configuration
+ * @return Whether @p config is valid
+ */
+bool Replay_Config(ConfigData_t *config, bool valid);
+
+/**
+ * @brief  Charge the processing of one event while replaying
+ */
+void Replay_AddCost(ReplayCost_t kind, uint32_t cycles);
+
+/**
+ * @brief  Print the per-event cost of the replay
+ *
+ * @details  Output format (the BENCH lines are read by
+ *           Tools/bench_compare.py, store per-trace baselines with -b):
+ *           @code
+ *           Replay event   count   avg us   max us
+ *           wheel             84       61      402
+ *           sensor           361        9       37
+ *           BENCH {"platform":"host","kernel":"replay_wheel","calls":84,...}
+ *           @endcode
+ */
+void Replay_Report(void);
+
+#define REPLAY_RECORD_INPUT(event) Replay_RecordInput((event))
+#define REPLAY_NEXT_INPUT(event) Replay_NextInput((event))
+#define REPLAY_ADC(samples) Replay_Adc((samples))
+#define REPLAY_ACTIVITY(activity) Replay_Activity((activity))
+#define REPLAY_RTC(time, date) Replay_Rtc((time), (date))
+#define REPLAY_CONFIG(config, valid) Replay_Config((config), (valid))
+#define REPLAY_COST_START() CycleCounter_Get()
+#define REPLAY_COST_END(kind, start)                                           \
+  Replay_AddCost((kind), CycleCounter_Get() - (start))
+
+#else
+
+#define REPLAY_RECORD_INPUT(event) ((void)0)
+#define REPLAY_NEXT_INPUT(event) false
+#define REPLAY_ADC(samples) ((void)0)
+#define REPLAY_ACTIVITY(activity) ((void)0)
+#define REPLAY_RTC(time, date) ((void)0)
+#define REPLAY_CONFIG(config, valid) (valid)
+#define REPLAY_COST_START() 0U
+#define REPLAY_COST_END(kind, start) ((void)(start))
+
+#endif /* REPLAY_HOOKS_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_REPLAY_H */
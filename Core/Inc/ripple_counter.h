@@ -0,0 +1,314 @@
+/**
+ ******************************************************************************
+ * @file           :  ripple_counter.h
+ * @brief          :  Valve position from the commutation ripple of the motor
+ *                    current
+ *
+ * @details        :  Each time a brush of the valve motor passes a
+ *                    commutator gap the current dips, a fixed number of
+ *                    times per revolution. Counting these ripples gives the
+ *                    rotor travel, and through the gearbox the valve travel,
+ *                    whatever the battery voltage and load, which an
+ *                    open-loop time does not. Per current sample:
+ *                    - a band-pass biquad removes the mean current, the
+ *                      inrush and the shunt noise outside the ripple band
+ *                      (Q14 fixed point, dual 16-bit MACs on Cortex-M4).
+ *                      It is wide around RIPPLE_COUNTER_CENTER_HZ until
+ *                      RIPPLE_COUNTER_LOCK_RIPPLES ripples have given the
+ *                      period, then narrow at the tracked period;
+ *                    - a comparator with hysteresis at half the mean
+ *                      filtered amplitude counts one ripple per rising
+ *                      transition;
+ *                    - a ripple closer to the previous one than
+ *                      RIPPLE_COUNTER_MIN_PERIOD_PCT of the tracked period
+ *                      is taken as noise; a gap longer than
+ *                      RIPPLE_COUNTER_MAX_PERIOD_PCT of it is credited
+ *                      with the ripples that went undetected, and one of
+ *                      RIPPLE_COUNTER_STALL_PERIODS is a stall.
+ *                    The motor keeps turning for a moment after it is
+ *                    braked, when the shunt no longer sees its current, so
+ *                    a run ends with the run-on predicted from the last
+ *                    ripple period. The sensor task feeds it from the DMA
+ *                    interrupt of each ADC sequence, like motor_guard.h,
+ *                    and stops moves commanded in ripples there
+ *                    (SensorTask_MoveMotor()). Integer arithmetic and no
+ *                    RTOS calls, so it is safe in interrupt context; the
+ *                    band-pass coefficients are constant tables designed
+ *                    offline, so the sensor task never touches the FPU.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_RIPPLE_COUNTER_H
+#define CORE_INC_RIPPLE_COUNTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_CENTER_HZ
+ * @brief Center of the band-pass, about the ripple frequency of the valve
+ *        drive at nominal voltage and load
+ */
+#ifndef RIPPLE_COUNTER_CENTER_HZ
+#define RIPPLE_COUNTER_CENTER_HZ 300U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_Q_X100
+ * @brief Quality factor of the band-pass times 100; low enough to pass
+ *        the ripple of a slow, loaded motor on a weak battery as well as
+ *        of a fast, free one on a fresh battery
+ * @note  This and the three below are the design of the coefficient tables
+ *        in ripple_counter.c; --ripple-eval checks the tables against them
+ *        and prints new ones when they differ
+ */
+#define RIPPLE_COUNTER_Q_X100 50U
+
+/**
+ * @def RIPPLE_COUNTER_TRACK_Q_X100
+ * @brief Quality factor of the band-pass times 100 once the ripple period
+ *        is known; it is then centered on the period, which passes less
+ *        noise than the wide band
+ */
+#define RIPPLE_COUNTER_TRACK_Q_X100 200U
+
+/**
+ * @def RIPPLE_COUNTER_TRACK_MIN_PERIOD
+ * @brief Shortest ripple period in samples a band-pass is designed for
+ */
+#define RIPPLE_COUNTER_TRACK_MIN_PERIOD 3U
+
+/**
+ * @def RIPPLE_COUNTER_TRACK_STEPS
+ * @brief Band-passes of each quality factor, one per whole sample of
+ *        period; longer periods use the last. Being designed per period
+ *        in samples, they fit any sample rate.
+ */
+#define RIPPLE_COUNTER_TRACK_STEPS 64U
+
+/**
+ * @def RIPPLE_COUNTER_MAX_HZ
+ * @brief Fastest ripple expected; closer transitions are always noise
+ */
+#ifndef RIPPLE_COUNTER_MAX_HZ
+#define RIPPLE_COUNTER_MAX_HZ 800U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_MIN_AMPLITUDE_MA
+ * @brief Smallest hysteresis of the comparator, above the noise of the
+ *        filtered current of a motor that does not turn
+ */
+#ifndef RIPPLE_COUNTER_MIN_AMPLITUDE_MA
+#define RIPPLE_COUNTER_MIN_AMPLITUDE_MA 1U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_MIN_DEPTH_PCT
+ * @brief Smallest hysteresis of the comparator in percent of the mean
+ *        current; the ripple of a turning motor is a larger share of it
+ */
+#ifndef RIPPLE_COUNTER_MIN_DEPTH_PCT
+#define RIPPLE_COUNTER_MIN_DEPTH_PCT 3U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_SETTLE_US
+ * @brief Time after a start in which no ripple is counted: the inrush
+ *        current falls steeply while the rotor makes less than a ripple
+ */
+#ifndef RIPPLE_COUNTER_SETTLE_US
+#define RIPPLE_COUNTER_SETTLE_US 5000U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_MIN_PERIOD_PCT
+ * @brief Shortest ripple interval counted, in percent of the tracked
+ *        period
+ */
+#ifndef RIPPLE_COUNTER_MIN_PERIOD_PCT
+#define RIPPLE_COUNTER_MIN_PERIOD_PCT 60U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_MAX_PERIOD_PCT
+ * @brief Longest ripple interval taken as a single ripple, in percent of
+ *        the tracked period
+ */
+#ifndef RIPPLE_COUNTER_MAX_PERIOD_PCT
+#define RIPPLE_COUNTER_MAX_PERIOD_PCT 160U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_MAX_CREDIT
+ * @brief Most ripples one interval is counted as; a longer gap is a
+ *        stalling motor, not missed ripples
+ */
+#ifndef RIPPLE_COUNTER_MAX_CREDIT
+#define RIPPLE_COUNTER_MAX_CREDIT 3U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_LOCK_RIPPLES
+ * @brief Ripples of a run before the period is trusted; until then, while
+ *        the motor speeds up, every interval is counted as one ripple
+ */
+#ifndef RIPPLE_COUNTER_LOCK_RIPPLES
+#define RIPPLE_COUNTER_LOCK_RIPPLES 8U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_STALL_PERIODS
+ * @brief Ripple periods without a ripple after which a run has stalled;
+ *        catches a blocked motor whose current stays below the stall
+ *        threshold of the motor guard on a weak battery
+ */
+#ifndef RIPPLE_COUNTER_STALL_PERIODS
+#define RIPPLE_COUNTER_STALL_PERIODS 4U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_BRAKE_US
+ * @brief Run-on of a braked motor: the ripples it still makes are this
+ *        time over the last ripple period. About the mechanical time
+ *        constant of the drive with the windings shorted, less the load.
+ */
+#ifndef RIPPLE_COUNTER_BRAKE_US
+#define RIPPLE_COUNTER_BRAKE_US 7000U
+#endif
+
+/**
+ * @def RIPPLE_COUNTER_COAST_US
+ * @brief Run-on of a motor left to coast, slowed by friction and the valve
+ *        spring only
+ */
+#ifndef RIPPLE_COUNTER_COAST_US
+#define RIPPLE_COUNTER_COAST_US 20000U
+#endif
+
+/**
+ * @brief  Band-pass coefficients in Q14:
+ *         y0 = b0 * (x0 - x2) + a1 * y1 + a2 * y2
+ */
+typedef struct {
+  int16_t b0;
+  int16_t a1;
+  int16_t a2;
+} RippleCounterBiquad_t;
+
+/**
+ * @brief  Counter state; the position survives runs
+ */
+typedef struct {
+  /* Band-pass */
+  const RippleCounterBiquad_t *wide;   /**< Around RIPPLE_COUNTER_CENTER_HZ */
+  const RippleCounterBiquad_t *filter; /**< In use */
+  int16_t x1, x2; /**< Previous inputs */
+  int16_t y1, y2; /**< Previous outputs */
+  /* Ripple detection */
+  uint32_t sample_us;      /**< Time between samples */
+  uint32_t envelope;       /**< Mean |output| in 1/16 */
+  uint32_t mean;           /**< Mean input in 1/16 */
+  uint32_t period_x16;     /**< Tracked ripple period in 1/16 samples */
+  uint16_t min_interval;   /**< Shortest interval in samples */
+  uint16_t settle_samples; /**< Samples not counted after a start */
+  uint16_t min_hysteresis; /**< Smallest comparator hysteresis */
+  uint16_t since_ripple;   /**< Samples since the last ripple, saturating */
+  uint16_t ripples;        /**< Ripples of the run, saturating at lock */
+  bool primed;             /**< Filter state taken from a first sample */
+  bool low;                /**< Below the lower threshold since a ripple */
+  /* Travel */
+  int8_t direction;     /**< +1 or -1 while a run counts, 0 otherwise */
+  int32_t position;     /**< Signed ripple count */
+  uint32_t run_ripples; /**< Ripples of the run, run-on included */
+  uint32_t target;      /**< Ripples the run stops at, 0 for no target */
+} RippleCounter_t;
+
+/**
+ * @brief  Pick the band-pass for a sample interval and zero the position
+ * @param  counter    Counter state
+ * @param  sample_us  Time between current samples
+ */
+void RippleCounter_Init(RippleCounter_t *counter, uint32_t sample_us);
+
+/**
+ * @brief  Band-pass coefficients for a ripple period
+ * @param  period    Period in samples, clamped to the tables
+ * @param  tracking  RIPPLE_COUNTER_TRACK_Q_X100 instead of
+ *                   RIPPLE_COUNTER_Q_X100
+ */
+const RippleCounterBiquad_t *RippleCounter_GetFilter(uint32_t period,
+                                                     bool tracking);
+
+/**
+ * @brief  The motor was started or reversed: count a new run
+ * @param  counter    Counter state
+ * @param  direction  Sign the ripples move the position by, +1 or -1
+ * @param  target     Ripples at which RippleCounter_TargetReached() turns
+ *                    true, 0 for none
+ */
+void RippleCounter_Start(RippleCounter_t *counter, int8_t direction,
+                         uint32_t target);
+
+/**
+ * @brief  Count the ripples of one current sample of a driven motor
+ * @param  counter     Counter state
+ * @param  current_ma  Motor current
+ * @return Ripples counted with this sample, usually 0 or 1
+ */
+uint32_t RippleCounter_Update(RippleCounter_t *counter, uint32_t current_ma);
+
+/**
+ * @brief  Ripples the motor would still make if braked now
+ * @param  run_on_us  RIPPLE_COUNTER_BRAKE_US or RIPPLE_COUNTER_COAST_US
+ * @return 0 unless a ripple was seen within two periods
+ */
+uint32_t RippleCounter_RunOn(const RippleCounter_t *counter,
+                             uint32_t run_on_us);
+
+/**
+ * @brief  Whether the run, with the run-on after braking, has reached its
+ *         target; braking now ends it on the target
+ */
+bool RippleCounter_TargetReached(const RippleCounter_t *counter);
+
+/**
+ * @brief  Whether the motor stopped turning although it is driven: no
+ *         ripple for RIPPLE_COUNTER_STALL_PERIODS periods after
+ *         RIPPLE_COUNTER_LOCK_RIPPLES
+ */
+bool RippleCounter_Stalled(const RippleCounter_t *counter);
+
+/**
+ * @brief  The motor was braked or left to coast: add the predicted run-on
+ *         and end the run
+ * @param  run_on_us  RIPPLE_COUNTER_BRAKE_US or RIPPLE_COUNTER_COAST_US
+ */
+void RippleCounter_Stop(RippleCounter_t *counter, uint32_t run_on_us);
+
+/**
+ * @brief  Signed ripple count since the position was last set
+ */
+int32_t RippleCounter_GetPosition(const RippleCounter_t *counter);
+
+/**
+ * @brief  Set the position, e.g. to 0 with the valve pin on its seat
+ */
+void RippleCounter_SetPosition(RippleCounter_t *counter, int32_t position);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_RIPPLE_COUNTER_H */
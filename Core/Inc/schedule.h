@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * @file           :  schedule.h
+ * @brief          :  Weekly heating schedule
+ *
+ * @details        :  Every weekday has its own list of up to
+ *                    SCHEDULE_MAX_SLOTS slots, stored packed in
+ *                    WeeklyScheduleTypeDef. Start times are quantised to
+ *                    SCHEDULE_STEP_MIN minutes and temperatures to the
+ *                    indices of Utils_TempToIndex(), so the whole week fits
+ *                    in 78 bytes of the flash record.
+ *
+ *                    Schedule_Evaluate() returns the target at a time of the
+ *                    week and the next change of target, which may be on a
+ *                    later day. It visits each slot of the week at most
+ *                    once, so its cost is bounded by SCHEDULE_DAYS *
+ *                    SCHEDULE_MAX_SLOTS whatever the schedule holds.
+ *
+ *                    The editor works on one day at a time as a
+ *                    DailyScheduleTypeDef; Schedule_GetDay() and
+ *                    Schedule_SetDay() convert.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_SCHEDULE_H
+#define CORE_INC_SCHEDULE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "storage_task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Resolution of slot start times in minutes */
+#define SCHEDULE_STEP_MIN 5U
+
+/** Minutes in one day */
+#define SCHEDULE_DAY_MIN 1440U
+
+/** Pack a start time in minutes after midnight and a temperature index */
+#define SCHEDULE_SLOT(start_min, temp_index)                                  \
+  ((uint16_t)(((start_min) / SCHEDULE_STEP_MIN) | ((uint16_t)(temp_index) << 9)))
+
+/** Start time of a packed slot in minutes after midnight */
+#define SCHEDULE_SLOT_START(slot)                                             \
+  ((uint16_t)(((slot) & 0x1FFU) * SCHEDULE_STEP_MIN))
+
+/** Temperature index of a packed slot */
+#define SCHEDULE_SLOT_INDEX(slot) ((uint8_t)(((slot) >> 9) & 0x3FU))
+
+/** Day masks for Schedule_CopyDay(), bit 0 = Monday */
+#define SCHEDULE_MASK_WORKDAYS 0x1FU
+#define SCHEDULE_MASK_WEEKEND 0x60U
+#define SCHEDULE_MASK_ALL 0x7FU
+
+/**
+ * @brief  Result of Schedule_Evaluate()
+ */
+typedef struct {
+  uint8_t target_index; /**< Temperature index now */
+  uint8_t next_index;   /**< Temperature index after the next change */
+  uint8_t next_day;     /**< Day of the next change, 0 = Monday */
+  uint8_t next_hour;    /**< Time of the next change */
+  uint8_t next_minute;
+  uint16_t minutes_to_next; /**< 1 to one week */
+} ScheduleState_t;
+
+/**
+ * @brief  Fill every day with the same preset of Utils_LoadDefaultSchedule()
+ * @param  num_slots  3, 4 or 5
+ */
+void Schedule_LoadDefault(WeeklyScheduleTypeDef *weekly, uint8_t num_slots);
+
+/**
+ * @brief  Check a schedule read from flash or built by the editor
+ * @return true if every day has 1 to SCHEDULE_MAX_SLOTS slots, the first
+ *         starting at midnight, with increasing start times and valid
+ *         temperature indices
+ */
+bool Schedule_IsValid(const WeeklyScheduleTypeDef *weekly);
+
+/**
+ * @brief  Expand one day for the editor
+ * @details Each slot ends where the next starts; the last ends at 23:59,
+ *          as the editor shows it.
+ * @param  day  0 = Monday
+ * @return false if the day is out of range
+ */
+bool Schedule_GetDay(const WeeklyScheduleTypeDef *weekly, uint8_t day,
+                     DailyScheduleTypeDef *daily);
+
+/**
+ * @brief  Replace one day with an edited daily schedule
+ * @details Start times are rounded down to SCHEDULE_STEP_MIN and
+ *          temperatures to their index; end times are implied by the next
+ *          start. The day is left unchanged if the result is not valid.
+ * @param  day  0 = Monday
+ * @return true if the day was replaced
+ */
+bool Schedule_SetDay(WeeklyScheduleTypeDef *weekly, uint8_t day,
+                     const DailyScheduleTypeDef *daily);
+
+/**
+ * @brief  Copy the slots of one day to the days in a mask
+ * @param  from     Source day, 0 = Monday
+ * @param  to_mask  Destination days, bit 0 = Monday
+ */
+void Schedule_CopyDay(WeeklyScheduleTypeDef *weekly, uint8_t from,
+                      uint8_t to_mask);
+
+/**
+ * @brief  Find the target at a time of the week and the next change
+ * @details Slot boundaries that keep the same temperature are skipped, so
+ *          the next change may be days ahead. If the target never changes,
+ *          the next change is reported at the start of the current slot one
+ *          week later, with the same index.
+ * @param  day  0 = Monday
+ * @return false if the day is out of range or has no slots
+ */
+bool Schedule_Evaluate(const WeeklyScheduleTypeDef *weekly, uint8_t day,
+                       uint8_t hour, uint8_t minute, ScheduleState_t *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_SCHEDULE_H */
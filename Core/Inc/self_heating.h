@@ -0,0 +1,156 @@
+/**
+ ******************************************************************************
+ * @file           :  self_heating.h
+ * @brief          :  Self-heating compensation of the internal temperature
+ *                    sensor
+ *
+ * @details        :  The ambient temperature is read from the MCU's own
+ *                    sensor, which the CPU, the display traffic and the
+ *                    motor driver warm above the room. The model estimates
+ *                    that rise from the activity measured over each sampling
+ *                    interval:
+ *                      rise = cpu_cdeg * lag(CPU duty)
+ *                           + display_cdeg * lag(display rate / 1 KB/s)
+ *                           + motor_cdeg * lag(motor current / 100 mA)
+ *                    where lag() is a first-order lag with the thermal time
+ *                    constant tau_s of the board. Each coefficient is the
+ *                    steady-state rise of its source at full scale. The
+ *                    sensor task subtracts the rise before the filter; the
+ *                    manual temperature offset still applies on top.
+ *
+ *                    Fit the coefficients to a recorded trace with the host
+ *                    build's --self-heating-fit. Integer arithmetic only, like
+ *                    sensor_filter.h.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_SELF_HEATING_H
+#define CORE_INC_SELF_HEATING_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Display rate at which display_cdeg applies, in bytes per second */
+#define SELF_HEATING_DISPLAY_FULL_BPS 1000U
+
+/** Mean motor current at which motor_cdeg applies, in mA */
+#define SELF_HEATING_MOTOR_FULL_MA 100U
+
+/**
+ * @def SELF_HEATING_DEFAULT_TAU_S
+ * @brief Default thermal time constant of the board in seconds (0 = off)
+ */
+#ifndef SELF_HEATING_DEFAULT_TAU_S
+#define SELF_HEATING_DEFAULT_TAU_S 600U
+#endif
+
+/**
+ * @def SELF_HEATING_DEFAULT_CPU_CDEG
+ * @brief Default rise at a CPU duty of 100%, in centidegrees
+ */
+#ifndef SELF_HEATING_DEFAULT_CPU_CDEG
+#define SELF_HEATING_DEFAULT_CPU_CDEG 60
+#endif
+
+/**
+ * @def SELF_HEATING_DEFAULT_DISPLAY_CDEG
+ * @brief Default rise at SELF_HEATING_DISPLAY_FULL_BPS, in centidegrees
+ */
+#ifndef SELF_HEATING_DEFAULT_DISPLAY_CDEG
+#define SELF_HEATING_DEFAULT_DISPLAY_CDEG 20
+#endif
+
+/**
+ * @def SELF_HEATING_DEFAULT_MOTOR_CDEG
+ * @brief Default rise at SELF_HEATING_MOTOR_FULL_MA, in centidegrees
+ */
+#ifndef SELF_HEATING_DEFAULT_MOTOR_CDEG
+#define SELF_HEATING_DEFAULT_MOTOR_CDEG 80
+#endif
+
+/**
+ * @brief  Model coefficients
+ */
+typedef struct {
+  uint16_t tau_s;       /**< Thermal time constant, 0 = compensation off */
+  int16_t cpu_cdeg;     /**< Rise at 100% CPU duty */
+  int16_t display_cdeg; /**< Rise at SELF_HEATING_DISPLAY_FULL_BPS */
+  int16_t motor_cdeg;   /**< Rise at SELF_HEATING_MOTOR_FULL_MA */
+} SelfHeatingParams_t;
+
+/**
+ * @brief  Activity over one sampling interval
+ */
+typedef struct {
+  uint32_t period_ms;    /**< Length of the interval */
+  uint16_t cpu_permille; /**< Time outside the idle task */
+  uint16_t display_bps;  /**< Bytes written to the display per second */
+  uint16_t motor_ma;     /**< Mean motor current over the interval */
+} SelfHeatingActivity_t;
+
+/** Heat sources of the model */
+typedef enum {
+  SELF_HEATING_CPU = 0,
+  SELF_HEATING_DISPLAY,
+  SELF_HEATING_MOTOR,
+  SELF_HEATING_SOURCE_COUNT
+} SelfHeatingSource_t;
+
+/**
+ * @brief  Model state
+ */
+typedef struct {
+  SelfHeatingParams_t params;
+  /** Lagged activity per source, Q16 of its full scale */
+  int32_t lag_q16[SELF_HEATING_SOURCE_COUNT];
+  int32_t rise_cdeg; /**< Last estimated rise */
+} SelfHeating_t;
+
+/**
+ * @brief  Coefficients used when none are configured
+ */
+void SelfHeating_DefaultParams(SelfHeatingParams_t *params);
+
+/**
+ * @brief  Start from a board at room temperature
+ * @param  model   Model state
+ * @param  params  Coefficients, NULL for the defaults
+ */
+void SelfHeating_Init(SelfHeating_t *model, const SelfHeatingParams_t *params);
+
+/**
+ * @brief  Change the coefficients, keeping the lagged activity
+ */
+void SelfHeating_SetParams(SelfHeating_t *model,
+                           const SelfHeatingParams_t *params);
+
+/**
+ * @brief  Account one interval of activity
+ *
+ * @return Estimated rise of the sensor above the room at the end of the
+ *         interval, in centidegrees; subtract it from the reading
+ */
+int32_t SelfHeating_Update(SelfHeating_t *model,
+                           const SelfHeatingActivity_t *activity);
+
+/**
+ * @brief  Normalise the activity of one source to Q16 of its full scale
+ */
+int32_t SelfHeating_ActivityQ16(const SelfHeatingActivity_t *activity,
+                                SelfHeatingSource_t source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_SELF_HEATING_H */
@@ -0,0 +1,121 @@
+/**
+ ******************************************************************************
+ * @file           :  sensor_calc.h
+ * @brief          :  Conversions from raw ADC samples to physical values
+ *
+ * @details        :  Pure functions used by the sensor task: VREF+
+ *                    calculation from the VREFINT sample, raw-to-voltage
+ *                    conversion, internal temperature sensor conversion and
+ *                    the 2xAA alkaline state-of-charge curve. They take no
+ *                    locks and touch no hardware, so they can be called from
+ *                    the benchmarks and from the host build unchanged.
+ *
+ *                    All conversions work in integer milli- and centi-units
+ *                    so the sensor task never touches the FPU (a task that
+ *                    does pays for the extended FPU frame on every context
+ *                    switch). Convert to float at the presentation side.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_SENSOR_CALC_H
+#define CORE_INC_SENSOR_CALC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Motor shunt resistance in milliohms */
+#define SENSOR_CALC_MOTOR_SHUNT_MOHMS 220U
+
+/** Ratio of the battery voltage to the VBAT channel input (internal bridge) */
+#define SENSOR_CALC_VBAT_DIVIDER 3U
+
+/**
+ * @brief  Calculate VREF+ from the internal voltage reference sample
+ *
+ * @param  vref_raw  12-bit VREFINT conversion result
+ * @return VREF+ in millivolts (factory calibration voltage if vref_raw is 0)
+ */
+uint32_t SensorCalc_VrefVoltage(uint16_t vref_raw);
+
+/**
+ * @brief  Convert a 12-bit conversion result to millivolts
+ *
+ * @param  raw_value  12-bit conversion result
+ * @param  vref_mv    VREF+ in millivolts (see SensorCalc_VrefVoltage)
+ * @return Input voltage in millivolts
+ */
+uint32_t SensorCalc_RawToMillivolts(uint16_t raw_value, uint32_t vref_mv);
+
+/**
+ * @brief  Motor current from the shunt voltage sample
+ *
+ * @param  motor_raw  12-bit conversion result of the shunt channel
+ * @param  vref_mv    VREF+ in millivolts
+ * @return Motor current in milliamperes
+ */
+uint32_t SensorCalc_MotorCurrent(uint16_t motor_raw, uint32_t vref_mv);
+
+/**
+ * @brief  Battery voltage from the VBAT channel sample
+ *
+ * @param  vbat_raw  12-bit conversion result of the VBAT channel
+ * @param  vref_mv   VREF+ in millivolts
+ * @return Battery voltage in millivolts
+ */
+uint32_t SensorCalc_BatteryVoltage(uint16_t vbat_raw, uint32_t vref_mv);
+
+/**
+ * @brief  Convert the internal temperature sensor sample to centidegrees
+ *
+ * @details  Uses the factory calibration points (TS_CAL1/TS_CAL2) like
+ *           __LL_ADC_CALC_TEMPERATURE() but keeps two decimals; truncating
+ *           the result to whole degrees (toward TS_CAL1_TEMP) gives the
+ *           macro's result exactly. The user temperature offset is not
+ *           applied here.
+ *
+ * @param  temperature_raw  12-bit temperature sensor conversion result
+ * @param  vref_mv          VREF+ in millivolts
+ * @return Temperature in hundredths of a degree Celsius
+ */
+int32_t SensorCalc_TemperatureCenti(uint16_t temperature_raw,
+                                    uint32_t vref_mv);
+
+/**
+ * @brief  Battery state of charge from the battery voltage
+ *
+ * @details  Piecewise linear interpolation of the discharge curve of two
+ *           alkaline AA cells in series (3.0 V full, 2.0 V cut-off).
+ *
+ * @param  battery_mv  Battery voltage in millivolts
+ * @return State of charge in percent (0-100)
+ */
+uint8_t SensorCalc_BatterySoc(uint32_t battery_mv);
+
+/**
+ * @brief  Convert a float, given by its IEEE 754 bits, to hundredths
+ *
+ * @details  Rounds half away from zero and saturates to the int16_t range;
+ *           NaN gives 0. Lets the sampling path use a float stored in the
+ *           configuration without executing a floating-point instruction:
+ *           read the value with memcpy() into a uint32_t.
+ *
+ * @param  bits  Bit pattern of a single-precision float
+ * @return Value times 100, rounded
+ */
+int32_t SensorCalc_FloatBitsToCenti(uint32_t bits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_SENSOR_CALC_H */
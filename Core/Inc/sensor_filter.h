@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * @file           :  sensor_filter.h
+ * @brief          :  Median, first-order IIR and slew-rate filter for the
+ *                    ambient temperature
+ *
+ * @details        :  The stages run in that order and each can be turned
+ *                    off: the median removes single-sample spikes, the IIR
+ *                    smooths the remaining noise, and the rate limit bounds
+ *                    how fast the published value may move. The IIR and the
+ *                    rate limit are specified in time units and take the
+ *                    interval since the previous sample, so they behave the
+ *                    same at any sampling period. Integer arithmetic only
+ *                    (centidegrees), like sensor_calc.h.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_SENSOR_FILTER_H
+#define CORE_INC_SENSOR_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest median window */
+#define SENSOR_FILTER_MEDIAN_MAX 7U
+
+/**
+ * @def SENSOR_FILTER_DEFAULT_MEDIAN
+ * @brief Default median window in samples (1 = off)
+ */
+#ifndef SENSOR_FILTER_DEFAULT_MEDIAN
+#define SENSOR_FILTER_DEFAULT_MEDIAN 3U
+#endif
+
+/**
+ * @def SENSOR_FILTER_DEFAULT_TAU_S
+ * @brief Default IIR time constant in seconds (0 = off)
+ */
+#ifndef SENSOR_FILTER_DEFAULT_TAU_S
+#define SENSOR_FILTER_DEFAULT_TAU_S 60U
+#endif
+
+/**
+ * @def SENSOR_FILTER_DEFAULT_SLEW
+ * @brief Default rate limit in centidegrees per minute (0 = off)
+ */
+#ifndef SENSOR_FILTER_DEFAULT_SLEW
+#define SENSOR_FILTER_DEFAULT_SLEW 100U
+#endif
+
+/**
+ * @brief  Tunable parameters
+ */
+typedef struct {
+  uint8_t median_n;    /**< Median window, odd, 1 (off) to MEDIAN_MAX */
+  uint16_t iir_tau_s;  /**< IIR time constant in seconds, 0 = off */
+  uint16_t slew_cdeg_per_min; /**< Largest change per minute, 0 = off */
+} SensorFilterParams_t;
+
+/**
+ * @brief  Filter state (one per filtered quantity)
+ */
+typedef struct {
+  SensorFilterParams_t params;
+  int16_t window[SENSOR_FILTER_MEDIAN_MAX]; /**< Last samples, ring */
+  uint8_t window_count;                     /**< Valid samples in window */
+  uint8_t window_head;                      /**< Next slot to write */
+  int32_t iir_q8;                           /**< IIR state, Q24.8 */
+  int32_t output;                           /**< Last published value */
+  uint32_t slew_carry;                      /**< Unused rate allowance */
+  bool primed;                              /**< Seen a first sample */
+} SensorFilter_t;
+
+/**
+ * @brief  Parameters used when none are configured
+ */
+void SensorFilter_DefaultParams(SensorFilterParams_t *params);
+
+/**
+ * @brief  Clear the state and set the parameters
+ *
+ * @details  Out-of-range parameters are clamped: an even median window is
+ *           rounded down to the next odd one.
+ */
+void SensorFilter_Init(SensorFilter_t *filter,
+                       const SensorFilterParams_t *params);
+
+/**
+ * @brief  Change the parameters, keeping the IIR and rate-limit state
+ *
+ * @details  A different median window restarts the median.
+ */
+void SensorFilter_SetParams(SensorFilter_t *filter,
+                            const SensorFilterParams_t *params);
+
+/**
+ * @brief  Filter one sample
+ *
+ * @details  The first sample after SensorFilter_Init() passes unchanged and
+ *           seeds every stage.
+ *
+ * @param  filter    Filter state
+ * @param  raw_cdeg  New sample in centidegrees
+ * @param  dt_ms     Time since the previous sample
+ * @return Filtered value in centidegrees
+ */
+int32_t SensorFilter_Update(SensorFilter_t *filter, int32_t raw_cdeg,
+                            uint32_t dt_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_SENSOR_FILTER_H */
@@ -0,0 +1,172 @@
+/**
+ ******************************************************************************
+ * @file           :  sensor_sampling.h
+ * @brief          :  Adaptive temperature sampling period
+ *
+ * @details        :  Picks the time to the next temperature measurement from
+ *                    what the last ones showed:
+ *                    - the period doubles while the temperature stays within
+ *                      half of SENSOR_SAMPLING_THRESHOLD_CDEG of the last
+ *                      significant value, and halves when it moves further;
+ *                    - it never exceeds the time the temperature needs to
+ *                      move by the threshold at twice the observed rate or
+ *                      at SENSOR_SAMPLING_MAX_SLEW_CDEG_PER_MIN, the fastest
+ *                      a room is expected to change (an open window), so no
+ *                      larger change goes unseen;
+ *                    - it drops to SENSOR_SAMPLING_FAST_PERIOD_MS while the
+ *                      temperature changes quickly or heads for the setpoint
+ *                      and would cross it within one period;
+ *                    - it stays at SENSOR_SAMPLING_ACTIVE_PERIOD_MS while
+ *                      the user operates the device;
+ *                    - on a low battery the threshold doubles and the period
+ *                      may stretch to SENSOR_SAMPLING_LOW_SOC_MAX_PERIOD_MS
+ *                      instead of SENSOR_SAMPLING_MAX_PERIOD_MS.
+ *                    Integer arithmetic only, like sensor_filter.h.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_SENSOR_SAMPLING_H
+#define CORE_INC_SENSOR_SAMPLING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def SENSOR_SAMPLING_THRESHOLD_CDEG
+ * @brief Largest temperature change allowed to go unseen between two
+ *        measurements, in centidegrees
+ */
+#ifndef SENSOR_SAMPLING_THRESHOLD_CDEG
+#define SENSOR_SAMPLING_THRESHOLD_CDEG 50U
+#endif
+
+/**
+ * @def SENSOR_SAMPLING_MAX_SLEW_CDEG_PER_MIN
+ * @brief Fastest rate the room temperature is expected to change at; bounds
+ *        the period to THRESHOLD / MAX_SLEW minutes (200 s by default)
+ */
+#ifndef SENSOR_SAMPLING_MAX_SLEW_CDEG_PER_MIN
+#define SENSOR_SAMPLING_MAX_SLEW_CDEG_PER_MIN 15U
+#endif
+
+/**
+ * @def SENSOR_SAMPLING_FAST_RATE_CDEG_PER_MIN
+ * @brief Rate above which the temperature is sampled at the fast period
+ */
+#ifndef SENSOR_SAMPLING_FAST_RATE_CDEG_PER_MIN
+#define SENSOR_SAMPLING_FAST_RATE_CDEG_PER_MIN 30U
+#endif
+
+/**
+ * @def SENSOR_SAMPLING_FAST_PERIOD_MS
+ * @brief Shortest period, while the temperature moves quickly or crosses
+ *        the setpoint
+ */
+#ifndef SENSOR_SAMPLING_FAST_PERIOD_MS
+#define SENSOR_SAMPLING_FAST_PERIOD_MS 5000U
+#endif
+
+/**
+ * @def SENSOR_SAMPLING_ACTIVE_PERIOD_MS
+ * @brief Longest period while the user operates the device
+ */
+#ifndef SENSOR_SAMPLING_ACTIVE_PERIOD_MS
+#define SENSOR_SAMPLING_ACTIVE_PERIOD_MS 10000U
+#endif
+
+/**
+ * @def SENSOR_SAMPLING_ACTIVE_MS
+ * @brief Time after the last user input during which the device counts as
+ *        operated
+ */
+#ifndef SENSOR_SAMPLING_ACTIVE_MS
+#define SENSOR_SAMPLING_ACTIVE_MS 30000U
+#endif
+
+/**
+ * @def SENSOR_SAMPLING_MAX_PERIOD_MS
+ * @brief Longest period
+ */
+#ifndef SENSOR_SAMPLING_MAX_PERIOD_MS
+#define SENSOR_SAMPLING_MAX_PERIOD_MS 300000U
+#endif
+
+/**
+ * @def SENSOR_SAMPLING_LOW_SOC_PERCENT
+ * @brief State of charge below which the low-battery limit applies
+ */
+#ifndef SENSOR_SAMPLING_LOW_SOC_PERCENT
+#define SENSOR_SAMPLING_LOW_SOC_PERCENT 20U
+#endif
+
+/**
+ * @def SENSOR_SAMPLING_LOW_SOC_MAX_PERIOD_MS
+ * @brief Longest period on a low battery
+ */
+#ifndef SENSOR_SAMPLING_LOW_SOC_MAX_PERIOD_MS
+#define SENSOR_SAMPLING_LOW_SOC_MAX_PERIOD_MS 600000U
+#endif
+
+/** Setpoint value when no setpoint applies */
+#define SENSOR_SAMPLING_NO_SETPOINT INT32_MIN
+
+/**
+ * @brief  What the policy looks at on every measurement
+ */
+typedef struct {
+  int32_t temperature_cdeg; /**< Latest (filtered) temperature */
+  int32_t setpoint_cdeg;    /**< Target or SENSOR_SAMPLING_NO_SETPOINT */
+  uint8_t soc;              /**< Battery state of charge in percent */
+  bool user_active;         /**< User input within SENSOR_SAMPLING_ACTIVE_MS */
+} SensorSamplingInput_t;
+
+/**
+ * @brief  Policy state
+ */
+typedef struct {
+  int32_t anchor_cdeg;     /**< Last significant temperature */
+  uint32_t anchor_ms;      /**< Time of the anchor */
+  int32_t rate_cdeg_per_min; /**< Latest rate estimate, signed */
+  uint32_t period_ms;      /**< Period picked last */
+  bool primed;             /**< Seen a first measurement */
+} SensorSampling_t;
+
+/**
+ * @brief  Largest change allowed to go unseen at a state of charge
+ */
+uint32_t SensorSampling_ThresholdCdeg(uint8_t soc);
+
+/**
+ * @brief  Start over at SENSOR_SAMPLING_ACTIVE_PERIOD_MS
+ */
+void SensorSampling_Init(SensorSampling_t *sampling);
+
+/**
+ * @brief  Take one measurement into account and pick the next period
+ *
+ * @param  sampling  Policy state
+ * @param  input     Measurement and context
+ * @param  now_ms    Time of the measurement
+ * @return Milliseconds to the next measurement, between
+ *         SENSOR_SAMPLING_FAST_PERIOD_MS and the applicable maximum
+ */
+uint32_t SensorSampling_Update(SensorSampling_t *sampling,
+                               const SensorSamplingInput_t *input,
+                               uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_SENSOR_SAMPLING_H */
@@ -17,6 +17,10 @@
 
 #include "tests.h"
 #include "cmsis_os2.h"
+#include "motor_guard.h"
+#include "self_heating.h"
+#include "sensor_filter.h"
+#include "sensor_sampling.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +34,30 @@ extern "C" {
  */
 #define SENSOR_TASK_MIN_SAMPLING_PERIOD_MS 26U
 
+/**
+ * @def SENSOR_TASK_ADC_TIMEOUT_MS
+ * @brief Longest wait for a triggered ADC sequence to complete
+ * @details While motor measurements are disabled, each measurement powers
+ *          the ADC up, converts one sequence and puts the ADC back into deep
+ *          power-down. Generous against SENSOR_TASK_MIN_SAMPLING_PERIOD_MS
+ *          so the slower host model of the ADC fits as well.
+ */
+#define SENSOR_TASK_ADC_TIMEOUT_MS 1000U
+
+/**
+ * @def SENSOR_TASK_MOTOR_SEQUENCE_US
+ * @brief Duration of one ADC sequence while motor current is measured
+ * @details The continuous sequence is oversampled 4x instead of 256x,
+ *          with the ADC clocked from PLL-P at 64 MHz (ADC_CLOCK_ASYNC_DIV1):
+ *          4 channels * (12.5 + 640.5 cycles) * 4 / 64MHz ≈ 163 us. It
+ *          is the interval of the motor current samples the motor guard
+ *          checks (motor_guard.h), so a stall is cut off within a few ms,
+ *          and that the ripple counter counts (ripple_counter.h): about
+ *          6 kHz, so the commutation ripple of up to RIPPLE_COUNTER_MAX_HZ
+ *          gets several samples a period.
+ */
+#define SENSOR_TASK_MOTOR_SEQUENCE_US 163U
+
 /**
  * @def MOTOR_MEAS_PERIOD_MS
  * @brief Motor current measurement interval in milliseconds
@@ -41,8 +69,10 @@ extern "C" {
 /**
  * @def TEMPERATURE_AND_BAT_MEAS_PERIOD_MS
  * @brief Temperature and battery measurement period in milliseconds
- * @details When motor measurements are disabled, temperature and battery
- *          are sampled at this interval (10 seconds).
+ * @details While motor measurements are enabled, temperature and battery
+ *          are sampled at this interval (10 seconds). Otherwise the period
+ *          adapts between SENSOR_SAMPLING_FAST_PERIOD_MS and minutes, see
+ *          sensor_sampling.h.
  */
 #define TEMPERATURE_AND_BAT_MEAS_PERIOD_MS 10000U
 
@@ -60,17 +90,23 @@ extern "C" {
  * @brief Aggregated sensor measurement values
  * @details Contains calibrated sensor readings: temperature (with offset applied),
  *          battery state-of-charge percentage, motor current (during active measurement),
- *          and battery voltage (when DRIVER_TEST enabled for debugging).
+ *          and battery voltage (when DRIVER_TEST enabled for debugging). Values
+ *          are integers in centi- and milli-units; presenters convert them for
+ *          display.
  * @see SensorModel_t for thread-safe access wrapper
  */
 typedef struct
 {
-  float ambient_temperature;       /**< Current temperature in °C (with offset applied) */
+  int16_t ambient_temperature_cdeg; /**< Filtered temperature in 0.01 °C (with offset applied) */
+  int16_t ambient_temperature_raw_cdeg; /**< Unfiltered temperature in 0.01 °C (self-heating compensated, with offset applied) */
+  int16_t temperature_slope_cdeg_min; /**< Slope of the filtered temperature in 0.01 °C/min (WINDOW_DETECT_NO_SLOPE if unknown) */
+  bool temperature_valid; /**< Set with the first published temperature; until then the temperatures above are 0 */
 #if DRIVER_TEST
-  float battery_voltage;    /**< Battery voltage in V (debug only) */
+  uint16_t battery_mv;      /**< Battery voltage in mV (debug only) */
 #endif
   uint8_t soc;             /**< Battery state-of-charge percentage (0-100%) */
-  float motor_current;      /**< Motor shunt current in amperes */
+  uint16_t battery_days;   /**< Projected battery life in days (0 = unknown) */
+  uint16_t motor_current_ma; /**< Motor shunt current in mA */
 } SensorData_t;
 
 /**
@@ -105,6 +141,8 @@ void StartSensorTask(void *argument);
  * @details Allows sensor task to include motor current in ADC conversion
  *          sequence. Used when motor is active to monitor shunt voltage.
  *          Reduces temperature/battery sampling rate to TEMP_MEAS_PER_MOTOR_MEAS_CYCLES.
+ *          Wakes the sensor task, so measurements start without waiting
+ *          out the current temperature period.
  * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
  * @see SensorTask_StopMotorMeasurements
  */
@@ -112,14 +150,194 @@ void SensorTask_StartMotorMeasurements(void);
 
 /**
  * @brief Disable motor current measurement sampling
- * @details Stops motor current ADC sampling and increases temperature/battery
- *          sampling rate to TEMPERATURE_AND_BAT_MEAS_PERIOD_MS (every 10 seconds).
+ * @details Stops motor current ADC sampling; temperature and battery are
+ *          then sampled at the adaptive period (sensor_sampling.h).
  *          Reduces ADC/DMA traffic when motor is idle.
  * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
  * @see SensorTask_StartMotorMeasurements
  */
 void SensorTask_StopMotorMeasurements(void);
 
+/**
+ * @brief Change the ambient temperature filter at runtime
+ * @details The sensor task applies the parameters on its next temperature
+ *          measurement; the filter keeps its state, so the published value
+ *          does not jump. See sensor_filter.h for the stages.
+ * @param params Median window, IIR time constant and rate limit
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+void SensorTask_SetTemperatureFilter(const SensorFilterParams_t *params);
+
+/**
+ * @brief Read the ambient temperature filter parameters last set
+ * @param params Receives the parameters
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+void SensorTask_GetTemperatureFilter(SensorFilterParams_t *params);
+
+/**
+ * @brief Change the self-heating compensation at runtime
+ * @details The sensor task applies the coefficients on its next temperature
+ *          measurement and keeps the lagged activity. See self_heating.h for
+ *          the model; tau_s = 0 turns the compensation off.
+ * @param params Thermal time constant and rise per heat source
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+void SensorTask_SetSelfHeating(const SelfHeatingParams_t *params);
+
+/**
+ * @brief Read the self-heating coefficients last set
+ * @param params Receives the coefficients
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+void SensorTask_GetSelfHeating(SelfHeatingParams_t *params);
+
+/**
+ * @brief Set the target temperature the sampling period watches
+ * @details The sensor task samples faster while the temperature is about to
+ *          cross it.
+ * @param setpoint_cdeg Target in 0.01 °C, or SENSOR_SAMPLING_NO_SETPOINT
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+void SensorTask_SetSetpoint(int32_t setpoint_cdeg);
+
+/**
+ * @brief Report user input to the sensor task
+ * @details Wakes the sensor task for a fresh measurement if the device was
+ *          unattended, and keeps the period at most
+ *          SENSOR_SAMPLING_ACTIVE_PERIOD_MS for SENSOR_SAMPLING_ACTIVE_MS.
+ * @note Thread-safe; call from task context
+ */
+void SensorTask_NotifyUserActivity(void);
+
+/**
+ * @brief Change the motor overcurrent and stall thresholds
+ * @param config Thresholds, see motor_guard.h
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+void SensorTask_SetMotorGuard(const MotorGuardConfig_t *config);
+
+/**
+ * @brief Make the calling task the one told about motor cut-offs
+ * @details While motor measurements are enabled the DMA interrupt of each
+ *          ADC sequence checks the motor current. On a stall or overcurrent
+ *          it brakes the motor (MOTOR_BRAKE) at once and sets @p flags on
+ *          the owner, which reads the reason with
+ *          SensorTask_TakeMotorTrip(). A move started with
+ *          SensorTask_MoveMotor() that reaches its target sets @p flags
+ *          too, with the reason MOTOR_GUARD_OK. A motor driven without
+ *          motor measurements enabled is neither protected nor counted.
+ * @param flags Thread flags to set, 0 to stop notifying
+ * @note Thread-safe; call from task context
+ */
+void SensorTask_SetMotorGuardOwner(uint32_t flags);
+
+/**
+ * @brief Read and clear the reason of the last motor cut-off
+ * @return MOTOR_GUARD_OK if the motor was not cut off since the last call
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+MotorGuardReason_t SensorTask_TakeMotorTrip(void);
+
+/**
+ * @brief Drive the valve motor by a number of commutation ripples
+ * @details Enables motor measurements and has the DMA interrupt start the
+ *          motor with its next sequence, so the ripple counter
+ *          (ripple_counter.h) sees the run from the start. The interrupt
+ *          brakes the motor once the counted ripples and the predicted
+ *          run-on reach @p ripples, or on a cut-off, and tells the owner
+ *          (SensorTask_SetMotorGuardOwner()). The caller disables motor
+ *          measurements when it is done.
+ * @param direction 1 for MOTOR_FORWARD, -1 for MOTOR_BACKWARD
+ * @param ripples   Length of the move, > 0
+ * @return false if the arguments are invalid
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+bool SensorTask_MoveMotor(int8_t direction, uint32_t ripples);
+
+/**
+ * @brief Let the valve motor coast, ending a move before its target
+ * @details Cancels a move not yet started. The counted position gets the
+ *          predicted run-on with the next motor sequence.
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL, which
+ *       also masks the DMA interrupt that drives the motor
+ */
+void SensorTask_StopMotor(void);
+
+/**
+ * @brief Valve position in ripples, counted while motor measurements are
+ *        enabled; forward counts up
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+int32_t SensorTask_GetValvePosition(void);
+
+/**
+ * @brief Set the valve position, e.g. to 0 at a seat found by a stall
+ * @note Thread-safe; uses taskENTER_CRITICAL/taskEXIT_CRITICAL
+ */
+void SensorTask_SetValvePosition(int32_t position);
+
+/**
+ * @def SENSOR_TASK_MAX_SUBSCRIBERS
+ * @brief Tasks that can be subscribed to sensor changes at the same time
+ */
+#ifndef SENSOR_TASK_MAX_SUBSCRIBERS
+#define SENSOR_TASK_MAX_SUBSCRIBERS 4U
+#endif
+
+/**
+ * @typedef SensorThresholds_t
+ * @brief Smallest changes of the published values a subscriber is woken for
+ * @details Each change is measured from the values the subscriber was last
+ *          notified of, so slow drifts add up until they cross the
+ *          threshold. A threshold of 0 ignores the value.
+ * @see SensorTask_Subscribe
+ */
+typedef struct {
+  uint16_t temperature_cdeg; /**< Filtered temperature, in 0.01 °C */
+  uint16_t motor_current_ma; /**< Motor current, in mA */
+#if DRIVER_TEST
+  uint16_t battery_mv;       /**< Battery voltage, in mV */
+#endif
+  uint8_t soc;               /**< State of charge, in percent */
+  uint16_t battery_days;     /**< Projected battery life, in days */
+} SensorThresholds_t;
+
+/**
+ * @brief Subscribe the calling task to changes of the sensor values
+ * @details After each update of the SensorModel_t the sensor task sets
+ *          @p flags on the subscribed task if any value moved by its
+ *          threshold, and on the first update after subscribing. The
+ *          subscriber reads the model only then, instead of polling it.
+ * @param flags Thread flags to set (osThreadFlagsSet())
+ * @param thresholds Changes to notify, copied
+ * @return Subscription handle, or -1 if the table is full or the arguments
+ *         are invalid
+ * @note Thread-safe; call from task context
+ * @see SensorTask_Unsubscribe
+ */
+int32_t SensorTask_Subscribe(uint32_t flags,
+                             const SensorThresholds_t *thresholds);
+
+/**
+ * @brief End a subscription
+ * @param subscription Handle returned by SensorTask_Subscribe(); negative
+ *                     handles are ignored
+ * @note Thread-safe; the task may still find its flags set once afterwards
+ */
+void SensorTask_Unsubscribe(int32_t subscription);
+
+/**
+ * @brief Check two sets of sensor values against subscription thresholds
+ * @param thresholds Thresholds of the subscriber
+ * @param notified Values the subscriber was last notified of
+ * @param current Values just published
+ * @return true if any value with a non-zero threshold moved by it or more
+ */
+bool SensorTask_ExceedsThresholds(const SensorThresholds_t *thresholds,
+                                  const SensorData_t *notified,
+                                  const SensorData_t *current);
+
 /**
  * @def SENSOR_TASK_STACK_SIZE
  * @brief Stack size in bytes for the sensor measurement task
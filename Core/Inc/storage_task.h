@@ -69,18 +69,41 @@ typedef struct {
   TimeSlotTypeDef time_slots[5];   /**< Array of time slot configurations */
 } DailyScheduleTypeDef;
 
+/** Days of the weekly schedule, Monday first */
+#define SCHEDULE_DAYS 7U
+
+/** Maximum number of time slots per day */
+#define SCHEDULE_MAX_SLOTS 5U
+
+/**
+ * @typedef WeeklyScheduleTypeDef
+ * @brief Heating schedule with its own slot list for every weekday
+ * @details Each slot is packed into 16 bits: the start time in
+ *          SCHEDULE_STEP_MIN steps after midnight (bits 0-8) and the
+ *          temperature index of Utils_TempToIndex() (bits 9-14). A slot
+ *          ends where the next one starts, the last one at midnight.
+ *          Access through schedule.h.
+ */
+typedef struct {
+  uint8_t num_slots[SCHEDULE_DAYS];  /**< Slots per day (1-5), Monday first */
+  uint16_t slots[SCHEDULE_DAYS][SCHEDULE_MAX_SLOTS]; /**< Packed slots */
+} WeeklyScheduleTypeDef;
+
 /**
  * @typedef ConfigData_t
  * @brief Device configuration parameters stored in Flash
  * @details All user-configurable settings persisted across power cycles.
  *          Temperature offset allows sensor calibration compensation.
  *          Manual target temperature used in non-scheduled operation.
- * @see DailyScheduleTypeDef
+ *          The heat-up rate is learned by optimum start, not set by the
+ *          user.
+ * @see WeeklyScheduleTypeDef
  */
 typedef struct {
   float temperature_offset;        /**< Temperature sensor calibration offset in °C */
-  DailyScheduleTypeDef daily_schedule; /**< Daily heating schedule */
+  WeeklyScheduleTypeDef schedule;  /**< Weekly heating schedule */
   float manual_target_temp;          /**< Manual mode target temperature in °C */
+  uint16_t heatup_rate_cdeg_h;       /**< Learned heat-up rate in 0.01 °C/h, 0 = none */
 } ConfigData_t;
 
 /**
@@ -125,6 +148,16 @@ void StartStorageTask(void *argument);
 bool StorageTask_TryGetEvent(Storage2SystemEventTypeDef *event,
                              uint32_t timeout_ticks);
 
+/**
+ * @brief Calculate the checksum stored with the configuration in Flash
+ * @details Byte sum with a rotate-left after every byte over the bit-packed
+ *          encoding of config_codec.h, so padding and float bits that the
+ *          record does not store do not count.
+ * @param config Configuration to checksum
+ * @return Checksum value, 0 for a null pointer or an invalid schedule
+ */
+uint32_t StorageTask_CalculateChecksum(const ConfigData_t *config);
+
 /**
  * @def STORAGE_TASK_STACK_SIZE
  * @brief Stack size in bytes for the storage management task
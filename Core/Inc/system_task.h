@@ -23,6 +23,7 @@
 
 #include "cmsis_os2.h"
 #include "main.h"
+#include "temp_history.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -66,11 +67,13 @@ typedef enum {
  *          - MODE_AUTO: Follow daily schedule from configuration
  *          - MODE_MANUAL: Use fixed manual target temperature
  *          - MODE_BOOST: Maximum heating for specified duration (300 seconds)
+ *          - MODE_WINDOW_OPEN: Valve shut while an open window is detected
  */
 typedef enum {
   MODE_AUTO = 0,            /**< Schedule-based automatic mode */
   MODE_MANUAL = 1,          /**< Fixed temperature manual mode */
-  MODE_BOOST = 2            /**< Opens valve at 80% for 300 seconds*/
+  MODE_BOOST = 2,           /**< Opens valve at 80% for 300 seconds*/
+  MODE_WINDOW_OPEN = 3      /**< Frost protection until the window closes */
 } SystemMode_t;
 
 /**
@@ -96,6 +99,7 @@ typedef struct {
   SystemState_t state;              /**< Current system state */
   SystemMode_t mode;                /**< Current operating mode (AUTO/MANUAL/BOOST) */
   SystemMode_t mode_before_boost;   /**< Previous mode before BOOST was activated */
+  SystemMode_t mode_before_window;  /**< Mode restored when the window closes */
   uint32_t boost_begin_time;        /**< Tick count when BOOST mode started */
   AdaptResult_t adapt_result;       /**< Result of last adaptation attempt */
   float target_temp;                /**< Target temperature in °C */
@@ -117,6 +121,18 @@ typedef struct {
   SystemData_t data;    /**< System context data (protected by mutex) */
 } SystemModel_t;
 
+/**
+ * @typedef HistoryModel_t
+ * @brief Thread-safe access wrapper for the temperature history
+ * @details The system task records into it every run in RUNNING; the history
+ *          view reads it to plot the last 24 h, 7 days or 30 days.
+ * @see TempHistory_t
+ */
+typedef struct {
+  osMutexId_t mutex;    /**< CMSIS-RTOS2 mutex for thread-safe access */
+  TempHistory_t data;   /**< Temperature history (protected by mutex) */
+} HistoryModel_t;
+
 /**
  * @typedef VP2SystemEventTypeDef
  * @brief ViewPresenter to System event type
@@ -144,8 +160,9 @@ typedef enum {
   EVT_SYS_INIT_END = 0      /**< System initialization complete */
 } System2VPEventTypeDef;
 
-/* Forward declaration */
+/* Forward declarations */
 typedef struct ConfigModel_t ConfigModel_t;
+typedef struct SensorModel_t SensorModel_t;
 
 /**
  * @typedef SystemTaskArgsTypeDef
@@ -164,6 +181,10 @@ typedef struct {
       *system_model;                              /**< Pointer to system state context */
   ConfigModel_t
       *config_model;                              /**< Pointer to configuration/schedule data */
+  SensorModel_t
+      *sensor_model;                              /**< Room temperature, for optimum start */
+  HistoryModel_t
+      *history_model;                             /**< Temperature history recorded while running */
 } SystemTaskArgsTypeDef;
 
 /**
@@ -109,4 +109,182 @@
 #define VIEW_PRESENTER_TASK_DEBUG_LEDS 0
 #endif
 
+/**
+ * @def OS_TASKS_RUNTIME_STATS
+ *
+ * @brief  Enable periodic per-task CPU usage and stack high-water report
+ *
+ * @details  When enabled (set to 1), the default task prints a compact table
+ *           every OS_TASKS_RUNTIME_STATS_PERIOD_MS with the CPU share of each
+ *           task over the last period (measured with the DWT cycle counter),
+ *           the minimum free stack ever seen (uxTaskGetStackHighWaterMark)
+ *           and the current/minimum free heap. Use it to right-size task
+ *           stacks and find CPU hogs under real use. Default: 0 (disabled).
+ */
+#ifndef OS_TASKS_RUNTIME_STATS
+#define OS_TASKS_RUNTIME_STATS 0
+#endif
+
+/**
+ * @def OS_TASKS_RUNTIME_STATS_PERIOD_MS
+ *
+ * @brief  Reporting period of OS_TASKS_RUNTIME_STATS in milliseconds
+ */
+#ifndef OS_TASKS_RUNTIME_STATS_PERIOD_MS
+#define OS_TASKS_RUNTIME_STATS_PERIOD_MS 10000U
+#endif
+
+/**
+ * @def OS_TRACE_ENABLED
+ *
+ * @brief  Enable the binary span trace ring (see trace.h)
+ *
+ * @details  When enabled (set to 1), hot paths (state machine, router, LVGL
+ *           timer handler and flush, sensor loop, flash writes) and model
+ *           mutex waits record begin/end events with cycle timestamps into a
+ *           RAM ring buffer. The ring can be read with a debugger or dumped
+ *           over the UART and converted with Tools/trace2chrome.py.
+ *           When disabled the trace macros compile to nothing. Default: 0
+ *           (disabled).
+ */
+#ifndef OS_TRACE_ENABLED
+#define OS_TRACE_ENABLED 0
+#endif
+
+/**
+ * @def OS_TRACE_RING_EVENTS
+ *
+ * @brief  Trace ring capacity in events (8 bytes each, power of two)
+ */
+#ifndef OS_TRACE_RING_EVENTS
+#define OS_TRACE_RING_EVENTS 1024U
+#endif
+
+/**
+ * @def OS_TRACE_UART_DUMP
+ *
+ * @brief  Dump the trace ring over the UART from the default task
+ *
+ * @details  When enabled (set to 1) together with OS_TRACE_ENABLED, the
+ *           default task prints the ring contents once per period (60 s, or
+ *           OS_TASKS_RUNTIME_STATS_PERIOD_MS with run-time stats enabled).
+ *           Leave disabled to read the ring with a debugger only.
+ *           Default: 0 (disabled).
+ */
+#ifndef OS_TRACE_UART_DUMP
+#define OS_TRACE_UART_DUMP 0
+#endif
+
+/**
+ * @def IPC_PROFILE_ENABLED
+ *
+ * @brief  Enable the mutex/queue contention profiler (see ipc_profile.h)
+ *
+ * @details  When enabled (set to 1), every IPC_MUTEX_ACQUIRE,
+ *           IPC_MUTEX_RELEASE and IPC_QUEUE_PUT call site records wait time,
+ *           hold time, timeouts, queue depth high-water and dropped puts, and
+ *           the default task prints the per-site table once per period
+ *           (60 s, or OS_TASKS_RUNTIME_STATS_PERIOD_MS with run-time stats
+ *           enabled). Costs a few hundred bytes of RAM per hundred sites and
+ *           two cycle counter reads per call. Default: 0 (disabled).
+ */
+#ifndef IPC_PROFILE_ENABLED
+#define IPC_PROFILE_ENABLED 0
+#endif
+
+/**
+ * @def DEFERRED_LOG_ENABLED
+ *
+ * @brief  Route DLOG() messages through the deferred log task
+ *
+ * @details  When enabled (set to 1), DLOG() only queues the format string
+ *           pointer and raw arguments (a few dozen cycles) and the
+ *           low-priority log task formats and prints them later, so float
+ *           formatting and UART output no longer stall the calling task.
+ *           When disabled, DLOG() is printf() and no log task (or its
+ *           stack) is created.
+ *           Default: 0 (disabled).
+ */
+#ifndef DEFERRED_LOG_ENABLED
+#define DEFERRED_LOG_ENABLED 0
+#endif
+
+/**
+ * @def DEFERRED_LOG_BINARY
+ *
+ * @brief  Emit deferred log messages undecoded
+ *
+ * @details  When enabled (set to 1), the log task prints "DL" lines with the
+ *           tick, format string address and argument words in hex instead of
+ *           formatting on the target. Decode them with
+ *           Tools/dlog_decode.py and the matching ELF file. Default: 0
+ *           (disabled).
+ */
+#ifndef DEFERRED_LOG_BINARY
+#define DEFERRED_LOG_BINARY 0
+#endif
+
+/**
+ * @def BENCHMARKS_ENABLED
+ *
+ * @brief  Run the kernel micro-benchmarks at startup (see benchmarks.h)
+ *
+ * @details  When enabled (set to 1), the default task runs Benchmarks_Run()
+ *           once after all tasks are created and prints one "BENCH" JSON
+ *           line per kernel. Check the log against the stored baselines with
+ *           Tools/bench_compare.py. The host build runs the same benchmarks
+ *           with --bench regardless of this flag. Default: 0 (disabled).
+ */
+#ifndef BENCHMARKS_ENABLED
+#define BENCHMARKS_ENABLED 0
+#endif
+
+/**
+ * @def MEM_HEAP_REPORT
+ *
+ * @brief  Print the unified heap report periodically (see mem_heap.h)
+ *
+ * @details  When enabled (set to 1), the default task prints the per-owner
+ *           usage, fragmentation and per-route peak tables once per period
+ *           (60 s, or OS_TASKS_RUNTIME_STATS_PERIOD_MS with run-time stats
+ *           enabled). The host build prints the same report with the heap
+ *           command. Default: 0 (disabled).
+ */
+#ifndef MEM_HEAP_REPORT
+#define MEM_HEAP_REPORT 0
+#endif
+
+/**
+ * @def REPLAY_RECORD_ENABLED
+ *
+ * @brief  Record inputs, ADC samples and RTC reads for replay (see replay.h)
+ *
+ * @details  When enabled (set to 1), recording starts before the scheduler
+ *           and the default task prints the new trace bytes as "RPL" lines
+ *           once per period (60 s, or OS_TASKS_RUNTIME_STATS_PERIOD_MS with
+ *           run-time stats enabled). Convert the log with
+ *           Tools/replay_tool.py and replay it in the host build with
+ *           --replay. The host build records with --record instead; leave
+ *           this flag off there. Default: 0 (disabled).
+ */
+#ifndef REPLAY_RECORD_ENABLED
+#define REPLAY_RECORD_ENABLED 0
+#endif
+
+/**
+ * @def ENERGY_REPORT
+ *
+ * @brief  Print the energy accounting periodically (see energy.h)
+ *
+ * @details  When enabled (set to 1), the default task prints the charge drawn
+ *           per sink, the battery-life projection and an "ENERGY" JSON line
+ *           for export once per period (60 s, or
+ *           OS_TASKS_RUNTIME_STATS_PERIOD_MS with run-time stats enabled).
+ *           The host build prints the same report with the energy command.
+ *           Default: 0 (disabled).
+ */
+#ifndef ENERGY_REPORT
+#define ENERGY_REPORT 0
+#endif
+
 #endif /* CORE_INC_TASK_DEBUG_H */
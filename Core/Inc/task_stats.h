@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ * @file           :  task_stats.h
+ * @brief          :  Per-task CPU usage and stack high-water reporting
+ *
+ * @details        :  Samples the FreeRTOS run-time statistics (driven by the
+ *                    DWT cycle counter, see app_freertos.c) and prints a
+ *                    compact per-task table over the log UART. CPU shares are
+ *                    computed over the interval since the previous report.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_TASK_STATS_H
+#define CORE_INC_TASK_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TASK_STATS_MAX_TASKS
+ *
+ * @brief  Maximum number of tasks tracked in one report (application tasks,
+ *         idle and timer service task)
+ */
+#define TASK_STATS_MAX_TASKS 12U
+
+/**
+ * @brief  Print the run-time statistics report
+ *
+ * @details  Output format (one header line, then one line per task in
+ *           creation order):
+ *           @code
+ *           STATS t=60012ms win=10000ms heap=9384 min=9120
+ *           defaultTask        0.0%  3724B p24 B
+ *           lvglTask          11.4%  3012B p41 B
+ *           ...
+ *           @endcode
+ *           CPU share is given in 0.1 % steps over the window since the
+ *           previous call, stack is the minimum free stack ever seen in
+ *           bytes, pNN the current priority and the last column the task
+ *           state (R)unning, r(E)ady, (B)locked, (S)uspended, (D)eleted.
+ *
+ * @return void
+ *
+ * @note   Must be called from task context; suspends the scheduler while
+ *         collecting the task states.
+ */
+void TaskStats_Report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_TASK_STATS_H */
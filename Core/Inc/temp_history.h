@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file           :  temp_history.h
+ * @brief          :  Multi-resolution history of the room temperature
+ *
+ * @details        :  Three rings of points, each the minimum, maximum and
+ *                    mean temperature, the mean target and the valve
+ *                    activity over the samples of its interval:
+ *                      TEMP_HISTORY_TIER_MINUTE  1 min points for 24 h
+ *                      TEMP_HISTORY_TIER_QUARTER 15 min points for 7 days
+ *                      TEMP_HISTORY_TIER_HOUR    1 h points for 30 days
+ *                    Samples are folded into the open minute; a closed
+ *                    minute is stored and its sums folded into the open
+ *                    quarter, a closed quarter's into the open hour. While
+ *                    samples come at least once a minute, every
+ *                    TempHistory_Add() therefore does a constant amount of
+ *                    work, closing at most one point per tier. The rings
+ *                    are fixed arrays; the build fails if TempHistory_t
+ *                    outgrows TEMP_HISTORY_MAX_BYTES. Integer arithmetic
+ *                    and no RTOS calls, like sensor_sampling.h; the system
+ *                    task keeps it in a HistoryModel_t.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_TEMP_HISTORY_H
+#define CORE_INC_TEMP_HISTORY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TEMP_HISTORY_MINUTE_POINTS
+ * @brief 1-minute points kept (24 h)
+ */
+#ifndef TEMP_HISTORY_MINUTE_POINTS
+#define TEMP_HISTORY_MINUTE_POINTS 1440U
+#endif
+
+/**
+ * @def TEMP_HISTORY_QUARTER_POINTS
+ * @brief 15-minute points kept (7 days)
+ */
+#ifndef TEMP_HISTORY_QUARTER_POINTS
+#define TEMP_HISTORY_QUARTER_POINTS 672U
+#endif
+
+/**
+ * @def TEMP_HISTORY_HOUR_POINTS
+ * @brief 1-hour points kept (30 days)
+ */
+#ifndef TEMP_HISTORY_HOUR_POINTS
+#define TEMP_HISTORY_HOUR_POINTS 720U
+#endif
+
+/**
+ * @def TEMP_HISTORY_MAX_BYTES
+ * @brief RAM the history may take; checked at compile time
+ */
+#ifndef TEMP_HISTORY_MAX_BYTES
+#define TEMP_HISTORY_MAX_BYTES (24U * 1024U)
+#endif
+
+#define TEMP_HISTORY_MINUTE_MS 60000U
+#define TEMP_HISTORY_MINUTES_PER_QUARTER 15U
+#define TEMP_HISTORY_QUARTERS_PER_HOUR 4U
+
+/**
+ * @brief  Resolutions, finest first
+ */
+typedef enum {
+  TEMP_HISTORY_TIER_MINUTE = 0, /**< 1 min points */
+  TEMP_HISTORY_TIER_QUARTER,    /**< 15 min points */
+  TEMP_HISTORY_TIER_HOUR,       /**< 1 h points */
+  TEMP_HISTORY_TIER_COUNT
+} TempHistoryTier_t;
+
+/**
+ * @brief  One interval; min_cdeg > max_cdeg marks an interval without
+ *         samples (TempHistory_IsGap())
+ */
+typedef struct {
+  int16_t min_cdeg;     /**< Lowest temperature */
+  int16_t max_cdeg;     /**< Highest temperature */
+  int16_t avg_cdeg;     /**< Mean temperature */
+  uint8_t target_index; /**< Mean target as Utils_TempToIndex() */
+  uint8_t valve;        /**< Motor on-time in 1/255 of the interval, rounded
+                             up so that any movement shows */
+} TempHistoryPoint_t;
+
+/**
+ * @brief  Point being collected
+ */
+typedef struct {
+  int32_t sum_cdeg;     /**< Sum of the samples' temperatures */
+  uint32_t target_sum;  /**< Sum of their target indices */
+  uint32_t motor_ms;    /**< Motor on-time in the interval */
+  uint32_t samples;     /**< Samples in the interval */
+  uint16_t children;    /**< Finer points folded in */
+  int16_t min_cdeg;
+  int16_t max_cdeg;
+} TempHistoryAccum_t;
+
+/**
+ * @brief  Ring of one resolution
+ */
+typedef struct {
+  uint16_t head;            /**< Next slot to write */
+  uint16_t count;           /**< Valid points */
+  TempHistoryAccum_t accum; /**< Open point */
+} TempHistoryRing_t;
+
+/**
+ * @brief  The whole history
+ */
+typedef struct {
+  TempHistoryPoint_t minutes[TEMP_HISTORY_MINUTE_POINTS];
+  TempHistoryPoint_t quarters[TEMP_HISTORY_QUARTER_POINTS];
+  TempHistoryPoint_t hours[TEMP_HISTORY_HOUR_POINTS];
+  TempHistoryRing_t rings[TEMP_HISTORY_TIER_COUNT];
+  uint32_t minute_start_ms; /**< Start of the open minute */
+  uint32_t last_motor_ms;   /**< Motor on-time total at the last sample */
+  bool primed;              /**< Seen a first sample */
+} TempHistory_t;
+
+_Static_assert(sizeof(TempHistory_t) <= TEMP_HISTORY_MAX_BYTES,
+               "TempHistory_t exceeds TEMP_HISTORY_MAX_BYTES");
+
+/**
+ * @brief  Empty all rings
+ */
+void TempHistory_Init(TempHistory_t *history);
+
+/**
+ * @brief  Fold in one sample, closing the minute (and coarser points) it
+ *         ends
+ * @param  now_ms        Free-running millisecond time, may wrap
+ * @param  cdeg          Room temperature
+ * @param  target_index  Target as Utils_TempToIndex()
+ * @param  motor_ms      Motor on-time since boot; the history takes the
+ *                       difference to the previous sample
+ * @note   Minutes without samples are stored as gaps; after a stall longer
+ *         than TEMP_HISTORY_MINUTE_POINTS minutes the open minute is closed
+ *         and the next one starts at this sample, without gaps
+ */
+void TempHistory_Add(TempHistory_t *history, uint32_t now_ms, int32_t cdeg,
+                     uint8_t target_index, uint32_t motor_ms);
+
+/**
+ * @brief  Points held at a resolution
+ */
+uint16_t TempHistory_Count(const TempHistory_t *history,
+                           TempHistoryTier_t tier);
+
+/**
+ * @brief  Points a resolution can hold
+ */
+uint16_t TempHistory_Capacity(TempHistoryTier_t tier);
+
+/**
+ * @brief  Length of one point of a resolution in minutes
+ */
+uint16_t TempHistory_PointMinutes(TempHistoryTier_t tier);
+
+/**
+ * @brief  Read a stored point
+ * @param  age  0 for the newest closed point
+ * @return false if there is no point that old
+ */
+bool TempHistory_Get(const TempHistory_t *history, TempHistoryTier_t tier,
+                     uint16_t age, TempHistoryPoint_t *point);
+
+/**
+ * @brief  Whether a point has no temperature
+ */
+bool TempHistory_IsGap(const TempHistoryPoint_t *point);
+
+/**
+ * @brief  Merge the full span of a resolution into @p n columns, oldest
+ *         first, for plotting; columns before the first point are gaps
+ * @note   Walks every slot of the resolution once
+ */
+void TempHistory_Columns(const TempHistory_t *history, TempHistoryTier_t tier,
+                         TempHistoryPoint_t *columns, uint16_t n);
+
+/**
+ * @brief  Print the RAM taken, the points held and a "HISTORY {...}" JSON
+ *         line
+ */
+void TempHistory_Report(const TempHistory_t *history);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_TEMP_HISTORY_H */
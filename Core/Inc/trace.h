@@ -0,0 +1,174 @@
+/**
+ ******************************************************************************
+ * @file           :  trace.h
+ * @brief          :  Low-overhead binary span trace ring
+ *
+ * @details        :  Records begin/end/instant events with DWT cycle
+ *                    timestamps into a RAM ring buffer. Each event is 8 bytes
+ *                    (timestamp, span ID, task number, phase, argument) and
+ *                    is reserved with a single atomic increment, so recording
+ *                    is safe from any task or ISR and never blocks. The ring
+ *                    carries its own header and name tables, so a raw RAM
+ *                    dump of g_trace_ring is self-describing; Trace_Dump()
+ *                    prints the same data over the UART. Tools/trace2chrome.py
+ *                    converts either form to Chrome trace JSON.
+ *
+ *                    All macros compile to nothing (TRACE_MUTEX_ACQUIRE to a
+ *                    plain osMutexAcquire) unless OS_TRACE_ENABLED is set in
+ *                    task_debug.h.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_TRACE_H
+#define CORE_INC_TRACE_H
+
+#include <stdint.h>
+
+#include "cmsis_os2.h"
+#include "task_debug.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Traced span identifiers
+ *
+ * @note   Keep in sync with SPAN_NAMES in Tools/trace2chrome.py (only used
+ *         for RAM dumps; UART dumps carry the names).
+ */
+typedef enum {
+  TRACE_ID_SYSTEM_SM_RUN = 0,
+  TRACE_ID_ROUTER_EVENT,
+  TRACE_ID_ROUTER_TICK,
+  TRACE_ID_LV_TIMER,
+  TRACE_ID_LV_FLUSH,
+  TRACE_ID_SENSOR_LOOP,
+  TRACE_ID_FLASH_WRITE,
+  TRACE_ID_MUTEX_WAIT,
+  TRACE_ID_COUNT
+} TraceId_t;
+
+/**
+ * @brief  Event phase, matching the Chrome trace "B", "E" and "i" phases
+ */
+typedef enum {
+  TRACE_PHASE_BEGIN = 0,
+  TRACE_PHASE_END = 1,
+  TRACE_PHASE_INSTANT = 2
+} TracePhase_t;
+
+#define TRACE_MAGIC 0x5254544DUL /* "MTTR" */
+#define TRACE_VERSION 1U
+#define TRACE_NAME_LEN 16U
+#define TRACE_MAX_TASKS 16U   /* task numbers 1..15, 0 = unregistered */
+#define TRACE_MAX_OBJECTS 8U  /* mutexes seen by TRACE_MUTEX_ACQUIRE */
+
+/**
+ * @brief  One trace event (8 bytes)
+ */
+typedef struct {
+  uint32_t cycles; /*!< DWT cycle counter at the event (wraps) */
+  uint16_t arg;    /*!< Span-specific argument */
+  uint8_t id;      /*!< TraceId_t */
+  uint8_t task;    /*!< Bits 7..2: task number, bits 1..0: TracePhase_t */
+} TraceEvent_t;
+
+/**
+ * @brief  Trace ring as laid out in RAM (little-endian, no padding)
+ *
+ * @details  @c count is the total number of events ever reserved; the newest
+ *           event lives at index (count - 1) & (capacity - 1).
+ */
+typedef struct {
+  uint32_t magic;         /*!< TRACE_MAGIC */
+  uint16_t version;       /*!< TRACE_VERSION */
+  uint16_t event_size;    /*!< sizeof(TraceEvent_t) */
+  uint32_t capacity;      /*!< Number of events in the ring */
+  uint32_t cpu_hz;        /*!< Cycle counter frequency */
+  volatile uint32_t count;  /*!< Events reserved so far */
+  volatile uint32_t paused; /*!< Non-zero while the ring is being read */
+  uint16_t name_len;      /*!< TRACE_NAME_LEN */
+  uint8_t max_tasks;      /*!< TRACE_MAX_TASKS */
+  uint8_t max_objects;    /*!< TRACE_MAX_OBJECTS */
+  char task_names[TRACE_MAX_TASKS][TRACE_NAME_LEN];
+  char object_names[TRACE_MAX_OBJECTS][TRACE_NAME_LEN];
+  TraceEvent_t events[OS_TRACE_RING_EVENTS];
+} TraceRing_t;
+
+#if OS_TRACE_ENABLED
+
+/** Trace ring, exported so it can be located in a RAM dump via the map file */
+extern TraceRing_t g_trace_ring;
+
+/**
+ * @brief  Number the existing tasks and start recording
+ *
+ * @details  Assigns each task a trace number (vTaskSetTaskNumber), stores
+ *           task names in the ring and latches the core clock. Call once all
+ *           tasks are created; events of tasks created later are attributed
+ *           to task 0.
+ */
+void Trace_Start(void);
+
+/**
+ * @brief  Append one event to the ring (task or ISR context)
+ */
+void Trace_Record(TraceId_t id, TracePhase_t phase, uint16_t arg);
+
+/**
+ * @brief  osMutexAcquire() wrapped in a TRACE_ID_MUTEX_WAIT span
+ *
+ * @details  The begin event carries the mutex index in the object table, the
+ *           end event 1 when the mutex was acquired and 0 otherwise.
+ */
+osStatus_t Trace_MutexAcquire(osMutexId_t mutex, uint32_t timeout);
+
+/**
+ * @brief  Print the ring over the UART
+ *
+ * @details  Output format:
+ *           @code
+ *           TRACE BEGIN v=1 hz=32000000 cap=1024 count=53120 size=8
+ *           TRACE SPAN 0 SystemSM_Run
+ *           TRACE TASK 1 defaultTask
+ *           TRACE OBJ 0 configMutex
+ *           TRACE DATA <event bytes as hex, 8 events per line>
+ *           TRACE END
+ *           @endcode
+ *           DATA lines hold the valid events oldest first. Recording is
+ *           paused while dumping.
+ */
+void Trace_Dump(void);
+
+#define TRACE_START() Trace_Start()
+#define TRACE_BEGIN(id, arg)                                                   \
+  Trace_Record((id), TRACE_PHASE_BEGIN, (uint16_t)(arg))
+#define TRACE_END(id, arg) Trace_Record((id), TRACE_PHASE_END, (uint16_t)(arg))
+#define TRACE_INSTANT(id, arg)                                                 \
+  Trace_Record((id), TRACE_PHASE_INSTANT, (uint16_t)(arg))
+#define TRACE_MUTEX_ACQUIRE(mutex, timeout)                                    \
+  Trace_MutexAcquire((mutex), (timeout))
+
+#else
+
+#define TRACE_START() ((void)0)
+#define TRACE_BEGIN(id, arg) ((void)0)
+#define TRACE_END(id, arg) ((void)0)
+#define TRACE_INSTANT(id, arg) ((void)0)
+#define TRACE_MUTEX_ACQUIRE(mutex, timeout) osMutexAcquire((mutex), (timeout))
+
+#endif /* OS_TRACE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_TRACE_H */
@@ -30,6 +30,14 @@
 extern "C" {
 #endif
 
+/**
+ * @def    UTILS_TEMP_INDEX_ON
+ * @brief  Highest temperature index, ON (valve fully open)
+ *
+ * @details  Index 0 is OFF; indices 1-50 are 5.0-29.5°C in 0.5°C steps.
+ */
+#define UTILS_TEMP_INDEX_ON 51U
+
 /**
  * @brief  Load default schedule into the provided structure
  *
@@ -98,6 +106,22 @@ float Utils_IndexToTemp(uint16_t index);
  */
 uint16_t Utils_TempToIndex(float temp);
 
+/**
+ * @brief  Convert temperature index to hundredths of a degree Celsius
+ *
+ * @details  Integer form of Utils_IndexToTemp() for the control code, which
+ *           works in centidegrees: index 0 (OFF) is 450, index 51 (ON) 3000.
+ *
+ * @param  index  The temperature index value (0-51)
+ *
+ * @return Temperature in hundredths of a degree Celsius (450 to 3000)
+ *
+ * @note   Index values above 51 are clamped to ON
+ *
+ * @see    Utils_IndexToTemp
+ */
+int32_t Utils_IndexToCentiDegrees(uint16_t index);
+
 /**
  * @brief  Generate temperature option string for UI roller/selector
  *
@@ -118,6 +142,17 @@ uint16_t Utils_TempToIndex(float temp);
  */
 void Utils_GenerateTempOptions(char *buffer, size_t size);
 
+/**
+ * @brief  Day of the week of a Gregorian date
+ *
+ * @param  year   Full year, e.g. 2025
+ * @param  month  Month (1-12)
+ * @param  day    Day of the month (1-31)
+ *
+ * @return 1 = Monday to 7 = Sunday, the numbering of RTC_WEEKDAY_x
+ */
+uint8_t Utils_DayOfWeek(uint16_t year, uint8_t month, uint8_t day);
+
 #ifdef __cplusplus
 }
 #endif
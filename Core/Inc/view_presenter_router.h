@@ -45,6 +45,7 @@ extern "C" {
  *          - ROUTE_MENU: Settings menu
  *          - ROUTE_EDIT_TEMP_OFFSET: Temperature sensor offset calibration
  *          - ROUTE_FACTORY_RESET: Factory reset confirmation
+ *          - ROUTE_HISTORY: Temperature history graph
  */
 typedef enum {
   ROUTE_INIT = 0,           /**< Startup initialization screen */
@@ -59,6 +60,7 @@ typedef enum {
   ROUTE_MENU,               /**< Settings menu */
   ROUTE_EDIT_TEMP_OFFSET,   /**< Temperature offset calibration */
   ROUTE_FACTORY_RESET,      /**< Factory reset confirmation */
+  ROUTE_HISTORY,            /**< Temperature history graph */
 } RouteTypeDef;
 
 /**
@@ -69,6 +71,7 @@ typedef enum {
  * @param system_model Shared system state context (for reading state)
  * @param config_model Shared configuration data access
  * @param sensor_model Shared sensor measurement values
+ * @param history_model Temperature history recorded by the system task
  * @return void; calls Error_Handler() if queues or contexts are invalid
  * @note Must be called once during VP task startup
  * @see ViewPresenterTaskArgsTypeDef, RouteTypeDef
@@ -76,7 +79,8 @@ typedef enum {
 void Router_Init(osMessageQueueId_t vp2system_queue,
                  SystemModel_t *system_model,
                  ConfigModel_t *config_model,
-                 SensorModel_t *sensor_model);
+                 SensorModel_t *sensor_model,
+                 HistoryModel_t *history_model);
 
 /**
  * @brief Deinitialize the router
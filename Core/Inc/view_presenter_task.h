@@ -35,6 +35,14 @@ extern "C" {
  */
 #define VP_TASK_STACK_SIZE (1024U * 4U)
 
+/**
+ * @def VP_TASK_FLAG_SENSOR_CHANGED
+ * @brief Thread flag the sensor task sets on the view presenter task when
+ *        values shown by the active presenter changed
+ * @see SensorTask_Subscribe
+ */
+#define VP_TASK_FLAG_SENSOR_CHANGED 0x0001U
+
 #include "sensor_task.h"
 #include "storage_task.h"
 #include "system_task.h"
@@ -55,6 +63,8 @@ typedef struct {
   ConfigModel_t *config_model;         /**< Pointer to configuration data access */
   SensorModel_t
       *sensor_model;                  /**< Pointer to sensor values for display */
+  HistoryModel_t
+      *history_model;                 /**< Temperature history for the graph */
 } ViewPresenterTaskArgsTypeDef;
 
 /**
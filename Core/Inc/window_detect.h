@@ -0,0 +1,188 @@
+/**
+ ******************************************************************************
+ * @file           :  window_detect.h
+ * @brief          :  Open-window detection from the temperature slope
+ *
+ * @details        :  An open window makes the room, and first the air at
+ *                    the radiator, cool several times faster than anything
+ *                    else in a heated room does. The sensor task keeps the
+ *                    last WINDOW_DETECT_SAMPLES filtered temperatures in a
+ *                    ring (WindowSlope_t) and publishes their least-squares
+ *                    slope over the last WINDOW_DETECT_SPAN_MS, in 0.01 °C
+ *                    per minute. The system state machine feeds it to
+ *                    WindowDetect_Update(), which reports the window open
+ *                    when the slope falls to -WINDOW_DETECT_DROP_CDEG_PER_MIN
+ *                    and closed again once the room has warmed by
+ *                    WINDOW_DETECT_RECOVER_CDEG from its lowest point, or
+ *                    after WINDOW_DETECT_TIMEOUT_MS. It is armed again only
+ *                    after the slope has come back above half the
+ *                    threshold, so a window left open after the timeout
+ *                    does not keep the valve shut. Integer arithmetic and
+ *                    no RTOS calls, like sensor_sampling.h.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CORE_INC_WINDOW_DETECT_H
+#define CORE_INC_WINDOW_DETECT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def WINDOW_DETECT_SAMPLES
+ * @brief Temperatures kept for the slope
+ */
+#ifndef WINDOW_DETECT_SAMPLES
+#define WINDOW_DETECT_SAMPLES 16U
+#endif
+
+/**
+ * @def WINDOW_DETECT_SPAN_MS
+ * @brief Time the slope is fitted over, back from the newest sample
+ */
+#ifndef WINDOW_DETECT_SPAN_MS
+#define WINDOW_DETECT_SPAN_MS 600000U
+#endif
+
+/**
+ * @def WINDOW_DETECT_GAP_MS
+ * @brief Shortest time between kept samples, so that the ring covers the
+ *        span at any sampling period
+ */
+#ifndef WINDOW_DETECT_GAP_MS
+#define WINDOW_DETECT_GAP_MS (WINDOW_DETECT_SPAN_MS / WINDOW_DETECT_SAMPLES)
+#endif
+
+/**
+ * @def WINDOW_DETECT_MIN_SPAN_MS
+ * @brief Shortest time between the oldest and newest sample of a fit;
+ *        shorter fits are dominated by the sensor's quantisation
+ */
+#ifndef WINDOW_DETECT_MIN_SPAN_MS
+#define WINDOW_DETECT_MIN_SPAN_MS 180000U
+#endif
+
+/**
+ * @def WINDOW_DETECT_MIN_SAMPLES
+ * @brief Fewest samples of a fit
+ */
+#ifndef WINDOW_DETECT_MIN_SAMPLES
+#define WINDOW_DETECT_MIN_SAMPLES 4U
+#endif
+
+/**
+ * @def WINDOW_DETECT_DROP_CDEG_PER_MIN
+ * @brief Cooling rate that means an open window
+ */
+#ifndef WINDOW_DETECT_DROP_CDEG_PER_MIN
+#define WINDOW_DETECT_DROP_CDEG_PER_MIN 15
+#endif
+
+/**
+ * @def WINDOW_DETECT_RECOVER_CDEG
+ * @brief Rise above the lowest temperature while open that means the
+ *        window was closed
+ */
+#ifndef WINDOW_DETECT_RECOVER_CDEG
+#define WINDOW_DETECT_RECOVER_CDEG 30
+#endif
+
+/**
+ * @def WINDOW_DETECT_TIMEOUT_MS
+ * @brief Longest time the valve is kept shut
+ */
+#ifndef WINDOW_DETECT_TIMEOUT_MS
+#define WINDOW_DETECT_TIMEOUT_MS (20U * 60U * 1000U)
+#endif
+
+/** Published slope when too few samples are in the span */
+#define WINDOW_DETECT_NO_SLOPE INT16_MIN
+
+/**
+ * @brief  Ring of the last temperatures and their times
+ */
+typedef struct {
+  uint32_t ms[WINDOW_DETECT_SAMPLES];  /**< Sample times */
+  int16_t cdeg[WINDOW_DETECT_SAMPLES]; /**< Temperatures */
+  uint8_t head;                        /**< Next slot to write */
+  uint8_t count;                       /**< Valid samples */
+} WindowSlope_t;
+
+/**
+ * @brief  What WindowDetect_Update() saw
+ */
+typedef enum {
+  WINDOW_DETECT_NONE = 0, /**< No change */
+  WINDOW_DETECT_OPENED,   /**< Sharp drop: shut the valve */
+  WINDOW_DETECT_CLOSED,   /**< Room warming again: resume */
+  WINDOW_DETECT_TIMEOUT,  /**< Open for WINDOW_DETECT_TIMEOUT_MS: resume */
+} WindowDetectEvent_t;
+
+/**
+ * @brief  Detector state
+ */
+typedef struct {
+  bool open;           /**< Window reported open */
+  bool armed;          /**< A drop may be reported */
+  uint32_t open_ms;    /**< Time it was reported open */
+  int32_t lowest_cdeg; /**< Lowest temperature while open */
+} WindowDetect_t;
+
+/**
+ * @brief  Empty the ring
+ */
+void WindowSlope_Init(WindowSlope_t *slope);
+
+/**
+ * @brief  Add a temperature, overwriting the oldest once full
+ * @param  now_ms  Free-running millisecond time, may wrap
+ */
+void WindowSlope_Add(WindowSlope_t *slope, uint32_t now_ms, int32_t cdeg);
+
+/**
+ * @brief  Least-squares slope of the samples within WINDOW_DETECT_SPAN_MS
+ *         of the newest
+ * @return Slope in 0.01 °C per minute, clamped to int16_t, or
+ *         WINDOW_DETECT_NO_SLOPE if the fit has fewer than
+ *         WINDOW_DETECT_MIN_SAMPLES samples or spans less than
+ *         WINDOW_DETECT_MIN_SPAN_MS
+ */
+int16_t WindowSlope_Get(const WindowSlope_t *slope);
+
+/**
+ * @brief  Start closed and armed
+ */
+void WindowDetect_Init(WindowDetect_t *detect);
+
+/**
+ * @brief  Feed the room temperature and its slope
+ * @param  now_ms        Free-running millisecond time, may wrap
+ * @param  slope_cdeg_min  WindowSlope_Get(), may be WINDOW_DETECT_NO_SLOPE
+ * @return Change of the window state
+ */
+WindowDetectEvent_t WindowDetect_Update(WindowDetect_t *detect,
+                                        uint32_t now_ms, int32_t cdeg,
+                                        int16_t slope_cdeg_min);
+
+/**
+ * @brief  The user ended the window mode: report closed and wait for the
+ *         drop to end before arming again
+ */
+void WindowDetect_Cancel(WindowDetect_t *detect);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_INC_WINDOW_DETECT_H */
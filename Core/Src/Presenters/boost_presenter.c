@@ -1,5 +1,6 @@
 #include "boost_presenter.h"
 #include "cmsis_os2.h"
+#include "ipc_profile.h"
 #include "view_presenter_router.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -46,12 +47,12 @@ void BoostPresenter_HandleEvent(BoostPresenter_t *presenter,
 
       /* Restore previous mode before boost */
       if (presenter->system_context) {
-        if (osMutexAcquire(presenter->system_context->mutex, 10) == osOK) {
+        if (IPC_MUTEX_ACQUIRE(presenter->system_context->mutex, 10) == osOK) {
           SystemMode_t previous_mode =
               presenter->system_context->data.mode_before_boost;
           presenter->system_context->data.mode = previous_mode;
           printf("Boost: Restored previous mode (%d)\n", previous_mode);
-          osMutexRelease(presenter->system_context->mutex);
+          IPC_MUTEX_RELEASE(presenter->system_context->mutex);
         }
       }
 
@@ -70,7 +71,7 @@ void BoostPresenter_Run(BoostPresenter_t *presenter, uint32_t current_tick) {
   BoostViewData_t model = {0};
 
   /* Calculate remaining time */
-  if (osMutexAcquire(presenter->system_context->mutex, 10) == osOK) {
+  if (IPC_MUTEX_ACQUIRE(presenter->system_context->mutex, 10) == osOK) {
     uint32_t elapsed_ticks = osKernelGetTickCount() -
                              presenter->system_context->data.boost_begin_time;
     uint32_t elapsed_seconds = elapsed_ticks / 1000; /* Convert ms to seconds */
@@ -84,7 +85,7 @@ void BoostPresenter_Run(BoostPresenter_t *presenter, uint32_t current_tick) {
           presenter->system_context->data.mode_before_boost;
       presenter->system_context->data.mode = previous_mode;
       printf("Boost: Restored previous mode (%d)\n", previous_mode);
-      osMutexRelease(presenter->system_context->mutex);
+      IPC_MUTEX_RELEASE(presenter->system_context->mutex);
 
       Router_GoToRoute(ROUTE_HOME);
       return;
@@ -92,7 +93,7 @@ void BoostPresenter_Run(BoostPresenter_t *presenter, uint32_t current_tick) {
       model.remaining_seconds = 300 - elapsed_seconds;
     }
 
-    osMutexRelease(presenter->system_context->mutex);
+    IPC_MUTEX_RELEASE(presenter->system_context->mutex);
   }
 
   BoostView_Render(presenter->view, &model);
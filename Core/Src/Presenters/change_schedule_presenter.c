@@ -1,5 +1,7 @@
 #include "change_schedule_presenter.h"
 #include "change_schedule_view.h"
+#include "ipc_profile.h"
+#include "schedule.h"
 #include "set_bool_presenter.h"
 #include "set_time_slot_presenter.h"
 #include "set_value_presenter.h"
@@ -10,12 +12,25 @@
 
 typedef enum {
   STEP_ASK_CHANGE = 0,
+  STEP_DAY,
   STEP_NUM_SLOTS,
   STEP_SLOT_TIME,
   STEP_SLOT_TEMP,
+  STEP_COPY,
   STEP_FINISH
 } ScheduleStep_t;
 
+/* Day roller: the seven days, then "Save" */
+#define DAY_OPTIONS "Mon\nTue\nWed\nThu\nFri\nSat\nSun\nSave"
+#define DAY_INDEX_SAVE SCHEDULE_DAYS
+
+/* Copy roller, in the order of copy_mask() */
+#define COPY_OPTIONS "None\nNext day\nMon-Fri\nSat-Sun\nAll days"
+#define COPY_INDEX_MAX 4U
+
+static const char *const day_names[SCHEDULE_DAYS] = {
+    "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+
 typedef struct ChangeSchedulePresenter {
   ChangeScheduleView_t *view;
   ConfigModel_t *config_model;
@@ -28,8 +43,10 @@ typedef struct ChangeSchedulePresenter {
   bool is_complete;
   bool is_cancelled;
 
-  /* Temporary schedule data */
+  /* Temporary schedule data: the week, and the day being edited */
+  WeeklyScheduleTypeDef weekly;
   DailyScheduleTypeDef schedule;
+  uint8_t current_day;
   uint8_t current_slot_index;
 
   /* For temperature roller options */
@@ -38,6 +55,8 @@ typedef struct ChangeSchedulePresenter {
 } ChangeSchedulePresenter_t;
 
 static void load_schedule(ChangeSchedulePresenter_t *presenter);
+static void setup_day_view(ChangeSchedulePresenter_t *presenter,
+                           uint16_t selected);
 
 ChangeSchedulePresenter_t *
 ChangeSchedulePresenter_Init(ChangeScheduleView_t *view,
@@ -50,10 +69,10 @@ ChangeSchedulePresenter_Init(ChangeScheduleView_t *view,
 
   presenter->view = view;
   presenter->config_model = config_model;
-  presenter->current_step =
-      skip_confirmation ? STEP_NUM_SLOTS : STEP_ASK_CHANGE;
+  presenter->current_step = skip_confirmation ? STEP_DAY : STEP_ASK_CHANGE;
   presenter->is_complete = false;
   presenter->is_cancelled = false;
+  presenter->current_day = 0;
   presenter->current_slot_index = 0;
 
   /* Initialize sub-presenters */
@@ -79,15 +98,8 @@ ChangeSchedulePresenter_Init(ChangeScheduleView_t *view,
   load_schedule(presenter);
 
   if (skip_confirmation) {
-    /* Skip directly to asking number of slots */
-    SetValueView_SetTitle(ChangeScheduleView_GetValueView(view),
-                          "Num time slots");
-    SetValueView_SetUnit(ChangeScheduleView_GetValueView(view), NULL);
-    SetValueView_SetOptions(ChangeScheduleView_GetValueView(view), "3\n4\n5");
-    SetValuePresenter_SetMaxIndex(presenter->value_presenter, 2);
-    SetValuePresenter_SetSelectedIndex(presenter->value_presenter,
-                                       presenter->schedule.num_time_slots - 3);
-    SetValueView_Show(ChangeScheduleView_GetValueView(view));
+    /* Skip directly to choosing the day */
+    setup_day_view(presenter, 0);
   } else {
     /* Start with "Change schedule?" */
     SetBoolView_Show(ChangeScheduleView_GetBoolView(view));
@@ -118,70 +130,100 @@ static void save_schedule(ChangeSchedulePresenter_t *presenter) {
   if (!presenter || !presenter->config_model)
     return;
 
-  if (osMutexAcquire(presenter->config_model->mutex, osWaitForever) == osOK) {
-    presenter->config_model->data.daily_schedule = presenter->schedule;
-    osMutexRelease(presenter->config_model->mutex);
+  if (IPC_MUTEX_ACQUIRE(presenter->config_model->mutex, osWaitForever) ==
+      osOK) {
+    presenter->config_model->data.schedule = presenter->weekly;
+    IPC_MUTEX_RELEASE(presenter->config_model->mutex);
   }
 }
 
-static bool is_time_less(uint8_t h1, uint8_t m1, uint8_t h2, uint8_t m2) {
-  if (h1 < h2)
-    return true;
-  if (h1 == h2 && m1 < m2)
-    return true;
-  return false;
-}
-
-static bool is_schedule_valid(const DailyScheduleTypeDef *schedule) {
-  if (schedule->num_time_slots < 3 || schedule->num_time_slots > 5)
-    return false;
-
-  /* First slot must start at 00:00 */
-  if (schedule->time_slots[0].start_hour != 0 ||
-      schedule->time_slots[0].start_minute != 0)
-    return false;
+static void load_schedule(ChangeSchedulePresenter_t *presenter) {
+  if (!presenter || !presenter->config_model)
+    return;
 
-  /* Last slot must end at 23:59 */
-  if (schedule->time_slots[schedule->num_time_slots - 1].end_hour != 23 ||
-      schedule->time_slots[schedule->num_time_slots - 1].end_minute != 59)
-    return false;
+  if (IPC_MUTEX_ACQUIRE(presenter->config_model->mutex, osWaitForever) ==
+      osOK) {
+    presenter->weekly = presenter->config_model->data.schedule;
+    IPC_MUTEX_RELEASE(presenter->config_model->mutex);
+  }
 
-  for (int i = 0; i < schedule->num_time_slots; i++) {
-    /* Start < End */
-    if (!is_time_less(schedule->time_slots[i].start_hour,
-                      schedule->time_slots[i].start_minute,
-                      schedule->time_slots[i].end_hour,
-                      schedule->time_slots[i].end_minute)) {
-      return false;
-    }
+  /* If invalid, load default */
+  if (!Schedule_IsValid(&presenter->weekly)) {
+    Schedule_LoadDefault(&presenter->weekly, 3);
+  }
+}
 
-    /* Contiguity */
-    if (i > 0) {
-      if (schedule->time_slots[i].start_hour !=
-              schedule->time_slots[i - 1].end_hour ||
-          schedule->time_slots[i].start_minute !=
-              schedule->time_slots[i - 1].end_minute) {
-        return false;
-      }
-    }
+/* Days a copy roller option copies the current day to */
+static uint8_t copy_mask(uint8_t day, uint16_t option) {
+  switch (option) {
+  case 1:
+    return (uint8_t)(1U << ((day + 1U) % SCHEDULE_DAYS));
+  case 2:
+    return SCHEDULE_MASK_WORKDAYS;
+  case 3:
+    return SCHEDULE_MASK_WEEKEND;
+  case 4:
+    return SCHEDULE_MASK_ALL;
+  default:
+    return 0;
   }
-  return true;
 }
 
+static void setup_day_view(ChangeSchedulePresenter_t *presenter,
+                           uint16_t selected) {
+  SetValueView_t *value_view =
+      ChangeScheduleView_GetValueView(presenter->view);
+
+  SetValueView_SetTitle(value_view, "Edit day:");
+  SetValueView_SetOptions(value_view, DAY_OPTIONS);
+  SetValueView_SetUnit(value_view, NULL);
+  SetValueView_SetLeftButtonHint(value_view, false);
+  SetValuePresenter_SetMaxIndex(presenter->value_presenter, DAY_INDEX_SAVE);
+  SetValuePresenter_SetSelectedIndex(presenter->value_presenter, selected);
+  SetValuePresenter_Reset(presenter->value_presenter);
+  SetValueView_Show(value_view);
+}
 
-static void load_schedule(ChangeSchedulePresenter_t *presenter) {
-  if (!presenter || !presenter->config_model)
-    return;
+static void setup_num_slots_view(ChangeSchedulePresenter_t *presenter) {
+  SetValueView_t *value_view =
+      ChangeScheduleView_GetValueView(presenter->view);
+  char title[32];
+  snprintf(title, sizeof(title), "%s time slots:",
+           day_names[presenter->current_day]);
+
+  SetValueView_SetTitle(value_view, title);
+  SetValueView_SetOptions(value_view, "3\n4\n5");
+  SetValueView_SetUnit(value_view, NULL);
+  SetValueView_SetLeftButtonHint(value_view, false);
+  SetValuePresenter_SetMaxIndex(presenter->value_presenter,
+                                2); /* 0=3, 1=4, 2=5 */
+
+  /* Map current num slots to index */
+  uint16_t idx = 0;
+  if (presenter->schedule.num_time_slots >= 3 &&
+      presenter->schedule.num_time_slots <= 5)
+    idx = presenter->schedule.num_time_slots - 3;
+  SetValuePresenter_SetSelectedIndex(presenter->value_presenter, idx);
 
-  if (osMutexAcquire(presenter->config_model->mutex, osWaitForever) == osOK) {
-    presenter->schedule = presenter->config_model->data.daily_schedule;
-    osMutexRelease(presenter->config_model->mutex);
-  }
+  SetValuePresenter_Reset(presenter->value_presenter);
+  SetValueView_Show(value_view);
+}
 
-  /* If invalid, load default */
-  if (!is_schedule_valid(&presenter->schedule)) {
-    Utils_LoadDefaultSchedule(&presenter->schedule, 3);
-  }
+static void setup_copy_view(ChangeSchedulePresenter_t *presenter) {
+  SetValueView_t *value_view =
+      ChangeScheduleView_GetValueView(presenter->view);
+  char title[32];
+  snprintf(title, sizeof(title), "Copy %s to:",
+           day_names[presenter->current_day]);
+
+  SetValueView_SetTitle(value_view, title);
+  SetValueView_SetOptions(value_view, COPY_OPTIONS);
+  SetValueView_SetUnit(value_view, NULL);
+  SetValueView_SetLeftButtonHint(value_view, true);
+  SetValuePresenter_SetMaxIndex(presenter->value_presenter, COPY_INDEX_MAX);
+  SetValuePresenter_SetSelectedIndex(presenter->value_presenter, 0);
+  SetValuePresenter_Reset(presenter->value_presenter);
+  SetValueView_Show(value_view);
 }
 
 static void setup_slot_time_view(ChangeSchedulePresenter_t *presenter) {
@@ -276,27 +318,9 @@ void ChangeSchedulePresenter_HandleEvent(ChangeSchedulePresenter_t *presenter,
         /* Load current schedule to edit */
         load_schedule(presenter);
 
-        /* Go to Num Slots selection */
-        presenter->current_step = STEP_NUM_SLOTS;
-
-        SetValueView_SetTitle(ChangeScheduleView_GetValueView(presenter->view),
-                              "Time slots / day:");
-        SetValueView_SetOptions(
-            ChangeScheduleView_GetValueView(presenter->view), "3\n4\n5");
-        SetValueView_SetLeftButtonHint(
-            ChangeScheduleView_GetValueView(presenter->view), false);
-        SetValuePresenter_SetMaxIndex(presenter->value_presenter,
-                                      2); /* 0=3, 1=4, 2=5 */
-
-        /* Map current num slots to index */
-        uint16_t idx = 0;
-        if (presenter->schedule.num_time_slots >= 3 &&
-            presenter->schedule.num_time_slots <= 5)
-          idx = presenter->schedule.num_time_slots - 3;
-        SetValuePresenter_SetSelectedIndex(presenter->value_presenter, idx);
-
-        SetValuePresenter_Reset(presenter->value_presenter);
-        SetValueView_Show(ChangeScheduleView_GetValueView(presenter->view));
+        /* Go to day selection */
+        presenter->current_step = STEP_DAY;
+        setup_day_view(presenter, 0);
       } else /* No */
       {
         /* Skip changing */
@@ -305,7 +329,7 @@ void ChangeSchedulePresenter_HandleEvent(ChangeSchedulePresenter_t *presenter,
     }
     break;
 
-  case STEP_NUM_SLOTS:
+  case STEP_DAY:
     /* Handle Back */
     if (event->type == EVT_LEFT_BTN &&
         event->button_action == BUTTON_ACTION_PRESSED) {
@@ -313,6 +337,35 @@ void ChangeSchedulePresenter_HandleEvent(ChangeSchedulePresenter_t *presenter,
       return;
     }
 
+    SetValuePresenter_HandleEvent(presenter->value_presenter, event);
+    if (SetValuePresenter_IsComplete(presenter->value_presenter)) {
+      uint16_t idx =
+          SetValuePresenter_GetSelectedIndex(presenter->value_presenter);
+      if (idx >= DAY_INDEX_SAVE) {
+        save_schedule(presenter);
+        presenter->is_complete = true;
+        return;
+      }
+
+      /* Edit the chosen day */
+      presenter->current_day = (uint8_t)idx;
+      Schedule_GetDay(&presenter->weekly, presenter->current_day,
+                      &presenter->schedule);
+      presenter->current_step = STEP_NUM_SLOTS;
+      setup_num_slots_view(presenter);
+    }
+    break;
+
+  case STEP_NUM_SLOTS:
+    /* Handle Back */
+    if (event->type == EVT_LEFT_BTN &&
+        event->button_action == BUTTON_ACTION_PRESSED) {
+      /* Back to day selection, dropping this day's edits */
+      presenter->current_step = STEP_DAY;
+      setup_day_view(presenter, presenter->current_day);
+      return;
+    }
+
     SetValuePresenter_HandleEvent(presenter->value_presenter, event);
     if (SetValuePresenter_IsComplete(presenter->value_presenter)) {
       uint16_t idx =
@@ -347,20 +400,7 @@ void ChangeSchedulePresenter_HandleEvent(ChangeSchedulePresenter_t *presenter,
         if (presenter->current_slot_index == 0) {
           /* Back to Num Slots */
           presenter->current_step = STEP_NUM_SLOTS;
-          SetValueView_SetTitle(
-              ChangeScheduleView_GetValueView(presenter->view),
-              "Time slots / day:");
-          SetValueView_SetOptions(
-              ChangeScheduleView_GetValueView(presenter->view), "3\n4\n5");
-          SetValueView_SetUnit(ChangeScheduleView_GetValueView(presenter->view),
-                               "");
-          SetValueView_SetLeftButtonHint(
-              ChangeScheduleView_GetValueView(presenter->view), false);
-          SetValuePresenter_SetMaxIndex(presenter->value_presenter, 2);
-          SetValuePresenter_SetSelectedIndex(presenter->value_presenter,
-                                            presenter->schedule.num_time_slots - 3);
-          SetValuePresenter_Reset(presenter->value_presenter);
-          SetValueView_Show(ChangeScheduleView_GetValueView(presenter->view));
+          setup_num_slots_view(presenter);
         } else {
           /* Back to previous slot Temp */
           presenter->current_slot_index--;
@@ -433,14 +473,43 @@ void ChangeSchedulePresenter_HandleEvent(ChangeSchedulePresenter_t *presenter,
         presenter->current_slot_index++;
         presenter->current_step = STEP_SLOT_TIME;
         setup_slot_time_view(presenter);
+      } else if (Schedule_SetDay(&presenter->weekly, presenter->current_day,
+                                 &presenter->schedule)) {
+        /* Finished all slots of the day */
+        presenter->current_step = STEP_COPY;
+        setup_copy_view(presenter);
       } else {
-        /* Finished all slots */
-        save_schedule(presenter);
-        presenter->is_complete = true;
+        /* Slots too short for the schedule resolution: edit again */
+        presenter->current_slot_index = 0;
+        presenter->current_step = STEP_SLOT_TIME;
+        setup_slot_time_view(presenter);
       }
     }
     break;
 
+  case STEP_COPY:
+    /* Handle Back */
+    if (event->type == EVT_LEFT_BTN &&
+        event->button_action == BUTTON_ACTION_PRESSED) {
+      /* Back to the last slot Temp */
+      presenter->current_step = STEP_SLOT_TEMP;
+      setup_slot_temp_view(presenter);
+      return;
+    }
+
+    SetValuePresenter_HandleEvent(presenter->value_presenter, event);
+    if (SetValuePresenter_IsComplete(presenter->value_presenter)) {
+      uint16_t idx =
+          SetValuePresenter_GetSelectedIndex(presenter->value_presenter);
+      Schedule_CopyDay(&presenter->weekly, presenter->current_day,
+                       copy_mask(presenter->current_day, idx));
+
+      /* Offer the following day next, "Save" after Sunday */
+      presenter->current_step = STEP_DAY;
+      setup_day_view(presenter, presenter->current_day + 1U);
+    }
+    break;
+
   default:
     break;
   }
@@ -1,4 +1,5 @@
 #include "factory_reset_presenter.h"
+#include "ipc_profile.h"
 #include "loading_presenter.h"
 #include "loading_view.h"
 #include "lvgl_port_display.h"
@@ -107,7 +108,7 @@ void FactoryResetPresenter_HandleEvent(FactoryResetPresenter_t *presenter,
           /* Send Event */
           if (presenter->vp2system_queue) {
             VP2SystemEventTypeDef evt = EVT_FACTORY_RST_REQ;
-            osMessageQueuePut(presenter->vp2system_queue, &evt, 0, 0);
+            IPC_QUEUE_PUT(presenter->vp2system_queue, &evt, 0, 0);
           }
         } else {
           /* No selected -> Cancel */
@@ -0,0 +1,183 @@
+#include "history_presenter.h"
+#include "cmsis_os2.h"
+#include "ipc_profile.h"
+#include "utils.h"
+#include "view_presenter_router.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Rebuild the plot this often while the screen is shown */
+#define HISTORY_PRESENTER_REFRESH_MS 60000U
+/* Narrowest temperature scale, so that sensor noise does not fill it */
+#define HISTORY_PRESENTER_MIN_SPAN_CDEG 200
+/* Scale limits are multiples of this */
+#define HISTORY_PRESENTER_STEP_CDEG 50
+
+static const char *const k_range_names[TEMP_HISTORY_TIER_COUNT] = {
+    "24h", "7d", "30d"};
+
+struct HistoryPresenter {
+  HistoryView_t *view;
+  HistoryModel_t *history_model;
+
+  TempHistoryTier_t tier;
+  bool dirty;
+  uint32_t last_build_tick;
+
+  HistoryViewData_t data;
+  TempHistoryPoint_t points[HISTORY_VIEW_COLUMNS];
+  HistoryViewColumn_t columns[HISTORY_VIEW_COLUMNS];
+};
+
+static int32_t floor_step(int32_t cdeg) {
+  const int32_t step = HISTORY_PRESENTER_STEP_CDEG;
+  return (cdeg >= 0) ? (cdeg / step) * step
+                     : -(((-cdeg) + step - 1) / step) * step;
+}
+
+static uint8_t to_row(int32_t cdeg, int32_t low, int32_t high) {
+  const int32_t rows = (int32_t)HISTORY_VIEW_PLOT_ROWS - 1;
+  return (uint8_t)(((high - cdeg) * rows + (high - low) / 2) / (high - low));
+}
+
+/* Scale the merged points to rows; the scale covers the temperatures only,
+   targets off the scale are not drawn */
+static void build_columns(HistoryPresenter_t *presenter) {
+  int32_t low = INT16_MAX;
+  int32_t high = INT16_MIN;
+  for (uint16_t i = 0; i < HISTORY_VIEW_COLUMNS; i++) {
+    const TempHistoryPoint_t *point = &presenter->points[i];
+    if (TempHistory_IsGap(point))
+      continue;
+    if (point->min_cdeg < low)
+      low = point->min_cdeg;
+    if (point->max_cdeg > high)
+      high = point->max_cdeg;
+  }
+
+  presenter->data.empty = (low > high);
+  if (presenter->data.empty) {
+    low = 1800;
+    high = 2200;
+  }
+  low = floor_step(low);
+  high = -floor_step(-high);
+  if (high - low < HISTORY_PRESENTER_MIN_SPAN_CDEG) {
+    const int32_t widen = HISTORY_PRESENTER_MIN_SPAN_CDEG - (high - low);
+    low = floor_step(low - widen / 2);
+    high = low + HISTORY_PRESENTER_MIN_SPAN_CDEG;
+  }
+  presenter->data.min_cdeg = (int16_t)low;
+  presenter->data.max_cdeg = (int16_t)high;
+
+  for (uint16_t i = 0; i < HISTORY_VIEW_COLUMNS; i++) {
+    const TempHistoryPoint_t *point = &presenter->points[i];
+    HistoryViewColumn_t *column = &presenter->columns[i];
+    column->valve = (point->valve != 0U);
+    if (TempHistory_IsGap(point)) {
+      column->top_row = HISTORY_VIEW_NO_ROW;
+      column->bottom_row = HISTORY_VIEW_NO_ROW;
+      column->target_row = HISTORY_VIEW_NO_ROW;
+      continue;
+    }
+    column->top_row = to_row(point->max_cdeg, low, high);
+    column->bottom_row = to_row(point->min_cdeg, low, high);
+    const int32_t target =
+        (int32_t)(Utils_IndexToTemp(point->target_index) * 100.0f);
+    column->target_row = (target >= low && target <= high)
+                             ? to_row(target, low, high)
+                             : HISTORY_VIEW_NO_ROW;
+  }
+  presenter->data.revision++;
+}
+
+HistoryPresenter_t *HistoryPresenter_Init(HistoryView_t *view,
+                                          HistoryModel_t *history_model) {
+  if (!view || !history_model)
+    return NULL;
+
+  HistoryPresenter_t *presenter =
+      (HistoryPresenter_t *)malloc(sizeof(HistoryPresenter_t));
+  if (!presenter)
+    return NULL;
+
+  presenter->view = view;
+  presenter->history_model = history_model;
+  presenter->tier = TEMP_HISTORY_TIER_MINUTE;
+  presenter->dirty = true;
+  presenter->last_build_tick = 0;
+
+  presenter->data.range = k_range_names[presenter->tier];
+  presenter->data.min_cdeg = 0;
+  presenter->data.max_cdeg = 0;
+  presenter->data.empty = true;
+  presenter->data.revision = 0;
+  presenter->data.columns = presenter->columns;
+
+  return presenter;
+}
+
+void HistoryPresenter_Deinit(HistoryPresenter_t *presenter) {
+  if (presenter) {
+    free(presenter);
+  }
+}
+
+void HistoryPresenter_HandleEvent(HistoryPresenter_t *presenter,
+                                  const Input2VPEvent_t *event) {
+  if (!presenter || !event)
+    return;
+
+  if (event->type == EVT_CTRL_WHEEL_DELTA) {
+    /* Wheel: step through 24 h, 7 days and 30 days */
+    if (event->delta > 0 && presenter->tier + 1 < TEMP_HISTORY_TIER_COUNT) {
+      presenter->tier = (TempHistoryTier_t)(presenter->tier + 1);
+      presenter->dirty = true;
+    } else if (event->delta < 0 && presenter->tier > 0) {
+      presenter->tier = (TempHistoryTier_t)(presenter->tier - 1);
+      presenter->dirty = true;
+    }
+  } else if (event->button_action == BUTTON_ACTION_PRESSED) {
+    switch (event->type) {
+    case EVT_LEFT_BTN:
+      /* Left button: Back to Menu */
+      Router_GoToRoute(ROUTE_MENU);
+      break;
+    case EVT_MIDDLE_BTN:
+      /* Middle button: next range, wrapping around */
+      presenter->tier =
+          (TempHistoryTier_t)((presenter->tier + 1) % TEMP_HISTORY_TIER_COUNT);
+      presenter->dirty = true;
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void HistoryPresenter_Run(HistoryPresenter_t *presenter,
+                          uint32_t current_tick) {
+  if (!presenter || !presenter->view)
+    return;
+
+  if (current_tick - presenter->last_build_tick >=
+      HISTORY_PRESENTER_REFRESH_MS) {
+    presenter->dirty = true;
+  }
+
+  /* Merge the range into one point per column; retried on the next run if
+     the system task holds the history */
+  if (presenter->dirty &&
+      IPC_MUTEX_ACQUIRE(presenter->history_model->mutex, 10) == osOK) {
+    TempHistory_Columns(&presenter->history_model->data, presenter->tier,
+                        presenter->points, HISTORY_VIEW_COLUMNS);
+    IPC_MUTEX_RELEASE(presenter->history_model->mutex);
+
+    presenter->data.range = k_range_names[presenter->tier];
+    build_columns(presenter);
+    presenter->dirty = false;
+    presenter->last_build_tick = current_tick;
+  }
+
+  HistoryView_Render(presenter->view, &presenter->data);
+}
@@ -1,8 +1,12 @@
 #include "home_presenter.h"
 #include "cmsis_os2.h"
+#include "ipc_profile.h"
+#include "log_task.h"
 #include "main.h"
+#include "replay.h"
 #include "utils.h"
 #include "view_presenter_router.h"
+#include "view_presenter_task.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -13,6 +17,13 @@ struct HomePresenter {
   SystemModel_t *system_model;
   ConfigModel_t *config_model;
   SensorModel_t *sensor_model;
+  int32_t sensor_subscription;
+  bool sensor_stale;          /* Sensor values below need reading */
+  float ambient_temperature;  /* Sensor values last read */
+  uint8_t battery_percentage;
+  uint16_t battery_days;
+  bool rendered;
+  HomeViewData_t last_data;   /* Data of the last render */
 };
 
 HomePresenter_t *
@@ -31,16 +42,71 @@ HomePresenter_Init(HomeView_t *view, SystemModel_t *system_model,
   presenter->system_model = system_model;
   presenter->config_model = config_model;
   presenter->sensor_model = sensor_model;
+  presenter->ambient_temperature = 0.0f;
+  presenter->battery_percentage = 0U;
+  presenter->battery_days = 0U;
+  presenter->rendered = false;
+
+  /* Read the sensor model once now, then only when the sensor task reports
+     a change the screen shows */
+  const SensorThresholds_t thresholds = {
+      .temperature_cdeg = HOME_PRESENTER_TEMPERATURE_STEP_CDEG,
+      .soc = HOME_PRESENTER_SOC_STEP,
+      .battery_days = HOME_PRESENTER_BATTERY_DAYS_STEP,
+  };
+  (void)osThreadFlagsClear(VP_TASK_FLAG_SENSOR_CHANGED);
+  presenter->sensor_subscription =
+      SensorTask_Subscribe(VP_TASK_FLAG_SENSOR_CHANGED, &thresholds);
+  presenter->sensor_stale = true;
 
   return presenter;
 }
 
 void HomePresenter_Deinit(HomePresenter_t *presenter) {
   if (presenter) {
+    SensorTask_Unsubscribe(presenter->sensor_subscription);
     free(presenter);
   }
 }
 
+/* Read the sensor values if the sensor task reported a change. Without a
+   subscription (table full) the model is read on every run as before. */
+static void update_sensor_values(HomePresenter_t *presenter) {
+  const uint32_t flags = osThreadFlagsClear(VP_TASK_FLAG_SENSOR_CHANGED);
+  if ((flags & osFlagsError) == 0U &&
+      (flags & VP_TASK_FLAG_SENSOR_CHANGED) != 0U) {
+    presenter->sensor_stale = true;
+  }
+  if (!presenter->sensor_stale && presenter->sensor_subscription >= 0)
+    return;
+
+  if (IPC_MUTEX_ACQUIRE(presenter->sensor_model->mutex, 10) == osOK) {
+    /* Truncated to the 0.1 degree the view shows, so the view re-renders
+       only when the shown value changes */
+    presenter->ambient_temperature =
+        (float)((presenter->sensor_model->data.ambient_temperature_cdeg / 10) *
+                10) *
+        0.01f;
+    presenter->battery_percentage = presenter->sensor_model->data.soc;
+    presenter->battery_days = presenter->sensor_model->data.battery_days;
+    IPC_MUTEX_RELEASE(presenter->sensor_model->mutex);
+    presenter->sensor_stale = false;
+  }
+  /* else: retried on the next run */
+}
+
+static bool view_data_equal(const HomeViewData_t *a, const HomeViewData_t *b) {
+  return a->hour == b->hour && a->minute == b->minute &&
+         a->ambient_temperature == b->ambient_temperature &&
+         a->target_temp == b->target_temp &&
+         a->slot_end_hour == b->slot_end_hour &&
+         a->slot_end_minute == b->slot_end_minute &&
+         a->battery_percentage == b->battery_percentage &&
+         a->battery_days == b->battery_days &&
+         a->is_off_mode == b->is_off_mode && a->is_on_mode == b->is_on_mode &&
+         a->mode == b->mode;
+}
+
 void HomePresenter_HandleEvent(HomePresenter_t *presenter,
                                const Input2VPEvent_t *event) {
   if (!presenter || !event)
@@ -53,14 +119,22 @@ void HomePresenter_HandleEvent(HomePresenter_t *presenter,
 
     /* Check current mode */
     SystemMode_t current_mode = MODE_AUTO;
-    if (osMutexAcquire(presenter->system_model->mutex, 10) == osOK) {
+    if (IPC_MUTEX_ACQUIRE(presenter->system_model->mutex, 10) == osOK) {
       current_mode = presenter->system_model->data.mode;
-      osMutexRelease(presenter->system_model->mutex);
+      /* The first turn only ends the window mode */
+      if (current_mode == MODE_WINDOW_OPEN) {
+        presenter->system_model->data.mode =
+            presenter->system_model->data.mode_before_window;
+        DLOG("Home: Wheel turned, leaving window mode\n");
+      }
+      IPC_MUTEX_RELEASE(presenter->system_model->mutex);
     }
 
-    if (current_mode == MODE_AUTO) {
+    if (current_mode == MODE_WINDOW_OPEN) {
+      return;
+    } else if (current_mode == MODE_AUTO) {
       /* AUTO mode: use temporary override */
-      if (osMutexAcquire(presenter->system_model->mutex, 10) == osOK) {
+      if (IPC_MUTEX_ACQUIRE(presenter->system_model->mutex, 10) == osOK) {
         /* Use current temporary override if set, otherwise start from scheduled
          * target */
         float current_temp;
@@ -82,15 +156,15 @@ void HomePresenter_HandleEvent(HomePresenter_t *presenter,
         float new_temp = Utils_IndexToTemp((uint16_t)new_index);
         presenter->system_model->data.temporary_target_temp = new_temp;
 
-        printf("Home: AUTO mode - Rotary encoder delta=%d, new temp "
-               "override=%.1f°C\n",
-               event->delta, new_temp);
+        DLOG("Home: AUTO mode - Rotary encoder delta=%d, new temp "
+             "override=%.1f°C\n",
+             event->delta, new_temp);
 
-        osMutexRelease(presenter->system_model->mutex);
+        IPC_MUTEX_RELEASE(presenter->system_model->mutex);
       }
     } else {
       /* MANUAL mode: adjust manual temperature directly */
-      if (osMutexAcquire(presenter->config_model->mutex, 10) == osOK) {
+      if (IPC_MUTEX_ACQUIRE(presenter->config_model->mutex, 10) == osOK) {
         float current_temp = presenter->config_model->data.manual_target_temp;
         uint16_t current_index = Utils_TempToIndex(current_temp);
 
@@ -104,11 +178,11 @@ void HomePresenter_HandleEvent(HomePresenter_t *presenter,
         float new_temp = Utils_IndexToTemp((uint16_t)new_index);
         presenter->config_model->data.manual_target_temp = new_temp;
 
-        printf("Home: MANUAL mode - Rotary encoder delta=%d, new manual "
-               "temp=%.1f°C\n",
-               event->delta, new_temp);
+        DLOG("Home: MANUAL mode - Rotary encoder delta=%d, new manual "
+             "temp=%.1f°C\n",
+             event->delta, new_temp);
 
-        osMutexRelease(presenter->config_model->mutex);
+        IPC_MUTEX_RELEASE(presenter->config_model->mutex);
       }
     }
 
@@ -119,13 +193,17 @@ void HomePresenter_HandleEvent(HomePresenter_t *presenter,
   if (event->button_action == BUTTON_ACTION_PRESSED) {
     switch (event->type) {
     case EVT_LEFT_BTN:
-      /* Toggle mode between AUTO and MANUAL */
+      /* Toggle mode between AUTO and MANUAL, or resume from the window
+         mode */
       if (presenter->system_model) {
-        if (osMutexAcquire(presenter->system_model->mutex, 10) == osOK) {
+        if (IPC_MUTEX_ACQUIRE(presenter->system_model->mutex, 10) == osOK) {
           /* Toggle mode */
+          const SystemMode_t mode = presenter->system_model->data.mode;
           SystemMode_t new_mode =
-              (presenter->system_model->data.mode == MODE_AUTO) ? MODE_MANUAL
-                                                                  : MODE_AUTO;
+              (mode == MODE_WINDOW_OPEN)
+                  ? presenter->system_model->data.mode_before_window
+              : (mode == MODE_AUTO) ? MODE_MANUAL
+                                    : MODE_AUTO;
           presenter->system_model->data.mode = new_mode;
 
           /* Clear temporary override when switching modes */
@@ -134,17 +212,20 @@ void HomePresenter_HandleEvent(HomePresenter_t *presenter,
           printf("Home: Mode button pressed, switching to %s mode\n",
                  (new_mode == MODE_AUTO) ? "AUTO" : "MANUAL");
 
-          osMutexRelease(presenter->system_model->mutex);
+          IPC_MUTEX_RELEASE(presenter->system_model->mutex);
         }
       }
       break;
     case EVT_MIDDLE_BTN:
       /* Activate Boost mode */
       if (presenter->system_model) {
-        if (osMutexAcquire(presenter->system_model->mutex, 10) == osOK) {
-          /* Save current mode before boost */
+        if (IPC_MUTEX_ACQUIRE(presenter->system_model->mutex, 10) == osOK) {
+          /* Save current mode before boost; boost ends the window mode */
+          const SystemMode_t mode = presenter->system_model->data.mode;
           presenter->system_model->data.mode_before_boost =
-              presenter->system_model->data.mode;
+              (mode == MODE_WINDOW_OPEN)
+                  ? presenter->system_model->data.mode_before_window
+                  : mode;
           /* Set boost mode and record start time */
           presenter->system_model->data.mode = MODE_BOOST;
           presenter->system_model->data.boost_begin_time =
@@ -152,7 +233,7 @@ void HomePresenter_HandleEvent(HomePresenter_t *presenter,
 
           printf("Home: Boost button pressed, entering boost mode\n");
 
-          osMutexRelease(presenter->system_model->mutex);
+          IPC_MUTEX_RELEASE(presenter->system_model->mutex);
         }
         /* Switch to boost view */
         Router_GoToRoute(ROUTE_BOOST);
@@ -180,24 +261,26 @@ void HomePresenter_Run(HomePresenter_t *presenter, uint32_t current_tick) {
   RTC_DateTypeDef sDate = {0};
   HAL_RTC_GetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
   HAL_RTC_GetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
+  REPLAY_RTC(&sTime, &sDate);
 
   data.hour = sTime.Hours;
   data.minute = sTime.Minutes;
 
   /* Get Sensor Values */
-  if (osMutexAcquire(presenter->sensor_model->mutex, 10) == osOK) {
-    data.ambient_temperature = presenter->sensor_model->data.ambient_temperature;
-    data.battery_percentage = presenter->sensor_model->data.soc;
-    osMutexRelease(presenter->sensor_model->mutex);
-  }
+  update_sensor_values(presenter);
+  data.ambient_temperature = presenter->ambient_temperature;
+  data.battery_percentage = presenter->battery_percentage;
+  data.battery_days = presenter->battery_days;
 
   /* Get Target Temperature and Mode from System State */
-  if (osMutexAcquire(presenter->system_model->mutex, 10) == osOK) {
+  if (IPC_MUTEX_ACQUIRE(presenter->system_model->mutex, 10) == osOK) {
     data.target_temp = presenter->system_model->data.target_temp;
     data.mode = presenter->system_model->data.mode;
 
-    /* Use temporary override if set, otherwise use scheduled target */
-    if (presenter->system_model->data.temporary_target_temp != 0) {
+    /* Use temporary override if set, otherwise use scheduled target; an
+       open window overrides both */
+    if (presenter->system_model->data.temporary_target_temp != 0 &&
+        data.mode != MODE_WINDOW_OPEN) {
       data.target_temp = presenter->system_model->data.temporary_target_temp;
     }
 
@@ -208,8 +291,13 @@ void HomePresenter_Run(HomePresenter_t *presenter, uint32_t current_tick) {
     data.is_off_mode = (data.target_temp <= 4.5f);
     data.is_on_mode = (data.target_temp >= 30.0f);
 
-    osMutexRelease(presenter->system_model->mutex);
+    IPC_MUTEX_RELEASE(presenter->system_model->mutex);
   }
 
+  /* Take the display lock only for a changed screen */
+  if (presenter->rendered && view_data_equal(&data, &presenter->last_data))
+    return;
   HomeView_Render(presenter->view, &data);
+  presenter->last_data = data;
+  presenter->rendered = true;
 }
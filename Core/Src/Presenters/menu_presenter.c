@@ -16,7 +16,8 @@ struct MenuPresenter {
 
 #define MENU_OPTION_SCHEDULE 0
 #define MENU_OPTION_OFFSET 1
-#define MENU_OPTION_FACTORY_RST 2
+#define MENU_OPTION_HISTORY 2
+#define MENU_OPTION_FACTORY_RST 3
 
 MenuPresenter_t *
 MenuPresenter_Init(MenuView_t *view, SystemModel_t *system_model,
@@ -37,7 +38,7 @@ MenuPresenter_Init(MenuView_t *view, SystemModel_t *system_model,
 
   presenter->selected_index = 0;
   presenter->options = "\n"; // Empty to save flash, we hardcode buttons in view
-  presenter->num_options = 3;
+  presenter->num_options = 4;
 
   return presenter;
 }
@@ -78,6 +79,8 @@ void MenuPresenter_HandleEvent(MenuPresenter_t *presenter,
       } else if (presenter->selected_index == MENU_OPTION_SCHEDULE) {
         /* TODO: Go to Change Schedule */
         Router_GoToRoute(ROUTE_CHANGE_SCHEDULE);
+      } else if (presenter->selected_index == MENU_OPTION_HISTORY) {
+        Router_GoToRoute(ROUTE_HISTORY);
       } else if (presenter->selected_index == MENU_OPTION_FACTORY_RST) {
         Router_GoToRoute(ROUTE_FACTORY_RESET);
       }
@@ -3,6 +3,7 @@
 #include "set_date_presenter.h"
 #include "set_time_presenter.h"
 #include "stm32wbxx_hal.h"
+#include "utils.h"
 #include <stdlib.h>
 
 extern RTC_HandleTypeDef hrtc;
@@ -40,7 +41,8 @@ static void set_rtc(SetDateTimePresenter_t *presenter) {
   sDate.Year = (uint8_t)(date_data->year - 2000);
   sDate.Month = date_data->month;
   sDate.Date = date_data->day;
-  sDate.WeekDay = RTC_WEEKDAY_MONDAY;
+  sDate.WeekDay =
+      Utils_DayOfWeek(date_data->year, date_data->month, date_data->day);
 
   sTime.Hours = time_data->hour;
   sTime.Minutes = time_data->minute;
@@ -1,4 +1,5 @@
 #include "set_temp_offset_presenter.h"
+#include "ipc_profile.h"
 #include "set_value_presenter.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -69,7 +70,7 @@ SetTempOffsetPresenter_Init(SetValueView_t *view,
 
   /* Calculate initial index */
   uint16_t initial_index = 30; /* Default 0.0 */
-  if (osMutexAcquire(config_model->mutex, 10) == osOK) {
+  if (IPC_MUTEX_ACQUIRE(config_model->mutex, 10) == osOK) {
     float current_offset = config_model->data.temperature_offset;
     /* Calculate index: (offset + 15.0) / 0.5 */
     int idx = (int)((current_offset + 15.0f) * 2.0f);
@@ -78,7 +79,7 @@ SetTempOffsetPresenter_Init(SetValueView_t *view,
     if (idx > 60)
       idx = 60;
     initial_index = (uint16_t)idx;
-    osMutexRelease(config_model->mutex);
+    IPC_MUTEX_RELEASE(config_model->mutex);
   }
 
   /* Initialize Generic Presenter */
@@ -130,9 +131,9 @@ void SetTempOffsetPresenter_HandleEvent(SetTempOffsetPresenter_t *presenter,
     /* Map index to offset. Range -15.0 to +15.0 with 0.5 step. */
     float new_offset = (float)index * 0.5f - 15.0f;
 
-    if (osMutexAcquire(presenter->config_model->mutex, 10) == osOK) {
+    if (IPC_MUTEX_ACQUIRE(presenter->config_model->mutex, 10) == osOK) {
       presenter->config_model->data.temperature_offset = new_offset;
-      osMutexRelease(presenter->config_model->mutex);
+      IPC_MUTEX_RELEASE(presenter->config_model->mutex);
     }
 
     presenter->is_complete = true;
@@ -0,0 +1,194 @@
+#include "history_view.h"
+#include "lvgl_port_display.h"
+#include <src/misc/lv_area.h>
+#include <src/misc/lv_txt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct HistoryView {
+  lv_obj_t *screen;
+
+  lv_obj_t *label_range;
+  lv_obj_t *label_empty;
+  lv_obj_t *canvas;
+  lv_obj_t *label_hint_left;
+  lv_obj_t *label_hint_center;
+
+  /* 1 bit per pixel with a two-entry palette: 0 black, 1 white */
+  uint8_t canvas_buf[LV_CANVAS_BUF_SIZE_INDEXED_1BIT(HISTORY_VIEW_COLUMNS,
+                                                     HISTORY_VIEW_ROWS)];
+
+  /* Cache to avoid redrawing if not changed */
+  HistoryViewData_t last_data;
+  bool first_render;
+} HistoryView_t;
+
+static lv_color_t palette_index(uint8_t index) {
+  lv_color_t color;
+  color.full = index;
+  return color;
+}
+
+/* Temperature with one decimal, e.g. "21.5" or "-0.5" */
+static int format_cdeg(char *buf, size_t size, int16_t cdeg) {
+  const int tenths = (cdeg >= 0) ? (cdeg + 5) / 10 : (cdeg - 5) / 10;
+  return snprintf(buf, size, "%s%d.%d", (tenths < 0) ? "-" : "",
+                  abs(tenths) / 10, abs(tenths) % 10);
+}
+
+/* Redraw the plot into the canvas buffer and invalidate it once */
+static void draw_columns(HistoryView_t *view,
+                         const HistoryViewColumn_t *columns) {
+  lv_img_dsc_t *img = lv_canvas_get_img(view->canvas);
+  const lv_color_t black = palette_index(0);
+  const lv_color_t white = palette_index(1);
+
+  lv_canvas_fill_bg(view->canvas, black, LV_OPA_COVER);
+  for (lv_coord_t x = 0; x < (lv_coord_t)HISTORY_VIEW_COLUMNS; x++) {
+    const HistoryViewColumn_t *column = &columns[x];
+
+    /* Temperature: vertical bar from the lowest to the highest value */
+    if (column->top_row != HISTORY_VIEW_NO_ROW) {
+      for (lv_coord_t y = column->top_row; y <= column->bottom_row; y++) {
+        lv_img_buf_set_px_color(img, x, y, white);
+      }
+    }
+
+    /* Target: dotted line, cut out where it crosses the bar */
+    if (column->target_row != HISTORY_VIEW_NO_ROW && (x % 2) == 0) {
+      const bool inside = column->top_row != HISTORY_VIEW_NO_ROW &&
+                          column->target_row >= column->top_row &&
+                          column->target_row <= column->bottom_row;
+      lv_img_buf_set_px_color(img, x, column->target_row,
+                              inside ? black : white);
+    }
+
+    /* Valve: tick on the bottom row */
+    if (column->valve) {
+      lv_img_buf_set_px_color(img, x, HISTORY_VIEW_ROWS - 1U, white);
+    }
+  }
+  lv_obj_invalidate(view->canvas);
+}
+
+HistoryView_t *HistoryView_Init(void) {
+  HistoryView_t *view = (HistoryView_t *)malloc(sizeof(HistoryView_t));
+  if (!view)
+    return NULL;
+
+  if (!lv_port_lock()) {
+    free(view);
+    return NULL;
+  }
+
+  view->screen = lv_obj_create(NULL);
+  if (!view->screen) {
+    lv_port_unlock();
+    free(view);
+    return NULL;
+  }
+
+  lv_obj_set_style_bg_color(view->screen, lv_color_black(), 0);
+  lv_obj_set_size(view->screen, LV_HOR_RES, LV_VER_RES);
+
+  /* Range and scale: Top */
+  view->label_range = lv_label_create(view->screen);
+  lv_obj_align(view->label_range, LV_ALIGN_TOP_MID, 0, 0);
+  lv_obj_set_style_text_color(view->label_range, lv_color_white(), 0);
+  lv_obj_set_style_text_font(view->label_range, &lv_font_montserrat_12, 0);
+  lv_label_set_text(view->label_range, "24h");
+
+  /* Plot: full width below the title */
+  view->canvas = lv_canvas_create(view->screen);
+  lv_canvas_set_buffer(view->canvas, view->canvas_buf, HISTORY_VIEW_COLUMNS,
+                       HISTORY_VIEW_ROWS, LV_IMG_CF_INDEXED_1BIT);
+  lv_canvas_set_palette(view->canvas, 0, lv_color_black());
+  lv_canvas_set_palette(view->canvas, 1, lv_color_white());
+  lv_canvas_fill_bg(view->canvas, palette_index(0), LV_OPA_COVER);
+  lv_obj_align(view->canvas, LV_ALIGN_TOP_LEFT, 0, 14);
+
+  /* Shown instead of an empty plot */
+  view->label_empty = lv_label_create(view->screen);
+  lv_obj_align(view->label_empty, LV_ALIGN_CENTER, 0, 0);
+  lv_obj_set_style_text_color(view->label_empty, lv_color_white(), 0);
+  lv_obj_set_style_text_font(view->label_empty, &lv_font_montserrat_12, 0);
+  lv_label_set_text(view->label_empty, "No data yet");
+  lv_obj_add_flag(view->label_empty, LV_OBJ_FLAG_HIDDEN);
+
+  /* Hints */
+  view->label_hint_left = lv_label_create(view->screen);
+  lv_label_set_text(view->label_hint_left, "<");
+  lv_obj_align(view->label_hint_left, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+  lv_obj_set_style_text_color(view->label_hint_left, lv_color_white(), 0);
+  lv_obj_set_style_text_font(view->label_hint_left, &lv_font_montserrat_12, 0);
+
+  view->label_hint_center = lv_label_create(view->screen);
+  lv_label_set_text(view->label_hint_center, "O");
+  lv_obj_align(view->label_hint_center, LV_ALIGN_BOTTOM_MID, 0, 0);
+  lv_obj_set_style_text_color(view->label_hint_center, lv_color_white(), 0);
+  lv_obj_set_style_text_font(view->label_hint_center, &lv_font_montserrat_12,
+                             0);
+
+  view->first_render = true;
+
+  lv_scr_load(view->screen);
+  lv_port_unlock();
+
+  return view;
+}
+
+void HistoryView_Deinit(HistoryView_t *view) {
+  if (view) {
+    if (lv_port_lock()) {
+      if (view->screen)
+        lv_obj_del(view->screen);
+      lv_port_unlock();
+    }
+    free(view);
+  }
+}
+
+void HistoryView_Render(HistoryView_t *view, const HistoryViewData_t *data) {
+  if (!view || !data || !data->columns || !data->range)
+    return;
+
+  if (!lv_port_lock())
+    return;
+
+  char buf[32];
+  char low[8];
+  char high[8];
+
+  /* Range and scale, e.g. "7d 18.5-22.0°" */
+  if (view->first_render || view->last_data.range != data->range ||
+      view->last_data.min_cdeg != data->min_cdeg ||
+      view->last_data.max_cdeg != data->max_cdeg ||
+      view->last_data.empty != data->empty) {
+    if (data->empty) {
+      snprintf(buf, sizeof(buf), "%s", data->range);
+    } else {
+      format_cdeg(low, sizeof(low), data->min_cdeg);
+      format_cdeg(high, sizeof(high), data->max_cdeg);
+      snprintf(buf, sizeof(buf), "%s %s-%s°", data->range, low, high);
+    }
+    lv_label_set_text(view->label_range, buf);
+  }
+
+  if (view->first_render || view->last_data.empty != data->empty) {
+    if (data->empty) {
+      lv_obj_clear_flag(view->label_empty, LV_OBJ_FLAG_HIDDEN);
+    } else {
+      lv_obj_add_flag(view->label_empty, LV_OBJ_FLAG_HIDDEN);
+    }
+  }
+
+  if (view->first_render || view->last_data.revision != data->revision) {
+    draw_columns(view, data->columns);
+  }
+
+  view->last_data = *data;
+  view->first_render = false;
+
+  lv_port_unlock();
+}
@@ -134,8 +134,14 @@ void HomeView_Render(HomeView_t *view, const HomeViewData_t *data) {
 
   /* Battery */
   if (view->first_render ||
-      view->last_data.battery_percentage != data->battery_percentage) {
-    snprintf(buf, sizeof(buf), "Bat: %d%%", data->battery_percentage);
+      view->last_data.battery_percentage != data->battery_percentage ||
+      view->last_data.battery_days != data->battery_days) {
+    if (data->battery_days != 0U) {
+      snprintf(buf, sizeof(buf), "%d%% %ud", data->battery_percentage,
+               (unsigned)data->battery_days);
+    } else {
+      snprintf(buf, sizeof(buf), "Bat: %d%%", data->battery_percentage);
+    }
     lv_label_set_text(view->label_battery, buf);
   }
 
@@ -176,6 +182,9 @@ void HomeView_Render(HomeView_t *view, const HomeViewData_t *data) {
       snprintf(buf, sizeof(buf), "-> %02d:%02d", data->slot_end_hour,
                data->slot_end_minute);
       lv_label_set_text(view->label_time_slot, buf);
+    } else if (data->mode == 3) /* MODE_WINDOW_OPEN */
+    {
+      lv_label_set_text(view->label_time_slot, "Window");
     } else /* MODE_MANUAL */
     {
       lv_label_set_text(view->label_time_slot, "");
@@ -184,7 +193,9 @@ void HomeView_Render(HomeView_t *view, const HomeViewData_t *data) {
 
   /* Mode Hint Label (Left Button) */
   if (view->first_render || view->last_data.mode != data->mode) {
-    const char *mode_text = (data->mode == 0) ? "Auto" : "Manual";
+    const char *mode_text = (data->mode == 0)   ? "Auto"
+                            : (data->mode == 3) ? "Resume"
+                                                : "Manual";
     lv_label_set_text(view->label_hint_left, mode_text);
   }
 
@@ -9,6 +9,7 @@ struct MenuView {
   lv_obj_t *list;
   lv_obj_t *btn_offset;
   lv_obj_t *btn_schedule;
+  lv_obj_t *btn_history;
   lv_obj_t *btn_factory_rst;
 
   lv_obj_t *label_hint_left;
@@ -69,6 +70,14 @@ MenuView_t *MenuView_Init(const char *options) {
   lv_obj_set_style_text_color(view->btn_offset, lv_color_black(),
                               LV_STATE_FOCUS_KEY);
 
+  view->btn_history = lv_list_add_btn(view->list, NULL, "History");
+  lv_obj_set_style_bg_color(view->btn_history, lv_color_black(), 0);
+  lv_obj_set_style_text_color(view->btn_history, lv_color_white(), 0);
+  lv_obj_set_style_bg_color(view->btn_history, lv_color_white(),
+                            LV_STATE_FOCUS_KEY);
+  lv_obj_set_style_text_color(view->btn_history, lv_color_black(),
+                              LV_STATE_FOCUS_KEY);
+
   view->btn_factory_rst = lv_list_add_btn(view->list, NULL, "Factory reset");
   lv_obj_set_style_bg_color(view->btn_factory_rst, lv_color_black(), 0);
   lv_obj_set_style_text_color(view->btn_factory_rst, lv_color_white(), 0);
@@ -122,6 +131,7 @@ void MenuView_Render(MenuView_t *view, const MenuViewData_t *data) {
     /* Manually manage focus state to simulate selection */
     lv_obj_clear_state(view->btn_schedule, LV_STATE_FOCUS_KEY);
     lv_obj_clear_state(view->btn_offset, LV_STATE_FOCUS_KEY);
+    lv_obj_clear_state(view->btn_history, LV_STATE_FOCUS_KEY);
     lv_obj_clear_state(view->btn_factory_rst, LV_STATE_FOCUS_KEY);
 
     if (data->selected_index == 0) {
@@ -131,6 +141,9 @@ void MenuView_Render(MenuView_t *view, const MenuViewData_t *data) {
       lv_obj_add_state(view->btn_offset, LV_STATE_FOCUS_KEY);
       lv_obj_scroll_to_view(view->btn_offset, LV_ANIM_OFF);
     } else if (data->selected_index == 2) {
+      lv_obj_add_state(view->btn_history, LV_STATE_FOCUS_KEY);
+      lv_obj_scroll_to_view(view->btn_history, LV_ANIM_OFF);
+    } else if (data->selected_index == 3) {
       lv_obj_add_state(view->btn_factory_rst, LV_STATE_FOCUS_KEY);
       lv_obj_scroll_to_view(view->btn_factory_rst, LV_ANIM_OFF);
     }
@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ * @file           :  adc_snapshot.c
+ * @brief          :  Sequence-consistent snapshots of the ADC channels
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "adc_snapshot.h"
+
+#include "cmsis_os2.h"
+#include "main.h"
+
+#include <stddef.h>
+
+/* Snapshot n is in slot n % 2; s_published is the count of snapshots
+   written, so the latest is s_published - 1 */
+static AdcSnapshot_t s_slots[2];
+static volatile uint32_t s_published = 0U;
+static volatile uint32_t s_retries = 0U;
+
+void AdcSnapshot_Init(void) {
+  s_published = 0U;
+  s_retries = 0U;
+}
+
+void AdcSnapshot_Publish(const uint16_t *samples) {
+  const uint32_t sequence = s_published;
+  AdcSnapshot_t *slot = &s_slots[sequence & 1U];
+
+  for (uint32_t i = 0U; i < ADC_SNAPSHOT_CHANNELS; i++) {
+    slot->samples[i] = samples[i];
+  }
+  slot->sequence = sequence;
+  slot->tick = osKernelGetTickCount();
+  /* The slot is complete before readers can see it */
+  __DMB();
+  s_published = sequence + 1U;
+}
+
+bool AdcSnapshot_Read(AdcSnapshot_t *snapshot) {
+  if (snapshot == NULL) {
+    return false;
+  }
+
+  for (;;) {
+    const uint32_t published = s_published;
+    if (published == 0U) {
+      return false;
+    }
+    __DMB();
+    *snapshot = s_slots[(published - 1U) & 1U];
+    __DMB();
+    /* One more sequence went to the other slot; two or more may have
+       rewritten this one while it was copied */
+    if (s_published - published < 2U) {
+      return true;
+    }
+    s_retries = s_retries + 1U;
+  }
+}
+
+uint32_t AdcSnapshot_GetRetries(void) { return s_retries; }
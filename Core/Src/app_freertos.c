@@ -24,7 +24,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "cycle_counter.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -34,7 +34,9 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+/* Run-time stats resolution: core cycles >> 5 = 1 us at 32 MHz, so the
+ * 32-bit kernel counter wraps after ~71 minutes instead of ~2 minutes */
+#define RUN_TIME_STATS_CYCLE_SHIFT 5U
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -44,7 +46,9 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
-
+/* 64-bit extension of the DWT cycle counter */
+static uint64_t s_run_time_cycles = 0U;
+static uint32_t s_run_time_last_cyccnt = 0U;
 /* USER CODE END Variables */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -52,6 +56,32 @@
 
 /* USER CODE END FunctionPrototypes */
 
+/* Hook prototypes */
+void configureTimerForRunTimeStats(void);
+unsigned long getRunTimeCounterValue(void);
+
+/* USER CODE BEGIN 1 */
+/* Functions needed when configGENERATE_RUN_TIME_STATS is on */
+void configureTimerForRunTimeStats(void) {
+  CycleCounter_Init();
+  s_run_time_cycles = 0U;
+  s_run_time_last_cyccnt = CycleCounter_Get();
+}
+
+/* Called on every context switch and from uxTaskGetSystemState(); the kernel
+ * switches far more often than CYCCNT wraps, so every wrap is observed */
+unsigned long getRunTimeCounterValue(void) {
+  const UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+  const uint32_t now = CycleCounter_Get();
+  s_run_time_cycles += (uint32_t)(now - s_run_time_last_cyccnt);
+  s_run_time_last_cyccnt = now;
+  const uint64_t cycles = s_run_time_cycles;
+  taskEXIT_CRITICAL_FROM_ISR(mask);
+
+  return (unsigned long)(uint32_t)(cycles >> RUN_TIME_STATS_CYCLE_SHIFT);
+}
+/* USER CODE END 1 */
+
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
 
@@ -0,0 +1,190 @@
+/**
+ ******************************************************************************
+ * @file           :  battery_estimator.c
+ * @brief          :  Load-compensated battery state of charge
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "battery_estimator.h"
+
+#include "sensor_calc.h"
+
+#include <stddef.h>
+
+#define MPCT_PER_PERCENT 1000U
+#define MPCT_FULL (100U * MPCT_PER_PERCENT)
+
+/* Motor charge worth a thousandth of a percent: the capacity in nC over
+   100000 (1 uAh = 3600000 nC) */
+#define NC_PER_MPCT ((uint64_t)BATTERY_ESTIMATOR_CAPACITY_MAH * 36000U)
+
+static uint32_t clamp_r(uint32_t r_mohm) {
+  if (r_mohm < BATTERY_ESTIMATOR_MIN_R_MOHM) {
+    return BATTERY_ESTIMATOR_MIN_R_MOHM;
+  }
+  return (r_mohm > BATTERY_ESTIMATOR_MAX_R_MOHM) ? BATTERY_ESTIMATOR_MAX_R_MOHM
+                                                 : r_mohm;
+}
+
+/* Move @p value by 1/2^shift of the way to @p target */
+static uint32_t approach(uint32_t value, uint32_t target, uint32_t shift) {
+  if (target >= value) {
+    return value + ((target - value) >> shift);
+  }
+  return value - ((value - target) >> shift);
+}
+
+/* Published percent, following the SoC with hysteresis */
+static void publish(BatteryEstimator_t *estimator) {
+  const uint32_t shown = (uint32_t)estimator->soc * MPCT_PER_PERCENT;
+  const uint32_t distance = (estimator->soc_mpct > shown)
+                                ? estimator->soc_mpct - shown
+                                : shown - estimator->soc_mpct;
+  if (distance >= BATTERY_ESTIMATOR_HYSTERESIS_MPCT) {
+    estimator->soc = (uint8_t)((estimator->soc_mpct + MPCT_PER_PERCENT / 2U) /
+                               MPCT_PER_PERCENT);
+  }
+}
+
+/* Restart from a rest voltage: first sample or fresh cells */
+static void prime(BatteryEstimator_t *estimator, uint32_t rest_mv) {
+  estimator->rest_mv = rest_mv;
+  estimator->soc_mpct =
+      (uint32_t)SensorCalc_BatterySoc(rest_mv) * MPCT_PER_PERCENT;
+  estimator->soc = (uint8_t)(estimator->soc_mpct / MPCT_PER_PERCENT);
+  estimator->pending_nc = 0U;
+  estimator->primed = true;
+}
+
+/* Count the motor charge and learn the resistance from the sag */
+static void update_loaded(BatteryEstimator_t *estimator,
+                          const BatteryEstimatorInput_t *input,
+                          uint32_t now_ms) {
+  const uint64_t charge_nc =
+      (uint64_t)input->current_ma * 1000U * input->period_ms;
+  estimator->motor_nc += charge_nc;
+  estimator->loaded_mv = input->battery_mv;
+  estimator->last_load_ms = now_ms;
+  estimator->loaded = true;
+
+  if (!estimator->primed) {
+    /* Booted into a motor run: compensate the sag with the assumed
+       resistance until a rest voltage is available */
+    prime(estimator, input->battery_mv + (input->current_ma *
+                                          estimator->r_mohm) / 1000U);
+    return;
+  }
+
+  estimator->pending_nc += charge_nc;
+  const uint64_t taken = estimator->pending_nc / NC_PER_MPCT;
+  estimator->pending_nc -= taken * NC_PER_MPCT;
+  estimator->soc_mpct = (taken >= estimator->soc_mpct)
+                            ? 0U
+                            : estimator->soc_mpct - (uint32_t)taken;
+
+  if (input->current_ma >= BATTERY_ESTIMATOR_MIN_LOAD_MA) {
+    const uint32_t sag_mv = (estimator->rest_mv > input->battery_mv)
+                                ? estimator->rest_mv - input->battery_mv
+                                : 0U;
+    const uint32_t sample = clamp_r((sag_mv * 1000U) / input->current_ma);
+    /* The first measurements replace the assumption outright */
+    estimator->r_mohm =
+        (estimator->r_samples == 0U)
+            ? sample
+            : approach(estimator->r_mohm, sample, BATTERY_ESTIMATOR_R_SHIFT);
+    if (estimator->r_samples < UINT16_MAX) {
+      estimator->r_samples++;
+    }
+  }
+}
+
+/* Average the rest voltage and correct the counted SoC toward it */
+static void update_rest(BatteryEstimator_t *estimator, uint32_t battery_mv) {
+  if (!estimator->primed) {
+    prime(estimator, battery_mv);
+    return;
+  }
+
+  const uint32_t sample_mpct =
+      (uint32_t)SensorCalc_BatterySoc(battery_mv) * MPCT_PER_PERCENT;
+  if (sample_mpct >= estimator->soc_mpct +
+                         BATTERY_ESTIMATOR_RESET_STEP * MPCT_PER_PERCENT) {
+    /* Fresh cells: start over, including the resistance */
+    prime(estimator, battery_mv);
+    estimator->r_mohm = BATTERY_ESTIMATOR_DEFAULT_R_MOHM;
+    estimator->r_samples = 0U;
+    return;
+  }
+
+  estimator->rest_mv =
+      approach(estimator->rest_mv, battery_mv, BATTERY_ESTIMATOR_REST_SHIFT);
+  const uint32_t rest_mpct =
+      (uint32_t)SensorCalc_BatterySoc(estimator->rest_mv) * MPCT_PER_PERCENT;
+  estimator->soc_mpct = approach(estimator->soc_mpct, rest_mpct,
+                                 BATTERY_ESTIMATOR_SOC_SHIFT);
+}
+
+void BatteryEstimator_Init(BatteryEstimator_t *estimator) {
+  if (estimator == NULL) {
+    return;
+  }
+  estimator->rest_mv = 0U;
+  estimator->loaded_mv = 0U;
+  estimator->r_mohm = BATTERY_ESTIMATOR_DEFAULT_R_MOHM;
+  estimator->soc_mpct = 0U;
+  estimator->motor_nc = 0U;
+  estimator->pending_nc = 0U;
+  estimator->last_load_ms = 0U;
+  estimator->r_samples = 0U;
+  estimator->soc = 0U;
+  estimator->loaded = false;
+  estimator->primed = false;
+}
+
+uint8_t BatteryEstimator_Update(BatteryEstimator_t *estimator,
+                                const BatteryEstimatorInput_t *input,
+                                uint32_t now_ms) {
+  if (estimator == NULL || input == NULL) {
+    return 0U;
+  }
+
+  if (input->motor_running) {
+    update_loaded(estimator, input, now_ms);
+  } else if (!estimator->loaded || !estimator->primed ||
+             now_ms - estimator->last_load_ms >=
+                 BATTERY_ESTIMATOR_RECOVERY_MS) {
+    update_rest(estimator, input->battery_mv);
+  }
+  /* else: still recovering from a run, the counted SoC stands */
+
+  if (estimator->soc_mpct > MPCT_FULL) {
+    estimator->soc_mpct = MPCT_FULL;
+  }
+  publish(estimator);
+  return estimator->soc;
+}
+
+uint32_t BatteryEstimator_RemainingUah(const BatteryEstimator_t *estimator) {
+  if (estimator == NULL) {
+    return 0U;
+  }
+  /* capacity [mAh] * 1000 * soc_mpct / 100000 */
+  return (uint32_t)(((uint64_t)estimator->soc_mpct *
+                     BATTERY_ESTIMATOR_CAPACITY_MAH) /
+                    100U);
+}
+
+uint32_t BatteryEstimator_RuntimeHours(const BatteryEstimator_t *estimator,
+                                       uint32_t average_ua) {
+  if (average_ua == 0U) {
+    return UINT32_MAX;
+  }
+  return BatteryEstimator_RemainingUah(estimator) / average_ua;
+}
@@ -0,0 +1,409 @@
+/**
+ ******************************************************************************
+ * @file           :  benchmarks.c
+ * @brief          :  Micro-benchmarks of the pure firmware kernels
+ *
+ * @details        :  Every benchmark sweeps its kernel over a fixed input
+ *                    set so that all branches are exercised and results stay
+ *                    comparable between builds. Results are written to a
+ *                    volatile sink to keep the calls from being optimized
+ *                    away. Host cycle counts are monotonic clock time scaled
+ *                    to SystemCoreClock and are only comparable with other
+ *                    host runs on the same machine.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "benchmarks.h"
+
+#include "FreeRTOS.h"
+#include "cmsis_os2.h"
+#include "cycle_counter.h"
+#include "lvgl_port_display.h"
+#include "ripple_counter.h"
+#include "schedule.h"
+#include "sensor_calc.h"
+#include "stm32wbxx_hal.h"
+#include "stm32wbxx_ll_adc.h"
+#include "storage_task.h"
+#include "task.h"
+#include "utils.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef MIRATHERM_HOST
+#define BENCHMARKS_PLATFORM "host"
+#else
+#define BENCHMARKS_PLATFORM "stm32wb55"
+#endif
+
+/* Display geometry of one LVGL partial buffer (128 x 64, 8 pixels/byte) */
+#define BENCH_DISPLAY_WIDTH 128
+#define BENCH_DISPLAY_HEIGHT 64
+
+/* Room for "OFF\n" + 50 x "NN.N\n" + "ON" */
+#define BENCH_TEMP_OPTIONS_LEN 320U
+
+/* ADC sequences per sensor sample run, VDDA from 1.8 V to 3.6 V */
+#define BENCH_SAMPLES 256U
+#define BENCH_VDDA_MIN_MV 1800U
+#define BENCH_VDDA_MAX_MV 3600U
+
+/* Temperature offset of the sample runs (a configurable 0.5 degree step) */
+#define BENCH_TEMP_OFFSET 1.5f
+
+/* Motor current of a ripple counter run: 40 mA with a 6 mA triangle ripple
+   of 16 samples, about 380 Hz at the motor sequence period */
+#define BENCH_RIPPLE_SAMPLES 256U
+#define BENCH_RIPPLE_PERIOD 16U
+#define BENCH_RIPPLE_SAMPLE_US 163U
+
+/* Settings of the temperature offset roller: -15.0 to +15.0 in 0.5 steps */
+#define BENCH_OFFSET_OPTIONS 61U
+
+typedef struct {
+  const char *name;     /* Kernel name in the JSON output */
+  uint32_t calls;       /* Kernel calls per run */
+  void (*run)(void);    /* One run over the input set */
+} Benchmark_t;
+
+static volatile uint32_t s_sink;
+static ConfigData_t s_config;
+static uint8_t s_pixels[BENCH_DISPLAY_WIDTH * BENCH_DISPLAY_HEIGHT / 8];
+static char s_options[BENCH_TEMP_OPTIONS_LEN];
+static uint16_t s_samples[BENCH_SAMPLES][4];
+static RippleCounter_t s_ripple_counter;
+static uint16_t s_ripple_current[BENCH_RIPPLE_SAMPLES];
+
+/* Sensor sample chains ------------------------------------------------------*/
+/* Float chain of the sensor task before the integer pipeline: the "before"
+ * of sample_fixed and the reference of the exactness checks */
+typedef struct {
+  float temperature;     /* degC, offset applied */
+  float motor_current;   /* A */
+  float battery_voltage; /* V */
+  uint8_t soc;
+} FloatSample_t;
+
+typedef struct {
+  int32_t temperature_cdeg;
+  uint32_t motor_current_ma;
+  uint32_t battery_mv;
+  uint8_t soc;
+} FixedSample_t;
+
+static void float_sample(const uint16_t adc[4], float offset,
+                         FloatSample_t *out) {
+  const uint32_t vref_mv = SensorCalc_VrefVoltage(adc[0]);
+  const float motor_voltage =
+      (float)SensorCalc_RawToMillivolts(adc[1], vref_mv) * 0.001f;
+  out->motor_current = motor_voltage / 0.22f;
+  out->temperature = (float)__LL_ADC_CALC_TEMPERATURE(
+                         vref_mv, adc[2], LL_ADC_RESOLUTION_12B) +
+                     offset;
+  out->battery_voltage =
+      (float)SensorCalc_RawToMillivolts(adc[3], vref_mv) * 0.001f * 3.0f;
+  out->soc =
+      SensorCalc_BatterySoc((uint16_t)(out->battery_voltage * 1000.0f));
+}
+
+static void fixed_sample(const uint16_t adc[4], uint32_t offset_bits,
+                         FixedSample_t *out) {
+  const uint32_t vref_mv = SensorCalc_VrefVoltage(adc[0]);
+  out->motor_current_ma = SensorCalc_MotorCurrent(adc[1], vref_mv);
+  out->temperature_cdeg = SensorCalc_TemperatureCenti(adc[2], vref_mv) +
+                          SensorCalc_FloatBitsToCenti(offset_bits);
+  out->battery_mv = SensorCalc_BatteryVoltage(adc[3], vref_mv);
+  out->soc = SensorCalc_BatterySoc(out->battery_mv);
+}
+
+static uint32_t float_bits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/* VREFINT conversion result at a given VDDA */
+static uint16_t vref_raw_at(uint32_t vdda_mv) {
+  return (uint16_t)(((uint32_t)*VREFINT_CAL_ADDR * VREFINT_CAL_VREF) /
+                    vdda_mv);
+}
+
+/* Kernels ------------------------------------------------------------------*/
+static void bench_vref_voltage(void) {
+  for (uint32_t raw = 1400U; raw < 1800U; raw++) {
+    s_sink += SensorCalc_VrefVoltage((uint16_t)raw);
+  }
+}
+
+static void bench_raw_to_millivolts(void) {
+  for (uint32_t raw = 0U; raw < 4096U; raw += 8U) {
+    s_sink += SensorCalc_RawToMillivolts((uint16_t)raw, 3000U);
+  }
+}
+
+static void bench_temperature_centi(void) {
+  for (uint32_t raw = 700U; raw < 1212U; raw++) {
+    s_sink += (uint32_t)SensorCalc_TemperatureCenti((uint16_t)raw, 3000U);
+  }
+}
+
+static void bench_battery_soc(void) {
+  /* 1.9 V to 3.3 V in 1 mV steps: every curve segment and both clamps */
+  for (uint32_t mv = 1900U; mv <= 3300U; mv++) {
+    s_sink += SensorCalc_BatterySoc(mv);
+  }
+}
+
+/* One sensor sample (all four channels) per call, before and after */
+static void bench_sample_float(void) {
+  FloatSample_t sample;
+  for (uint32_t i = 0U; i < BENCH_SAMPLES; i++) {
+    float_sample(s_samples[i], BENCH_TEMP_OFFSET, &sample);
+    s_sink += (uint32_t)sample.temperature + sample.soc;
+  }
+}
+
+static void bench_sample_fixed(void) {
+  const uint32_t offset_bits = float_bits(BENCH_TEMP_OFFSET);
+  FixedSample_t sample;
+  for (uint32_t i = 0U; i < BENCH_SAMPLES; i++) {
+    fixed_sample(s_samples[i], offset_bits, &sample);
+    s_sink += (uint32_t)sample.temperature_cdeg + sample.soc;
+  }
+}
+
+static void bench_ripple_update(void) {
+  /* One DMA interrupt's worth of ripple counting per sample */
+  RippleCounter_Start(&s_ripple_counter, 1, 0U);
+  for (uint32_t i = 0U; i < BENCH_RIPPLE_SAMPLES; i++) {
+    s_sink += RippleCounter_Update(&s_ripple_counter, s_ripple_current[i]);
+  }
+}
+
+static void bench_temp_to_index(void) {
+  for (uint32_t tenth = 40U; tenth <= 310U; tenth++) {
+    s_sink += Utils_TempToIndex((float)tenth * 0.1f);
+  }
+}
+
+static void bench_index_to_temp(void) {
+  for (uint16_t index = 0U; index < 52U; index++) {
+    s_sink += (uint32_t)(Utils_IndexToTemp(index) * 2.0f);
+  }
+}
+
+static void bench_schedule_slot(void) {
+  /* Every minute of the day against the 5-slot preset, on a Sunday so the
+     evening slots look ahead into Monday */
+  for (uint8_t hour = 0U; hour < 24U; hour++) {
+    for (uint8_t minute = 0U; minute < 60U; minute++) {
+      ScheduleState_t state;
+      s_sink += Schedule_Evaluate(&s_config.schedule, 6U, hour, minute, &state)
+                    ? state.next_hour
+                    : 0xFFU;
+    }
+  }
+}
+
+static void bench_config_encode(void) {
+  /* Encoding and checksum of the flash record, as on every save */
+  for (uint32_t i = 0U; i < 16U; i++) {
+    s_sink += StorageTask_CalculateChecksum(&s_config);
+  }
+}
+
+static void bench_temp_options(void) {
+  Utils_GenerateTempOptions(s_options, sizeof(s_options));
+  s_sink += (uint32_t)s_options[4];
+}
+
+static void bench_set_px(void) {
+  /* Checkerboard over the full frame, as LVGL renders it pixel by pixel */
+  for (lv_coord_t y = 0; y < BENCH_DISPLAY_HEIGHT; y++) {
+    for (lv_coord_t x = 0; x < BENCH_DISPLAY_WIDTH; x++) {
+      lv_port_set_px(s_pixels, BENCH_DISPLAY_WIDTH, x, y,
+                     ((x ^ y) & 1) != 0);
+    }
+  }
+  s_sink += s_pixels[0];
+}
+
+static const Benchmark_t s_benchmarks[] = {
+    {"vref_voltage", 400U, bench_vref_voltage},
+    {"raw_to_millivolts", 512U, bench_raw_to_millivolts},
+    {"temperature_centi", 512U, bench_temperature_centi},
+    {"battery_soc", 1401U, bench_battery_soc},
+    {"sample_float", BENCH_SAMPLES, bench_sample_float},
+    {"sample_fixed", BENCH_SAMPLES, bench_sample_fixed},
+    {"ripple_update", BENCH_RIPPLE_SAMPLES, bench_ripple_update},
+    {"temp_to_index", 271U, bench_temp_to_index},
+    {"index_to_temp", 52U, bench_index_to_temp},
+    {"schedule_slot", 24U * 60U, bench_schedule_slot},
+    {"config_encode", 16U, bench_config_encode},
+    {"temp_options", 1U, bench_temp_options},
+    {"set_px", BENCH_DISPLAY_WIDTH * BENCH_DISPLAY_HEIGHT, bench_set_px},
+};
+
+/* Runner -------------------------------------------------------------------*/
+static uint32_t time_run(const Benchmark_t *bench) {
+  const bool suspend = (osKernelGetState() == osKernelRunning);
+
+  if (suspend) {
+    vTaskSuspendAll();
+  }
+  const uint32_t start = CycleCounter_Get();
+  for (uint32_t loop = 0U; loop < BENCHMARKS_LOOPS; loop++) {
+    bench->run();
+  }
+  const uint32_t cycles = CycleCounter_Get() - start;
+  if (suspend) {
+    (void)xTaskResumeAll();
+  }
+  return cycles;
+}
+
+uint32_t Benchmarks_Run(void) {
+  const uint32_t count = sizeof(s_benchmarks) / sizeof(s_benchmarks[0]);
+
+  CycleCounter_Init();
+  memset(&s_config, 0, sizeof(s_config));
+  s_config.temperature_offset = 0.0f;
+  s_config.manual_target_temp = 20.0f;
+  Schedule_LoadDefault(&s_config.schedule, 5U);
+
+  /* VDDA sweep with every channel code range covered */
+  for (uint32_t i = 0U; i < BENCH_SAMPLES; i++) {
+    const uint32_t vdda_mv =
+        BENCH_VDDA_MIN_MV +
+        (i * (BENCH_VDDA_MAX_MV - BENCH_VDDA_MIN_MV)) / (BENCH_SAMPLES - 1U);
+    s_samples[i][0] = vref_raw_at(vdda_mv);
+    s_samples[i][1] = (uint16_t)((i * 16U) & 0xFFFU);
+    s_samples[i][2] = (uint16_t)(700U + (i * 2U));
+    s_samples[i][3] = (uint16_t)(2200U + (i * 7U));
+  }
+
+  RippleCounter_Init(&s_ripple_counter, BENCH_RIPPLE_SAMPLE_US);
+  for (uint32_t i = 0U; i < BENCH_RIPPLE_SAMPLES; i++) {
+    const uint32_t phase = i % BENCH_RIPPLE_PERIOD;
+    const uint32_t ramp = (phase < BENCH_RIPPLE_PERIOD / 2U)
+                              ? phase
+                              : BENCH_RIPPLE_PERIOD - phase;
+    s_ripple_current[i] =
+        (uint16_t)(37U + (ramp * 6U) / (BENCH_RIPPLE_PERIOD / 2U));
+  }
+
+  for (uint32_t i = 0U; i < count; i++) {
+    const Benchmark_t *bench = &s_benchmarks[i];
+
+    /* Warm-up run fills caches and the flash accelerator */
+    bench->run();
+
+    uint32_t best = UINT32_MAX;
+    for (uint32_t r = 0U; r < BENCHMARKS_REPEATS; r++) {
+      const uint32_t cycles = time_run(bench);
+      if (cycles < best) {
+        best = cycles;
+      }
+    }
+
+    /* Three decimals without pulling float printf into the output path */
+    const uint32_t calls = bench->calls * BENCHMARKS_LOOPS;
+    const uint64_t per_call_x1000 = ((uint64_t)best * 1000U) / calls;
+    printf("BENCH {\"platform\":\"%s\",\"kernel\":\"%s\",\"calls\":%lu,"
+           "\"cycles\":%lu,\"cycles_per_call\":%lu.%03lu}\n",
+           BENCHMARKS_PLATFORM, bench->name, (unsigned long)calls,
+           (unsigned long)best, (unsigned long)(per_call_x1000 / 1000U),
+           (unsigned long)(per_call_x1000 % 1000U));
+  }
+
+  return count;
+}
+
+/* Checks -------------------------------------------------------------------*/
+static uint32_t report_check(const char *name, uint32_t cases,
+                             uint32_t mismatches) {
+  printf("CHECK {\"platform\":\"%s\",\"check\":\"%s\",\"cases\":%lu,"
+         "\"mismatches\":%lu}\n",
+         BENCHMARKS_PLATFORM, name, (unsigned long)cases,
+         (unsigned long)mismatches);
+  return mismatches;
+}
+
+uint32_t Benchmarks_Check(void) {
+  uint32_t cases = 0U;
+  uint32_t motor = 0U;
+  uint32_t temperature = 0U;
+  uint32_t battery = 0U;
+  uint32_t soc = 0U;
+
+  /* Every code of every channel at VDDA steps of 100 mV, cycling through
+   * the offset roller settings */
+  for (uint32_t vdda_mv = BENCH_VDDA_MIN_MV; vdda_mv <= BENCH_VDDA_MAX_MV;
+       vdda_mv += 100U) {
+    for (uint32_t raw = 0U; raw < 4096U; raw++) {
+      const uint16_t adc[4] = {vref_raw_at(vdda_mv), (uint16_t)raw,
+                               (uint16_t)raw, (uint16_t)raw};
+      const float offset = (float)(raw % BENCH_OFFSET_OPTIONS) * 0.5f - 15.0f;
+      FloatSample_t before;
+      FixedSample_t after;
+      float_sample(adc, offset, &before);
+      fixed_sample(adc, float_bits(offset), &after);
+      cases++;
+
+      if ((uint32_t)(before.motor_current * 1000.0f) !=
+          after.motor_current_ma) {
+        motor++;
+      }
+      /* The float chain kept whole degrees: truncating the centidegrees
+       * toward TS_CAL1_TEMP must give them back exactly, with the offset
+       * added on top */
+      const int32_t cal1_cdeg = (int32_t)TEMPSENSOR_CAL1_TEMP * 100;
+      const int32_t offset_cdeg =
+          (int32_t)(raw % BENCH_OFFSET_OPTIONS) * 50 - 1500;
+      const int32_t whole =
+          (after.temperature_cdeg - offset_cdeg - cal1_cdeg) / 100 +
+          (int32_t)TEMPSENSOR_CAL1_TEMP;
+      if ((float)whole + offset != before.temperature) {
+        temperature++;
+      }
+      /* The float chain truncated x.xxx999 V to the millivolt below */
+      const uint32_t before_mv =
+          (uint16_t)(before.battery_voltage * 1000.0f);
+      if (after.battery_mv != before_mv && after.battery_mv != before_mv + 1U) {
+        battery++;
+      }
+      if (before.soc != after.soc) {
+        soc++;
+      }
+    }
+  }
+
+  uint32_t mismatches = 0U;
+  mismatches += report_check("motor_current", cases, motor);
+  mismatches += report_check("temperature", cases, temperature);
+  mismatches += report_check("battery_voltage", cases, battery);
+  mismatches += report_check("battery_soc", cases, soc);
+
+  /* Offsets decoded from their float bits, over the whole int16 range */
+  uint32_t offset_cases = 0U;
+  uint32_t offsets = 0U;
+  for (int32_t centi = -INT16_MAX; centi <= INT16_MAX; centi++) {
+    offset_cases++;
+    if (SensorCalc_FloatBitsToCenti(float_bits((float)centi * 0.01f)) !=
+        centi) {
+      offsets++;
+    }
+  }
+  mismatches += report_check("offset_centi", offset_cases, offsets);
+
+  return mismatches;
+}
@@ -0,0 +1,207 @@
+/**
+ ******************************************************************************
+ * @file           :  config_codec.c
+ * @brief          :  Bit-packed serialisation of the configuration
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "config_codec.h"
+
+#include "schedule.h"
+#include "utils.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define OFFSET_BITS 7U
+#define INDEX_BITS 6U
+#define COUNT_BITS 3U
+#define START_BITS 9U
+#define RATE_BITS 8U
+
+/* Heat-up rate resolution in 0.01 °C per hour */
+#define RATE_STEP_CDEG_H 5U
+
+typedef struct {
+  uint8_t *data;
+  uint32_t size;
+  uint32_t bit;
+  bool overflow;
+} BitWriter_t;
+
+typedef struct {
+  const uint8_t *data;
+  uint32_t size;
+  uint32_t bit;
+  bool overflow;
+} BitReader_t;
+
+/* Least significant bit first, a byte at a time; the buffer is cleared
+   before writing */
+static void put_bits(BitWriter_t *writer, uint32_t value, uint32_t bits) {
+  uint32_t done = 0U;
+  while (done < bits) {
+    const uint32_t byte = writer->bit / 8U;
+    if (byte >= writer->size) {
+      writer->overflow = true;
+      return;
+    }
+    const uint32_t shift = writer->bit % 8U;
+    uint32_t take = 8U - shift;
+    if (take > bits - done)
+      take = bits - done;
+    const uint32_t chunk = (value >> done) & ((1U << take) - 1U);
+    writer->data[byte] |= (uint8_t)(chunk << shift);
+    writer->bit += take;
+    done += take;
+  }
+}
+
+static uint32_t get_bits(BitReader_t *reader, uint32_t bits) {
+  uint32_t value = 0U;
+  uint32_t done = 0U;
+  while (done < bits) {
+    const uint32_t byte = reader->bit / 8U;
+    if (byte >= reader->size) {
+      reader->overflow = true;
+      return 0U;
+    }
+    const uint32_t shift = reader->bit % 8U;
+    uint32_t take = 8U - shift;
+    if (take > bits - done)
+      take = bits - done;
+    const uint32_t chunk =
+        ((uint32_t)reader->data[byte] >> shift) & ((1U << take) - 1U);
+    value |= chunk << done;
+    reader->bit += take;
+    done += take;
+  }
+  return value;
+}
+
+/* Offset in 0.5 °C steps, rounded to nearest and clamped to the editor's
+   range */
+static int32_t offset_to_steps(float offset) {
+  const float half_steps = offset * 2.0f;
+  int32_t steps =
+      (int32_t)(half_steps + ((half_steps >= 0.0f) ? 0.5f : -0.5f));
+  if (steps > CONFIG_CODEC_OFFSET_MAX_STEPS)
+    steps = CONFIG_CODEC_OFFSET_MAX_STEPS;
+  if (steps < -CONFIG_CODEC_OFFSET_MAX_STEPS)
+    steps = -CONFIG_CODEC_OFFSET_MAX_STEPS;
+  return steps;
+}
+
+uint32_t ConfigCodec_Encode(const ConfigData_t *config, uint8_t *buffer,
+                            uint32_t size) {
+  if (config == NULL || buffer == NULL ||
+      !Schedule_IsValid(&config->schedule)) {
+    return 0U;
+  }
+
+  memset(buffer, 0, size);
+  BitWriter_t writer = {buffer, size, 0U, false};
+
+  /* Two's complement in OFFSET_BITS bits */
+  put_bits(&writer,
+           (uint32_t)offset_to_steps(config->temperature_offset) &
+               ((1U << OFFSET_BITS) - 1U),
+           OFFSET_BITS);
+  put_bits(&writer, Utils_TempToIndex(config->manual_target_temp),
+           INDEX_BITS);
+  uint32_t rate_steps = (config->heatup_rate_cdeg_h + RATE_STEP_CDEG_H / 2U) /
+                        RATE_STEP_CDEG_H;
+  if (rate_steps >= (1U << RATE_BITS))
+    rate_steps = (1U << RATE_BITS) - 1U;
+  put_bits(&writer, rate_steps, RATE_BITS);
+
+  const WeeklyScheduleTypeDef *weekly = &config->schedule;
+  for (uint8_t day = 0U; day < SCHEDULE_DAYS; day++) {
+    const uint8_t count = weekly->num_slots[day];
+    put_bits(&writer, count - 1U, COUNT_BITS);
+    put_bits(&writer, SCHEDULE_SLOT_INDEX(weekly->slots[day][0]), INDEX_BITS);
+    for (uint8_t i = 1U; i < count; i++) {
+      const uint16_t slot = weekly->slots[day][i];
+      put_bits(&writer, SCHEDULE_SLOT_START(slot) / SCHEDULE_STEP_MIN,
+               START_BITS);
+      put_bits(&writer, SCHEDULE_SLOT_INDEX(slot), INDEX_BITS);
+    }
+  }
+
+  return writer.overflow ? 0U : (writer.bit + 7U) / 8U;
+}
+
+bool ConfigCodec_Decode(const uint8_t *buffer, uint32_t length,
+                        ConfigData_t *config) {
+  if (buffer == NULL || config == NULL) {
+    return false;
+  }
+
+  BitReader_t reader = {buffer, length, 0U, false};
+  ConfigData_t decoded;
+  memset(&decoded, 0, sizeof(decoded));
+
+  /* Sign-extend the offset */
+  int32_t steps = (int32_t)get_bits(&reader, OFFSET_BITS);
+  if (steps >= (1 << (OFFSET_BITS - 1U))) {
+    steps -= (1 << OFFSET_BITS);
+  }
+  if (steps > CONFIG_CODEC_OFFSET_MAX_STEPS ||
+      steps < -CONFIG_CODEC_OFFSET_MAX_STEPS) {
+    return false;
+  }
+  decoded.temperature_offset = (float)steps * 0.5f;
+
+  const uint32_t manual = get_bits(&reader, INDEX_BITS);
+  if (manual > UTILS_TEMP_INDEX_ON) {
+    return false;
+  }
+  decoded.manual_target_temp = Utils_IndexToTemp((uint16_t)manual);
+  decoded.heatup_rate_cdeg_h =
+      (uint16_t)(get_bits(&reader, RATE_BITS) * RATE_STEP_CDEG_H);
+
+  WeeklyScheduleTypeDef *weekly = &decoded.schedule;
+  for (uint8_t day = 0U; day < SCHEDULE_DAYS; day++) {
+    const uint32_t count = get_bits(&reader, COUNT_BITS) + 1U;
+    if (count > SCHEDULE_MAX_SLOTS) {
+      return false;
+    }
+    weekly->num_slots[day] = (uint8_t)count;
+    weekly->slots[day][0] = SCHEDULE_SLOT(0U, get_bits(&reader, INDEX_BITS));
+    for (uint32_t i = 1U; i < count; i++) {
+      const uint32_t start =
+          get_bits(&reader, START_BITS) * SCHEDULE_STEP_MIN;
+      weekly->slots[day][i] =
+          SCHEDULE_SLOT(start, get_bits(&reader, INDEX_BITS));
+    }
+  }
+
+  /* The encoding fills the buffer up to its last byte, and indices and
+     start times are checked with the rest of the schedule */
+  if (reader.overflow || (reader.bit + 7U) / 8U != length ||
+      !Schedule_IsValid(weekly)) {
+    return false;
+  }
+
+  memcpy(config, &decoded, sizeof(decoded));
+  return true;
+}
+
+uint32_t ConfigCodec_Checksum(const uint8_t *data, uint32_t length) {
+  if (data == NULL)
+    return 0;
+
+  uint32_t checksum = 0;
+  for (uint32_t i = 0; i < length; i++) {
+    checksum += data[i];
+    checksum = (checksum << 1) | (checksum >> 31); /* Rotate left */
+  }
+  return checksum;
+}
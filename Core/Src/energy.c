@@ -0,0 +1,362 @@
+/**
+ ******************************************************************************
+ * @file           :  energy.c
+ * @brief          :  Energy accounting and battery-life projection
+ *
+ * @details        :  Counters are kept as event counts and converted to
+ *                    charge in Energy_Update(), so the hooks in the display,
+ *                    storage and sensor paths cost one critical section.
+ *                    Charge is accumulated in nanocoulombs (uA * ms) in
+ *                    64-bit sums.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "energy.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_stats.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ENERGY_NC_PER_UAH 3600000ULL
+#define ENERGY_MS_PER_HOUR 3600000UL
+
+/* Name the kernel gives the idle task */
+#ifndef configIDLE_TASK_NAME
+#define configIDLE_TASK_NAME "IDLE"
+#endif
+
+/* A rise of the SoC by this much means fresh cells: restart the trend */
+#define ENERGY_TREND_RESET_STEP 20U
+
+static const char *const k_sink_names[ENERGY_SINK_COUNT] = {
+    "base", "run", "idle", "motor", "adc", "display", "flash"};
+
+/* Event counters, written by the hooks (guarded by a critical section) */
+static uint64_t s_motor_nc = 0U;
+static uint32_t s_motor_ms = 0U;
+static uint32_t s_adc_sequences = 0U;
+static uint32_t s_adc_remainder_us = 0U;
+static uint32_t s_display_bytes = 0U;
+static uint32_t s_flash_erases = 0U;
+static uint32_t s_flash_dwords = 0U;
+
+/* Time accounting, owned by Energy_Update() */
+static uint64_t s_elapsed_ms = 0U;
+static uint64_t s_awake_ms = 0U;
+static uint32_t s_last_tick = 0U;
+static uint32_t s_last_total_run_time = 0U;
+static uint32_t s_last_idle_run_time = 0U;
+static bool s_started = false;
+
+/* Hourly SoC trend (ring of the last ENERGY_TREND_HOURS samples) */
+static uint8_t s_trend[ENERGY_TREND_HOURS];
+static uint16_t s_trend_head = 0U;
+static uint16_t s_trend_count = 0U;
+static uint64_t s_next_trend_ms = 0U;
+
+/* Latest result, read by Energy_GetStats() and Energy_GetCounters() */
+static EnergyStats_t s_stats;
+static EnergyCounters_t s_counters;
+
+void Energy_AddMotor(uint32_t current_ma, uint32_t period_ms) {
+  taskENTER_CRITICAL();
+  s_motor_nc += (uint64_t)current_ma * period_ms * 1000U;
+  s_motor_ms += period_ms;
+  taskEXIT_CRITICAL();
+}
+
+void Energy_AddAdcSequences(uint32_t count) {
+  taskENTER_CRITICAL();
+  s_adc_sequences += count;
+  taskEXIT_CRITICAL();
+}
+
+void Energy_AddAdcRunTime(uint32_t period_ms) {
+  taskENTER_CRITICAL();
+  const uint32_t us = s_adc_remainder_us + period_ms * 1000U;
+  s_adc_sequences += us / ENERGY_ADC_SEQUENCE_US;
+  s_adc_remainder_us = us % ENERGY_ADC_SEQUENCE_US;
+  taskEXIT_CRITICAL();
+}
+
+void Energy_AddDisplayBytes(uint32_t bytes) {
+  taskENTER_CRITICAL();
+  s_display_bytes += bytes;
+  taskEXIT_CRITICAL();
+}
+
+void Energy_AddFlashErase(void) {
+  taskENTER_CRITICAL();
+  s_flash_erases++;
+  taskEXIT_CRITICAL();
+}
+
+void Energy_AddFlashProgram(uint32_t double_words) {
+  taskENTER_CRITICAL();
+  s_flash_dwords += double_words;
+  taskEXIT_CRITICAL();
+}
+
+/* Run-time counters of the idle task and of the whole system */
+static bool read_run_times(uint32_t *idle, uint32_t *total) {
+  static TaskStatus_t status[TASK_STATS_MAX_TASKS];
+  const UBaseType_t count =
+      uxTaskGetSystemState(status, TASK_STATS_MAX_TASKS, total);
+
+  for (UBaseType_t i = 0U; i < count; i++) {
+    if (strcmp(status[i].pcTaskName, configIDLE_TASK_NAME) == 0) {
+      *idle = status[i].ulRunTimeCounter;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Split the window of @p delta_ms into awake and idle time */
+static uint32_t awake_ms(uint32_t delta_ms) {
+  uint32_t idle = 0U;
+  uint32_t total = 0U;
+  if (!read_run_times(&idle, &total)) {
+    return delta_ms; /* Unknown: charge it all as run time */
+  }
+
+  /* Deltas are wrap-safe while calls are closer than the counter period */
+  const uint32_t idle_delta = idle - s_last_idle_run_time;
+  const uint32_t total_delta = total - s_last_total_run_time;
+  s_last_idle_run_time = idle;
+  s_last_total_run_time = total;
+
+  if (total_delta == 0U || idle_delta > total_delta) {
+    return delta_ms;
+  }
+  const uint64_t busy = total_delta - idle_delta;
+  return (uint32_t)((busy * delta_ms) / total_delta);
+}
+
+/* Add an hourly SoC sample; fresh cells restart the trend */
+static void add_trend_sample(uint8_t soc) {
+  if (s_trend_count > 0U) {
+    const uint16_t last = (uint16_t)((s_trend_head + ENERGY_TREND_HOURS - 1U) %
+                                     ENERGY_TREND_HOURS);
+    if (soc >= s_trend[last] + ENERGY_TREND_RESET_STEP) {
+      s_trend_count = 0U;
+    }
+  }
+
+  s_trend[s_trend_head] = soc;
+  s_trend_head = (uint16_t)((s_trend_head + 1U) % ENERGY_TREND_HOURS);
+  if (s_trend_count < ENERGY_TREND_HOURS) {
+    s_trend_count++;
+  }
+}
+
+/* Least-squares slope of the trend window in percent per hour, as the
+ * fraction *num / *den (den > 0); false if it is undefined */
+static bool trend_slope(int64_t *num, int64_t *den) {
+  const uint32_t n = s_trend_count;
+  const uint32_t first =
+      (s_trend_head + ENERGY_TREND_HOURS - n) % ENERGY_TREND_HOURS;
+  int64_t sum_x = 0;
+  int64_t sum_y = 0;
+  int64_t sum_xy = 0;
+  int64_t sum_xx = 0;
+
+  for (uint32_t x = 0U; x < n; x++) {
+    const int64_t y = s_trend[(first + x) % ENERGY_TREND_HOURS];
+    sum_x += x;
+    sum_y += y;
+    sum_xy += (int64_t)x * y;
+    sum_xx += (int64_t)x * x;
+  }
+
+  *num = (int64_t)n * sum_xy - sum_x * sum_y;
+  *den = (int64_t)n * sum_xx - sum_x * sum_x;
+  return *den > 0;
+}
+
+/* num / den rounded to whole days, clamped to ENERGY_DAYS_MAX */
+static uint16_t clamp_days(uint64_t num, uint64_t den) {
+  if (den == 0U) {
+    return ENERGY_DAYS_UNKNOWN;
+  }
+  const uint64_t days = (num + den / 2U) / den;
+  return (days >= ENERGY_DAYS_MAX) ? (uint16_t)ENERGY_DAYS_MAX
+                                   : (uint16_t)days;
+}
+
+uint16_t Energy_Update(uint8_t soc) {
+  const uint32_t now =
+      (uint32_t)(((uint64_t)xTaskGetTickCount() * 1000U) / configTICK_RATE_HZ);
+
+  if (!s_started) {
+    /* First call: only take the reference points */
+    uint32_t idle = 0U;
+    uint32_t total = 0U;
+    (void)read_run_times(&idle, &total);
+    s_last_idle_run_time = idle;
+    s_last_total_run_time = total;
+    s_last_tick = now;
+    s_started = true;
+    add_trend_sample(soc);
+    s_next_trend_ms = ENERGY_MS_PER_HOUR;
+    return ENERGY_DAYS_UNKNOWN;
+  }
+
+  const uint32_t delta_ms = now - s_last_tick;
+  s_last_tick = now;
+  s_elapsed_ms += delta_ms;
+  s_awake_ms += awake_ms(delta_ms);
+
+  if (s_elapsed_ms >= s_next_trend_ms) {
+    add_trend_sample(soc);
+    s_next_trend_ms += ENERGY_MS_PER_HOUR;
+  }
+
+  EnergyStats_t stats;
+  memset(&stats, 0, sizeof(stats));
+
+  taskENTER_CRITICAL();
+  const uint64_t motor_nc = s_motor_nc;
+  stats.motor_ms = s_motor_ms;
+  stats.adc_sequences = s_adc_sequences;
+  stats.display_bytes = s_display_bytes;
+  stats.flash_erases = s_flash_erases;
+  stats.flash_dwords = s_flash_dwords;
+  taskEXIT_CRITICAL();
+
+  /* uA * ms = nC */
+  const uint64_t idle_ms = s_elapsed_ms - s_awake_ms;
+  uint64_t charge_nc[ENERGY_SINK_COUNT];
+  charge_nc[ENERGY_SINK_BASE] = s_elapsed_ms * ENERGY_BASE_UA;
+  charge_nc[ENERGY_SINK_RUN] = s_awake_ms * ENERGY_RUN_UA;
+  charge_nc[ENERGY_SINK_IDLE] = idle_ms * ENERGY_IDLE_UA;
+  charge_nc[ENERGY_SINK_MOTOR] = motor_nc;
+  charge_nc[ENERGY_SINK_ADC] =
+      (uint64_t)stats.adc_sequences * ENERGY_ADC_SEQUENCE_NC;
+  charge_nc[ENERGY_SINK_DISPLAY] =
+      (uint64_t)stats.display_bytes * ENERGY_DISPLAY_BYTE_NC;
+  charge_nc[ENERGY_SINK_FLASH] =
+      (uint64_t)stats.flash_erases * ENERGY_FLASH_ERASE_NC +
+      (uint64_t)stats.flash_dwords * ENERGY_FLASH_DWORD_NC;
+
+  uint64_t total_nc = 0U;
+  for (uint32_t i = 0U; i < ENERGY_SINK_COUNT; i++) {
+    stats.charge_uah[i] = (uint32_t)(charge_nc[i] / ENERGY_NC_PER_UAH);
+    total_nc += charge_nc[i];
+  }
+
+  stats.elapsed_s = (uint32_t)(s_elapsed_ms / 1000U);
+  stats.awake_s = (uint32_t)(s_awake_ms / 1000U);
+  stats.soc = soc;
+  stats.trend_hours = s_trend_count;
+
+  /* Model: charge left at this SoC over the average current (integer
+   * math keeps the sensor task off the FPU) */
+  if (s_elapsed_ms > 0U && total_nc > 0U) {
+    stats.average_ua = (uint32_t)(total_nc / s_elapsed_ms);
+    const uint64_t remaining_uah =
+        (uint64_t)ENERGY_BATTERY_CAPACITY_MAH * 10U * soc;
+    stats.model_days =
+        clamp_days(remaining_uah * s_elapsed_ms, total_nc * 24U);
+  }
+
+  /* Trend: time until the fitted SoC line reaches zero; it gains weight
+   * as the window fills */
+  uint32_t weight = 0U;
+  int64_t num = 0;
+  int64_t den = 0;
+  if (s_trend_count >= ENERGY_TREND_MIN_HOURS && trend_slope(&num, &den) &&
+      num < 0) {
+    stats.trend_days =
+        clamp_days((uint64_t)soc * (uint64_t)den, (uint64_t)(-num) * 24U);
+    weight = s_trend_count - 1U;
+  }
+
+  if (stats.model_days != ENERGY_DAYS_UNKNOWN) {
+    const uint32_t scale = ENERGY_TREND_HOURS - 1U;
+    stats.days = clamp_days((uint64_t)stats.model_days * (scale - weight) +
+                                (uint64_t)stats.trend_days * weight,
+                            scale);
+  }
+
+  taskENTER_CRITICAL();
+  s_stats = stats;
+  s_counters.elapsed_ms = s_elapsed_ms;
+  s_counters.awake_ms = s_awake_ms;
+  s_counters.motor_nc = motor_nc;
+  s_counters.display_bytes = stats.display_bytes;
+  taskEXIT_CRITICAL();
+
+  return stats.days;
+}
+
+void Energy_GetStats(EnergyStats_t *stats) {
+  if (stats == NULL) {
+    return;
+  }
+  taskENTER_CRITICAL();
+  *stats = s_stats;
+  taskEXIT_CRITICAL();
+}
+
+void Energy_GetCounters(EnergyCounters_t *counters) {
+  if (counters == NULL) {
+    return;
+  }
+  taskENTER_CRITICAL();
+  *counters = s_counters;
+  taskEXIT_CRITICAL();
+}
+
+void Energy_Report(void) {
+  EnergyStats_t stats;
+  Energy_GetStats(&stats);
+
+  const uint32_t awake_pct =
+      (stats.elapsed_s == 0U) ? 0U : (stats.awake_s * 100U) / stats.elapsed_s;
+
+  printf("Energy: %lu s, awake %lu%%, avg %lu uA, SoC %u%%, %u days "
+         "(model %u, trend %u over %u h)\n",
+         (unsigned long)stats.elapsed_s, (unsigned long)awake_pct,
+         (unsigned long)stats.average_ua, stats.soc, stats.days,
+         stats.model_days, stats.trend_days, stats.trend_hours);
+  printf("Sink          uAh\n");
+  for (uint32_t i = 0U; i < ENERGY_SINK_COUNT; i++) {
+    printf("%-8s %8lu\n", k_sink_names[i],
+           (unsigned long)stats.charge_uah[i]);
+  }
+
+  const uint32_t *uah = stats.charge_uah;
+  printf("ENERGY {\"elapsed_s\":%lu,\"awake_s\":%lu,\"motor_ms\":%lu,"
+         "\"adc_sequences\":%lu,\"display_bytes\":%lu,\"flash_erases\":%lu,"
+         "\"flash_dwords\":%lu,\"charge_uah\":{\"base\":%lu,\"run\":%lu,"
+         "\"idle\":%lu,\"motor\":%lu,\"adc\":%lu,\"display\":%lu,"
+         "\"flash\":%lu},"
+         "\"average_ua\":%lu,\"soc\":%u,\"trend_hours\":%u,"
+         "\"model_days\":%u,\"trend_days\":%u,\"days\":%u}\n",
+         (unsigned long)stats.elapsed_s, (unsigned long)stats.awake_s,
+         (unsigned long)stats.motor_ms, (unsigned long)stats.adc_sequences,
+         (unsigned long)stats.display_bytes,
+         (unsigned long)stats.flash_erases,
+         (unsigned long)stats.flash_dwords,
+         (unsigned long)uah[ENERGY_SINK_BASE],
+         (unsigned long)uah[ENERGY_SINK_RUN],
+         (unsigned long)uah[ENERGY_SINK_IDLE],
+         (unsigned long)uah[ENERGY_SINK_MOTOR],
+         (unsigned long)uah[ENERGY_SINK_ADC],
+         (unsigned long)uah[ENERGY_SINK_DISPLAY],
+         (unsigned long)uah[ENERGY_SINK_FLASH], (unsigned long)stats.average_ua,
+         stats.soc, stats.trend_hours, stats.model_days, stats.trend_days,
+         stats.days);
+}
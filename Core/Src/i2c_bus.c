@@ -0,0 +1,322 @@
+/**
+ ******************************************************************************
+ * @file           :  i2c_bus.c
+ * @brief          :  Shared I2C bus with queued DMA transactions
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "i2c_bus.h"
+
+#include "FreeRTOS.h"
+#include "cmsis_os2.h"
+#include "cycle_counter.h"
+#include "task.h"
+#include "task_debug.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+/* Flags of the bus task */
+#define I2C_BUS_FLAG_SUBMIT 0x0001U
+#define I2C_BUS_FLAG_XFER_DONE 0x0002U
+#define I2C_BUS_FLAG_XFER_ERROR 0x0004U
+
+/* Bytes on the bus besides the data: device address and register */
+#define I2C_BUS_HEADER_BYTES 2U
+
+typedef struct {
+  I2CBusTransaction_t *head;
+  I2CBusTransaction_t *tail;
+} I2CBusQueue_t;
+
+static const char *const k_priority_names[I2C_BUS_PRIORITY_COUNT] = {
+    "high", "normal", "low"};
+
+static I2C_HandleTypeDef *s_hi2c;
+static osThreadId_t s_bus_thread;
+/* One FIFO per priority; queues and statistics are shared with the
+   submitting tasks under a critical section */
+static I2CBusQueue_t s_queues[I2C_BUS_PRIORITY_COUNT];
+static I2CBusStats_t s_clients[I2C_BUS_MAX_CLIENTS];
+static uint32_t s_client_count;
+/* End of the running transfer, stamped by the completion interrupt */
+static volatile uint32_t s_xfer_end_cycles;
+
+void I2CBus_Init(I2C_HandleTypeDef *hi2c) { s_hi2c = hi2c; }
+
+int32_t I2CBus_RegisterClient(const char *name, I2CBusPriority_t priority) {
+  if (priority >= I2C_BUS_PRIORITY_COUNT) {
+    priority = I2C_BUS_PRIORITY_LOW;
+  }
+  int32_t client = -1;
+  taskENTER_CRITICAL();
+  if (s_client_count < I2C_BUS_MAX_CLIENTS) {
+    client = (int32_t)s_client_count;
+    s_clients[client] = (I2CBusStats_t){.name = name, .priority = priority};
+    s_client_count++;
+  }
+  taskEXIT_CRITICAL();
+  return client;
+}
+
+static bool is_valid(const I2CBusTransaction_t *txn) {
+  return s_hi2c != NULL && txn != NULL && txn->client >= 0 &&
+         (uint32_t)txn->client < s_client_count && txn->data != NULL &&
+         txn->size != 0U;
+}
+
+bool I2CBus_Submit(I2CBusTransaction_t *txn) {
+  if (!is_valid(txn)) {
+    return false;
+  }
+  txn->status = I2C_BUS_PENDING;
+  txn->next = NULL;
+  txn->submit_cycles = CycleCounter_Get();
+
+  I2CBusQueue_t *queue = &s_queues[s_clients[txn->client].priority];
+  taskENTER_CRITICAL();
+  if (queue->tail != NULL) {
+    queue->tail->next = txn;
+  } else {
+    queue->head = txn;
+  }
+  queue->tail = txn;
+  const osThreadId_t bus_thread = s_bus_thread;
+  taskEXIT_CRITICAL();
+
+  /* Before the task runs, it finds the queue filled when it starts */
+  if (bus_thread != NULL) {
+    (void)osThreadFlagsSet(bus_thread, I2C_BUS_FLAG_SUBMIT);
+  }
+  return true;
+}
+
+/* Oldest transaction of the highest priority */
+static I2CBusTransaction_t *take_next(void) {
+  I2CBusTransaction_t *txn = NULL;
+  taskENTER_CRITICAL();
+  for (uint32_t p = 0U; p < I2C_BUS_PRIORITY_COUNT && txn == NULL; p++) {
+    I2CBusQueue_t *queue = &s_queues[p];
+    txn = queue->head;
+    if (txn != NULL) {
+      queue->head = txn->next;
+      if (queue->head == NULL) {
+        queue->tail = NULL;
+      }
+    }
+  }
+  taskEXIT_CRITICAL();
+  return txn;
+}
+
+static void account(const I2CBusTransaction_t *txn, I2CBusStatus_t status,
+                    uint32_t start_cycles, uint32_t end_cycles) {
+  const uint32_t wait_us =
+      CycleCounter_ToUs(start_cycles - txn->submit_cycles);
+  const uint32_t bus_us = CycleCounter_ToUs(end_cycles - start_cycles);
+  I2CBusStats_t *client = &s_clients[txn->client];
+
+  taskENTER_CRITICAL();
+  client->transactions++;
+  if (status != I2C_BUS_OK) {
+    client->errors++;
+  }
+  client->bytes += (uint32_t)txn->size + I2C_BUS_HEADER_BYTES;
+  client->bus_us += bus_us;
+  client->wait_us += wait_us;
+  if (wait_us > client->max_wait_us) {
+    client->max_wait_us = wait_us;
+  }
+  taskEXIT_CRITICAL();
+}
+
+static void complete(I2CBusTransaction_t *txn, I2CBusStatus_t status) {
+  /* The owner may reuse the descriptor as soon as the status is set */
+  const osThreadId_t notify = txn->notify;
+  const uint32_t notify_flags = txn->notify_flags;
+  txn->status = status;
+  if (notify != NULL) {
+    (void)osThreadFlagsSet(notify, notify_flags);
+  }
+}
+
+/* A transfer that did not finish leaves the peripheral and its DMA channel
+   busy; start over from the configuration in the handle */
+static void recover_bus(void) {
+  (void)HAL_I2C_DeInit(s_hi2c);
+  if (HAL_I2C_Init(s_hi2c) != HAL_OK) {
+    printf("I2CBus: reinit failed\n");
+  }
+}
+
+/* Run one transaction with DMA; returns when it has completed */
+static I2CBusStatus_t execute(const I2CBusTransaction_t *txn,
+                              uint32_t *end_cycles) {
+  (void)osThreadFlagsClear(I2C_BUS_FLAG_XFER_DONE | I2C_BUS_FLAG_XFER_ERROR);
+  const HAL_StatusTypeDef started =
+      txn->read ? HAL_I2C_Mem_Read_DMA(s_hi2c, txn->dev_addr, txn->mem_addr,
+                                       I2C_MEMADD_SIZE_8BIT, txn->data,
+                                       txn->size)
+                : HAL_I2C_Mem_Write_DMA(s_hi2c, txn->dev_addr, txn->mem_addr,
+                                        I2C_MEMADD_SIZE_8BIT, txn->data,
+                                        txn->size);
+  if (started != HAL_OK) {
+    *end_cycles = CycleCounter_Get();
+    recover_bus();
+    return I2C_BUS_ERROR;
+  }
+
+  const uint32_t flags =
+      osThreadFlagsWait(I2C_BUS_FLAG_XFER_DONE | I2C_BUS_FLAG_XFER_ERROR,
+                        osFlagsWaitAny, pdMS_TO_TICKS(I2C_BUS_TIMEOUT_MS));
+  if ((flags & osFlagsError) != 0U) {
+    *end_cycles = CycleCounter_Get();
+    printf("I2CBus: client %ld timed out\n", (long)txn->client);
+    recover_bus();
+    return I2C_BUS_TIMEOUT;
+  }
+  *end_cycles = s_xfer_end_cycles;
+  return ((flags & I2C_BUS_FLAG_XFER_ERROR) != 0U) ? I2C_BUS_ERROR
+                                                   : I2C_BUS_OK;
+}
+
+void StartI2CBusTask(void *argument) {
+  (void)argument;
+#if OS_TASKS_DEBUG
+  printf("I2CBusTask running (heap=%lu)\n",
+         (unsigned long)xPortGetFreeHeapSize());
+#endif
+  taskENTER_CRITICAL();
+  s_bus_thread = osThreadGetId();
+  taskEXIT_CRITICAL();
+
+  for (;;) {
+    I2CBusTransaction_t *txn = take_next();
+    if (txn == NULL) {
+      (void)osThreadFlagsWait(I2C_BUS_FLAG_SUBMIT, osFlagsWaitAny,
+                              osWaitForever);
+      continue;
+    }
+
+    const uint32_t start_cycles = CycleCounter_Get();
+    uint32_t end_cycles = start_cycles;
+    const I2CBusStatus_t status = execute(txn, &end_cycles);
+    account(txn, status, start_cycles, end_cycles);
+    complete(txn, status);
+  }
+}
+
+/* Before the scheduler runs there is no bus task to wait for */
+static I2CBusStatus_t transfer_polling(I2CBusTransaction_t *txn) {
+  const uint32_t start_cycles = CycleCounter_Get();
+  txn->submit_cycles = start_cycles;
+  const HAL_StatusTypeDef result =
+      txn->read ? HAL_I2C_Mem_Read(s_hi2c, txn->dev_addr, txn->mem_addr,
+                                   I2C_MEMADD_SIZE_8BIT, txn->data, txn->size,
+                                   I2C_BUS_TIMEOUT_MS)
+                : HAL_I2C_Mem_Write(s_hi2c, txn->dev_addr, txn->mem_addr,
+                                    I2C_MEMADD_SIZE_8BIT, txn->data, txn->size,
+                                    I2C_BUS_TIMEOUT_MS);
+  const I2CBusStatus_t status =
+      (result == HAL_OK)        ? I2C_BUS_OK
+      : (result == HAL_TIMEOUT) ? I2C_BUS_TIMEOUT
+                                : I2C_BUS_ERROR;
+  account(txn, status, start_cycles, CycleCounter_Get());
+  txn->status = status;
+  return status;
+}
+
+I2CBusStatus_t I2CBus_Transfer(I2CBusTransaction_t *txn) {
+  if (!is_valid(txn)) {
+    return I2C_BUS_ERROR;
+  }
+  if (osKernelGetState() != osKernelRunning) {
+    return transfer_polling(txn);
+  }
+
+  txn->notify = osThreadGetId();
+  txn->notify_flags = I2C_BUS_FLAG_DONE;
+  (void)osThreadFlagsClear(I2C_BUS_FLAG_DONE);
+  if (!I2CBus_Submit(txn)) {
+    return I2C_BUS_ERROR;
+  }
+  while (txn->status == I2C_BUS_PENDING) {
+    (void)osThreadFlagsWait(I2C_BUS_FLAG_DONE, osFlagsWaitAny,
+                            osWaitForever);
+  }
+  return txn->status;
+}
+
+bool I2CBus_GetStats(int32_t client, I2CBusStats_t *stats) {
+  if (client < 0 || (uint32_t)client >= s_client_count || stats == NULL) {
+    return false;
+  }
+  taskENTER_CRITICAL();
+  *stats = s_clients[client];
+  taskEXIT_CRITICAL();
+  return true;
+}
+
+void I2CBus_Report(void) {
+  const uint32_t count = s_client_count;
+  I2CBusStats_t stats[I2C_BUS_MAX_CLIENTS];
+  for (uint32_t i = 0U; i < count; i++) {
+    (void)I2CBus_GetStats((int32_t)i, &stats[i]);
+  }
+
+  printf("I2C bus: %lu clients\n", (unsigned long)count);
+  printf("Client     prio    xfers errors    bytes  bus ms  avg us  "
+         "wait ms  max wait us\n");
+  for (uint32_t i = 0U; i < count; i++) {
+    const I2CBusStats_t *s = &stats[i];
+    const uint32_t avg_us =
+        (s->transactions == 0U)
+            ? 0U
+            : (uint32_t)(s->bus_us / s->transactions);
+    printf("%-10s %-6s %6lu %6lu %8lu %7lu %7lu %8lu %12lu\n", s->name,
+           k_priority_names[s->priority], (unsigned long)s->transactions,
+           (unsigned long)s->errors, (unsigned long)s->bytes,
+           (unsigned long)(s->bus_us / 1000U), (unsigned long)avg_us,
+           (unsigned long)(s->wait_us / 1000U),
+           (unsigned long)s->max_wait_us);
+  }
+  for (uint32_t i = 0U; i < count; i++) {
+    const I2CBusStats_t *s = &stats[i];
+    printf("I2C_BUS {\"client\":\"%s\",\"priority\":\"%s\","
+           "\"transactions\":%lu,\"errors\":%lu,\"bytes\":%lu,"
+           "\"bus_ms\":%lu,\"wait_ms\":%lu,\"max_wait_us\":%lu}\n",
+           s->name, k_priority_names[s->priority],
+           (unsigned long)s->transactions, (unsigned long)s->errors,
+           (unsigned long)s->bytes, (unsigned long)(s->bus_us / 1000U),
+           (unsigned long)(s->wait_us / 1000U),
+           (unsigned long)s->max_wait_us);
+  }
+}
+
+/* HAL completion callbacks (interrupt context) ----------------------------*/
+static void transfer_finished(I2C_HandleTypeDef *hi2c, uint32_t flag) {
+  if (hi2c != s_hi2c || s_bus_thread == NULL) {
+    return;
+  }
+  s_xfer_end_cycles = CycleCounter_Get();
+  (void)osThreadFlagsSet(s_bus_thread, flag);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+  transfer_finished(hi2c, I2C_BUS_FLAG_XFER_DONE);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+  transfer_finished(hi2c, I2C_BUS_FLAG_XFER_DONE);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+  transfer_finished(hi2c, I2C_BUS_FLAG_XFER_ERROR);
+}
@@ -21,7 +21,9 @@
 #include "input_task.h"
 #include "FreeRTOS.h"
 #include "cmsis_os2.h"
+#include "ipc_profile.h"
 #include "main.h"
+#include "replay.h"
 #include "rotary_encoder.h"
 
 /* Button polling interval in milliseconds */
@@ -62,8 +64,10 @@ static void InputTask_PostEvent(const Input2VPEvent_t *event) {
          (unsigned long)event->timestamp);
 #endif
 
+  REPLAY_RECORD_INPUT(event);
+
   /* Post event to queue without timeout (non-blocking) */
-  (void)osMessageQueuePut(s_event_queue, event, 0U, 0U);
+  (void)IPC_QUEUE_PUT(s_event_queue, event, 0U, 0U);
 }
 
 void StartInputTask(void *argument) {
@@ -122,6 +126,12 @@ void StartInputTask(void *argument) {
       InputTask_PostEvent(&event);
     }
 
+    /* Events of a replayed trace that are due (host replay only) */
+    Input2VPEvent_t replayed;
+    while (REPLAY_NEXT_INPUT(&replayed)) {
+      InputTask_PostEvent(&replayed);
+    }
+
     /* Sleep until next polling cycle (25ms interval) */
     osDelay(pdMS_TO_TICKS(INPUT_BUTTON_POLL_DELAY_MS));
   }
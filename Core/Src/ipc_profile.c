@@ -0,0 +1,177 @@
+/**
+ ******************************************************************************
+ * @file           :  ipc_profile.c
+ * @brief          :  Contention profiler for model mutexes and event queues
+ *
+ * @details        :  Call-site records are linked into a list on first use
+ *                    under a short critical section; afterwards each call
+ *                    only updates its own record. Hold time is measured per
+ *                    mutex from the outermost acquire to the matching
+ *                    release (the LVGL mutex is recursive) and charged to the
+ *                    acquiring site. Compiled only with IPC_PROFILE_ENABLED.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "ipc_profile.h"
+
+#if IPC_PROFILE_ENABLED
+#include "FreeRTOS.h"
+#include "cycle_counter.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Holder of one mutex, only written by the task holding it */
+typedef struct {
+  osMutexId_t mutex;
+  IpcSite_t *owner;
+  uint32_t since;
+  uint32_t depth;
+} IpcMutexState_t;
+
+static IpcSite_t *s_sites = NULL;
+static IpcMutexState_t s_mutexes[IPC_PROFILE_MAX_MUTEXES];
+static uint32_t s_mutex_count = 0U;
+
+/* Saturating accumulation keeps long runs from wrapping the averages */
+static void add_sample(uint32_t *total, uint32_t *max, uint32_t value) {
+  *total = (*total > UINT32_MAX - value) ? UINT32_MAX : *total + value;
+  if (value > *max) {
+    *max = value;
+  }
+}
+
+static void register_site(IpcSite_t *site) {
+  const UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+  if (site->registered == 0U) {
+    site->next = s_sites;
+    s_sites = site;
+    site->registered = 1U;
+  }
+  taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+static IpcMutexState_t *mutex_state(osMutexId_t mutex) {
+  for (uint32_t i = 0U; i < s_mutex_count; i++) {
+    if (s_mutexes[i].mutex == mutex) {
+      return &s_mutexes[i];
+    }
+  }
+
+  IpcMutexState_t *state = NULL;
+  const UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+  for (uint32_t i = 0U; i < s_mutex_count && state == NULL; i++) {
+    if (s_mutexes[i].mutex == mutex) {
+      state = &s_mutexes[i];
+    }
+  }
+  if (state == NULL && s_mutex_count < IPC_PROFILE_MAX_MUTEXES) {
+    state = &s_mutexes[s_mutex_count];
+    state->mutex = mutex;
+    __atomic_store_n(&s_mutex_count, s_mutex_count + 1U, __ATOMIC_RELEASE);
+  }
+  taskEXIT_CRITICAL_FROM_ISR(mask);
+  return state;
+}
+
+osStatus_t IpcProfile_MutexAcquire(IpcSite_t *site, osMutexId_t mutex,
+                                   uint32_t timeout) {
+  if (site->registered == 0U) {
+    register_site(site);
+  }
+
+  const uint32_t start = CycleCounter_Get();
+  const osStatus_t status = TRACE_MUTEX_ACQUIRE(mutex, timeout);
+  const uint32_t now = CycleCounter_Get();
+
+  site->calls++;
+  add_sample(&site->wait_total, &site->wait_max, now - start);
+  if (status != osOK) {
+    site->failures++;
+    return status;
+  }
+
+  IpcMutexState_t *state = mutex_state(mutex);
+  if (state != NULL && state->depth++ == 0U) {
+    state->owner = site;
+    state->since = now;
+  }
+  return status;
+}
+
+osStatus_t IpcProfile_MutexRelease(osMutexId_t mutex) {
+  IpcMutexState_t *state = mutex_state(mutex);
+  if (state != NULL && state->depth > 0U && --state->depth == 0U &&
+      state->owner != NULL) {
+    IpcSite_t *owner = state->owner;
+    state->owner = NULL;
+    owner->holds++;
+    add_sample(&owner->hold_total, &owner->hold_max,
+               CycleCounter_Get() - state->since);
+  }
+  return osMutexRelease(mutex);
+}
+
+osStatus_t IpcProfile_QueuePut(IpcSite_t *site, osMessageQueueId_t queue,
+                               const void *msg, uint8_t prio,
+                               uint32_t timeout) {
+  if (site->registered == 0U) {
+    register_site(site);
+  }
+
+  const uint32_t start = CycleCounter_Get();
+  const osStatus_t status = osMessageQueuePut(queue, msg, prio, timeout);
+  const uint32_t waited = CycleCounter_Get() - start;
+
+  site->calls++;
+  add_sample(&site->wait_total, &site->wait_max, waited);
+  if (status != osOK) {
+    site->failures++;
+  } else if (queue != NULL) {
+    const uint32_t depth = osMessageQueueGetCount(queue);
+    if (depth > site->depth_max) {
+      site->depth_max = depth;
+    }
+    site->capacity = osMessageQueueGetCapacity(queue);
+  }
+  return status;
+}
+
+/* Average of a saturating total in microseconds */
+static unsigned long average_us(uint32_t total, uint32_t count) {
+  return (count == 0U) ? 0UL : (unsigned long)CycleCounter_ToUs(total / count);
+}
+
+void IpcProfile_Report(void) {
+  printf("IPC site                       calls  fail wait avg/max  "
+         "hold avg/max  depth\n");
+
+  for (const IpcSite_t *site = s_sites; site != NULL; site = site->next) {
+    const char *file = strrchr(site->file, '/');
+    char name[32];
+    snprintf(name, sizeof(name), "%s:%lu",
+             (file != NULL) ? file + 1 : site->file, (unsigned long)site->line);
+
+    printf("%-30s %6lu %5lu %5lu/%6lu ", name, (unsigned long)site->calls,
+           (unsigned long)site->failures,
+           average_us(site->wait_total, site->calls),
+           (unsigned long)CycleCounter_ToUs(site->wait_max));
+    if (site->kind == IPC_SITE_MUTEX) {
+      printf("%6lu/%5lu      -\n", average_us(site->hold_total, site->holds),
+             (unsigned long)CycleCounter_ToUs(site->hold_max));
+    } else {
+      printf("           -  %2lu/%lu\n", (unsigned long)site->depth_max,
+             (unsigned long)site->capacity);
+    }
+  }
+}
+
+#endif /* IPC_PROFILE_ENABLED */
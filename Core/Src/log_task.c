@@ -0,0 +1,242 @@
+/**
+ ******************************************************************************
+ * @file           :  log_task.c
+ * @brief          :  Deferred binary logging
+ *
+ * @details        :  Bounded multi-producer/single-consumer ring. Producers
+ *                    claim a slot with a compare-and-swap on the head index,
+ *                    fill it and publish it by storing the slot sequence
+ *                    number; the consumer only advances over published
+ *                    slots. No locks are taken, so DLOG() is usable from any
+ *                    priority and from ISRs. Compiled only with
+ *                    DEFERRED_LOG_ENABLED.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "log_task.h"
+
+#if DEFERRED_LOG_ENABLED
+#include "FreeRTOS.h"
+#include "cmsis_os2.h"
+#include "main.h"
+#include "task.h"
+
+#include <string.h>
+
+#if (LOG_TASK_QUEUE_LEN & (LOG_TASK_QUEUE_LEN - 1U)) != 0U
+#error "LOG_TASK_QUEUE_LEN must be a power of two"
+#endif
+
+#define LOG_TASK_QUEUE_MASK (LOG_TASK_QUEUE_LEN - 1U)
+#define LOG_TASK_LINE_LEN 128U
+#define LOG_TASK_SPEC_LEN 16U
+
+typedef struct {
+  uint32_t seq;  /* head index + 1 once the slot is published */
+  uint32_t tick; /* HAL tick at the call */
+  const char *fmt;
+  uint32_t nargs;
+  uintptr_t args[LOG_TASK_MAX_ARGS];
+} LogRecord_t;
+
+static LogRecord_t s_records[LOG_TASK_QUEUE_LEN];
+static uint32_t s_head = 0U;
+static uint32_t s_tail = 0U;
+static uint32_t s_dropped = 0U;
+static bool s_draining = false;
+
+bool LogTask_Write(const char *fmt, uint32_t nargs, const uintptr_t *args) {
+  uint32_t head = __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+
+  do {
+    if (head - __atomic_load_n(&s_tail, __ATOMIC_ACQUIRE) >=
+        LOG_TASK_QUEUE_LEN) {
+      __atomic_fetch_add(&s_dropped, 1U, __ATOMIC_RELAXED);
+      return false;
+    }
+  } while (!__atomic_compare_exchange_n(&s_head, &head, head + 1U, true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+  LogRecord_t *record = &s_records[head & LOG_TASK_QUEUE_MASK];
+  if (nargs > LOG_TASK_MAX_ARGS) {
+    nargs = LOG_TASK_MAX_ARGS;
+  }
+  record->tick = HAL_GetTick();
+  record->fmt = fmt;
+  record->nargs = nargs;
+  for (uint32_t i = 0U; i < nargs; i++) {
+    record->args[i] = args[i];
+  }
+  __atomic_store_n(&record->seq, head + 1U, __ATOMIC_RELEASE);
+  return true;
+}
+
+#if DEFERRED_LOG_BINARY
+/* "DL <tick> <fmt address> <arg>..." in hex, decoded by dlog_decode.py */
+static void output_record(const LogRecord_t *record) {
+  printf("DL %lx %lx", (unsigned long)record->tick,
+         (unsigned long)(uintptr_t)record->fmt);
+  for (uint32_t i = 0U; i < record->nargs; i++) {
+    printf(" %lx", (unsigned long)record->args[i]);
+  }
+  printf("\n");
+}
+#else
+/* Float stored by LogTask_ArgFloat */
+static double arg_to_double(uintptr_t arg) {
+  union {
+    uint32_t u;
+    float f;
+  } bits = {.u = (uint32_t)arg};
+  return (double)bits.f;
+}
+
+/* Format one conversion of the record's format string into out */
+static int format_conversion(char *out, size_t size, const char *spec,
+                             size_t spec_len, char conversion, uintptr_t arg) {
+  char buf[LOG_TASK_SPEC_LEN + 3U];
+
+  /* Drop length modifiers, the argument width is known from its kind */
+  size_t len = 0U;
+  for (size_t i = 0U; i + 1U < spec_len && len < LOG_TASK_SPEC_LEN; i++) {
+    if (strchr("hlLqjzt", spec[i]) == NULL) {
+      buf[len++] = spec[i];
+    }
+  }
+
+  switch (conversion) {
+  case 'd':
+  case 'i':
+    buf[len++] = 'l';
+    buf[len++] = conversion;
+    buf[len] = '\0';
+    return snprintf(out, size, buf, (long)(int32_t)(uint32_t)arg);
+  case 'u':
+  case 'x':
+  case 'X':
+  case 'o':
+    buf[len++] = 'l';
+    buf[len++] = conversion;
+    buf[len] = '\0';
+    return snprintf(out, size, buf, (unsigned long)(uint32_t)arg);
+  case 'c':
+    buf[len++] = 'c';
+    buf[len] = '\0';
+    return snprintf(out, size, buf, (int)arg);
+  case 'f':
+  case 'F':
+  case 'e':
+  case 'E':
+  case 'g':
+  case 'G':
+    buf[len++] = conversion;
+    buf[len] = '\0';
+    return snprintf(out, size, buf, arg_to_double(arg));
+  case 's':
+    buf[len++] = 's';
+    buf[len] = '\0';
+    return snprintf(out, size, buf, (const char *)arg);
+  case 'p':
+    buf[len++] = 'p';
+    buf[len] = '\0';
+    return snprintf(out, size, buf, (void *)arg);
+  default:
+    return 0;
+  }
+}
+
+/* Rebuild the printf output from the format string and argument words */
+static void output_record(const LogRecord_t *record) {
+  char line[LOG_TASK_LINE_LEN];
+  size_t pos = 0U;
+  uint32_t next_arg = 0U;
+  const char *p = record->fmt;
+
+  while (*p != '\0' && pos + 1U < sizeof(line)) {
+    if (*p != '%') {
+      line[pos++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      line[pos++] = '%';
+      p += 2;
+      continue;
+    }
+
+    /* Find the end of the conversion specification */
+    const char *start = p++;
+    while (*p != '\0' && strchr("diouxXeEfFgGcsp", *p) == NULL) {
+      p++;
+    }
+    if (*p == '\0') {
+      break;
+    }
+    const char conversion = *p++;
+    const uintptr_t arg =
+        (next_arg < record->nargs) ? record->args[next_arg] : 0U;
+    next_arg++;
+
+    const int written =
+        format_conversion(&line[pos], sizeof(line) - pos, start,
+                          (size_t)(p - start), conversion, arg);
+    if (written > 0) {
+      pos += (size_t)written;
+      if (pos >= sizeof(line)) {
+        pos = sizeof(line) - 1U;
+      }
+    }
+  }
+  line[pos] = '\0';
+  printf("%s", line);
+}
+#endif /* DEFERRED_LOG_BINARY */
+
+void LogTask_Flush(void) {
+  if (__atomic_test_and_set(&s_draining, __ATOMIC_ACQUIRE)) {
+    return;
+  }
+
+  const uint32_t dropped =
+      __atomic_exchange_n(&s_dropped, 0U, __ATOMIC_RELAXED);
+  if (dropped != 0U) {
+    printf("LogTask: %lu messages dropped\n", (unsigned long)dropped);
+  }
+
+  uint32_t tail = __atomic_load_n(&s_tail, __ATOMIC_RELAXED);
+  for (;;) {
+    const LogRecord_t *slot = &s_records[tail & LOG_TASK_QUEUE_MASK];
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != tail + 1U) {
+      break; /* empty, or the next slot is still being written */
+    }
+
+    /* Copy out so the slot can be reused while the message is printed */
+    const LogRecord_t record = *slot;
+    tail++;
+    __atomic_store_n(&s_tail, tail, __ATOMIC_RELEASE);
+    output_record(&record);
+  }
+
+  __atomic_clear(&s_draining, __ATOMIC_RELEASE);
+}
+
+void StartLogTask(void *argument) {
+  (void)argument;
+#if OS_TASKS_DEBUG
+  printf("LogTask running (heap=%lu)\n",
+         (unsigned long)xPortGetFreeHeapSize());
+#endif
+
+  for (;;) {
+    LogTask_Flush();
+    osDelay(pdMS_TO_TICKS(LOG_TASK_PERIOD_MS));
+  }
+}
+
+#endif /* DEFERRED_LOG_ENABLED */
@@ -23,14 +23,24 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "benchmarks.h"
+#include "energy.h"
+#include "i2c_bus.h"
 #include "input_task.h"
+#include "ipc_profile.h"
+#include "log_task.h"
 #include "lvgl_port_display.h"
 #include "maintenance_task.h"
+#include "mem_heap.h"
+#include "replay.h"
 #include "motor.h"
 #include "sensor_task.h"
 #include "storage_task.h"
 #include "system_task.h"
+#include "task_stats.h"
+#include "trace.h"
 #include "view_presenter_task.h"
+#include "window_detect.h"
 
 /* USER CODE END Includes */
 
@@ -56,6 +66,8 @@ ADC_HandleTypeDef hadc1;
 DMA_HandleTypeDef hdma_adc1;
 
 I2C_HandleTypeDef hi2c1;
+DMA_HandleTypeDef hdma_i2c1_rx;
+DMA_HandleTypeDef hdma_i2c1_tx;
 
 RTC_HandleTypeDef hrtc;
 
@@ -90,6 +102,13 @@ const osThreadAttr_t sensorTask_attributes = {
     .priority = (osPriority_t)osPriorityHigh3,
     .stack_size = SENSOR_TASK_STACK_SIZE};
 
+/* Definitions for I2CBusTask */
+osThreadId_t i2cBusTaskHandle;
+const osThreadAttr_t i2cBusTask_attributes = {
+    .name = "i2cBusTask",
+    .priority = (osPriority_t)osPriorityHigh4,
+    .stack_size = I2C_BUS_TASK_STACK_SIZE};
+
 /* Definitions for StorageTask */
 osThreadId_t storageTaskHandle;
 const osThreadAttr_t storageTask_attributes = {
@@ -97,6 +116,15 @@ const osThreadAttr_t storageTask_attributes = {
     .priority = (osPriority_t)osPriorityLow,
     .stack_size = STORAGE_TASK_STACK_SIZE};
 
+#if DEFERRED_LOG_ENABLED
+/* Definitions for LogTask */
+osThreadId_t logTaskHandle;
+const osThreadAttr_t logTask_attributes = {
+    .name = "logTask",
+    .priority = (osPriority_t)osPriorityLow,
+    .stack_size = LOG_TASK_STACK_SIZE};
+#endif
+
 /* Storage event queue */
 osMessageQueueId_t storage2SystemEventQueueHandle;
 
@@ -235,8 +263,12 @@ int main(void)
   MX_ADC1_Init();
   MX_RTC_Init();
   /* USER CODE BEGIN 2 */
+  I2CBus_Init(&hi2c1);
   display_system_init();
   Motor_Init();
+#if REPLAY_RECORD_ENABLED
+  Replay_StartRecording();
+#endif
   /* Initializations moved to according tasks to avoid issues before scheduler
    * starts */
   /* USER CODE END 2 */
@@ -263,12 +295,16 @@ int main(void)
   /* Create sensor values access structure with mutex */
   static SensorModel_t sensorModel = {
       .mutex = NULL,
-      .data = {.ambient_temperature = 0.0f,
+      .data = {.ambient_temperature_cdeg = 0,
+               .ambient_temperature_raw_cdeg = 0,
+               .temperature_slope_cdeg_min = WINDOW_DETECT_NO_SLOPE,
+               .temperature_valid = false,
                .soc = 0,
+               .battery_days = 0,
 #if DRIVER_TEST
-               .battery_voltage = 0.0f,
+               .battery_mv = 0,
 #endif
-               .motor_current = 0.0f}};
+               .motor_current_ma = 0}};
   const osMutexAttr_t sensorValuesMutexAttr = {
       .name = "SensorValuesMutex",
       .attr_bits = osMutexPrioInherit,
@@ -286,6 +322,7 @@ int main(void)
       .data = {.state = STATE_INIT,
                .mode = MODE_AUTO,
                .mode_before_boost = MODE_AUTO,
+               .mode_before_window = MODE_AUTO,
                .boost_begin_time = 0,
                .adapt_result = -1}};
 
@@ -300,6 +337,19 @@ int main(void)
   }
   systemTaskArgs.system_model = &systemModel;
   viewPresenterTaskArgs.system_model = &systemModel;
+
+  /* Temperature history; the rings are initialised by the system task */
+  static HistoryModel_t historyModel = {.mutex = NULL};
+  const osMutexAttr_t historyMutexAttr = {
+      .name = "HistoryMutex",
+      .attr_bits = osMutexPrioInherit,
+  };
+  historyModel.mutex = osMutexNew(&historyMutexAttr);
+  if (historyModel.mutex == NULL) {
+    Error_Handler();
+  }
+  systemTaskArgs.history_model = &historyModel;
+  viewPresenterTaskArgs.history_model = &historyModel;
 #endif
 
   /* USER CODE END RTOS_MUTEX */
@@ -360,6 +410,7 @@ int main(void)
   viewPresenterTaskArgs.config_model = &configModel;
   viewPresenterTaskArgs.sensor_model = &sensorModel;
   systemTaskArgs.config_model = &configModel;
+  systemTaskArgs.sensor_model = &sensorModel;
 
   /* Create System <-> Maint queues */
   system2MaintEventQueueHandle =
@@ -388,12 +439,17 @@ int main(void)
 
   /* USER CODE BEGIN RTOS_THREADS */
   lvglTaskHandle = osThreadNew(StartLVGLTask, NULL, &lvglTask_attributes);
+  i2cBusTaskHandle =
+      osThreadNew(StartI2CBusTask, NULL, &i2cBusTask_attributes);
   sensorTaskHandle = osThreadNew(StartSensorTask, (void *)&sensorTaskArgs,
                                  &sensorTask_attributes);
   storageTaskHandle = osThreadNew(StartStorageTask, (void *)&storageTaskArgs,
                                   &storageTask_attributes);
   inputTaskHandle = osThreadNew(StartInputTask, (void *)&inputTaskArgs,
                                 &inputTask_attributes);
+#if DEFERRED_LOG_ENABLED
+  logTaskHandle = osThreadNew(StartLogTask, NULL, &logTask_attributes);
+#endif
 #if !TESTS
   viewPresenterTaskHandle =
       osThreadNew(StartViewPresenterTask, (void *)&viewPresenterTaskArgs,
@@ -435,8 +491,12 @@ int main(void)
 #if OS_TASKS_DEBUG
   DebugReportTaskCreation("lvglTask", lvglTaskHandle);
   DebugReportTaskCreation("lvglTask", lvglTaskHandle);
+  DebugReportTaskCreation("i2cBusTask", i2cBusTaskHandle);
   DebugReportTaskCreation("sensorTask", sensorTaskHandle);
   DebugReportTaskCreation("inputTask", inputTaskHandle);
+#if DEFERRED_LOG_ENABLED
+  DebugReportTaskCreation("logTask", logTaskHandle);
+#endif
 #if !TESTS
   DebugReportTaskCreation("viewPresenterTask", viewPresenterTaskHandle);
   DebugReportTaskCreation("systemTask", systemTaskHandle);
@@ -568,7 +628,7 @@ static void MX_ADC1_Init(void)
   hadc1.Init.ScanConvMode = ADC_SCAN_ENABLE;
   hadc1.Init.EOCSelection = ADC_EOC_SEQ_CONV;
   hadc1.Init.LowPowerAutoWait = ENABLE;
-  hadc1.Init.ContinuousConvMode = ENABLE;
+  hadc1.Init.ContinuousConvMode = DISABLE;
   hadc1.Init.NbrOfConversion = 4;
   hadc1.Init.DiscontinuousConvMode = DISABLE;
   hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
@@ -781,6 +841,12 @@ static void MX_DMA_Init(void)
   /* DMA1_Channel1_IRQn interrupt configuration */
   HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 5, 0);
   HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+  /* DMA1_Channel2_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+  /* DMA1_Channel3_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
 
 }
 
@@ -897,11 +963,19 @@ void StartDefaultTask(void *argument)
   (void)argument; /* Unused */
 #endif
 
+  /* All tasks exist once the scheduler runs this task */
+  TRACE_START();
+
 #if OS_TASKS_DEBUG
   printf("DefaultTask running (heap=%lu)\n",
          (unsigned long)xPortGetFreeHeapSize());
 #endif
 
+#if BENCHMARKS_ENABLED
+  Benchmarks_Run();
+  (void)Benchmarks_Check();
+#endif
+
 #if TESTS
 #if DRIVER_TEST
   Driver_Test(args->storage2system_event_queue, args->input2vp_event_queue,
@@ -911,7 +985,27 @@ void StartDefaultTask(void *argument)
 #endif
 #else
   for (;;) {
+#if OS_TASKS_RUNTIME_STATS
+    osDelay(pdMS_TO_TICKS(OS_TASKS_RUNTIME_STATS_PERIOD_MS));
+    TaskStats_Report();
+#else
     osDelay(pdMS_TO_TICKS(60000U));
+#endif
+#if IPC_PROFILE_ENABLED
+    IpcProfile_Report();
+#endif
+#if MEM_HEAP_REPORT
+    MemHeap_Report();
+#endif
+#if ENERGY_REPORT
+    Energy_Report();
+#endif
+#if REPLAY_RECORD_ENABLED
+    Replay_Dump();
+#endif
+#if OS_TRACE_ENABLED && OS_TRACE_UART_DUMP
+    Trace_Dump();
+#endif
   }
 #endif
   /* USER CODE END 5 */
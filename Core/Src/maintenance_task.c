@@ -19,6 +19,7 @@
 #include "maintenance_task.h"
 #include "FreeRTOS.h"
 #include "cmsis_os2.h"
+#include "ipc_profile.h"
 #include "main.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -52,7 +53,7 @@ void StartMaintenanceTask(void *argument) {
         
         /* Report result back to system task */
         if (m2s_q != NULL) {
-          osMessageQueuePut(m2s_q, &m2s, 0, 0);
+          IPC_QUEUE_PUT(m2s_q, &m2s, 0, 0);
         }
       }
     }
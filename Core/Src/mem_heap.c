@@ -0,0 +1,577 @@
+/**
+ ******************************************************************************
+ * @file           :  mem_heap.c
+ * @brief          :  Unified TLSF heap for FreeRTOS, LVGL and the application
+ *
+ * @details        :  Two-level segregated fit: free blocks are kept in
+ *                    FL x SL lists, where the first level is the power of two
+ *                    of the block size and the second level splits each power
+ *                    of two into 16 ranges (blocks below 128 bytes share the
+ *                    first level in 8-byte steps). Two bitmaps locate a
+ *                    non-empty list with a single find-first-set, so
+ *                    allocation and free take constant time. Every block
+ *                    starts with {previous physical block, size | flags |
+ *                    owner}; free blocks keep their list links in the
+ *                    payload. Neighbouring free blocks are merged on free.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "mem_heap.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef MIRATHERM_HOST
+#include <errno.h>
+#include <reent.h>
+#endif
+
+/* Size classes */
+#define MEM_ALIGN_LOG2 3U
+#define MEM_ALIGN (1U << MEM_ALIGN_LOG2)
+#define MEM_SL_LOG2 4U
+#define MEM_SL_COUNT (1U << MEM_SL_LOG2)
+#define MEM_FL_SHIFT (MEM_SL_LOG2 + MEM_ALIGN_LOG2)
+#ifdef MIRATHERM_HOST
+#define MEM_FL_MAX 21U /* blocks below 2 MB */
+#else
+#define MEM_FL_MAX 17U /* blocks below 128 KB */
+#endif
+#define MEM_FL_COUNT (MEM_FL_MAX - MEM_FL_SHIFT + 1U)
+#define MEM_SMALL_BLOCK (1U << MEM_FL_SHIFT)
+
+/* Size field: payload size (multiple of 8), flags and owner */
+#define MEM_BLOCK_FREE 0x1U
+#define MEM_BLOCK_PREV_FREE 0x2U
+#define MEM_OWNER_SHIFT 28U
+#define MEM_OWNER_MASK (0x3U << MEM_OWNER_SHIFT)
+#define MEM_SIZE_MASK (~(MEM_OWNER_MASK | (MEM_ALIGN - 1U)))
+
+#if MEM_HEAP_SIZE >= (1U << MEM_FL_MAX)
+#error "MEM_HEAP_SIZE exceeds the largest TLSF size class"
+#endif
+
+typedef struct MemBlock {
+  struct MemBlock *prev_phys; /* physically previous block */
+  uint32_t size;              /* payload size | flags | owner */
+#if UINTPTR_MAX > 0xFFFFFFFFU
+  uint32_t pad;               /* keep the payload 8-byte aligned */
+#endif
+} MemBlock_t;
+
+/* Free list links, stored in the payload of free blocks */
+typedef struct {
+  MemBlock_t *next;
+  MemBlock_t *prev;
+} MemLinks_t;
+
+#define MEM_HDR ((uint32_t)sizeof(MemBlock_t))
+#define MEM_MIN_PAYLOAD                                                        \
+  (((uint32_t)sizeof(MemLinks_t) + MEM_ALIGN - 1U) & ~(MEM_ALIGN - 1U))
+#define MEM_USABLE (MEM_HEAP_SIZE - MEM_HDR)
+
+typedef struct {
+  const char *name;
+  uint32_t peak;
+  uint32_t owner_peak[MEM_OWNER_COUNT];
+} MemRoute_t;
+
+static uint8_t s_pool[MEM_HEAP_SIZE] __attribute__((aligned(MEM_ALIGN)));
+static bool s_initialized = false;
+
+static uint32_t s_fl_bitmap;
+static uint32_t s_sl_bitmap[MEM_FL_COUNT];
+static MemBlock_t *s_free_lists[MEM_FL_COUNT][MEM_SL_COUNT];
+
+static uint32_t s_used = 0U;
+static uint32_t s_min_free = MEM_USABLE;
+static MemOwnerStats_t s_owners[MEM_OWNER_COUNT];
+static MemRoute_t s_routes[MEM_HEAP_MAX_ROUTES];
+static uint32_t s_route = MEM_HEAP_MAX_ROUTES;
+
+/* Block helpers ------------------------------------------------------------*/
+static inline uint32_t block_size(const MemBlock_t *block) {
+  return block->size & MEM_SIZE_MASK;
+}
+
+static inline MemBlock_t *block_next(const MemBlock_t *block) {
+  return (MemBlock_t *)((uint8_t *)block + MEM_HDR + block_size(block));
+}
+
+static inline MemLinks_t *block_links(MemBlock_t *block) {
+  return (MemLinks_t *)((uint8_t *)block + MEM_HDR);
+}
+
+static inline MemOwner_t block_owner(const MemBlock_t *block) {
+  return (MemOwner_t)((block->size & MEM_OWNER_MASK) >> MEM_OWNER_SHIFT);
+}
+
+static inline MemBlock_t *block_from_ptr(void *ptr) {
+  return (MemBlock_t *)((uint8_t *)ptr - MEM_HDR);
+}
+
+static inline uint32_t fls32(uint32_t value) {
+  return 31U - (uint32_t)__builtin_clz(value);
+}
+
+static inline uint32_t ffs32(uint32_t value) {
+  return (uint32_t)__builtin_ctz(value);
+}
+
+/* Free lists ---------------------------------------------------------------*/
+static void mapping_insert(uint32_t size, uint32_t *fl, uint32_t *sl) {
+  if (size < MEM_SMALL_BLOCK) {
+    *fl = 0U;
+    *sl = size / (MEM_SMALL_BLOCK / MEM_SL_COUNT);
+  } else {
+    const uint32_t log2 = fls32(size);
+    *sl = (size >> (log2 - MEM_SL_LOG2)) ^ MEM_SL_COUNT;
+    *fl = log2 - (MEM_FL_SHIFT - 1U);
+  }
+}
+
+/* Round up to the next list start so any block found is large enough */
+static void mapping_search(uint32_t size, uint32_t *fl, uint32_t *sl) {
+  if (size >= MEM_SMALL_BLOCK) {
+    size += (1U << (fls32(size) - MEM_SL_LOG2)) - 1U;
+  }
+  mapping_insert(size, fl, sl);
+}
+
+static MemBlock_t *find_suitable(uint32_t *fl, uint32_t *sl) {
+  uint32_t sl_map = s_sl_bitmap[*fl] & (~0U << *sl);
+  if (sl_map == 0U) {
+    const uint32_t fl_map = s_fl_bitmap & (~0U << (*fl + 1U));
+    if (fl_map == 0U) {
+      return NULL;
+    }
+    *fl = ffs32(fl_map);
+    sl_map = s_sl_bitmap[*fl];
+  }
+  *sl = ffs32(sl_map);
+  return s_free_lists[*fl][*sl];
+}
+
+static void remove_free(MemBlock_t *block) {
+  uint32_t fl, sl;
+  mapping_insert(block_size(block), &fl, &sl);
+
+  MemLinks_t *links = block_links(block);
+  if (links->next != NULL) {
+    block_links(links->next)->prev = links->prev;
+  }
+  if (links->prev != NULL) {
+    block_links(links->prev)->next = links->next;
+  } else {
+    s_free_lists[fl][sl] = links->next;
+    if (links->next == NULL) {
+      s_sl_bitmap[fl] &= ~(1U << sl);
+      if (s_sl_bitmap[fl] == 0U) {
+        s_fl_bitmap &= ~(1U << fl);
+      }
+    }
+  }
+}
+
+static void insert_free(MemBlock_t *block) {
+  uint32_t fl, sl;
+  mapping_insert(block_size(block), &fl, &sl);
+
+  MemLinks_t *links = block_links(block);
+  links->prev = NULL;
+  links->next = s_free_lists[fl][sl];
+  if (links->next != NULL) {
+    block_links(links->next)->prev = block;
+  }
+  s_free_lists[fl][sl] = block;
+  s_sl_bitmap[fl] |= 1U << sl;
+  s_fl_bitmap |= 1U << fl;
+}
+
+/* Trim a block to size, returning the tail to the free lists */
+static void split_block(MemBlock_t *block, uint32_t size) {
+  const uint32_t available = block_size(block);
+
+  if (available >= size + MEM_HDR + MEM_MIN_PAYLOAD) {
+    MemBlock_t *rest = (MemBlock_t *)((uint8_t *)block + MEM_HDR + size);
+    rest->prev_phys = block;
+    rest->size = (available - size - MEM_HDR) | MEM_BLOCK_FREE;
+    block->size = (block->size & ~MEM_SIZE_MASK) | size;
+
+    MemBlock_t *next = block_next(rest);
+    next->prev_phys = rest;
+    next->size |= MEM_BLOCK_PREV_FREE;
+    insert_free(rest);
+  } else {
+    block_next(block)->size &= ~MEM_BLOCK_PREV_FREE;
+  }
+}
+
+static void heap_init(void) {
+  MemBlock_t *first = (MemBlock_t *)s_pool;
+  first->prev_phys = NULL;
+  first->size = (MEM_HEAP_SIZE - 2U * MEM_HDR) | MEM_BLOCK_FREE;
+
+  /* Zero-size used sentinel stops merging at the end of the pool */
+  MemBlock_t *sentinel = block_next(first);
+  sentinel->prev_phys = first;
+  sentinel->size = MEM_BLOCK_PREV_FREE;
+
+  insert_free(first);
+  s_initialized = true;
+}
+
+/* Accounting ---------------------------------------------------------------*/
+static void update_route_peaks(void) {
+  if (s_route >= MEM_HEAP_MAX_ROUTES) {
+    return;
+  }
+  MemRoute_t *route = &s_routes[s_route];
+  if (s_used > route->peak) {
+    route->peak = s_used;
+  }
+  for (uint32_t i = 0U; i < MEM_OWNER_COUNT; i++) {
+    if (s_owners[i].current > route->owner_peak[i]) {
+      route->owner_peak[i] = s_owners[i].current;
+    }
+  }
+}
+
+static void charge(MemOwner_t owner, uint32_t bytes) {
+  MemOwnerStats_t *stats = &s_owners[owner];
+  stats->current += bytes;
+  if (stats->current > stats->peak) {
+    stats->peak = stats->current;
+  }
+  s_used += bytes;
+  if (MEM_USABLE - s_used < s_min_free) {
+    s_min_free = MEM_USABLE - s_used;
+  }
+  update_route_peaks();
+}
+
+static void release(MemOwner_t owner, uint32_t bytes) {
+  s_owners[owner].current -= bytes;
+  s_used -= bytes;
+}
+
+static uint32_t adjust_size(size_t size) {
+  if (size == 0U || size > MEM_USABLE) {
+    return 0U;
+  }
+  uint32_t adjusted = ((uint32_t)size + MEM_ALIGN - 1U) & ~(MEM_ALIGN - 1U);
+  return (adjusted < MEM_MIN_PAYLOAD) ? MEM_MIN_PAYLOAD : adjusted;
+}
+
+/* Public API ---------------------------------------------------------------*/
+void *MemHeap_Alloc(size_t size, MemOwner_t owner) {
+  const uint32_t adjusted = adjust_size(size);
+  MemBlock_t *block = NULL;
+
+  vTaskSuspendAll();
+  if (!s_initialized) {
+    heap_init();
+  }
+
+  if (adjusted != 0U) {
+    uint32_t fl, sl;
+    mapping_search(adjusted, &fl, &sl);
+    if (fl < MEM_FL_COUNT) {
+      block = find_suitable(&fl, &sl);
+    }
+  }
+
+  if (block != NULL) {
+    remove_free(block);
+    split_block(block, adjusted);
+    block->size = (block->size & ~(MEM_BLOCK_FREE | MEM_OWNER_MASK)) |
+                  ((uint32_t)owner << MEM_OWNER_SHIFT);
+    s_owners[owner].allocs++;
+    charge(owner, block_size(block) + MEM_HDR);
+  } else {
+    s_owners[owner].failures++;
+  }
+  (void)xTaskResumeAll();
+
+  return (block != NULL) ? (uint8_t *)block + MEM_HDR : NULL;
+}
+
+void MemHeap_Free(void *ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+
+  vTaskSuspendAll();
+  MemBlock_t *block = block_from_ptr(ptr);
+  const MemOwner_t owner = block_owner(block);
+  s_owners[owner].frees++;
+  release(owner, block_size(block) + MEM_HDR);
+
+  block->size = (block->size & ~MEM_OWNER_MASK) | MEM_BLOCK_FREE;
+  MemBlock_t *next = block_next(block);
+
+  if ((block->size & MEM_BLOCK_PREV_FREE) != 0U) {
+    MemBlock_t *prev = block->prev_phys;
+    remove_free(prev);
+    prev->size += MEM_HDR + block_size(block);
+    block = prev;
+    next->prev_phys = block;
+  }
+  if ((next->size & MEM_BLOCK_FREE) != 0U) {
+    remove_free(next);
+    block->size += MEM_HDR + block_size(next);
+    next = block_next(block);
+    next->prev_phys = block;
+  }
+  next->size |= MEM_BLOCK_PREV_FREE;
+  insert_free(block);
+  (void)xTaskResumeAll();
+}
+
+void *MemHeap_Realloc(void *ptr, size_t size, MemOwner_t owner) {
+  if (ptr == NULL) {
+    return MemHeap_Alloc(size, owner);
+  }
+  if (size == 0U) {
+    MemHeap_Free(ptr);
+    return NULL;
+  }
+
+  const uint32_t adjusted = adjust_size(size);
+  if (adjusted == 0U) {
+    return NULL;
+  }
+
+  MemBlock_t *block = block_from_ptr(ptr);
+  bool done = false;
+
+  vTaskSuspendAll();
+  const uint32_t current = block_size(block);
+  const MemOwner_t block_owner_id = block_owner(block);
+  if (adjusted <= current) {
+    done = true; /* shrinking keeps the block as is */
+  } else {
+    /* Grow into the following free block if it is large enough */
+    MemBlock_t *next = block_next(block);
+    if ((next->size & MEM_BLOCK_FREE) != 0U &&
+        current + MEM_HDR + block_size(next) >= adjusted) {
+      remove_free(next);
+      block->size += MEM_HDR + block_size(next);
+      block_next(block)->prev_phys = block;
+      split_block(block, adjusted);
+      charge(block_owner_id, block_size(block) - current);
+      done = true;
+    }
+  }
+  (void)xTaskResumeAll();
+
+  if (done) {
+    return ptr;
+  }
+
+  void *moved = MemHeap_Alloc(size, block_owner_id);
+  if (moved != NULL) {
+    memcpy(moved, ptr, current);
+    MemHeap_Free(ptr);
+  }
+  return moved;
+}
+
+void MemHeap_GetStats(MemHeapStats_t *stats) {
+  memset(stats, 0, sizeof(*stats));
+
+  vTaskSuspendAll();
+  if (!s_initialized) {
+    heap_init();
+  }
+  stats->total = MEM_USABLE;
+  stats->free = MEM_USABLE - s_used;
+  stats->min_free = s_min_free;
+
+  /* Sizes of the largest and smallest lists bound the extremes; walk only
+     those two lists for the exact values */
+  if (s_fl_bitmap != 0U) {
+    const uint32_t fl_max = fls32(s_fl_bitmap);
+    for (MemBlock_t *b = s_free_lists[fl_max][fls32(s_sl_bitmap[fl_max])];
+         b != NULL; b = block_links(b)->next) {
+      if (block_size(b) > stats->largest_free) {
+        stats->largest_free = block_size(b);
+      }
+    }
+    const uint32_t fl_min = ffs32(s_fl_bitmap);
+    stats->smallest_free = UINT32_MAX;
+    for (MemBlock_t *b = s_free_lists[fl_min][ffs32(s_sl_bitmap[fl_min])];
+         b != NULL; b = block_links(b)->next) {
+      if (block_size(b) < stats->smallest_free) {
+        stats->smallest_free = block_size(b);
+      }
+    }
+    for (uint32_t fl = 0U; fl < MEM_FL_COUNT; fl++) {
+      for (uint32_t sl = 0U; sl < MEM_SL_COUNT; sl++) {
+        for (MemBlock_t *b = s_free_lists[fl][sl]; b != NULL;
+             b = block_links(b)->next) {
+          stats->free_blocks++;
+        }
+      }
+    }
+  }
+  (void)xTaskResumeAll();
+
+  /* A single free block (header included) is 0 % fragmented */
+  if (stats->free > 0U && stats->free_blocks > 0U) {
+    const uint64_t largest = (uint64_t)stats->largest_free + MEM_HDR;
+    stats->fragmentation_pct = 100U - (uint32_t)((largest * 100U) / stats->free);
+  }
+}
+
+void MemHeap_GetOwnerStats(MemOwner_t owner, MemOwnerStats_t *stats) {
+  vTaskSuspendAll();
+  *stats = s_owners[owner];
+  (void)xTaskResumeAll();
+}
+
+void MemHeap_SetRoute(uint32_t route, const char *name) {
+  vTaskSuspendAll();
+  s_route = route;
+  if (route < MEM_HEAP_MAX_ROUTES) {
+    s_routes[route].name = name;
+    update_route_peaks();
+  }
+  (void)xTaskResumeAll();
+}
+
+void MemHeap_Report(void) {
+  static const char *const owner_names[MEM_OWNER_COUNT] = {"rtos", "lvgl",
+                                                           "app"};
+  MemHeapStats_t heap;
+  MemOwnerStats_t owners[MEM_OWNER_COUNT];
+  MemRoute_t routes[MEM_HEAP_MAX_ROUTES];
+
+  MemHeap_GetStats(&heap);
+  vTaskSuspendAll();
+  memcpy(owners, s_owners, sizeof(owners));
+  memcpy(routes, s_routes, sizeof(routes));
+  (void)xTaskResumeAll();
+
+  printf("Heap: %lu total, %lu free (min %lu), largest %lu, %lu blocks, "
+         "frag %lu%%\n",
+         (unsigned long)heap.total, (unsigned long)heap.free,
+         (unsigned long)heap.min_free, (unsigned long)heap.largest_free,
+         (unsigned long)heap.free_blocks,
+         (unsigned long)heap.fragmentation_pct);
+
+  printf("Owner       current     peak  allocs   frees  fail\n");
+  for (uint32_t i = 0U; i < MEM_OWNER_COUNT; i++) {
+    printf("%-10s %8lu %8lu %7lu %7lu %5lu\n", owner_names[i],
+           (unsigned long)owners[i].current, (unsigned long)owners[i].peak,
+           (unsigned long)owners[i].allocs, (unsigned long)owners[i].frees,
+           (unsigned long)owners[i].failures);
+  }
+
+  printf("Route            peak     rtos     lvgl      app\n");
+  for (uint32_t i = 0U; i < MEM_HEAP_MAX_ROUTES; i++) {
+    if (routes[i].name == NULL) {
+      continue;
+    }
+    printf("%-14s %6lu %8lu %8lu %8lu\n", routes[i].name,
+           (unsigned long)routes[i].peak,
+           (unsigned long)routes[i].owner_peak[MEM_OWNER_RTOS],
+           (unsigned long)routes[i].owner_peak[MEM_OWNER_LVGL],
+           (unsigned long)routes[i].owner_peak[MEM_OWNER_APP]);
+  }
+}
+
+/* FreeRTOS port allocator (replaces heap_4.c) ------------------------------*/
+void *pvPortMalloc(size_t xWantedSize) {
+  void *block = MemHeap_Alloc(xWantedSize, MEM_OWNER_RTOS);
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+  if (block == NULL) {
+    extern void vApplicationMallocFailedHook(void);
+    vApplicationMallocFailedHook();
+  }
+#endif
+  return block;
+}
+
+void vPortFree(void *pv) { MemHeap_Free(pv); }
+
+size_t xPortGetFreeHeapSize(void) {
+  vTaskSuspendAll();
+  const size_t free_bytes = MEM_USABLE - s_used;
+  (void)xTaskResumeAll();
+  return free_bytes;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void) { return s_min_free; }
+
+void vPortGetHeapStats(HeapStats_t *pxHeapStats) {
+  MemHeapStats_t heap;
+  MemOwnerStats_t rtos;
+
+  MemHeap_GetStats(&heap);
+  MemHeap_GetOwnerStats(MEM_OWNER_RTOS, &rtos);
+  pxHeapStats->xAvailableHeapSpaceInBytes = heap.free;
+  pxHeapStats->xSizeOfLargestFreeBlockInBytes = heap.largest_free;
+  pxHeapStats->xSizeOfSmallestFreeBlockInBytes = heap.smallest_free;
+  pxHeapStats->xNumberOfFreeBlocks = heap.free_blocks;
+  pxHeapStats->xMinimumEverFreeBytesRemaining = heap.min_free;
+  pxHeapStats->xNumberOfSuccessfulAllocations = rtos.allocs;
+  pxHeapStats->xNumberOfSuccessfulFrees = rtos.frees;
+}
+
+#ifndef MIRATHERM_HOST
+/* newlib allocator (replaces the sbrk-based malloc) ------------------------*/
+void *_malloc_r(struct _reent *reent, size_t size) {
+  void *ptr = MemHeap_Alloc(size, MEM_OWNER_APP);
+  if (ptr == NULL && size != 0U) {
+    reent->_errno = ENOMEM;
+  }
+  return ptr;
+}
+
+void _free_r(struct _reent *reent, void *ptr) {
+  (void)reent;
+  MemHeap_Free(ptr);
+}
+
+void *_realloc_r(struct _reent *reent, void *ptr, size_t size) {
+  void *moved = MemHeap_Realloc(ptr, size, MEM_OWNER_APP);
+  if (moved == NULL && size != 0U) {
+    reent->_errno = ENOMEM;
+  }
+  return moved;
+}
+
+void *_calloc_r(struct _reent *reent, size_t count, size_t size) {
+  if (size != 0U && count > SIZE_MAX / size) {
+    reent->_errno = ENOMEM;
+    return NULL;
+  }
+  void *ptr = _malloc_r(reent, count * size);
+  if (ptr != NULL) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+
+void *malloc(size_t size) { return _malloc_r(_REENT, size); }
+
+void free(void *ptr) { _free_r(_REENT, ptr); }
+
+void *realloc(void *ptr, size_t size) { return _realloc_r(_REENT, ptr, size); }
+
+void *calloc(size_t count, size_t size) {
+  return _calloc_r(_REENT, count, size);
+}
+#endif /* MIRATHERM_HOST */
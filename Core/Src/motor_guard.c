@@ -0,0 +1,98 @@
+/**
+ ******************************************************************************
+ * @file           :  motor_guard.c
+ * @brief          :  Motor overcurrent and stall cut-off
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "motor_guard.h"
+
+#include <stddef.h>
+
+static const MotorGuardConfig_t s_default_config = {
+    .stall_ma = MOTOR_GUARD_STALL_MA,
+    .limit_ma = MOTOR_GUARD_LIMIT_MA,
+    .debounce_us = MOTOR_GUARD_DEBOUNCE_US,
+    .blanking_us = MOTOR_GUARD_BLANKING_US,
+};
+
+static uint32_t add_saturating(uint32_t value, uint32_t add) {
+  return (value > UINT32_MAX - add) ? UINT32_MAX : value + add;
+}
+
+void MotorGuard_Init(MotorGuard_t *guard, const MotorGuardConfig_t *config) {
+  if (guard == NULL) {
+    return;
+  }
+  guard->config = (config != NULL) ? *config : s_default_config;
+  MotorGuard_Start(guard);
+}
+
+void MotorGuard_SetConfig(MotorGuard_t *guard,
+                          const MotorGuardConfig_t *config) {
+  if (guard == NULL || config == NULL) {
+    return;
+  }
+  guard->config = *config;
+}
+
+void MotorGuard_Start(MotorGuard_t *guard) {
+  if (guard == NULL) {
+    return;
+  }
+  guard->run_us = 0U;
+  guard->over_us = 0U;
+  guard->sampled = false;
+  guard->over = false;
+  guard->reason = MOTOR_GUARD_OK;
+}
+
+MotorGuardReason_t MotorGuard_Update(MotorGuard_t *guard, uint32_t current_ma,
+                                     uint32_t dt_us) {
+  if (guard == NULL || guard->reason != MOTOR_GUARD_OK) {
+    return MOTOR_GUARD_OK;
+  }
+  const MotorGuardConfig_t *config = &guard->config;
+  /* The first sample of a run stands for no time */
+  const uint32_t elapsed_us = guard->sampled ? dt_us : 0U;
+  guard->sampled = true;
+  guard->run_us = add_saturating(guard->run_us, elapsed_us);
+
+  if (config->limit_ma != 0U && current_ma >= config->limit_ma) {
+    guard->reason = MOTOR_GUARD_OVERCURRENT;
+    return guard->reason;
+  }
+
+  if (config->stall_ma == 0U || current_ma < config->stall_ma) {
+    guard->over = false;
+    guard->over_us = 0U;
+    return MOTOR_GUARD_OK;
+  }
+  /* Time above the threshold counts from its first sample */
+  guard->over_us = guard->over ? add_saturating(guard->over_us, elapsed_us)
+                               : 0U;
+  guard->over = true;
+  if (guard->run_us >= config->blanking_us &&
+      guard->over_us >= config->debounce_us) {
+    guard->reason = MOTOR_GUARD_STALL;
+  }
+  return guard->reason;
+}
+
+const char *MotorGuard_ReasonName(MotorGuardReason_t reason) {
+  switch (reason) {
+  case MOTOR_GUARD_STALL:
+    return "stall";
+  case MOTOR_GUARD_OVERCURRENT:
+    return "overcurrent";
+  default:
+    return "ok";
+  }
+}
@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ * @file           :  optimum_start.c
+ * @brief          :  Learned preheating ahead of schedule transitions
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "optimum_start.h"
+
+#include "utils.h"
+
+#include <stddef.h>
+
+#define MS_PER_MIN 60000U
+#define MS_PER_HOUR 3600000U
+
+static uint16_t clamp_rate(uint32_t rate) {
+  if (rate < OPTIMUM_START_MIN_RATE_CDEG_H)
+    return OPTIMUM_START_MIN_RATE_CDEG_H;
+  if (rate > OPTIMUM_START_MAX_RATE_CDEG_H)
+    return OPTIMUM_START_MAX_RATE_CDEG_H;
+  return (uint16_t)rate;
+}
+
+void OptimumStart_Init(OptimumStart_t *model, uint16_t rate_cdeg_h) {
+  if (model == NULL) {
+    return;
+  }
+  model->rate_cdeg_h = (rate_cdeg_h != 0U) ? clamp_rate(rate_cdeg_h) : 0U;
+  model->primed = false;
+  model->measuring = false;
+  model->last_target_cdeg = 0;
+  model->start_cdeg = 0;
+  model->start_ms = 0U;
+  model->preheating = false;
+  model->preheat_key = 0U;
+}
+
+uint16_t OptimumStart_GetRate(const OptimumStart_t *model) {
+  if (model == NULL || model->rate_cdeg_h == 0U) {
+    return OPTIMUM_START_DEFAULT_RATE_CDEG_H;
+  }
+  return model->rate_cdeg_h;
+}
+
+uint32_t OptimumStart_LeadMinutes(const OptimumStart_t *model,
+                                  int32_t ambient_cdeg, int32_t target_cdeg) {
+  if (target_cdeg <= ambient_cdeg) {
+    return 0U;
+  }
+  const uint32_t rise = (uint32_t)(target_cdeg - ambient_cdeg);
+  const uint32_t rate = OptimumStart_GetRate(model);
+  /* Round up, so the lead is never short by a part minute */
+  const uint32_t lead = (rise * 60U + rate - 1U) / rate;
+  return (lead > OPTIMUM_START_MAX_LEAD_MIN) ? OPTIMUM_START_MAX_LEAD_MIN
+                                             : lead;
+}
+
+bool OptimumStart_ShouldPreheat(OptimumStart_t *model,
+                                const ScheduleState_t *state,
+                                int32_t ambient_cdeg) {
+  if (model == NULL) {
+    return false;
+  }
+  /* ON opens the valve, there is no temperature to reach */
+  if (state == NULL || state->next_index <= state->target_index ||
+      state->next_index >= UTILS_TEMP_INDEX_ON) {
+    model->preheating = false;
+    return false;
+  }
+  const uint16_t key = (uint16_t)(state->next_day * 1440U +
+                                  state->next_hour * 60U + state->next_minute);
+  if (model->preheating && model->preheat_key == key) {
+    return true;
+  }
+
+  const int32_t next_cdeg = Utils_IndexToCentiDegrees(state->next_index);
+  model->preheating = state->minutes_to_next <=
+                      OptimumStart_LeadMinutes(model, ambient_cdeg, next_cdeg);
+  model->preheat_key = key;
+  return model->preheating;
+}
+
+bool OptimumStart_Observe(OptimumStart_t *model, uint32_t now_ms,
+                          int32_t ambient_cdeg, int32_t target_cdeg) {
+  if (model == NULL) {
+    return false;
+  }
+  bool updated = false;
+  const bool changed = model->primed && target_cdeg != model->last_target_cdeg;
+
+  if (model->measuring) {
+    const uint32_t elapsed_ms = now_ms - model->start_ms;
+    const int32_t rise = ambient_cdeg - model->start_cdeg;
+    if (changed || elapsed_ms > OPTIMUM_START_MAX_MEASURE_MIN * MS_PER_MIN) {
+      model->measuring = false;
+    } else if (ambient_cdeg >= target_cdeg - OPTIMUM_START_REACHED_CDEG) {
+      model->measuring = false;
+      if (rise >= OPTIMUM_START_MIN_RISE_CDEG && elapsed_ms >= MS_PER_MIN) {
+        /* Rise per hour; in 64 bits, a rise of 20 °C over 6 h overflows
+           32 */
+        const uint16_t measured = clamp_rate((uint32_t)(
+            ((uint64_t)rise * MS_PER_HOUR + elapsed_ms / 2U) / elapsed_ms));
+        const uint16_t previous = model->rate_cdeg_h;
+        if (previous == 0U) {
+          model->rate_cdeg_h = measured;
+        } else {
+          const int32_t step = ((int32_t)measured - (int32_t)previous) /
+                               (1 << OPTIMUM_START_LEARN_SHIFT);
+          model->rate_cdeg_h = clamp_rate((uint32_t)(previous + step));
+        }
+        updated = (model->rate_cdeg_h != previous);
+      }
+    }
+  }
+
+  /* A rise of the target well above the room starts a heat-up */
+  if (changed && !model->measuring && target_cdeg > model->last_target_cdeg &&
+      target_cdeg - ambient_cdeg >= OPTIMUM_START_MIN_RISE_CDEG) {
+    model->measuring = true;
+    model->start_cdeg = ambient_cdeg;
+    model->start_ms = now_ms;
+  }
+
+  model->last_target_cdeg = target_cdeg;
+  model->primed = true;
+  return updated;
+}
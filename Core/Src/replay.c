@@ -0,0 +1,549 @@
+/**
+ ******************************************************************************
+ * @file           :  replay.c
+ * @brief          :  Deterministic record/replay of inputs, ADC samples, RTC
+ *                    reads, activity and the loaded configuration
+ *
+ * @details        :  Records are appended to a byte ring under a short
+ *                    critical section and encoded byte by byte, so the trace
+ *                    does not depend on structure padding. A replayed trace
+ *                    is walked in place with one cursor per record type; each
+ *                    cursor only moves past records whose tick has come.
+ *                    Compiled with REPLAY_RECORD_ENABLED and in the host
+ *                    build.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "replay.h"
+
+#if REPLAY_HOOKS_ENABLED
+#include "FreeRTOS.h"
+#include "cmsis_os2.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if (REPLAY_BUFFER_SIZE & (REPLAY_BUFFER_SIZE - 1U)) != 0U
+#error "REPLAY_BUFFER_SIZE must be a power of two"
+#endif
+
+#ifdef MIRATHERM_HOST
+#define REPLAY_PLATFORM "host"
+#else
+#define REPLAY_PLATFORM "stm32wb55"
+#endif
+
+#define REPLAY_BUFFER_MASK (REPLAY_BUFFER_SIZE - 1U)
+#define REPLAY_BYTES_PER_LINE 32U
+#define REPLAY_INPUT_SIZE 6U
+#define REPLAY_ADC_SIZE (REPLAY_ADC_CHANNELS * 2U)
+#define REPLAY_RTC_SIZE 7U
+#define REPLAY_CONFIG_SIZE (1U + sizeof(ConfigData_t))
+#define REPLAY_WORD_SIZE 4U
+#define REPLAY_ACTIVITY_SIZE 10U
+
+/* Position of one record type's consumer in the loaded trace */
+typedef struct {
+  uint32_t offset; /* Next record to look at */
+  uint32_t tick;   /* Tick of the record before it */
+} ReplayCursor_t;
+
+typedef struct {
+  uint32_t count;
+  uint32_t total; /* Cycles, saturating */
+  uint32_t max;
+} ReplayCostStats_t;
+
+static const char *const k_cost_names[REPLAY_COST_COUNT] = {
+    [REPLAY_COST_LEFT] = "left",     [REPLAY_COST_MIDDLE] = "middle",
+    [REPLAY_COST_RIGHT] = "right",   [REPLAY_COST_WHEEL] = "wheel",
+    [REPLAY_COST_SENSOR] = "sensor",
+};
+
+/* Recording ring, head and tail are free-running byte counts */
+static uint8_t s_ring[REPLAY_BUFFER_SIZE];
+static uint32_t s_head;
+static uint32_t s_tail;
+static bool s_recording;
+static uint32_t s_last_tick;
+static uint32_t s_dropped;
+static uint8_t s_recorded_rtc[REPLAY_RTC_SIZE];
+static bool s_recorded_rtc_valid;
+
+/* Loaded trace */
+static const uint8_t *s_trace;
+static uint32_t s_trace_size;
+static uint32_t s_end_tick;
+static ReplayCursor_t s_input_cursor;
+static ReplayCursor_t s_adc_cursor;
+static ReplayCursor_t s_rtc_cursor;
+static ReplayCursor_t s_activity_cursor;
+static ReplayCursor_t s_scan_cursor;
+static ReplayCursor_t s_scan_activity_cursor;
+static uint16_t s_adc_replayed[REPLAY_ADC_CHANNELS];
+static bool s_adc_replayed_valid;
+static SelfHeatingActivity_t s_activity_replayed;
+static bool s_activity_replayed_valid;
+static uint8_t s_rtc_replayed[REPLAY_RTC_SIZE];
+static uint32_t s_rtc_replayed_tick;
+static bool s_rtc_replayed_valid;
+static ReplayCostStats_t s_costs[REPLAY_COST_COUNT];
+
+static void put_u16(uint8_t *dst, uint16_t value) {
+  dst[0] = (uint8_t)value;
+  dst[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *dst, uint32_t value) {
+  put_u16(dst, (uint16_t)value);
+  put_u16(dst + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *src) {
+  return (uint16_t)(src[0] | ((uint16_t)src[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *src) {
+  return get_u16(src) | ((uint32_t)get_u16(src + 2) << 16);
+}
+
+/* Payload size of a record type, 0 for an unknown type */
+static uint32_t payload_size(uint8_t type) {
+  switch (type) {
+  case REPLAY_REC_INPUT:
+    return REPLAY_INPUT_SIZE;
+  case REPLAY_REC_ADC:
+    return REPLAY_ADC_SIZE;
+  case REPLAY_REC_RTC:
+    return REPLAY_RTC_SIZE;
+  case REPLAY_REC_CONFIG:
+    return REPLAY_CONFIG_SIZE;
+  case REPLAY_REC_TICK:
+  case REPLAY_REC_DROP:
+    return REPLAY_WORD_SIZE;
+  case REPLAY_REC_ACTIVITY:
+    return REPLAY_ACTIVITY_SIZE;
+  default:
+    return 0U;
+  }
+}
+
+/* Recording --------------------------------------------------------------- */
+static void ring_put(const uint8_t *src, uint32_t size) {
+  for (uint32_t i = 0U; i < size; i++) {
+    s_ring[(s_head + i) & REPLAY_BUFFER_MASK] = src[i];
+  }
+  s_head += size;
+}
+
+static void ring_put_record(uint8_t type, uint16_t delta, const uint8_t *src,
+                            uint32_t size) {
+  uint8_t header[REPLAY_RECORD_HEADER_SIZE];
+  header[0] = type;
+  put_u16(&header[1], delta);
+  ring_put(header, sizeof(header));
+  ring_put(src, size);
+}
+
+/* Append one record, preceded by TICK/DROP records when needed */
+static void record(uint8_t type, const uint8_t *payload, uint32_t size) {
+  if (!s_recording) {
+    return;
+  }
+
+  const uint32_t now = osKernelGetTickCount();
+  const uint32_t word_record = REPLAY_RECORD_HEADER_SIZE + REPLAY_WORD_SIZE;
+  uint8_t word[REPLAY_WORD_SIZE];
+
+  taskENTER_CRITICAL();
+  const bool long_gap = (now - s_last_tick) > UINT16_MAX;
+  const uint32_t needed = REPLAY_RECORD_HEADER_SIZE + size +
+                          (long_gap ? word_record : 0U) +
+                          ((s_dropped != 0U) ? word_record : 0U);
+
+  if (REPLAY_BUFFER_SIZE - (s_head - s_tail) < needed) {
+    s_dropped += REPLAY_RECORD_HEADER_SIZE + size;
+  } else {
+    if (long_gap) {
+      put_u32(word, now);
+      ring_put_record(REPLAY_REC_TICK, 0U, word, sizeof(word));
+      s_last_tick = now;
+    }
+    if (s_dropped != 0U) {
+      put_u32(word, s_dropped);
+      ring_put_record(REPLAY_REC_DROP, (uint16_t)(now - s_last_tick), word,
+                      sizeof(word));
+      s_last_tick = now;
+      s_dropped = 0U;
+    }
+    ring_put_record(type, (uint16_t)(now - s_last_tick), payload, size);
+    s_last_tick = now;
+  }
+  taskEXIT_CRITICAL();
+}
+
+void Replay_StartRecording(void) {
+  if (s_recording) {
+    return;
+  }
+
+  uint8_t header[REPLAY_HEADER_SIZE];
+  put_u32(&header[0], REPLAY_MAGIC);
+  put_u16(&header[4], REPLAY_VERSION);
+  put_u16(&header[6], (uint16_t)sizeof(ConfigData_t));
+  put_u32(&header[8], configTICK_RATE_HZ);
+
+  /* Runs before the scheduler, nothing else touches the ring yet */
+  ring_put(header, sizeof(header));
+  s_last_tick = 0U;
+  s_recording = true;
+}
+
+uint32_t Replay_ReadRecording(uint8_t *dst, uint32_t size) {
+  taskENTER_CRITICAL();
+  uint32_t count = s_head - s_tail;
+  if (count > size) {
+    count = size;
+  }
+  for (uint32_t i = 0U; i < count; i++) {
+    dst[i] = s_ring[(s_tail + i) & REPLAY_BUFFER_MASK];
+  }
+  s_tail += count;
+  taskEXIT_CRITICAL();
+  return count;
+}
+
+void Replay_Dump(void) {
+  uint8_t line[REPLAY_BYTES_PER_LINE];
+  uint32_t count;
+
+  while ((count = Replay_ReadRecording(line, sizeof(line))) > 0U) {
+    printf("RPL ");
+    for (uint32_t i = 0U; i < count; i++) {
+      printf("%02x", line[i]);
+    }
+    printf("\n");
+  }
+}
+
+/* Replay ------------------------------------------------------------------ */
+bool Replay_Load(const uint8_t *data, uint32_t size) {
+  if (data == NULL || size < REPLAY_HEADER_SIZE ||
+      get_u32(&data[0]) != REPLAY_MAGIC ||
+      get_u16(&data[4]) != REPLAY_VERSION) {
+    printf("Replay: not a version %u trace\n", (unsigned)REPLAY_VERSION);
+    return false;
+  }
+  if (get_u16(&data[6]) != sizeof(ConfigData_t) ||
+      get_u32(&data[8]) != configTICK_RATE_HZ) {
+    printf("Replay: trace recorded by an incompatible build\n");
+    return false;
+  }
+
+  /* Validate every record and find the end of the trace */
+  uint32_t offset = REPLAY_HEADER_SIZE;
+  uint32_t tick = 0U;
+  uint32_t dropped = 0U;
+  while (offset < size) {
+    const uint8_t type = data[offset];
+    const uint32_t length = payload_size(type);
+    if (length == 0U || offset + REPLAY_RECORD_HEADER_SIZE + length > size) {
+      printf("Replay: bad record at offset %lu\n", (unsigned long)offset);
+      return false;
+    }
+
+    const uint8_t *payload = &data[offset + REPLAY_RECORD_HEADER_SIZE];
+    tick = (type == REPLAY_REC_TICK) ? get_u32(payload)
+                                     : tick + get_u16(&data[offset + 1]);
+    if (type == REPLAY_REC_DROP) {
+      dropped += get_u32(payload);
+    }
+    offset += REPLAY_RECORD_HEADER_SIZE + length;
+  }
+
+  if (dropped != 0U) {
+    printf("Replay: trace lost %lu bytes while recording, replay will "
+           "diverge\n",
+           (unsigned long)dropped);
+  }
+
+  const ReplayCursor_t start = {.offset = REPLAY_HEADER_SIZE, .tick = 0U};
+  s_input_cursor = start;
+  s_adc_cursor = start;
+  s_rtc_cursor = start;
+  s_activity_cursor = start;
+  s_scan_cursor = start;
+  s_scan_activity_cursor = start;
+  s_end_tick = tick;
+  s_trace_size = size;
+  s_trace = data;
+  return true;
+}
+
+bool Replay_IsActive(void) { return s_trace != NULL; }
+
+uint32_t Replay_GetEndTick(void) { return s_end_tick; }
+
+/* Next record of one type due at @p now, NULL if none is due yet */
+static const uint8_t *next_record(ReplayCursor_t *cursor, uint8_t type,
+                                  uint32_t now) {
+  while (cursor->offset < s_trace_size) {
+    const uint8_t *record = &s_trace[cursor->offset];
+    const uint8_t *payload = record + REPLAY_RECORD_HEADER_SIZE;
+    const uint32_t tick = (record[0] == REPLAY_REC_TICK)
+                              ? get_u32(payload)
+                              : cursor->tick + get_u16(&record[1]);
+    if (tick > now) {
+      return NULL;
+    }
+
+    cursor->offset += REPLAY_RECORD_HEADER_SIZE + payload_size(record[0]);
+    cursor->tick = tick;
+    if (record[0] == type) {
+      return payload;
+    }
+  }
+  return NULL;
+}
+
+bool Replay_ScanAdc(uint32_t *tick, uint16_t samples[REPLAY_ADC_CHANNELS]) {
+  if (s_trace == NULL) {
+    return false;
+  }
+
+  const uint8_t *payload =
+      next_record(&s_scan_cursor, REPLAY_REC_ADC, UINT32_MAX);
+  if (payload == NULL) {
+    return false;
+  }
+
+  for (uint32_t i = 0U; i < REPLAY_ADC_CHANNELS; i++) {
+    samples[i] = get_u16(&payload[2U * i]);
+  }
+  *tick = s_scan_cursor.tick;
+  return true;
+}
+
+static void get_activity(const uint8_t *payload,
+                         SelfHeatingActivity_t *activity) {
+  activity->period_ms = get_u32(&payload[0]);
+  activity->cpu_permille = get_u16(&payload[4]);
+  activity->display_bps = get_u16(&payload[6]);
+  activity->motor_ma = get_u16(&payload[8]);
+}
+
+bool Replay_ScanActivity(uint32_t *tick, SelfHeatingActivity_t *activity) {
+  if (s_trace == NULL) {
+    return false;
+  }
+
+  const uint8_t *payload =
+      next_record(&s_scan_activity_cursor, REPLAY_REC_ACTIVITY, UINT32_MAX);
+  if (payload == NULL) {
+    return false;
+  }
+
+  get_activity(payload, activity);
+  *tick = s_scan_activity_cursor.tick;
+  return true;
+}
+
+/* Hooks ------------------------------------------------------------------- */
+void Replay_RecordInput(const Input2VPEvent_t *event) {
+  const uint32_t age = HAL_GetTick() - event->timestamp;
+  uint8_t payload[REPLAY_INPUT_SIZE];
+
+  payload[0] = (uint8_t)event->type;
+  payload[1] = (uint8_t)event->button_action;
+  put_u16(&payload[2], (uint16_t)event->delta);
+  put_u16(&payload[4], (age > UINT16_MAX) ? UINT16_MAX : (uint16_t)age);
+  record(REPLAY_REC_INPUT, payload, sizeof(payload));
+}
+
+bool Replay_NextInput(Input2VPEvent_t *event) {
+  if (s_trace == NULL) {
+    return false;
+  }
+
+  const uint8_t *payload =
+      next_record(&s_input_cursor, REPLAY_REC_INPUT, osKernelGetTickCount());
+  if (payload == NULL) {
+    return false;
+  }
+
+  event->type = (Input2VPEventTypeDef)payload[0];
+  event->button_action = (button_action_t)payload[1];
+  event->delta = (int16_t)get_u16(&payload[2]);
+  event->timestamp = HAL_GetTick() - get_u16(&payload[4]);
+  return true;
+}
+
+void Replay_Adc(uint16_t samples[REPLAY_ADC_CHANNELS]) {
+  uint8_t payload[REPLAY_ADC_SIZE];
+
+  if (s_trace != NULL) {
+    const uint32_t now = osKernelGetTickCount();
+    const uint8_t *recorded;
+    while ((recorded = next_record(&s_adc_cursor, REPLAY_REC_ADC, now)) !=
+           NULL) {
+      for (uint32_t i = 0U; i < REPLAY_ADC_CHANNELS; i++) {
+        s_adc_replayed[i] = get_u16(&recorded[2U * i]);
+      }
+      s_adc_replayed_valid = true;
+    }
+    if (s_adc_replayed_valid) {
+      memcpy(samples, s_adc_replayed, sizeof(s_adc_replayed));
+    }
+  }
+
+  for (uint32_t i = 0U; i < REPLAY_ADC_CHANNELS; i++) {
+    put_u16(&payload[2U * i], samples[i]);
+  }
+  record(REPLAY_REC_ADC, payload, sizeof(payload));
+}
+
+void Replay_Activity(SelfHeatingActivity_t *activity) {
+  uint8_t payload[REPLAY_ACTIVITY_SIZE];
+
+  if (s_trace != NULL) {
+    const uint32_t now = osKernelGetTickCount();
+    const uint8_t *recorded;
+    while ((recorded = next_record(&s_activity_cursor, REPLAY_REC_ACTIVITY,
+                                   now)) != NULL) {
+      get_activity(recorded, &s_activity_replayed);
+      s_activity_replayed_valid = true;
+    }
+    if (s_activity_replayed_valid) {
+      *activity = s_activity_replayed;
+    }
+  }
+
+  put_u32(&payload[0], activity->period_ms);
+  put_u16(&payload[4], activity->cpu_permille);
+  put_u16(&payload[6], activity->display_bps);
+  put_u16(&payload[8], activity->motor_ma);
+  record(REPLAY_REC_ACTIVITY, payload, sizeof(payload));
+}
+
+void Replay_Rtc(RTC_TimeTypeDef *time, RTC_DateTypeDef *date) {
+  const uint32_t now = osKernelGetTickCount();
+
+  /* Called from several tasks: the cursor and both calendars are shared */
+  taskENTER_CRITICAL();
+  if (s_trace != NULL) {
+    const uint8_t *recorded;
+    while ((recorded = next_record(&s_rtc_cursor, REPLAY_REC_RTC, now)) !=
+           NULL) {
+      memcpy(s_rtc_replayed, recorded, sizeof(s_rtc_replayed));
+      s_rtc_replayed_tick = s_rtc_cursor.tick;
+      s_rtc_replayed_valid = true;
+    }
+    if (s_rtc_replayed_valid) {
+      const uint32_t seconds =
+          s_rtc_replayed[2] +
+          (now - s_rtc_replayed_tick) / configTICK_RATE_HZ;
+      time->Hours = s_rtc_replayed[0];
+      time->Minutes = s_rtc_replayed[1];
+      time->Seconds = (uint8_t)((seconds > 59U) ? 59U : seconds);
+      date->WeekDay = s_rtc_replayed[3];
+      date->Date = s_rtc_replayed[4];
+      date->Month = s_rtc_replayed[5];
+      date->Year = s_rtc_replayed[6];
+    }
+  }
+
+  const uint8_t payload[REPLAY_RTC_SIZE] = {
+      time->Hours, time->Minutes, time->Seconds, date->WeekDay,
+      date->Date,  date->Month,   date->Year,
+  };
+  /* Compare everything but the seconds (index 2) */
+  const bool changed = !s_recorded_rtc_valid ||
+                       memcmp(payload, s_recorded_rtc, 2U) != 0 ||
+                       memcmp(&payload[3], &s_recorded_rtc[3],
+                              REPLAY_RTC_SIZE - 3U) != 0;
+  if (changed) {
+    memcpy(s_recorded_rtc, payload, sizeof(s_recorded_rtc));
+    s_recorded_rtc_valid = true;
+  }
+  taskEXIT_CRITICAL();
+
+  if (changed) {
+    record(REPLAY_REC_RTC, payload, sizeof(payload));
+  }
+}
+
+bool Replay_Config(ConfigData_t *config, bool valid) {
+  if (s_trace != NULL) {
+    ReplayCursor_t cursor = {.offset = REPLAY_HEADER_SIZE, .tick = 0U};
+    const uint8_t *recorded =
+        next_record(&cursor, REPLAY_REC_CONFIG, UINT32_MAX);
+    if (recorded != NULL) {
+      valid = (recorded[0] != 0U);
+      if (valid) {
+        memcpy(config, &recorded[1], sizeof(ConfigData_t));
+      }
+    }
+  }
+
+  uint8_t payload[REPLAY_CONFIG_SIZE];
+  payload[0] = valid ? 1U : 0U;
+  memcpy(&payload[1], config, sizeof(ConfigData_t));
+  record(REPLAY_REC_CONFIG, payload, sizeof(payload));
+  return valid;
+}
+
+/* Cost report ------------------------------------------------------------- */
+void Replay_AddCost(ReplayCost_t kind, uint32_t cycles) {
+  if (s_trace == NULL || kind >= REPLAY_COST_COUNT) {
+    return;
+  }
+
+  /* Each class is charged by a single task */
+  ReplayCostStats_t *stats = &s_costs[kind];
+  stats->count++;
+  stats->total =
+      (stats->total > UINT32_MAX - cycles) ? UINT32_MAX : stats->total + cycles;
+  if (cycles > stats->max) {
+    stats->max = cycles;
+  }
+}
+
+void Replay_Report(void) {
+  printf("Replay event   count   avg us   max us\n");
+  for (uint32_t i = 0U; i < REPLAY_COST_COUNT; i++) {
+    const ReplayCostStats_t *stats = &s_costs[i];
+    if (stats->count == 0U) {
+      continue;
+    }
+    printf("%-12s %7lu %8lu %8lu\n", k_cost_names[i],
+           (unsigned long)stats->count,
+           (unsigned long)CycleCounter_ToUs(stats->total / stats->count),
+           (unsigned long)CycleCounter_ToUs(stats->max));
+  }
+
+  /* Same format as benchmarks.c, three decimals without float printf */
+  for (uint32_t i = 0U; i < REPLAY_COST_COUNT; i++) {
+    const ReplayCostStats_t *stats = &s_costs[i];
+    if (stats->count == 0U) {
+      continue;
+    }
+    const uint64_t per_event_x1000 =
+        ((uint64_t)stats->total * 1000U) / stats->count;
+    printf("BENCH {\"platform\":\"%s\",\"kernel\":\"replay_%s\",\"calls\":%lu,"
+           "\"cycles\":%lu,\"cycles_per_call\":%lu.%03lu}\n",
+           REPLAY_PLATFORM, k_cost_names[i], (unsigned long)stats->count,
+           (unsigned long)stats->total,
+           (unsigned long)(per_event_x1000 / 1000U),
+           (unsigned long)(per_event_x1000 % 1000U));
+  }
+}
+
+#endif /* REPLAY_HOOKS_ENABLED */
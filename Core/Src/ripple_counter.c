@@ -0,0 +1,420 @@
+/**
+ ******************************************************************************
+ * @file           :  ripple_counter.c
+ * @brief          :  Valve position from the commutation ripple of the motor
+ *                    current
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "ripple_counter.h"
+
+/* The CMSIS SIMD intrinsics (__SMLAD, __PKHBT, __SSAT) of the target */
+#if defined(__ARM_FEATURE_DSP) && !defined(MIRATHERM_HOST)
+#include "main.h"
+#define RIPPLE_COUNTER_USE_DSP 1
+#else
+#define RIPPLE_COUNTER_USE_DSP 0
+#endif
+
+#include <stddef.h>
+
+/* Currents are scaled by 8 into the 16-bit filter input, so the filter
+   keeps fractions of a mA; 4095 mA is above any current the shunt reads */
+#define RIPPLE_COUNTER_INPUT_SHIFT 3U
+#define RIPPLE_COUNTER_INPUT_MAX_MA 4095U
+
+/* Envelope time constant in samples, a few ripple periods */
+#define RIPPLE_COUNTER_ENVELOPE_SAMPLES 32
+
+/* Constant peak gain band-pass (RBJ cookbook) in Q14, b1 = 0 and b2 = -b0,
+   centered on a period of RIPPLE_COUNTER_TRACK_MIN_PERIOD samples and up;
+   generated by --ripple-eval from the quality factors in ripple_counter.h */
+static const RippleCounterBiquad_t k_wide[RIPPLE_COUNTER_TRACK_STEPS] = {
+    {7604, -8780, -1176}, /*  3 */
+    {8192, 0, 0}, /*  4 */
+    {7986, 5190, -411}, /*  5 */
+    {7604, 8780, -1176}, /*  6 */
+    {7189, 11466, -2006}, /*  7 */
+    {6786, 13573, -2811}, /*  8 */
+    {6411, 15280, -3563}, /*  9 */
+    {6065, 16696, -4254}, /* 10 */
+    {5749, 17893, -4885}, /* 11 */
+    {5461, 18919, -5461}, /* 12 */
+    {5198, 19809, -5987}, /* 13 */
+    {4958, 20589, -6469}, /* 14 */
+    {4737, 21280, -6910}, /* 15 */
+    {4535, 21895, -7315}, /* 16 */
+    {4348, 22447, -7688}, /* 17 */
+    {4176, 22944, -8033}, /* 18 */
+    {4016, 23396, -8352}, /* 19 */
+    {3868, 23807, -8649}, /* 20 */
+    {3730, 24184, -8924}, /* 21 */
+    {3601, 24530, -9181}, /* 22 */
+    {3481, 24849, -9422}, /* 23 */
+    {3369, 25144, -9647}, /* 24 */
+    {3263, 25417, -9858}, /* 25 */
+    {3164, 25672, -10056}, /* 26 */
+    {3070, 25910, -10243}, /* 27 */
+    {2982, 26132, -10420}, /* 28 */
+    {2899, 26340, -10586}, /* 29 */
+    {2820, 26535, -10744}, /* 30 */
+    {2745, 26719, -10893}, /* 31 */
+    {2675, 26892, -11035}, /* 32 */
+    {2607, 27056, -11169}, /* 33 */
+    {2543, 27210, -11298}, /* 34 */
+    {2482, 27357, -11419}, /* 35 */
+    {2424, 27496, -11536}, /* 36 */
+    {2369, 27628, -11647}, /* 37 */
+    {2316, 27753, -11753}, /* 38 */
+    {2265, 27873, -11854}, /* 39 */
+    {2216, 27987, -11951}, /* 40 */
+    {2170, 28095, -12044}, /* 41 */
+    {2125, 28199, -12134}, /* 42 */
+    {2082, 28299, -12219}, /* 43 */
+    {2041, 28394, -12302}, /* 44 */
+    {2002, 28485, -12381}, /* 45 */
+    {1964, 28572, -12457}, /* 46 */
+    {1927, 28656, -12530}, /* 47 */
+    {1892, 28737, -12601}, /* 48 */
+    {1858, 28814, -12669}, /* 49 */
+    {1825, 28889, -12734}, /* 50 */
+    {1793, 28961, -12798}, /* 51 */
+    {1762, 29030, -12859}, /* 52 */
+    {1733, 29097, -12918}, /* 53 */
+    {1704, 29161, -12976}, /* 54 */
+    {1677, 29223, -13031}, /* 55 */
+    {1650, 29283, -13085}, /* 56 */
+    {1624, 29341, -13137}, /* 57 */
+    {1599, 29397, -13187}, /* 58 */
+    {1574, 29452, -13236}, /* 59 */
+    {1551, 29504, -13283}, /* 60 */
+    {1528, 29555, -13329}, /* 61 */
+    {1505, 29605, -13373}, /* 62 */
+    {1484, 29653, -13417}, /* 63 */
+    {1463, 29699, -13459}, /* 64 */
+    {1442, 29744, -13500}, /* 65 */
+    {1422, 29788, -13540}, /* 66 */
+};
+
+static const RippleCounterBiquad_t k_tracking[RIPPLE_COUNTER_TRACK_STEPS] = {
+    {2916, -13468, -10552}, /*  3 */
+    {3277, 0, -9830}, /*  4 */
+    {3147, 8181, -10090}, /*  5 */
+    {2916, 13468, -10552}, /*  6 */
+    {2679, 17090, -11026}, /*  7 */
+    {2461, 19690, -11462}, /*  8 */
+    {2268, 21626, -11847}, /*  9 */
+    {2099, 23113, -12186}, /* 10 */
+    {1951, 24284, -12482}, /* 11 */
+    {1820, 25225, -12743}, /* 12 */
+    {1705, 25995, -12973}, /* 13 */
+    {1603, 26634, -13177}, /* 14 */
+    {1512, 27172, -13360}, /* 15 */
+    {1431, 27630, -13523}, /* 16 */
+    {1357, 28024, -13670}, /* 17 */
+    {1291, 28366, -13803}, /* 18 */
+    {1230, 28666, -13924}, /* 19 */
+    {1175, 28929, -14034}, /* 20 */
+    {1124, 29163, -14135}, /* 21 */
+    {1078, 29372, -14228}, /* 22 */
+    {1035, 29559, -14313}, /* 23 */
+    {996, 29728, -14393}, /* 24 */
+    {959, 29881, -14466}, /* 25 */
+    {925, 30020, -14534}, /* 26 */
+    {893, 30147, -14598}, /* 27 */
+    {863, 30263, -14657}, /* 28 */
+    {836, 30370, -14713}, /* 29 */
+    {810, 30468, -14765}, /* 30 */
+    {785, 30559, -14814}, /* 31 */
+    {762, 30644, -14860}, /* 32 */
+    {740, 30722, -14904}, /* 33 */
+    {720, 30795, -14945}, /* 34 */
+    {700, 30864, -14984}, /* 35 */
+    {682, 30928, -15021}, /* 36 */
+    {664, 30987, -15056}, /* 37 */
+    {648, 31044, -15089}, /* 38 */
+    {632, 31097, -15121}, /* 39 */
+    {617, 31146, -15151}, /* 40 */
+    {602, 31194, -15179}, /* 41 */
+    {589, 31238, -15207}, /* 42 */
+    {575, 31280, -15233}, /* 43 */
+    {563, 31320, -15258}, /* 44 */
+    {551, 31358, -15282}, /* 45 */
+    {539, 31394, -15305}, /* 46 */
+    {528, 31428, -15327}, /* 47 */
+    {518, 31461, -15349}, /* 48 */
+    {508, 31492, -15369}, /* 49 */
+    {498, 31522, -15388}, /* 50 */
+    {488, 31550, -15407}, /* 51 */
+    {479, 31578, -15425}, /* 52 */
+    {471, 31604, -15443}, /* 53 */
+    {462, 31628, -15460}, /* 54 */
+    {454, 31652, -15476}, /* 55 */
+    {446, 31675, -15492}, /* 56 */
+    {439, 31697, -15507}, /* 57 */
+    {431, 31719, -15522}, /* 58 */
+    {424, 31739, -15536}, /* 59 */
+    {417, 31759, -15550}, /* 60 */
+    {411, 31777, -15563}, /* 61 */
+    {404, 31796, -15576}, /* 62 */
+    {398, 31813, -15588}, /* 63 */
+    {392, 31830, -15600}, /* 64 */
+    {386, 31847, -15612}, /* 65 */
+    {380, 31862, -15623}, /* 66 */
+};
+
+/* One band-pass step: y0 = b0 * x0 - b0 * x2 + a1 * y1 + a2 * y2 in Q14,
+   rounded and saturated to 16 bits. Bit-exact on both paths. */
+static int16_t band_pass(const RippleCounter_t *counter, int16_t x0) {
+  const RippleCounterBiquad_t *f = counter->filter;
+#if RIPPLE_COUNTER_USE_DSP
+  /* Two dual 16-bit multiply-accumulates on packed pairs */
+  const uint32_t b = __PKHBT((uint32_t)(uint16_t)f->b0,
+                             (uint32_t)(uint16_t)(-f->b0), 16);
+  const uint32_t a = __PKHBT((uint32_t)(uint16_t)f->a1,
+                             (uint32_t)(uint16_t)f->a2, 16);
+  uint32_t acc = __SMLAD(__PKHBT((uint32_t)(uint16_t)x0,
+                                 (uint32_t)(uint16_t)counter->x2, 16),
+                         b, 0U);
+  acc = __SMLAD(__PKHBT((uint32_t)(uint16_t)counter->y1,
+                        (uint32_t)(uint16_t)counter->y2, 16),
+                a, acc);
+  return (int16_t)__SSAT(((int32_t)acc + (1 << 13)) >> 14, 16);
+#else
+  const int32_t acc = (int32_t)f->b0 * x0 - (int32_t)f->b0 * counter->x2 +
+                      (int32_t)f->a1 * counter->y1 +
+                      (int32_t)f->a2 * counter->y2;
+  const int32_t y = (acc + (1 << 13)) >> 14;
+  if (y > INT16_MAX)
+    return INT16_MAX;
+  if (y < INT16_MIN)
+    return INT16_MIN;
+  return (int16_t)y;
+#endif
+}
+
+/* Period of the band center in 1/16 samples, the guess a run starts with */
+static uint32_t center_period_x16(uint32_t sample_us) {
+  return (16U * 1000000U) / (RIPPLE_COUNTER_CENTER_HZ * sample_us);
+}
+
+/* Narrow band-pass at the tracked period */
+static void track(RippleCounter_t *counter) {
+  counter->filter =
+      RippleCounter_GetFilter((counter->period_x16 + 8U) / 16U, true);
+}
+
+/* A rising transition: the ripples it stands for, 0 for noise */
+static uint32_t count_ripple(RippleCounter_t *counter) {
+  const uint32_t interval = counter->since_ripple;
+  const uint32_t interval_x16 = interval * 16U;
+  uint32_t ripples = 1U;
+
+  if (interval < counter->min_interval) {
+    return 0U;
+  }
+  if (counter->ripples >= RIPPLE_COUNTER_LOCK_RIPPLES) {
+    const uint32_t period = counter->period_x16;
+    if (interval_x16 * 100U < period * RIPPLE_COUNTER_MIN_PERIOD_PCT) {
+      /* Keep timing from the last real ripple */
+      return 0U;
+    }
+    if (interval_x16 * 100U > period * RIPPLE_COUNTER_MAX_PERIOD_PCT) {
+      ripples = (interval_x16 + period / 2U) / period;
+      if (ripples > RIPPLE_COUNTER_MAX_CREDIT) {
+        ripples = RIPPLE_COUNTER_MAX_CREDIT;
+      }
+    } else {
+      counter->period_x16 =
+          (uint32_t)((int32_t)period +
+                     ((int32_t)interval_x16 - (int32_t)period) / 4);
+    }
+    track(counter);
+  } else {
+    /* Speeding up: follow the intervals closely, the first one has no
+       start */
+    if (counter->ripples > 0U) {
+      counter->period_x16 = (uint32_t)(
+          (int32_t)counter->period_x16 +
+          ((int32_t)interval_x16 - (int32_t)counter->period_x16) / 2);
+    }
+    counter->ripples++;
+  }
+  counter->since_ripple = 0U;
+  return ripples;
+}
+
+void RippleCounter_Init(RippleCounter_t *counter, uint32_t sample_us) {
+  if (counter == NULL || sample_us == 0U) {
+    return;
+  }
+  counter->wide = RippleCounter_GetFilter(
+      (center_period_x16(sample_us) + 8U) / 16U, false);
+  counter->sample_us = sample_us;
+  counter->min_interval =
+      (uint16_t)(1000000U / (RIPPLE_COUNTER_MAX_HZ * sample_us));
+  counter->settle_samples = (uint16_t)(RIPPLE_COUNTER_SETTLE_US / sample_us);
+  counter->min_hysteresis =
+      (uint16_t)(RIPPLE_COUNTER_MIN_AMPLITUDE_MA << RIPPLE_COUNTER_INPUT_SHIFT);
+  counter->position = 0;
+  counter->run_ripples = 0U;
+  RippleCounter_Start(counter, 0, 0U);
+}
+
+void RippleCounter_Start(RippleCounter_t *counter, int8_t direction,
+                         uint32_t target) {
+  if (counter == NULL || counter->sample_us == 0U) {
+    return;
+  }
+  counter->x1 = counter->x2 = 0;
+  counter->y1 = counter->y2 = 0;
+  counter->filter = counter->wide;
+  counter->envelope = 0U;
+  counter->mean = 0U;
+  counter->period_x16 = center_period_x16(counter->sample_us);
+  counter->since_ripple = 0U;
+  counter->ripples = 0U;
+  counter->primed = false;
+  counter->low = false;
+  counter->direction = (direction > 0) ? 1 : ((direction < 0) ? -1 : 0);
+  counter->run_ripples = 0U;
+  counter->target = target;
+}
+
+uint32_t RippleCounter_Update(RippleCounter_t *counter, uint32_t current_ma) {
+  if (counter == NULL || counter->direction == 0) {
+    return 0U;
+  }
+  const uint32_t clamped_ma = (current_ma > RIPPLE_COUNTER_INPUT_MAX_MA)
+                                  ? RIPPLE_COUNTER_INPUT_MAX_MA
+                                  : current_ma;
+  const int16_t x0 = (int16_t)(clamped_ma << RIPPLE_COUNTER_INPUT_SHIFT);
+  if (!counter->primed) {
+    /* Start from a steady state at the first current, so the step from
+       zero does not ring through the band-pass */
+    counter->x1 = counter->x2 = x0;
+    counter->mean = (uint32_t)x0 * 16U;
+    counter->primed = true;
+    return 0U;
+  }
+
+  const int16_t y0 = band_pass(counter, x0);
+  counter->x2 = counter->x1;
+  counter->x1 = x0;
+  counter->y2 = counter->y1;
+  counter->y1 = y0;
+
+  const int32_t magnitude_x16 = ((y0 < 0) ? -(int32_t)y0 : (int32_t)y0) * 16;
+  counter->envelope = (uint32_t)(
+      (int32_t)counter->envelope +
+      (magnitude_x16 - (int32_t)counter->envelope) /
+          RIPPLE_COUNTER_ENVELOPE_SAMPLES);
+  counter->mean = (uint32_t)(
+      (int32_t)counter->mean +
+      ((int32_t)x0 * 16 - (int32_t)counter->mean) /
+          RIPPLE_COUNTER_ENVELOPE_SAMPLES);
+  /* Half the mean amplitude (a sine peaks at 1.57 times its mean), but
+     not below a fixed noise floor or a share of the current: the
+     tracking band-pass shapes noise on a stalled motor into ripples */
+  int32_t hysteresis = (int32_t)(counter->envelope / 32U);
+  const int32_t depth =
+      (int32_t)((counter->mean * RIPPLE_COUNTER_MIN_DEPTH_PCT) / 1600U);
+  if (hysteresis < depth) {
+    hysteresis = depth;
+  }
+  if (hysteresis < (int32_t)counter->min_hysteresis) {
+    hysteresis = (int32_t)counter->min_hysteresis;
+  }
+
+  if (counter->since_ripple < UINT16_MAX) {
+    counter->since_ripple++;
+  }
+  if (counter->ripples == 0U &&
+      counter->since_ripple < counter->settle_samples) {
+    /* Inrush: the envelope builds up, the motor has hardly turned */
+    return 0U;
+  }
+  if (y0 < -hysteresis) {
+    counter->low = true;
+    return 0U;
+  }
+  if (!counter->low || y0 <= hysteresis) {
+    return 0U;
+  }
+  counter->low = false;
+  const uint32_t ripples = count_ripple(counter);
+  counter->position += counter->direction * (int32_t)ripples;
+  counter->run_ripples += ripples;
+  return ripples;
+}
+
+uint32_t RippleCounter_RunOn(const RippleCounter_t *counter,
+                             uint32_t run_on_us) {
+  if (counter == NULL || counter->direction == 0 || counter->ripples == 0U) {
+    return 0U;
+  }
+  const uint32_t period_x16 = counter->period_x16;
+  if ((uint32_t)counter->since_ripple * 16U > 2U * period_x16) {
+    /* Not turning any more */
+    return 0U;
+  }
+  const uint32_t period_us_x16 = period_x16 * counter->sample_us;
+  return (run_on_us * 16U + period_us_x16 / 2U) / period_us_x16;
+}
+
+bool RippleCounter_TargetReached(const RippleCounter_t *counter) {
+  if (counter == NULL || counter->direction == 0 || counter->target == 0U) {
+    return false;
+  }
+  return counter->run_ripples +
+             RippleCounter_RunOn(counter, RIPPLE_COUNTER_BRAKE_US) >=
+         counter->target;
+}
+
+bool RippleCounter_Stalled(const RippleCounter_t *counter) {
+  if (counter == NULL || counter->direction == 0 ||
+      counter->ripples < RIPPLE_COUNTER_LOCK_RIPPLES) {
+    return false;
+  }
+  return (uint32_t)counter->since_ripple * 16U >
+         RIPPLE_COUNTER_STALL_PERIODS * counter->period_x16;
+}
+
+void RippleCounter_Stop(RippleCounter_t *counter, uint32_t run_on_us) {
+  if (counter == NULL || counter->direction == 0) {
+    return;
+  }
+  const uint32_t ripples = RippleCounter_RunOn(counter, run_on_us);
+  counter->position += counter->direction * (int32_t)ripples;
+  counter->run_ripples += ripples;
+  counter->direction = 0;
+}
+
+const RippleCounterBiquad_t *RippleCounter_GetFilter(uint32_t period,
+                                                     bool tracking) {
+  if (period < RIPPLE_COUNTER_TRACK_MIN_PERIOD) {
+    period = RIPPLE_COUNTER_TRACK_MIN_PERIOD;
+  }
+  if (period >= RIPPLE_COUNTER_TRACK_MIN_PERIOD + RIPPLE_COUNTER_TRACK_STEPS) {
+    period = RIPPLE_COUNTER_TRACK_MIN_PERIOD + RIPPLE_COUNTER_TRACK_STEPS - 1U;
+  }
+  const uint32_t index = period - RIPPLE_COUNTER_TRACK_MIN_PERIOD;
+  return tracking ? &k_tracking[index] : &k_wide[index];
+}
+
+int32_t RippleCounter_GetPosition(const RippleCounter_t *counter) {
+  return (counter != NULL) ? counter->position : 0;
+}
+
+void RippleCounter_SetPosition(RippleCounter_t *counter, int32_t position) {
+  if (counter != NULL) {
+    counter->position = position;
+  }
+}
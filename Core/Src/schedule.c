@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ * @file           :  schedule.c
+ * @brief          :  Weekly heating schedule
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "schedule.h"
+
+#include "utils.h"
+
+#include <stddef.h>
+
+static bool is_day_valid(const WeeklyScheduleTypeDef *weekly, uint8_t day) {
+  const uint8_t count = weekly->num_slots[day];
+  if (count == 0U || count > SCHEDULE_MAX_SLOTS) {
+    return false;
+  }
+  uint16_t previous_start = 0U;
+  for (uint8_t i = 0U; i < count; i++) {
+    const uint16_t slot = weekly->slots[day][i];
+    const uint16_t start = SCHEDULE_SLOT_START(slot);
+    if ((slot & 0x8000U) != 0U || start >= SCHEDULE_DAY_MIN ||
+        SCHEDULE_SLOT_INDEX(slot) > UTILS_TEMP_INDEX_ON) {
+      return false;
+    }
+    /* The first slot starts at midnight, the others strictly later */
+    if ((i == 0U) ? (start != 0U) : (start <= previous_start)) {
+      return false;
+    }
+    previous_start = start;
+  }
+  return true;
+}
+
+void Schedule_LoadDefault(WeeklyScheduleTypeDef *weekly, uint8_t num_slots) {
+  if (weekly == NULL) {
+    return;
+  }
+  DailyScheduleTypeDef daily;
+  Utils_LoadDefaultSchedule(&daily, num_slots);
+  weekly->num_slots[0] = 0U;
+  (void)Schedule_SetDay(weekly, 0U, &daily);
+  Schedule_CopyDay(weekly, 0U, SCHEDULE_MASK_ALL);
+}
+
+bool Schedule_IsValid(const WeeklyScheduleTypeDef *weekly) {
+  if (weekly == NULL) {
+    return false;
+  }
+  for (uint8_t day = 0U; day < SCHEDULE_DAYS; day++) {
+    if (!is_day_valid(weekly, day)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Schedule_GetDay(const WeeklyScheduleTypeDef *weekly, uint8_t day,
+                     DailyScheduleTypeDef *daily) {
+  if (weekly == NULL || daily == NULL || day >= SCHEDULE_DAYS) {
+    return false;
+  }
+  const uint8_t count = weekly->num_slots[day];
+  daily->num_time_slots = count;
+  for (uint8_t i = 0U; i < count && i < SCHEDULE_MAX_SLOTS; i++) {
+    const uint16_t slot = weekly->slots[day][i];
+    const uint16_t start = SCHEDULE_SLOT_START(slot);
+    const uint16_t end = (i + 1U < count)
+                             ? SCHEDULE_SLOT_START(weekly->slots[day][i + 1U])
+                             : (SCHEDULE_DAY_MIN - 1U);
+    TimeSlotTypeDef *out = &daily->time_slots[i];
+    out->start_hour = (uint8_t)(start / 60U);
+    out->start_minute = (uint8_t)(start % 60U);
+    out->end_hour = (uint8_t)(end / 60U);
+    out->end_minute = (uint8_t)(end % 60U);
+    out->temperature = Utils_IndexToTemp(SCHEDULE_SLOT_INDEX(slot));
+  }
+  return true;
+}
+
+bool Schedule_SetDay(WeeklyScheduleTypeDef *weekly, uint8_t day,
+                     const DailyScheduleTypeDef *daily) {
+  if (weekly == NULL || daily == NULL || day >= SCHEDULE_DAYS ||
+      daily->num_time_slots == 0U ||
+      daily->num_time_slots > SCHEDULE_MAX_SLOTS) {
+    return false;
+  }
+
+  WeeklyScheduleTypeDef candidate = *weekly;
+  candidate.num_slots[day] = daily->num_time_slots;
+  for (uint8_t i = 0U; i < SCHEDULE_MAX_SLOTS; i++) {
+    uint16_t slot = 0U;
+    if (i < daily->num_time_slots) {
+      const TimeSlotTypeDef *in = &daily->time_slots[i];
+      const uint16_t start =
+          (uint16_t)(in->start_hour * 60U + in->start_minute);
+      slot = SCHEDULE_SLOT(start, Utils_TempToIndex(in->temperature));
+    }
+    candidate.slots[day][i] = slot;
+  }
+
+  if (!is_day_valid(&candidate, day)) {
+    return false;
+  }
+  *weekly = candidate;
+  return true;
+}
+
+void Schedule_CopyDay(WeeklyScheduleTypeDef *weekly, uint8_t from,
+                      uint8_t to_mask) {
+  if (weekly == NULL || from >= SCHEDULE_DAYS) {
+    return;
+  }
+  for (uint8_t day = 0U; day < SCHEDULE_DAYS; day++) {
+    if (day == from || (to_mask & (1U << day)) == 0U) {
+      continue;
+    }
+    weekly->num_slots[day] = weekly->num_slots[from];
+    for (uint8_t i = 0U; i < SCHEDULE_MAX_SLOTS; i++) {
+      weekly->slots[day][i] = weekly->slots[from][i];
+    }
+  }
+}
+
+bool Schedule_Evaluate(const WeeklyScheduleTypeDef *weekly, uint8_t day,
+                       uint8_t hour, uint8_t minute, ScheduleState_t *state) {
+  if (weekly == NULL || state == NULL || day >= SCHEDULE_DAYS) {
+    return false;
+  }
+  const uint8_t count = weekly->num_slots[day];
+  if (count == 0U || count > SCHEDULE_MAX_SLOTS) {
+    return false;
+  }
+
+  /* Last slot starting at or before now; the first starts at midnight */
+  const uint16_t now = (uint16_t)(hour * 60U + minute);
+  uint8_t current = 0U;
+  for (uint8_t i = 1U; i < count; i++) {
+    if (SCHEDULE_SLOT_START(weekly->slots[day][i]) <= now) {
+      current = i;
+    }
+  }
+  const uint8_t target = SCHEDULE_SLOT_INDEX(weekly->slots[day][current]);
+  state->target_index = target;
+
+  /* Walk the following slot starts for up to a week, until the target
+     changes; a week holds at most SCHEDULE_DAYS * SCHEDULE_MAX_SLOTS */
+  uint8_t next_day = day;
+  uint8_t next_slot = current;
+  uint16_t days_ahead = 0U;
+  for (;;) {
+    next_slot++;
+    if (next_slot >= weekly->num_slots[next_day] ||
+        next_slot >= SCHEDULE_MAX_SLOTS) {
+      next_slot = 0U;
+      next_day = (uint8_t)((next_day + 1U) % SCHEDULE_DAYS);
+      days_ahead++;
+      if (weekly->num_slots[next_day] == 0U) {
+        continue;
+      }
+    }
+    const uint16_t slot = weekly->slots[next_day][next_slot];
+    const bool wrapped = (days_ahead == SCHEDULE_DAYS && next_slot == current);
+    if (SCHEDULE_SLOT_INDEX(slot) != target || wrapped) {
+      const uint16_t start = SCHEDULE_SLOT_START(slot);
+      state->next_index = SCHEDULE_SLOT_INDEX(slot);
+      state->next_day = next_day;
+      state->next_hour = (uint8_t)(start / 60U);
+      state->next_minute = (uint8_t)(start % 60U);
+      state->minutes_to_next =
+          (uint16_t)(days_ahead * SCHEDULE_DAY_MIN + start - now);
+      return true;
+    }
+  }
+}
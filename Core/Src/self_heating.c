@@ -0,0 +1,105 @@
+/**
+ ******************************************************************************
+ * @file           :  self_heating.c
+ * @brief          :  Self-heating compensation of the internal temperature
+ *                    sensor
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "self_heating.h"
+
+#include <stddef.h>
+
+#define Q16_ONE 65536
+
+void SelfHeating_DefaultParams(SelfHeatingParams_t *params) {
+  if (params == NULL) {
+    return;
+  }
+  params->tau_s = SELF_HEATING_DEFAULT_TAU_S;
+  params->cpu_cdeg = SELF_HEATING_DEFAULT_CPU_CDEG;
+  params->display_cdeg = SELF_HEATING_DEFAULT_DISPLAY_CDEG;
+  params->motor_cdeg = SELF_HEATING_DEFAULT_MOTOR_CDEG;
+}
+
+void SelfHeating_Init(SelfHeating_t *model, const SelfHeatingParams_t *params) {
+  if (model == NULL) {
+    return;
+  }
+  if (params != NULL) {
+    model->params = *params;
+  } else {
+    SelfHeating_DefaultParams(&model->params);
+  }
+  for (uint32_t i = 0U; i < SELF_HEATING_SOURCE_COUNT; i++) {
+    model->lag_q16[i] = 0;
+  }
+  model->rise_cdeg = 0;
+}
+
+void SelfHeating_SetParams(SelfHeating_t *model,
+                           const SelfHeatingParams_t *params) {
+  if (model == NULL || params == NULL) {
+    return;
+  }
+  model->params = *params;
+}
+
+int32_t SelfHeating_ActivityQ16(const SelfHeatingActivity_t *activity,
+                                SelfHeatingSource_t source) {
+  switch (source) {
+  case SELF_HEATING_CPU:
+    return (int32_t)(((uint32_t)activity->cpu_permille * Q16_ONE) / 1000U);
+  case SELF_HEATING_DISPLAY:
+    return (int32_t)(((uint32_t)activity->display_bps * Q16_ONE) /
+                     SELF_HEATING_DISPLAY_FULL_BPS);
+  case SELF_HEATING_MOTOR:
+    return (int32_t)(((uint32_t)activity->motor_ma * Q16_ONE) /
+                     SELF_HEATING_MOTOR_FULL_MA);
+  default:
+    return 0;
+  }
+}
+
+int32_t SelfHeating_Update(SelfHeating_t *model,
+                           const SelfHeatingActivity_t *activity) {
+  if (model == NULL || activity == NULL) {
+    return 0;
+  }
+  if (model->params.tau_s == 0U) {
+    model->rise_cdeg = 0;
+    return 0;
+  }
+
+  /* First-order lag per source, the same step as the temperature IIR, so
+     any interval length is stable */
+  const uint64_t tau_ms = (uint64_t)model->params.tau_s * 1000U;
+  const int64_t alpha_q24 =
+      (int64_t)(((uint64_t)activity->period_ms << 24) /
+                (tau_ms + activity->period_ms));
+  const int16_t coefficient[SELF_HEATING_SOURCE_COUNT] = {
+      model->params.cpu_cdeg, model->params.display_cdeg,
+      model->params.motor_cdeg};
+
+  int64_t rise_q16 = 0;
+  for (uint32_t i = 0U; i < SELF_HEATING_SOURCE_COUNT; i++) {
+    const int32_t target =
+        SelfHeating_ActivityQ16(activity, (SelfHeatingSource_t)i);
+    const int64_t error = (int64_t)target - model->lag_q16[i];
+    model->lag_q16[i] += (int32_t)((error * alpha_q24) / (1 << 24));
+    rise_q16 += (int64_t)coefficient[i] * model->lag_q16[i];
+  }
+
+  /* Round to the nearest centidegree */
+  model->rise_cdeg = (int32_t)((rise_q16 + ((rise_q16 >= 0) ? Q16_ONE / 2
+                                                            : -Q16_ONE / 2)) /
+                               Q16_ONE);
+  return model->rise_cdeg;
+}
@@ -0,0 +1,136 @@
+/**
+ ******************************************************************************
+ * @file           :  sensor_calc.c
+ * @brief          :  Conversions from raw ADC samples to physical values
+ *
+ * @details        :  All conversions assume 12-bit resolution, as configured
+ *                    for ADC1 in sensor_task.c.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "sensor_calc.h"
+
+#include "stm32wbxx_hal.h"
+#include "stm32wbxx_ll_adc.h"
+
+#include <stdbool.h>
+
+/* Calculate internal voltage reference from ADC sample */
+uint32_t SensorCalc_VrefVoltage(uint16_t vref_raw) {
+  if (vref_raw == 0U) {
+    return TEMPSENSOR_CAL_VREFANALOG;
+  }
+  return __LL_ADC_CALC_VREFANALOG_VOLTAGE(vref_raw, LL_ADC_RESOLUTION_12B);
+}
+
+/* Convert ADC raw value to millivolts using current VREF calibration */
+uint32_t SensorCalc_RawToMillivolts(uint16_t raw_value, uint32_t vref_mv) {
+  return __LL_ADC_CALC_DATA_TO_VOLTAGE(vref_mv, raw_value,
+                                       LL_ADC_RESOLUTION_12B);
+}
+
+uint32_t SensorCalc_MotorCurrent(uint16_t motor_raw, uint32_t vref_mv) {
+  return (SensorCalc_RawToMillivolts(motor_raw, vref_mv) * 1000U) /
+         SENSOR_CALC_MOTOR_SHUNT_MOHMS;
+}
+
+uint32_t SensorCalc_BatteryVoltage(uint16_t vbat_raw, uint32_t vref_mv) {
+  return SensorCalc_RawToMillivolts(vbat_raw, vref_mv) *
+         SENSOR_CALC_VBAT_DIVIDER;
+}
+
+/* __LL_ADC_CALC_TEMPERATURE() with the slope scaled by 100 before the
+   division, so only the fraction below 0.01 degree is truncated */
+int32_t SensorCalc_TemperatureCenti(uint16_t temperature_raw,
+                                    uint32_t vref_mv) {
+  const int32_t ts_cal1 = (int32_t)*TEMPSENSOR_CAL1_ADDR;
+  const int32_t ts_cal2 = (int32_t)*TEMPSENSOR_CAL2_ADDR;
+  const int32_t scaled = (int32_t)(((uint32_t)temperature_raw * vref_mv) /
+                                   TEMPSENSOR_CAL_VREFANALOG);
+
+  return ((scaled - ts_cal1) *
+          (int32_t)(TEMPSENSOR_CAL2_TEMP - TEMPSENSOR_CAL1_TEMP) * 100) /
+             (ts_cal2 - ts_cal1) +
+         (int32_t)TEMPSENSOR_CAL1_TEMP * 100;
+}
+
+/* Calculate battery state-of-charge percentage from voltage
+   Uses piecewise linear interpolation of 2 AA alkaline discharge curve */
+uint8_t SensorCalc_BatterySoc(uint32_t battery_mv) {
+  typedef struct {
+    uint16_t mv;
+    uint8_t soc;
+  } BatteryPoint;
+
+  /* Discharge curve for 2 AA alkaline batteries (voltage in mV)
+     Doubled from single-battery curve due to 2-cell series configuration */
+  static const BatteryPoint curve[] = {
+      {3200, 100}, /* Freshly out of pack (2 x 1.6V) */
+      {3000, 100}, /* Nominal Full (2 x 1.5V) */
+      {2800, 85},  /* High (2 x 1.4V) */
+      {2600, 60},  /* Mid (2 x 1.3V) */
+      {2400, 35},  /* Low (2 x 1.2V) */
+      {2200, 10},  /* Critical (2 x 1.1V) */
+      {2000, 0}    /* Cutoff (2 x 1.0V) */
+  };
+
+  const uint32_t voltage_mv = battery_mv;
+
+  /* Handle boundary cases */
+  if (voltage_mv >= curve[0].mv)
+    return 100;
+  if (voltage_mv <= curve[6].mv)
+    return 0;
+
+  /* Interpolate between curve points */
+  for (int i = 0; i < 6; i++) {
+    if (voltage_mv >= curve[i + 1].mv) {
+      uint16_t v_high = curve[i].mv;
+      uint16_t v_low = curve[i + 1].mv;
+      uint8_t s_high = curve[i].soc;
+      uint8_t s_low = curve[i + 1].soc;
+
+      /* Linear interpolation: SoC = s_low + (v - v_low) * (s_high - s_low) / (v_high - v_low) */
+      uint32_t soc =
+          s_low + ((uint32_t)(voltage_mv - v_low) * (s_high - s_low)) /
+                      (v_high - v_low);
+
+      return (uint8_t)soc;
+    }
+  }
+
+  return 0;
+}
+
+/* value = mantissa * 2^(exponent - 150); scale by 100 and round in 64 bits */
+int32_t SensorCalc_FloatBitsToCenti(uint32_t bits) {
+  const uint32_t exponent = (bits >> 23) & 0xFFU;
+  const uint32_t fraction = bits & 0x7FFFFFU;
+  const bool negative = (bits & 0x80000000U) != 0U;
+  uint32_t magnitude;
+
+  if (exponent == 0xFFU && fraction != 0U) {
+    return 0; /* NaN */
+  }
+  if (exponent >= 150U) {
+    magnitude = INT16_MAX; /* |value| >= 2^23, or infinity */
+  } else {
+    const uint32_t shift = 150U - exponent;
+    const uint64_t scaled = (uint64_t)(fraction | 0x800000U) * 100U;
+    if (exponent == 0U || shift > 40U) {
+      magnitude = 0U; /* Below 0.005 */
+    } else {
+      const uint64_t rounded = (scaled + (1ULL << (shift - 1U))) >> shift;
+      magnitude = (rounded > INT16_MAX) ? INT16_MAX : (uint32_t)rounded;
+    }
+  }
+
+  return negative ? -(int32_t)magnitude : (int32_t)magnitude;
+}
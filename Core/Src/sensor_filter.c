@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ * @file           :  sensor_filter.c
+ * @brief          :  Median, first-order IIR and slew-rate filter for the
+ *                    ambient temperature
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "sensor_filter.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define MS_PER_MINUTE 60000U
+
+static int16_t clamp_i16(int32_t value) {
+  if (value > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (value < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)value;
+}
+
+/* Q24.8 to integer, rounding half away from zero */
+static int32_t q8_round(int32_t value_q8) {
+  return (value_q8 >= 0) ? (value_q8 + 128) / 256 : (value_q8 - 128) / 256;
+}
+
+static void sanitize(SensorFilterParams_t *params) {
+  if (params->median_n == 0U) {
+    params->median_n = 1U;
+  }
+  if (params->median_n > SENSOR_FILTER_MEDIAN_MAX) {
+    params->median_n = SENSOR_FILTER_MEDIAN_MAX;
+  }
+  if ((params->median_n & 1U) == 0U) {
+    params->median_n = (uint8_t)(params->median_n - 1U);
+  }
+}
+
+static int32_t median(SensorFilter_t *filter, int32_t raw) {
+  filter->window[filter->window_head] = clamp_i16(raw);
+  filter->window_head = (uint8_t)((filter->window_head + 1U) %
+                                  filter->params.median_n);
+  if (filter->window_count < filter->params.median_n) {
+    filter->window_count++;
+  }
+
+  /* Insertion sort of at most SENSOR_FILTER_MEDIAN_MAX values */
+  int16_t sorted[SENSOR_FILTER_MEDIAN_MAX];
+  const uint8_t count = filter->window_count;
+  for (uint8_t i = 0U; i < count; i++) {
+    const int16_t value = filter->window[i];
+    uint8_t j = i;
+    while (j > 0U && sorted[j - 1U] > value) {
+      sorted[j] = sorted[j - 1U];
+      j--;
+    }
+    sorted[j] = value;
+  }
+  return sorted[count / 2U];
+}
+
+/* y += (x - y) * dt / (tau + dt), the backward-Euler step of a first-order
+   low-pass, so a longer interval weights the new sample more */
+static int32_t iir(SensorFilter_t *filter, int32_t value, uint32_t dt_ms) {
+  const uint32_t tau_ms = (uint32_t)filter->params.iir_tau_s * 1000U;
+  int32_t alpha_q8 = (int32_t)(((uint64_t)dt_ms * 256U) / (tau_ms + dt_ms));
+  if (alpha_q8 < 1) {
+    alpha_q8 = 1;
+  }
+  const int64_t error_q8 = (int64_t)value * 256 - filter->iir_q8;
+  filter->iir_q8 += (int32_t)((error_q8 * alpha_q8) / 256);
+  return q8_round(filter->iir_q8);
+}
+
+static int32_t slew(SensorFilter_t *filter, int32_t value, uint32_t dt_ms) {
+  /* Allowance in cdeg * ms / min; the unused part of a limited step carries
+     over, so short intervals still add up to the configured rate */
+  const uint64_t allowance =
+      (uint64_t)filter->params.slew_cdeg_per_min * dt_ms + filter->slew_carry;
+  const int32_t max_step = (allowance / MS_PER_MINUTE > (uint64_t)UINT16_MAX)
+                               ? (int32_t)UINT16_MAX
+                               : (int32_t)(allowance / MS_PER_MINUTE);
+  const int32_t step = value - filter->output;
+
+  if (step > max_step) {
+    filter->slew_carry = (uint32_t)(allowance % MS_PER_MINUTE);
+    return filter->output + max_step;
+  }
+  if (step < -max_step) {
+    filter->slew_carry = (uint32_t)(allowance % MS_PER_MINUTE);
+    return filter->output - max_step;
+  }
+  filter->slew_carry = 0U;
+  return value;
+}
+
+void SensorFilter_DefaultParams(SensorFilterParams_t *params) {
+  if (params == NULL) {
+    return;
+  }
+  params->median_n = SENSOR_FILTER_DEFAULT_MEDIAN;
+  params->iir_tau_s = SENSOR_FILTER_DEFAULT_TAU_S;
+  params->slew_cdeg_per_min = SENSOR_FILTER_DEFAULT_SLEW;
+}
+
+void SensorFilter_Init(SensorFilter_t *filter,
+                       const SensorFilterParams_t *params) {
+  if (filter == NULL) {
+    return;
+  }
+  memset(filter, 0, sizeof(*filter));
+  if (params != NULL) {
+    filter->params = *params;
+  } else {
+    SensorFilter_DefaultParams(&filter->params);
+  }
+  sanitize(&filter->params);
+}
+
+void SensorFilter_SetParams(SensorFilter_t *filter,
+                            const SensorFilterParams_t *params) {
+  if (filter == NULL || params == NULL) {
+    return;
+  }
+  SensorFilterParams_t next = *params;
+  sanitize(&next);
+  if (next.median_n != filter->params.median_n) {
+    filter->window_count = 0U;
+    filter->window_head = 0U;
+  }
+  if (next.iir_tau_s != 0U && filter->params.iir_tau_s == 0U) {
+    /* Resume the IIR from the published value instead of a stale state */
+    filter->iir_q8 = filter->output * 256;
+  }
+  filter->slew_carry = 0U;
+  filter->params = next;
+}
+
+int32_t SensorFilter_Update(SensorFilter_t *filter, int32_t raw_cdeg,
+                            uint32_t dt_ms) {
+  if (filter == NULL) {
+    return raw_cdeg;
+  }
+  const int32_t raw = clamp_i16(raw_cdeg);
+  if (dt_ms == 0U) {
+    dt_ms = 1U;
+  }
+
+  if (!filter->primed) {
+    filter->primed = true;
+    filter->window[0] = (int16_t)raw;
+    filter->window_count = 1U;
+    filter->window_head = (uint8_t)(1U % filter->params.median_n);
+    filter->iir_q8 = raw * 256;
+    filter->slew_carry = 0U;
+    filter->output = raw;
+    return raw;
+  }
+
+  int32_t value = raw;
+  if (filter->params.median_n > 1U) {
+    value = median(filter, value);
+  }
+  if (filter->params.iir_tau_s != 0U) {
+    value = iir(filter, value, dt_ms);
+  }
+  if (filter->params.slew_cdeg_per_min != 0U) {
+    value = slew(filter, value, dt_ms);
+  }
+  filter->output = value;
+  return value;
+}
@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ * @file           :  sensor_sampling.c
+ * @brief          :  Adaptive temperature sampling period
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "sensor_sampling.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#define MS_PER_MINUTE 60000U
+
+static uint32_t min_u32(uint32_t a, uint32_t b) { return (a < b) ? a : b; }
+
+/* Time for the temperature to move by @p cdeg at @p rate */
+static uint32_t time_to_move_ms(uint32_t cdeg, uint32_t rate_cdeg_per_min) {
+  if (rate_cdeg_per_min == 0U) {
+    return UINT32_MAX;
+  }
+  const uint64_t ms = ((uint64_t)cdeg * MS_PER_MINUTE) / rate_cdeg_per_min;
+  return (ms > UINT32_MAX) ? UINT32_MAX : (uint32_t)ms;
+}
+
+uint32_t SensorSampling_ThresholdCdeg(uint8_t soc) {
+  return (soc < SENSOR_SAMPLING_LOW_SOC_PERCENT)
+             ? 2U * SENSOR_SAMPLING_THRESHOLD_CDEG
+             : SENSOR_SAMPLING_THRESHOLD_CDEG;
+}
+
+void SensorSampling_Init(SensorSampling_t *sampling) {
+  if (sampling == NULL) {
+    return;
+  }
+  sampling->anchor_cdeg = 0;
+  sampling->anchor_ms = 0U;
+  sampling->rate_cdeg_per_min = 0;
+  sampling->period_ms = SENSOR_SAMPLING_ACTIVE_PERIOD_MS;
+  sampling->primed = false;
+}
+
+uint32_t SensorSampling_Update(SensorSampling_t *sampling,
+                               const SensorSamplingInput_t *input,
+                               uint32_t now_ms) {
+  if (sampling == NULL || input == NULL) {
+    return SENSOR_SAMPLING_ACTIVE_PERIOD_MS;
+  }
+
+  const int32_t temperature = input->temperature_cdeg;
+  const uint32_t threshold = SensorSampling_ThresholdCdeg(input->soc);
+  uint32_t period = sampling->period_ms;
+
+  if (!sampling->primed) {
+    sampling->primed = true;
+    sampling->anchor_cdeg = temperature;
+    sampling->anchor_ms = now_ms;
+    sampling->rate_cdeg_per_min = 0;
+    period = SENSOR_SAMPLING_ACTIVE_PERIOD_MS;
+  } else {
+    uint32_t span_ms = now_ms - sampling->anchor_ms;
+    if (span_ms == 0U) {
+      span_ms = 1U;
+    }
+    const int32_t change = temperature - sampling->anchor_cdeg;
+    sampling->rate_cdeg_per_min =
+        (int32_t)(((int64_t)change * MS_PER_MINUTE) / span_ms);
+
+    if ((uint32_t)abs(change) * 2U >= threshold) {
+      /* Moving: look closer and measure the rate from here */
+      sampling->anchor_cdeg = temperature;
+      sampling->anchor_ms = now_ms;
+      period /= 2U;
+    } else {
+      /* Stable: back off; the anchor stays, so a slow drift adds up */
+      period = (period > UINT32_MAX / 2U) ? UINT32_MAX : period * 2U;
+    }
+  }
+
+  const uint32_t rate = (uint32_t)abs(sampling->rate_cdeg_per_min);
+
+  /* Never let more than the threshold pass unseen */
+  uint32_t assumed_rate = rate * 2U;
+  if (assumed_rate < SENSOR_SAMPLING_MAX_SLEW_CDEG_PER_MIN) {
+    assumed_rate = SENSOR_SAMPLING_MAX_SLEW_CDEG_PER_MIN;
+  }
+  period = min_u32(period, time_to_move_ms(threshold, assumed_rate));
+  period = min_u32(period, (input->soc < SENSOR_SAMPLING_LOW_SOC_PERCENT)
+                               ? SENSOR_SAMPLING_LOW_SOC_MAX_PERIOD_MS
+                               : SENSOR_SAMPLING_MAX_PERIOD_MS);
+
+  /* Fast while changing quickly or about to cross the setpoint */
+  if (rate >= SENSOR_SAMPLING_FAST_RATE_CDEG_PER_MIN) {
+    period = SENSOR_SAMPLING_FAST_PERIOD_MS;
+  } else if (input->setpoint_cdeg != SENSOR_SAMPLING_NO_SETPOINT &&
+             rate != 0U) {
+    const int32_t distance = input->setpoint_cdeg - temperature;
+    const bool approaching =
+        (distance > 0) == (sampling->rate_cdeg_per_min > 0);
+    if (approaching) {
+      period =
+          min_u32(period, time_to_move_ms((uint32_t)abs(distance), rate));
+    }
+  }
+
+  if (input->user_active) {
+    period = min_u32(period, SENSOR_SAMPLING_ACTIVE_PERIOD_MS);
+  }
+  if (period < SENSOR_SAMPLING_FAST_PERIOD_MS) {
+    period = SENSOR_SAMPLING_FAST_PERIOD_MS;
+  }
+
+  sampling->period_ms = period;
+  return period;
+}
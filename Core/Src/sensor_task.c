@@ -19,15 +19,29 @@
 #include "sensor_task.h"
 
 #include "FreeRTOS.h"
+#include "adc_snapshot.h"
+#include "battery_estimator.h"
 #include "cmsis_os2.h"
+#include "energy.h"
+#include "ipc_profile.h"
+#include "log_task.h"
 #include "main.h"
+#include "motor.h"
+#include "motor_guard.h"
+#include "replay.h"
+#include "ripple_counter.h"
+#include "self_heating.h"
+#include "sensor_calc.h"
+#include "sensor_filter.h"
+#include "sensor_sampling.h"
 #include "stm32wbxx_hal.h"
 #include "stm32wbxx_hal_adc_ex.h"
-#include "stm32wbxx_ll_adc.h"
 #include "storage_task.h"
 #include "task.h"
 #include "task_debug.h"
 #include "tests.h"
+#include "trace.h"
+#include "window_detect.h"
 
 #include <stddef.h>
 #include <string.h>
@@ -39,12 +53,43 @@
 #define SENSOR_TASK_TEMPERATURE_CHANNEL_INDEX 2U
 #define SENSOR_TASK_VBAT_CHANNEL_INDEX 3U
 
-/* Motor shunt resistance and battery divider */
-#define SENSOR_TASK_MOTOR_SHUNT_OHMS 0.22f
-#define SENSOR_TASK_VBAT_DIVIDER 3.0f
+/* Thread flag that ends the sensor task's wait before its period is over */
+#define SENSOR_TASK_FLAG_WAKE 0x0001U
+/* Thread flag set by the DMA-complete interrupt of a triggered sequence */
+#define SENSOR_TASK_FLAG_ADC_DONE 0x0002U
 
-/* DMA buffer for ADC conversions */
-static uint16_t s_adc_dma_buffer[SENSOR_TASK_ADC_CHANNEL_COUNT];
+#if SENSOR_TASK_ADC_CHANNEL_COUNT != REPLAY_ADC_CHANNELS
+#error "Replay records must hold one complete ADC sequence"
+#endif
+#if SENSOR_TASK_ADC_CHANNEL_COUNT != ADC_SNAPSHOT_CHANNELS
+#error "ADC snapshots must hold one complete ADC sequence"
+#endif
+
+/* Circular DMA buffer of two sequences: the DMA fills one half while the
+   other is published as a snapshot */
+static uint16_t s_adc_dma_buffer[2][SENSOR_TASK_ADC_CHANNEL_COUNT];
+
+/* The ADC converts continuously only while motor measurements are enabled;
+   otherwise it sits in deep power-down between triggered sequences */
+static bool s_adc_continuous = false;
+/* Set while the sensor task waits for a sequence to complete */
+static volatile bool s_adc_waiting = false;
+
+/* Motor protection, checked in the DMA interrupt of every continuous
+   sequence; the owner task is told about a cut-off */
+static MotorGuard_t s_motor_guard;
+static MotorStateTypeDef s_guarded_state = MOTOR_COAST;
+static MotorGuardReason_t s_motor_trip = MOTOR_GUARD_OK;
+static osThreadId_t s_motor_owner = NULL;
+static uint32_t s_motor_owner_flags = 0U;
+
+/* Valve position from the commutation ripples of the motor current, counted
+   in the same interrupt; a move staged by SensorTask_MoveMotor() is started
+   there so that the counter sees the run from its first sample. Tasks
+   change the motor state only through the SensorTask_*Motor() calls. */
+static RippleCounter_t s_ripple_counter;
+static int8_t s_move_direction = 0;
+static uint32_t s_move_ripples = 0U;
 
 /* Thread-safe access to sensor values and configuration */
 static SensorModel_t *s_sensor_model = NULL;
@@ -57,6 +102,52 @@ static bool s_motor_measurements_enabled = true;
 static bool s_motor_measurements_enabled = false;
 #endif
 
+/* Ambient temperature filter; parameters changed by other tasks are staged
+   and applied by the sensor task on its next temperature measurement */
+static SensorFilter_t s_temperature_filter;
+static SensorFilterParams_t s_filter_params = {
+    .median_n = SENSOR_FILTER_DEFAULT_MEDIAN,
+    .iir_tau_s = SENSOR_FILTER_DEFAULT_TAU_S,
+    .slew_cdeg_per_min = SENSOR_FILTER_DEFAULT_SLEW};
+static bool s_filter_params_changed = false;
+static uint32_t s_last_temperature_tick = 0U;
+
+/* Rise of the sensor above the room, estimated from the activity since the
+   previous temperature measurement; staged like the filter parameters */
+static SelfHeating_t s_self_heating;
+static SelfHeatingParams_t s_self_heating_params = {
+    .tau_s = SELF_HEATING_DEFAULT_TAU_S,
+    .cpu_cdeg = SELF_HEATING_DEFAULT_CPU_CDEG,
+    .display_cdeg = SELF_HEATING_DEFAULT_DISPLAY_CDEG,
+    .motor_cdeg = SELF_HEATING_DEFAULT_MOTOR_CDEG};
+static bool s_self_heating_params_changed = false;
+static EnergyCounters_t s_last_counters;
+
+/* Battery state of charge, compensated for the motor load */
+static BatteryEstimator_t s_battery_estimator;
+
+/* Adaptive temperature period and what it depends on besides the
+   measurements: the setpoint (system task) and user input (view presenter) */
+static SensorSampling_t s_sampling;
+
+/* Recent filtered temperatures, for the open-window detection */
+static WindowSlope_t s_window_slope;
+static uint32_t s_sampling_period_ms = SENSOR_SAMPLING_ACTIVE_PERIOD_MS;
+static int32_t s_setpoint_cdeg = SENSOR_SAMPLING_NO_SETPOINT;
+static uint32_t s_last_activity_tick = 0U;
+static osThreadId_t s_sensor_thread = NULL;
+
+/* Tasks woken when the published values change by their thresholds */
+typedef struct {
+  osThreadId_t thread;         /**< Subscribed task, NULL if the slot is free */
+  uint32_t flags;              /**< Thread flags set on a change */
+  SensorThresholds_t thresholds;
+  SensorData_t notified;       /**< Values of the last notification */
+  bool primed;                 /**< Notified at least once */
+} SensorSubscriber_t;
+
+static SensorSubscriber_t s_subscribers[SENSOR_TASK_MAX_SUBSCRIBERS];
+
 extern ADC_HandleTypeDef hadc1;
 
 /* Convert milliseconds to FreeRTOS ticks, ensuring minimum of 1 tick */
@@ -65,89 +156,467 @@ static TickType_t safe_ms_to_ticks(uint32_t ms) {
   return pdMS_TO_TICKS(safe_ms);
 }
 
-/* Calculate internal voltage reference from ADC sample */
-static uint32_t calculate_vref_voltage(uint16_t vref_raw) {
-  if (vref_raw == 0U) {
-    return TEMPSENSOR_CAL_VREFANALOG;
+static uint32_t ticks_to_ms(uint32_t ticks) {
+  return (uint32_t)(((uint64_t)ticks * 1000U) / configTICK_RATE_HZ);
+}
+
+/* End the sensor task's wait so it measures now */
+static void wake_sensor_task(void) {
+  if (s_sensor_thread != NULL) {
+    (void)osThreadFlagsSet(s_sensor_thread, SENSOR_TASK_FLAG_WAKE);
+  }
+}
+
+/* Check the motor current of a continuous sequence. Cut the motor off here
+   instead of waiting for the sensor task's next MOTOR_MEAS_PERIOD_MS
+   iteration. */
+static bool motor_driven(MotorStateTypeDef state) {
+  return state == MOTOR_FORWARD || state == MOTOR_BACKWARD;
+}
+
+/* Brake the motor from the interrupt and tell the owner; @p reason stays
+   MOTOR_GUARD_OK when a move reached its target */
+static void brake_motor(MotorGuardReason_t reason, uint32_t run_on_us) {
+  Motor_SetState(MOTOR_BRAKE);
+  s_guarded_state = MOTOR_BRAKE;
+  RippleCounter_Stop(&s_ripple_counter, run_on_us);
+  s_motor_trip = reason;
+  if (s_motor_owner != NULL) {
+    (void)osThreadFlagsSet(s_motor_owner, s_motor_owner_flags);
+  }
+}
+
+static void guard_motor(const uint16_t *sequence) {
+  uint32_t target = 0U;
+  if (s_move_direction != 0) {
+    Motor_SetState((s_move_direction > 0) ? MOTOR_FORWARD : MOTOR_BACKWARD);
+    target = s_move_ripples;
+    s_move_direction = 0;
+  }
+
+  const MotorStateTypeDef state = Motor_GetState();
+  if (!motor_driven(state)) {
+    if (motor_driven(s_guarded_state)) {
+      /* Stopped by a task: the motor turns on a little after the cut */
+      RippleCounter_Stop(&s_ripple_counter, (state == MOTOR_COAST)
+                                                ? RIPPLE_COUNTER_COAST_US
+                                                : RIPPLE_COUNTER_BRAKE_US);
+    }
+    s_guarded_state = state;
+    return;
+  }
+  if (state != s_guarded_state || target != 0U) {
+    /* Started, reversed or given a new move: blank the inrush current */
+    if (state != s_guarded_state) {
+      MotorGuard_Start(&s_motor_guard);
+    }
+    if (motor_driven(s_guarded_state)) {
+      /* A reversal brakes the old run; a new move in the same direction
+         carries on from where it is */
+      RippleCounter_Stop(&s_ripple_counter, (state != s_guarded_state)
+                                                ? RIPPLE_COUNTER_BRAKE_US
+                                                : 0U);
+    }
+    RippleCounter_Start(&s_ripple_counter,
+                        (state == MOTOR_FORWARD) ? 1 : -1, target);
+    s_guarded_state = state;
+  }
+
+  const uint32_t vref_mv =
+      SensorCalc_VrefVoltage(sequence[SENSOR_TASK_VREF_CHANNEL_INDEX]);
+  const uint32_t current_ma = SensorCalc_MotorCurrent(
+      sequence[SENSOR_TASK_MOTOR_CHANNEL_INDEX], vref_mv);
+  MotorGuardReason_t reason = MotorGuard_Update(
+      &s_motor_guard, current_ma, SENSOR_TASK_MOTOR_SEQUENCE_US);
+  if (reason == MOTOR_GUARD_OK) {
+    (void)RippleCounter_Update(&s_ripple_counter, current_ma);
+    /* Below the guard's threshold on a weak battery, a blocked valve
+       shows as ripples that stop */
+    if (RippleCounter_Stalled(&s_ripple_counter)) {
+      reason = MOTOR_GUARD_STALL;
+    }
+  }
+  if (reason != MOTOR_GUARD_OK) {
+    /* A blocked motor does not run on */
+    brake_motor(reason, 0U);
+  } else if (RippleCounter_TargetReached(&s_ripple_counter)) {
+    brake_motor(MOTOR_GUARD_OK, RIPPLE_COUNTER_BRAKE_US);
+  }
+}
+
+/* A whole sequence is in one half of s_adc_dma_buffer while the DMA fills
+   the other: publish it, check the motor and end the wait for it */
+static void adc_sequence_done(const uint16_t *sequence) {
+  AdcSnapshot_Publish(sequence);
+  if (s_adc_continuous) {
+    guard_motor(sequence);
+  }
+  if (s_adc_waiting) {
+    s_adc_waiting = false;
+    (void)osThreadFlagsSet(s_sensor_thread, SENSOR_TASK_FLAG_ADC_DONE);
+  }
+}
+
+/* DMA half transfer: a sequence in the first half */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+  if (hadc == &hadc1) {
+    adc_sequence_done(s_adc_dma_buffer[0]);
+  }
+}
+
+/* DMA transfer complete: a sequence in the second half */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+  if (hadc == &hadc1) {
+    adc_sequence_done(s_adc_dma_buffer[1]);
   }
-  return __LL_ADC_CALC_VREFANALOG_VOLTAGE(vref_raw, LL_ADC_RESOLUTION_12B);
 }
 
-/* Convert ADC raw value to voltage using current VREF calibration */
-static float convert_raw_to_voltage(uint16_t raw_value, uint32_t vref_mv) {
-  const uint32_t millivolt =
-      __LL_ADC_CALC_DATA_TO_VOLTAGE(vref_mv, raw_value, LL_ADC_RESOLUTION_12B);
-  return (float)millivolt * 0.001f;
+/* Power the ADC up in the given mode, start it and block until the first
+   sequence has been transferred. The calibration is lost in deep
+   power-down, so it is repeated every time (a few microseconds). The
+   continuous sequence is oversampled less, so the motor guard gets a
+   current sample every SENSOR_TASK_MOTOR_SEQUENCE_US. */
+static void adc_start(FunctionalState continuous) {
+  hadc1.Init.ContinuousConvMode = continuous;
+  hadc1.Init.Oversampling.Ratio = (continuous == ENABLE)
+                                      ? ADC_OVERSAMPLING_RATIO_4
+                                      : ADC_OVERSAMPLING_RATIO_256;
+  hadc1.Init.Oversampling.RightBitShift = (continuous == ENABLE)
+                                              ? ADC_RIGHTBITSHIFT_2
+                                              : ADC_RIGHTBITSHIFT_8;
+  if (HAL_ADC_Init(&hadc1) != HAL_OK ||
+      HAL_ADCEx_Calibration_Start(&hadc1, ADC_SINGLE_ENDED) != HAL_OK) {
+    Error_Handler();
+  }
+
+  (void)osThreadFlagsClear(SENSOR_TASK_FLAG_ADC_DONE);
+  s_adc_waiting = true;
+  if (HAL_ADC_Start_DMA(&hadc1, (uint32_t *)s_adc_dma_buffer,
+                        2U * SENSOR_TASK_ADC_CHANNEL_COUNT) != HAL_OK) {
+    Error_Handler();
+  }
+
+  const uint32_t flags =
+      osThreadFlagsWait(SENSOR_TASK_FLAG_ADC_DONE, osFlagsWaitAny,
+                        safe_ms_to_ticks(SENSOR_TASK_ADC_TIMEOUT_MS));
+  s_adc_waiting = false;
+  if ((flags & osFlagsError) != 0U) {
+    DLOG("SensorTask: ADC sequence timed out, keeping last samples\n");
+  }
 }
 
-static float calculate_temperature(uint16_t temperature_raw, uint32_t vref_mv) {
-  const int32_t temperature = __LL_ADC_CALC_TEMPERATURE(
-      vref_mv, temperature_raw, LL_ADC_RESOLUTION_12B);
+/* Stop the conversions and switch the ADC and its regulator off */
+static void adc_power_down(void) {
+  if (HAL_ADC_Stop_DMA(&hadc1) != HAL_OK ||
+      HAL_ADCEx_EnterADCDeepPowerDownMode(&hadc1) != HAL_OK) {
+    Error_Handler();
+  }
+}
 
-  /* Read temperature offset from config model */
-  float offset = 0.0f;
-  if (osMutexAcquire(s_config_model->mutex, osWaitForever) == osOK) {
-    offset = s_config_model->data.temperature_offset;
-    osMutexRelease(s_config_model->mutex);
+/* Snapshot of one complete ADC sequence. While motor measurements are
+   enabled the ADC runs continuously and the latest sequence is taken;
+   otherwise one sequence is triggered and the ADC powered down after it. */
+static void acquire_adc(bool continuous, AdcSnapshot_t *snapshot) {
+  if (continuous && !s_adc_continuous) {
+    adc_start(ENABLE);
+    s_adc_continuous = true;
+  } else if (!continuous) {
+    if (s_adc_continuous) {
+      adc_power_down();
+      s_adc_continuous = false;
+    }
+    adc_start(DISABLE);
+    adc_power_down();
+    Energy_AddAdcSequences(1U);
+  }
+  if (!AdcSnapshot_Read(snapshot)) {
+    memset(snapshot, 0, sizeof(*snapshot));
   }
+}
 
-  return (float)temperature + offset;
+/* Activity since the previous temperature measurement, from the energy
+   counters of the Energy_Update() just before it */
+static void measure_activity(SelfHeatingActivity_t *activity) {
+  EnergyCounters_t counters;
+  Energy_GetCounters(&counters);
+
+  const uint64_t elapsed_ms = counters.elapsed_ms - s_last_counters.elapsed_ms;
+  memset(activity, 0, sizeof(*activity));
+  activity->period_ms =
+      (elapsed_ms > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed_ms;
+  if (elapsed_ms > 0U) {
+    const uint64_t awake_ms = counters.awake_ms - s_last_counters.awake_ms;
+    const uint64_t display_bytes =
+        counters.display_bytes - s_last_counters.display_bytes;
+    /* nC per ms is uA */
+    const uint64_t motor_ua =
+        (counters.motor_nc - s_last_counters.motor_nc) / elapsed_ms;
+    const uint64_t cpu = (awake_ms * 1000U) / elapsed_ms;
+    const uint64_t bps = (display_bytes * 1000U) / elapsed_ms;
+    activity->cpu_permille = (uint16_t)((cpu > 1000U) ? 1000U : cpu);
+    activity->display_bps = (uint16_t)((bps > UINT16_MAX) ? UINT16_MAX : bps);
+    activity->motor_ma =
+        (uint16_t)((motor_ua / 1000U > UINT16_MAX) ? UINT16_MAX
+                                                    : motor_ua / 1000U);
+  }
+  s_last_counters = counters;
 }
 
-/* Calculate battery state-of-charge percentage from voltage
-   Uses piecewise linear interpolation of 2 AA alkaline discharge curve */
-static uint8_t calculate_battery_soc(float battery_voltage_v) {
-  typedef struct {
-    uint16_t mv;
-    uint8_t soc;
-  } BatteryPoint;
+/* Filtered temperature in centidegrees with the configured offset applied;
+   the unfiltered one is stored to @p raw_cdeg. The self-heating rise is
+   subtracted before the filter, the offset added after it so that changing
+   it moves the display at once. */
+static int32_t calculate_temperature(uint16_t temperature_raw,
+                                     uint32_t vref_mv, int32_t *raw_cdeg) {
+  SelfHeatingParams_t heating_params;
+  bool heating_changed;
+  taskENTER_CRITICAL();
+  heating_params = s_self_heating_params;
+  heating_changed = s_self_heating_params_changed;
+  s_self_heating_params_changed = false;
+  taskEXIT_CRITICAL();
+  if (heating_changed) {
+    SelfHeating_SetParams(&s_self_heating, &heating_params);
+  }
+
+  /* Activity behind this sample (replaced by a host replay) */
+  SelfHeatingActivity_t activity;
+  measure_activity(&activity);
+  REPLAY_ACTIVITY(&activity);
+  const int32_t rise = SelfHeating_Update(&s_self_heating, &activity);
+
+  const int32_t temperature =
+      SensorCalc_TemperatureCenti(temperature_raw, vref_mv) - rise;
+
+  SensorFilterParams_t params;
+  bool params_changed;
+  taskENTER_CRITICAL();
+  params = s_filter_params;
+  params_changed = s_filter_params_changed;
+  s_filter_params_changed = false;
+  taskEXIT_CRITICAL();
+  if (params_changed) {
+    SensorFilter_SetParams(&s_temperature_filter, &params);
+  }
+
+  const uint32_t now = osKernelGetTickCount();
+  const uint32_t elapsed_ms = ticks_to_ms(now - s_last_temperature_tick);
+  s_last_temperature_tick = now;
+  const int32_t filtered =
+      SensorFilter_Update(&s_temperature_filter, temperature, elapsed_ms);
+
+  /* Read temperature offset from config model (copied as bits: no FPU use) */
+  uint32_t offset_bits = 0U;
+  if (IPC_MUTEX_ACQUIRE(s_config_model->mutex, osWaitForever) == osOK) {
+    memcpy(&offset_bits, &s_config_model->data.temperature_offset,
+           sizeof(offset_bits));
+    IPC_MUTEX_RELEASE(s_config_model->mutex);
+  }
+
+  const int32_t offset = SensorCalc_FloatBitsToCenti(offset_bits);
+  *raw_cdeg = temperature + offset;
+  return filtered + offset;
+}
 
-  /* Discharge curve for 2 AA alkaline batteries (voltage in mV)
-     Doubled from single-battery curve due to 2-cell series configuration */
-  static const BatteryPoint curve[] = {
-      {3200, 100}, /* Freshly out of pack (2 x 1.6V) */
-      {3000, 100}, /* Nominal Full (2 x 1.5V) */
-      {2800, 85},  /* High (2 x 1.4V) */
-      {2600, 60},  /* Mid (2 x 1.3V) */
-      {2400, 35},  /* Low (2 x 1.2V) */
-      {2200, 10},  /* Critical (2 x 1.1V) */
-      {2000, 0}    /* Cutoff (2 x 1.0V) */
+/* State of charge from a battery sample and the motor load at the time */
+static uint8_t estimate_battery_soc(uint32_t battery_mv, uint32_t current_ma,
+                                    bool motor_running) {
+  const BatteryEstimatorInput_t input = {
+      .battery_mv = battery_mv,
+      .current_ma = current_ma,
+      .period_ms = MOTOR_MEAS_PERIOD_MS,
+      .motor_running = motor_running,
   };
+  return BatteryEstimator_Update(&s_battery_estimator, &input,
+                                 ticks_to_ms(osKernelGetTickCount()));
+}
+
+/* Stage new filter parameters for the sensor task */
+void SensorTask_SetTemperatureFilter(const SensorFilterParams_t *params) {
+  if (params == NULL) {
+    return;
+  }
+  taskENTER_CRITICAL();
+  s_filter_params = *params;
+  s_filter_params_changed = true;
+  taskEXIT_CRITICAL();
+}
+
+/* Stage new self-heating coefficients for the sensor task */
+void SensorTask_SetSelfHeating(const SelfHeatingParams_t *params) {
+  if (params == NULL) {
+    return;
+  }
+  taskENTER_CRITICAL();
+  s_self_heating_params = *params;
+  s_self_heating_params_changed = true;
+  taskEXIT_CRITICAL();
+}
+
+/* Read the self-heating coefficients last set */
+void SensorTask_GetSelfHeating(SelfHeatingParams_t *params) {
+  if (params == NULL) {
+    return;
+  }
+  taskENTER_CRITICAL();
+  *params = s_self_heating_params;
+  taskEXIT_CRITICAL();
+}
+
+/* Time to the next temperature measurement while the motor is idle */
+static uint32_t next_sampling_period(int32_t temperature_cdeg, uint8_t soc) {
+  const uint32_t now = osKernelGetTickCount();
+  SensorSamplingInput_t input = {.temperature_cdeg = temperature_cdeg,
+                                 .soc = soc};
+
+  taskENTER_CRITICAL();
+  input.setpoint_cdeg = s_setpoint_cdeg;
+  input.user_active = (now - s_last_activity_tick) <
+                      pdMS_TO_TICKS(SENSOR_SAMPLING_ACTIVE_MS);
+  taskEXIT_CRITICAL();
+
+  return SensorSampling_Update(&s_sampling, &input, ticks_to_ms(now));
+}
 
-  /* Convert from volts to millivolts */
-  uint16_t voltage_mv = (uint16_t)(battery_voltage_v * 1000.0f);
-
-  /* Handle boundary cases */
-  if (voltage_mv >= curve[0].mv)
-    return 100;
-  if (voltage_mv <= curve[6].mv)
-    return 0;
-
-  /* Interpolate between curve points */
-  for (int i = 0; i < 6; i++) {
-    if (voltage_mv >= curve[i + 1].mv) {
-      uint16_t v_high = curve[i].mv;
-      uint16_t v_low = curve[i + 1].mv;
-      uint8_t s_high = curve[i].soc;
-      uint8_t s_low = curve[i + 1].soc;
-
-      /* Linear interpolation: SoC = s_low + (v - v_low) * (s_high - s_low) / (v_high - v_low) */
-      uint32_t soc =
-          s_low + ((uint32_t)(voltage_mv - v_low) * (s_high - s_low)) /
-                      (v_high - v_low);
-
-      return (uint8_t)soc;
+/* Setpoint the sampling period watches for crossings */
+void SensorTask_SetSetpoint(int32_t setpoint_cdeg) {
+  taskENTER_CRITICAL();
+  s_setpoint_cdeg = setpoint_cdeg;
+  taskEXIT_CRITICAL();
+}
+
+/* User input: measure now if the device was unattended, then keep the
+   display fresh while it is operated */
+void SensorTask_NotifyUserActivity(void) {
+  const uint32_t now = osKernelGetTickCount();
+  bool was_idle;
+
+  taskENTER_CRITICAL();
+  was_idle = (now - s_last_activity_tick) >=
+             pdMS_TO_TICKS(SENSOR_SAMPLING_ACTIVE_MS);
+  s_last_activity_tick = now;
+  taskEXIT_CRITICAL();
+
+  if (was_idle) {
+    wake_sensor_task();
+  }
+}
+
+/* Read the filter parameters last set */
+void SensorTask_GetTemperatureFilter(SensorFilterParams_t *params) {
+  if (params == NULL) {
+    return;
+  }
+  taskENTER_CRITICAL();
+  *params = s_filter_params;
+  taskEXIT_CRITICAL();
+}
+
+static bool exceeds(int32_t notified, int32_t current, uint32_t threshold) {
+  if (threshold == 0U) {
+    return false;
+  }
+  const uint32_t change = (current >= notified)
+                              ? (uint32_t)(current - notified)
+                              : (uint32_t)(notified - current);
+  return change >= threshold;
+}
+
+bool SensorTask_ExceedsThresholds(const SensorThresholds_t *thresholds,
+                                  const SensorData_t *notified,
+                                  const SensorData_t *current) {
+  if (thresholds == NULL || notified == NULL || current == NULL) {
+    return false;
+  }
+  /* The first sample always counts, whatever its distance to the 0 before */
+  return notified->temperature_valid != current->temperature_valid ||
+         exceeds(notified->ambient_temperature_cdeg,
+                 current->ambient_temperature_cdeg,
+                 thresholds->temperature_cdeg) ||
+         exceeds(notified->motor_current_ma, current->motor_current_ma,
+                 thresholds->motor_current_ma) ||
+#if DRIVER_TEST
+         exceeds(notified->battery_mv, current->battery_mv,
+                 thresholds->battery_mv) ||
+#endif
+         exceeds(notified->soc, current->soc, thresholds->soc) ||
+         exceeds(notified->battery_days, current->battery_days,
+                 thresholds->battery_days);
+}
+
+/* Register the calling task in a free subscriber slot */
+int32_t SensorTask_Subscribe(uint32_t flags,
+                             const SensorThresholds_t *thresholds) {
+  const osThreadId_t thread = osThreadGetId();
+  if (thresholds == NULL || flags == 0U || thread == NULL) {
+    return -1;
+  }
+
+  int32_t subscription = -1;
+  taskENTER_CRITICAL();
+  for (uint32_t i = 0U; i < SENSOR_TASK_MAX_SUBSCRIBERS; i++) {
+    SensorSubscriber_t *subscriber = &s_subscribers[i];
+    if (subscriber->thread == NULL) {
+      subscriber->thread = thread;
+      subscriber->flags = flags;
+      subscriber->thresholds = *thresholds;
+      subscriber->primed = false;
+      subscription = (int32_t)i;
+      break;
     }
   }
+  taskEXIT_CRITICAL();
+
+  if (subscription < 0) {
+    DLOG("SensorTask: no free subscriber slot\n");
+  }
+  return subscription;
+}
+
+void SensorTask_Unsubscribe(int32_t subscription) {
+  if (subscription < 0 ||
+      (uint32_t)subscription >= SENSOR_TASK_MAX_SUBSCRIBERS) {
+    return;
+  }
+  taskENTER_CRITICAL();
+  s_subscribers[subscription].thread = NULL;
+  taskEXIT_CRITICAL();
+}
 
-  return 0;
+/* Wake the subscribers the published values changed enough for. Called
+   after the model mutex is released, so a woken reader does not block. */
+static void notify_subscribers(const SensorData_t *published) {
+  for (uint32_t i = 0U; i < SENSOR_TASK_MAX_SUBSCRIBERS; i++) {
+    SensorSubscriber_t *subscriber = &s_subscribers[i];
+    osThreadId_t thread = NULL;
+    uint32_t flags = 0U;
+
+    taskENTER_CRITICAL();
+    if (subscriber->thread != NULL &&
+        (!subscriber->primed ||
+         SensorTask_ExceedsThresholds(&subscriber->thresholds,
+                                      &subscriber->notified, published))) {
+      subscriber->notified = *published;
+      subscriber->primed = true;
+      thread = subscriber->thread;
+      flags = subscriber->flags;
+    }
+    taskEXIT_CRITICAL();
+
+    if (thread != NULL) {
+      (void)osThreadFlagsSet(thread, flags);
+    }
+  }
 }
 
+
 /* Enable motor current measurements */
 void SensorTask_StartMotorMeasurements(void) {
   taskENTER_CRITICAL();
   s_motor_measurements_enabled = true;
   taskEXIT_CRITICAL();
+  /* Do not wait out a long temperature period */
+  wake_sensor_task();
 }
 
 /* Disable motor current measurements */
@@ -157,6 +626,67 @@ void SensorTask_StopMotorMeasurements(void) {
   taskEXIT_CRITICAL();
 }
 
+/* The critical sections below also mask the DMA interrupt */
+void SensorTask_SetMotorGuard(const MotorGuardConfig_t *config) {
+  if (config == NULL) {
+    return;
+  }
+  taskENTER_CRITICAL();
+  MotorGuard_SetConfig(&s_motor_guard, config);
+  taskEXIT_CRITICAL();
+}
+
+void SensorTask_SetMotorGuardOwner(uint32_t flags) {
+  const osThreadId_t owner = (flags != 0U) ? osThreadGetId() : NULL;
+  taskENTER_CRITICAL();
+  s_motor_owner = owner;
+  s_motor_owner_flags = flags;
+  taskEXIT_CRITICAL();
+}
+
+MotorGuardReason_t SensorTask_TakeMotorTrip(void) {
+  taskENTER_CRITICAL();
+  const MotorGuardReason_t reason = s_motor_trip;
+  s_motor_trip = MOTOR_GUARD_OK;
+  taskEXIT_CRITICAL();
+  return reason;
+}
+
+bool SensorTask_MoveMotor(int8_t direction, uint32_t ripples) {
+  if (direction == 0 || ripples == 0U) {
+    return false;
+  }
+  taskENTER_CRITICAL();
+  s_move_direction = (direction > 0) ? 1 : -1;
+  s_move_ripples = ripples;
+  s_motor_measurements_enabled = true;
+  taskEXIT_CRITICAL();
+  wake_sensor_task();
+  return true;
+}
+
+void SensorTask_StopMotor(void) {
+  /* Masks the DMA interrupt, the other writer of the motor state; it
+     counts the run-on with its next sequence */
+  taskENTER_CRITICAL();
+  s_move_direction = 0;
+  Motor_SetState(MOTOR_COAST);
+  taskEXIT_CRITICAL();
+}
+
+int32_t SensorTask_GetValvePosition(void) {
+  taskENTER_CRITICAL();
+  const int32_t position = RippleCounter_GetPosition(&s_ripple_counter);
+  taskEXIT_CRITICAL();
+  return position;
+}
+
+void SensorTask_SetValvePosition(int32_t position) {
+  taskENTER_CRITICAL();
+  RippleCounter_SetPosition(&s_ripple_counter, position);
+  taskEXIT_CRITICAL();
+}
+
 /* Main sensor measurement task
    Acquires ADC samples, performs calculations, updates sensor values via mutex */
 void StartSensorTask(void *argument) {
@@ -181,21 +711,26 @@ void StartSensorTask(void *argument) {
     Error_Handler();
   }
 
-  /* Calibrate ADC and start DMA conversions */
-  if (HAL_ADCEx_Calibration_Start(&hadc1, ADC_SINGLE_ENDED) != HAL_OK) {
-    Error_Handler();
-  }
+  SensorFilter_Init(&s_temperature_filter, &s_filter_params);
+  SelfHeating_Init(&s_self_heating, &s_self_heating_params);
+  Energy_GetCounters(&s_last_counters);
+  SensorSampling_Init(&s_sampling);
+  WindowSlope_Init(&s_window_slope);
+  BatteryEstimator_Init(&s_battery_estimator);
+  taskENTER_CRITICAL();
+  MotorGuard_Init(&s_motor_guard, NULL);
+  RippleCounter_Init(&s_ripple_counter, SENSOR_TASK_MOTOR_SEQUENCE_US);
+  taskEXIT_CRITICAL();
+  s_sensor_thread = osThreadGetId();
+  /* The display is on and likely operated right after boot */
+  s_last_activity_tick = osKernelGetTickCount();
 
+  /* Conversions are started per measurement, the first one below */
   memset(s_adc_dma_buffer, 0, sizeof(s_adc_dma_buffer));
-  if (HAL_ADC_Start_DMA(&hadc1, (uint32_t *)s_adc_dma_buffer,
-                        SENSOR_TASK_ADC_CHANNEL_COUNT) != HAL_OK) {
-    Error_Handler();
-  }
-
-  /* Wait for first ADC conversions to complete before starting main loop */
-  osDelay(safe_ms_to_ticks(SENSOR_TASK_MIN_SAMPLING_PERIOD_MS));
+  AdcSnapshot_Init();
 
   TickType_t last_wake_time = osKernelGetTickCount();
+  uint32_t last_loop_tick = last_wake_time;
   const uint16_t temp_cycle_threshold = TEMP_MEAS_PER_MOTOR_MEAS_CYCLES;
   uint32_t temp_measurement_counter =
       temp_cycle_threshold; /* Trigger immediate measurement */
@@ -203,16 +738,8 @@ void StartSensorTask(void *argument) {
   printf("SensorTask init OK. Running loop...\n");
 
   for (;;) {
-    /* Perform all ADC calculations OUTSIDE the mutex (keep critical section short) */
-    const uint16_t vref_raw = s_adc_dma_buffer[SENSOR_TASK_VREF_CHANNEL_INDEX];
-    const uint32_t vref_mv = calculate_vref_voltage(vref_raw);
-
-    float temperature = 0.0f;
-    float battery_voltage = 0.0f;
-    float motor_current = 0.0f;
-    uint8_t battery_soc = 0U;
-    bool update_motor = false;
-    bool update_temp_bat = false;
+    TRACE_BEGIN(TRACE_ID_SENSOR_LOOP, 0U);
+    const uint32_t replay_start = REPLAY_COST_START();
 
     /* Check if motor measurements are enabled */
     bool local_motor_enabled;
@@ -220,27 +747,69 @@ void StartSensorTask(void *argument) {
     local_motor_enabled = s_motor_measurements_enabled;
     taskEXIT_CRITICAL();
 
+    /* A continuously converting ADC is charged for the sequences since the
+       last iteration, a triggered sequence in acquire_adc() */
+    const uint32_t loop_tick = osKernelGetTickCount();
+    if (s_adc_continuous) {
+      Energy_AddAdcRunTime(ticks_to_ms(loop_tick - last_loop_tick));
+    }
+    last_loop_tick = loop_tick;
+
+    /* Samples this iteration publishes from (replaced by a host replay) */
+    AdcSnapshot_t snapshot;
+    acquire_adc(local_motor_enabled, &snapshot);
+    uint16_t *const adc = snapshot.samples;
+    REPLAY_ADC(adc);
+
+    /* Perform all ADC calculations OUTSIDE the mutex (keep critical section short) */
+    const uint16_t vref_raw = adc[SENSOR_TASK_VREF_CHANNEL_INDEX];
+    const uint32_t vref_mv = SensorCalc_VrefVoltage(vref_raw);
+
+    int32_t temperature_cdeg = 0;
+    int32_t temperature_raw_cdeg = 0;
+    uint32_t battery_mv = 0U;
+    uint32_t motor_current_ma = 0U;
+    uint8_t battery_soc = 0U;
+    uint16_t battery_days = ENERGY_DAYS_UNKNOWN;
+    bool update_motor = false;
+    bool update_temp_bat = false;
+
     if (local_motor_enabled) {
       /* Motor measurements enabled: sample motor current */
-      const uint16_t motor_raw =
-          s_adc_dma_buffer[SENSOR_TASK_MOTOR_CHANNEL_INDEX];
-      const float motor_voltage = convert_raw_to_voltage(motor_raw, vref_mv);
-      motor_current = motor_voltage / SENSOR_TASK_MOTOR_SHUNT_OHMS;
+      const uint16_t motor_raw = adc[SENSOR_TASK_MOTOR_CHANNEL_INDEX];
+      motor_current_ma = SensorCalc_MotorCurrent(motor_raw, vref_mv);
       update_motor = true;
 
+      /* Braking shorts the motor and draws nothing from the battery */
+      const MotorStateTypeDef motor_state = Motor_GetState();
+      const bool motor_running =
+          motor_state == MOTOR_FORWARD || motor_state == MOTOR_BACKWARD;
+      if (motor_running) {
+        Energy_AddMotor(motor_current_ma, MOTOR_MEAS_PERIOD_MS);
+      }
+
       /* Check if it's time to measure temperature and battery */
-      if (temp_cycle_threshold == 0U ||
-          temp_measurement_counter >= temp_cycle_threshold) {
+      const bool temp_cycle =
+          temp_cycle_threshold == 0U ||
+          temp_measurement_counter >= temp_cycle_threshold;
+      const uint16_t vbat_raw = adc[SENSOR_TASK_VBAT_CHANNEL_INDEX];
+
+      /* The battery estimator sees every sample under load, to count the
+         motor charge and learn the internal resistance */
+      if (motor_running || temp_cycle) {
+        battery_mv = SensorCalc_BatteryVoltage(vbat_raw, vref_mv);
+        battery_soc =
+            estimate_battery_soc(battery_mv, motor_current_ma, motor_running);
+      }
+
+      if (temp_cycle) {
         temp_measurement_counter = 0U;
-        const uint16_t temp_raw =
-            s_adc_dma_buffer[SENSOR_TASK_TEMPERATURE_CHANNEL_INDEX];
-        const uint16_t vbat_raw =
-            s_adc_dma_buffer[SENSOR_TASK_VBAT_CHANNEL_INDEX];
-
-        temperature = calculate_temperature(temp_raw, vref_mv);
-        battery_voltage = convert_raw_to_voltage(vbat_raw, vref_mv) *
-                          SENSOR_TASK_VBAT_DIVIDER;
-        battery_soc = calculate_battery_soc(battery_voltage);
+        const uint16_t temp_raw = adc[SENSOR_TASK_TEMPERATURE_CHANNEL_INDEX];
+
+        /* Accounts the activity the temperature is compensated for */
+        battery_days = Energy_Update(battery_soc);
+        temperature_cdeg =
+            calculate_temperature(temp_raw, vref_mv, &temperature_raw_cdeg);
         update_temp_bat = true;
 #if SENSOR_TASK_DEBUG_PRINTING
         printf("SensorTask: vref_raw=%u, temp_raw=%u, vbat_raw=%u, "
@@ -252,17 +821,18 @@ void StartSensorTask(void *argument) {
       temp_measurement_counter += 1U;
     } else {
       /* Motor measurements disabled: always measure temperature and battery */
-      const uint16_t temp_raw =
-          s_adc_dma_buffer[SENSOR_TASK_TEMPERATURE_CHANNEL_INDEX];
-      const uint16_t vbat_raw =
-          s_adc_dma_buffer[SENSOR_TASK_VBAT_CHANNEL_INDEX];
-
-      temperature = calculate_temperature(temp_raw, vref_mv);
-      battery_voltage =
-          convert_raw_to_voltage(vbat_raw, vref_mv) * SENSOR_TASK_VBAT_DIVIDER;
-      battery_soc = calculate_battery_soc(battery_voltage);
+      const uint16_t temp_raw = adc[SENSOR_TASK_TEMPERATURE_CHANNEL_INDEX];
+      const uint16_t vbat_raw = adc[SENSOR_TASK_VBAT_CHANNEL_INDEX];
+
+      battery_mv = SensorCalc_BatteryVoltage(vbat_raw, vref_mv);
+      battery_soc = estimate_battery_soc(battery_mv, 0U, false);
+      battery_days = Energy_Update(battery_soc);
+      temperature_cdeg =
+          calculate_temperature(temp_raw, vref_mv, &temperature_raw_cdeg);
       update_temp_bat = true;
       temp_measurement_counter = 0U; /* Reset counter */
+      s_sampling_period_ms =
+          next_sampling_period(temperature_cdeg, battery_soc);
 #if SENSOR_TASK_DEBUG_PRINTING
       printf("SensorTask: vref_raw=%u, temp_raw=%u, vbat_raw=%u, vref_mv=%lu, "
              "battery_soc=%u%%\n",
@@ -270,20 +840,41 @@ void StartSensorTask(void *argument) {
 #endif
     }
 
+    /* Cooling rate for the system task's open-window detection */
+    int16_t temperature_slope = WINDOW_DETECT_NO_SLOPE;
+    if (update_temp_bat) {
+      WindowSlope_Add(&s_window_slope, ticks_to_ms(osKernelGetTickCount()),
+                      temperature_cdeg);
+      temperature_slope = WindowSlope_Get(&s_window_slope);
+    }
+
     /* Update sensor values via mutex */
-    if (osMutexAcquire(s_sensor_model->mutex, osWaitForever) == osOK) {
+    SensorData_t published;
+    bool updated = false;
+    if (IPC_MUTEX_ACQUIRE(s_sensor_model->mutex, osWaitForever) == osOK) {
       if (update_motor) {
-        s_sensor_model->data.motor_current = motor_current;
+        s_sensor_model->data.motor_current_ma = (uint16_t)motor_current_ma;
       }
 
       if (update_temp_bat) {
-        s_sensor_model->data.ambient_temperature = temperature;
+        s_sensor_model->data.ambient_temperature_cdeg =
+            (int16_t)temperature_cdeg;
+        s_sensor_model->data.ambient_temperature_raw_cdeg =
+            (int16_t)temperature_raw_cdeg;
+        s_sensor_model->data.temperature_slope_cdeg_min = temperature_slope;
+        s_sensor_model->data.temperature_valid = true;
         s_sensor_model->data.soc = battery_soc;
+        s_sensor_model->data.battery_days = battery_days;
 #if DRIVER_TEST
-        s_sensor_model->data.battery_voltage = battery_voltage;
+        s_sensor_model->data.battery_mv = (uint16_t)battery_mv;
 #endif
       }
-      osMutexRelease(s_sensor_model->mutex);
+      published = s_sensor_model->data;
+      updated = true;
+      IPC_MUTEX_RELEASE(s_sensor_model->mutex);
+    }
+    if (updated) {
+      notify_subscribers(&published);
     }
 
     /* Determine delay interval based on motor measurement state */
@@ -292,9 +883,23 @@ void StartSensorTask(void *argument) {
       /* Motor measurements enabled: use standard motor measurement period */
       task_interval = safe_ms_to_ticks(MOTOR_MEAS_PERIOD_MS);
     } else {
-      /* Motor measurements disabled: measure temp/battery once per minute */
-      task_interval = safe_ms_to_ticks(TEMPERATURE_AND_BAT_MEAS_PERIOD_MS);
+      /* Motor measurements disabled: adaptive temperature/battery period */
+      task_interval = safe_ms_to_ticks(s_sampling_period_ms);
+    }
+    REPLAY_COST_END(REPLAY_COST_SENSOR, replay_start);
+    TRACE_END(TRACE_ID_SENSOR_LOOP, update_temp_bat ? 1U : 0U);
+
+    /* Wait for the period to end, like vTaskDelayUntil(), or for a wake-up
+       (user input, motor measurements starting) */
+    const TickType_t elapsed = osKernelGetTickCount() - last_wake_time;
+    last_wake_time += task_interval;
+    if (elapsed < task_interval) {
+      const uint32_t flags = osThreadFlagsWait(
+          SENSOR_TASK_FLAG_WAKE, osFlagsWaitAny, task_interval - elapsed);
+      if ((flags & osFlagsError) == 0U) {
+        /* Woken early: the next period starts now */
+        last_wake_time = osKernelGetTickCount();
+      }
     }
-    vTaskDelayUntil(&last_wake_time, task_interval);
   }
 }
\ No newline at end of file
@@ -21,11 +21,17 @@
 
 #include "FreeRTOS.h"
 #include "cmsis_os2.h"
+#include "config_codec.h"
+#include "energy.h"
+#include "ipc_profile.h"
+#include "log_task.h"
 #include "main.h"
+#include "replay.h"
+#include "schedule.h"
 #include "stm32wbxx_hal.h"
 #include "task.h"
 #include "task_debug.h"
-#include "utils.h"
+#include "trace.h"
 
 #include <string.h>
 
@@ -33,37 +39,84 @@
 #define EEPROM_START_ADDR (FLASH_BASE + 512 * 1024 - 4 * 1024)
 #define EEPROM_SIZE 4096U
 #define CONFIG_MAGIC_NUMBER 0xDEADBEEFU
-#define CONFIG_VERSION 1U
+#define CONFIG_VERSION 4U
 #define STORAGE_EVENT_QUEUE_DEPTH 4U
 
-/* Configuration storage block format: magic + version + config + checksum */
-typedef struct {
-  uint32_t magic;
-  uint32_t version;
-  ConfigData_t config;
-  uint32_t checksum;
-} StorageBlockTypeDef;
+/* Configuration record: magic (u32), version (u16), length (u16), the
+   encoded configuration (config_codec.h) and its checksum (u32); all
+   little-endian, padded with erased bytes to whole double-words */
+#define RECORD_HEADER_SIZE 8U
+#define RECORD_CHECKSUM_SIZE 4U
+#define RECORD_MAX_SIZE                                                       \
+  ((RECORD_HEADER_SIZE + CONFIG_CODEC_MAX_SIZE + RECORD_CHECKSUM_SIZE + 7U) & \
+   ~7U)
+
+/* Version 1 record: the memory image of the former magic (u32), version
+   (u32), ConfigData_t with a single daily schedule and a checksum (u32)
+   over the configuration bytes. The offsets are those of the Cortex-M4
+   layout it was written with: temperature offset, slot count, five slots
+   of start/end hour and minute and a float temperature, manual target */
+#define CONFIG_VERSION_V1 1U
+#define V1_OFFSET_POS 8U
+#define V1_NUM_SLOTS_POS 12U
+#define V1_SLOTS_POS 16U
+#define V1_SLOT_SIZE 8U
+#define V1_MAX_SLOTS 5U
+#define V1_MANUAL_POS 56U
+#define V1_CHECKSUM_POS 60U
 
 /* Thread-safe access to configuration and event queues */
 static ConfigModel_t *s_config_model = NULL;
 static osMessageQueueId_t s_event_queue = NULL;
 static osMessageQueueId_t s_system2storage_queue = NULL;
 
-/* Calculate simple checksum for config validation and corruption detection */
-static uint32_t calculate_checksum(const ConfigData_t *config) {
-  if (config == NULL)
+/* Encoding held by the flash record, to detect changes without keeping
+   (and re-encoding) a copy of the configuration */
+static uint8_t s_written[CONFIG_CODEC_MAX_SIZE];
+static uint32_t s_written_length = 0U;
+
+static void put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+  put_u16(p, (uint16_t)v);
+  put_u16(&p[2], (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t)get_u16(p) | ((uint32_t)get_u16(&p[2]) << 16);
+}
+
+/* Checksum of the encoded configuration, as stored in the record */
+uint32_t StorageTask_CalculateChecksum(const ConfigData_t *config) {
+  uint8_t encoded[CONFIG_CODEC_MAX_SIZE];
+  const uint32_t length =
+      ConfigCodec_Encode(config, encoded, sizeof(encoded));
+  if (length == 0U)
     return 0;
 
-  uint32_t checksum = 0;
-  const uint8_t *data = (const uint8_t *)config;
-  size_t size = sizeof(ConfigData_t);
+  return ConfigCodec_Checksum(encoded, length);
+}
 
-  for (size_t i = 0; i < size; i++) {
-    checksum += data[i];
-    checksum = (checksum << 1) | (checksum >> 31); /* Rotate left for better distribution */
-  }
+static float get_float(const uint8_t *p) {
+  const uint32_t bits = get_u32(p);
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/* True if the configuration stores the record already in flash */
+static bool is_written(const ConfigData_t *config) {
+  uint8_t encoded[CONFIG_CODEC_MAX_SIZE];
+  const uint32_t length = ConfigCodec_Encode(config, encoded, sizeof(encoded));
 
-  return checksum;
+  return length == s_written_length && memcmp(encoded, s_written, length) == 0;
 }
 
 /* Read configuration from Flash with validation */
@@ -71,36 +124,70 @@ static bool read_config_from_flash(ConfigData_t *config) {
   if (config == NULL)
     return false;
 
-  const StorageBlockTypeDef *block =
-      (const StorageBlockTypeDef *)EEPROM_START_ADDR;
+  const uint8_t *record = (const uint8_t *)EEPROM_START_ADDR;
 
   /* Validate magic number and version */
-  if (block->magic != CONFIG_MAGIC_NUMBER)
+  if (get_u32(&record[0]) != CONFIG_MAGIC_NUMBER)
+    return false;
+
+  if (get_u16(&record[4]) != CONFIG_VERSION)
     return false;
 
-  if (block->version != CONFIG_VERSION)
+  const uint32_t length = get_u16(&record[6]);
+  if (length == 0U || length > CONFIG_CODEC_MAX_SIZE)
     return false;
 
   /* Validate checksum to detect corruption */
-  uint32_t calculated_checksum = calculate_checksum(&block->config);
-  if (calculated_checksum != block->checksum)
+  const uint8_t *encoded = &record[RECORD_HEADER_SIZE];
+  if (ConfigCodec_Checksum(encoded, length) != get_u32(&encoded[length]))
     return false;
 
-  *config = block->config;
-  return true;
+  return ConfigCodec_Decode(encoded, length, config);
 }
 
-/* Write configuration to Flash with sector erase */
-static bool write_config_to_flash(const ConfigData_t *config) {
-  if (config == NULL)
+/* Read a version 1 record, running its daily schedule on every day */
+static bool read_v1_config_from_flash(ConfigData_t *config) {
+  const uint8_t *record = (const uint8_t *)EEPROM_START_ADDR;
+
+  if (get_u32(&record[0]) != CONFIG_MAGIC_NUMBER ||
+      get_u32(&record[4]) != CONFIG_VERSION_V1)
+    return false;
+
+  /* Rotate-left sum of the ConfigData_t bytes, padding included */
+  uint32_t checksum = 0U;
+  for (uint32_t i = V1_OFFSET_POS; i < V1_CHECKSUM_POS; i++) {
+    checksum += record[i];
+    checksum = (checksum << 1) | (checksum >> 31);
+  }
+  if (checksum != get_u32(&record[V1_CHECKSUM_POS]))
+    return false;
+
+  DailyScheduleTypeDef daily = {.num_time_slots = record[V1_NUM_SLOTS_POS]};
+  if (daily.num_time_slots > V1_MAX_SLOTS)
     return false;
+  for (uint8_t i = 0U; i < daily.num_time_slots; i++) {
+    const uint8_t *slot = &record[V1_SLOTS_POS + i * V1_SLOT_SIZE];
+    daily.time_slots[i].start_hour = slot[0];
+    daily.time_slots[i].start_minute = slot[1];
+    daily.time_slots[i].end_hour = slot[2];
+    daily.time_slots[i].end_minute = slot[3];
+    daily.time_slots[i].temperature = get_float(&slot[4]);
+  }
 
-  StorageBlockTypeDef block;
-  block.magic = CONFIG_MAGIC_NUMBER;
-  block.version = CONFIG_VERSION;
-  block.config = *config;
-  block.checksum = calculate_checksum(config);
+  ConfigData_t migrated = {
+      .temperature_offset = get_float(&record[V1_OFFSET_POS]),
+      .manual_target_temp = get_float(&record[V1_MANUAL_POS])};
+  Schedule_LoadDefault(&migrated.schedule, 3);
+  if (!Schedule_SetDay(&migrated.schedule, 0U, &daily))
+    return false;
+  Schedule_CopyDay(&migrated.schedule, 0U, SCHEDULE_MASK_ALL);
 
+  *config = migrated;
+  return true;
+}
+
+/* Erase the EEPROM page and program a record of whole double-words */
+static bool program_config_record(const uint8_t *record, uint32_t size) {
   /* Unlock Flash for writing */
   if (HAL_FLASH_Unlock() != HAL_OK)
     return false;
@@ -112,28 +199,23 @@ static bool write_config_to_flash(const ConfigData_t *config) {
   erase_init.NbPages = 1;
   uint32_t page_error = 0;
 
+  Energy_AddFlashErase();
   if (HAL_FLASHEx_Erase(&erase_init, &page_error) != HAL_OK) {
     HAL_FLASH_Lock();
     return false;
   }
 
   /* Program data as 64-bit words (STM32WB55 requires double-word writes) */
-  uint8_t *src_bytes = (uint8_t *)&block;
   uint64_t *dst = (uint64_t *)EEPROM_START_ADDR;
-  size_t total_bytes = sizeof(StorageBlockTypeDef);
-  size_t words = (total_bytes + 7) / 8;
+  const uint32_t words = size / 8U;
 
-  for (size_t i = 0; i < words; i++) {
-    uint64_t data = 0;
-    /* Construct 64-bit word safely from source bytes */
-    size_t copy_len = (total_bytes - i * 8);
-    if (copy_len > 8)
-      copy_len = 8;
+  for (uint32_t i = 0; i < words; i++) {
+    uint64_t data;
+    memcpy(&data, &record[i * 8U], sizeof(data));
 
-    memcpy(&data, src_bytes + i * 8, copy_len);
-
-    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, (uint32_t)(dst + i),
-                          data) != HAL_OK) {
+    Energy_AddFlashProgram(1U);
+    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD,
+                          (uint32_t)(uintptr_t)(dst + i), data) != HAL_OK) {
       HAL_FLASH_Lock();
       return false;
     }
@@ -144,15 +226,45 @@ static bool write_config_to_flash(const ConfigData_t *config) {
   return true;
 }
 
+/* Encode the configuration and write its record to Flash */
+static bool write_config_to_flash(const ConfigData_t *config) {
+  uint8_t record[RECORD_MAX_SIZE];
+  memset(record, 0xFF, sizeof(record));
+
+  const uint32_t length = ConfigCodec_Encode(
+      config, &record[RECORD_HEADER_SIZE], CONFIG_CODEC_MAX_SIZE);
+  if (length == 0U)
+    return false;
+
+  put_u32(&record[0], CONFIG_MAGIC_NUMBER);
+  put_u16(&record[4], CONFIG_VERSION);
+  put_u16(&record[6], (uint16_t)length);
+  put_u32(&record[RECORD_HEADER_SIZE + length],
+          ConfigCodec_Checksum(&record[RECORD_HEADER_SIZE], length));
+  const uint32_t size =
+      (RECORD_HEADER_SIZE + length + RECORD_CHECKSUM_SIZE + 7U) & ~7U;
+
+  TRACE_BEGIN(TRACE_ID_FLASH_WRITE, 0U);
+  const bool ok = program_config_record(record, size);
+  TRACE_END(TRACE_ID_FLASH_WRITE, ok ? 1U : 0U);
+  if (ok) {
+    memcpy(s_written, &record[RECORD_HEADER_SIZE], length);
+    s_written_length = length;
+    DLOG("StorageTask: Programmed %lu bytes (%lu double-words)\n",
+         (unsigned long)size, (unsigned long)(size / 8U));
+  }
+  return ok;
+}
+
 /* Post event to system via event queue */
 static void StorageTask_PostEvent(Storage2SystemEventTypeDef event) {
   if (s_event_queue == NULL)
     return;
 
   Storage2SystemEventTypeDef evt_copy = event;
-  osStatus_t status = osMessageQueuePut(s_event_queue, &evt_copy, 0U, 0U);
+  osStatus_t status = IPC_QUEUE_PUT(s_event_queue, &evt_copy, 0U, 0U);
   if (status != osOK) {
-    printf("StorageTask: Failed to post event (status=%d)\n", status);
+    DLOG("StorageTask: Failed to post event (status=%d)\n", status);
   }
 }
 
@@ -188,23 +300,34 @@ void StartStorageTask(void *argument) {
   /* Load configuration from Flash or initialize defaults */
   ConfigData_t loaded_config = {.temperature_offset = 0.0f,
                                  .manual_target_temp = 20.0f};
-  if (read_config_from_flash(&loaded_config)) {
+  bool loaded = read_config_from_flash(&loaded_config);
+  const bool migrated = !loaded && read_v1_config_from_flash(&loaded_config);
+  loaded = REPLAY_CONFIG(&loaded_config, loaded || migrated);
+  if (loaded) {
     /* Store in shared config with mutex protection */
-    if (osMutexAcquire(s_config_model->mutex, osWaitForever) == osOK) {
+    if (IPC_MUTEX_ACQUIRE(s_config_model->mutex, osWaitForever) == osOK) {
       s_config_model->data = loaded_config;
-      osMutexRelease(s_config_model->mutex);
+      IPC_MUTEX_RELEASE(s_config_model->mutex);
     }
     printf("StorageTask: Configuration loaded from Flash\n");
+    /* Rewrite a version 1 record in the current format */
+    if (migrated) {
+      if (write_config_to_flash(&loaded_config)) {
+        printf("StorageTask: Version 1 configuration migrated\n");
+      } else {
+        printf("StorageTask: Failed to migrate version 1 configuration\n");
+      }
+    }
   } else {
     printf("StorageTask: No valid configuration in Flash, using defaults\n");
     /* Save default configuration to Flash */
     ConfigData_t default_config = {.temperature_offset = 0.0f,
                                     .manual_target_temp = 20.0f};
-    Utils_LoadDefaultSchedule(&default_config.daily_schedule, 3);
+    Schedule_LoadDefault(&default_config.schedule, 3);
     if (write_config_to_flash(&default_config)) {
-      if (osMutexAcquire(s_config_model->mutex, osWaitForever) == osOK) {
+      if (IPC_MUTEX_ACQUIRE(s_config_model->mutex, osWaitForever) == osOK) {
         s_config_model->data = default_config;
-        osMutexRelease(s_config_model->mutex);
+        IPC_MUTEX_RELEASE(s_config_model->mutex);
       }
       printf("StorageTask: Default configuration saved to Flash\n");
     } else {
@@ -220,8 +343,9 @@ void StartStorageTask(void *argument) {
          (unsigned long)xPortGetFreeHeapSize());
 #endif
 
-  /* Track last written config to detect changes */
-  ConfigData_t last_written_config = s_config_model->data;
+  /* The flash record holds the configuration loaded or saved above */
+  s_written_length =
+      ConfigCodec_Encode(&s_config_model->data, s_written, sizeof(s_written));
 
   /* Periodic monitoring loop: check every 2.5 seconds for config changes */
   for (;;) {
@@ -232,45 +356,40 @@ void StartStorageTask(void *argument) {
     /* Handle factory reset request */
     if (status == osOK) {
       if (sysEvt == EVT_CFG_RST_REQ) {
-        printf("StorageTask: Factory Reset Requested\n");
+        DLOG("StorageTask: Factory Reset Requested\n");
         ConfigData_t default_config = {.temperature_offset = 0.0f,
                                         .manual_target_temp = 20.0f};
-        Utils_LoadDefaultSchedule(&default_config.daily_schedule, 3);
+        Schedule_LoadDefault(&default_config.schedule, 3);
 
         if (write_config_to_flash(&default_config)) {
-          if (osMutexAcquire(s_config_model->mutex, osWaitForever) == osOK) {
+          if (IPC_MUTEX_ACQUIRE(s_config_model->mutex, osWaitForever) ==
+              osOK) {
             s_config_model->data = default_config;
-            last_written_config = default_config; /* Prevent re-write */
-            osMutexRelease(s_config_model->mutex);
+            IPC_MUTEX_RELEASE(s_config_model->mutex);
           }
-          printf("StorageTask: Factory Reset Complete\n");
+          DLOG("StorageTask: Factory Reset Complete\n");
           StorageTask_PostEvent(EVT_CFG_RST_END);
         }
       }
     }
 
     /* Check if config changed and write to Flash if needed */
-    if (osMutexAcquire(s_config_model->mutex, osWaitForever) == osOK) {
-      bool config_changed =
-          (memcmp(&s_config_model->data, &last_written_config,
-                  sizeof(ConfigData_t)) != 0);
+    if (IPC_MUTEX_ACQUIRE(s_config_model->mutex, osWaitForever) == osOK) {
+      /* Only what the record stores counts as a change */
+      bool config_changed = !is_written(&s_config_model->data);
 
       if (config_changed) {
         ConfigData_t current_data = s_config_model->data;
-        osMutexRelease(s_config_model->mutex);
+        IPC_MUTEX_RELEASE(s_config_model->mutex);
 
         /* Config changed, persist to Flash */
         if (write_config_to_flash(&current_data)) {
-          if (osMutexAcquire(s_config_model->mutex, osWaitForever) == osOK) {
-            last_written_config = s_config_model->data;
-            osMutexRelease(s_config_model->mutex);
-          }
-          printf("StorageTask: Configuration saved to Flash\n");
+          DLOG("StorageTask: Configuration saved to Flash\n");
         } else {
-          printf("StorageTask: Failed to save configuration to Flash\n");
+          DLOG("StorageTask: Failed to save configuration to Flash\n");
         }
       } else {
-        osMutexRelease(s_config_model->mutex);
+        IPC_MUTEX_RELEASE(s_config_model->mutex);
       }
     }
   }
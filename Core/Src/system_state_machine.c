@@ -19,10 +19,19 @@
 #include "system_state_machine.h"
 #include "FreeRTOS.h"
 #include "cmsis_os2.h"
+#include "energy.h"
+#include "ipc_profile.h"
+#include "log_task.h"
 #include "main.h"
 #include "maintenance_task.h"
+#include "optimum_start.h"
+#include "replay.h"
+#include "schedule.h"
+#include "sensor_task.h"
 #include "storage_task.h"
 #include "system_task.h"
+#include "utils.h"
+#include "window_detect.h"
 #include <stdio.h>
 
 /* External event queue from storage task */
@@ -79,7 +88,7 @@ void SystemSM_Run(void) {
       /* Signal init complete to ViewPresenter on exit */
       if (smArgs->system2vp_event_queue != NULL) {
         System2VPEventTypeDef event = EVT_SYS_INIT_END;
-        osMessageQueuePut(smArgs->system2vp_event_queue, &event, 0, 0);
+        IPC_QUEUE_PUT(smArgs->system2vp_event_queue, &event, 0, 0);
         printf("SystemSM: Sent EVT_SYS_INIT_END to ViewPresenter on exit from "
                "INIT\n");
       }
@@ -114,10 +123,10 @@ void SystemSM_Run(void) {
       printf("SystemSM: Entering ADAPT_FAIL state...\n");
       if (smArgs->system_model != NULL &&
           smArgs->system_model->mutex != NULL) {
-        if (osMutexAcquire(smArgs->system_model->mutex,
-                           osWaitForever) == osOK) {
+        if (IPC_MUTEX_ACQUIRE(smArgs->system_model->mutex,
+                              osWaitForever) == osOK) {
           smArgs->system_model->data.adapt_result = ADAPT_RESULT_FAIL;
-          osMutexRelease(smArgs->system_model->mutex);
+          IPC_MUTEX_RELEASE(smArgs->system_model->mutex);
         }
       }
       break;
@@ -125,10 +134,10 @@ void SystemSM_Run(void) {
       printf("SystemSM: Entering RUNNING state...\n");
       if (smArgs->system_model != NULL &&
           smArgs->system_model->mutex != NULL) {
-        if (osMutexAcquire(smArgs->system_model->mutex,
-                           osWaitForever) == osOK) {
+        if (IPC_MUTEX_ACQUIRE(smArgs->system_model->mutex,
+                              osWaitForever) == osOK) {
           smArgs->system_model->data.adapt_result = ADAPT_RESULT_OK;
-          osMutexRelease(smArgs->system_model->mutex);
+          IPC_MUTEX_RELEASE(smArgs->system_model->mutex);
         }
       }
       break;
@@ -136,7 +145,7 @@ void SystemSM_Run(void) {
       printf("SystemSM: Entering FACTORY_RST state...\n");
       if (smArgs->system2storage_event_queue != NULL) {
         System2StorageEventTypeDef evt = EVT_CFG_RST_REQ;
-        osMessageQueuePut(smArgs->system2storage_event_queue, &evt, 0, 0);
+        IPC_QUEUE_PUT(smArgs->system2storage_event_queue, &evt, 0, 0);
       }
       break;
     default:
@@ -282,10 +291,14 @@ static SystemState_t doRunningState(void) {
   static uint8_t last_slot_end_hour =
       0xFF; /* Track previous slot to detect transitions */
   static uint8_t last_slot_end_minute = 0xFF;
+  static OptimumStart_t optimum_start;
+  static bool optimum_start_loaded = false;
+  static WindowDetect_t window_detect;
+  static bool window_detect_ready = false;
 
   /* Check for boost mode timeout (300 seconds) */
   if (smArgs && smArgs->system_model) {
-    if (osMutexAcquire(smArgs->system_model->mutex, 10) == osOK) {
+    if (IPC_MUTEX_ACQUIRE(smArgs->system_model->mutex, 10) == osOK) {
       if (smArgs->system_model->data.mode == MODE_BOOST) {
         uint32_t elapsed_ticks =
             osKernelGetTickCount() -
@@ -296,12 +309,11 @@ static SystemState_t doRunningState(void) {
           SystemMode_t previous_mode =
               smArgs->system_model->data.mode_before_boost;
           smArgs->system_model->data.mode = previous_mode;
-          printf(
-              "SystemSM: Boost mode timeout - restoring previous mode (%d)\n",
-              previous_mode);
+          DLOG("SystemSM: Boost mode timeout - restoring previous mode (%d)\n",
+               previous_mode);
         }
       }
-      osMutexRelease(smArgs->system_model->mutex);
+      IPC_MUTEX_RELEASE(smArgs->system_model->mutex);
     }
   }
 
@@ -312,54 +324,125 @@ static SystemState_t doRunningState(void) {
     RTC_DateTypeDef sDate = {0};
     HAL_RTC_GetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
     HAL_RTC_GetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
+    REPLAY_RTC(&sTime, &sDate);
 
     float target_temp = 20.0f;
     uint8_t end_h = 0, end_m = 0;
     SystemMode_t current_mode = MODE_AUTO;
 
+    const uint32_t now_ms =
+        osKernelGetTickCount() * (1000U / configTICK_RATE_HZ);
+
+    /* Room temperature and its slope, for optimum start, the open-window
+       detection and the history; none of them sees the 0 before the sensor
+       task's first sample */
+    int32_t ambient_cdeg = 0;
+    int16_t slope_cdeg_min = WINDOW_DETECT_NO_SLOPE;
+    bool ambient_valid = false;
+    if (smArgs->sensor_model != NULL &&
+        IPC_MUTEX_ACQUIRE(smArgs->sensor_model->mutex, 10) == osOK) {
+      ambient_cdeg = smArgs->sensor_model->data.ambient_temperature_cdeg;
+      slope_cdeg_min = smArgs->sensor_model->data.temperature_slope_cdeg_min;
+      ambient_valid = smArgs->sensor_model->data.temperature_valid;
+      IPC_MUTEX_RELEASE(smArgs->sensor_model->mutex);
+    }
+
     /* Read current mode */
-    if (osMutexAcquire(smArgs->system_model->mutex, 10) == osOK) {
+    if (IPC_MUTEX_ACQUIRE(smArgs->system_model->mutex, 10) == osOK) {
       current_mode = smArgs->system_model->data.mode;
-      osMutexRelease(smArgs->system_model->mutex);
+      IPC_MUTEX_RELEASE(smArgs->system_model->mutex);
     }
 
-    /* Set target temperature based on current operating mode */
-    if (current_mode == MODE_AUTO) {
-      /* AUTO mode: calculate from active schedule slot */
-      if (osMutexAcquire(smArgs->config_model->mutex, 10) == osOK) {
-        ConfigData_t *cfg = &smArgs->config_model->data;
-        bool found = false;
-
-        int current_mins = sTime.Hours * 60 + sTime.Minutes;
-
-        for (int i = 0; i < cfg->daily_schedule.num_time_slots; i++) {
-          TimeSlotTypeDef *slot = &cfg->daily_schedule.time_slots[i];
+    /* Open window: shut the valve in AUTO or MANUAL on a sharp drop of the
+       room temperature, restore the mode once the room warms again or on
+       the timeout. Leaving the window mode otherwise (user input, boost)
+       cancels the detection. */
+    if (!window_detect_ready) {
+      WindowDetect_Init(&window_detect);
+      window_detect_ready = true;
+    }
+    if (window_detect.open && current_mode != MODE_WINDOW_OPEN) {
+      WindowDetect_Cancel(&window_detect);
+    }
+    if (ambient_valid &&
+        (current_mode == MODE_AUTO || current_mode == MODE_MANUAL ||
+         current_mode == MODE_WINDOW_OPEN)) {
+      const WindowDetectEvent_t event = WindowDetect_Update(
+          &window_detect, now_ms, ambient_cdeg, slope_cdeg_min);
+      if (event == WINDOW_DETECT_OPENED) {
+        DLOG("SystemSM: Window open (%d cdeg/min at %ld cdeg)\n",
+             (int)slope_cdeg_min, (long)ambient_cdeg);
+      } else if (event == WINDOW_DETECT_CLOSED) {
+        DLOG("SystemSM: Window closed (%ld cdeg)\n", (long)ambient_cdeg);
+      } else if (event == WINDOW_DETECT_TIMEOUT) {
+        DLOG("SystemSM: Window mode timeout\n");
+      }
+    }
+    if (window_detect.open != (current_mode == MODE_WINDOW_OPEN) &&
+        IPC_MUTEX_ACQUIRE(smArgs->system_model->mutex, 10) == osOK) {
+      SystemData_t *data = &smArgs->system_model->data;
+      if (window_detect.open && data->mode == current_mode) {
+        data->mode_before_window = current_mode;
+        data->mode = MODE_WINDOW_OPEN;
+      } else if (!window_detect.open && data->mode == MODE_WINDOW_OPEN) {
+        data->mode = data->mode_before_window;
+      }
+      current_mode = data->mode;
+      IPC_MUTEX_RELEASE(smArgs->system_model->mutex);
+    }
 
-          int start_mins = slot->start_hour * 60 + slot->start_minute;
-          int end_mins = slot->end_hour * 60 + slot->end_minute;
+    /* Learned heat-up rate, loaded once the storage task has the
+       configuration */
+    if (!optimum_start_loaded &&
+        IPC_MUTEX_ACQUIRE(smArgs->config_model->mutex, 10) == osOK) {
+      OptimumStart_Init(&optimum_start,
+                        smArgs->config_model->data.heatup_rate_cdeg_h);
+      IPC_MUTEX_RELEASE(smArgs->config_model->mutex);
+      optimum_start_loaded = true;
+    }
 
-          if (current_mins >= start_mins && current_mins < end_mins) {
-            target_temp = slot->temperature;
-            end_h = slot->end_hour;
-            end_m = slot->end_minute;
-            found = true;
-            break;
+    /* Set target temperature based on current operating mode */
+    if (current_mode == MODE_AUTO) {
+      /* AUTO mode: today's slot; it lasts until the target next changes,
+         possibly on a later day (RTC weekday 1 = Monday) */
+      if (IPC_MUTEX_ACQUIRE(smArgs->config_model->mutex, 10) == osOK) {
+        ScheduleState_t slot;
+        const bool scheduled = Schedule_Evaluate(
+            &smArgs->config_model->data.schedule,
+            (uint8_t)(sDate.WeekDay - 1U), sTime.Hours, sTime.Minutes, &slot);
+
+        if (scheduled) {
+          end_h = slot.next_hour;
+          end_m = slot.next_minute;
+
+          /* Optimum start: take the next slot's target early enough for the
+             room to reach it when the slot starts; the slot end stays the
+             transition */
+          const bool preheating = optimum_start.preheating;
+          const bool preheat =
+              ambient_valid && optimum_start_loaded &&
+              OptimumStart_ShouldPreheat(&optimum_start, &slot, ambient_cdeg);
+          if (preheat && !preheating) {
+            DLOG("SystemSM: Preheating for %02u:%02u (%u min ahead, "
+                 "%u cdeg/h)\n",
+                 end_h, end_m, (unsigned)slot.minutes_to_next,
+                 (unsigned)OptimumStart_GetRate(&optimum_start));
           }
-        }
-
-        if (!found) {
+          target_temp = Utils_IndexToTemp(preheat ? slot.next_index
+                                                  : slot.target_index);
+        } else {
           target_temp = 20.0f;
           end_h = 0;
           end_m = 0;
         }
 
-        osMutexRelease(smArgs->config_model->mutex);
+        IPC_MUTEX_RELEASE(smArgs->config_model->mutex);
       }
     } else if (current_mode == MODE_MANUAL) {
       /* MANUAL mode: use fixed manual temperature */
-      if (osMutexAcquire(smArgs->config_model->mutex, 10) == osOK) {
+      if (IPC_MUTEX_ACQUIRE(smArgs->config_model->mutex, 10) == osOK) {
         target_temp = smArgs->config_model->data.manual_target_temp;
-        osMutexRelease(smArgs->config_model->mutex);
+        IPC_MUTEX_RELEASE(smArgs->config_model->mutex);
       }
       end_h = 0xFF; /* No slot tracking in manual */
       end_m = 0xFF;
@@ -368,10 +451,15 @@ static SystemState_t doRunningState(void) {
       target_temp = 30.0f;
       end_h = 0xFF; /* No slot tracking in boost */
       end_m = 0xFF;
+    } else if (current_mode == MODE_WINDOW_OPEN) {
+      /* WINDOW mode: valve shut (OFF, frost protection) */
+      target_temp = Utils_IndexToTemp(0);
+      end_h = 0xFF; /* No slot tracking while the window is open */
+      end_m = 0xFF;
     }
 
     /* Update shared context with calculated values */
-    if (osMutexAcquire(smArgs->system_model->mutex, 10) == osOK) {
+    if (IPC_MUTEX_ACQUIRE(smArgs->system_model->mutex, 10) == osOK) {
       /* Only clear temporary override in AUTO mode on slot change */
       if (current_mode == MODE_AUTO) {
         bool slot_changed =
@@ -379,20 +467,56 @@ static SystemState_t doRunningState(void) {
         if (slot_changed &&
             smArgs->system_model->data.temporary_target_temp != 0) {
           smArgs->system_model->data.temporary_target_temp = 0;
-          printf("SystemSM: Cleared temporary target temperature (slot changed "
-                 "from %02u:%02u to %02u:%02u)\n",
-                 last_slot_end_hour, last_slot_end_minute, end_h, end_m);
+          DLOG("SystemSM: Cleared temporary target temperature (slot changed "
+               "from %02u:%02u to %02u:%02u)\n",
+               last_slot_end_hour, last_slot_end_minute, end_h, end_m);
         }
 
         smArgs->system_model->data.target_temp = target_temp;
         smArgs->system_model->data.slot_end_hour = end_h;
         smArgs->system_model->data.slot_end_minute = end_m;
-      } else if (current_mode == MODE_MANUAL || current_mode == MODE_BOOST) {
-        /* MANUAL/BOOST: only update target, don't modify slot info */
+      } else {
+        /* MANUAL/BOOST/WINDOW: only update target, don't modify slot info */
         smArgs->system_model->data.target_temp = target_temp;
       }
 
-      osMutexRelease(smArgs->system_model->mutex);
+      /* Effective setpoint, for the sensor task's adaptive sampling; an
+         open window overrides the temporary target */
+      const float temporary = smArgs->system_model->data.temporary_target_temp;
+      const float effective =
+          (temporary != 0 && current_mode != MODE_WINDOW_OPEN) ? temporary
+                                                               : target_temp;
+
+      IPC_MUTEX_RELEASE(smArgs->system_model->mutex);
+
+      SensorTask_SetSetpoint((int32_t)(effective * 100.0f));
+
+      /* Temperature history: room temperature, the setpoint in force and
+         the motor on-time, folded into minute, quarter and hour points */
+      if (ambient_valid && smArgs->history_model != NULL &&
+          IPC_MUTEX_ACQUIRE(smArgs->history_model->mutex, 10) == osOK) {
+        EnergyStats_t energy;
+        Energy_GetStats(&energy);
+        TempHistory_Add(&smArgs->history_model->data, now_ms, ambient_cdeg,
+                        (uint8_t)Utils_TempToIndex(effective),
+                        energy.motor_ms);
+        IPC_MUTEX_RELEASE(smArgs->history_model->mutex);
+      }
+
+      /* Learn the heat-up rate from rises of the setpoint; boost heats at
+         full power and would overstate it, the window mode's setpoint is not
+         the user's */
+      if (optimum_start_loaded && ambient_valid &&
+          current_mode != MODE_BOOST && current_mode != MODE_WINDOW_OPEN &&
+          OptimumStart_Observe(&optimum_start, now_ms, ambient_cdeg,
+                               (int32_t)(effective * 100.0f))) {
+        const uint16_t rate = OptimumStart_GetRate(&optimum_start);
+        DLOG("SystemSM: Heat-up rate now %u cdeg/h\n", (unsigned)rate);
+        if (IPC_MUTEX_ACQUIRE(smArgs->config_model->mutex, 10) == osOK) {
+          smArgs->config_model->data.heatup_rate_cdeg_h = rate;
+          IPC_MUTEX_RELEASE(smArgs->config_model->mutex);
+        }
+      }
 
       /* Update slot tracking (AUTO mode only) */
       if (current_mode == MODE_AUTO) {
@@ -425,6 +549,7 @@ static SystemState_t doFactoryRstState(void) {
           osOK) {
     if (stEvt == EVT_CFG_RST_END) {
       printf("SystemSM: Factory Reset Complete. Resetting MCU...\n");
+      DLOG_FLUSH();
 
       /* Reset backup domain (RTC) */
       HAL_PWR_EnableBkUpAccess();
@@ -442,9 +567,9 @@ static SystemState_t doFactoryRstState(void) {
 static void updateSharedState(SystemState_t newState) {
   if (smArgs != NULL && smArgs->system_model != NULL &&
       smArgs->system_model->mutex != NULL) {
-    if (osMutexAcquire(smArgs->system_model->mutex, 0) == osOK) {
+    if (IPC_MUTEX_ACQUIRE(smArgs->system_model->mutex, 0) == osOK) {
       smArgs->system_model->data.state = newState;
-      osMutexRelease(smArgs->system_model->mutex);
+      IPC_MUTEX_RELEASE(smArgs->system_model->mutex);
     }
   }
 }
@@ -452,7 +577,7 @@ static void updateSharedState(SystemState_t newState) {
 /* Send command to maintenance task via queue */
 static void sendMaintCommand(System2MaintEventTypeDef cmd) {
   if (smArgs != NULL && smArgs->system2maint_event_queue != NULL) {
-    osMessageQueuePut(smArgs->system2maint_event_queue, &cmd, 0, 0);
+    IPC_QUEUE_PUT(smArgs->system2maint_event_queue, &cmd, 0, 0);
   }
 }
 
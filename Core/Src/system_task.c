@@ -22,6 +22,7 @@
 #include "maintenance_task.h"
 #include "storage_task.h"
 #include "system_state_machine.h"
+#include "trace.h"
 #include <stdio.h>
 
 /* Global pointer to system context for API helpers (System_GetState, etc.) */
@@ -53,13 +54,20 @@ void StartSystemTask(void *argument) {
          (unsigned long)xPortGetFreeHeapSize());
 #endif
 
+  if (args->history_model != NULL) {
+    TempHistory_Init(&args->history_model->data);
+    TempHistory_Report(&args->history_model->data);
+  }
+
   /* Initialize the state machine with task arguments */
   SystemSM_Init(args);
 
   /* Main control loop: execute state machine periodically */
   for (;;) {
     /* Run one iteration of the state machine */
+    TRACE_BEGIN(TRACE_ID_SYSTEM_SM_RUN, 0U);
     SystemSM_Run();
+    TRACE_END(TRACE_ID_SYSTEM_SM_RUN, 0U);
 
     /* Yield to prevent task starvation */
     osDelay(pdMS_TO_TICKS(250));
@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * @file           :  task_stats.c
+ * @brief          :  Per-task CPU usage and stack high-water reporting
+ *
+ * @details        :  Uses uxTaskGetSystemState() to collect run-time counters
+ *                    and stack high-water marks, and keeps the counters of the
+ *                    previous call to turn the cumulative run time into a CPU
+ *                    share over the last reporting window. Compiled only with
+ *                    OS_TASKS_RUNTIME_STATS enabled.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "task_stats.h"
+
+#include "task_debug.h"
+
+#if OS_TASKS_RUNTIME_STATS
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdio.h>
+
+/* Run-time counter of one task at the previous report */
+typedef struct {
+  UBaseType_t task_number;
+  uint32_t run_time;
+} TaskStatsSample_t;
+
+/* Snapshot buffers (kept static to stay off the caller's stack) */
+static TaskStatus_t s_status[TASK_STATS_MAX_TASKS];
+static TaskStatsSample_t s_previous[TASK_STATS_MAX_TASKS];
+static UBaseType_t s_previous_count = 0U;
+static uint32_t s_previous_total = 0U;
+static uint32_t s_previous_tick = 0U;
+
+/* Single-letter task state for the compact report */
+static char state_letter(eTaskState state) {
+  switch (state) {
+  case eRunning:
+    return 'R';
+  case eReady:
+    return 'E';
+  case eBlocked:
+    return 'B';
+  case eSuspended:
+    return 'S';
+  case eDeleted:
+    return 'D';
+  default:
+    return '?';
+  }
+}
+
+/* Run time of a task at the previous report, 0 for tasks created since */
+static uint32_t previous_run_time(UBaseType_t task_number) {
+  for (UBaseType_t i = 0U; i < s_previous_count; i++) {
+    if (s_previous[i].task_number == task_number) {
+      return s_previous[i].run_time;
+    }
+  }
+  return 0U;
+}
+
+/* Sort snapshot by creation order so consecutive reports line up */
+static void sort_by_task_number(UBaseType_t count) {
+  for (UBaseType_t i = 1U; i < count; i++) {
+    const TaskStatus_t entry = s_status[i];
+    UBaseType_t j = i;
+    while (j > 0U && s_status[j - 1U].xTaskNumber > entry.xTaskNumber) {
+      s_status[j] = s_status[j - 1U];
+      j--;
+    }
+    s_status[j] = entry;
+  }
+}
+
+void TaskStats_Report(void) {
+  uint32_t total_run_time = 0U;
+  const UBaseType_t count =
+      uxTaskGetSystemState(s_status, TASK_STATS_MAX_TASKS, &total_run_time);
+  const uint32_t now = (uint32_t)xTaskGetTickCount();
+
+  if (count == 0U) {
+    printf("STATS: more than %u tasks\n", (unsigned)TASK_STATS_MAX_TASKS);
+    return;
+  }
+
+  sort_by_task_number(count);
+
+  /* Counter deltas are wrap-safe as long as the window is shorter than the
+   * 32-bit run-time counter period */
+  const uint32_t window = total_run_time - s_previous_total;
+
+  printf("STATS t=%lums win=%lums heap=%lu min=%lu\n", (unsigned long)now,
+         (unsigned long)(now - s_previous_tick),
+         (unsigned long)xPortGetFreeHeapSize(),
+         (unsigned long)xPortGetMinimumEverFreeHeapSize());
+
+  for (UBaseType_t i = 0U; i < count; i++) {
+    const TaskStatus_t *task = &s_status[i];
+    const uint32_t busy =
+        task->ulRunTimeCounter - previous_run_time(task->xTaskNumber);
+    const uint32_t permille =
+        (window == 0U) ? 0U : (uint32_t)(((uint64_t)busy * 1000U) / window);
+    const unsigned long stack_free =
+        (unsigned long)task->usStackHighWaterMark * sizeof(StackType_t);
+
+    printf("%-16s %3lu.%lu%% %5luB p%02lu %c\n", task->pcTaskName,
+           (unsigned long)(permille / 10U), (unsigned long)(permille % 10U),
+           stack_free, (unsigned long)task->uxCurrentPriority,
+           state_letter(task->eCurrentState));
+
+    s_previous[i].task_number = task->xTaskNumber;
+    s_previous[i].run_time = task->ulRunTimeCounter;
+  }
+
+  s_previous_count = count;
+  s_previous_total = total_run_time;
+  s_previous_tick = now;
+}
+
+#endif /* OS_TASKS_RUNTIME_STATS */
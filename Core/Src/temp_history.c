@@ -0,0 +1,290 @@
+/**
+ ******************************************************************************
+ * @file           :  temp_history.c
+ * @brief          :  Multi-resolution history of the room temperature
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "temp_history.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+static const uint16_t k_capacity[TEMP_HISTORY_TIER_COUNT] = {
+    TEMP_HISTORY_MINUTE_POINTS, TEMP_HISTORY_QUARTER_POINTS,
+    TEMP_HISTORY_HOUR_POINTS};
+
+static const uint16_t k_point_minutes[TEMP_HISTORY_TIER_COUNT] = {
+    1U, TEMP_HISTORY_MINUTES_PER_QUARTER,
+    TEMP_HISTORY_MINUTES_PER_QUARTER * TEMP_HISTORY_QUARTERS_PER_HOUR};
+
+/* Finer points that make one point of the tier */
+static const uint16_t k_children[TEMP_HISTORY_TIER_COUNT] = {
+    1U, TEMP_HISTORY_MINUTES_PER_QUARTER, TEMP_HISTORY_QUARTERS_PER_HOUR};
+
+static TempHistoryPoint_t *ring_points(TempHistory_t *history,
+                                       TempHistoryTier_t tier) {
+  switch (tier) {
+  case TEMP_HISTORY_TIER_MINUTE:
+    return history->minutes;
+  case TEMP_HISTORY_TIER_QUARTER:
+    return history->quarters;
+  case TEMP_HISTORY_TIER_HOUR:
+  default:
+    return history->hours;
+  }
+}
+
+static const TempHistoryPoint_t *
+ring_points_const(const TempHistory_t *history, TempHistoryTier_t tier) {
+  return ring_points((TempHistory_t *)history, tier);
+}
+
+static int16_t clamp_cdeg(int32_t cdeg) {
+  if (cdeg > INT16_MAX)
+    return INT16_MAX;
+  if (cdeg < INT16_MIN)
+    return INT16_MIN;
+  return (int16_t)cdeg;
+}
+
+/* Divide rounding half away from zero */
+static int32_t div_round(int32_t sum, int32_t n) {
+  return (sum >= 0) ? (sum + n / 2) / n : (sum - n / 2) / n;
+}
+
+static void accum_reset(TempHistoryAccum_t *accum) {
+  accum->sum_cdeg = 0;
+  accum->target_sum = 0U;
+  accum->motor_ms = 0U;
+  accum->samples = 0U;
+  accum->children = 0U;
+  accum->min_cdeg = INT16_MAX;
+  accum->max_cdeg = INT16_MIN;
+}
+
+static void accum_sample(TempHistoryAccum_t *accum, int16_t min_cdeg,
+                         int16_t max_cdeg, int16_t avg_cdeg,
+                         uint8_t target_index) {
+  accum->sum_cdeg += avg_cdeg;
+  accum->target_sum += target_index;
+  accum->samples++;
+  if (min_cdeg < accum->min_cdeg)
+    accum->min_cdeg = min_cdeg;
+  if (max_cdeg > accum->max_cdeg)
+    accum->max_cdeg = max_cdeg;
+}
+
+/* Fold a closed point's sums into a coarser one, so that its mean weighs
+   every sample alike even when some minutes are gaps */
+static void accum_merge(TempHistoryAccum_t *accum,
+                        const TempHistoryAccum_t *child) {
+  accum->sum_cdeg += child->sum_cdeg;
+  accum->target_sum += child->target_sum;
+  accum->motor_ms += child->motor_ms;
+  accum->samples += child->samples;
+  accum->children++;
+  if (child->min_cdeg < accum->min_cdeg)
+    accum->min_cdeg = child->min_cdeg;
+  if (child->max_cdeg > accum->max_cdeg)
+    accum->max_cdeg = child->max_cdeg;
+}
+
+static TempHistoryPoint_t accum_point(const TempHistoryAccum_t *accum,
+                                      TempHistoryTier_t tier) {
+  TempHistoryPoint_t point = {.min_cdeg = INT16_MAX,
+                              .max_cdeg = INT16_MIN,
+                              .avg_cdeg = 0,
+                              .target_index = 0U,
+                              .valve = 0U};
+  if (accum->samples != 0U) {
+    point.min_cdeg = accum->min_cdeg;
+    point.max_cdeg = accum->max_cdeg;
+    point.avg_cdeg =
+        clamp_cdeg(div_round(accum->sum_cdeg, (int32_t)accum->samples));
+    point.target_index =
+        (uint8_t)((accum->target_sum + accum->samples / 2U) / accum->samples);
+  }
+  const uint32_t interval_ms =
+      (uint32_t)k_point_minutes[tier] * TEMP_HISTORY_MINUTE_MS;
+  const uint64_t valve =
+      ((uint64_t)accum->motor_ms * 255U + interval_ms - 1U) / interval_ms;
+  point.valve = (valve > 255U) ? 255U : (uint8_t)valve;
+  return point;
+}
+
+/* Store the open point of @p tier and fold it into the next coarser one */
+static void close_point(TempHistory_t *history, TempHistoryTier_t tier) {
+  TempHistoryRing_t *ring = &history->rings[tier];
+
+  ring_points(history, tier)[ring->head] = accum_point(&ring->accum, tier);
+  ring->head = (uint16_t)((ring->head + 1U) % k_capacity[tier]);
+  if (ring->count < k_capacity[tier]) {
+    ring->count++;
+  }
+
+  if (tier + 1 < TEMP_HISTORY_TIER_COUNT) {
+    const TempHistoryTier_t coarser = (TempHistoryTier_t)(tier + 1);
+    TempHistoryAccum_t *accum = &history->rings[coarser].accum;
+    accum_merge(accum, &ring->accum);
+    accum_reset(&ring->accum);
+    if (accum->children >= k_children[coarser]) {
+      close_point(history, coarser);
+    }
+  } else {
+    accum_reset(&ring->accum);
+  }
+}
+
+void TempHistory_Init(TempHistory_t *history) {
+  if (history == NULL) {
+    return;
+  }
+  for (uint32_t tier = 0U; tier < TEMP_HISTORY_TIER_COUNT; tier++) {
+    history->rings[tier].head = 0U;
+    history->rings[tier].count = 0U;
+    accum_reset(&history->rings[tier].accum);
+  }
+  history->minute_start_ms = 0U;
+  history->last_motor_ms = 0U;
+  history->primed = false;
+}
+
+void TempHistory_Add(TempHistory_t *history, uint32_t now_ms, int32_t cdeg,
+                     uint8_t target_index, uint32_t motor_ms) {
+  if (history == NULL) {
+    return;
+  }
+  if (!history->primed) {
+    history->primed = true;
+    history->minute_start_ms = now_ms;
+    history->last_motor_ms = motor_ms;
+  }
+
+  /* Close the minutes that ended before this sample; minutes without a
+     sample become gaps. After a longer stall the open minute is closed
+     and the next one starts at this sample. */
+  uint32_t elapsed_ms = now_ms - history->minute_start_ms;
+  if (elapsed_ms / TEMP_HISTORY_MINUTE_MS > TEMP_HISTORY_MINUTE_POINTS) {
+    close_point(history, TEMP_HISTORY_TIER_MINUTE);
+    history->minute_start_ms = now_ms;
+    elapsed_ms = 0U;
+  }
+  while (elapsed_ms >= TEMP_HISTORY_MINUTE_MS) {
+    close_point(history, TEMP_HISTORY_TIER_MINUTE);
+    history->minute_start_ms += TEMP_HISTORY_MINUTE_MS;
+    elapsed_ms -= TEMP_HISTORY_MINUTE_MS;
+  }
+
+  TempHistoryAccum_t *accum =
+      &history->rings[TEMP_HISTORY_TIER_MINUTE].accum;
+  const int16_t sample = clamp_cdeg(cdeg);
+  accum_sample(accum, sample, sample, sample, target_index);
+  accum->motor_ms += motor_ms - history->last_motor_ms;
+  history->last_motor_ms = motor_ms;
+}
+
+uint16_t TempHistory_Count(const TempHistory_t *history,
+                           TempHistoryTier_t tier) {
+  if (history == NULL || tier >= TEMP_HISTORY_TIER_COUNT) {
+    return 0U;
+  }
+  return history->rings[tier].count;
+}
+
+uint16_t TempHistory_Capacity(TempHistoryTier_t tier) {
+  return (tier < TEMP_HISTORY_TIER_COUNT) ? k_capacity[tier] : 0U;
+}
+
+uint16_t TempHistory_PointMinutes(TempHistoryTier_t tier) {
+  return (tier < TEMP_HISTORY_TIER_COUNT) ? k_point_minutes[tier] : 0U;
+}
+
+bool TempHistory_Get(const TempHistory_t *history, TempHistoryTier_t tier,
+                     uint16_t age, TempHistoryPoint_t *point) {
+  if (history == NULL || point == NULL || tier >= TEMP_HISTORY_TIER_COUNT ||
+      age >= history->rings[tier].count) {
+    return false;
+  }
+  const TempHistoryRing_t *ring = &history->rings[tier];
+  const uint16_t index = (uint16_t)((ring->head + k_capacity[tier] - 1U -
+                                     age) %
+                                    k_capacity[tier]);
+  *point = ring_points_const(history, tier)[index];
+  return true;
+}
+
+bool TempHistory_IsGap(const TempHistoryPoint_t *point) {
+  return point == NULL || point->min_cdeg > point->max_cdeg;
+}
+
+void TempHistory_Columns(const TempHistory_t *history, TempHistoryTier_t tier,
+                         TempHistoryPoint_t *columns, uint16_t n) {
+  if (history == NULL || columns == NULL || n == 0U ||
+      tier >= TEMP_HISTORY_TIER_COUNT) {
+    return;
+  }
+  const uint32_t capacity = k_capacity[tier];
+  const uint16_t count = history->rings[tier].count;
+
+  /* Column c covers the slots [c * capacity / n, (c + 1) * capacity / n)
+     of the span, oldest first; the newest point is the last slot */
+  for (uint16_t c = 0U; c < n; c++) {
+    const uint32_t first = ((uint32_t)c * capacity) / n;
+    const uint32_t last = ((uint32_t)(c + 1U) * capacity) / n;
+    TempHistoryAccum_t accum;
+    uint32_t valve_sum = 0U;
+    uint32_t slots = 0U;
+    accum_reset(&accum);
+    for (uint32_t slot = first; slot < last; slot++) {
+      const uint32_t age = capacity - 1U - slot;
+      TempHistoryPoint_t point;
+      slots++;
+      if (age >= count ||
+          !TempHistory_Get(history, tier, (uint16_t)age, &point)) {
+        continue;
+      }
+      valve_sum += point.valve;
+      if (!TempHistory_IsGap(&point)) {
+        accum_sample(&accum, point.min_cdeg, point.max_cdeg, point.avg_cdeg,
+                     point.target_index);
+      }
+    }
+    columns[c] = accum_point(&accum, tier);
+    columns[c].valve =
+        (slots != 0U) ? (uint8_t)((valve_sum + slots - 1U) / slots) : 0U;
+  }
+}
+
+void TempHistory_Report(const TempHistory_t *history) {
+  if (history == NULL) {
+    return;
+  }
+  const uint16_t minutes = TempHistory_Count(history, TEMP_HISTORY_TIER_MINUTE);
+  const uint16_t quarters =
+      TempHistory_Count(history, TEMP_HISTORY_TIER_QUARTER);
+  const uint16_t hours = TempHistory_Count(history, TEMP_HISTORY_TIER_HOUR);
+
+  printf("History: %lu bytes of %lu (%u x 1 min, %u x 15 min, %u x 1 h "
+         "points of %lu bytes), holding %u/%u/%u\n",
+         (unsigned long)sizeof(TempHistory_t),
+         (unsigned long)TEMP_HISTORY_MAX_BYTES,
+         (unsigned)TEMP_HISTORY_MINUTE_POINTS,
+         (unsigned)TEMP_HISTORY_QUARTER_POINTS,
+         (unsigned)TEMP_HISTORY_HOUR_POINTS,
+         (unsigned long)sizeof(TempHistoryPoint_t), (unsigned)minutes,
+         (unsigned)quarters, (unsigned)hours);
+  printf("HISTORY {\"bytes\":%lu,\"max_bytes\":%lu,\"point_bytes\":%lu,"
+         "\"minutes\":%u,\"quarters\":%u,\"hours\":%u}\n",
+         (unsigned long)sizeof(TempHistory_t),
+         (unsigned long)TEMP_HISTORY_MAX_BYTES,
+         (unsigned long)sizeof(TempHistoryPoint_t), (unsigned)minutes,
+         (unsigned)quarters, (unsigned)hours);
+}
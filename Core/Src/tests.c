@@ -23,11 +23,19 @@
 
 #include "input_task.h"
 #include "lvgl_port_display.h"
-#include "motor.h"
 #include "sensor_task.h"
 #include "storage_task.h"
 
 #if DRIVER_TEST
+/* Thread flag the sensor task sets when a shown value changed */
+#define DRIVER_TEST_FLAG_SENSOR_CHANGED 0x0001U
+/* Thread flag the sensor task sets when it cut the motor off or a move
+   reached its target */
+#define DRIVER_TEST_FLAG_MOTOR_TRIP 0x0002U
+/* Ripples a press of the Go button moves at most, about a full valve
+   stroke */
+#define DRIVER_TEST_MOVE_RIPPLES 600U
+
 /* Update motor current display label */
 static void sensor_current_label_update(lv_obj_t *label, float current) {
   if (label == NULL) {
@@ -74,10 +82,12 @@ static void sensor_display_update(lv_obj_t *current_label,
     return;
   }
 
-  sensor_current_label_update(current_label, values->motor_current);
-  sensor_battery_label_update(battery_label, values->battery_voltage,
-                              values->soc);
-  sensor_temperature_label_update(temp_label, values->ambient_temperature);
+  sensor_current_label_update(current_label,
+                              (float)values->motor_current_ma * 0.001f);
+  sensor_battery_label_update(battery_label,
+                              (float)values->battery_mv * 0.001f, values->soc);
+  sensor_temperature_label_update(
+      temp_label, (float)values->ambient_temperature_cdeg * 0.01f);
 }
 
 /* Update middle button label to show motor direction */
@@ -236,6 +246,20 @@ void Driver_Test(osMessageQueueId_t storage2system_event_queue,
   const TickType_t event_wait_ticks = pdMS_TO_TICKS(50U);
   TickType_t last_sensor_tick = osKernelGetTickCount();
 
+  /* Refresh the sensor labels only when a value changed by what they show */
+  const SensorThresholds_t sensor_thresholds = {
+      .temperature_cdeg = 10U,
+      .motor_current_ma = 1U,
+      .battery_mv = 50U,
+      .soc = 1U,
+  };
+  const int32_t sensor_subscription = SensorTask_Subscribe(
+      DRIVER_TEST_FLAG_SENSOR_CHANGED, &sensor_thresholds);
+  bool sensor_changed = true;
+
+  /* The motor is braked from the ADC interrupt on a stall or overcurrent */
+  SensorTask_SetMotorGuardOwner(DRIVER_TEST_FLAG_MOTOR_TRIP);
+
   /* Main test UI loop: process input and update display */
   for (;;) {
     Input2VPEvent_t event;
@@ -257,8 +281,8 @@ void Driver_Test(osMessageQueueId_t storage2system_event_queue,
             if (event.button_action == BUTTON_ACTION_PRESSED) {
               motor_direction_forward = !motor_direction_forward;
               if (motor_running) {
-                Motor_SetState(motor_direction_forward ? MOTOR_FORWARD
-                                                       : MOTOR_BACKWARD);
+                (void)SensorTask_MoveMotor(motor_direction_forward ? 1 : -1,
+                                           DRIVER_TEST_MOVE_RIPPLES);
               }
               update_go_button_label(buttons[1].label, motor_direction_forward);
             }
@@ -267,11 +291,11 @@ void Driver_Test(osMessageQueueId_t storage2system_event_queue,
             /* Middle button: start/stop motor */
             if (event.button_action == BUTTON_ACTION_PRESSED) {
               motor_running = true;
-              Motor_SetState(motor_direction_forward ? MOTOR_FORWARD
-                                                     : MOTOR_BACKWARD);
+              (void)SensorTask_MoveMotor(motor_direction_forward ? 1 : -1,
+                                         DRIVER_TEST_MOVE_RIPPLES);
             } else {
               motor_running = false;
-              Motor_SetState(MOTOR_COAST);
+              SensorTask_StopMotor();
             }
             break;
           default:
@@ -305,9 +329,33 @@ void Driver_Test(osMessageQueueId_t storage2system_event_queue,
       }
     }
 
-    /* Periodic sensor value display update */
+    const uint32_t flags = osThreadFlagsClear(
+        DRIVER_TEST_FLAG_SENSOR_CHANGED | DRIVER_TEST_FLAG_MOTOR_TRIP);
+    if ((flags & osFlagsError) == 0U &&
+        (flags & DRIVER_TEST_FLAG_MOTOR_TRIP) != 0U) {
+      const MotorGuardReason_t reason = SensorTask_TakeMotorTrip();
+      /* Released and pressed again to restart */
+      motor_running = false;
+      if (reason != MOTOR_GUARD_OK) {
+        printf("Driver_Test: motor cut off (%s) at %ld ripples\n",
+               MotorGuard_ReasonName(reason),
+               (long)SensorTask_GetValvePosition());
+      } else {
+        printf("Driver_Test: move done at %ld ripples\n",
+               (long)SensorTask_GetValvePosition());
+      }
+    }
+
+    /* Sensor value display update, at most every sensor_display_interval
+       (polled at that interval without a subscription) */
+    if ((flags & osFlagsError) == 0U &&
+        (flags & DRIVER_TEST_FLAG_SENSOR_CHANGED) != 0U) {
+      sensor_changed = true;
+    }
     const TickType_t now = osKernelGetTickCount();
-    if ((now - last_sensor_tick) >= sensor_display_interval) {
+    if ((sensor_changed || sensor_subscription < 0) &&
+        (now - last_sensor_tick) >= sensor_display_interval) {
+      sensor_changed = false;
       if (sensor_model != NULL && sensor_model->mutex != NULL) {
         if (osMutexAcquire(sensor_model->mutex, osWaitForever) ==
             osOK) {
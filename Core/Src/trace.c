@@ -0,0 +1,193 @@
+/**
+ ******************************************************************************
+ * @file           :  trace.c
+ * @brief          :  Low-overhead binary span trace ring
+ *
+ * @details        :  Event slots are reserved with an atomic increment of the
+ *                    ring counter (LDREX/STREX on the Cortex-M4), so
+ *                    recording needs no critical section. Task numbers are
+ *                    assigned once by Trace_Start() and read back with
+ *                    uxTaskGetTaskNumber(). Compiled only with
+ *                    OS_TRACE_ENABLED.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "trace.h"
+
+#if OS_TRACE_ENABLED
+#include "FreeRTOS.h"
+#include "cycle_counter.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if (OS_TRACE_RING_EVENTS & (OS_TRACE_RING_EVENTS - 1U)) != 0U
+#error "OS_TRACE_RING_EVENTS must be a power of two"
+#endif
+
+#define TRACE_RING_MASK (OS_TRACE_RING_EVENTS - 1U)
+#define TRACE_EVENTS_PER_LINE 8U
+#define TRACE_OBJECT_NONE 0xFFFFU
+
+/* Span names printed with the dump (indexed by TraceId_t) */
+static const char *const s_span_names[TRACE_ID_COUNT] = {
+    [TRACE_ID_SYSTEM_SM_RUN] = "SystemSM_Run",
+    [TRACE_ID_ROUTER_EVENT] = "Router_HandleEvent",
+    [TRACE_ID_ROUTER_TICK] = "Router_OnTick",
+    [TRACE_ID_LV_TIMER] = "lv_timer_handler",
+    [TRACE_ID_LV_FLUSH] = "flush_cb",
+    [TRACE_ID_SENSOR_LOOP] = "SensorLoop",
+    [TRACE_ID_FLASH_WRITE] = "write_config_to_flash",
+    [TRACE_ID_MUTEX_WAIT] = "MutexWait",
+};
+
+/* Recording stays paused until Trace_Start() */
+TraceRing_t g_trace_ring = {
+    .magic = TRACE_MAGIC,
+    .version = TRACE_VERSION,
+    .event_size = (uint16_t)sizeof(TraceEvent_t),
+    .capacity = OS_TRACE_RING_EVENTS,
+    .cpu_hz = 0U,
+    .count = 0U,
+    .paused = 1U,
+    .name_len = TRACE_NAME_LEN,
+    .max_tasks = TRACE_MAX_TASKS,
+    .max_objects = TRACE_MAX_OBJECTS,
+};
+
+/* Mutex handles matching g_trace_ring.object_names */
+static osMutexId_t s_objects[TRACE_MAX_OBJECTS];
+static volatile uint32_t s_object_count = 0U;
+
+/* Copy a name into a fixed, always terminated table slot */
+static void copy_name(char *dst, const char *src) {
+  if (src == NULL) {
+    src = "?";
+  }
+  strncpy(dst, src, TRACE_NAME_LEN - 1U);
+  dst[TRACE_NAME_LEN - 1U] = '\0';
+}
+
+/* Index of a mutex in the object table, registering it on first use */
+static uint16_t object_index(osMutexId_t mutex) {
+  uint32_t count = s_object_count;
+  for (uint32_t i = 0U; i < count; i++) {
+    if (s_objects[i] == mutex) {
+      return (uint16_t)i;
+    }
+  }
+
+  uint16_t index = TRACE_OBJECT_NONE;
+  const UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+  count = s_object_count;
+  for (uint32_t i = 0U; i < count; i++) {
+    if (s_objects[i] == mutex) {
+      index = (uint16_t)i;
+    }
+  }
+  if (index == TRACE_OBJECT_NONE && count < TRACE_MAX_OBJECTS) {
+    s_objects[count] = mutex;
+    copy_name(g_trace_ring.object_names[count], osMutexGetName(mutex));
+    __atomic_store_n(&s_object_count, count + 1U, __ATOMIC_RELEASE);
+    index = (uint16_t)count;
+  }
+  taskEXIT_CRITICAL_FROM_ISR(mask);
+  return index;
+}
+
+void Trace_Start(void) {
+  static TaskStatus_t status[TRACE_MAX_TASKS - 1U];
+  const UBaseType_t count =
+      uxTaskGetSystemState(status, TRACE_MAX_TASKS - 1U, NULL);
+
+  if (count == 0U) {
+    printf("TRACE: more than %u tasks, tasks left unnamed\n",
+           (unsigned)(TRACE_MAX_TASKS - 1U));
+  }
+
+  copy_name(g_trace_ring.task_names[0], "(other)");
+  for (UBaseType_t i = 0U; i < count; i++) {
+    vTaskSetTaskNumber(status[i].xHandle, i + 1U);
+    copy_name(g_trace_ring.task_names[i + 1U], status[i].pcTaskName);
+  }
+
+  g_trace_ring.cpu_hz = SystemCoreClock;
+  CycleCounter_Init();
+  g_trace_ring.paused = 0U;
+}
+
+void Trace_Record(TraceId_t id, TracePhase_t phase, uint16_t arg) {
+  if (g_trace_ring.paused != 0U) {
+    return;
+  }
+
+  const uint32_t slot =
+      __atomic_fetch_add(&g_trace_ring.count, 1U, __ATOMIC_RELAXED) &
+      TRACE_RING_MASK;
+  const UBaseType_t task = uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle());
+
+  TraceEvent_t *event = &g_trace_ring.events[slot];
+  event->cycles = CycleCounter_Get();
+  event->arg = arg;
+  event->id = (uint8_t)id;
+  event->task = (uint8_t)(((task & 0x3FU) << 2) | ((uint32_t)phase & 0x3U));
+}
+
+osStatus_t Trace_MutexAcquire(osMutexId_t mutex, uint32_t timeout) {
+  Trace_Record(TRACE_ID_MUTEX_WAIT, TRACE_PHASE_BEGIN, object_index(mutex));
+  const osStatus_t status = osMutexAcquire(mutex, timeout);
+  Trace_Record(TRACE_ID_MUTEX_WAIT, TRACE_PHASE_END,
+               (status == osOK) ? 1U : 0U);
+  return status;
+}
+
+void Trace_Dump(void) {
+  g_trace_ring.paused = 1U;
+
+  const uint32_t count = g_trace_ring.count;
+  const uint32_t first =
+      (count > OS_TRACE_RING_EVENTS) ? (count - OS_TRACE_RING_EVENTS) : 0U;
+
+  printf("TRACE BEGIN v=%u hz=%lu cap=%lu count=%lu size=%u\n",
+         (unsigned)TRACE_VERSION, (unsigned long)g_trace_ring.cpu_hz,
+         (unsigned long)OS_TRACE_RING_EVENTS, (unsigned long)count,
+         (unsigned)sizeof(TraceEvent_t));
+  for (uint32_t i = 0U; i < TRACE_ID_COUNT; i++) {
+    printf("TRACE SPAN %lu %s\n", (unsigned long)i, s_span_names[i]);
+  }
+  for (uint32_t i = 0U; i < TRACE_MAX_TASKS; i++) {
+    if (g_trace_ring.task_names[i][0] != '\0') {
+      printf("TRACE TASK %lu %s\n", (unsigned long)i,
+             g_trace_ring.task_names[i]);
+    }
+  }
+  for (uint32_t i = 0U; i < s_object_count; i++) {
+    printf("TRACE OBJ %lu %s\n", (unsigned long)i,
+           g_trace_ring.object_names[i]);
+  }
+
+  for (uint32_t n = first; n < count; n += TRACE_EVENTS_PER_LINE) {
+    printf("TRACE DATA ");
+    for (uint32_t k = n; k < count && k < n + TRACE_EVENTS_PER_LINE; k++) {
+      const uint8_t *bytes =
+          (const uint8_t *)&g_trace_ring.events[k & TRACE_RING_MASK];
+      for (uint32_t b = 0U; b < sizeof(TraceEvent_t); b++) {
+        printf("%02x", bytes[b]);
+      }
+    }
+    printf("\n");
+  }
+  printf("TRACE END\n");
+
+  g_trace_ring.paused = 0U;
+}
+
+#endif /* OS_TRACE_ENABLED */
@@ -30,7 +30,7 @@ float Utils_IndexToTemp(uint16_t index) {
   /* Special endpoints: index 0 = OFF (4.5°C), index 51 = ON (30.0°C) */
   if (index == 0)
     return 4.5f;
-  if (index == 51)
+  if (index >= UTILS_TEMP_INDEX_ON)
     return 30.0f;
 
   /* Linear interpolation: index N → 5.0 + (N-1) × 0.5 */
@@ -46,12 +46,22 @@ uint16_t Utils_TempToIndex(float temp) {
   if (temp <= 4.5f)
     return 0;  /* OFF */
   if (temp >= 30.0f)
-    return 51; /* ON */
+    return UTILS_TEMP_INDEX_ON;
 
   /* Reverse interpolation: map 5.0-29.5°C to indices 1-50 using 0.5°C steps */
   return (uint16_t)((temp - 5.0f) * 2.0f) + 1;
 }
 
+/**
+ * Convert temperature index to centidegrees; OFF and ON lie on the same
+ * 0.5°C grid, so every index is 4.5°C + N × 0.5°C.
+ */
+int32_t Utils_IndexToCentiDegrees(uint16_t index) {
+  if (index > UTILS_TEMP_INDEX_ON)
+    index = UTILS_TEMP_INDEX_ON;
+  return 450 + (int32_t)index * 50;
+}
+
 /**
  * Generate newline-separated temperature option string for UI roller widget.
  * Produces 52 options: OFF, 5.0, 5.5, ..., 29.5, ON
@@ -72,6 +82,24 @@ void Utils_GenerateTempOptions(char *buffer, size_t size) {
   (void)size; /* unused: buffer size validation handled by caller */
 }
 
+/**
+ * Day of the week by Sakamoto's method, which counts January and February
+ * as months of the previous year.
+ */
+uint8_t Utils_DayOfWeek(uint16_t year, uint8_t month, uint8_t day) {
+  static const uint8_t month_offset[12] = {0, 3, 2, 5, 0, 3,
+                                           5, 1, 4, 6, 2, 4};
+  if (month < 1 || month > 12)
+    return 1;
+
+  const uint32_t y = (month < 3) ? (uint32_t)year - 1U : year;
+  const uint32_t sunday_based =
+      (y + y / 4U - y / 100U + y / 400U + month_offset[month - 1] + day) % 7U;
+
+  /* 0 = Sunday -> 7 */
+  return (sunday_based == 0U) ? 7U : (uint8_t)sunday_based;
+}
+
 /**
  * Load factory preset daily heating/cooling schedule.
  * Supports 3-slot, 4-slot, or 5-slot configurations with predefined times/temps.
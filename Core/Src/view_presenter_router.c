@@ -22,10 +22,14 @@
 #include "change_schedule_view.h"
 #include "cmsis_os2.h"
 #include "factory_reset_presenter.h"
+#include "history_presenter.h"
+#include "history_view.h"
 #include "home_presenter.h"
 #include "home_view.h"
+#include "ipc_profile.h"
 #include "loading_presenter.h"
 #include "loading_view.h"
+#include "mem_heap.h"
 #include "menu_presenter.h"
 #include "menu_view.h"
 #include "set_date_time_presenter.h"
@@ -75,13 +79,25 @@ typedef struct {
 
   FactoryResetPresenter_t *factory_reset_presenter;
 
+  HistoryPresenter_t *history_presenter;
+  HistoryView_t *history_view;
+
   /* System communication and shared data */
   osMessageQueueId_t vp2system_queue;
   SystemModel_t *system_model;
   ConfigModel_t *config_model;
   SensorModel_t *sensor_model;
+  HistoryModel_t *history_model;
 } Router_State_t;
 
+/* Route names for the per-route heap report (indexed by RouteTypeDef) */
+static const char *const k_route_names[] = {
+    "INIT",     "DATE_TIME", "CHANGE_SCHEDULE", "NOT_INST",
+    "ADAPT",    "ADAPT_FAIL", "RUNNING",        "HOME",
+    "BOOST",    "MENU",      "EDIT_TEMP_OFFSET", "FACTORY_RESET",
+    "HISTORY",
+};
+
 /* Global router state instance */
 static Router_State_t g_router_state = {.current_route = ROUTE_INIT,
                                         .dt_presenter = NULL,
@@ -101,10 +117,13 @@ static Router_State_t g_router_state = {.current_route = ROUTE_INIT,
                                         .temp_offset_presenter = NULL,
                                         .temp_offset_view = NULL,
                                         .factory_reset_presenter = NULL,
+                                        .history_presenter = NULL,
+                                        .history_view = NULL,
                                         .vp2system_queue = NULL,
                                         .system_model = NULL,
                                         .config_model = NULL,
-                                        .sensor_model = NULL};
+                                        .sensor_model = NULL,
+                                        .history_model = NULL};
 
 /* Update debug LEDs based on button input (debug feature) */
 static void Router_UpdateDebugLeds(const Input2VPEvent_t *event) {
@@ -145,10 +164,10 @@ static void Router_UpdateDebugLeds(const Input2VPEvent_t *event) {
 static SystemState_t Router_GetSystemState(void) {
   SystemState_t state = STATE_INIT;
   if (g_router_state.system_model && g_router_state.system_model->mutex) {
-    if (osMutexAcquire(g_router_state.system_model->mutex, osWaitForever) ==
-        osOK) {
+    if (IPC_MUTEX_ACQUIRE(g_router_state.system_model->mutex,
+                          osWaitForever) == osOK) {
       state = g_router_state.system_model->data.state;
-      osMutexRelease(g_router_state.system_model->mutex);
+      IPC_MUTEX_RELEASE(g_router_state.system_model->mutex);
     } else {
       printf("Router: Failed to acquire system context mutex\n");
     }
@@ -161,7 +180,7 @@ static SystemState_t Router_GetSystemState(void) {
 /* Send user action event to system task */
 static void Router_SendSystemEvent(VP2SystemEventTypeDef event) {
   if (g_router_state.vp2system_queue) {
-    osMessageQueuePut(g_router_state.vp2system_queue, &event, 0, 0);
+    IPC_QUEUE_PUT(g_router_state.vp2system_queue, &event, 0, 0);
   }
 }
 
@@ -170,14 +189,17 @@ static void Router_SendSystemEvent(VP2SystemEventTypeDef event) {
  */
 void Router_Init(osMessageQueueId_t vp2system_queue,
                  SystemModel_t *system_model, ConfigModel_t *config_model,
-                 SensorModel_t *sensor_model) {
+                 SensorModel_t *sensor_model,
+                 HistoryModel_t *history_model) {
   g_router_state.vp2system_queue = vp2system_queue;
   g_router_state.system_model = system_model;
   g_router_state.config_model = config_model;
   g_router_state.sensor_model = sensor_model;
+  g_router_state.history_model = history_model;
 
   /* Start in INIT route */
   g_router_state.current_route = ROUTE_INIT;
+  MemHeap_SetRoute(ROUTE_INIT, k_route_names[ROUTE_INIT]);
 
   /* Initialize loading view for INIT */
   g_router_state.loading_view =
@@ -260,6 +282,16 @@ void Router_Deinit(void) {
     FactoryResetPresenter_Deinit(g_router_state.factory_reset_presenter);
     g_router_state.factory_reset_presenter = NULL;
   }
+
+  if (g_router_state.history_view) {
+    HistoryView_Deinit(g_router_state.history_view);
+    g_router_state.history_view = NULL;
+  }
+
+  if (g_router_state.history_presenter) {
+    HistoryPresenter_Deinit(g_router_state.history_presenter);
+    g_router_state.history_presenter = NULL;
+  }
 }
 
 /**
@@ -362,6 +394,10 @@ void Router_HandleEvent(const Input2VPEvent_t *event) {
         Router_GoToRoute(ROUTE_MENU);
       }
     }
+  } else if (g_router_state.current_route == ROUTE_HISTORY) {
+    if (g_router_state.history_presenter) {
+      HistoryPresenter_HandleEvent(g_router_state.history_presenter, event);
+    }
   }
   /* Other routes (INIT, RUNNING) have no specific interactions yet */
 }
@@ -412,7 +448,8 @@ void Router_OnTick(uint32_t current_tick) {
         g_router_state.current_route != ROUTE_BOOST &&
         g_router_state.current_route != ROUTE_EDIT_TEMP_OFFSET &&
         g_router_state.current_route != ROUTE_CHANGE_SCHEDULE &&
-        g_router_state.current_route != ROUTE_FACTORY_RESET) {
+        g_router_state.current_route != ROUTE_FACTORY_RESET &&
+        g_router_state.current_route != ROUTE_HISTORY) {
       targetRoute = ROUTE_HOME;
     }
     break;
@@ -453,6 +490,8 @@ void Router_OnTick(uint32_t current_tick) {
              g_router_state.factory_reset_presenter) {
     FactoryResetPresenter_Run(g_router_state.factory_reset_presenter,
                               current_tick);
+  } else if (route == ROUTE_HISTORY && g_router_state.history_presenter) {
+    HistoryPresenter_Run(g_router_state.history_presenter, current_tick);
   }
   /* Routes without periodic updates: DATE_TIME, CHANGE_SCHEDULE,
    * EDIT_TEMP_OFFSET */
@@ -465,6 +504,13 @@ void Router_GoToRoute(RouteTypeDef route) {
   if (g_router_state.current_route == route)
     return;
 
+  /* Charge the transition (old and new screen alive) to the new route */
+  MemHeap_SetRoute((uint32_t)route,
+                   ((size_t)route < sizeof(k_route_names) /
+                                        sizeof(k_route_names[0]))
+                       ? k_route_names[route]
+                       : "?");
+
   /* Initialize new route */
   if (route == ROUTE_DATE_TIME) {
     if (!g_router_state.dt_view) {
@@ -592,6 +638,14 @@ void Router_GoToRoute(RouteTypeDef route) {
       g_router_state.factory_reset_presenter =
           FactoryResetPresenter_Init(g_router_state.vp2system_queue);
     }
+  } else if (route == ROUTE_HISTORY) {
+    if (!g_router_state.history_view) {
+      g_router_state.history_view = HistoryView_Init();
+    }
+    if (g_router_state.history_view && !g_router_state.history_presenter) {
+      g_router_state.history_presenter = HistoryPresenter_Init(
+          g_router_state.history_view, g_router_state.history_model);
+    }
   }
 
   /* Cleanup old route */
@@ -685,6 +739,16 @@ void Router_GoToRoute(RouteTypeDef route) {
       g_router_state.factory_reset_presenter = NULL;
     }
     break;
+  case ROUTE_HISTORY:
+    if (g_router_state.history_presenter) {
+      HistoryPresenter_Deinit(g_router_state.history_presenter);
+      g_router_state.history_presenter = NULL;
+    }
+    if (g_router_state.history_view) {
+      HistoryView_Deinit(g_router_state.history_view);
+      g_router_state.history_view = NULL;
+    }
+    break;
   default:
     break;
   }
@@ -21,12 +21,24 @@
 #include "input_task.h"
 #include "lvgl_port_display.h"
 #include "main.h"
+#include "replay.h"
+#include "sensor_task.h"
 #include "task.h"
+#include "trace.h"
 #include "view_presenter_router.h"
 
 /* Display update interval in milliseconds */
 #define VIEW_DELAY_MS 10U
 
+/* Route one input event; a host replay reports its processing cost */
+static void handle_input_event(const Input2VPEvent_t *event) {
+  TRACE_BEGIN(TRACE_ID_ROUTER_EVENT, event->type);
+  const uint32_t replay_start = REPLAY_COST_START();
+  Router_HandleEvent(event);
+  REPLAY_COST_END((ReplayCost_t)event->type, replay_start);
+  TRACE_END(TRACE_ID_ROUTER_EVENT, event->type);
+}
+
 /* Main UI presentation task: handles input, routing, and display */
 void StartViewPresenterTask(void *argument) {
   const ViewPresenterTaskArgsTypeDef *args =
@@ -56,7 +68,7 @@ void StartViewPresenterTask(void *argument) {
 
   /* Initialize MVP router with all queues and data access */
   Router_Init(args->vp2system_event_queue, args->system_model,
-              args->config_model, args->sensor_model);
+              args->config_model, args->sensor_model, args->history_model);
 
   Input2VPEvent_t event;
   System2VPEventTypeDef sys_event;
@@ -86,7 +98,8 @@ void StartViewPresenterTask(void *argument) {
       printf("ViewPresenterTask: Received event type=%d\n", event.type);
 #endif
       /* Process single input event */
-      Router_HandleEvent(&event);
+      SensorTask_NotifyUserActivity();
+      handle_input_event(&event);
 
       /* Drain remaining queued events without blocking */
       while (osMessageQueueGet(input2vp_event_queue, &event, NULL, 0) == osOK) {
@@ -94,13 +107,15 @@ void StartViewPresenterTask(void *argument) {
         printf("ViewPresenterTask: Received event (drained) type=%d\n",
                event.type);
 #endif
-        Router_HandleEvent(&event);
+        handle_input_event(&event);
       }
     }
 
     /* Periodic display update: animations and state changes */
     /* This ensures continuous rendering even with no input */
+    TRACE_BEGIN(TRACE_ID_ROUTER_TICK, 0U);
     Router_OnTick(osKernelGetTickCount());
+    TRACE_END(TRACE_ID_ROUTER_TICK, 0U);
 
     /* Yield to allow other tasks (LVGL, sensor, storage) to run */
     osDelay(pdMS_TO_TICKS(5U));
@@ -0,0 +1,175 @@
+/**
+ ******************************************************************************
+ * @file           :  window_detect.c
+ * @brief          :  Open-window detection from the temperature slope
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+
+#include "window_detect.h"
+
+#include <stddef.h>
+
+#define MS_PER_MIN 60000
+
+void WindowSlope_Init(WindowSlope_t *slope) {
+  if (slope == NULL) {
+    return;
+  }
+  slope->head = 0U;
+  slope->count = 0U;
+}
+
+void WindowSlope_Add(WindowSlope_t *slope, uint32_t now_ms, int32_t cdeg) {
+  if (slope == NULL) {
+    return;
+  }
+  if (cdeg > INT16_MAX)
+    cdeg = INT16_MAX;
+  if (cdeg < INT16_MIN + 1)
+    cdeg = INT16_MIN + 1;
+
+  /* At the fast sampling period the ring would cover only a fraction of
+     the span: replace the newest sample until it is WINDOW_DETECT_GAP_MS
+     after the one before it */
+  uint8_t slot = slope->head;
+  if (slope->count >= 2U) {
+    const uint8_t newest = (uint8_t)((slope->head + WINDOW_DETECT_SAMPLES -
+                                      1U) %
+                                     WINDOW_DETECT_SAMPLES);
+    const uint8_t before = (uint8_t)((slope->head + WINDOW_DETECT_SAMPLES -
+                                      2U) %
+                                     WINDOW_DETECT_SAMPLES);
+    if (now_ms - slope->ms[before] < WINDOW_DETECT_GAP_MS) {
+      slot = newest;
+    }
+  }
+  slope->ms[slot] = now_ms;
+  slope->cdeg[slot] = (int16_t)cdeg;
+  if (slot == slope->head) {
+    slope->head = (uint8_t)((slope->head + 1U) % WINDOW_DETECT_SAMPLES);
+    if (slope->count < WINDOW_DETECT_SAMPLES) {
+      slope->count++;
+    }
+  }
+}
+
+int16_t WindowSlope_Get(const WindowSlope_t *slope) {
+  if (slope == NULL || slope->count < WINDOW_DETECT_MIN_SAMPLES) {
+    return WINDOW_DETECT_NO_SLOPE;
+  }
+
+  /* Times back from the newest sample and temperatures relative to it keep
+     the sums small: 16 samples of at most 2^20 ms and 2^16 cdeg leave the
+     numerator below 2^60 */
+  const uint8_t newest =
+      (uint8_t)((slope->head + WINDOW_DETECT_SAMPLES - 1U) %
+                WINDOW_DETECT_SAMPLES);
+  const uint32_t newest_ms = slope->ms[newest];
+  const int32_t newest_cdeg = slope->cdeg[newest];
+  int64_t n = 0;
+  int64_t sum_t = 0;
+  int64_t sum_y = 0;
+  int64_t sum_tt = 0;
+  int64_t sum_ty = 0;
+  uint32_t span_ms = 0U;
+
+  for (uint8_t i = 0U; i < slope->count; i++) {
+    const uint8_t index =
+        (uint8_t)((newest + WINDOW_DETECT_SAMPLES - i) % WINDOW_DETECT_SAMPLES);
+    const uint32_t age_ms = newest_ms - slope->ms[index];
+    if (age_ms > WINDOW_DETECT_SPAN_MS) {
+      break;
+    }
+    const int64_t t = -(int64_t)age_ms;
+    const int64_t y = (int64_t)slope->cdeg[index] - newest_cdeg;
+    n++;
+    sum_t += t;
+    sum_y += y;
+    sum_tt += t * t;
+    sum_ty += t * y;
+    span_ms = age_ms;
+  }
+
+  const int64_t denominator = n * sum_tt - sum_t * sum_t;
+  if (n < (int64_t)WINDOW_DETECT_MIN_SAMPLES ||
+      span_ms < WINDOW_DETECT_MIN_SPAN_MS || denominator <= 0) {
+    return WINDOW_DETECT_NO_SLOPE;
+  }
+
+  /* cdeg per ms to cdeg per minute, rounded half away from zero */
+  const int64_t numerator = (n * sum_ty - sum_t * sum_y) * MS_PER_MIN;
+  int64_t per_min = (numerator >= 0)
+                        ? (numerator + denominator / 2) / denominator
+                        : (numerator - denominator / 2) / denominator;
+  if (per_min > INT16_MAX)
+    per_min = INT16_MAX;
+  if (per_min <= WINDOW_DETECT_NO_SLOPE)
+    per_min = WINDOW_DETECT_NO_SLOPE + 1;
+  return (int16_t)per_min;
+}
+
+void WindowDetect_Init(WindowDetect_t *detect) {
+  if (detect == NULL) {
+    return;
+  }
+  detect->open = false;
+  detect->armed = true;
+  detect->open_ms = 0U;
+  detect->lowest_cdeg = 0;
+}
+
+WindowDetectEvent_t WindowDetect_Update(WindowDetect_t *detect,
+                                        uint32_t now_ms, int32_t cdeg,
+                                        int16_t slope_cdeg_min) {
+  if (detect == NULL) {
+    return WINDOW_DETECT_NONE;
+  }
+  const bool known = (slope_cdeg_min != WINDOW_DETECT_NO_SLOPE);
+
+  if (detect->open) {
+    if (cdeg < detect->lowest_cdeg) {
+      detect->lowest_cdeg = cdeg;
+    }
+    if (cdeg - detect->lowest_cdeg >= WINDOW_DETECT_RECOVER_CDEG) {
+      detect->open = false;
+      return WINDOW_DETECT_CLOSED;
+    }
+    if (now_ms - detect->open_ms >= WINDOW_DETECT_TIMEOUT_MS) {
+      detect->open = false;
+      return WINDOW_DETECT_TIMEOUT;
+    }
+    return WINDOW_DETECT_NONE;
+  }
+
+  /* Re-arm once the drop that was reported or cancelled has ended */
+  if (!detect->armed) {
+    if (!known || slope_cdeg_min > -WINDOW_DETECT_DROP_CDEG_PER_MIN / 2) {
+      detect->armed = true;
+    }
+    return WINDOW_DETECT_NONE;
+  }
+
+  if (known && slope_cdeg_min <= -WINDOW_DETECT_DROP_CDEG_PER_MIN) {
+    detect->open = true;
+    detect->armed = false;
+    detect->open_ms = now_ms;
+    detect->lowest_cdeg = cdeg;
+    return WINDOW_DETECT_OPENED;
+  }
+  return WINDOW_DETECT_NONE;
+}
+
+void WindowDetect_Cancel(WindowDetect_t *detect) {
+  if (detect == NULL) {
+    return;
+  }
+  detect->open = false;
+  detect->armed = false;
+}
@@ -46,7 +46,8 @@
  *=========================*/
 
 /*1: use custom malloc/free, 0: use the built-in `lv_mem_alloc()` and `lv_mem_free()`*/
-#define LV_MEM_CUSTOM 0
+/* Custom: LVGL shares the unified TLSF heap (Core/Inc/mem_heap.h) with FreeRTOS */
+#define LV_MEM_CUSTOM 1
 #if LV_MEM_CUSTOM == 0
     /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
     /* Important: Too small heap can cause frozen screen */
@@ -61,10 +62,10 @@
     #endif
 
 #else       /*LV_MEM_CUSTOM*/
-    #define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
-    #define LV_MEM_CUSTOM_ALLOC   malloc
-    #define LV_MEM_CUSTOM_FREE    free
-    #define LV_MEM_CUSTOM_REALLOC realloc
+    #define LV_MEM_CUSTOM_INCLUDE "mem_heap.h"   /*Header for the dynamic memory function*/
+    #define LV_MEM_CUSTOM_ALLOC   MemHeap_LvglAlloc
+    #define LV_MEM_CUSTOM_FREE    MemHeap_Free
+    #define LV_MEM_CUSTOM_REALLOC MemHeap_LvglRealloc
 #endif     /*LV_MEM_CUSTOM*/
 
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
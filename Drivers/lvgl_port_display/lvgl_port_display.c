@@ -16,8 +16,12 @@
  ******************************************************************************
  */
 #include "lvgl_port_display.h"
+#include "energy.h"
+#include "i2c_bus.h"
+#include "ipc_profile.h"
 #include "ssd1306.h"
 #include "task_debug.h"
+#include "trace.h"
 
 #include "FreeRTOS.h"
 #include "cmsis_os2.h"
@@ -40,6 +44,13 @@
 /* SH1106 maps RAM columns 2-129 to physical columns 0-127 */
 #define SH1106_COL_OFFSET 2
 
+/* I2C control bytes: the following bytes are commands or display data */
+#define SH1106_CONTROL_COMMAND 0x00U
+#define SH1106_CONTROL_DATA 0x40U
+
+/* Commands that address one page: page, lower and upper column */
+#define SH1106_PAGE_COMMANDS 3U
+
 /* Bit manipulation macros - optimized for speed */
 #define BIT_SET(a, b) ((a) |= (1U << (b)))
 #define BIT_CLEAR(a, b) ((a) &= ~(1U << (b)))
@@ -82,12 +93,15 @@
  */
 static osMutexId_t s_lvgl_mutex;
 
+/* Client id of the display on the shared I2C bus */
+static int32_t s_i2c_client = -1;
+
 /* Acquire LVGL rendering mutex for exclusive access */
 bool lv_port_lock(void) {
   if (s_lvgl_mutex == NULL) {
     return false;
   }
-  return osMutexAcquire(s_lvgl_mutex, osWaitForever) == osOK;
+  return IPC_MUTEX_ACQUIRE(s_lvgl_mutex, osWaitForever) == osOK;
 }
 
 /* Release LVGL rendering mutex */
@@ -95,7 +109,7 @@ void lv_port_unlock(void) {
   if (s_lvgl_mutex == NULL) {
     return;
   }
-  osMutexRelease(s_lvgl_mutex);
+  IPC_MUTEX_RELEASE(s_lvgl_mutex);
 }
 
 /* LVGL rendering task - handles timer callbacks and display updates */
@@ -111,7 +125,9 @@ void StartLVGLTask(void *argument) {
     /* Acquire lock for LVGL rendering */
     if (lv_port_lock()) {
       /* Handle LVGL timers and rendering */
+      TRACE_BEGIN(TRACE_ID_LV_TIMER, 0U);
       lv_timer_handler();
+      TRACE_END(TRACE_ID_LV_TIMER, 0U);
       lv_port_unlock();
     }
 
@@ -125,12 +141,13 @@ void StartLVGLTask(void *argument) {
  *
  * This callback is invoked by LVGL after rendering a portion of the display.
  * It transfers the rendered pixel data from the color buffer to the
- * SSD1306/SH1106 display via I2C.
+ * SSD1306/SH1106 display through the shared I2C bus (i2c_bus.h).
  *
  * The function:
  * 1. Calculates the page and column ranges for the update area
  * 2. Adjusts column addressing for SH1106 offset (columns 2-129)
- * 3. Writes each page of pixel data to the display
+ * 3. Writes each page as two bus transactions, page address commands and
+ *    pixel data, so other clients can use the bus between pages
  * 4. Notifies LVGL that the flush is complete
  *
  * @param[in] disp_drv    Pointer to LVGL display driver.
@@ -139,7 +156,7 @@ void StartLVGLTask(void *argument) {
  *                        Each byte represents 8 vertical pixels.
  *
  * @note This function is called automatically by LVGL during rendering.
- * @note Optimized for minimal I2C overhead with batch command writes.
+ * @note The three addressing commands of a page go in one transfer.
  *
  * @see rounder_cb()
  * @see set_pixel_cb()
@@ -151,6 +168,8 @@ static inline void flush_cb(lv_disp_drv_t *disp_drv, const lv_area_t *area,
   uint8_t row_end = area->y2 >> ROW_BITS;
   uint8_t *buf = (uint8_t *)color_p;
 
+  TRACE_BEGIN(TRACE_ID_LV_FLUSH, row_end - row_start + 1U);
+
   /* Calculate column addresses for the area width */
   uint16_t col_width = area->x2 - area->x1 + 1;
 
@@ -161,22 +180,52 @@ static inline void flush_cb(lv_disp_drv_t *disp_drv, const lv_area_t *area,
   uint8_t upper_col = SSD1306_UPPER_COL_ADDR |
                       ((col_start >> COL_SHIFT) & SSD1306_UPPER_COL_MASK);
 
-  /* Batch command writes to reduce I2C overhead */
+  uint8_t commands[SH1106_PAGE_COMMANDS] = {0U, lower_col, upper_col};
+  I2CBusTransaction_t command_txn = {.client = s_i2c_client,
+                                     .dev_addr = SSD1306_I2C_ADDR,
+                                     .mem_addr = SH1106_CONTROL_COMMAND,
+                                     .data = commands,
+                                     .size = SH1106_PAGE_COMMANDS};
+  I2CBusTransaction_t data_txn = {.client = s_i2c_client,
+                                  .dev_addr = SSD1306_I2C_ADDR,
+                                  .mem_addr = SH1106_CONTROL_DATA,
+                                  .size = col_width};
+
   for (uint8_t row = row_start; row <= row_end; row++) {
-    /* Set page address */
-    ssd1306_WriteCommand(SSD1306_PAGE_START_ADDR | row);
-    /* Set column address in one operation */
-    ssd1306_WriteCommand(lower_col);
-    ssd1306_WriteCommand(upper_col);
-
-    /* Write data directly with minimal overhead */
-    ssd1306_WriteData(buf, col_width);
+    /* Set page and column address */
+    commands[0] = SSD1306_PAGE_START_ADDR | row;
+    (void)I2CBus_Transfer(&command_txn);
+
+    data_txn.data = buf;
+    (void)I2CBus_Transfer(&data_txn);
     buf += col_width;
   }
 
+  /* Bytes on the bus: per page, the data and the three commands plus the
+   * address and control bytes of two transfers */
+  Energy_AddDisplayBytes((uint32_t)(row_end - row_start + 1U) *
+                         (col_width + SH1106_PAGE_COMMANDS + 4U));
+
+  TRACE_END(TRACE_ID_LV_FLUSH, 0U);
   lv_disp_flush_ready(disp_drv);
 }
 
+/* Pixel packing shared by set_pixel_cb() and the benchmarks */
+void lv_port_set_px(uint8_t *buf, lv_coord_t buf_w, lv_coord_t x,
+                    lv_coord_t y, bool on) {
+  /* Fast bit calculation without division/modulo */
+  const uint32_t row_offset = (uint32_t)(y >> ROW_BITS);
+  const uint32_t stride = (uint32_t)buf_w;
+  const uint32_t byte_index = (uint32_t)x + stride * row_offset;
+  const uint8_t bit_mask = 1U << (y & BIT_MASK);
+
+  if (on) {
+    buf[byte_index] |= bit_mask;
+  } else {
+    buf[byte_index] &= ~bit_mask;
+  }
+}
+
 /**
  * @brief Set pixel callback for drawing individual pixels.
  *
@@ -212,17 +261,7 @@ static inline void set_pixel_cb(struct _lv_disp_drv_t *disp_drv, uint8_t *buf,
   (void)disp_drv;
   (void)opa;
 
-  /* Fast bit calculation without division/modulo */
-  const uint32_t row_offset = (uint32_t)(y >> ROW_BITS);
-  const uint32_t stride = (uint32_t)buf_w;
-  const uint32_t byte_index = (uint32_t)x + stride * row_offset;
-  const uint8_t bit_mask = 1U << (y & BIT_MASK);
-
-  if (color.full) {
-    buf[byte_index] |= bit_mask;
-  } else {
-    buf[byte_index] &= ~bit_mask;
-  }
+  lv_port_set_px(buf, buf_w, x, y, color.full != 0U);
 }
 
 /**
@@ -299,7 +338,9 @@ void display_system_init(void) {
   const osMutexAttr_t mutex_attr = {
       .name = "LVGL Mutex", .attr_bits = osMutexPrioInherit | osMutexRecursive};
   s_lvgl_mutex = osMutexNew(&mutex_attr);
+  s_i2c_client = I2CBus_RegisterClient("display", I2C_BUS_PRIORITY_NORMAL);
 
+  /* Runs before the scheduler, so the driver may use the bus directly */
   ssd1306_Init();
   lv_init();
   lv_port_disp_init();
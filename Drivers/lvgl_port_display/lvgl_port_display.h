@@ -92,4 +92,19 @@ bool lv_port_lock(void);
  */
 void lv_port_unlock(void);
 
+/**
+ * @brief Set or clear one pixel in a page-organized monochrome buffer.
+ *
+ * Pixel packing used by set_pixel_cb(): 8 vertical pixels per byte, LSB on
+ * top, buf_w bytes per page. Exposed for the benchmarks.
+ *
+ * @param[in,out] buf    Pixel buffer.
+ * @param[in]     buf_w  Width of the buffer in pixels.
+ * @param[in]     x      X coordinate of the pixel.
+ * @param[in]     y      Y coordinate of the pixel.
+ * @param[in]     on     true to set the pixel, false to clear it.
+ */
+void lv_port_set_px(uint8_t *buf, lv_coord_t buf_w, lv_coord_t x,
+                    lv_coord_t y, bool on);
+
 #endif /* LVGL_PORT_DISPLAY_H */
@@ -0,0 +1,167 @@
+/**
+ ******************************************************************************
+ * @file           :  host_sim.h
+ * @brief          :  Simulated clock, environment and user input for the host
+ *                    (POSIX) build of the firmware.
+ *
+ * @details        :  The simulation runs as the highest-priority FreeRTOS task
+ *                    and plays the role of the hardware: it completes ADC DMA
+ *                    sequences from the environment model, drives the button
+ *                    and encoder lines, and executes commands from stdin or a
+ *                    script file. The kernel tick period is derived from the
+ *                    requested speed factor, so one simulated millisecond can
+ *                    elapse faster than real time. When replaying a trace
+ *                    (replay.h) the tick timer is off and the idle hook
+ *                    raises each tick instead, so simulated time advances
+ *                    only while every task is blocked (lockstep).
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include "stm32wbxx_hal.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum speed-up: one kernel tick per real microsecond */
+#define HOST_SIM_MAX_SPEED 1000U
+
+/* Duration of one 4-channel ADC sequence with 256x oversampling at
+ * 640.5 cycles per sample and a 1 MHz ADC clock */
+#define HOST_SIM_ADC_SEQUENCE_MS 668U
+
+/* Display RAM geometry of the SH1106 controller */
+#define HOST_SIM_DISPLAY_COLUMNS 132U
+#define HOST_SIM_DISPLAY_PAGES 8U
+
+/* Simulation options parsed by host_main.c */
+typedef struct {
+  uint32_t speed;             /* Simulated ms per real ms (1..MAX_SPEED) */
+  uint32_t duration_s;        /* Stop after this many simulated s, 0 = never */
+  const char *flash_path;     /* Persist the flash image here, may be NULL */
+  const char *display_path;   /* Write a PBM of the display on exit */
+  const char *script_path;    /* Command script executed in simulated time */
+  const char *record_path;    /* Write a replay trace here, may be NULL */
+  const char *replay_path;    /* Replay this trace in lockstep, may be NULL */
+  bool interactive;           /* Read commands from stdin */
+  uint16_t year;              /* Initial RTC calendar */
+  uint8_t month;
+  uint8_t day;
+  uint8_t hour;
+  uint8_t minute;
+} HostSimConfig_t;
+
+/* Simulated environment sampled by the ADC */
+typedef struct {
+  float ambient_temperature; /* Die temperature seen by TEMPSENSOR, degC */
+  float battery_voltage;     /* Voltage at the battery terminals, V */
+  float motor_current;       /* Motor current while driven, A */
+  float vdda;                /* Analog supply, V */
+  uint16_t adc_noise_lsb;    /* Peak uniform noise added to every sample */
+} HostSimEnvironment_t;
+
+/* Lifecycle */
+void HostSim_Init(const HostSimConfig_t *config);
+void HostSim_Start(void);
+void HostSim_Stop(int exit_code);
+
+/* Simulated clock (tick period 0 = lockstep, timer disarmed) */
+uint32_t HostSim_GetTickPeriodUs(void);
+uint64_t HostSim_GetTimeMs(void);
+
+/* Environment and input */
+void HostSim_GetEnvironment(HostSimEnvironment_t *env);
+void HostSim_SetEnvironment(const HostSimEnvironment_t *env);
+bool HostSim_ExecuteCommand(const char *line);
+
+/* Read a recorded trace into memory and hand it to Replay_Load(), which
+ * uses it in place; NULL if it cannot be read or is not a trace. The caller
+ * frees it once done with the replay. */
+uint8_t *HostSim_LoadTrace(const char *path);
+
+/* Offline evaluation of the temperature filter on a trace (filter_eval.c),
+ * returns the process exit code */
+int HostSim_FilterEval(const char *trace_path);
+
+/* Offline evaluation of the adaptive temperature sampling on a simulated
+ * day (sampling_eval.c), fails if a change above the threshold went unseen */
+int HostSim_SamplingEval(void);
+
+/* Offline evaluation of the battery state estimation on synthetic
+ * discharges (battery_eval.c), fails if the estimated SoC rose or strayed */
+int HostSim_BatteryEval(void);
+
+/* Offline evaluation of the motor cut-off on synthetic current waveforms
+ * (motor_guard_eval.c), fails on a wrong or late cut-off */
+int HostSim_MotorGuardEval(void);
+
+/* Fit of the self-heating compensation to a trace (self_heating_eval.c),
+ * returns the process exit code */
+int HostSim_SelfHeatingFit(const char *trace_path);
+
+/* Offline evaluation of the self-heating fit on a synthetic trace with a
+ * known ambient (self_heating_eval.c), fails if the fit does not halve the
+ * error */
+int HostSim_SelfHeatingEval(void);
+
+/* Offline check of the bit-packed configuration record (config_codec_eval.c),
+ * fails if a round trip changes a value or a corrupt encoding decodes to an
+ * invalid configuration */
+int HostSim_ConfigCodecEval(void);
+
+/* Optimum start on a simulated room over two weeks (optimum_start_eval.c),
+ * fails unless it cuts the shortfall at the start of warmer slots to a
+ * quarter */
+int HostSim_OptimumStartEval(void);
+
+/* Open-window detection on simulated room traces (window_eval.c), fails if
+ * a wide-open or tilted window is missed or reported late, or on false
+ * reports */
+int HostSim_WindowEval(void);
+
+/* Temperature history over a simulated month (history_eval.c), fails if a
+ * stored point differs from the samples it covers or a ring is short */
+int HostSim_HistoryEval(void);
+
+/* Valve position from motor current ripples on a simulated motor
+ * (ripple_eval.c), fails if a count misses the true ripples by more than
+ * RIPPLE_EVAL_MAX_ERROR or a blocked valve is not stopped */
+int HostSim_RippleEval(void);
+
+/* Ripple count of a recorded motor current trace (ripple_eval.c), fails if
+ * it misses the trace's reference count by more than RIPPLE_EVAL_MAX_ERROR */
+int HostSim_RippleTrace(const char *trace_path);
+
+/* ISR emulation: code between Enter/Exit runs in "handler mode" so the
+ * CMSIS-RTOS2 wrapper selects the FromISR kernel API */
+void HostSim_IsrEnter(uint32_t irq_number);
+void HostSim_IsrExit(void);
+
+/* Peripheral back-ends implemented in hal_shim.c */
+void HostShim_SetPin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+void HostShim_CompleteAdcSequence(const uint16_t *samples, uint32_t count);
+bool HostShim_IsAdcRunning(void);
+void HostShim_AddEncoderTicks(int32_t ticks);
+const uint8_t *HostShim_GetDisplayRam(void);
+bool HostShim_LoadFlash(const char *path);
+bool HostShim_SaveFlash(const char *path);
+void HostShim_SetRtcEpoch(uint16_t year, uint8_t month, uint8_t day,
+                          uint8_t hour, uint8_t minute);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_SIM_H */
@@ -0,0 +1,144 @@
+/**
+ ******************************************************************************
+ * @file           :  stm32wbxx.h
+ * @brief          :  Host replacement of the CMSIS device header for the
+ *                    STM32WB55 used by the POSIX build.
+ *
+ * @details        :  Provides the subset of core peripheral types, IRQ
+ *                    numbers and intrinsic functions referenced by the
+ *                    firmware, the CMSIS-RTOS2 wrapper and the HAL shims.
+ *                    Core registers (SysTick, SCB, DWT, CoreDebug) are plain
+ *                    RAM objects owned by hal_shim.c.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#ifndef HOST_STM32WBXX_H
+#define HOST_STM32WBXX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __IO volatile
+#define __I volatile const
+#define __O volatile
+
+#ifndef __weak
+#define __weak __attribute__((weak))
+#endif
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE static inline
+#endif
+#ifndef __STATIC_FORCEINLINE
+#define __STATIC_FORCEINLINE static inline
+#endif
+#ifndef __ALIGNED
+#define __ALIGNED(x) __attribute__((aligned(x)))
+#endif
+
+/* Interrupt numbers referenced by the firmware */
+typedef enum {
+  NonMaskableInt_IRQn = -14,
+  HardFault_IRQn = -13,
+  SVCall_IRQn = -5,
+  PendSV_IRQn = -2,
+  SysTick_IRQn = -1,
+  ADC1_IRQn = 18,
+  EXTI2_IRQn = 8,
+  EXTI3_IRQn = 9,
+  DMA1_Channel1_IRQn = 11,
+  DMA1_Channel2_IRQn = 12,
+  DMA1_Channel3_IRQn = 13,
+  EXTI9_5_IRQn = 23,
+  TIM1_TRG_COM_TIM17_IRQn = 26,
+  I2C1_EV_IRQn = 30,
+  I2C1_ER_IRQn = 31
+} IRQn_Type;
+
+/* SysTick registers (only touched by the CMSIS-RTOS2 wrapper) */
+typedef struct {
+  __IO uint32_t CTRL;
+  __IO uint32_t LOAD;
+  __IO uint32_t VAL;
+  __I uint32_t CALIB;
+} SysTick_Type;
+
+/* System control block: only the fields used by the firmware */
+typedef struct {
+  __IO uint32_t ICSR;
+  __IO uint32_t AIRCR;
+  __IO uint32_t SCR;
+  __IO uint32_t CPACR;
+} SCB_Type;
+
+/* Data watchpoint and trace unit: cycle counter */
+typedef struct {
+  __IO uint32_t CTRL;
+  __IO uint32_t CYCCNT;
+} DWT_Type;
+
+/* Core debug registers: trace enable */
+typedef struct {
+  __IO uint32_t DHCSR;
+  __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define SysTick_CTRL_ENABLE_Msk (1UL << 0)
+#define SysTick_CTRL_COUNTFLAG_Msk (1UL << 16)
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
+
+extern SysTick_Type HostSysTick;
+extern SCB_Type HostSCB;
+extern DWT_Type HostDWT;
+extern CoreDebug_Type HostCoreDebug;
+
+#define SysTick (&HostSysTick)
+#define SCB (&HostSCB)
+#define DWT (&HostDWT)
+#define CoreDebug (&HostCoreDebug)
+
+/* Interrupt state emulation, implemented in hal_shim.c */
+uint32_t HostSim_GetIpsr(void);
+void HostSim_DisableIrq(void);
+void HostSim_EnableIrq(void);
+void HostSim_SystemReset(void);
+
+static inline uint32_t __get_IPSR(void) { return HostSim_GetIpsr(); }
+static inline uint32_t __get_PRIMASK(void) { return 0U; }
+static inline uint32_t __get_BASEPRI(void) { return 0U; }
+static inline void __disable_irq(void) { HostSim_DisableIrq(); }
+static inline void __enable_irq(void) { HostSim_EnableIrq(); }
+static inline void __NOP(void) { __asm__ volatile("" ::: "memory"); }
+static inline void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __ISB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __WFI(void) {}
+
+static inline void NVIC_SystemReset(void) { HostSim_SystemReset(); }
+static inline void NVIC_SetPriority(IRQn_Type irqn, uint32_t priority) {
+  (void)irqn;
+  (void)priority;
+}
+static inline void NVIC_EnableIRQ(IRQn_Type irqn) { (void)irqn; }
+static inline void NVIC_DisableIRQ(IRQn_Type irqn) { (void)irqn; }
+
+/* Core clock, kept at the value SystemClock_Config() selects on target */
+extern uint32_t SystemCoreClock;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STM32WBXX_H */
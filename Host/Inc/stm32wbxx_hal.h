@@ -0,0 +1,556 @@
+/**
+ ******************************************************************************
+ * @file           :  stm32wbxx_hal.h
+ * @brief          :  Host replacement of the STM32WB HAL used by the POSIX
+ *                    build.
+ *
+ * @details        :  Declares the handle types, constants and functions the
+ *                    firmware references for GPIO, RCC, ADC/DMA, I2C, RTC,
+ *                    TIM, FLASH and PWR. Constants only need to be distinct,
+ *                    not register-accurate; the behaviour behind every call
+ *                    lives in hal_shim.c and is driven by the simulated
+ *                    environment in host_sim.c.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#ifndef HOST_STM32WBXX_HAL_H
+#define HOST_STM32WBXX_HAL_H
+
+#include "stm32wbxx.h"
+#include "stm32wbxx_hal_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ---------------------------------------------------------------- GPIO --- */
+typedef struct {
+  __IO uint32_t IDR;
+  __IO uint32_t ODR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef HostGPIOA;
+extern GPIO_TypeDef HostGPIOB;
+extern GPIO_TypeDef HostGPIOC;
+#define GPIOA (&HostGPIOA)
+#define GPIOB (&HostGPIOB)
+#define GPIOC (&HostGPIOC)
+
+typedef enum { GPIO_PIN_RESET = 0U, GPIO_PIN_SET } GPIO_PinState;
+
+typedef struct {
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+  uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+#define GPIO_PIN_0 ((uint16_t)0x0001)
+#define GPIO_PIN_1 ((uint16_t)0x0002)
+#define GPIO_PIN_2 ((uint16_t)0x0004)
+#define GPIO_PIN_3 ((uint16_t)0x0008)
+#define GPIO_PIN_4 ((uint16_t)0x0010)
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_7 ((uint16_t)0x0080)
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+#define GPIO_MODE_INPUT 0x00000000U
+#define GPIO_MODE_OUTPUT_PP 0x00000001U
+#define GPIO_MODE_OUTPUT_OD 0x00000011U
+#define GPIO_MODE_AF_PP 0x00000002U
+#define GPIO_MODE_ANALOG 0x00000003U
+#define GPIO_MODE_IT_RISING 0x10110000U
+#define GPIO_MODE_IT_FALLING 0x10210000U
+#define GPIO_MODE_IT_RISING_FALLING 0x10310000U
+#define GPIO_NOPULL 0x00000000U
+#define GPIO_PULLUP 0x00000001U
+#define GPIO_PULLDOWN 0x00000002U
+#define GPIO_SPEED_FREQ_LOW 0x00000000U
+#define GPIO_SPEED_FREQ_HIGH 0x00000002U
+#define GPIO_AF4_I2C1 0x04U
+#define GPIO_AF10_USB 0x0AU
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+                       GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+/* ----------------------------------------------------------- RCC / PWR --- */
+typedef struct {
+  uint32_t PLLState;
+  uint32_t PLLSource;
+  uint32_t PLLM;
+  uint32_t PLLN;
+  uint32_t PLLP;
+  uint32_t PLLQ;
+  uint32_t PLLR;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+  uint32_t OscillatorType;
+  uint32_t HSEState;
+  uint32_t LSEState;
+  uint32_t HSIState;
+  uint32_t HSICalibrationValue;
+  uint32_t LSIState;
+  uint32_t MSIState;
+  uint32_t MSICalibrationValue;
+  uint32_t MSIClockRange;
+  RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+  uint32_t ClockType;
+  uint32_t SYSCLKSource;
+  uint32_t AHBCLKDivider;
+  uint32_t APB1CLKDivider;
+  uint32_t APB2CLKDivider;
+  uint32_t AHBCLK2Divider;
+  uint32_t AHBCLK4Divider;
+} RCC_ClkInitTypeDef;
+
+typedef struct {
+  uint32_t PeriphClockSelection;
+  uint32_t I2c1ClockSelection;
+  uint32_t RTCClockSelection;
+  uint32_t AdcClockSelection;
+  uint32_t SmpsClockSelection;
+  uint32_t SmpsDivSelection;
+} RCC_PeriphCLKInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_HSI 0x00000002U
+#define RCC_OSCILLATORTYPE_LSI1 0x00000008U
+#define RCC_OSCILLATORTYPE_MSI 0x00000020U
+#define RCC_HSI_ON 0x00000100U
+#define RCC_MSI_ON 0x00000001U
+#define RCC_LSI_ON 0x00000001U
+#define RCC_HSICALIBRATION_DEFAULT 64U
+#define RCC_MSICALIBRATION_DEFAULT 0U
+#define RCC_MSIRANGE_10 0x000000A0U
+#define RCC_PLL_ON 0x00000002U
+#define RCC_PLLSOURCE_MSI 0x00000001U
+#define RCC_PLLM_DIV2 0x00000010U
+#define RCC_PLLP_DIV2 0x00020000U
+#define RCC_PLLQ_DIV2 0x02000000U
+#define RCC_PLLR_DIV2 0x20000000U
+#define RCC_CLOCKTYPE_SYSCLK 0x00000001U
+#define RCC_CLOCKTYPE_HCLK 0x00000002U
+#define RCC_CLOCKTYPE_PCLK1 0x00000004U
+#define RCC_CLOCKTYPE_PCLK2 0x00000008U
+#define RCC_CLOCKTYPE_HCLK2 0x00000020U
+#define RCC_CLOCKTYPE_HCLK4 0x00000040U
+#define RCC_SYSCLKSOURCE_MSI 0x00000000U
+#define RCC_SYSCLK_DIV1 0x00000000U
+#define RCC_HCLK_DIV1 0x00000000U
+#define RCC_PERIPHCLK_SMPS 0x00001000U
+#define RCC_SMPSCLKSOURCE_HSI 0x00000000U
+#define RCC_SMPSCLKDIV_RANGE0 0x00000000U
+#define FLASH_LATENCY_1 0x00000001U
+#define PWR_REGULATOR_VOLTAGE_SCALE1 0x00000200U
+
+#define __HAL_PWR_VOLTAGESCALING_CONFIG(__REGULATOR__) ((void)(__REGULATOR__))
+#define __HAL_RCC_GPIOA_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_DMAMUX1_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_DMA1_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_ADC_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_I2C1_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_TIM2_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_RTC_ENABLE() ((void)0)
+#define __HAL_RCC_RTCAPB_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_HSEM_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_BACKUPRESET_FORCE() HostSim_BackupDomainReset()
+#define __HAL_RCC_BACKUPRESET_RELEASE() ((void)0)
+
+void HostSim_BackupDomainReset(void);
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct,
+                                      uint32_t FLatency);
+HAL_StatusTypeDef
+HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit);
+void HAL_PWR_EnableBkUpAccess(void);
+void HAL_PWR_DisableBkUpAccess(void);
+
+/* ---------------------------------------------------------------- NVIC --- */
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority,
+                          uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+/* ----------------------------------------------------------------- DMA --- */
+typedef struct {
+  uint32_t Request;
+  uint32_t Direction;
+  uint32_t PeriphInc;
+  uint32_t MemInc;
+  uint32_t PeriphDataAlignment;
+  uint32_t MemDataAlignment;
+  uint32_t Mode;
+  uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+  void *Instance;
+  DMA_InitTypeDef Init;
+  void *Parent;
+} DMA_HandleTypeDef;
+
+/* ----------------------------------------------------------------- ADC --- */
+typedef struct {
+  uint32_t Ratio;
+  uint32_t RightBitShift;
+  uint32_t TriggeredMode;
+  uint32_t OversamplingStopReset;
+} ADC_OversamplingTypeDef;
+
+typedef struct {
+  uint32_t ClockPrescaler;
+  uint32_t Resolution;
+  uint32_t DataAlign;
+  uint32_t ScanConvMode;
+  uint32_t EOCSelection;
+  FunctionalState LowPowerAutoWait;
+  FunctionalState ContinuousConvMode;
+  uint32_t NbrOfConversion;
+  FunctionalState DiscontinuousConvMode;
+  uint32_t NbrOfDiscConversion;
+  uint32_t ExternalTrigConv;
+  uint32_t ExternalTrigConvEdge;
+  FunctionalState DMAContinuousRequests;
+  uint32_t Overrun;
+  FunctionalState OversamplingMode;
+  ADC_OversamplingTypeDef Oversampling;
+} ADC_InitTypeDef;
+
+typedef struct {
+  uint32_t Channel;
+  uint32_t Rank;
+  uint32_t SamplingTime;
+  uint32_t SingleDiff;
+  uint32_t OffsetNumber;
+  uint32_t Offset;
+} ADC_ChannelConfTypeDef;
+
+typedef struct {
+  uint32_t id;
+} ADC_TypeDef;
+
+extern ADC_TypeDef HostADC1;
+#define ADC1 (&HostADC1)
+
+typedef struct __ADC_HandleTypeDef {
+  ADC_TypeDef *Instance;
+  ADC_InitTypeDef Init;
+  DMA_HandleTypeDef *DMA_Handle;
+  HAL_LockTypeDef Lock;
+  __IO uint32_t State;
+  __IO uint32_t ErrorCode;
+} ADC_HandleTypeDef;
+
+#define ADC_CLOCK_ASYNC_DIV1 0x00000000U
+#define ADC_RESOLUTION_12B 0x00000000U
+#define ADC_DATAALIGN_RIGHT 0x00000000U
+#define ADC_SCAN_ENABLE 0x00000001U
+#define ADC_SCAN_DISABLE 0x00000000U
+#define ADC_EOC_SINGLE_CONV 0x00000004U
+#define ADC_EOC_SEQ_CONV 0x00000008U
+#define ADC_SOFTWARE_START 0x00000001U
+#define ADC_EXTERNALTRIGCONVEDGE_NONE 0x00000000U
+#define ADC_OVR_DATA_PRESERVED 0x00000000U
+#define ADC_OVR_DATA_OVERWRITTEN 0x00001000U
+#define ADC_OVERSAMPLING_RATIO_4 0x00000004U
+#define ADC_OVERSAMPLING_RATIO_256 0x0000001CU
+#define ADC_RIGHTBITSHIFT_2 0x00000040U
+#define ADC_RIGHTBITSHIFT_8 0x00000100U
+#define ADC_TRIGGEREDMODE_SINGLE_TRIGGER 0x00000000U
+#define ADC_REGOVERSAMPLING_CONTINUED_MODE 0x00000000U
+#define ADC_CHANNEL_VREFINT 0x80000000U
+#define ADC_CHANNEL_TEMPSENSOR 0x80000011U
+#define ADC_CHANNEL_VBAT 0x80000012U
+#define ADC_CHANNEL_1 0x00000001U
+#define ADC_REGULAR_RANK_1 0x00000006U
+#define ADC_REGULAR_RANK_2 0x0000000CU
+#define ADC_REGULAR_RANK_3 0x00000012U
+#define ADC_REGULAR_RANK_4 0x00000018U
+#define ADC_SAMPLETIME_640CYCLES_5 0x00000007U
+#define ADC_SINGLE_ENDED 0x7F0000U
+#define ADC_OFFSET_NONE 0x00000004U
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc,
+                                        ADC_ChannelConfTypeDef *sConfig);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData,
+                                    uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc,
+                                              uint32_t SingleDiff);
+HAL_StatusTypeDef HAL_ADCEx_EnterADCDeepPowerDownMode(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+
+/* ----------------------------------------------------------------- I2C --- */
+typedef struct {
+  uint32_t Timing;
+  uint32_t OwnAddress1;
+  uint32_t AddressingMode;
+  uint32_t DualAddressMode;
+  uint32_t OwnAddress2;
+  uint32_t OwnAddress2Masks;
+  uint32_t GeneralCallMode;
+  uint32_t NoStretchMode;
+} I2C_InitTypeDef;
+
+typedef struct {
+  uint32_t id;
+} I2C_TypeDef;
+
+extern I2C_TypeDef HostI2C1;
+#define I2C1 (&HostI2C1)
+
+typedef struct __I2C_HandleTypeDef {
+  I2C_TypeDef *Instance;
+  I2C_InitTypeDef Init;
+  DMA_HandleTypeDef *hdmatx;
+  DMA_HandleTypeDef *hdmarx;
+  HAL_LockTypeDef Lock;
+  __IO uint32_t State;
+  __IO uint32_t ErrorCode;
+} I2C_HandleTypeDef;
+
+#define I2C_ADDRESSINGMODE_7BIT 0x00000001U
+#define I2C_DUALADDRESS_DISABLE 0x00000000U
+#define I2C_OA2_NOMASK 0x00U
+#define I2C_GENERALCALL_DISABLE 0x00000000U
+#define I2C_NOSTRETCH_DISABLE 0x00000000U
+#define I2C_ANALOGFILTER_ENABLE 0x00000000U
+#define I2C_FASTMODEPLUS_I2C1 0x00000100U
+#define I2C_MEMADD_SIZE_8BIT 0x00000001U
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2CEx_ConfigAnalogFilter(I2C_HandleTypeDef *hi2c,
+                                               uint32_t AnalogFilter);
+HAL_StatusTypeDef HAL_I2CEx_ConfigDigitalFilter(I2C_HandleTypeDef *hi2c,
+                                                uint32_t DigitalFilter);
+void HAL_I2CEx_EnableFastModePlus(uint32_t ConfigFastModePlus);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c,
+                                    uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData,
+                                    uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c,
+                                   uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData,
+                                   uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c,
+                                        uint16_t DevAddress,
+                                        uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData,
+                                        uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c,
+                                       uint16_t DevAddress,
+                                       uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData,
+                                       uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c,
+                                          uint16_t DevAddress, uint8_t *pData,
+                                          uint16_t Size, uint32_t Timeout);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+/* ----------------------------------------------------------------- RTC --- */
+typedef struct {
+  uint32_t HourFormat;
+  uint32_t AsynchPrediv;
+  uint32_t SynchPrediv;
+  uint32_t OutPut;
+  uint32_t OutPutRemap;
+  uint32_t OutPutPolarity;
+  uint32_t OutPutType;
+} RTC_InitTypeDef;
+
+typedef struct {
+  uint32_t id;
+} RTC_TypeDef;
+
+extern RTC_TypeDef HostRTC;
+#define RTC (&HostRTC)
+
+typedef struct {
+  RTC_TypeDef *Instance;
+  RTC_InitTypeDef Init;
+  HAL_LockTypeDef Lock;
+  __IO uint32_t State;
+} RTC_HandleTypeDef;
+
+typedef struct {
+  uint8_t Hours;
+  uint8_t Minutes;
+  uint8_t Seconds;
+  uint8_t TimeFormat;
+  uint32_t SubSeconds;
+  uint32_t SecondFraction;
+  uint32_t DayLightSaving;
+  uint32_t StoreOperation;
+} RTC_TimeTypeDef;
+
+typedef struct {
+  uint8_t WeekDay;
+  uint8_t Month;
+  uint8_t Date;
+  uint8_t Year;
+} RTC_DateTypeDef;
+
+#define RTC_HOURFORMAT_24 0x00000000U
+#define RTC_OUTPUT_DISABLE 0x00000000U
+#define RTC_OUTPUT_POLARITY_HIGH 0x00000000U
+#define RTC_OUTPUT_TYPE_OPENDRAIN 0x00000000U
+#define RTC_OUTPUT_REMAP_NONE 0x00000000U
+#define RTC_FORMAT_BIN 0x00000000U
+#define RTC_FORMAT_BCD 0x00000001U
+#define RTC_HOURFORMAT12_AM ((uint8_t)0x00)
+#define RTC_DAYLIGHTSAVING_NONE 0x00000000U
+#define RTC_DAYLIGHTSAVING_ADD1H 0x00010000U
+#define RTC_STOREOPERATION_RESET 0x00000000U
+#define RTC_WEEKDAY_MONDAY ((uint8_t)0x01)
+#define RTC_WEEKDAY_TUESDAY ((uint8_t)0x02)
+#define RTC_WEEKDAY_WEDNESDAY ((uint8_t)0x03)
+#define RTC_WEEKDAY_THURSDAY ((uint8_t)0x04)
+#define RTC_WEEKDAY_FRIDAY ((uint8_t)0x05)
+#define RTC_WEEKDAY_SATURDAY ((uint8_t)0x06)
+#define RTC_WEEKDAY_SUNDAY ((uint8_t)0x07)
+#define RTC_MONTH_JANUARY ((uint8_t)0x01)
+
+HAL_StatusTypeDef HAL_RTC_Init(RTC_HandleTypeDef *hrtc);
+HAL_StatusTypeDef HAL_RTC_SetTime(RTC_HandleTypeDef *hrtc,
+                                  RTC_TimeTypeDef *sTime, uint32_t Format);
+HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef *hrtc,
+                                  RTC_TimeTypeDef *sTime, uint32_t Format);
+HAL_StatusTypeDef HAL_RTC_SetDate(RTC_HandleTypeDef *hrtc,
+                                  RTC_DateTypeDef *sDate, uint32_t Format);
+HAL_StatusTypeDef HAL_RTC_GetDate(RTC_HandleTypeDef *hrtc,
+                                  RTC_DateTypeDef *sDate, uint32_t Format);
+
+/* ----------------------------------------------------------------- TIM --- */
+typedef struct {
+  __IO uint32_t CNT;
+} TIM_TypeDef;
+
+extern TIM_TypeDef HostTIM2;
+extern TIM_TypeDef HostTIM17;
+#define TIM2 (&HostTIM2)
+#define TIM17 (&HostTIM17)
+
+typedef struct {
+  uint32_t Prescaler;
+  uint32_t CounterMode;
+  uint32_t Period;
+  uint32_t ClockDivision;
+  uint32_t RepetitionCounter;
+  uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+  TIM_TypeDef *Instance;
+  TIM_Base_InitTypeDef Init;
+  HAL_LockTypeDef Lock;
+  __IO uint32_t State;
+} TIM_HandleTypeDef;
+
+typedef struct {
+  uint32_t EncoderMode;
+  uint32_t IC1Polarity;
+  uint32_t IC1Selection;
+  uint32_t IC1Prescaler;
+  uint32_t IC1Filter;
+  uint32_t IC2Polarity;
+  uint32_t IC2Selection;
+  uint32_t IC2Prescaler;
+  uint32_t IC2Filter;
+} TIM_Encoder_InitTypeDef;
+
+typedef struct {
+  uint32_t MasterOutputTrigger;
+  uint32_t MasterOutputTrigger2;
+  uint32_t MasterSlaveMode;
+} TIM_MasterConfigTypeDef;
+
+#define TIM_COUNTERMODE_UP 0x00000000U
+#define TIM_CLOCKDIVISION_DIV1 0x00000000U
+#define TIM_AUTORELOAD_PRELOAD_DISABLE 0x00000000U
+#define TIM_ENCODERMODE_TI12 0x00000003U
+#define TIM_ICPOLARITY_FALLING 0x00000002U
+#define TIM_ICSELECTION_DIRECTTI 0x00000001U
+#define TIM_ICPSC_DIV1 0x00000000U
+#define TIM_TRGO_RESET 0x00000000U
+#define TIM_MASTERSLAVEMODE_DISABLE 0x00000000U
+#define TIM_CHANNEL_ALL 0x0000003CU
+
+#define __HAL_TIM_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Instance->CNT)
+#define __HAL_TIM_SET_COUNTER(__HANDLE__, __COUNTER__)                         \
+  ((__HANDLE__)->Instance->CNT = (__COUNTER__))
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim,
+                                       TIM_Encoder_InitTypeDef *sConfig);
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim,
+                                        uint32_t Channel);
+HAL_StatusTypeDef
+HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim,
+                                      TIM_MasterConfigTypeDef *sMasterConfig);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+/* --------------------------------------------------------------- FLASH --- */
+/* Simulated flash array, see hal_shim.c. FLASH_BASE keeps the pointer width of
+ * the host so that direct reads through it work as on target. */
+#define HOST_FLASH_SIZE (512U * 1024U)
+extern uint8_t HostFlash[HOST_FLASH_SIZE];
+#define FLASH_BASE ((uintptr_t)HostFlash)
+#define FLASH_PAGE_SIZE 0x00001000U
+#define FLASH_TYPEERASE_PAGES 0x00000000U
+#define FLASH_TYPEPROGRAM_DOUBLEWORD 0x00000001U
+
+typedef struct {
+  uint32_t TypeErase;
+  uint32_t Page;
+  uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address,
+                                    uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit,
+                                    uint32_t *PageError);
+
+/* -------------------------------------------------------------- System --- */
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STM32WBXX_HAL_H */
@@ -0,0 +1,20 @@
+/**
+ ******************************************************************************
+ * @file           :  stm32wbxx_hal_adc_ex.h
+ * @brief          :  Host replacement of the ADC extended HAL header. The
+ *                    extended API is declared in the stm32wbxx_hal.h shim.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#ifndef HOST_STM32WBXX_HAL_ADC_EX_H
+#define HOST_STM32WBXX_HAL_ADC_EX_H
+
+#include "stm32wbxx_hal.h"
+
+#endif /* HOST_STM32WBXX_HAL_ADC_EX_H */
@@ -0,0 +1,45 @@
+/**
+ ******************************************************************************
+ * @file           :  stm32wbxx_hal_def.h
+ * @brief          :  Host replacement of the HAL common definitions.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#ifndef HOST_STM32WBXX_HAL_DEF_H
+#define HOST_STM32WBXX_HAL_DEF_H
+
+#include "stm32wbxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  HAL_OK = 0x00U,
+  HAL_ERROR = 0x01U,
+  HAL_BUSY = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum { HAL_UNLOCKED = 0x00U, HAL_LOCKED = 0x01U } HAL_LockTypeDef;
+
+typedef enum { DISABLE = 0U, ENABLE = !DISABLE } FunctionalState;
+typedef enum { RESET = 0U, SET = !RESET } FlagStatus, ITStatus;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+#ifndef UNUSED
+#define UNUSED(X) (void)X
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STM32WBXX_HAL_DEF_H */
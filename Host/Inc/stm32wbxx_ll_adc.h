@@ -0,0 +1,84 @@
+/**
+ ******************************************************************************
+ * @file           :  stm32wbxx_ll_adc.h
+ * @brief          :  Host replacement of the ADC low-layer helper macros.
+ *
+ * @details        :  The conversion macros are copied in behaviour from the
+ *                    STM32WB LL driver; the factory calibration words live in
+ *                    hal_shim.c instead of the system memory area so the
+ *                    firmware conversions produce the same integers as on
+ *                    target.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#ifndef HOST_STM32WBXX_LL_ADC_H
+#define HOST_STM32WBXX_LL_ADC_H
+
+#include "stm32wbxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LL_ADC_RESOLUTION_12B 0x00000000UL
+#define LL_ADC_RESOLUTION_10B 0x00000008UL
+#define LL_ADC_RESOLUTION_8B 0x00000010UL
+#define LL_ADC_RESOLUTION_6B 0x00000018UL
+
+/* Factory calibration words, see HostSim calibration in hal_shim.c */
+extern const uint16_t HostVrefintCal;
+extern const uint16_t HostTsCal1;
+extern const uint16_t HostTsCal2;
+
+#define VREFINT_CAL_ADDR (&HostVrefintCal)
+#define VREFINT_CAL_VREF 3600UL
+#define TEMPSENSOR_CAL1_ADDR (&HostTsCal1)
+#define TEMPSENSOR_CAL2_ADDR (&HostTsCal2)
+#define TEMPSENSOR_CAL1_TEMP 30L
+#define TEMPSENSOR_CAL2_TEMP 130L
+#define TEMPSENSOR_CAL_VREFANALOG 3600UL
+
+#define __LL_ADC_DIGITAL_SCALE(__ADC_RESOLUTION__)                             \
+  (0xFFFUL >> ((__ADC_RESOLUTION__) >> 2UL))
+
+#define __LL_ADC_CONVERT_DATA_RESOLUTION(__DATA__, __ADC_RESOLUTION_CURRENT__, \
+                                         __ADC_RESOLUTION_TARGET__)            \
+  (((__DATA__) << ((__ADC_RESOLUTION_CURRENT__) >> 2UL)) >>                    \
+   ((__ADC_RESOLUTION_TARGET__) >> 2UL))
+
+#define __LL_ADC_CALC_DATA_TO_VOLTAGE(__VREFANALOG_VOLTAGE__, __ADC_DATA__,    \
+                                      __ADC_RESOLUTION__)                      \
+  ((__ADC_DATA__) * (__VREFANALOG_VOLTAGE__) /                                 \
+   __LL_ADC_DIGITAL_SCALE(__ADC_RESOLUTION__))
+
+#define __LL_ADC_CALC_VREFANALOG_VOLTAGE(__VREFINT_ADC_DATA__,                 \
+                                         __ADC_RESOLUTION__)                   \
+  (((uint32_t)(*VREFINT_CAL_ADDR) * VREFINT_CAL_VREF) /                        \
+   __LL_ADC_CONVERT_DATA_RESOLUTION((__VREFINT_ADC_DATA__),                    \
+                                    (__ADC_RESOLUTION__),                      \
+                                    LL_ADC_RESOLUTION_12B))
+
+#define __LL_ADC_CALC_TEMPERATURE(__VREFANALOG_VOLTAGE__,                      \
+                                  __TEMPSENSOR_ADC_DATA__, __ADC_RESOLUTION__) \
+  (((((int32_t)((__LL_ADC_CONVERT_DATA_RESOLUTION((__TEMPSENSOR_ADC_DATA__),   \
+                                                  (__ADC_RESOLUTION__),        \
+                                                  LL_ADC_RESOLUTION_12B) *     \
+                 (__VREFANALOG_VOLTAGE__)) /                                   \
+                TEMPSENSOR_CAL_VREFANALOG) -                                   \
+      (int32_t) * TEMPSENSOR_CAL1_ADDR)) *                                     \
+    (int32_t)(TEMPSENSOR_CAL2_TEMP - TEMPSENSOR_CAL1_TEMP)) /                  \
+       (int32_t)((int32_t) * TEMPSENSOR_CAL2_ADDR -                            \
+                 (int32_t) * TEMPSENSOR_CAL1_ADDR) +                           \
+   TEMPSENSOR_CAL1_TEMP)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STM32WBXX_LL_ADC_H */
@@ -0,0 +1,61 @@
+/**
+ ******************************************************************************
+ * @file           :  stm32wbxx_nucleo.h
+ * @brief          :  Host replacement of the Nucleo-64 BSP (LEDs, user
+ *                    buttons and the VCOM log port). LED changes are reported
+ *                    on stdout, printf already goes to the console.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#ifndef HOST_STM32WBXX_NUCLEO_H
+#define HOST_STM32WBXX_NUCLEO_H
+
+#include "stm32wbxx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum { LED1 = 0, LED2 = 1, LED3 = 2, LEDn } Led_TypeDef;
+#define LED_BLUE LED1
+#define LED_GREEN LED2
+#define LED_RED LED3
+
+typedef enum { BUTTON_SW1 = 0, BUTTON_SW2 = 1, BUTTON_SW3 = 2 } Button_TypeDef;
+typedef enum { BUTTON_MODE_GPIO = 0, BUTTON_MODE_EXTI = 1 } ButtonMode_TypeDef;
+
+typedef enum { COM1 = 0U, COMn } COM_TypeDef;
+typedef enum { COM_WORDLENGTH_8B = 0x0000U } COM_WordLengthTypeDef;
+typedef enum { COM_STOPBITS_1 = 0x0000U } COM_StopBitsTypeDef;
+typedef enum { COM_PARITY_NONE = 0x0000U } COM_ParityTypeDef;
+typedef enum { COM_HWCONTROL_NONE = 0x0000U } COM_HwFlowCtlTypeDef;
+
+typedef struct {
+  uint32_t BaudRate;
+  COM_WordLengthTypeDef WordLength;
+  COM_StopBitsTypeDef StopBits;
+  COM_ParityTypeDef Parity;
+  COM_HwFlowCtlTypeDef HwFlowCtl;
+} COM_InitTypeDef;
+
+#define BSP_ERROR_NONE 0
+
+int32_t BSP_LED_Init(Led_TypeDef Led);
+int32_t BSP_LED_On(Led_TypeDef Led);
+int32_t BSP_LED_Off(Led_TypeDef Led);
+int32_t BSP_LED_Toggle(Led_TypeDef Led);
+int32_t BSP_PB_Init(Button_TypeDef Button, ButtonMode_TypeDef ButtonMode);
+int32_t BSP_COM_Init(COM_TypeDef COM, COM_InitTypeDef *COM_Init);
+int32_t BSP_COM_SelectLogPort(COM_TypeDef COM);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STM32WBXX_NUCLEO_H */
@@ -0,0 +1,337 @@
+/**
+ ******************************************************************************
+ * @file           :  battery_eval.c
+ * @brief          :  Offline evaluation of the battery state estimation on
+ *                    synthetic discharges (--battery-eval).
+ *
+ * @details        :  Discharges a model of two alkaline AA cells (open
+ *                    circuit voltage from the curve of
+ *                    SensorCalc_BatterySoc(), an internal resistance that
+ *                    grows as the cells empty, and a polarisation that
+ *                    builds up under load and decays afterwards) with a
+ *                    constant base drain and daily valve motor runs. The
+ *                    battery voltage goes through the 12-bit VBAT
+ *                    conversion with +-1 LSB of deterministic noise.
+ *
+ *                    Two estimates are compared on every load profile:
+ *                      raw        the curve read on each published sample,
+ *                                 as the sensor task did before: one sample
+ *                                 under load per run, one right after it
+ *                                 and the periodic ones at rest
+ *                      estimator  battery_estimator.h, fed every motor
+ *                                 current sample of a run as well
+ *                    and reported as:
+ *                      err        RMS and largest difference of the
+ *                                 published SoC to the true one, percent
+ *                      rises      times the published SoC went up
+ *                                 (excluding a cell swap)
+ *                      runtime    mean difference of the projected runtime
+ *                                 at the average drain to the true one
+ *                      r          learned resistance at the end against the
+ *                                 model's, in milliohms
+ *                    followed by one "BATTERY {...}" JSON line per run. It
+ *                    fails if the estimator's SoC ever rose or strayed more
+ *                    than BATTERY_EVAL_MAX_ERR_PCT from the truth. No
+ *                    scheduler is started.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "battery_estimator.h"
+#include "sensor_calc.h"
+#include "sensor_sampling.h"
+#include "sensor_task.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BATTERY_EVAL_VDDA_MV 3000U
+#define BATTERY_EVAL_MS_PER_DAY 86400000ULL
+#define BATTERY_EVAL_REST_PERIOD_MS SENSOR_SAMPLING_MAX_PERIOD_MS
+#define BATTERY_EVAL_POLARISATION_TAU_S 20.0
+#define BATTERY_EVAL_MAX_ERR_PCT 5.0
+/* Runtime is compared while more than a day of it is left */
+#define BATTERY_EVAL_RUNTIME_MIN_H 24.0
+
+typedef enum {
+  BATTERY_EVAL_RAW = 0,
+  BATTERY_EVAL_ESTIMATOR,
+} BatteryEvalMethod_t;
+
+typedef struct {
+  const char *name;
+  uint32_t base_ua;      /**< Drain besides the motor */
+  uint32_t runs_per_day; /**< Valve motor runs */
+  uint32_t run_ms;       /**< Length of one run */
+  uint32_t run_ma;       /**< Motor current */
+  uint32_t swap_soc;     /**< Fresh cells below this SoC, 0 for none */
+} BatteryEvalProfile_t;
+
+static const BatteryEvalProfile_t s_profiles[] = {
+    {"light", 300U, 4U, 8000U, 60U, 0U},
+    {"heavy", 500U, 24U, 15000U, 120U, 0U},
+    {"swap", 400U, 12U, 12000U, 90U, 40U},
+};
+
+typedef struct {
+  double err_rms;
+  double err_max;
+  uint32_t rises;
+  double runtime_err_pct;
+  uint32_t r_mohm;
+  uint32_t r_true_mohm;
+  uint32_t days;
+} BatteryEvalResult_t;
+
+/* Cell model state */
+typedef struct {
+  double charge_uah;      /**< Charge left */
+  double polarisation_mv; /**< Extra sag that outlasts the load */
+  uint32_t noise_state;
+} BatteryEvalCells_t;
+
+static double true_soc(const BatteryEvalCells_t *cells) {
+  return 100.0 * cells->charge_uah /
+         ((double)BATTERY_ESTIMATOR_CAPACITY_MAH * 1000.0);
+}
+
+/* Open circuit voltage: the curve of SensorCalc_BatterySoc() inverted */
+static double open_circuit_mv(double soc) {
+  static const struct {
+    double soc;
+    double mv;
+  } curve[] = {{0.0, 2000.0},  {10.0, 2200.0}, {35.0, 2400.0},
+               {60.0, 2600.0}, {85.0, 2800.0}, {100.0, 3000.0}};
+  const uint32_t count = sizeof(curve) / sizeof(curve[0]);
+
+  if (soc <= curve[0].soc)
+    return curve[0].mv;
+  for (uint32_t i = 1U; i < count; i++) {
+    if (soc <= curve[i].soc) {
+      const double f =
+          (soc - curve[i - 1U].soc) / (curve[i].soc - curve[i - 1U].soc);
+      return curve[i - 1U].mv + f * (curve[i].mv - curve[i - 1U].mv);
+    }
+  }
+  return curve[count - 1U].mv;
+}
+
+/* Internal resistance of the pair, growing as the cells empty */
+static double resistance_mohm(double soc) {
+  return 300.0 + 900.0 * (100.0 - soc) / 100.0;
+}
+
+/* Battery voltage as the sensor task converts it from the VBAT channel */
+static uint32_t measure_mv(BatteryEvalCells_t *cells, uint32_t current_ma) {
+  const double soc = true_soc(cells);
+  const double mv = open_circuit_mv(soc) -
+                    (double)current_ma * resistance_mohm(soc) / 1000.0 -
+                    cells->polarisation_mv;
+  cells->noise_state = cells->noise_state * 1103515245U + 12345U;
+  const int32_t noise = (int32_t)((cells->noise_state >> 16) % 3U) - 1;
+  const int32_t raw =
+      (int32_t)((mv / SENSOR_CALC_VBAT_DIVIDER) * 4095.0 /
+                BATTERY_EVAL_VDDA_MV) +
+      noise;
+  return SensorCalc_BatteryVoltage((uint16_t)((raw < 0) ? 0 : raw),
+                                   BATTERY_EVAL_VDDA_MV);
+}
+
+/* Drain the cells for @p ms at @p current_ua; the polarisation follows the
+   motor current with a first-order lag */
+static void drain(BatteryEvalCells_t *cells, uint32_t ms, uint32_t current_ua,
+                  uint32_t motor_ma) {
+  cells->charge_uah -= (double)current_ua * ms / 3600000.0;
+  if (cells->charge_uah < 0.0)
+    cells->charge_uah = 0.0;
+  const double target = (double)motor_ma * 0.3; /* 300 mOhm of polarisation */
+  const double k = exp(-(double)ms / (BATTERY_EVAL_POLARISATION_TAU_S * 1000.0));
+  cells->polarisation_mv = target + (cells->polarisation_mv - target) * k;
+}
+
+typedef struct {
+  BatteryEvalMethod_t method;
+  BatteryEstimator_t estimator;
+  int32_t published;
+  double sum_sq;
+  uint32_t count;
+  double runtime_err_sum;
+  uint32_t runtime_count;
+  double average_ua;
+  BatteryEvalResult_t *result;
+} BatteryEvalRun_t;
+
+/* Publish a SoC and compare it, and the runtime projected from it, with
+   the truth */
+static void publish(BatteryEvalRun_t *run, const BatteryEvalCells_t *cells,
+                    uint8_t soc, bool swapped) {
+  if (run->published >= 0 && (int32_t)soc > run->published && !swapped)
+    run->result->rises++;
+  run->published = soc;
+
+  const double average_ua = run->average_ua;
+  const double truth = true_soc(cells);
+  const double err = (double)run->published - truth;
+  run->sum_sq += err * err;
+  run->count++;
+  if (fabs(err) > run->result->err_max)
+    run->result->err_max = fabs(err);
+
+  const double true_h = cells->charge_uah / average_ua;
+  if (true_h > BATTERY_EVAL_RUNTIME_MIN_H) {
+    const double projected_h = (double)run->published *
+                               BATTERY_ESTIMATOR_CAPACITY_MAH * 10.0 /
+                               average_ua;
+    run->runtime_err_sum += fabs(projected_h - true_h) / true_h;
+    run->runtime_count++;
+  }
+}
+
+/* One battery sample; the sensor task publishes only some of them */
+static void sample(BatteryEvalRun_t *run, BatteryEvalCells_t *cells,
+                   uint32_t motor_ma, bool published, uint32_t period_ms,
+                   uint64_t now_ms, bool swapped) {
+  const uint32_t mv = measure_mv(cells, motor_ma);
+  uint8_t soc;
+  if (run->method == BATTERY_EVAL_RAW) {
+    soc = SensorCalc_BatterySoc(mv);
+  } else {
+    const BatteryEstimatorInput_t input = {
+        .battery_mv = mv,
+        .current_ma = motor_ma,
+        .period_ms = period_ms,
+        .motor_running = motor_ma > 0U,
+    };
+    soc = BatteryEstimator_Update(&run->estimator, &input, (uint32_t)now_ms);
+  }
+  if (published)
+    publish(run, cells, soc, swapped);
+}
+
+static void run_profile(const BatteryEvalProfile_t *profile,
+                        BatteryEvalMethod_t method,
+                        BatteryEvalResult_t *result) {
+  BatteryEvalCells_t cells = {
+      .charge_uah = (double)BATTERY_ESTIMATOR_CAPACITY_MAH * 1000.0,
+      .polarisation_mv = 0.0,
+      .noise_state = 1U,
+  };
+  const uint64_t run_every_ms = BATTERY_EVAL_MS_PER_DAY / profile->runs_per_day;
+  BatteryEvalRun_t run = {
+      .method = method,
+      .published = -1,
+      .average_ua = (double)profile->base_ua +
+                    (double)profile->run_ma * 1000.0 * profile->run_ms /
+                        (double)run_every_ms,
+      .result = result,
+  };
+  BatteryEstimator_Init(&run.estimator);
+  *result = (BatteryEvalResult_t){0};
+  uint64_t now_ms = 0U;
+  uint64_t next_run_ms = run_every_ms / 2U;
+  bool swapped = false;
+  bool swap_done = false;
+
+  while (true_soc(&cells) > 0.5) {
+    /* Periodic measurements at rest until the next run */
+    while (now_ms + BATTERY_EVAL_REST_PERIOD_MS < next_run_ms) {
+      drain(&cells, BATTERY_EVAL_REST_PERIOD_MS, profile->base_ua, 0U);
+      now_ms += BATTERY_EVAL_REST_PERIOD_MS;
+      sample(&run, &cells, 0U, true, 0U, now_ms, swapped);
+      swapped = false;
+    }
+    drain(&cells, (uint32_t)(next_run_ms - now_ms), profile->base_ua, 0U);
+    now_ms = next_run_ms;
+
+    /* A motor run: current sampled every MOTOR_MEAS_PERIOD_MS, the battery
+       published TEMPERATURE_AND_BAT_MEAS_PERIOD_MS into it */
+    for (uint32_t t = MOTOR_MEAS_PERIOD_MS; t <= profile->run_ms;
+         t += MOTOR_MEAS_PERIOD_MS) {
+      drain(&cells, MOTOR_MEAS_PERIOD_MS,
+            profile->base_ua + profile->run_ma * 1000U, profile->run_ma);
+      now_ms += MOTOR_MEAS_PERIOD_MS;
+      sample(&run, &cells, profile->run_ma,
+             t % TEMPERATURE_AND_BAT_MEAS_PERIOD_MS == 0U,
+             MOTOR_MEAS_PERIOD_MS, now_ms, false);
+    }
+    /* First measurement at rest, right after the motor stopped */
+    drain(&cells, MOTOR_MEAS_PERIOD_MS, profile->base_ua, 0U);
+    now_ms += MOTOR_MEAS_PERIOD_MS;
+    sample(&run, &cells, 0U, true, 0U, now_ms, false);
+    next_run_ms += run_every_ms;
+
+    /* Fresh cells once; the next sample may rise */
+    if (!swap_done && true_soc(&cells) < (double)profile->swap_soc) {
+      cells.charge_uah = (double)BATTERY_ESTIMATOR_CAPACITY_MAH * 1000.0;
+      cells.polarisation_mv = 0.0;
+      swapped = true;
+      swap_done = true;
+    }
+  }
+
+  result->err_rms = (run.count > 0U) ? sqrt(run.sum_sq / run.count) : 0.0;
+  result->runtime_err_pct = (run.runtime_count > 0U)
+                                ? 100.0 * run.runtime_err_sum /
+                                      run.runtime_count
+                                : 0.0;
+  result->r_mohm = run.estimator.r_mohm;
+  result->r_true_mohm = (uint32_t)resistance_mohm(true_soc(&cells));
+  result->days = (uint32_t)(now_ms / BATTERY_EVAL_MS_PER_DAY);
+}
+
+int HostSim_BatteryEval(void) {
+  static const char *const method_names[] = {"raw", "estimator"};
+  const uint32_t profile_count = sizeof(s_profiles) / sizeof(s_profiles[0]);
+  BatteryEvalResult_t results[sizeof(s_profiles) / sizeof(s_profiles[0])][2];
+  bool pass = true;
+
+  for (uint32_t p = 0U; p < profile_count; p++) {
+    for (uint32_t m = 0U; m < 2U; m++) {
+      run_profile(&s_profiles[p], (BatteryEvalMethod_t)m, &results[p][m]);
+    }
+    const BatteryEvalResult_t *est = &results[p][BATTERY_EVAL_ESTIMATOR];
+    if (est->rises > 0U || est->err_max > BATTERY_EVAL_MAX_ERR_PCT)
+      pass = false;
+  }
+
+  printf("Battery evaluation: %u mAh, synthetic discharges\n",
+         (unsigned)BATTERY_ESTIMATOR_CAPACITY_MAH);
+  printf("Profile  Method     days  err rms  err max  rises  runtime %%  "
+         "r mOhm (true)\n");
+  for (uint32_t p = 0U; p < profile_count; p++) {
+    for (uint32_t m = 0U; m < 2U; m++) {
+      const BatteryEvalResult_t *r = &results[p][m];
+      printf("%-8s %-9s %5lu %8.2f %8.2f %6lu %10.1f",
+             s_profiles[p].name, method_names[m], (unsigned long)r->days,
+             r->err_rms, r->err_max, (unsigned long)r->rises,
+             r->runtime_err_pct);
+      if (m == BATTERY_EVAL_ESTIMATOR)
+        printf("  %6lu (%lu)", (unsigned long)r->r_mohm,
+               (unsigned long)r->r_true_mohm);
+      printf("\n");
+    }
+  }
+  for (uint32_t p = 0U; p < profile_count; p++) {
+    for (uint32_t m = 0U; m < 2U; m++) {
+      const BatteryEvalResult_t *r = &results[p][m];
+      printf("BATTERY {\"profile\":\"%s\",\"method\":\"%s\",\"days\":%lu,"
+             "\"err_rms_pct\":%.2f,\"err_max_pct\":%.2f,\"rises\":%lu,"
+             "\"runtime_err_pct\":%.1f,\"r_mohm\":%lu,\"r_true_mohm\":%lu}\n",
+             s_profiles[p].name, method_names[m], (unsigned long)r->days,
+             r->err_rms, r->err_max, (unsigned long)r->rises,
+             r->runtime_err_pct,
+             (unsigned long)((m == BATTERY_EVAL_ESTIMATOR) ? r->r_mohm : 0U),
+             (unsigned long)r->r_true_mohm);
+    }
+  }
+
+  return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,212 @@
+/**
+ ******************************************************************************
+ * @file           :  config_codec_eval.c
+ * @brief          :  Offline check of the bit-packed configuration record
+ *                    (--config-codec-eval).
+ *
+ * @details        :  Encodes a set of configurations, decodes them again
+ *                    and compares the record the storage task programs with
+ *                    the memory image of ConfigData_t it used to program.
+ *                    For each configuration it reports:
+ *                      image    bytes of the old record (magic, version,
+ *                               ConfigData_t, checksum)
+ *                      record   bytes of the new record (header, encoding,
+ *                               checksum)
+ *                      dwords   flash double-words programmed per save
+ *                      program  programming time per save at
+ *                               ENERGY_FLASH_DWORD_US, in us
+ *                    followed by one "CONFIG_CODEC {...}" JSON line per
+ *                    configuration. Every save also erases the page
+ *                    (about 22 ms), which the encoding does not change.
+ *
+ *                    Then round-trips random valid configurations and
+ *                    decodes every single-bit corruption and truncation of
+ *                    the default encoding. Fails if a round trip changes a
+ *                    value or a corrupt encoding decodes to an invalid
+ *                    configuration. No scheduler is started.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "config_codec.h"
+#include "energy.h"
+#include "schedule.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Record framing of storage_task.c: 8-byte header, 4-byte checksum, whole
+   double-words */
+#define CODEC_EVAL_HEADER_SIZE 8U
+#define CODEC_EVAL_CHECKSUM_SIZE 4U
+#define CODEC_EVAL_RANDOM_CONFIGS 10000U
+
+typedef struct {
+  const char *name;
+  ConfigData_t config;
+} CodecEvalCase_t;
+
+static uint32_t s_seed = 12345U;
+
+static uint32_t next_random(void) {
+  s_seed = s_seed * 1103515245U + 12345U;
+  return (s_seed >> 8) & 0xFFFFU;
+}
+
+static uint32_t round_up_dwords(uint32_t bytes) { return (bytes + 7U) & ~7U; }
+
+static void load_default(ConfigData_t *config, uint8_t num_slots) {
+  memset(config, 0, sizeof(*config));
+  config->temperature_offset = 0.0f;
+  config->manual_target_temp = 20.0f;
+  Schedule_LoadDefault(&config->schedule, num_slots);
+}
+
+/* Five slots on work days, three at the weekend, non-zero offset */
+static void load_workweek(ConfigData_t *config) {
+  load_default(config, 5U);
+  config->temperature_offset = -1.5f;
+  config->manual_target_temp = 21.5f;
+  config->heatup_rate_cdeg_h = 185U;
+  DailyScheduleTypeDef weekend;
+  Utils_LoadDefaultSchedule(&weekend, 3U);
+  weekend.time_slots[1].start_hour = 8U;
+  weekend.time_slots[0].end_hour = 8U;
+  weekend.time_slots[0].end_minute = 0U;
+  (void)Schedule_SetDay(&config->schedule, 5U, &weekend);
+  Schedule_CopyDay(&config->schedule, 5U, SCHEDULE_MASK_WEEKEND);
+}
+
+static void load_random(ConfigData_t *config) {
+  memset(config, 0, sizeof(*config));
+  config->temperature_offset =
+      (float)((int32_t)(next_random() % 61U) - 30) * 0.5f;
+  config->manual_target_temp = Utils_IndexToTemp(next_random() % 52U);
+  config->heatup_rate_cdeg_h = (uint16_t)((next_random() % 256U) * 5U);
+  for (uint8_t day = 0U; day < SCHEDULE_DAYS; day++) {
+    const uint8_t count = (uint8_t)(1U + next_random() % SCHEDULE_MAX_SLOTS);
+    uint16_t start = 0U;
+    config->schedule.num_slots[day] = count;
+    for (uint8_t i = 0U; i < count; i++) {
+      if (i > 0U) {
+        /* Leave room for the remaining slots before midnight */
+        const uint16_t room = (uint16_t)(SCHEDULE_DAY_MIN - start -
+                                         (count - i + 1U) * SCHEDULE_STEP_MIN);
+        start = (uint16_t)(start + SCHEDULE_STEP_MIN +
+                           (next_random() % (room / SCHEDULE_STEP_MIN + 1U)) *
+                               SCHEDULE_STEP_MIN);
+      }
+      config->schedule.slots[day][i] =
+          SCHEDULE_SLOT(start, next_random() % 52U);
+    }
+  }
+}
+
+static bool same_config(const ConfigData_t *a, const ConfigData_t *b) {
+  return a->temperature_offset == b->temperature_offset &&
+         a->manual_target_temp == b->manual_target_temp &&
+         a->heatup_rate_cdeg_h == b->heatup_rate_cdeg_h &&
+         memcmp(&a->schedule, &b->schedule, sizeof(a->schedule)) == 0;
+}
+
+static bool round_trip(const ConfigData_t *config, uint32_t *length) {
+  uint8_t encoded[CONFIG_CODEC_MAX_SIZE];
+  ConfigData_t decoded;
+  *length = ConfigCodec_Encode(config, encoded, sizeof(encoded));
+  return *length != 0U && ConfigCodec_Decode(encoded, *length, &decoded) &&
+         same_config(config, &decoded);
+}
+
+int HostSim_ConfigCodecEval(void) {
+  static CodecEvalCase_t cases[] = {
+      {.name = "default"}, {.name = "five_slots"}, {.name = "workweek"}};
+  load_default(&cases[0].config, 3U);
+  load_default(&cases[1].config, 5U);
+  load_workweek(&cases[2].config);
+
+  const uint32_t image = round_up_dwords(8U + sizeof(ConfigData_t) + 4U);
+  bool ok = true;
+
+  printf("%-12s %6s %7s %7s %8s %8s\n", "config", "image", "record",
+         "dwords", "old_us", "new_us");
+  for (size_t i = 0U; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    uint32_t length = 0U;
+    const bool passed = round_trip(&cases[i].config, &length);
+    const uint32_t record = round_up_dwords(
+        CODEC_EVAL_HEADER_SIZE + length + CODEC_EVAL_CHECKSUM_SIZE);
+    const uint32_t old_us = (image / 8U) * ENERGY_FLASH_DWORD_US;
+    const uint32_t new_us = (record / 8U) * ENERGY_FLASH_DWORD_US;
+
+    printf("%-12s %6lu %7lu %7lu %8lu %8lu%s\n", cases[i].name,
+           (unsigned long)image, (unsigned long)record,
+           (unsigned long)(record / 8U), (unsigned long)old_us,
+           (unsigned long)new_us, passed ? "" : "  ROUND TRIP FAILED");
+    printf("CONFIG_CODEC {\"config\":\"%s\",\"encoded_bytes\":%lu,"
+           "\"image_bytes\":%lu,\"record_bytes\":%lu,\"old_program_us\":%lu,"
+           "\"new_program_us\":%lu,\"round_trip\":%s}\n",
+           cases[i].name, (unsigned long)length, (unsigned long)image,
+           (unsigned long)record, (unsigned long)old_us,
+           (unsigned long)new_us, passed ? "true" : "false");
+    ok = ok && passed;
+  }
+
+  /* Random valid configurations */
+  uint32_t failures = 0U;
+  uint32_t max_length = 0U;
+  for (uint32_t i = 0U; i < CODEC_EVAL_RANDOM_CONFIGS; i++) {
+    ConfigData_t config;
+    uint32_t length = 0U;
+    load_random(&config);
+    if (!Schedule_IsValid(&config.schedule) || !round_trip(&config, &length)) {
+      failures++;
+    }
+    if (length > max_length) {
+      max_length = length;
+    }
+  }
+  printf("random: %lu configurations, %lu round trip failures, longest "
+         "%lu bytes\n",
+         (unsigned long)CODEC_EVAL_RANDOM_CONFIGS, (unsigned long)failures,
+         (unsigned long)max_length);
+  ok = ok && failures == 0U && max_length <= CONFIG_CODEC_MAX_SIZE;
+
+  /* Corruptions of the default encoding: rejected or still valid */
+  uint8_t encoded[CONFIG_CODEC_MAX_SIZE];
+  const uint32_t length =
+      ConfigCodec_Encode(&cases[0].config, encoded, sizeof(encoded));
+  uint32_t rejected = 0U;
+  uint32_t invalid = 0U;
+  for (uint32_t bit = 0U; bit < length * 8U; bit++) {
+    ConfigData_t decoded;
+    encoded[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+    if (!ConfigCodec_Decode(encoded, length, &decoded)) {
+      rejected++;
+    } else if (!Schedule_IsValid(&decoded.schedule)) {
+      invalid++;
+    }
+    encoded[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+  }
+  for (uint32_t cut = 0U; cut < length; cut++) {
+    ConfigData_t decoded;
+    if (ConfigCodec_Decode(encoded, cut, &decoded)) {
+      invalid++;
+    }
+  }
+  printf("corruption: %lu single-bit flips, %lu rejected by the decoder "
+         "(the rest by the record checksum), %lu invalid results\n",
+         (unsigned long)(length * 8U), (unsigned long)rejected,
+         (unsigned long)invalid);
+  ok = ok && invalid == 0U;
+
+  printf("config codec eval: %s\n", ok ? "PASS" : "FAIL");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
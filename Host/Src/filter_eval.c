@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file           :  filter_eval.c
+ * @brief          :  Offline evaluation of the ambient temperature filter on
+ *                    recorded traces (--filter-eval).
+ *
+ * @details        :  Picks the temperature samples the sensor task would
+ *                    have converted from the ADC records of a replay trace
+ *                    (at least SENSOR_SAMPLING_FAST_PERIOD_MS apart) and runs
+ *                    them through a set of filter configurations. For each
+ *                    configuration it reports:
+ *                      noise    RMS of the sample-to-sample change, in cdeg
+ *                      delay    time to reach 90% of a clean 2 degC step
+ *                      renders  changes of the 0.1 degC value the home
+ *                               screen shows (each one re-renders it)
+ *                      moves    changes of at least
+ *                               FILTER_EVAL_DEADBAND_CDEG since the last
+ *                               one, a proxy for valve re-positioning
+ *                    followed by one "FILTER {...}" JSON line per
+ *                    configuration. No scheduler is started.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "replay.h"
+#include "sensor_calc.h"
+#include "sensor_filter.h"
+#include "sensor_task.h"
+
+#include "FreeRTOS.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FILTER_EVAL_MAX_SAMPLES 100000U
+#define FILTER_EVAL_STEP_CDEG 200
+#define FILTER_EVAL_STEP_SAMPLES 200U
+#define FILTER_EVAL_DEADBAND_CDEG 50
+
+typedef struct {
+  const char *name;
+  SensorFilterParams_t params;
+} FilterEvalConfig_t;
+
+static const FilterEvalConfig_t s_configs[] = {
+    {"raw", {1U, 0U, 0U}},
+    {"median3", {3U, 0U, 0U}},
+    {"median5", {5U, 0U, 0U}},
+    {"iir60", {1U, 60U, 0U}},
+    {"iir120", {1U, 120U, 0U}},
+    {"slew100", {1U, 0U, 100U}},
+    {"default",
+     {SENSOR_FILTER_DEFAULT_MEDIAN, SENSOR_FILTER_DEFAULT_TAU_S,
+      SENSOR_FILTER_DEFAULT_SLEW}},
+};
+
+typedef struct {
+  double noise_cdeg;
+  uint32_t delay_s;
+  uint32_t renders;
+  uint32_t moves;
+} FilterEvalResult_t;
+
+static int32_t s_samples[FILTER_EVAL_MAX_SAMPLES];
+static uint32_t s_sample_ms[FILTER_EVAL_MAX_SAMPLES];
+
+/* Temperature samples at the sensor task's measurement periods; the trace
+   also holds the 100 ms sequences recorded while the motor ran */
+static uint32_t collect_samples(void) {
+  const uint32_t period_ticks =
+      (uint32_t)pdMS_TO_TICKS(SENSOR_SAMPLING_FAST_PERIOD_MS);
+  const uint32_t slack_ticks = (uint32_t)pdMS_TO_TICKS(MOTOR_MEAS_PERIOD_MS);
+  uint16_t adc[REPLAY_ADC_CHANNELS];
+  uint32_t tick;
+  uint32_t last_tick = 0U;
+  uint32_t count = 0U;
+
+  while (count < FILTER_EVAL_MAX_SAMPLES && Replay_ScanAdc(&tick, adc)) {
+    if (count > 0U && tick - last_tick + slack_ticks < period_ticks)
+      continue;
+    const uint32_t vref_mv = SensorCalc_VrefVoltage(adc[0]);
+    s_samples[count] = SensorCalc_TemperatureCenti(adc[2], vref_mv);
+    s_sample_ms[count] = (uint32_t)(((uint64_t)tick * 1000U) /
+                                    configTICK_RATE_HZ);
+    last_tick = tick;
+    count++;
+  }
+  return count;
+}
+
+static uint32_t step_delay_s(const SensorFilterParams_t *params) {
+  SensorFilter_t filter;
+  SensorFilter_Init(&filter, params);
+  /* Settle every stage, filling the median window, before the step */
+  for (uint32_t i = 0U; i < SENSOR_FILTER_MEDIAN_MAX; i++) {
+    (void)SensorFilter_Update(&filter, 0, TEMPERATURE_AND_BAT_MEAS_PERIOD_MS);
+  }
+
+  for (uint32_t i = 1U; i <= FILTER_EVAL_STEP_SAMPLES; i++) {
+    const int32_t out = SensorFilter_Update(
+        &filter, FILTER_EVAL_STEP_CDEG, TEMPERATURE_AND_BAT_MEAS_PERIOD_MS);
+    if (out * 10 >= FILTER_EVAL_STEP_CDEG * 9)
+      return i * (TEMPERATURE_AND_BAT_MEAS_PERIOD_MS / 1000U);
+  }
+  return FILTER_EVAL_STEP_SAMPLES *
+         (TEMPERATURE_AND_BAT_MEAS_PERIOD_MS / 1000U);
+}
+
+static void evaluate(const SensorFilterParams_t *params, uint32_t count,
+                     FilterEvalResult_t *result) {
+  SensorFilter_t filter;
+  SensorFilter_Init(&filter, params);
+
+  double sum_sq = 0.0;
+  int32_t previous = 0;
+  int32_t shown = 0;
+  int32_t moved_at = 0;
+  result->renders = 0U;
+  result->moves = 0U;
+
+  for (uint32_t i = 0U; i < count; i++) {
+    const uint32_t dt_ms =
+        (i == 0U) ? 0U : s_sample_ms[i] - s_sample_ms[i - 1U];
+    const int32_t out = SensorFilter_Update(&filter, s_samples[i], dt_ms);
+    if (i == 0U) {
+      shown = out / 10;
+      moved_at = out;
+    } else {
+      const double diff = (double)(out - previous);
+      sum_sq += diff * diff;
+      if (out / 10 != shown) {
+        shown = out / 10;
+        result->renders++;
+      }
+      if (abs(out - moved_at) >= FILTER_EVAL_DEADBAND_CDEG) {
+        moved_at = out;
+        result->moves++;
+      }
+    }
+    previous = out;
+  }
+
+  result->noise_cdeg =
+      (count > 1U) ? sqrt(sum_sq / (double)(count - 1U)) : 0.0;
+  result->delay_s = step_delay_s(params);
+}
+
+int HostSim_FilterEval(const char *trace_path) {
+  uint8_t *trace = HostSim_LoadTrace(trace_path);
+  if (trace == NULL) {
+    fprintf(stderr, "[host] cannot load trace %s\n", trace_path);
+    return EXIT_FAILURE;
+  }
+
+  const uint32_t count = collect_samples();
+  if (count < 2U) {
+    fprintf(stderr, "[host] %s holds fewer than 2 temperature samples\n",
+            trace_path);
+    free(trace);
+    return EXIT_FAILURE;
+  }
+
+  const uint32_t config_count = sizeof(s_configs) / sizeof(s_configs[0]);
+  FilterEvalResult_t results[sizeof(s_configs) / sizeof(s_configs[0])];
+  for (uint32_t i = 0U; i < config_count; i++) {
+    evaluate(&s_configs[i].params, count, &results[i]);
+  }
+
+  /* The first configuration is the unfiltered reference */
+  const FilterEvalResult_t *raw = &results[0];
+  printf("Filter evaluation: %lu samples over %lu s\n", (unsigned long)count,
+         (unsigned long)((s_sample_ms[count - 1U] - s_sample_ms[0]) / 1000U));
+  printf("Config     median tau_s slew  noise cdeg  delay s  renders  moves\n");
+  for (uint32_t i = 0U; i < config_count; i++) {
+    const SensorFilterParams_t *p = &s_configs[i].params;
+    printf("%-10s %6u %5u %4u %11.2f %8lu %8lu %6lu\n", s_configs[i].name,
+           p->median_n, p->iir_tau_s, p->slew_cdeg_per_min,
+           results[i].noise_cdeg, (unsigned long)results[i].delay_s,
+           (unsigned long)results[i].renders, (unsigned long)results[i].moves);
+  }
+  for (uint32_t i = 0U; i < config_count; i++) {
+    const FilterEvalResult_t *r = &results[i];
+    const double reduction =
+        (raw->noise_cdeg > 0.0)
+            ? 100.0 * (1.0 - r->noise_cdeg / raw->noise_cdeg)
+            : 0.0;
+    printf("FILTER {\"config\":\"%s\",\"samples\":%lu,\"noise_cdeg\":%.2f,"
+           "\"noise_reduction_pct\":%.1f,\"delay_s\":%lu,\"renders\":%lu,"
+           "\"renders_avoided\":%ld,\"moves\":%lu,\"moves_avoided\":%ld}\n",
+           s_configs[i].name, (unsigned long)count, r->noise_cdeg, reduction,
+           (unsigned long)r->delay_s, (unsigned long)r->renders,
+           (long)raw->renders - (long)r->renders, (unsigned long)r->moves,
+           (long)raw->moves - (long)r->moves);
+  }
+
+  free(trace);
+  return EXIT_SUCCESS;
+}
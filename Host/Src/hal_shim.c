@@ -0,0 +1,758 @@
+/**
+ ******************************************************************************
+ * @file           :  hal_shim.c
+ * @brief          :  Host implementation of the STM32WB HAL/BSP subset used by
+ *                    the firmware.
+ *
+ * @details        :  Peripherals are modelled just far enough for the
+ *                    application to behave as on target:
+ *                    - GPIO keeps pin levels and raises EXTI callbacks
+ *                    - ADC writes simulated sequences into the DMA buffer
+ *                    - I2C decodes SH1106 page/column commands into a RAM copy;
+ *                      DMA transfers complete within the call
+ *                    - RTC derives the calendar from the simulated clock
+ *                    - TIM2 exposes the encoder counter
+ *                    - FLASH is a 512 KB array with erase/program rules
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "stm32wbxx_hal.h"
+#include "stm32wbxx_ll_adc.h"
+#include "stm32wbxx_nucleo.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "host_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Core registers and clock ------------------------------------------------ */
+SysTick_Type HostSysTick;
+SCB_Type HostSCB;
+DWT_Type HostDWT;
+CoreDebug_Type HostCoreDebug;
+
+/* MSI range 10 selected by SystemClock_Config() */
+uint32_t SystemCoreClock = 32000000U;
+
+/* Factory calibration words (typical STM32WB55 values at VDDA = 3.6 V) */
+const uint16_t HostVrefintCal = 1655U;
+const uint16_t HostTsCal1 = 1034U;
+const uint16_t HostTsCal2 = 1370U;
+
+/* Peripheral instances */
+GPIO_TypeDef HostGPIOA;
+GPIO_TypeDef HostGPIOB;
+GPIO_TypeDef HostGPIOC;
+ADC_TypeDef HostADC1;
+I2C_TypeDef HostI2C1;
+RTC_TypeDef HostRTC;
+TIM_TypeDef HostTIM2;
+TIM_TypeDef HostTIM17;
+
+/* HAL time base handle, generated into stm32wbxx_hal_timebase_tim.c on
+ * target */
+TIM_HandleTypeDef htim17 = {.Instance = TIM17};
+
+/* HAL tick counter */
+volatile uint32_t uwTick;
+
+/* Interrupt emulation ----------------------------------------------------- */
+static volatile uint32_t s_ipsr;
+
+uint32_t HostSim_GetIpsr(void) { return s_ipsr; }
+
+void HostSim_IsrEnter(uint32_t irq_number) { s_ipsr = 16U + irq_number; }
+
+void HostSim_IsrExit(void) { s_ipsr = 0U; }
+
+void HostSim_DisableIrq(void) {
+  if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+    portDISABLE_INTERRUPTS();
+  }
+}
+
+void HostSim_EnableIrq(void) {
+  if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+    portENABLE_INTERRUPTS();
+  }
+}
+
+void HostSim_SystemReset(void) {
+  printf("[host] NVIC_SystemReset requested\n");
+  HostSim_Stop(3);
+}
+
+/* System ------------------------------------------------------------------ */
+HAL_StatusTypeDef HAL_Init(void) { return HAL_OK; }
+
+void HAL_IncTick(void) { uwTick += 1U; }
+
+uint32_t HAL_GetTick(void) { return uwTick; }
+
+/* GPIO -------------------------------------------------------------------- */
+#define HOST_GPIO_PORT_COUNT 3U
+
+/* Pins configured as EXTI sources, per port */
+static uint16_t s_exti_pins[HOST_GPIO_PORT_COUNT];
+
+static int gpio_port_index(const GPIO_TypeDef *port) {
+  if (port == GPIOA)
+    return 0;
+  if (port == GPIOB)
+    return 1;
+  if (port == GPIOC)
+    return 2;
+  return -1;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+  const int index = gpio_port_index(GPIOx);
+  if (index < 0 || GPIO_Init == NULL)
+    return;
+
+  const uint16_t pins = (uint16_t)GPIO_Init->Pin;
+  if ((GPIO_Init->Mode & 0x10000000U) != 0U) {
+    s_exti_pins[index] |= pins;
+  } else {
+    s_exti_pins[index] &= (uint16_t)~pins;
+  }
+
+  /* Idle level of undriven inputs follows the pull configuration */
+  if (GPIO_Init->Mode == GPIO_MODE_INPUT ||
+      (GPIO_Init->Mode & 0x10000000U) != 0U) {
+    if (GPIO_Init->Pull == GPIO_PULLUP) {
+      GPIOx->IDR |= pins;
+    } else {
+      GPIOx->IDR &= ~(uint32_t)pins;
+    }
+  }
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin) {
+  const int index = gpio_port_index(GPIOx);
+  if (index >= 0) {
+    s_exti_pins[index] &= (uint16_t)~GPIO_Pin;
+  }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+  return ((GPIOx->IDR & GPIO_Pin) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+                       GPIO_PinState PinState) {
+  if (PinState != GPIO_PIN_RESET) {
+    GPIOx->ODR |= GPIO_Pin;
+    GPIOx->IDR |= GPIO_Pin;
+  } else {
+    GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    GPIOx->IDR &= ~(uint32_t)GPIO_Pin;
+  }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+  HAL_GPIO_WritePin(GPIOx, GPIO_Pin,
+                    HAL_GPIO_ReadPin(GPIOx, GPIO_Pin) == GPIO_PIN_SET
+                        ? GPIO_PIN_RESET
+                        : GPIO_PIN_SET);
+}
+
+__weak void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) { UNUSED(GPIO_Pin); }
+
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin) {
+  HAL_GPIO_EXTI_Callback(GPIO_Pin);
+}
+
+/* Drive an input line from the simulation, raising EXTI on any edge */
+void HostShim_SetPin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state) {
+  const int index = gpio_port_index(port);
+  if (index < 0)
+    return;
+
+  const bool was_set = (port->IDR & pin) != 0U;
+  if (state != GPIO_PIN_RESET) {
+    port->IDR |= pin;
+  } else {
+    port->IDR &= ~(uint32_t)pin;
+  }
+
+  if (was_set != (state != GPIO_PIN_RESET) &&
+      (s_exti_pins[index] & pin) != 0U) {
+    HostSim_IsrEnter((uint32_t)EXTI9_5_IRQn);
+    HAL_GPIO_EXTI_IRQHandler(pin);
+    HostSim_IsrExit();
+  }
+}
+
+/* RCC / PWR / NVIC -------------------------------------------------------- */
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct) {
+  UNUSED(RCC_OscInitStruct);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct,
+                                      uint32_t FLatency) {
+  UNUSED(RCC_ClkInitStruct);
+  UNUSED(FLatency);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef
+HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit) {
+  UNUSED(PeriphClkInit);
+  return HAL_OK;
+}
+
+void HAL_PWR_EnableBkUpAccess(void) {}
+
+void HAL_PWR_DisableBkUpAccess(void) {}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority,
+                          uint32_t SubPriority) {
+  UNUSED(IRQn);
+  UNUSED(PreemptPriority);
+  UNUSED(SubPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) { UNUSED(IRQn); }
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) { UNUSED(IRQn); }
+
+/* ADC --------------------------------------------------------------------- */
+static ADC_HandleTypeDef *s_adc_handle;
+static uint16_t *s_adc_dma_target;
+static uint32_t s_adc_dma_length;
+static uint32_t s_adc_dma_index;
+static bool s_adc_single_done;
+static bool s_adc_deep_power_down;
+
+/* Also wakes the ADC from deep power-down, as the HAL does */
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc) {
+  if (hadc == NULL || hadc->Instance != ADC1 || s_adc_dma_target != NULL)
+    return HAL_ERROR;
+  s_adc_deep_power_down = false;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc,
+                                        ADC_ChannelConfTypeDef *sConfig) {
+  return (hadc != NULL && sConfig != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc,
+                                              uint32_t SingleDiff) {
+  UNUSED(SingleDiff);
+  return (hadc != NULL && !s_adc_deep_power_down && s_adc_dma_target == NULL)
+             ? HAL_OK
+             : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_EnterADCDeepPowerDownMode(ADC_HandleTypeDef *hadc) {
+  if (hadc == NULL || s_adc_dma_target != NULL)
+    return HAL_ERROR;
+  s_adc_deep_power_down = true;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData,
+                                    uint32_t Length) {
+  if (hadc == NULL || pData == NULL || Length == 0U)
+    return HAL_ERROR;
+  if (s_adc_dma_target != NULL)
+    return HAL_BUSY;
+  if (s_adc_deep_power_down)
+    return HAL_ERROR;
+
+  /* DMA is configured for half-word transfers */
+  s_adc_handle = hadc;
+  s_adc_dma_target = (uint16_t *)pData;
+  s_adc_dma_length = Length;
+  s_adc_dma_index = 0U;
+  s_adc_single_done = false;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc) {
+  UNUSED(hadc);
+  s_adc_dma_target = NULL;
+  s_adc_dma_length = 0U;
+  return HAL_OK;
+}
+
+__weak void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) { UNUSED(hadc); }
+
+__weak void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+  UNUSED(hadc);
+}
+
+/* Without continuous mode the ADC stops after one sequence until the DMA is
+ * stopped and started again */
+bool HostShim_IsAdcRunning(void) {
+  return s_adc_dma_target != NULL && !s_adc_single_done;
+}
+
+/* Transfer one conversion sequence in channel order, as the circular DMA
+ * channel does: from where the last one ended, raising the half and full
+ * transfer interrupts as the buffer fills and wrapping at its end */
+void HostShim_CompleteAdcSequence(const uint16_t *samples, uint32_t count) {
+  if (!HostShim_IsAdcRunning() || samples == NULL)
+    return;
+  s_adc_single_done = s_adc_handle->Init.ContinuousConvMode == DISABLE;
+
+  const uint32_t half = s_adc_dma_length / 2U;
+
+  HostSim_IsrEnter((uint32_t)DMA1_Channel1_IRQn);
+  for (uint32_t i = 0U; i < count && s_adc_dma_target != NULL; i++) {
+    s_adc_dma_target[s_adc_dma_index++] = samples[i];
+    if (s_adc_dma_index == half) {
+      HAL_ADC_ConvHalfCpltCallback(s_adc_handle);
+    } else if (s_adc_dma_index == s_adc_dma_length) {
+      s_adc_dma_index = 0U;
+      HAL_ADC_ConvCpltCallback(s_adc_handle);
+    }
+  }
+  HostSim_IsrExit();
+}
+
+/* I2C: SH1106 display model ----------------------------------------------- */
+#define SH1106_CONTROL_COMMAND 0x00U
+#define SH1106_CONTROL_DATA 0x40U
+
+static uint8_t s_display_ram[HOST_SIM_DISPLAY_PAGES * HOST_SIM_DISPLAY_COLUMNS];
+static uint8_t s_display_page;
+static uint8_t s_display_column;
+
+static void sh1106_command(uint8_t command) {
+  if (command >= 0xB0U && command <= 0xB7U) {
+    s_display_page = command & 0x07U;
+  } else if (command <= 0x0FU) {
+    s_display_column = (uint8_t)((s_display_column & 0xF0U) | command);
+  } else if (command >= 0x10U && command <= 0x1FU) {
+    s_display_column =
+        (uint8_t)((s_display_column & 0x0FU) | ((command & 0x0FU) << 4));
+  }
+  /* Remaining commands (contrast, multiplex, ...) do not affect RAM */
+}
+
+static void sh1106_data(const uint8_t *data, uint16_t size) {
+  for (uint16_t i = 0U; i < size; i++) {
+    if (s_display_column < HOST_SIM_DISPLAY_COLUMNS) {
+      s_display_ram[s_display_page * HOST_SIM_DISPLAY_COLUMNS +
+                    s_display_column] = data[i];
+      s_display_column++;
+    }
+  }
+}
+
+const uint8_t *HostShim_GetDisplayRam(void) { return s_display_ram; }
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c) {
+  return (hi2c != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c) {
+  return (hi2c != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigAnalogFilter(I2C_HandleTypeDef *hi2c,
+                                               uint32_t AnalogFilter) {
+  UNUSED(AnalogFilter);
+  return (hi2c != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigDigitalFilter(I2C_HandleTypeDef *hi2c,
+                                                uint32_t DigitalFilter) {
+  UNUSED(DigitalFilter);
+  return (hi2c != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+void HAL_I2CEx_EnableFastModePlus(uint32_t ConfigFastModePlus) {
+  UNUSED(ConfigFastModePlus);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c,
+                                    uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData,
+                                    uint16_t Size, uint32_t Timeout) {
+  UNUSED(DevAddress);
+  UNUSED(MemAddSize);
+  UNUSED(Timeout);
+  if (hi2c == NULL || pData == NULL)
+    return HAL_ERROR;
+
+  if (MemAddress == SH1106_CONTROL_DATA) {
+    sh1106_data(pData, Size);
+  } else if (MemAddress == SH1106_CONTROL_COMMAND) {
+    for (uint16_t i = 0U; i < Size; i++) {
+      sh1106_command(pData[i]);
+    }
+  }
+  return HAL_OK;
+}
+
+/* The display has nothing to read: reads return zeros */
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c,
+                                   uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData,
+                                   uint16_t Size, uint32_t Timeout) {
+  UNUSED(DevAddress);
+  UNUSED(MemAddress);
+  UNUSED(MemAddSize);
+  UNUSED(Timeout);
+  if (hi2c == NULL || pData == NULL)
+    return HAL_ERROR;
+  memset(pData, 0, Size);
+  return HAL_OK;
+}
+
+__weak void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+  UNUSED(hi2c);
+}
+
+__weak void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+  UNUSED(hi2c);
+}
+
+__weak void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) { UNUSED(hi2c); }
+
+/* DMA transfers complete at once; the completion interrupt follows before
+ * the call returns, as with a transfer shorter than the interrupt latency */
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c,
+                                        uint16_t DevAddress,
+                                        uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData,
+                                        uint16_t Size) {
+  const HAL_StatusTypeDef status = HAL_I2C_Mem_Write(
+      hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, 0U);
+  if (status != HAL_OK)
+    return status;
+
+  HostSim_IsrEnter((uint32_t)I2C1_EV_IRQn);
+  HAL_I2C_MemTxCpltCallback(hi2c);
+  HostSim_IsrExit();
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c,
+                                       uint16_t DevAddress,
+                                       uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData,
+                                       uint16_t Size) {
+  const HAL_StatusTypeDef status = HAL_I2C_Mem_Read(
+      hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, 0U);
+  if (status != HAL_OK)
+    return status;
+
+  HostSim_IsrEnter((uint32_t)I2C1_EV_IRQn);
+  HAL_I2C_MemRxCpltCallback(hi2c);
+  HostSim_IsrExit();
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c,
+                                          uint16_t DevAddress, uint8_t *pData,
+                                          uint16_t Size, uint32_t Timeout) {
+  if (pData == NULL || Size == 0U)
+    return HAL_ERROR;
+  return HAL_I2C_Mem_Write(hi2c, DevAddress, pData[0], I2C_MEMADD_SIZE_8BIT,
+                           pData + 1, (uint16_t)(Size - 1U), Timeout);
+}
+
+/* RTC --------------------------------------------------------------------- */
+#define SECONDS_PER_DAY 86400U
+
+/* Calendar state: seconds since 2000-01-01 00:00 at simulated time
+ * s_rtc_base_ms */
+static uint32_t s_rtc_base_seconds;
+static uint64_t s_rtc_base_ms;
+static uint8_t s_rtc_weekday_at_base = RTC_WEEKDAY_SATURDAY;
+static uint32_t s_rtc_daylight_saving;
+
+/* Days since 2000-01-01 for a date in 2000..2099 */
+static uint32_t days_from_date(uint16_t year, uint8_t month, uint8_t day) {
+  static const uint16_t cumulative[12] = {0,   31,  59,  90,  120, 151,
+                                          181, 212, 243, 273, 304, 334};
+  const uint32_t y = (uint32_t)(year - 2000U);
+  uint32_t days = y * 365U + (y + 3U) / 4U;
+  days += cumulative[(month - 1U) % 12U] + (uint32_t)day - 1U;
+  if (month > 2U && (y % 4U) == 0U) {
+    days += 1U;
+  }
+  return days;
+}
+
+static void date_from_days(uint32_t days, uint16_t *year, uint8_t *month,
+                           uint8_t *day) {
+  static const uint8_t month_days[12] = {31, 28, 31, 30, 31, 30,
+                                         31, 31, 30, 31, 30, 31};
+  uint32_t y = 0U;
+  for (;;) {
+    const uint32_t year_days = ((y % 4U) == 0U) ? 366U : 365U;
+    if (days < year_days)
+      break;
+    days -= year_days;
+    y++;
+  }
+  uint8_t m = 0U;
+  for (; m < 12U; m++) {
+    uint32_t len = month_days[m];
+    if (m == 1U && (y % 4U) == 0U)
+      len++;
+    if (days < len)
+      break;
+    days -= len;
+  }
+  *year = (uint16_t)(2000U + y);
+  *month = (uint8_t)(m + 1U);
+  *day = (uint8_t)(days + 1U);
+}
+
+static uint32_t rtc_now_seconds(void) {
+  const uint64_t elapsed_ms = HostSim_GetTimeMs() - s_rtc_base_ms;
+  return s_rtc_base_seconds + (uint32_t)(elapsed_ms / 1000U);
+}
+
+static void rtc_rebase(uint32_t seconds, uint8_t weekday) {
+  s_rtc_base_seconds = seconds;
+  s_rtc_base_ms = HostSim_GetTimeMs();
+  s_rtc_weekday_at_base = weekday;
+}
+
+static uint8_t rtc_current_weekday(void) {
+  const uint32_t days_now = rtc_now_seconds() / SECONDS_PER_DAY;
+  const uint32_t days_base = s_rtc_base_seconds / SECONDS_PER_DAY;
+  return (uint8_t)(((s_rtc_weekday_at_base - 1U) + (days_now - days_base)) %
+                       7U +
+                   1U);
+}
+
+void HostShim_SetRtcEpoch(uint16_t year, uint8_t month, uint8_t day,
+                          uint8_t hour, uint8_t minute) {
+  const uint32_t days = days_from_date(year, month, day);
+  /* 2000-01-01 was a Saturday */
+  const uint8_t weekday = (uint8_t)((days + 5U) % 7U + 1U);
+  rtc_rebase(days * SECONDS_PER_DAY + (uint32_t)hour * 3600U +
+                 (uint32_t)minute * 60U,
+             weekday);
+}
+
+void HostSim_BackupDomainReset(void) {
+  rtc_rebase(0U, RTC_WEEKDAY_SATURDAY);
+  s_rtc_daylight_saving = RTC_DAYLIGHTSAVING_NONE;
+}
+
+HAL_StatusTypeDef HAL_RTC_Init(RTC_HandleTypeDef *hrtc) {
+  return (hrtc != NULL && hrtc->Instance == RTC) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_RTC_SetTime(RTC_HandleTypeDef *hrtc,
+                                  RTC_TimeTypeDef *sTime, uint32_t Format) {
+  if (hrtc == NULL || sTime == NULL || Format != RTC_FORMAT_BIN)
+    return HAL_ERROR;
+  const uint32_t now = rtc_now_seconds();
+  const uint32_t midnight = now - (now % SECONDS_PER_DAY);
+  rtc_rebase(midnight + (uint32_t)sTime->Hours * 3600U +
+                 (uint32_t)sTime->Minutes * 60U + sTime->Seconds,
+             rtc_current_weekday());
+  s_rtc_daylight_saving = sTime->DayLightSaving;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef *hrtc,
+                                  RTC_TimeTypeDef *sTime, uint32_t Format) {
+  if (hrtc == NULL || sTime == NULL || Format != RTC_FORMAT_BIN)
+    return HAL_ERROR;
+  const uint32_t seconds_of_day = rtc_now_seconds() % SECONDS_PER_DAY;
+  const uint32_t ms = (uint32_t)((HostSim_GetTimeMs() - s_rtc_base_ms) % 1000U);
+  sTime->Hours = (uint8_t)(seconds_of_day / 3600U);
+  sTime->Minutes = (uint8_t)((seconds_of_day / 60U) % 60U);
+  sTime->Seconds = (uint8_t)(seconds_of_day % 60U);
+  sTime->TimeFormat = RTC_HOURFORMAT12_AM;
+  sTime->SecondFraction = hrtc->Init.SynchPrediv;
+  sTime->SubSeconds =
+      hrtc->Init.SynchPrediv - (ms * (hrtc->Init.SynchPrediv + 1U)) / 1000U;
+  sTime->DayLightSaving = s_rtc_daylight_saving;
+  sTime->StoreOperation = RTC_STOREOPERATION_RESET;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_SetDate(RTC_HandleTypeDef *hrtc,
+                                  RTC_DateTypeDef *sDate, uint32_t Format) {
+  if (hrtc == NULL || sDate == NULL || Format != RTC_FORMAT_BIN)
+    return HAL_ERROR;
+  const uint32_t seconds_of_day = rtc_now_seconds() % SECONDS_PER_DAY;
+  const uint32_t days =
+      days_from_date((uint16_t)(2000U + sDate->Year), sDate->Month,
+                     sDate->Date);
+  /* The weekday register holds whatever the application wrote */
+  rtc_rebase(days * SECONDS_PER_DAY + seconds_of_day, sDate->WeekDay);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetDate(RTC_HandleTypeDef *hrtc,
+                                  RTC_DateTypeDef *sDate, uint32_t Format) {
+  if (hrtc == NULL || sDate == NULL || Format != RTC_FORMAT_BIN)
+    return HAL_ERROR;
+  uint16_t year;
+  date_from_days(rtc_now_seconds() / SECONDS_PER_DAY, &year, &sDate->Month,
+                 &sDate->Date);
+  sDate->Year = (uint8_t)(year - 2000U);
+  sDate->WeekDay = rtc_current_weekday();
+  return HAL_OK;
+}
+
+/* TIM --------------------------------------------------------------------- */
+HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim,
+                                       TIM_Encoder_InitTypeDef *sConfig) {
+  return (htim != NULL && sConfig != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim,
+                                        uint32_t Channel) {
+  UNUSED(Channel);
+  return (htim != NULL && htim->Instance != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef
+HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim,
+                                      TIM_MasterConfigTypeDef *sMasterConfig) {
+  return (htim != NULL && sMasterConfig != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+/* Quadrature counter of TIM2, 16-bit with Period 65535 */
+void HostShim_AddEncoderTicks(int32_t ticks) {
+  taskENTER_CRITICAL();
+  HostTIM2.CNT = (uint32_t)((int32_t)HostTIM2.CNT + ticks) & 0xFFFFU;
+  taskEXIT_CRITICAL();
+}
+
+/* FLASH ------------------------------------------------------------------- */
+uint8_t HostFlash[HOST_FLASH_SIZE];
+static bool s_flash_unlocked;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+  s_flash_unlocked = true;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+  s_flash_unlocked = false;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit,
+                                    uint32_t *PageError) {
+  if (pEraseInit == NULL || PageError == NULL || !s_flash_unlocked)
+    return HAL_ERROR;
+
+  *PageError = 0xFFFFFFFFU;
+  const uint32_t first = pEraseInit->Page;
+  const uint32_t last = first + pEraseInit->NbPages;
+  if (last > HOST_FLASH_SIZE / FLASH_PAGE_SIZE) {
+    *PageError = first;
+    return HAL_ERROR;
+  }
+  memset(&HostFlash[first * FLASH_PAGE_SIZE], 0xFF,
+         (size_t)pEraseInit->NbPages * FLASH_PAGE_SIZE);
+  return HAL_OK;
+}
+
+/* Addresses arrive truncated to 32 bits (as on target); the flash array is
+ * addressed relative to the low word of its host address */
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address,
+                                    uint64_t Data) {
+  if (TypeProgram != FLASH_TYPEPROGRAM_DOUBLEWORD || !s_flash_unlocked)
+    return HAL_ERROR;
+
+  const uint32_t offset = Address - (uint32_t)FLASH_BASE;
+  if ((offset % 8U) != 0U || offset > HOST_FLASH_SIZE - 8U)
+    return HAL_ERROR;
+
+  /* Programming a non-erased double word sets PROGERR on STM32WB */
+  uint64_t current;
+  memcpy(&current, &HostFlash[offset], sizeof(current));
+  if (current != UINT64_MAX && Data != 0U)
+    return HAL_ERROR;
+
+  memcpy(&HostFlash[offset], &Data, sizeof(Data));
+  return HAL_OK;
+}
+
+bool HostShim_LoadFlash(const char *path) {
+  memset(HostFlash, 0xFF, sizeof(HostFlash));
+  if (path == NULL)
+    return false;
+
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return false;
+  const size_t read = fread(HostFlash, 1U, sizeof(HostFlash), file);
+  fclose(file);
+  return read == sizeof(HostFlash);
+}
+
+bool HostShim_SaveFlash(const char *path) {
+  if (path == NULL)
+    return false;
+
+  FILE *file = fopen(path, "wb");
+  if (file == NULL)
+    return false;
+  const size_t written = fwrite(HostFlash, 1U, sizeof(HostFlash), file);
+  fclose(file);
+  return written == sizeof(HostFlash);
+}
+
+/* BSP --------------------------------------------------------------------- */
+static bool s_led_state[LEDn];
+
+int32_t BSP_LED_Init(Led_TypeDef Led) {
+  if (Led < LEDn)
+    s_led_state[Led] = false;
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_LED_On(Led_TypeDef Led) {
+  if (Led < LEDn)
+    s_led_state[Led] = true;
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_LED_Off(Led_TypeDef Led) {
+  if (Led < LEDn)
+    s_led_state[Led] = false;
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_LED_Toggle(Led_TypeDef Led) {
+  if (Led < LEDn)
+    s_led_state[Led] = !s_led_state[Led];
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_PB_Init(Button_TypeDef Button, ButtonMode_TypeDef ButtonMode) {
+  UNUSED(Button);
+  UNUSED(ButtonMode);
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_COM_Init(COM_TypeDef COM, COM_InitTypeDef *COM_Init) {
+  UNUSED(COM);
+  UNUSED(COM_Init);
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_COM_SelectLogPort(COM_TypeDef COM) {
+  UNUSED(COM);
+  return BSP_ERROR_NONE;
+}
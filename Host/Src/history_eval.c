@@ -0,0 +1,326 @@
+/**
+ ******************************************************************************
+ * @file           :  history_eval.c
+ * @brief          :  Offline check of the multi-resolution temperature
+ *                    history (--history-eval).
+ *
+ * @details        :  Feeds HISTORY_EVAL_DAYS of a simulated room at the
+ *                    system task's 250 ms period, with jitter, motor runs,
+ *                    a day/night target and two stalls, into a
+ *                    TempHistory_t whose millisecond clock wraps on the
+ *                    second day. Alongside, every sample is kept per minute
+ *                    by brute force. Then it checks:
+ *                      points   every stored minute, quarter and hour
+ *                               against the minutes it covers: min and max
+ *                               exact, the mean and the target within one
+ *                               unit of rounding, the valve activity exact,
+ *                               intervals without samples as gaps
+ *                      counts   each ring full, holding 24 h, 7 days and
+ *                               30 days
+ *                      columns  the 24 h plot columns against the minutes
+ *                               they merge
+ *                      closes   no sample closes more than one point per
+ *                               resolution outside the stalls
+ *                    and prints the history's report, a "HISTORY_EVAL {...}"
+ *                    JSON line and PASS or FAIL. No scheduler is started.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "temp_history.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define HISTORY_EVAL_DAYS 31U
+#define HISTORY_EVAL_PERIOD_MS 250U
+#define HISTORY_EVAL_MINUTES (HISTORY_EVAL_DAYS * 24U * 60U)
+/* Clock value at the first sample: wraps about 27 h in */
+#define HISTORY_EVAL_START_MS (UINT32_MAX - 100000000U)
+#define HISTORY_EVAL_DAY_INDEX 33U   /* 21.0 °C */
+#define HISTORY_EVAL_NIGHT_INDEX 25U /* 17.0 °C */
+#define HISTORY_EVAL_COLUMNS 128U
+
+/* Sampling stalls, in minutes from the start: one of several hours within
+   the last week and a short one within the last day, so that every ring
+   holds gaps */
+static const uint32_t k_stalls[][2] = {
+    {26U * 1440U + 125U, 26U * 1440U + 371U},
+    {30U * 1440U + 601U, 30U * 1440U + 606U},
+};
+
+/* Brute-force record of one minute */
+typedef struct {
+  int32_t min_cdeg;
+  int32_t max_cdeg;
+  int64_t sum_cdeg;
+  uint32_t target_sum;
+  uint32_t samples;
+  uint32_t motor_ms;
+} HistoryEvalMinute_t;
+
+static HistoryEvalMinute_t s_minutes[HISTORY_EVAL_MINUTES];
+static TempHistory_t s_history;
+
+static uint32_t s_rng = 0x1234567U;
+
+static uint32_t eval_rand(void) {
+  s_rng = s_rng * 1664525U + 1013904223U;
+  return s_rng >> 8;
+}
+
+static bool in_stall(uint32_t minute) {
+  for (size_t i = 0; i < sizeof(k_stalls) / sizeof(k_stalls[0]); i++) {
+    if (minute >= k_stalls[i][0] && minute < k_stalls[i][1]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Room temperature: daily swing, heating ripple and sensor noise */
+static int32_t room_cdeg(uint64_t t_ms, bool day) {
+  const double hours = (double)t_ms / 3600000.0;
+  const double base = day ? 2050.0 : 1750.0;
+  const double swing = 120.0 * sin(hours * 2.0 * M_PI / 24.0);
+  const double ripple = 25.0 * sin(hours * 2.0 * M_PI * 1.7);
+  const int32_t noise = (int32_t)(eval_rand() % 11U) - 5;
+  return (int32_t)lround(base + swing + ripple) + noise;
+}
+
+/* Expected point over minutes [first, first + n); false if any check of
+   @p point fails */
+static bool check_point(const TempHistoryPoint_t *point, uint32_t first,
+                        uint32_t n, const char *tier_name, uint32_t *errors) {
+  int32_t min_cdeg = INT32_MAX;
+  int32_t max_cdeg = INT32_MIN;
+  int64_t sum_cdeg = 0;
+  uint64_t target_sum = 0;
+  uint64_t samples = 0;
+  uint64_t motor_ms = 0;
+  for (uint32_t m = first; m < first + n; m++) {
+    const HistoryEvalMinute_t *minute = &s_minutes[m];
+    motor_ms += minute->motor_ms;
+    if (minute->samples == 0U)
+      continue;
+    if (minute->min_cdeg < min_cdeg)
+      min_cdeg = minute->min_cdeg;
+    if (minute->max_cdeg > max_cdeg)
+      max_cdeg = minute->max_cdeg;
+    sum_cdeg += minute->sum_cdeg;
+    target_sum += minute->target_sum;
+    samples += minute->samples;
+  }
+
+  const uint64_t interval_ms = (uint64_t)n * TEMP_HISTORY_MINUTE_MS;
+  uint64_t valve = (motor_ms * 255U + interval_ms - 1U) / interval_ms;
+  if (valve > 255U)
+    valve = 255U;
+
+  bool ok = (point->valve == valve);
+  if (samples == 0U) {
+    ok = ok && TempHistory_IsGap(point);
+  } else {
+    const double mean = (double)sum_cdeg / (double)samples;
+    const double target = (double)target_sum / (double)samples;
+    ok = ok && !TempHistory_IsGap(point) && point->min_cdeg == min_cdeg &&
+         point->max_cdeg == max_cdeg &&
+         fabs((double)point->avg_cdeg - mean) <= 1.0 &&
+         fabs((double)point->target_index - target) <= 1.0;
+  }
+  if (!ok) {
+    if (*errors < 5U) {
+      printf("  %s at minute %lu: got min %d max %d avg %d target %u "
+             "valve %u, expected min %ld max %ld samples %llu valve %llu\n",
+             tier_name, (unsigned long)first, point->min_cdeg,
+             point->max_cdeg, point->avg_cdeg, point->target_index,
+             point->valve, (long)min_cdeg, (long)max_cdeg,
+             (unsigned long long)samples, (unsigned long long)valve);
+    }
+    (*errors)++;
+  }
+  return ok;
+}
+
+int HostSim_HistoryEval(void) {
+  static const char *const k_tier_names[TEMP_HISTORY_TIER_COUNT] = {
+      "minute", "quarter", "hour"};
+
+  printf("History eval: %u days at %u ms, %lu bytes\n",
+         (unsigned)HISTORY_EVAL_DAYS, (unsigned)HISTORY_EVAL_PERIOD_MS,
+         (unsigned long)sizeof(TempHistory_t));
+
+  TempHistory_Init(&s_history);
+
+  /* Feed the samples */
+  const uint64_t end_ms = (uint64_t)HISTORY_EVAL_MINUTES *
+                          TEMP_HISTORY_MINUTE_MS;
+  uint32_t motor_total_ms = 0U;
+  uint32_t motor_pending_ms = 0U;
+  uint32_t max_closes = 0U;
+  uint64_t samples = 0U;
+  const clock_t started = clock();
+
+  for (uint64_t t_ms = 0U; t_ms < end_ms;) {
+    const uint32_t minute = (uint32_t)(t_ms / TEMP_HISTORY_MINUTE_MS);
+    const uint32_t minute_of_day = minute % 1440U;
+    const bool day = minute_of_day >= 6U * 60U && minute_of_day < 22U * 60U;
+
+    /* Motor runs of up to 4 s, about every ten minutes */
+    if (eval_rand() % 2400U == 0U) {
+      motor_pending_ms += 500U + eval_rand() % 3500U;
+    }
+
+    if (!in_stall(minute)) {
+      const int32_t cdeg = room_cdeg(t_ms, day);
+      const uint8_t target =
+          day ? HISTORY_EVAL_DAY_INDEX : HISTORY_EVAL_NIGHT_INDEX;
+      motor_total_ms += motor_pending_ms;
+
+      HistoryEvalMinute_t *record = &s_minutes[minute];
+      if (record->samples == 0U) {
+        record->min_cdeg = cdeg;
+        record->max_cdeg = cdeg;
+      }
+      if (cdeg < record->min_cdeg)
+        record->min_cdeg = cdeg;
+      if (cdeg > record->max_cdeg)
+        record->max_cdeg = cdeg;
+      record->sum_cdeg += cdeg;
+      record->target_sum += target;
+      record->samples++;
+      record->motor_ms += motor_pending_ms;
+      motor_pending_ms = 0U;
+
+      uint16_t heads[TEMP_HISTORY_TIER_COUNT];
+      for (uint32_t tier = 0U; tier < TEMP_HISTORY_TIER_COUNT; tier++) {
+        heads[tier] = s_history.rings[tier].head;
+      }
+      TempHistory_Add(&s_history, (uint32_t)(HISTORY_EVAL_START_MS + t_ms),
+                      cdeg, target, motor_total_ms);
+      uint32_t closes = 0U;
+      for (uint32_t tier = 0U; tier < TEMP_HISTORY_TIER_COUNT; tier++) {
+        const uint32_t capacity =
+            TempHistory_Capacity((TempHistoryTier_t)tier);
+        closes += (s_history.rings[tier].head + capacity - heads[tier]) %
+                  capacity;
+      }
+      if (!in_stall(minute == 0U ? 0U : minute - 1U) && closes > max_closes) {
+        max_closes = closes;
+      }
+      samples++;
+    }
+
+    /* 250 ms with the odd late run */
+    t_ms += HISTORY_EVAL_PERIOD_MS + ((eval_rand() % 50U == 0U) ? 40U : 0U);
+  }
+  const double elapsed_s = (double)(clock() - started) / CLOCKS_PER_SEC;
+
+  /* The last minute is still open */
+  const uint32_t closed_minutes =
+      (uint32_t)((end_ms - 1U) / TEMP_HISTORY_MINUTE_MS);
+  uint32_t errors = 0U;
+  uint32_t checked = 0U;
+  bool counts_ok = true;
+
+  for (uint32_t tier = 0U; tier < TEMP_HISTORY_TIER_COUNT; tier++) {
+    const uint32_t span = TempHistory_PointMinutes((TempHistoryTier_t)tier);
+    const uint32_t closed = closed_minutes / span;
+    const uint32_t expected = (closed < TempHistory_Capacity(
+                                            (TempHistoryTier_t)tier))
+                                  ? closed
+                                  : TempHistory_Capacity((TempHistoryTier_t)tier);
+    const uint16_t count =
+        TempHistory_Count(&s_history, (TempHistoryTier_t)tier);
+    if (count != expected) {
+      printf("  %s count %u, expected %lu\n", k_tier_names[tier],
+             (unsigned)count, (unsigned long)expected);
+      counts_ok = false;
+    }
+    for (uint16_t age = 0U; age < count; age++) {
+      TempHistoryPoint_t point;
+      TempHistory_Get(&s_history, (TempHistoryTier_t)tier, age, &point);
+      const uint32_t first = (closed - 1U - age) * span;
+      check_point(&point, first, span, k_tier_names[tier], &errors);
+      checked++;
+    }
+  }
+
+  /* 24 h plot: every column merges the minutes it covers */
+  TempHistoryPoint_t columns[HISTORY_EVAL_COLUMNS];
+  uint32_t column_errors = 0U;
+  TempHistory_Columns(&s_history, TEMP_HISTORY_TIER_MINUTE, columns,
+                      HISTORY_EVAL_COLUMNS);
+  for (uint32_t c = 0U; c < HISTORY_EVAL_COLUMNS; c++) {
+    const uint32_t first_slot = c * TEMP_HISTORY_MINUTE_POINTS /
+                                HISTORY_EVAL_COLUMNS;
+    const uint32_t last_slot = (c + 1U) * TEMP_HISTORY_MINUTE_POINTS /
+                               HISTORY_EVAL_COLUMNS;
+    const uint32_t first =
+        closed_minutes - TEMP_HISTORY_MINUTE_POINTS + first_slot;
+    int32_t min_cdeg = INT32_MAX;
+    int32_t max_cdeg = INT32_MIN;
+    for (uint32_t m = first; m < first + (last_slot - first_slot); m++) {
+      if (s_minutes[m].samples == 0U)
+        continue;
+      if (s_minutes[m].min_cdeg < min_cdeg)
+        min_cdeg = s_minutes[m].min_cdeg;
+      if (s_minutes[m].max_cdeg > max_cdeg)
+        max_cdeg = s_minutes[m].max_cdeg;
+    }
+    if (TempHistory_IsGap(&columns[c]) || columns[c].min_cdeg != min_cdeg ||
+        columns[c].max_cdeg != max_cdeg) {
+      column_errors++;
+    }
+  }
+
+  /* Gaps where the stalls were */
+  uint32_t gaps[TEMP_HISTORY_TIER_COUNT] = {0U};
+  for (uint32_t tier = 0U; tier < TEMP_HISTORY_TIER_COUNT; tier++) {
+    const uint16_t count =
+        TempHistory_Count(&s_history, (TempHistoryTier_t)tier);
+    for (uint16_t age = 0U; age < count; age++) {
+      TempHistoryPoint_t point;
+      TempHistory_Get(&s_history, (TempHistoryTier_t)tier, age, &point);
+      if (TempHistory_IsGap(&point)) {
+        gaps[tier]++;
+      }
+    }
+  }
+
+  printf("  %llu samples in %.2f s host time (%.0f ns each), at most %lu "
+         "points closed per sample\n",
+         (unsigned long long)samples, elapsed_s,
+         (samples != 0U) ? elapsed_s * 1e9 / (double)samples : 0.0,
+         (unsigned long)max_closes);
+  printf("  %lu points checked, %lu wrong; %lu of %u columns wrong; gaps "
+         "%lu/%lu/%lu\n",
+         (unsigned long)checked, (unsigned long)errors,
+         (unsigned long)column_errors, (unsigned)HISTORY_EVAL_COLUMNS,
+         (unsigned long)gaps[0], (unsigned long)gaps[1],
+         (unsigned long)gaps[2]);
+  TempHistory_Report(&s_history);
+  printf("HISTORY_EVAL {\"bytes\":%lu,\"checked\":%lu,\"errors\":%lu,"
+         "\"column_errors\":%lu,\"max_closes\":%lu,\"gaps\":[%lu,%lu,%lu]}\n",
+         (unsigned long)sizeof(TempHistory_t), (unsigned long)checked,
+         (unsigned long)errors, (unsigned long)column_errors,
+         (unsigned long)max_closes, (unsigned long)gaps[0],
+         (unsigned long)gaps[1], (unsigned long)gaps[2]);
+
+  const bool pass = counts_ok && errors == 0U && column_errors == 0U &&
+                    max_closes <= TEMP_HISTORY_TIER_COUNT &&
+                    gaps[TEMP_HISTORY_TIER_MINUTE] != 0U &&
+                    gaps[TEMP_HISTORY_TIER_QUARTER] != 0U &&
+                    gaps[TEMP_HISTORY_TIER_HOUR] != 0U;
+  printf("History eval: %s\n", pass ? "PASS" : "FAIL");
+  return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
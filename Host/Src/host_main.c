@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ * @file           :  host_main.c
+ * @brief          :  Entry point of the host (POSIX) build.
+ *
+ * @details        :  Parses the simulation options, prepares the simulated
+ *                    hardware and then runs the unmodified firmware main()
+ *                    (compiled as firmware_main) so the queues, models and
+ *                    tasks are created exactly as on target.
+ *
+ *                    Usage: miratherm-radiator-thermostat-software
+ *                      [--speed N] [--duration S] [--flash FILE]
+ *                      [--display FILE.pbm] [--script FILE] [--no-console]
+ *                      [--date YYYY-MM-DD] [--time HH:MM] [--bench]
+ *                      [--record FILE.rpl] [--replay FILE.rpl]
+ *                      [--filter-eval FILE.rpl] [--sampling-eval]
+ *                      [--battery-eval] [--motor-guard-eval]
+ *                      [--self-heating-fit FILE.rpl] [--self-heating-eval]
+ *                      [--config-codec-eval] [--optimum-start-eval]
+ *                      [--window-eval] [--history-eval]
+ *                      [--ripple-eval] [--ripple-trace FILE]
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "benchmarks.h"
+#include "host_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Firmware entry point, see the main=firmware_main define in Host/ */
+int firmware_main(void);
+
+static void print_usage(const char *program) {
+  printf("Usage: %s [options]\n"
+         "  --speed N          simulated ms per real ms (1..%u, default 1)\n"
+         "  --duration S       stop after S simulated seconds\n"
+         "  --flash FILE       load/save the 512 KB flash image\n"
+         "  --display FILE     write the display as PBM on exit\n"
+         "  --script FILE      execute simulator commands from FILE\n"
+         "  --no-console       do not read commands from stdin\n"
+         "  --date YYYY-MM-DD  initial RTC date (default 2025-01-06)\n"
+         "  --time HH:MM       initial RTC time (default 08:00)\n"
+         "  --bench            run the kernel benchmarks and exit\n"
+         "  --record FILE      record inputs, ADC and RTC for replay\n"
+         "  --replay FILE      replay a recorded trace at full speed\n"
+         "  --filter-eval FILE compare temperature filters on a trace\n"
+         "  --sampling-eval    compare temperature sampling on a day\n"
+         "  --battery-eval     compare battery SoC estimates on discharges\n"
+         "  --motor-guard-eval check the motor cut-off on current waveforms\n"
+         "  --self-heating-fit FILE fit the self-heating model to a trace\n"
+         "  --self-heating-eval check the self-heating fit on a synthetic "
+         "trace\n"
+         "  --config-codec-eval check the configuration record encoding\n"
+         "  --optimum-start-eval check preheating on a simulated room\n"
+         "  --window-eval check open-window detection on room traces\n"
+         "  --history-eval check the temperature history on a month\n"
+         "  --ripple-eval check valve position counting on a motor model\n"
+         "  --ripple-trace FILE count the ripples of a motor current trace\n",
+         program, HOST_SIM_MAX_SPEED);
+}
+
+int main(int argc, char **argv) {
+  HostSimConfig_t config = {
+      .speed = 1U,
+      .duration_s = 0U,
+      .flash_path = NULL,
+      .display_path = NULL,
+      .script_path = NULL,
+      .record_path = NULL,
+      .replay_path = NULL,
+      .interactive = true,
+      .year = 2025U,
+      .month = 1U,
+      .day = 6U,
+      .hour = 8U,
+      .minute = 0U,
+  };
+
+  for (int i = 1; i < argc; i++) {
+    const char *option = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+    if (strcmp(option, "--no-console") == 0) {
+      config.interactive = false;
+      continue;
+    }
+    if (strcmp(option, "--bench") == 0) {
+      /* Pure kernels only, no simulated hardware or scheduler needed */
+      Benchmarks_Run();
+      return (Benchmarks_Check() == 0U) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (strcmp(option, "--sampling-eval") == 0) {
+      return HostSim_SamplingEval();
+    }
+    if (strcmp(option, "--battery-eval") == 0) {
+      return HostSim_BatteryEval();
+    }
+    if (strcmp(option, "--motor-guard-eval") == 0) {
+      return HostSim_MotorGuardEval();
+    }
+    if (strcmp(option, "--self-heating-eval") == 0) {
+      return HostSim_SelfHeatingEval();
+    }
+    if (strcmp(option, "--config-codec-eval") == 0) {
+      return HostSim_ConfigCodecEval();
+    }
+    if (strcmp(option, "--optimum-start-eval") == 0) {
+      return HostSim_OptimumStartEval();
+    }
+    if (strcmp(option, "--window-eval") == 0) {
+      return HostSim_WindowEval();
+    }
+    if (strcmp(option, "--history-eval") == 0) {
+      return HostSim_HistoryEval();
+    }
+    if (strcmp(option, "--ripple-eval") == 0) {
+      return HostSim_RippleEval();
+    }
+    if (strcmp(option, "--help") == 0 || value == NULL) {
+      print_usage(argv[0]);
+      return (strcmp(option, "--help") == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (strcmp(option, "--filter-eval") == 0) {
+      /* Offline, like --bench */
+      return HostSim_FilterEval(value);
+    }
+    if (strcmp(option, "--self-heating-fit") == 0) {
+      return HostSim_SelfHeatingFit(value);
+    }
+    if (strcmp(option, "--ripple-trace") == 0) {
+      return HostSim_RippleTrace(value);
+    }
+
+    unsigned year, month, day, hour, minute;
+    if (strcmp(option, "--speed") == 0) {
+      config.speed = (uint32_t)strtoul(value, NULL, 10);
+    } else if (strcmp(option, "--duration") == 0) {
+      config.duration_s = (uint32_t)strtoul(value, NULL, 10);
+    } else if (strcmp(option, "--flash") == 0) {
+      config.flash_path = value;
+    } else if (strcmp(option, "--display") == 0) {
+      config.display_path = value;
+    } else if (strcmp(option, "--script") == 0) {
+      config.script_path = value;
+    } else if (strcmp(option, "--record") == 0) {
+      config.record_path = value;
+    } else if (strcmp(option, "--replay") == 0) {
+      config.replay_path = value;
+    } else if (strcmp(option, "--date") == 0 &&
+               sscanf(value, "%u-%u-%u", &year, &month, &day) == 3 &&
+               year >= 2000U && year <= 2099U) {
+      config.year = (uint16_t)year;
+      config.month = (uint8_t)month;
+      config.day = (uint8_t)day;
+    } else if (strcmp(option, "--time") == 0 &&
+               sscanf(value, "%u:%u", &hour, &minute) == 2) {
+      config.hour = (uint8_t)hour;
+      config.minute = (uint8_t)minute;
+    } else {
+      print_usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    i++;
+  }
+
+  /* Log lines from several tasks must not interleave mid-line */
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  HostSim_Init(&config);
+  HostSim_Start();
+
+  /* Does not return: osKernelStart() runs the scheduler */
+  return firmware_main();
+}
@@ -0,0 +1,27 @@
+/**
+ ******************************************************************************
+ * @file           :  host_port.c
+ * @brief          :  FreeRTOS POSIX port with a run-time selectable tick
+ *                    period.
+ *
+ * @details        :  The upstream port arms its tick timer with the
+ *                    compile-time portTICK_RATE_MICROSECONDS. Redirecting
+ *                    that symbol to the simulation lets one kernel tick (one
+ *                    simulated millisecond) elapse in less real time, which
+ *                    is how the host build runs faster than real time.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "FreeRTOS.h"
+#include "host_sim.h"
+
+#undef portTICK_RATE_MICROSECONDS
+#define portTICK_RATE_MICROSECONDS HostSim_GetTickPeriodUs()
+
+#include "port.c"
@@ -0,0 +1,631 @@
+/**
+ ******************************************************************************
+ * @file           :  host_sim.c
+ * @brief          :  Simulated clock, environment and user input for the host
+ *                    build.
+ *
+ * @details        :  Time base: the FreeRTOS POSIX port ticks every
+ *                    HostSim_GetTickPeriodUs() real microseconds and one
+ *                    kernel tick is one simulated millisecond. The tick hook
+ *                    stands in for the TIM17 HAL time base interrupt.
+ *                    With --replay the timer is disarmed and the idle hook
+ *                    raises SIGALRM, which runs the port's tick handler on
+ *                    the idle thread: time then advances only while all
+ *                    tasks are blocked, at full speed and deterministically.
+ *
+ *                    The simulation task runs at the highest priority once
+ *                    per tick and emulates the interrupt sources: ADC DMA
+ *                    sequences, button EXTI lines and the encoder counter.
+ *
+ *                    Commands (stdin or --script, one per line):
+ *                      l | m | r          click left / middle / right button
+ *                      hold <l|m|r> <ms>  press a button for <ms>
+ *                      +[n] | -[n]        rotate the encoder n detents
+ *                      temp <degC>        set the ambient temperature
+ *                      vbat <V>           set the battery voltage
+ *                      motor <A>          set the driven motor current
+ *                      noise <lsb>        set the ADC noise amplitude
+ *                      wait <ms>          pause a script in simulated time
+ *                      show               print the display as text
+ *                      dump <file.pbm>    write the display as PBM
+ *                      time               print the simulated clock
+ *                      trace              dump the trace ring (trace.h)
+ *                      heap               print the heap report (mem_heap.h)
+ *                      energy             print the energy report (energy.h)
+ *                      i2c                print the I2C bus usage (i2c_bus.h)
+ *                      filter [n tau slew] set or print the temperature
+ *                                         filter (sensor_filter.h)
+ *                      selfheat [tau cpu display motor] set or print the
+ *                                         self-heating compensation
+ *                                         (self_heating.h)
+ *                      quit               stop the simulation
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "energy.h"
+#include "i2c_bus.h"
+#include "main.h"
+#include "mem_heap.h"
+#include "replay.h"
+#include "sensor_task.h"
+#include "stm32wbxx_ll_adc.h"
+#include "trace.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Simulation task configuration */
+#define HOST_SIM_TASK_STACK_WORDS (configMINIMAL_STACK_SIZE * 2U)
+#define HOST_SIM_TASK_PRIORITY (configMAX_PRIORITIES - 1U)
+
+/* Button timing */
+#define HOST_SIM_CLICK_MS 120U
+
+/* Console line queue */
+#define HOST_SIM_LINE_LEN 128U
+#define HOST_SIM_LINE_QUEUE 16U
+
+/* Visible display area (SH1106 column offset 2) */
+#define HOST_SIM_DISPLAY_WIDTH 128U
+#define HOST_SIM_DISPLAY_HEIGHT 64U
+#define HOST_SIM_DISPLAY_X_OFFSET 2U
+
+/* Simulated time run after the last record of a replayed trace */
+#define HOST_SIM_REPLAY_TAIL_MS 1000U
+
+/* Analog front end, matching sensor_task.c */
+#define HOST_SIM_MOTOR_SHUNT_OHMS 0.22f
+#define HOST_SIM_VBAT_DIVIDER 3.0f
+#define HOST_SIM_ADC_FULL_SCALE 4095.0f
+
+/* Button wiring */
+typedef struct {
+  GPIO_TypeDef *port;
+  uint16_t pin;
+  GPIO_PinState pressed_level;
+  uint64_t release_at_ms; /* 0 = not pressed */
+} HostSimButton_t;
+
+static HostSimConfig_t s_config;
+static HostSimEnvironment_t s_env = {
+    .ambient_temperature = 21.0f,
+    .battery_voltage = 3.0f,
+    .motor_current = 0.060f,
+    .vdda = 3.3f,
+    .adc_noise_lsb = 0U,
+};
+
+static volatile uint64_t s_sim_ms;
+static uint32_t s_tick_period_us = 1000U;
+static uint32_t s_noise_state = 0x12345678U;
+
+static HostSimButton_t s_buttons[3] = {
+    {BUTTON_LEFT_GPIO_Port, BUTTON_LEFT_Pin, GPIO_PIN_SET, 0U},
+    {BUTTON_MIDDLE_GPIO_Port, BUTTON_MIDDLE_Pin, GPIO_PIN_RESET, 0U},
+    {BUTTON_RIGHT_GPIO_Port, BUTTON_RIGHT_Pin, GPIO_PIN_SET, 0U},
+};
+
+/* Script playback */
+static FILE *s_script;
+static uint64_t s_script_resume_ms;
+
+/* Record/replay (replay.h) */
+static FILE *s_record;
+static uint8_t *s_replay_trace;
+static bool s_lockstep;
+
+/* Console lines handed from the stdin thread to the simulation task */
+static pthread_mutex_t s_line_lock = PTHREAD_MUTEX_INITIALIZER;
+static char s_lines[HOST_SIM_LINE_QUEUE][HOST_SIM_LINE_LEN];
+static uint32_t s_line_head;
+static uint32_t s_line_tail;
+
+extern TIM_HandleTypeDef htim17;
+
+/* Clock ------------------------------------------------------------------- */
+uint32_t HostSim_GetTickPeriodUs(void) { return s_tick_period_us; }
+
+uint64_t HostSim_GetTimeMs(void) { return s_sim_ms; }
+
+/* Kernel tick = TIM17 time base interrupt of the target */
+void vApplicationTickHook(void) {
+  s_sim_ms += 1U;
+  HAL_TIM_PeriodElapsedCallback(&htim17);
+}
+
+/* Lockstep: the next tick only comes once every task is blocked */
+void vApplicationIdleHook(void) {
+  if (s_lockstep)
+    raise(SIGALRM);
+}
+
+void vAssertCalled(const char *file, unsigned long line) {
+  fprintf(stderr, "[host] configASSERT failed at %s:%lu\n", file, line);
+  fflush(stderr);
+  abort();
+}
+
+/* Environment ------------------------------------------------------------- */
+void HostSim_GetEnvironment(HostSimEnvironment_t *env) {
+  if (env == NULL)
+    return;
+  taskENTER_CRITICAL();
+  *env = s_env;
+  taskEXIT_CRITICAL();
+}
+
+void HostSim_SetEnvironment(const HostSimEnvironment_t *env) {
+  if (env == NULL)
+    return;
+  taskENTER_CRITICAL();
+  s_env = *env;
+  taskEXIT_CRITICAL();
+}
+
+static uint16_t volts_to_raw(float volts, float vdda, uint16_t noise_lsb) {
+  float raw = volts / vdda * HOST_SIM_ADC_FULL_SCALE;
+  if (noise_lsb > 0U) {
+    s_noise_state = s_noise_state * 1664525U + 1013904223U;
+    const int32_t span = 2 * (int32_t)noise_lsb + 1;
+    raw += (float)((int32_t)((s_noise_state >> 8) % (uint32_t)span) -
+                   (int32_t)noise_lsb);
+  }
+  if (raw < 0.0f)
+    raw = 0.0f;
+  if (raw > HOST_SIM_ADC_FULL_SCALE)
+    raw = HOST_SIM_ADC_FULL_SCALE;
+  return (uint16_t)(raw + 0.5f);
+}
+
+/* Produce one conversion sequence: VREFINT, motor shunt, TEMPSENSOR, VBAT */
+static void generate_adc_sequence(uint16_t samples[4]) {
+  const HostSimEnvironment_t env = s_env;
+  const float cal_scale = (float)TEMPSENSOR_CAL_VREFANALOG / 1000.0f /
+                          HOST_SIM_ADC_FULL_SCALE;
+
+  const float vrefint = (float)*VREFINT_CAL_ADDR * cal_scale;
+  const float ts_cal1 = (float)*TEMPSENSOR_CAL1_ADDR * cal_scale;
+  const float ts_cal2 = (float)*TEMPSENSOR_CAL2_ADDR * cal_scale;
+  const float ts_slope =
+      (ts_cal2 - ts_cal1) / (float)(TEMPSENSOR_CAL2_TEMP - TEMPSENSOR_CAL1_TEMP);
+  const float ts_volts =
+      ts_cal1 +
+      ts_slope * (env.ambient_temperature - (float)TEMPSENSOR_CAL1_TEMP);
+
+  /* Motor draws current only while one bridge input is driven */
+  const bool motor_driven =
+      HAL_GPIO_ReadPin(MOTOR_IN1_GPIO_Port, MOTOR_IN1_Pin) !=
+      HAL_GPIO_ReadPin(MOTOR_IN2_GPIO_Port, MOTOR_IN2_Pin);
+  const float motor_current = motor_driven ? env.motor_current : 0.0f;
+
+  samples[0] = volts_to_raw(vrefint, env.vdda, env.adc_noise_lsb);
+  samples[1] = volts_to_raw(motor_current * HOST_SIM_MOTOR_SHUNT_OHMS, env.vdda,
+                            env.adc_noise_lsb);
+  samples[2] = volts_to_raw(ts_volts, env.vdda, env.adc_noise_lsb);
+  samples[3] = volts_to_raw(env.battery_voltage / HOST_SIM_VBAT_DIVIDER,
+                            env.vdda, env.adc_noise_lsb);
+}
+
+/* Display ----------------------------------------------------------------- */
+static bool display_pixel(const uint8_t *ram, uint32_t x, uint32_t y) {
+  const uint8_t page = ram[(y / 8U) * HOST_SIM_DISPLAY_COLUMNS + x +
+                           HOST_SIM_DISPLAY_X_OFFSET];
+  return ((page >> (y % 8U)) & 0x01U) != 0U;
+}
+
+static void display_print(void) {
+  const uint8_t *ram = HostShim_GetDisplayRam();
+  char row[HOST_SIM_DISPLAY_WIDTH + 3U];
+
+  for (uint32_t y = 0U; y < HOST_SIM_DISPLAY_HEIGHT; y += 2U) {
+    row[0] = '|';
+    for (uint32_t x = 0U; x < HOST_SIM_DISPLAY_WIDTH; x++) {
+      const bool top = display_pixel(ram, x, y);
+      const bool bottom = display_pixel(ram, x, y + 1U);
+      row[x + 1U] = top ? (bottom ? '8' : '\'') : (bottom ? '.' : ' ');
+    }
+    row[HOST_SIM_DISPLAY_WIDTH + 1U] = '|';
+    row[HOST_SIM_DISPLAY_WIDTH + 2U] = '\0';
+    printf("%s\n", row);
+  }
+}
+
+static bool display_dump(const char *path) {
+  FILE *file = fopen(path, "w");
+  if (file == NULL)
+    return false;
+
+  const uint8_t *ram = HostShim_GetDisplayRam();
+  fprintf(file, "P1\n%u %u\n", HOST_SIM_DISPLAY_WIDTH, HOST_SIM_DISPLAY_HEIGHT);
+  for (uint32_t y = 0U; y < HOST_SIM_DISPLAY_HEIGHT; y++) {
+    for (uint32_t x = 0U; x < HOST_SIM_DISPLAY_WIDTH; x++) {
+      fputc(display_pixel(ram, x, y) ? '1' : '0', file);
+    }
+    fputc('\n', file);
+  }
+  fclose(file);
+  return true;
+}
+
+static uint32_t display_crc32(void) {
+  const uint8_t *ram = HostShim_GetDisplayRam();
+  uint32_t crc = 0xFFFFFFFFU;
+
+  for (uint32_t i = 0U;
+       i < HOST_SIM_DISPLAY_COLUMNS * HOST_SIM_DISPLAY_PAGES; i++) {
+    crc ^= ram[i];
+    for (uint32_t bit = 0U; bit < 8U; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+  }
+  return ~crc;
+}
+
+/* Record/replay ----------------------------------------------------------- */
+uint8_t *HostSim_LoadTrace(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return NULL;
+
+  uint8_t *trace = NULL;
+  long size = -1;
+  if (fseek(file, 0, SEEK_END) == 0)
+    size = ftell(file);
+  if (size > 0 && fseek(file, 0, SEEK_SET) == 0)
+    trace = malloc((size_t)size);
+  const bool read = trace != NULL &&
+                    fread(trace, 1U, (size_t)size, file) == (size_t)size;
+  fclose(file);
+
+  if (!read || !Replay_Load(trace, (uint32_t)size)) {
+    free(trace);
+    return NULL;
+  }
+  return trace;
+}
+
+static bool replay_open(const char *path) {
+  /* The trace is used in place until the process exits */
+  s_replay_trace = HostSim_LoadTrace(path);
+  return s_replay_trace != NULL;
+}
+
+static void record_drain(void) {
+  uint8_t chunk[256];
+  uint32_t count;
+
+  if (s_record == NULL)
+    return;
+  while ((count = Replay_ReadRecording(chunk, sizeof(chunk))) > 0U) {
+    fwrite(chunk, 1U, count, s_record);
+  }
+}
+
+static void replay_update(void) {
+  if (!s_lockstep ||
+      s_sim_ms < (uint64_t)Replay_GetEndTick() + HOST_SIM_REPLAY_TAIL_MS)
+    return;
+
+  Replay_Report();
+  printf("[host] replay done, display crc32 %08lx\n",
+         (unsigned long)display_crc32());
+  HostSim_Stop(0);
+}
+
+/* Input ------------------------------------------------------------------- */
+static HostSimButton_t *button_from_name(const char *name) {
+  switch (name[0]) {
+  case 'l':
+    return &s_buttons[0];
+  case 'm':
+    return &s_buttons[1];
+  case 'r':
+    return &s_buttons[2];
+  default:
+    return NULL;
+  }
+}
+
+static void button_press(HostSimButton_t *button, uint32_t duration_ms) {
+  HostShim_SetPin(button->port, button->pin, button->pressed_level);
+  button->release_at_ms = s_sim_ms + (duration_ms == 0U ? 1U : duration_ms);
+}
+
+static void buttons_update(void) {
+  for (uint32_t i = 0U; i < 3U; i++) {
+    HostSimButton_t *button = &s_buttons[i];
+    if (button->release_at_ms != 0U && s_sim_ms >= button->release_at_ms) {
+      button->release_at_ms = 0U;
+      HostShim_SetPin(button->port, button->pin,
+                      button->pressed_level == GPIO_PIN_SET ? GPIO_PIN_RESET
+                                                            : GPIO_PIN_SET);
+    }
+  }
+}
+
+/* Commands ---------------------------------------------------------------- */
+bool HostSim_ExecuteCommand(const char *line) {
+  char cmd[HOST_SIM_LINE_LEN];
+  char arg[HOST_SIM_LINE_LEN];
+  char extra[HOST_SIM_LINE_LEN];
+
+  const int fields = sscanf(line, " %127s %127s %127s", cmd, arg, extra);
+  if (fields <= 0 || cmd[0] == '#')
+    return true;
+
+  HostSimEnvironment_t env;
+  HostSim_GetEnvironment(&env);
+
+  if ((cmd[0] == '+' || cmd[0] == '-') &&
+      (cmd[1] == '\0' || (cmd[1] >= '0' && cmd[1] <= '9'))) {
+    const int32_t steps = (cmd[1] == '\0') ? 1 : atoi(&cmd[1]);
+    /* KY-040: two counter ticks per detent */
+    HostShim_AddEncoderTicks((cmd[0] == '+' ? 2 : -2) * steps);
+  } else if (strlen(cmd) == 1U && button_from_name(cmd) != NULL) {
+    button_press(button_from_name(cmd), HOST_SIM_CLICK_MS);
+  } else if (strcmp(cmd, "hold") == 0 && fields == 3 &&
+             button_from_name(arg) != NULL) {
+    button_press(button_from_name(arg), (uint32_t)strtoul(extra, NULL, 10));
+  } else if (strcmp(cmd, "temp") == 0 && fields >= 2) {
+    env.ambient_temperature = strtof(arg, NULL);
+    HostSim_SetEnvironment(&env);
+  } else if (strcmp(cmd, "vbat") == 0 && fields >= 2) {
+    env.battery_voltage = strtof(arg, NULL);
+    HostSim_SetEnvironment(&env);
+  } else if (strcmp(cmd, "motor") == 0 && fields >= 2) {
+    env.motor_current = strtof(arg, NULL);
+    HostSim_SetEnvironment(&env);
+  } else if (strcmp(cmd, "noise") == 0 && fields >= 2) {
+    env.adc_noise_lsb = (uint16_t)strtoul(arg, NULL, 10);
+    HostSim_SetEnvironment(&env);
+  } else if (strcmp(cmd, "wait") == 0 && fields >= 2) {
+    s_script_resume_ms = s_sim_ms + strtoull(arg, NULL, 10);
+  } else if (strcmp(cmd, "show") == 0) {
+    display_print();
+  } else if (strcmp(cmd, "dump") == 0 && fields >= 2) {
+    if (!display_dump(arg))
+      printf("[host] cannot write %s\n", arg);
+  } else if (strcmp(cmd, "time") == 0) {
+    RTC_HandleTypeDef rtc = {.Instance = RTC, .Init.SynchPrediv = 255U};
+    RTC_TimeTypeDef time;
+    RTC_DateTypeDef date;
+    HAL_RTC_GetTime(&rtc, &time, RTC_FORMAT_BIN);
+    HAL_RTC_GetDate(&rtc, &date, RTC_FORMAT_BIN);
+    printf("[host] t=%llu ms, RTC 20%02u-%02u-%02u %02u:%02u:%02u\n",
+           (unsigned long long)s_sim_ms, date.Year, date.Month, date.Date,
+           time.Hours, time.Minutes, time.Seconds);
+  } else if (strcmp(cmd, "trace") == 0) {
+#if OS_TRACE_ENABLED
+    Trace_Dump();
+#else
+    printf("[host] tracing not built in (OS_TRACE_ENABLED=0)\n");
+#endif
+  } else if (strcmp(cmd, "heap") == 0) {
+    MemHeap_Report();
+  } else if (strcmp(cmd, "energy") == 0) {
+    Energy_Report();
+  } else if (strcmp(cmd, "i2c") == 0) {
+    I2CBus_Report();
+  } else if (strcmp(cmd, "filter") == 0) {
+    SensorFilterParams_t params;
+    unsigned median_n, tau_s, slew;
+    if (sscanf(line, " %*s %u %u %u", &median_n, &tau_s, &slew) == 3) {
+      params.median_n = (uint8_t)median_n;
+      params.iir_tau_s = (uint16_t)tau_s;
+      params.slew_cdeg_per_min = (uint16_t)slew;
+      SensorTask_SetTemperatureFilter(&params);
+    }
+    SensorTask_GetTemperatureFilter(&params);
+    printf("[host] filter: median %u, tau %u s, slew %u cdeg/min\n",
+           params.median_n, params.iir_tau_s, params.slew_cdeg_per_min);
+  } else if (strcmp(cmd, "selfheat") == 0) {
+    SelfHeatingParams_t params;
+    unsigned tau_s;
+    int cpu, display, motor;
+    if (sscanf(line, " %*s %u %d %d %d", &tau_s, &cpu, &display, &motor) ==
+        4) {
+      params.tau_s = (uint16_t)tau_s;
+      params.cpu_cdeg = (int16_t)cpu;
+      params.display_cdeg = (int16_t)display;
+      params.motor_cdeg = (int16_t)motor;
+      SensorTask_SetSelfHeating(&params);
+    }
+    SensorTask_GetSelfHeating(&params);
+    printf("[host] selfheat: tau %u s, cpu %d, display %d, motor %d cdeg\n",
+           params.tau_s, params.cpu_cdeg, params.display_cdeg,
+           params.motor_cdeg);
+  } else if (strcmp(cmd, "quit") == 0) {
+    HostSim_Stop(0);
+  } else {
+    printf("[host] unknown command: %s\n", line);
+    return false;
+  }
+  return true;
+}
+
+static void script_update(void) {
+  char line[HOST_SIM_LINE_LEN];
+
+  while (s_script != NULL && s_sim_ms >= s_script_resume_ms) {
+    if (fgets(line, sizeof(line), s_script) == NULL) {
+      fclose(s_script);
+      s_script = NULL;
+      break;
+    }
+    HostSim_ExecuteCommand(line);
+  }
+}
+
+static void console_update(void) {
+  char line[HOST_SIM_LINE_LEN];
+
+  for (;;) {
+    bool have_line = false;
+    pthread_mutex_lock(&s_line_lock);
+    if (s_line_tail != s_line_head) {
+      memcpy(line, s_lines[s_line_tail % HOST_SIM_LINE_QUEUE], sizeof(line));
+      s_line_tail++;
+      have_line = true;
+    }
+    pthread_mutex_unlock(&s_line_lock);
+
+    if (!have_line)
+      break;
+    HostSim_ExecuteCommand(line);
+  }
+}
+
+/* Plain pthread: never calls the kernel, only hands lines over */
+static void *console_thread(void *argument) {
+  (void)argument;
+  char line[HOST_SIM_LINE_LEN];
+
+  while (fgets(line, sizeof(line), stdin) != NULL) {
+    pthread_mutex_lock(&s_line_lock);
+    if (s_line_head - s_line_tail < HOST_SIM_LINE_QUEUE) {
+      memcpy(s_lines[s_line_head % HOST_SIM_LINE_QUEUE], line, sizeof(line));
+      s_line_head++;
+    }
+    pthread_mutex_unlock(&s_line_lock);
+  }
+  return NULL;
+}
+
+/* Simulation task --------------------------------------------------------- */
+static void host_sim_task(void *argument) {
+  (void)argument;
+  TickType_t last_wake = xTaskGetTickCount();
+  uint64_t next_adc_ms = HOST_SIM_ADC_SEQUENCE_MS;
+  uint16_t samples[4];
+
+  for (;;) {
+    vTaskDelayUntil(&last_wake, 1U);
+
+    if (s_config.duration_s != 0U &&
+        s_sim_ms >= (uint64_t)s_config.duration_s * 1000U) {
+      HostSim_Stop(0);
+    }
+
+    script_update();
+    console_update();
+    buttons_update();
+    record_drain();
+    replay_update();
+
+    if (!HostShim_IsAdcRunning()) {
+      next_adc_ms = s_sim_ms + HOST_SIM_ADC_SEQUENCE_MS;
+    } else if (s_sim_ms >= next_adc_ms) {
+      generate_adc_sequence(samples);
+      HostShim_CompleteAdcSequence(samples, 4U);
+      next_adc_ms += HOST_SIM_ADC_SEQUENCE_MS;
+    }
+  }
+}
+
+/* Lifecycle --------------------------------------------------------------- */
+void HostSim_Init(const HostSimConfig_t *config) {
+  s_config = *config;
+
+  uint32_t speed = s_config.speed;
+  if (speed == 0U)
+    speed = 1U;
+  if (speed > HOST_SIM_MAX_SPEED)
+    speed = HOST_SIM_MAX_SPEED;
+  s_config.speed = speed;
+  s_tick_period_us = 1000U / speed;
+
+  if (HostShim_LoadFlash(s_config.flash_path)) {
+    printf("[host] flash image loaded from %s\n", s_config.flash_path);
+  }
+  HostShim_SetRtcEpoch(s_config.year, s_config.month, s_config.day,
+                       s_config.hour, s_config.minute);
+
+  if (s_config.replay_path != NULL) {
+    if (!replay_open(s_config.replay_path)) {
+      fprintf(stderr, "[host] cannot replay %s\n", s_config.replay_path);
+      exit(EXIT_FAILURE);
+    }
+    /* Disarm the tick timer; console input would break determinism */
+    s_lockstep = true;
+    s_tick_period_us = 0U;
+    s_config.interactive = false;
+  }
+
+  if (s_config.record_path != NULL) {
+    s_record = fopen(s_config.record_path, "wb");
+    if (s_record == NULL) {
+      printf("[host] cannot write %s\n", s_config.record_path);
+    } else {
+      Replay_StartRecording();
+    }
+  }
+
+  if (s_config.script_path != NULL) {
+    s_script = fopen(s_config.script_path, "r");
+    if (s_script == NULL) {
+      printf("[host] cannot open script %s\n", s_config.script_path);
+    }
+  }
+}
+
+void HostSim_Start(void) {
+  if (xTaskCreate(host_sim_task, "hostSim", HOST_SIM_TASK_STACK_WORDS, NULL,
+                  HOST_SIM_TASK_PRIORITY, NULL) != pdPASS) {
+    fprintf(stderr, "[host] cannot create simulation task\n");
+    exit(EXIT_FAILURE);
+  }
+
+  if (s_config.interactive) {
+    /* Keep the kernel's signals away from the console thread */
+    sigset_t all_signals;
+    sigset_t previous;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_SETMASK, &all_signals, &previous);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, console_thread, NULL) == 0) {
+      pthread_detach(thread);
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+  }
+
+  if (s_lockstep) {
+    printf("[host] replaying %s in lockstep (%lu ms)\n", s_config.replay_path,
+           (unsigned long)Replay_GetEndTick());
+  } else {
+    printf("[host] simulation running at %lux (tick %lu us)\n",
+           (unsigned long)s_config.speed, (unsigned long)s_tick_period_us);
+  }
+}
+
+void HostSim_Stop(int exit_code) {
+  printf("[host] stopping at t=%llu ms\n", (unsigned long long)s_sim_ms);
+
+  if (s_config.flash_path != NULL && !HostShim_SaveFlash(s_config.flash_path)) {
+    printf("[host] cannot save flash image to %s\n", s_config.flash_path);
+  }
+  if (s_config.display_path != NULL && !display_dump(s_config.display_path)) {
+    printf("[host] cannot write %s\n", s_config.display_path);
+  }
+  if (s_record != NULL) {
+    record_drain();
+    fclose(s_record);
+  }
+
+  fflush(stdout);
+  exit(exit_code);
+}
@@ -0,0 +1,238 @@
+/**
+ ******************************************************************************
+ * @file           :  motor_guard_eval.c
+ * @brief          :  Offline evaluation of the motor overcurrent and stall
+ *                    cut-off on synthetic current waveforms
+ *                    (--motor-guard-eval).
+ *
+ * @details        :  Samples each waveform every SENSOR_TASK_MOTOR_SEQUENCE_US
+ *                    through the 12-bit shunt conversion, as the DMA
+ *                    interrupt of the continuous ADC sequence does, and feeds
+ *                    the motor guard with the default thresholds. The event
+ *                    of a waveform (stall, short) is swept over one sample
+ *                    period, so the worst phase is seen. For each waveform it
+ *                    reports:
+ *                      expect   cut-off the waveform calls for
+ *                      result   cut-off of the guard, at every phase
+ *                      reaction worst time from the event to the sample
+ *                               that cut the motor off, in us
+ *                    followed by one "MOTOR_GUARD {...}" JSON line per
+ *                    waveform. Fails on a wrong result or a reaction above
+ *                    MOTOR_GUARD_EVAL_MAX_REACTION_US. The interrupt latency
+ *                    (a few us) is not modelled. No scheduler is started.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "motor_guard.h"
+#include "sensor_calc.h"
+#include "sensor_task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MOTOR_GUARD_EVAL_VDDA_MV 3000U
+#define MOTOR_GUARD_EVAL_MAX_REACTION_US 5000U
+#define MOTOR_GUARD_EVAL_PHASES 16U
+#define MOTOR_GUARD_EVAL_RUN_US 2000000U
+#define MOTOR_GUARD_EVAL_SCAN_US 10U
+
+/* Running valve drive: inrush at stall current decaying to the running
+   current, +-8 mA of ripple and 1 ms commutation peaks every 15 ms */
+#define MOTOR_GUARD_EVAL_RUNNING_MA 60
+#define MOTOR_GUARD_EVAL_STALL_MA 180
+#define MOTOR_GUARD_EVAL_PEAK_MA 220
+#define MOTOR_GUARD_EVAL_SHORT_MA 1500
+
+typedef enum {
+  WAVE_RUN = 0,    /* Normal run, must not trip */
+  WAVE_STALL,      /* Blocked at the event */
+  WAVE_STALL_RAMP, /* Load rising to a stall over 200 ms from the event */
+  WAVE_BLOCKED,    /* Blocked from the start, event at the blanking end */
+  WAVE_SHORT,      /* Short circuit at the event */
+} MotorGuardEvalWave_t;
+
+typedef struct {
+  const char *name;
+  MotorGuardEvalWave_t wave;
+  MotorGuardReason_t expect;
+} MotorGuardEvalCase_t;
+
+static const MotorGuardEvalCase_t s_cases[] = {
+    {"run", WAVE_RUN, MOTOR_GUARD_OK},
+    {"stall", WAVE_STALL, MOTOR_GUARD_STALL},
+    {"stall_ramp", WAVE_STALL_RAMP, MOTOR_GUARD_STALL},
+    {"blocked", WAVE_BLOCKED, MOTOR_GUARD_STALL},
+    {"short", WAVE_SHORT, MOTOR_GUARD_OVERCURRENT},
+};
+
+typedef struct {
+  MotorGuardReason_t result; /* Same at every phase, else MOTOR_GUARD_OK */
+  bool consistent;
+  uint32_t max_reaction_us;
+} MotorGuardEvalResult_t;
+
+static int32_t running_ma(uint32_t t_us) {
+  if (t_us < 20000U) {
+    return MOTOR_GUARD_EVAL_STALL_MA;
+  }
+  if (t_us < 40000U) {
+    return MOTOR_GUARD_EVAL_STALL_MA -
+           (int32_t)(((int64_t)(MOTOR_GUARD_EVAL_STALL_MA -
+                                MOTOR_GUARD_EVAL_RUNNING_MA) *
+                      (t_us - 20000U)) /
+                     20000);
+  }
+  if (t_us % 15000U < 1000U) {
+    return MOTOR_GUARD_EVAL_PEAK_MA;
+  }
+  /* Deterministic ripple, a triangle of 4 ms */
+  const int32_t phase = (int32_t)(t_us % 4000U);
+  return MOTOR_GUARD_EVAL_RUNNING_MA - 8 +
+         ((phase < 2000) ? phase : 4000 - phase) * 16 / 2000;
+}
+
+/* Current of @p wave at @p t_us with the event at @p event_us */
+static int32_t wave_ma(MotorGuardEvalWave_t wave, uint32_t t_us,
+                       uint32_t event_us) {
+  switch (wave) {
+  case WAVE_STALL:
+    return (t_us >= event_us) ? MOTOR_GUARD_EVAL_STALL_MA : running_ma(t_us);
+  case WAVE_STALL_RAMP:
+    if (t_us < event_us) {
+      return running_ma(t_us);
+    }
+    if (t_us - event_us >= 200000U) {
+      return MOTOR_GUARD_EVAL_STALL_MA;
+    }
+    return MOTOR_GUARD_EVAL_RUNNING_MA +
+           (int32_t)(((int64_t)(MOTOR_GUARD_EVAL_STALL_MA -
+                                MOTOR_GUARD_EVAL_RUNNING_MA) *
+                      (t_us - event_us)) /
+                     200000);
+  case WAVE_BLOCKED:
+    return MOTOR_GUARD_EVAL_STALL_MA;
+  case WAVE_SHORT:
+    return (t_us >= event_us) ? MOTOR_GUARD_EVAL_SHORT_MA : running_ma(t_us);
+  default:
+    return running_ma(t_us);
+  }
+}
+
+/* Shunt current as the sensor task computes it from a 12-bit sample */
+static uint32_t convert_ma(int32_t current_ma) {
+  const uint32_t shunt_mv =
+      ((uint32_t)current_ma * SENSOR_CALC_MOTOR_SHUNT_MOHMS) / 1000U;
+  uint32_t raw = (shunt_mv * 4095U) / MOTOR_GUARD_EVAL_VDDA_MV;
+  if (raw > 4095U) {
+    raw = 4095U;
+  }
+  return SensorCalc_MotorCurrent((uint16_t)raw, MOTOR_GUARD_EVAL_VDDA_MV);
+}
+
+/* When the guard has to act: the first time from the event on the
+   converted current reaches the threshold of the expected cut-off, not
+   before the blanking end for a stall. The shunt resolution (about 4 mA)
+   is thereby not counted as reaction time. */
+static uint32_t event_start_us(const MotorGuardEvalCase_t *test,
+                               uint32_t event_us) {
+  const uint32_t threshold_ma = (test->expect == MOTOR_GUARD_OVERCURRENT)
+                                    ? MOTOR_GUARD_LIMIT_MA
+                                    : MOTOR_GUARD_STALL_MA;
+  uint32_t start_us = (test->wave == WAVE_BLOCKED) ? 0U : event_us;
+  while (start_us < MOTOR_GUARD_EVAL_RUN_US &&
+         convert_ma(wave_ma(test->wave, start_us, event_us)) < threshold_ma) {
+    start_us += MOTOR_GUARD_EVAL_SCAN_US;
+  }
+  if (test->expect == MOTOR_GUARD_STALL &&
+      start_us < MOTOR_GUARD_BLANKING_US) {
+    start_us = MOTOR_GUARD_BLANKING_US;
+  }
+  return start_us;
+}
+
+static void evaluate(const MotorGuardEvalCase_t *test,
+                     MotorGuardEvalResult_t *result) {
+  const uint32_t period_us = SENSOR_TASK_MOTOR_SEQUENCE_US;
+  result->consistent = true;
+  result->max_reaction_us = 0U;
+
+  for (uint32_t phase = 0U; phase < MOTOR_GUARD_EVAL_PHASES; phase++) {
+    const uint32_t event_us =
+        MOTOR_GUARD_EVAL_RUN_US / 2U +
+        (phase * period_us) / MOTOR_GUARD_EVAL_PHASES;
+    MotorGuard_t guard;
+    MotorGuard_Init(&guard, NULL);
+
+    MotorGuardReason_t reason = MOTOR_GUARD_OK;
+    uint32_t trip_us = 0U;
+    for (uint32_t t_us = 0U; t_us < MOTOR_GUARD_EVAL_RUN_US;
+         t_us += period_us) {
+      reason = MotorGuard_Update(
+          &guard, convert_ma(wave_ma(test->wave, t_us, event_us)), period_us);
+      if (reason != MOTOR_GUARD_OK) {
+        trip_us = t_us;
+        break;
+      }
+    }
+
+    if (phase == 0U) {
+      result->result = reason;
+    } else if (reason != result->result) {
+      result->consistent = false;
+    }
+    if (reason != MOTOR_GUARD_OK) {
+      const uint32_t start_us = event_start_us(test, event_us);
+      const uint32_t reaction_us =
+          (trip_us > start_us) ? trip_us - start_us : 0U;
+      if (reaction_us > result->max_reaction_us) {
+        result->max_reaction_us = reaction_us;
+      }
+    }
+  }
+}
+
+int HostSim_MotorGuardEval(void) {
+  const uint32_t count = sizeof(s_cases) / sizeof(s_cases[0]);
+  MotorGuardEvalResult_t results[sizeof(s_cases) / sizeof(s_cases[0])];
+  bool pass = true;
+
+  for (uint32_t i = 0U; i < count; i++) {
+    evaluate(&s_cases[i], &results[i]);
+  }
+
+  printf("Motor guard evaluation: sample every %u us, stall %u mA for %u us "
+         "after %u us blanking, limit %u mA\n",
+         (unsigned)SENSOR_TASK_MOTOR_SEQUENCE_US,
+         (unsigned)MOTOR_GUARD_STALL_MA, (unsigned)MOTOR_GUARD_DEBOUNCE_US,
+         (unsigned)MOTOR_GUARD_BLANKING_US, (unsigned)MOTOR_GUARD_LIMIT_MA);
+  printf("Waveform     expect       result       reaction us\n");
+  for (uint32_t i = 0U; i < count; i++) {
+    const MotorGuardEvalResult_t *r = &results[i];
+    const bool ok = r->consistent && r->result == s_cases[i].expect &&
+                    r->max_reaction_us <= MOTOR_GUARD_EVAL_MAX_REACTION_US;
+    pass = pass && ok;
+    printf("%-12s %-12s %-12s %11lu%s\n", s_cases[i].name,
+           MotorGuard_ReasonName(s_cases[i].expect),
+           r->consistent ? MotorGuard_ReasonName(r->result) : "varies",
+           (unsigned long)r->max_reaction_us, ok ? "" : "  FAIL");
+  }
+  for (uint32_t i = 0U; i < count; i++) {
+    const MotorGuardEvalResult_t *r = &results[i];
+    printf("MOTOR_GUARD {\"waveform\":\"%s\",\"expect\":\"%s\","
+           "\"result\":\"%s\",\"consistent\":%s,\"max_reaction_us\":%lu}\n",
+           s_cases[i].name, MotorGuard_ReasonName(s_cases[i].expect),
+           MotorGuard_ReasonName(r->result),
+           r->consistent ? "true" : "false",
+           (unsigned long)r->max_reaction_us);
+  }
+
+  return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
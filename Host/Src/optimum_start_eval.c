@@ -0,0 +1,211 @@
+/**
+ ******************************************************************************
+ * @file           :  optimum_start_eval.c
+ * @brief          :  Offline check of optimum start on a simulated room
+ *                    (--optimum-start-eval).
+ *
+ * @details        :  Runs two weeks of a weekly schedule against a room
+ *                    model: the room loses heat to the outside, which
+ *                    cools from 8 °C to -4 °C over the run with a daily
+ *                    swing, and gains it from a radiator that follows the
+ *                    valve with a lag. The valve is opened and closed
+ *                    around the effective target with a small hysteresis,
+ *                    as a thermostatic head would. Every minute the
+ *                    schedule and OptimumStart_* run as in the system
+ *                    state machine, starting without a learned rate. For
+ *                    each schedule, without and with optimum start, it
+ *                    reports:
+ *                      deficit  mean and worst shortfall of the room below
+ *                               the target when an upward slot starts, in
+ *                               cdeg
+ *                      late     mean minutes from the start of an upward
+ *                               slot until the room is within
+ *                               OPTIMUM_START_REACHED_CDEG of the target
+ *                      heat     radiator heat delivered, in hours at full
+ *                               output
+ *                      extra    heat over the run without optimum start,
+ *                               in percent
+ *                      rate     learned heat-up rate at the end, in cdeg/h
+ *                    followed by one "OPTIMUM_START {...}" JSON line per
+ *                    run. The first day is left out of the averages, as
+ *                    the room starts off the schedule. Fails unless
+ *                    optimum start cuts the mean deficit to a quarter.
+ *                    No scheduler is started.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "optimum_start.h"
+#include "schedule.h"
+#include "utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define OPTIMUM_EVAL_DAYS 14U
+#define OPTIMUM_EVAL_STEP_MIN 1U
+
+/* Room model, per hour: radiator gain at full output, heat loss per °C of
+   difference to the outside, and the radiator's own lag */
+#define OPTIMUM_EVAL_GAIN_C_H 3.5
+#define OPTIMUM_EVAL_LOSS_PER_H 0.1
+#define OPTIMUM_EVAL_RADIATOR_TAU_H 0.33
+#define OPTIMUM_EVAL_HYSTERESIS_C 0.1
+
+/* Outside temperature: linear from START to END over the run, plus a daily
+   swing peaking at 15:00 */
+#define OPTIMUM_EVAL_OUTSIDE_START_C 8.0
+#define OPTIMUM_EVAL_OUTSIDE_END_C -4.0
+#define OPTIMUM_EVAL_OUTSIDE_SWING_C 3.0
+
+#define OPTIMUM_EVAL_MAX_RATIO 0.25
+
+typedef struct {
+  uint32_t transitions;     /* Upward slot starts counted */
+  double deficit_sum_cdeg;
+  double deficit_max_cdeg;
+  double late_sum_min;
+  double heat_h;
+  uint16_t rate_cdeg_h;
+} OptimumEvalResult_t;
+
+static double outside_temp(uint32_t minute) {
+  const double day = (double)minute / (double)SCHEDULE_DAY_MIN;
+  const double hour = fmod(day, 1.0) * 24.0;
+  return OPTIMUM_EVAL_OUTSIDE_START_C +
+         (OPTIMUM_EVAL_OUTSIDE_END_C - OPTIMUM_EVAL_OUTSIDE_START_C) * day /
+             (double)OPTIMUM_EVAL_DAYS +
+         OPTIMUM_EVAL_OUTSIDE_SWING_C * cos((hour - 15.0) * M_PI / 12.0);
+}
+
+static void run(const WeeklyScheduleTypeDef *weekly, bool optimum,
+                OptimumEvalResult_t *result) {
+  OptimumStart_t model;
+  OptimumStart_Init(&model, 0U);
+
+  double room = 18.0;
+  double radiator = 0.0;
+  bool valve_open = false;
+  uint8_t previous_index = 0xFFU;
+  bool waiting = false; /* An upward slot started, target not reached */
+  uint32_t slot_start = 0U;
+  int32_t slot_target_cdeg = 0;
+
+  *result = (OptimumEvalResult_t){0};
+  const double dt_h = OPTIMUM_EVAL_STEP_MIN / 60.0;
+
+  for (uint32_t minute = 0U; minute < OPTIMUM_EVAL_DAYS * SCHEDULE_DAY_MIN;
+       minute += OPTIMUM_EVAL_STEP_MIN) {
+    const uint32_t of_day = minute % SCHEDULE_DAY_MIN;
+    const uint8_t day = (uint8_t)((minute / SCHEDULE_DAY_MIN) % SCHEDULE_DAYS);
+    const int32_t ambient_cdeg = (int32_t)lround(room * 100.0);
+    const bool counted = minute >= SCHEDULE_DAY_MIN;
+
+    ScheduleState_t slot;
+    if (!Schedule_Evaluate(weekly, day, (uint8_t)(of_day / 60U),
+                           (uint8_t)(of_day % 60U), &slot)) {
+      return;
+    }
+    uint8_t index = slot.target_index;
+    if (optimum && OptimumStart_ShouldPreheat(&model, &slot, ambient_cdeg)) {
+      index = slot.next_index;
+    }
+    const int32_t target_cdeg =
+        (int32_t)lround(Utils_IndexToTemp(index) * 100.0f);
+    (void)OptimumStart_Observe(&model, minute * 60000U, ambient_cdeg,
+                               target_cdeg);
+
+    /* Comfort at the start of each upward slot of the schedule */
+    if (previous_index != 0xFFU && slot.target_index > previous_index &&
+        counted) {
+      const int32_t scheduled_cdeg =
+          (int32_t)lround(Utils_IndexToTemp(slot.target_index) * 100.0f);
+      const double deficit =
+          (scheduled_cdeg > ambient_cdeg) ? scheduled_cdeg - ambient_cdeg : 0;
+      result->transitions++;
+      result->deficit_sum_cdeg += deficit;
+      if (deficit > result->deficit_max_cdeg) {
+        result->deficit_max_cdeg = deficit;
+      }
+      waiting = true;
+      slot_start = minute;
+      slot_target_cdeg = scheduled_cdeg;
+    }
+    previous_index = slot.target_index;
+    if (waiting &&
+        ambient_cdeg >= slot_target_cdeg - OPTIMUM_START_REACHED_CDEG) {
+      result->late_sum_min += (double)(minute - slot_start);
+      waiting = false;
+    }
+
+    /* Thermostatic valve and room */
+    const double target = target_cdeg / 100.0;
+    if (room < target - OPTIMUM_EVAL_HYSTERESIS_C) {
+      valve_open = true;
+    } else if (room > target + OPTIMUM_EVAL_HYSTERESIS_C) {
+      valve_open = false;
+    }
+    radiator += ((valve_open ? 1.0 : 0.0) - radiator) * dt_h /
+                OPTIMUM_EVAL_RADIATOR_TAU_H;
+    room += (OPTIMUM_EVAL_GAIN_C_H * radiator -
+             OPTIMUM_EVAL_LOSS_PER_H * (room - outside_temp(minute))) *
+            dt_h;
+    if (counted) {
+      result->heat_h += radiator * dt_h;
+    }
+  }
+  result->rate_cdeg_h = model.rate_cdeg_h;
+}
+
+int HostSim_OptimumStartEval(void) {
+  static const struct {
+    const char *name;
+    uint8_t num_slots;
+  } schedules[] = {{"default", 3U}, {"five_slots", 5U}};
+  bool ok = true;
+
+  printf("%-11s %-4s %8s %8s %6s %7s %6s %5s\n", "schedule", "os",
+         "deficit", "worst", "late", "heat_h", "extra", "rate");
+  for (size_t i = 0U; i < sizeof(schedules) / sizeof(schedules[0]); i++) {
+    WeeklyScheduleTypeDef weekly;
+    Schedule_LoadDefault(&weekly, schedules[i].num_slots);
+
+    OptimumEvalResult_t results[2];
+    run(&weekly, false, &results[0]);
+    run(&weekly, true, &results[1]);
+
+    double mean_deficit[2];
+    for (uint32_t on = 0U; on < 2U; on++) {
+      const OptimumEvalResult_t *r = &results[on];
+      const double n = (r->transitions != 0U) ? (double)r->transitions : 1.0;
+      const double extra =
+          100.0 * (r->heat_h - results[0].heat_h) / results[0].heat_h;
+      mean_deficit[on] = r->deficit_sum_cdeg / n;
+      printf("%-11s %-4s %8.1f %8.0f %6.1f %7.1f %5.1f%% %5u\n",
+             schedules[i].name, on ? "on" : "off", mean_deficit[on],
+             r->deficit_max_cdeg, r->late_sum_min / n, r->heat_h, extra,
+             (unsigned)r->rate_cdeg_h);
+      printf("OPTIMUM_START {\"schedule\":\"%s\",\"optimum_start\":%s,"
+             "\"transitions\":%lu,\"mean_deficit_cdeg\":%.1f,"
+             "\"max_deficit_cdeg\":%.0f,\"mean_late_min\":%.1f,"
+             "\"heat_h\":%.2f,\"extra_heat_pct\":%.1f,\"rate_cdeg_h\":%u}\n",
+             schedules[i].name, on ? "true" : "false",
+             (unsigned long)r->transitions, mean_deficit[on],
+             r->deficit_max_cdeg, r->late_sum_min / n, r->heat_h, extra,
+             (unsigned)r->rate_cdeg_h);
+    }
+    ok = ok && results[0].transitions != 0U &&
+         mean_deficit[1] <= mean_deficit[0] * OPTIMUM_EVAL_MAX_RATIO;
+  }
+
+  printf("optimum start eval: %s\n", ok ? "PASS" : "FAIL");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,552 @@
+/**
+ ******************************************************************************
+ * @file           :  ripple_eval.c
+ * @brief          :  Offline evaluation of the motor current ripple counting
+ *                    on a simulated valve drive (--ripple-eval) and on
+ *                    recorded current traces (--ripple-trace).
+ *
+ * @details        :  Simulates the DC motor of the valve drive in steps of
+ *                    RIPPLE_EVAL_STEP_US: back EMF, friction and a valve
+ *                    load, commutation ripple of the current at
+ *                    RIPPLE_EVAL_RIPPLES_PER_REV a revolution with a
+ *                    second harmonic, shunt noise and brush spikes. The
+ *                    current is sampled every RIPPLE_EVAL_SEQUENCE_US, the
+ *                    period of the continuous ADC sequence at the 64 MHz
+ *                    ADC clock, as its 4x oversampled conversion,
+ *                    quantised by the 12-bit shunt conversion, and handed to the motor guard and the
+ *                    ripple counter in the order of the DMA interrupt. The
+ *                    motor is braked when the counter reaches its target
+ *                    or the guard trips, and runs on until it stops. Each
+ *                    battery voltage and load is moved RIPPLE_EVAL_TARGET
+ *                    ripples RIPPLE_EVAL_SEEDS times, with a different rotor
+ *                    angle, sample phase and noise; three more moves end on
+ *                    the valve seat. For each it reports:
+ *                      ripple   steady ripple frequency, in Hz
+ *                      count    worst difference of the counted position
+ *                               (run-on included) to the ripples turned
+ *                      move     worst difference of the ripples turned to
+ *                               the target
+ *                      timed    difference to the target of a move timed
+ *                               for it at 3.0 V and nominal load, the
+ *                               open-loop positioning this replaces
+ *                    followed by one "RIPPLE {...}" JSON line per case.
+ *                    Fails if a count or move is off by more than
+ *                    RIPPLE_EVAL_MAX_ERROR ripples, or if a move onto the
+ *                    seat does not end with a stall. Before that it checks
+ *                    the constant band-pass tables of ripple_counter.c
+ *                    against their design and, if they differ, prints
+ *                    new ones and fails; it also fails if
+ *                    SENSOR_TASK_MOTOR_SEQUENCE_US, the period the counter
+ *                    is told, is more than RIPPLE_EVAL_MAX_PERIOD_ERROR_PCT
+ *                    off the modelled sequence. No scheduler is started.
+ *
+ *                    --ripple-trace reads a current trace recorded on a
+ *                    bench, e.g. with an oscilloscope across the shunt: one
+ *                    "t_us current_ma" pair per line, and optionally a
+ *                    "# ripples N" line with the ripples counted on it by
+ *                    other means (an encoder, by eye). The trace is
+ *                    resampled every RIPPLE_EVAL_SEQUENCE_US and
+ *                    counted; fails if it is off the given count by more
+ *                    than RIPPLE_EVAL_MAX_ERROR ripples.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "motor_guard.h"
+#include "ripple_counter.h"
+#include "sensor_calc.h"
+#include "sensor_task.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RIPPLE_EVAL_VDDA_MV 3000U
+#define RIPPLE_EVAL_STEP_US 5.0
+#define RIPPLE_EVAL_SEEDS 8U
+#define RIPPLE_EVAL_TARGET 600U
+#define RIPPLE_EVAL_SEAT 400U
+#define RIPPLE_EVAL_MAX_ERROR 3
+#define RIPPLE_EVAL_TIMEOUT_US 10000000.0
+#define RIPPLE_EVAL_TRACE_MAX_POINTS 4000000U
+
+/* The continuous sequence as the ADC runs it, independent of
+   SENSOR_TASK_MOTOR_SEQUENCE_US, which the counter and the guard assume:
+   4 channels of 4 oversampled conversions of (12.5 + 640.5) cycles at the
+   64 MHz ADC clock. The motor current is the mean of its 4 conversions. */
+#define RIPPLE_EVAL_ADC_CLOCK_MHZ 64.0
+#define RIPPLE_EVAL_CHANNELS 4U
+#define RIPPLE_EVAL_CONVERSIONS 4U
+#define RIPPLE_EVAL_CONVERSION_US ((12.5 + 640.5) / RIPPLE_EVAL_ADC_CLOCK_MHZ)
+#define RIPPLE_EVAL_SEQUENCE_US                                                \
+  (RIPPLE_EVAL_CHANNELS * RIPPLE_EVAL_CONVERSIONS * RIPPLE_EVAL_CONVERSION_US)
+/* Largest difference of the assumed sequence period to the modelled one */
+#define RIPPLE_EVAL_MAX_PERIOD_ERROR_PCT 2.0
+
+/* Valve drive: 60 mA running and 180 mA stall current at 3 V, 400 Hz of
+   ripple at nominal load, 15 ms mechanical time constant */
+#define RIPPLE_EVAL_RIPPLES_PER_REV 6.0
+#define RIPPLE_EVAL_R_OHMS 16.7
+#define RIPPLE_EVAL_KE 0.00477 /* V s/rad, also N m/A */
+#define RIPPLE_EVAL_J 2.05e-8  /* kg m^2 */
+#define RIPPLE_EVAL_FRICTION_MA 20.0
+#define RIPPLE_EVAL_NOMINAL_V 3.0
+#define RIPPLE_EVAL_NOMINAL_LOAD_MA 40.0
+
+/* Current measured: fundamental and second harmonic of the ripple in
+   parts of the current, RMS noise and rare brush spikes; the noisy cases
+   have a third less ripple and twice the noise */
+#define RIPPLE_EVAL_RIPPLE 0.15
+#define RIPPLE_EVAL_HARMONIC 0.05
+#define RIPPLE_EVAL_NOISE_MA 1.5
+#define RIPPLE_EVAL_NOISY_RIPPLE 0.10
+#define RIPPLE_EVAL_NOISY_NOISE_MA 3.0
+#define RIPPLE_EVAL_SPIKE_PER_1000 5U
+#define RIPPLE_EVAL_SPIKE_MA 25.0
+
+typedef struct {
+  const char *name;
+  double volts;
+  double load_ma; /* Valve load as motor current */
+  uint32_t seat;  /* Ripples to the valve seat, 0 for none */
+  bool noisy;
+} RippleEvalCase_t;
+
+static const RippleEvalCase_t s_cases[] = {
+    {"2.2V_light", 2.2, 20.0, 0U, false},
+    {"2.2V_nominal", 2.2, 40.0, 0U, false},
+    {"2.2V_heavy", 2.2, 60.0, 0U, false},
+    {"2.6V_light", 2.6, 20.0, 0U, false},
+    {"2.6V_nominal", 2.6, 40.0, 0U, false},
+    {"2.6V_heavy", 2.6, 60.0, 0U, false},
+    {"3.0V_light", 3.0, 20.0, 0U, false},
+    {"3.0V_nominal", 3.0, 40.0, 0U, false},
+    {"3.0V_heavy", 3.0, 60.0, 0U, false},
+    {"3.3V_light", 3.3, 20.0, 0U, false},
+    {"3.3V_nominal", 3.3, 40.0, 0U, false},
+    {"3.3V_heavy", 3.3, 60.0, 0U, false},
+    {"3.3V_noisy", 3.3, 20.0, 0U, true},
+    {"2.2V_noisy", 2.2, 60.0, 0U, true},
+    {"seat_3.0V", 3.0, 40.0, RIPPLE_EVAL_SEAT, false},
+    {"seat_2.2V", 2.2, 60.0, RIPPLE_EVAL_SEAT, false},
+    {"seat_noisy", 2.2, 60.0, RIPPLE_EVAL_SEAT, true},
+};
+
+typedef struct {
+  int32_t turned;            /* Ripples the rotor made, run-on included */
+  int32_t counted;           /* Counter position at the end */
+  MotorGuardReason_t reason; /* Guard trip that ended the move */
+  double brake_us;           /* When the motor was braked */
+} RippleEvalRun_t;
+
+typedef struct {
+  double ripple_hz;
+  int32_t count_error;    /* Worst counted - turned */
+  int32_t move_error;     /* Worst turned - target */
+  int32_t timed_error;    /* Timed move turned - target */
+  bool stalled;           /* Every move ended with a stall */
+} RippleEvalResult_t;
+
+static uint32_t s_rand_state;
+
+static uint32_t eval_rand(void) {
+  s_rand_state = s_rand_state * 1103515245U + 12345U;
+  return s_rand_state >> 8;
+}
+
+static double eval_uniform(void) {
+  return (double)(eval_rand() & 0xFFFFFFU) / (double)0x1000000U;
+}
+
+/* Roughly normal, from the sum of four uniforms */
+static double eval_gauss(void) {
+  double sum = 0.0;
+  for (uint32_t i = 0U; i < 4U; i++) {
+    sum += eval_uniform();
+  }
+  return (sum - 2.0) * sqrt(3.0);
+}
+
+/* Shunt current as the sensor task computes it from a 12-bit sample */
+static uint32_t convert_ma(double current_ma) {
+  if (current_ma < 0.0) {
+    current_ma = 0.0;
+  }
+  const double shunt_mv = current_ma * SENSOR_CALC_MOTOR_SHUNT_MOHMS / 1000.0;
+  double raw = floor(shunt_mv * 4095.0 / RIPPLE_EVAL_VDDA_MV + 0.5);
+  if (raw > 4095.0) {
+    raw = 4095.0;
+  }
+  return SensorCalc_MotorCurrent((uint16_t)raw, RIPPLE_EVAL_VDDA_MV);
+}
+
+static double steady_ripple_hz(const RippleEvalCase_t *test) {
+  const double current_a =
+      (RIPPLE_EVAL_FRICTION_MA + test->load_ma) / 1000.0;
+  const double omega =
+      (test->volts - current_a * RIPPLE_EVAL_R_OHMS) / RIPPLE_EVAL_KE;
+  return (omega > 0.0) ? omega * RIPPLE_EVAL_RIPPLES_PER_REV / (2.0 * M_PI)
+                       : 0.0;
+}
+
+static int32_t ripples_of(double theta) {
+  return (int32_t)floor(theta * RIPPLE_EVAL_RIPPLES_PER_REV / (2.0 * M_PI));
+}
+
+/* Move by the counter (timed_us = 0) or for a fixed time, from a random
+   rotor angle and sample phase */
+static void simulate(const RippleEvalCase_t *test, uint32_t seed,
+                     double timed_us, RippleEvalRun_t *run) {
+  const double dt = RIPPLE_EVAL_STEP_US * 1e-6;
+  const double sequence_us = RIPPLE_EVAL_SEQUENCE_US;
+  const double load_nm =
+      RIPPLE_EVAL_KE * (RIPPLE_EVAL_FRICTION_MA + test->load_ma) / 1000.0;
+  const double ripple =
+      test->noisy ? RIPPLE_EVAL_NOISY_RIPPLE : RIPPLE_EVAL_RIPPLE;
+  const double noise_ma =
+      test->noisy ? RIPPLE_EVAL_NOISY_NOISE_MA : RIPPLE_EVAL_NOISE_MA;
+  RippleCounter_t counter;
+  MotorGuard_t guard;
+
+  s_rand_state = seed * 2654435761U;
+  RippleCounter_Init(&counter, SENSOR_TASK_MOTOR_SEQUENCE_US);
+  MotorGuard_Init(&guard, NULL);
+  RippleCounter_Start(&counter, 1, (timed_us > 0.0) ? 0U : RIPPLE_EVAL_TARGET);
+
+  const double theta0 = eval_uniform() * 2.0 * M_PI /
+                        RIPPLE_EVAL_RIPPLES_PER_REV;
+  double theta = theta0;
+  double omega = 0.0;
+  double next_sample_us = eval_uniform() * sequence_us;
+  double sum_ma = 0.0;
+  uint32_t conversions = 0U;
+  bool driven = true;
+  bool seated = false;
+
+  run->reason = MOTOR_GUARD_OK;
+  run->brake_us = 0.0;
+
+  for (double t_us = 0.0; t_us < RIPPLE_EVAL_TIMEOUT_US;
+       t_us += RIPPLE_EVAL_STEP_US) {
+    if (driven && timed_us > 0.0 && t_us >= timed_us) {
+      driven = false;
+      run->brake_us = t_us;
+    }
+
+    /* Braked, the shorted windings carry the back EMF current past the
+       shunt */
+    const double volts = driven ? test->volts : 0.0;
+    const double current_a = (volts - RIPPLE_EVAL_KE * omega) /
+                             RIPPLE_EVAL_R_OHMS;
+    const double drive_nm = RIPPLE_EVAL_KE * current_a;
+    if (test->seat != 0U &&
+        ripples_of(theta) - ripples_of(theta0) >= (int32_t)test->seat) {
+      seated = true;
+    }
+    if (seated) {
+      omega = 0.0;
+    } else if (omega > 0.0 || drive_nm > load_nm) {
+      omega += (drive_nm - load_nm) / RIPPLE_EVAL_J * dt;
+      if (omega < 0.0) {
+        omega = 0.0;
+      }
+    }
+    theta += omega * dt;
+    if (!driven && omega == 0.0) {
+      break;
+    }
+    if (!driven || t_us < next_sample_us) {
+      continue;
+    }
+
+    const double phase = theta * RIPPLE_EVAL_RIPPLES_PER_REV;
+    sum_ma += current_a * 1000.0 *
+                  (1.0 + ripple * cos(phase) +
+                   RIPPLE_EVAL_HARMONIC * cos(2.0 * phase)) +
+              noise_ma * eval_gauss();
+    next_sample_us += RIPPLE_EVAL_CONVERSION_US;
+    if (++conversions < RIPPLE_EVAL_CONVERSIONS) {
+      continue;
+    }
+
+    /* A whole sequence: the DMA interrupt checks the guard, then counts */
+    double sample_ma = sum_ma / RIPPLE_EVAL_CONVERSIONS;
+    if (eval_rand() % 1000U < RIPPLE_EVAL_SPIKE_PER_1000) {
+      sample_ma += (eval_rand() & 1U) ? RIPPLE_EVAL_SPIKE_MA
+                                      : -RIPPLE_EVAL_SPIKE_MA;
+    }
+    sum_ma = 0.0;
+    conversions = 0U;
+    next_sample_us += sequence_us -
+                      RIPPLE_EVAL_CONVERSIONS * RIPPLE_EVAL_CONVERSION_US;
+
+    const uint32_t current_ma = convert_ma(sample_ma);
+    run->reason =
+        MotorGuard_Update(&guard, current_ma, SENSOR_TASK_MOTOR_SEQUENCE_US);
+    if (run->reason == MOTOR_GUARD_OK) {
+      (void)RippleCounter_Update(&counter, current_ma);
+      if (RippleCounter_Stalled(&counter)) {
+        run->reason = MOTOR_GUARD_STALL;
+      }
+    }
+    if (run->reason != MOTOR_GUARD_OK) {
+      /* Blocked or shorted: no run-on */
+      RippleCounter_Stop(&counter, 0U);
+      driven = false;
+      run->brake_us = t_us;
+    } else if (RippleCounter_TargetReached(&counter)) {
+      RippleCounter_Stop(&counter, RIPPLE_COUNTER_BRAKE_US);
+      driven = false;
+      run->brake_us = t_us;
+    }
+  }
+
+  run->turned = ripples_of(theta) - ripples_of(theta0);
+  run->counted = RippleCounter_GetPosition(&counter);
+}
+
+/* The coefficients the tables of ripple_counter.c are generated from:
+   constant peak gain band-pass (RBJ cookbook) at a period in samples */
+static RippleCounterBiquad_t design_filter(uint32_t period, uint32_t q_x100) {
+  const double w0 = 2.0 * M_PI / (double)period;
+  const double alpha = sin(w0) * 100.0 / (2.0 * (double)q_x100);
+  const double a0 = 1.0 + alpha;
+  const RippleCounterBiquad_t biquad = {
+      .b0 = (int16_t)lround(16384.0 * alpha / a0),
+      .a1 = (int16_t)lround(16384.0 * 2.0 * cos(w0) / a0),
+      .a2 = (int16_t)lround(16384.0 * -(1.0 - alpha) / a0),
+  };
+  return biquad;
+}
+
+/* Compare the tables with the design; print new ones if they differ */
+static bool check_filters(void) {
+  static const struct {
+    const char *name;
+    uint32_t q_x100;
+    bool tracking;
+  } tables[] = {{"k_wide", RIPPLE_COUNTER_Q_X100, false},
+                {"k_tracking", RIPPLE_COUNTER_TRACK_Q_X100, true}};
+  bool match = true;
+
+  for (uint32_t t = 0U; t < 2U; t++) {
+    for (uint32_t i = 0U; i < RIPPLE_COUNTER_TRACK_STEPS; i++) {
+      const uint32_t period = RIPPLE_COUNTER_TRACK_MIN_PERIOD + i;
+      const RippleCounterBiquad_t want =
+          design_filter(period, tables[t].q_x100);
+      const RippleCounterBiquad_t *have =
+          RippleCounter_GetFilter(period, tables[t].tracking);
+      match = match && want.b0 == have->b0 && want.a1 == have->a1 &&
+              want.a2 == have->a2;
+    }
+  }
+  if (match) {
+    return true;
+  }
+
+  printf("Band-pass tables differ from ripple_counter.h, replace them in "
+         "ripple_counter.c with:\n");
+  for (uint32_t t = 0U; t < 2U; t++) {
+    printf("static const RippleCounterBiquad_t "
+           "%s[RIPPLE_COUNTER_TRACK_STEPS] = {\n",
+           tables[t].name);
+    for (uint32_t i = 0U; i < RIPPLE_COUNTER_TRACK_STEPS; i++) {
+      const uint32_t period = RIPPLE_COUNTER_TRACK_MIN_PERIOD + i;
+      const RippleCounterBiquad_t want =
+          design_filter(period, tables[t].q_x100);
+      printf("    {%d, %d, %d}, /* %2u */\n", want.b0, want.a1, want.a2,
+             (unsigned)period);
+    }
+    printf("};\n");
+  }
+  return false;
+}
+
+static int32_t abs_max(int32_t worst, int32_t error) {
+  return (abs(error) > abs(worst)) ? error : worst;
+}
+
+static void evaluate(const RippleEvalCase_t *test, double timed_us,
+                     RippleEvalResult_t *result) {
+  result->ripple_hz = steady_ripple_hz(test);
+  result->count_error = 0;
+  result->move_error = 0;
+  result->stalled = true;
+
+  for (uint32_t seed = 1U; seed <= RIPPLE_EVAL_SEEDS; seed++) {
+    RippleEvalRun_t run;
+    simulate(test, seed, 0.0, &run);
+    result->count_error =
+        abs_max(result->count_error, run.counted - run.turned);
+    if (test->seat == 0U) {
+      result->move_error = abs_max(result->move_error,
+                                   run.turned - (int32_t)RIPPLE_EVAL_TARGET);
+    }
+    result->stalled = result->stalled && run.reason == MOTOR_GUARD_STALL;
+  }
+
+  RippleEvalRun_t timed;
+  simulate(test, 1U, timed_us, &timed);
+  result->timed_error = (test->seat == 0U)
+                            ? timed.turned - (int32_t)RIPPLE_EVAL_TARGET
+                            : 0;
+}
+
+int HostSim_RippleEval(void) {
+  const uint32_t count = sizeof(s_cases) / sizeof(s_cases[0]);
+  RippleEvalResult_t results[sizeof(s_cases) / sizeof(s_cases[0])];
+  bool pass = true;
+
+  if (!check_filters()) {
+    return EXIT_FAILURE;
+  }
+  /* The run-on and every time constant of the counter scale with the
+     sample period it is told */
+  const double period_error_pct =
+      100.0 * fabs((double)SENSOR_TASK_MOTOR_SEQUENCE_US -
+                   RIPPLE_EVAL_SEQUENCE_US) /
+      RIPPLE_EVAL_SEQUENCE_US;
+  if (period_error_pct > RIPPLE_EVAL_MAX_PERIOD_ERROR_PCT) {
+    printf("SENSOR_TASK_MOTOR_SEQUENCE_US is %u us, the ADC takes %.1f us "
+           "a sequence\n",
+           (unsigned)SENSOR_TASK_MOTOR_SEQUENCE_US, RIPPLE_EVAL_SEQUENCE_US);
+    return EXIT_FAILURE;
+  }
+
+  /* Open loop: the drive time that moves the target at nominal voltage
+     and load, as a factory calibration would find it */
+  const RippleEvalCase_t nominal = {"nominal", RIPPLE_EVAL_NOMINAL_V,
+                                    RIPPLE_EVAL_NOMINAL_LOAD_MA, 0U, false};
+  RippleEvalRun_t calibration;
+  simulate(&nominal, 1U, 0.0, &calibration);
+  const double timed_us =
+      calibration.brake_us *
+      ((double)RIPPLE_EVAL_TARGET / (double)calibration.turned);
+
+  for (uint32_t i = 0U; i < count; i++) {
+    evaluate(&s_cases[i], timed_us, &results[i]);
+  }
+
+  printf("Ripple evaluation: sample every %u us, band-pass %u Hz Q %u.%02u "
+         "then Q %u.%02u tracking, %u seeds, target %u ripples, seat at %u, "
+         "timed move %.0f ms\n",
+         (unsigned)SENSOR_TASK_MOTOR_SEQUENCE_US,
+         (unsigned)RIPPLE_COUNTER_CENTER_HZ,
+         (unsigned)(RIPPLE_COUNTER_Q_X100 / 100U),
+         (unsigned)(RIPPLE_COUNTER_Q_X100 % 100U),
+         (unsigned)(RIPPLE_COUNTER_TRACK_Q_X100 / 100U),
+         (unsigned)(RIPPLE_COUNTER_TRACK_Q_X100 % 100U),
+         (unsigned)RIPPLE_EVAL_SEEDS, (unsigned)RIPPLE_EVAL_TARGET, (unsigned)RIPPLE_EVAL_SEAT,
+         timed_us / 1000.0);
+  printf("Case          ripple Hz  count  move  timed\n");
+  for (uint32_t i = 0U; i < count; i++) {
+    const RippleEvalResult_t *r = &results[i];
+    const bool seat = s_cases[i].seat != 0U;
+    const bool ok = abs(r->count_error) <= RIPPLE_EVAL_MAX_ERROR &&
+                    abs(r->move_error) <= RIPPLE_EVAL_MAX_ERROR &&
+                    (!seat || r->stalled);
+    pass = pass && ok;
+    if (seat) {
+      printf("%-13s %9.0f %6ld  %-11s%s\n", s_cases[i].name, r->ripple_hz,
+             (long)r->count_error, r->stalled ? "stall" : "no stall",
+             ok ? "" : "  FAIL");
+    } else {
+      printf("%-13s %9.0f %6ld %5ld %6ld%s\n", s_cases[i].name, r->ripple_hz,
+             (long)r->count_error, (long)r->move_error, (long)r->timed_error,
+             ok ? "" : "  FAIL");
+    }
+  }
+  for (uint32_t i = 0U; i < count; i++) {
+    const RippleEvalResult_t *r = &results[i];
+    printf("RIPPLE {\"case\":\"%s\",\"volts\":%.1f,\"load_ma\":%.0f,"
+           "\"ripple_hz\":%.0f,\"count_error\":%ld,\"move_error\":%ld,"
+           "\"timed_error\":%ld,\"stall\":%s}\n",
+           s_cases[i].name, s_cases[i].volts, s_cases[i].load_ma,
+           r->ripple_hz, (long)r->count_error, (long)r->move_error,
+           (long)r->timed_error, r->stalled ? "true" : "false");
+  }
+
+  return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int HostSim_RippleTrace(const char *trace_path) {
+  FILE *file = fopen(trace_path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "[host] cannot open trace %s\n", trace_path);
+    return EXIT_FAILURE;
+  }
+
+  double *t_us = malloc(RIPPLE_EVAL_TRACE_MAX_POINTS * sizeof(double));
+  double *ma = malloc(RIPPLE_EVAL_TRACE_MAX_POINTS * sizeof(double));
+  uint32_t points = 0U;
+  long reference = -1;
+  char line[128];
+  while (t_us != NULL && ma != NULL && points < RIPPLE_EVAL_TRACE_MAX_POINTS &&
+         fgets(line, sizeof(line), file) != NULL) {
+    long ripples;
+    if (sscanf(line, " # ripples %ld", &ripples) == 1) {
+      reference = ripples;
+    } else if (line[0] != '#' &&
+               sscanf(line, "%lf%*[ ,\t]%lf", &t_us[points], &ma[points]) ==
+                   2 &&
+               (points == 0U || t_us[points] > t_us[points - 1U])) {
+      points++;
+    }
+  }
+  fclose(file);
+  if (points < 2U) {
+    fprintf(stderr, "[host] %s holds fewer than 2 current samples\n",
+            trace_path);
+    free(t_us);
+    free(ma);
+    return EXIT_FAILURE;
+  }
+
+  /* The DMA interrupt's view: the current every sequence */
+  RippleCounter_t counter;
+  RippleCounter_Init(&counter, SENSOR_TASK_MOTOR_SEQUENCE_US);
+  RippleCounter_Start(&counter, 1, 0U);
+  uint32_t samples = 0U;
+  uint32_t index = 0U;
+  for (double t = t_us[0]; t <= t_us[points - 1U];
+       t += RIPPLE_EVAL_SEQUENCE_US) {
+    while (t_us[index + 1U] < t) {
+      index++;
+    }
+    const double span = t_us[index + 1U] - t_us[index];
+    const double current_ma =
+        ma[index] + (ma[index + 1U] - ma[index]) * (t - t_us[index]) / span;
+    (void)RippleCounter_Update(&counter, (current_ma > 0.0)
+                                             ? (uint32_t)(current_ma + 0.5)
+                                             : 0U);
+    samples++;
+  }
+  const int32_t counted = RippleCounter_GetPosition(&counter);
+  const uint32_t run_on = RippleCounter_RunOn(&counter, RIPPLE_COUNTER_BRAKE_US);
+  free(t_us);
+  free(ma);
+
+  const bool ok = reference < 0 ||
+                  labs((long)counted - reference) <= RIPPLE_EVAL_MAX_ERROR;
+  printf("Ripple trace %s: %lu points, %lu samples of %u us, %ld ripples "
+         "(+%lu if braked at the end)",
+         trace_path, (unsigned long)points, (unsigned long)samples,
+         (unsigned)SENSOR_TASK_MOTOR_SEQUENCE_US, (long)counted,
+         (unsigned long)run_on);
+  if (reference >= 0) {
+    printf(", reference %ld%s", reference, ok ? "" : "  FAIL");
+  }
+  printf("\nRIPPLE_TRACE {\"trace\":\"%s\",\"samples\":%lu,\"counted\":%ld,"
+         "\"run_on\":%lu,\"reference\":%ld}\n",
+         trace_path, (unsigned long)samples, (long)counted,
+         (unsigned long)run_on, reference);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
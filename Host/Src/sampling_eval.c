@@ -0,0 +1,321 @@
+/**
+ ******************************************************************************
+ * @file           :  sampling_eval.c
+ * @brief          :  Offline evaluation of the adaptive temperature sampling
+ *                    on a simulated day (--sampling-eval).
+ *
+ * @details        :  Plays a 24 h room temperature profile (night setback,
+ *                    morning heat-up, an open window, afternoon sun, evening
+ *                    setback, a few user interactions) through the ADC
+ *                    conversion, the temperature filter and the sampling
+ *                    policy the sensor task uses, and compares it with the
+ *                    fixed TEMPERATURE_AND_BAT_MEAS_PERIOD_MS period:
+ *                      wakeups  sensor task wakeups per day
+ *                      adc      ADC sequences converted per day, with
+ *                               conversions triggered per measurement
+ *                      max      largest change of the room temperature
+ *                               between two measurements, in cdeg
+ *                      missed   intervals in which it exceeded the
+ *                               threshold (SensorSampling_ThresholdCdeg())
+ *                      notified reads of the sensor model by the home
+ *                               screen, woken with its thresholds
+ *                               (SensorTask_Subscribe()); polling read it
+ *                               on every view tick
+ *                      renders  HomeView_Render() calls, each taking the
+ *                               display lock; polling rendered on every
+ *                               view tick, the notified presenter only
+ *                               when the screen data changed
+ *                      labels   temperature label updates, each an LVGL
+ *                               invalidation and redraw, polled (the
+ *                               model read on every tick sees every
+ *                               published change of the 0.1 degC shown)
+ *                               and notified
+ *                    followed by one "SAMPLING {...}" JSON line per policy.
+ *                    No scheduler is started.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "home_presenter.h"
+#include "sensor_calc.h"
+#include "sensor_filter.h"
+#include "sensor_sampling.h"
+#include "sensor_task.h"
+#include "stm32wbxx_ll_adc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SAMPLING_EVAL_DAY_S 86400U
+#define SAMPLING_EVAL_VDDA_MV 3000U
+#define SAMPLING_EVAL_SOC 80U
+#define SAMPLING_EVAL_LOW_SOC 15U
+/* One view presenter loop: VIEW_DELAY_MS queue wait and a 5 ms delay */
+#define SAMPLING_EVAL_VIEW_TICK_MS 15U
+
+typedef enum {
+  SAMPLING_EVAL_FIXED = 0,
+  SAMPLING_EVAL_ADAPTIVE,
+} SamplingEvalPolicy_t;
+
+typedef struct {
+  uint32_t wakeups;
+  uint32_t max_unseen_cdeg;
+  uint32_t missed;
+  uint32_t notifications;
+  uint32_t renders;
+  uint32_t polled_labels;
+} SamplingEvalResult_t;
+
+/* User interactions, seconds of the day */
+static const uint32_t s_user_inputs_s[] = {
+    6U * 3600U + 50U * 60U, 6U * 3600U + 51U * 60U, 12U * 3600U,
+    18U * 3600U + 30U * 60U, 18U * 3600U + 31U * 60U, 21U * 3600U,
+};
+
+#define SAMPLING_EVAL_INPUT_COUNT \
+  (sizeof(s_user_inputs_s) / sizeof(s_user_inputs_s[0]))
+
+static int32_t lerp(int32_t from, int32_t to, uint32_t t, uint32_t t0,
+                    uint32_t t1) {
+  return from + (int32_t)(((int64_t)(to - from) * (t - t0)) / (t1 - t0));
+}
+
+/* Room temperature in centidegrees at second @p t of the day */
+static int32_t room_cdeg(uint32_t t) {
+  const uint32_t h = 3600U;
+  if (t < 6U * h) {
+    return lerp(1900, 1750, t, 0U, 6U * h); /* night setback, cooling */
+  }
+  if (t < 6U * h + 45U * 60U) {
+    return lerp(1750, 2100, t, 6U * h, 6U * h + 45U * 60U); /* heat-up */
+  }
+  if (t < 8U * h) {
+    /* Controller ripple: +-0.2 degC triangle with a 20 minute period */
+    const uint32_t phase = (t - (6U * h + 45U * 60U)) % 1200U;
+    return 2100 + ((phase < 600U) ? lerp(-20, 20, phase, 0U, 600U)
+                                  : lerp(20, -20, phase, 600U, 1200U));
+  }
+  if (t < 8U * h + 10U * 60U) {
+    return lerp(2100, 1950, t, 8U * h, 8U * h + 10U * 60U); /* window */
+  }
+  if (t < 8U * h + 40U * 60U) {
+    return lerp(1950, 2100, t, 8U * h + 10U * 60U, 8U * h + 40U * 60U);
+  }
+  if (t < 14U * h) {
+    return 2100;
+  }
+  if (t < 16U * h) {
+    return lerp(2100, 2200, t, 14U * h, 16U * h); /* afternoon sun */
+  }
+  if (t < 18U * h) {
+    return lerp(2200, 2100, t, 16U * h, 18U * h);
+  }
+  if (t < 22U * h) {
+    return 2100;
+  }
+  return lerp(2100, 1900, t, 22U * h, 24U * h); /* evening setback */
+}
+
+static int32_t setpoint_cdeg(uint32_t t) {
+  return (t >= 6U * 3600U && t < 22U * 3600U) ? 2100 : 1700;
+}
+
+/* What the sensor task would compute from one ADC sequence at second t:
+   the die temperature is quantised by the 12-bit conversion and dithered
+   by a deterministic +-1 LSB of noise */
+static int32_t measure_cdeg(uint32_t t, uint32_t *noise_state) {
+  const int32_t ts_cal1 = (int32_t)*TEMPSENSOR_CAL1_ADDR;
+  const int32_t ts_cal2 = (int32_t)*TEMPSENSOR_CAL2_ADDR;
+  const int32_t cal_span =
+      (int32_t)(TEMPSENSOR_CAL2_TEMP - TEMPSENSOR_CAL1_TEMP) * 100;
+  const int32_t scaled =
+      ts_cal1 + ((room_cdeg(t) - (int32_t)TEMPSENSOR_CAL1_TEMP * 100) *
+                 (ts_cal2 - ts_cal1)) /
+                    cal_span;
+  *noise_state = *noise_state * 1103515245U + 12345U;
+  const int32_t noise = (int32_t)((*noise_state >> 16) % 3U) - 1;
+  const int32_t raw = (scaled * (int32_t)TEMPSENSOR_CAL_VREFANALOG) /
+                          (int32_t)SAMPLING_EVAL_VDDA_MV +
+                      noise;
+  return SensorCalc_TemperatureCenti((uint16_t)raw, SAMPLING_EVAL_VDDA_MV);
+}
+
+static bool user_active(uint32_t t) {
+  for (uint32_t i = 0U; i < SAMPLING_EVAL_INPUT_COUNT; i++) {
+    if (t >= s_user_inputs_s[i] &&
+        t - s_user_inputs_s[i] < SENSOR_SAMPLING_ACTIVE_MS / 1000U) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Whether a user input wakes the sensor task in (from, to] */
+static bool user_input_between(uint32_t from, uint32_t to, uint32_t *at) {
+  for (uint32_t i = 0U; i < SAMPLING_EVAL_INPUT_COUNT; i++) {
+    if (s_user_inputs_s[i] > from && s_user_inputs_s[i] <= to) {
+      *at = s_user_inputs_s[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+static void run(SamplingEvalPolicy_t policy, uint8_t soc,
+                SamplingEvalResult_t *result) {
+  SensorFilter_t filter;
+  SensorSampling_t sampling;
+  SensorFilter_Init(&filter, NULL);
+  SensorSampling_Init(&sampling);
+
+  const SensorThresholds_t home_thresholds = {
+      .temperature_cdeg = HOME_PRESENTER_TEMPERATURE_STEP_CDEG,
+      .soc = HOME_PRESENTER_SOC_STEP,
+      .battery_days = HOME_PRESENTER_BATTERY_DAYS_STEP,
+  };
+  SensorData_t published = {.soc = soc};
+  SensorData_t notified = published;
+
+  uint32_t noise_state = 1U;
+  uint32_t t_ms = 0U;
+  uint32_t last_ms = 0U;
+  int32_t shown = 0;
+  int32_t polled_shown = 0;
+  result->wakeups = 0U;
+  result->max_unseen_cdeg = 0U;
+  result->missed = 0U;
+  result->notifications = 0U;
+  result->renders = 0U;
+  result->polled_labels = 0U;
+
+  while (t_ms < SAMPLING_EVAL_DAY_S * 1000U) {
+    const uint32_t t = t_ms / 1000U;
+    const int32_t filtered = SensorFilter_Update(
+        &filter, measure_cdeg(t, &noise_state), t_ms - last_ms);
+    result->wakeups++;
+    last_ms = t_ms;
+
+    /* The first publication always notifies */
+    published.ambient_temperature_cdeg = (int16_t)filtered;
+    if (result->wakeups == 1U ||
+        published.ambient_temperature_cdeg / 10 != polled_shown) {
+      polled_shown = published.ambient_temperature_cdeg / 10;
+      result->polled_labels++;
+    }
+    if (result->notifications == 0U ||
+        SensorTask_ExceedsThresholds(&home_thresholds, &notified,
+                                     &published)) {
+      notified = published;
+      result->notifications++;
+      if (result->renders == 0U ||
+          notified.ambient_temperature_cdeg / 10 != shown) {
+        shown = notified.ambient_temperature_cdeg / 10;
+        result->renders++;
+      }
+    }
+
+    uint32_t period_ms = TEMPERATURE_AND_BAT_MEAS_PERIOD_MS;
+    if (policy == SAMPLING_EVAL_ADAPTIVE) {
+      const SensorSamplingInput_t input = {
+          .temperature_cdeg = filtered,
+          .setpoint_cdeg = setpoint_cdeg(t),
+          .soc = soc,
+          .user_active = user_active(t),
+      };
+      period_ms = SensorSampling_Update(&sampling, &input, t_ms);
+    }
+
+    /* A user input wakes the task early, as SensorTask_NotifyUserActivity()
+       does on target */
+    uint32_t next_s = (t_ms + period_ms) / 1000U;
+    uint32_t input_s;
+    if (policy == SAMPLING_EVAL_ADAPTIVE &&
+        user_input_between(t, next_s, &input_s)) {
+      next_s = input_s;
+    }
+
+    /* Largest move of the room temperature before the next measurement */
+    const int32_t seen = room_cdeg(t);
+    uint32_t unseen = 0U;
+    for (uint32_t s = t + 1U; s < next_s && s < SAMPLING_EVAL_DAY_S; s++) {
+      const uint32_t change = (uint32_t)abs(room_cdeg(s) - seen);
+      if (change > unseen) {
+        unseen = change;
+      }
+    }
+    if (unseen > result->max_unseen_cdeg) {
+      result->max_unseen_cdeg = unseen;
+    }
+    if (unseen > ((policy == SAMPLING_EVAL_ADAPTIVE)
+                      ? SensorSampling_ThresholdCdeg(soc)
+                      : SENSOR_SAMPLING_THRESHOLD_CDEG)) {
+      result->missed++;
+    }
+    t_ms = (next_s * 1000U > t_ms) ? next_s * 1000U : t_ms + period_ms;
+  }
+}
+
+int HostSim_SamplingEval(void) {
+  static const struct {
+    const char *name;
+    SamplingEvalPolicy_t policy;
+    uint8_t soc;
+  } runs[] = {
+      {"fixed", SAMPLING_EVAL_FIXED, SAMPLING_EVAL_SOC},
+      {"adaptive", SAMPLING_EVAL_ADAPTIVE, SAMPLING_EVAL_SOC},
+      {"adaptive_low_soc", SAMPLING_EVAL_ADAPTIVE, SAMPLING_EVAL_LOW_SOC},
+  };
+  SamplingEvalResult_t results[sizeof(runs) / sizeof(runs[0])];
+  const uint32_t count = sizeof(runs) / sizeof(runs[0]);
+
+  for (uint32_t i = 0U; i < count; i++) {
+    run(runs[i].policy, runs[i].soc, &results[i]);
+  }
+
+  const uint32_t polled =
+      (SAMPLING_EVAL_DAY_S * 1000U) / SAMPLING_EVAL_VIEW_TICK_MS;
+  printf("Sampling evaluation: simulated day, threshold %u cdeg, "
+         "home screen polling %lu reads and renders\n",
+         (unsigned)SENSOR_SAMPLING_THRESHOLD_CDEG, (unsigned long)polled);
+  printf("Policy            wakeups     adc  max cdeg  missed  notified  "
+         "renders  labels polled/notified\n");
+  for (uint32_t i = 0U; i < count; i++) {
+    printf("%-16s %8lu %7lu %9lu %7lu %9lu %8lu %8lu/%lu\n", runs[i].name,
+           (unsigned long)results[i].wakeups,
+           (unsigned long)results[i].wakeups,
+           (unsigned long)results[i].max_unseen_cdeg,
+           (unsigned long)results[i].missed,
+           (unsigned long)results[i].notifications,
+           (unsigned long)results[i].renders,
+           (unsigned long)results[i].polled_labels,
+           (unsigned long)results[i].renders);
+  }
+  for (uint32_t i = 0U; i < count; i++) {
+    const SamplingEvalResult_t *r = &results[i];
+    printf("SAMPLING {\"policy\":\"%s\",\"soc\":%u,\"wakeups\":%lu,"
+           "\"adc_sequences\":%lu,\"reduction_pct\":%.1f,"
+           "\"max_unseen_cdeg\":%lu,\"missed\":%lu,"
+           "\"home_reads_polled\":%lu,\"home_reads_notified\":%lu,"
+           "\"home_renders_polled\":%lu,\"home_renders\":%lu,"
+           "\"home_labels_polled\":%lu,\"home_labels_notified\":%lu}\n",
+           runs[i].name, runs[i].soc, (unsigned long)r->wakeups,
+           (unsigned long)r->wakeups,
+           100.0 * (1.0 - (double)r->wakeups / (double)results[0].wakeups),
+           (unsigned long)r->max_unseen_cdeg, (unsigned long)r->missed,
+           (unsigned long)polled, (unsigned long)r->notifications,
+           (unsigned long)polled, (unsigned long)r->renders,
+           (unsigned long)r->polled_labels, (unsigned long)r->renders);
+  }
+
+  /* The adaptive policy must not let a larger change pass unseen */
+  return (results[1].missed == 0U && results[2].missed == 0U) ? EXIT_SUCCESS
+                                                              : EXIT_FAILURE;
+}
@@ -0,0 +1,545 @@
+/**
+ ******************************************************************************
+ * @file           :  self_heating_eval.c
+ * @brief          :  Fit and evaluation of the self-heating compensation
+ *                    (--self-heating-fit, --self-heating-eval).
+ *
+ * @details        :  The fit pairs every activity record of a replay trace
+ *                    with the ADC sequence the temperature was converted
+ *                    from. Without a reference thermometer the room is only
+ *                    assumed to change slowly: the temperatures and the
+ *                    lagged activity of each source are detrended by a
+ *                    centred moving average over
+ *                    SELF_HEATING_EVAL_WINDOW_S, and the coefficients are
+ *                    fitted by non-negative least squares to what is left,
+ *                    for each thermal time constant of a grid. The constant
+ *                    part of the rise cannot be told from the room and stays
+ *                    with the manual temperature offset. It reports:
+ *                      residual  RMS of the detrended compensated
+ *                                temperature, in cdeg
+ *                    for no compensation, the defaults and the fit (run
+ *                    through the integer SelfHeating_Update()), the -D
+ *                    options that build the fit in, and one
+ *                    "SELF_HEATING {...}" JSON line per configuration.
+ *
+ *                    --self-heating-eval does the same on two synthetic days
+ *                    with a heating schedule, user sessions and valve runs,
+ *                    a known room temperature and self-heating model and
+ *                    deterministic sensor noise. It also reports the RMS
+ *                    error of the estimated rise against the true one
+ *                    (after removing the mean, which the offset calibrates)
+ *                    and fails unless the fit halves the error of the
+ *                    uncompensated reading. No scheduler is started.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "replay.h"
+#include "self_heating.h"
+#include "sensor_calc.h"
+
+#include "FreeRTOS.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SELF_HEATING_EVAL_MAX_SAMPLES 100000U
+/* Room changes slower than this window are removed before the fit */
+#define SELF_HEATING_EVAL_WINDOW_S 7200U
+/* Below this variance a source is treated as never active */
+#define SELF_HEATING_EVAL_MIN_VARIANCE 1e-8
+
+/* Synthetic trace */
+#define SELF_HEATING_EVAL_DAYS 2U
+#define SELF_HEATING_EVAL_PERIOD_MS 30000U
+#define SELF_HEATING_EVAL_NOISE_CDEG 15
+#define SELF_HEATING_EVAL_SESSIONS_PER_DAY 10U
+#define SELF_HEATING_EVAL_RUNS_PER_DAY 12U
+#define SELF_HEATING_EVAL_RUN_MS 40000U
+#define SELF_HEATING_EVAL_RUN_MA 90U
+#define SELF_HEATING_EVAL_MAX_RATIO 0.5
+
+#define SELF_HEATING_EVAL_MS_PER_DAY 86400000U
+
+static const uint16_t s_taus[] = {60U,   120U,  300U,  600U, 900U,
+                                  1200U, 1800U, 2700U, 3600U};
+
+/* Model the synthetic board follows */
+static const SelfHeatingParams_t s_true_params = {
+    .tau_s = 900U, .cpu_cdeg = 150, .display_cdeg = 60, .motor_cdeg = 200};
+
+typedef struct {
+  uint32_t t_ms;
+  int32_t measured_cdeg;
+  double rise_cdeg; /**< True rise, synthetic trace only */
+  SelfHeatingActivity_t activity;
+} SelfHeatingSample_t;
+
+typedef struct {
+  const char *name;
+  SelfHeatingParams_t params;
+  double residual_cdeg;
+  double rise_err_cdeg;
+} SelfHeatingEvalResult_t;
+
+static SelfHeatingSample_t s_samples[SELF_HEATING_EVAL_MAX_SAMPLES];
+static double s_y[SELF_HEATING_EVAL_MAX_SAMPLES];
+static double s_x[SELF_HEATING_SOURCE_COUNT][SELF_HEATING_EVAL_MAX_SAMPLES];
+static double s_prefix[SELF_HEATING_EVAL_MAX_SAMPLES + 1U];
+static double s_work[SELF_HEATING_EVAL_MAX_SAMPLES];
+
+/* Each activity record with the latest ADC sequence at or before it: the
+   sensor task records both in the iteration that converts a temperature */
+static uint32_t collect_samples(void) {
+  uint16_t adc[REPLAY_ADC_CHANNELS];
+  uint16_t next_adc[REPLAY_ADC_CHANNELS];
+  uint32_t next_tick = 0U;
+  bool have_adc = false;
+  bool have_next = Replay_ScanAdc(&next_tick, next_adc);
+  SelfHeatingActivity_t activity;
+  uint32_t tick;
+  uint32_t count = 0U;
+
+  while (count < SELF_HEATING_EVAL_MAX_SAMPLES &&
+         Replay_ScanActivity(&tick, &activity)) {
+    while (have_next && next_tick <= tick) {
+      memcpy(adc, next_adc, sizeof(adc));
+      have_adc = true;
+      have_next = Replay_ScanAdc(&next_tick, next_adc);
+    }
+    if (!have_adc)
+      continue;
+    const uint32_t vref_mv = SensorCalc_VrefVoltage(adc[0]);
+    s_samples[count].t_ms =
+        (uint32_t)(((uint64_t)tick * 1000U) / configTICK_RATE_HZ);
+    s_samples[count].measured_cdeg =
+        SensorCalc_TemperatureCenti(adc[2], vref_mv);
+    s_samples[count].rise_cdeg = 0.0;
+    s_samples[count].activity = activity;
+    count++;
+  }
+  return count;
+}
+
+/* Subtract the centred moving average over SELF_HEATING_EVAL_WINDOW_S */
+static void detrend(double *values, uint32_t count) {
+  const uint32_t half_ms = SELF_HEATING_EVAL_WINDOW_S * 500U;
+  uint32_t first = 0U;
+  uint32_t last = 0U;
+
+  s_prefix[0] = 0.0;
+  for (uint32_t i = 0U; i < count; i++) {
+    s_prefix[i + 1U] = s_prefix[i] + values[i];
+  }
+  for (uint32_t i = 0U; i < count; i++) {
+    const uint32_t t = s_samples[i].t_ms;
+    while (s_samples[first].t_ms + half_ms < t)
+      first++;
+    while (last + 1U < count && s_samples[last + 1U].t_ms <= t + half_ms)
+      last++;
+    s_work[i] = values[i] - (s_prefix[last + 1U] - s_prefix[first]) /
+                                (double)(last + 1U - first);
+  }
+  memcpy(values, s_work, count * sizeof(double));
+}
+
+/* Lagged activity of each source for one time constant, discretised like
+   SelfHeating_Update(), detrended */
+static void build_features(uint16_t tau_s, uint32_t count) {
+  double lag[SELF_HEATING_SOURCE_COUNT] = {0.0};
+  const double tau_ms = (double)tau_s * 1000.0;
+
+  for (uint32_t i = 0U; i < count; i++) {
+    const SelfHeatingActivity_t *a = &s_samples[i].activity;
+    const double alpha = (double)a->period_ms / (tau_ms + a->period_ms);
+    for (uint32_t k = 0U; k < SELF_HEATING_SOURCE_COUNT; k++) {
+      const double target =
+          (double)SelfHeating_ActivityQ16(a, (SelfHeatingSource_t)k) /
+          65536.0;
+      lag[k] += (target - lag[k]) * alpha;
+      s_x[k][i] = lag[k];
+    }
+  }
+  for (uint32_t k = 0U; k < SELF_HEATING_SOURCE_COUNT; k++) {
+    detrend(s_x[k], count);
+  }
+}
+
+/* Least squares over the active sources; false if singular */
+static bool solve(const bool active[SELF_HEATING_SOURCE_COUNT],
+                  uint32_t count, double coeff[SELF_HEATING_SOURCE_COUNT]) {
+  enum { N = SELF_HEATING_SOURCE_COUNT };
+  uint32_t map[N];
+  uint32_t n = 0U;
+  double a[N][N + 1U];
+
+  for (uint32_t k = 0U; k < N; k++) {
+    coeff[k] = 0.0;
+    if (active[k])
+      map[n++] = k;
+  }
+  for (uint32_t r = 0U; r < n; r++) {
+    for (uint32_t c = 0U; c < n; c++) {
+      double sum = 0.0;
+      for (uint32_t i = 0U; i < count; i++)
+        sum += s_x[map[r]][i] * s_x[map[c]][i];
+      a[r][c] = sum;
+    }
+    double sum = 0.0;
+    for (uint32_t i = 0U; i < count; i++)
+      sum += s_x[map[r]][i] * s_y[i];
+    a[r][n] = sum;
+  }
+
+  /* Gaussian elimination with partial pivoting */
+  for (uint32_t c = 0U; c < n; c++) {
+    uint32_t pivot = c;
+    for (uint32_t r = c + 1U; r < n; r++) {
+      if (fabs(a[r][c]) > fabs(a[pivot][c]))
+        pivot = r;
+    }
+    if (fabs(a[pivot][c]) < SELF_HEATING_EVAL_MIN_VARIANCE)
+      return false;
+    for (uint32_t j = 0U; j <= n; j++) {
+      const double tmp = a[c][j];
+      a[c][j] = a[pivot][j];
+      a[pivot][j] = tmp;
+    }
+    for (uint32_t r = 0U; r < n; r++) {
+      if (r == c)
+        continue;
+      const double f = a[r][c] / a[c][c];
+      for (uint32_t j = c; j <= n; j++)
+        a[r][j] -= f * a[c][j];
+    }
+  }
+  for (uint32_t r = 0U; r < n; r++) {
+    coeff[map[r]] = a[r][n] / a[r][r];
+  }
+  return true;
+}
+
+/* Non-negative fit of the detrended temperatures for one time constant;
+   returns the RMS residual */
+static double fit_tau(uint16_t tau_s, uint32_t count,
+                      double coeff[SELF_HEATING_SOURCE_COUNT]) {
+  bool active[SELF_HEATING_SOURCE_COUNT];
+
+  build_features(tau_s, count);
+  for (uint32_t k = 0U; k < SELF_HEATING_SOURCE_COUNT; k++) {
+    double variance = 0.0;
+    for (uint32_t i = 0U; i < count; i++)
+      variance += s_x[k][i] * s_x[k][i];
+    active[k] = variance / (double)count > SELF_HEATING_EVAL_MIN_VARIANCE;
+  }
+
+  /* A source that would cool the sensor is dropped and the rest refitted */
+  for (uint32_t round = 0U; round < SELF_HEATING_SOURCE_COUNT; round++) {
+    if (!solve(active, count, coeff)) {
+      for (uint32_t k = 0U; k < SELF_HEATING_SOURCE_COUNT; k++)
+        coeff[k] = 0.0;
+      break;
+    }
+    uint32_t worst = SELF_HEATING_SOURCE_COUNT;
+    for (uint32_t k = 0U; k < SELF_HEATING_SOURCE_COUNT; k++) {
+      if (active[k] && coeff[k] < 0.0 &&
+          (worst == SELF_HEATING_SOURCE_COUNT || coeff[k] < coeff[worst]))
+        worst = k;
+    }
+    if (worst == SELF_HEATING_SOURCE_COUNT)
+      break;
+    active[worst] = false;
+    coeff[worst] = 0.0;
+  }
+
+  double sum_sq = 0.0;
+  for (uint32_t i = 0U; i < count; i++) {
+    double residual = s_y[i];
+    for (uint32_t k = 0U; k < SELF_HEATING_SOURCE_COUNT; k++)
+      residual -= coeff[k] * s_x[k][i];
+    sum_sq += residual * residual;
+  }
+  return sqrt(sum_sq / (double)count);
+}
+
+static int16_t to_cdeg(double coeff) {
+  if (coeff > INT16_MAX)
+    return INT16_MAX;
+  return (int16_t)lround(coeff);
+}
+
+/* Best time constant of the grid and its coefficients */
+static void fit(uint32_t count, SelfHeatingParams_t *params) {
+  double best_residual = INFINITY;
+
+  for (uint32_t i = 0U; i < count; i++)
+    s_y[i] = (double)s_samples[i].measured_cdeg;
+  detrend(s_y, count);
+
+  printf("tau_s    cpu  display  motor  residual cdeg\n");
+  for (uint32_t t = 0U; t < sizeof(s_taus) / sizeof(s_taus[0]); t++) {
+    double coeff[SELF_HEATING_SOURCE_COUNT];
+    const double residual = fit_tau(s_taus[t], count, coeff);
+    printf("%5u %6.1f %8.1f %6.1f %14.2f\n", s_taus[t],
+           coeff[SELF_HEATING_CPU], coeff[SELF_HEATING_DISPLAY],
+           coeff[SELF_HEATING_MOTOR], residual);
+    if (residual < best_residual) {
+      best_residual = residual;
+      params->tau_s = s_taus[t];
+      params->cpu_cdeg = to_cdeg(coeff[SELF_HEATING_CPU]);
+      params->display_cdeg = to_cdeg(coeff[SELF_HEATING_DISPLAY]);
+      params->motor_cdeg = to_cdeg(coeff[SELF_HEATING_MOTOR]);
+    }
+  }
+}
+
+/* Run the firmware model over the samples */
+static void evaluate(SelfHeatingEvalResult_t *result, uint32_t count,
+                     bool rise_known) {
+  SelfHeating_t model;
+  SelfHeating_Init(&model, &result->params);
+
+  double mean_err = 0.0;
+  for (uint32_t i = 0U; i < count; i++) {
+    const int32_t rise =
+        SelfHeating_Update(&model, &s_samples[i].activity);
+    s_y[i] = (double)(s_samples[i].measured_cdeg - rise);
+    s_work[i] = s_samples[i].rise_cdeg - (double)rise;
+    mean_err += s_work[i];
+  }
+  mean_err /= (double)count;
+
+  double rise_sq = 0.0;
+  for (uint32_t i = 0U; i < count; i++) {
+    const double err = s_work[i] - mean_err;
+    rise_sq += err * err;
+  }
+  result->rise_err_cdeg = rise_known ? sqrt(rise_sq / (double)count) : 0.0;
+
+  detrend(s_y, count);
+  double sum_sq = 0.0;
+  for (uint32_t i = 0U; i < count; i++)
+    sum_sq += s_y[i] * s_y[i];
+  result->residual_cdeg = sqrt(sum_sq / (double)count);
+}
+
+static void report(SelfHeatingEvalResult_t *results, uint32_t result_count,
+                   uint32_t count, bool rise_known) {
+  printf("Config     tau_s    cpu  display  motor  residual cdeg%s\n",
+         rise_known ? "  rise err cdeg" : "");
+  for (uint32_t r = 0U; r < result_count; r++) {
+    const SelfHeatingEvalResult_t *res = &results[r];
+    printf("%-10s %5u %6d %8d %6d %14.2f", res->name, res->params.tau_s,
+           res->params.cpu_cdeg, res->params.display_cdeg,
+           res->params.motor_cdeg, res->residual_cdeg);
+    if (rise_known)
+      printf(" %14.2f", res->rise_err_cdeg);
+    printf("\n");
+  }
+
+  const SelfHeatingParams_t *fitted = &results[result_count - 1U].params;
+  printf("Build with -DSELF_HEATING_DEFAULT_TAU_S=%uU "
+         "-DSELF_HEATING_DEFAULT_CPU_CDEG=%d "
+         "-DSELF_HEATING_DEFAULT_DISPLAY_CDEG=%d "
+         "-DSELF_HEATING_DEFAULT_MOTOR_CDEG=%d\n",
+         fitted->tau_s, fitted->cpu_cdeg, fitted->display_cdeg,
+         fitted->motor_cdeg);
+
+  for (uint32_t r = 0U; r < result_count; r++) {
+    const SelfHeatingEvalResult_t *res = &results[r];
+    printf("SELF_HEATING {\"config\":\"%s\",\"samples\":%lu,\"tau_s\":%u,"
+           "\"cpu_cdeg\":%d,\"display_cdeg\":%d,\"motor_cdeg\":%d,"
+           "\"residual_cdeg\":%.2f",
+           res->name, (unsigned long)count, res->params.tau_s,
+           res->params.cpu_cdeg, res->params.display_cdeg,
+           res->params.motor_cdeg, res->residual_cdeg);
+    if (rise_known)
+      printf(",\"rise_err_cdeg\":%.2f", res->rise_err_cdeg);
+    printf("}\n");
+  }
+}
+
+/* No compensation, the defaults and the fit, in that order */
+static void run(SelfHeatingEvalResult_t results[3], uint32_t count,
+                bool rise_known) {
+  results[0].name = "none";
+  memset(&results[0].params, 0, sizeof(results[0].params));
+  results[1].name = "default";
+  SelfHeating_DefaultParams(&results[1].params);
+  results[2].name = "fitted";
+  fit(count, &results[2].params);
+
+  for (uint32_t r = 0U; r < 3U; r++) {
+    evaluate(&results[r], count, rise_known);
+  }
+  report(results, 3U, count, rise_known);
+}
+
+int HostSim_SelfHeatingFit(const char *trace_path) {
+  uint8_t *trace = HostSim_LoadTrace(trace_path);
+  if (trace == NULL) {
+    fprintf(stderr, "[host] cannot load trace %s\n", trace_path);
+    return EXIT_FAILURE;
+  }
+
+  const uint32_t count = collect_samples();
+  if (count < 2U) {
+    fprintf(stderr, "[host] %s holds fewer than 2 activity records\n",
+            trace_path);
+    free(trace);
+    return EXIT_FAILURE;
+  }
+
+  printf("Self-heating fit: %lu samples over %lu s, detrended over %u s\n",
+         (unsigned long)count,
+         (unsigned long)((s_samples[count - 1U].t_ms - s_samples[0].t_ms) /
+                         1000U),
+         (unsigned)SELF_HEATING_EVAL_WINDOW_S);
+  SelfHeatingEvalResult_t results[3];
+  run(results, count, false);
+
+  free(trace);
+  return EXIT_SUCCESS;
+}
+
+/* Deterministic pseudo-random numbers */
+static uint32_t next_random(uint32_t *state) {
+  *state = *state * 1103515245U + 12345U;
+  return *state >> 16;
+}
+
+/* Room temperature: 21 degC from 06:00 to 22:00 and 17 degC at night,
+   approached with a time constant of 90 min, and a daily swing */
+static double room_target_cdeg(uint32_t t_ms) {
+  const uint32_t minute = (t_ms % SELF_HEATING_EVAL_MS_PER_DAY) / 60000U;
+  const double swing =
+      50.0 * sin(2.0 * M_PI * (double)t_ms / SELF_HEATING_EVAL_MS_PER_DAY);
+  return ((minute >= 360U && minute < 1320U) ? 2100.0 : 1700.0) + swing;
+}
+
+/* Synthetic samples: idle background, user sessions of 1 to 5 minutes with
+   CPU load and display traffic, valve runs at random times */
+static uint32_t synthesize(void) {
+  const uint32_t count = SELF_HEATING_EVAL_DAYS *
+                         (SELF_HEATING_EVAL_MS_PER_DAY /
+                          SELF_HEATING_EVAL_PERIOD_MS);
+  const uint32_t sessions =
+      SELF_HEATING_EVAL_DAYS * SELF_HEATING_EVAL_SESSIONS_PER_DAY;
+  const uint32_t runs = SELF_HEATING_EVAL_DAYS * SELF_HEATING_EVAL_RUNS_PER_DAY;
+  uint32_t session_start[SELF_HEATING_EVAL_DAYS *
+                         SELF_HEATING_EVAL_SESSIONS_PER_DAY];
+  uint32_t session_ms[SELF_HEATING_EVAL_DAYS *
+                      SELF_HEATING_EVAL_SESSIONS_PER_DAY];
+  uint32_t run_start[SELF_HEATING_EVAL_DAYS * SELF_HEATING_EVAL_RUNS_PER_DAY];
+  uint32_t state = 20251U;
+  const uint32_t span_ms = SELF_HEATING_EVAL_DAYS * SELF_HEATING_EVAL_MS_PER_DAY;
+
+  for (uint32_t s = 0U; s < sessions; s++) {
+    session_start[s] =
+        (uint32_t)(((uint64_t)next_random(&state) << 16 |
+                    next_random(&state)) %
+                   span_ms);
+    session_ms[s] = 60000U + (next_random(&state) % 5U) * 60000U;
+  }
+  for (uint32_t r = 0U; r < runs; r++) {
+    run_start[r] =
+        (uint32_t)(((uint64_t)next_random(&state) << 16 |
+                    next_random(&state)) %
+                   span_ms);
+  }
+
+  double room = room_target_cdeg(0U);
+  double lag[SELF_HEATING_SOURCE_COUNT] = {0.0};
+  const int16_t true_cdeg[SELF_HEATING_SOURCE_COUNT] = {
+      s_true_params.cpu_cdeg, s_true_params.display_cdeg,
+      s_true_params.motor_cdeg};
+
+  for (uint32_t i = 0U; i < count; i++) {
+    const uint32_t start = i * SELF_HEATING_EVAL_PERIOD_MS;
+    const uint32_t end = start + SELF_HEATING_EVAL_PERIOD_MS;
+    uint32_t session_overlap = 0U;
+    uint32_t run_overlap = 0U;
+
+    for (uint32_t s = 0U; s < sessions; s++) {
+      const uint32_t s_end = session_start[s] + session_ms[s];
+      const uint32_t lo = (session_start[s] > start) ? session_start[s] : start;
+      const uint32_t hi = (s_end < end) ? s_end : end;
+      if (hi > lo)
+        session_overlap += hi - lo;
+    }
+    for (uint32_t r = 0U; r < runs; r++) {
+      const uint32_t r_end = run_start[r] + SELF_HEATING_EVAL_RUN_MS;
+      const uint32_t lo = (run_start[r] > start) ? run_start[r] : start;
+      const uint32_t hi = (r_end < end) ? r_end : end;
+      if (hi > lo)
+        run_overlap += hi - lo;
+    }
+    if (session_overlap > SELF_HEATING_EVAL_PERIOD_MS)
+      session_overlap = SELF_HEATING_EVAL_PERIOD_MS;
+
+    SelfHeatingActivity_t *a = &s_samples[i].activity;
+    a->period_ms = SELF_HEATING_EVAL_PERIOD_MS;
+    a->cpu_permille = (uint16_t)(25U + next_random(&state) % 10U +
+                                 (330U * session_overlap) /
+                                     SELF_HEATING_EVAL_PERIOD_MS);
+    a->display_bps = (uint16_t)(20U + (2500U * session_overlap) /
+                                          SELF_HEATING_EVAL_PERIOD_MS);
+    a->motor_ma =
+        (uint16_t)((SELF_HEATING_EVAL_RUN_MA * run_overlap) /
+                   SELF_HEATING_EVAL_PERIOD_MS);
+
+    /* The board heats continuously, unlike the discretised model */
+    const double decay =
+        exp(-(double)SELF_HEATING_EVAL_PERIOD_MS /
+            ((double)s_true_params.tau_s * 1000.0));
+    double rise = 0.0;
+    for (uint32_t k = 0U; k < SELF_HEATING_SOURCE_COUNT; k++) {
+      const double target =
+          (double)SelfHeating_ActivityQ16(a, (SelfHeatingSource_t)k) /
+          65536.0;
+      lag[k] = target + (lag[k] - target) * decay;
+      rise += true_cdeg[k] * lag[k];
+    }
+    room += (room_target_cdeg(end) - room) *
+            (1.0 - exp(-(double)SELF_HEATING_EVAL_PERIOD_MS / 5400000.0));
+
+    const int32_t noise =
+        (int32_t)(next_random(&state) % (2U * SELF_HEATING_EVAL_NOISE_CDEG +
+                                         1U)) -
+        SELF_HEATING_EVAL_NOISE_CDEG;
+    s_samples[i].t_ms = end;
+    s_samples[i].rise_cdeg = rise;
+    s_samples[i].measured_cdeg = (int32_t)lround(room + rise) + noise;
+  }
+  return count;
+}
+
+int HostSim_SelfHeatingEval(void) {
+  const uint32_t count = synthesize();
+
+  printf("Self-heating evaluation: %u synthetic days, true tau %u s, "
+         "cpu %d, display %d, motor %d cdeg\n",
+         (unsigned)SELF_HEATING_EVAL_DAYS, s_true_params.tau_s,
+         s_true_params.cpu_cdeg, s_true_params.display_cdeg,
+         s_true_params.motor_cdeg);
+  SelfHeatingEvalResult_t results[3];
+  run(results, count, true);
+
+  const bool pass = results[2].rise_err_cdeg <
+                    SELF_HEATING_EVAL_MAX_RATIO * results[0].rise_err_cdeg;
+  if (!pass) {
+    printf("Self-heating evaluation failed: fitted error %.2f cdeg, "
+           "uncompensated %.2f cdeg\n",
+           results[2].rise_err_cdeg, results[0].rise_err_cdeg);
+  }
+  return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,376 @@
+/**
+ ******************************************************************************
+ * @file           :  window_eval.c
+ * @brief          :  Offline evaluation of the open-window detection on
+ *                    simulated room traces (--window-eval).
+ *
+ * @details        :  Plays a set of room temperature traces through the ADC
+ *                    conversion, the temperature filter and the sampling
+ *                    policy the sensor task uses, the slope ring it keeps
+ *                    and the detector the system state machine runs once a
+ *                    second. The traces follow what a thermostat on the
+ *                    radiator sees:
+ *                    - window traces: the room falls exponentially towards
+ *                      the outside temperature while the window is open and
+ *                      warms back towards its setpoint after it is closed,
+ *                      from airing with the window wide open in frost to a
+ *                      tilted window on a mild day;
+ *                    - other traces: night setback, controller ripple,
+ *                      sun and cloud, a door draught, and a quiet day.
+ *                    Each trace runs WINDOW_EVAL_SEEDS times with a
+ *                    different sensor noise sequence. For each it reports:
+ *                      missed    windows not reported
+ *                      detected  mean and worst time from opening the
+ *                                window to the report, in s; a report up
+ *                                to WINDOW_EVAL_LATE_S after closing still
+ *                                counts, as the room is still recovering
+ *                                from the airing
+ *                      resumed   mean time from closing the window to the
+ *                                resume, in s, and how many resumed on the
+ *                                timeout rather than the rise
+ *                      false     reports outside the window
+ *                    followed by one "WINDOW {...}" JSON line per trace and
+ *                    the false reports per simulated day. Fails if a
+ *                    required window is missed or reported later than
+ *                    WINDOW_EVAL_MAX_LATENCY_S, or on more than
+ *                    WINDOW_EVAL_MAX_FALSE_PER_DAY false reports. Airing
+ *                    shorter than the latency and a tilted window on a
+ *                    mild day cool too little to be required. No
+ *                    scheduler is started.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 MiraTherm.
+ * This file is licensed under GPL-3.0 License.
+ * For details, see the LICENSE file in the project root directory.
+ *
+ ******************************************************************************
+ */
+#include "host_sim.h"
+
+#include "sensor_calc.h"
+#include "sensor_filter.h"
+#include "sensor_sampling.h"
+#include "stm32wbxx_ll_adc.h"
+#include "window_detect.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define WINDOW_EVAL_VDDA_MV 3000U
+#define WINDOW_EVAL_SOC 80U
+#define WINDOW_EVAL_SETPOINT_CDEG 2100
+#define WINDOW_EVAL_MAX_LATENCY_S 1200U
+#define WINDOW_EVAL_LATE_S 1800U
+#define WINDOW_EVAL_SEEDS 16U
+#define WINDOW_EVAL_MAX_FALSE_PER_DAY 0.05
+#define WINDOW_EVAL_NO_TIME UINT32_MAX
+
+typedef enum {
+  WINDOW_EVAL_WINDOW = 0, /* Window open from start_s for length_s */
+  WINDOW_EVAL_SETBACK,    /* Valve closed at start_s, slow cooling */
+  WINDOW_EVAL_RIPPLE,     /* On/off controller ripple of amplitude_cdeg */
+  WINDOW_EVAL_SUN,        /* Sun, then a cloud at start_s */
+  WINDOW_EVAL_DRAUGHT,    /* Door draught dip of amplitude_cdeg */
+  WINDOW_EVAL_QUIET,      /* Constant room */
+} WindowEvalKind_t;
+
+typedef struct {
+  const char *name;
+  WindowEvalKind_t kind;
+  bool required; /* Window that must be reported in time */
+  uint32_t duration_s;
+  uint32_t start_s;
+  uint32_t length_s;
+  int32_t outside_cdeg;   /* Temperature the room falls towards */
+  uint32_t tau_s;         /* Time constant of the fall */
+  int32_t amplitude_cdeg; /* Ripple, sun or draught size */
+} WindowEvalTrace_t;
+
+typedef struct {
+  uint32_t detected_s; /* Report after opening, WINDOW_EVAL_NO_TIME if none */
+  uint32_t resumed_s;  /* Resume after closing */
+  bool timeout;        /* Resumed on the timeout */
+  uint32_t false_reports;
+} WindowEvalResult_t;
+
+static const WindowEvalTrace_t s_traces[] = {
+    {"wide_open_frost", WINDOW_EVAL_WINDOW, true, 3U * 3600U, 3600U, 600U, 0,
+     2400U, 0},
+    {"short_airing", WINDOW_EVAL_WINDOW, false, 3U * 3600U, 3600U, 300U, 200,
+     2400U, 0},
+    {"tilted", WINDOW_EVAL_WINDOW, true, 3U * 3600U, 3600U, 1800U, 500, 5400U,
+     0},
+    {"tilted_mild", WINDOW_EVAL_WINDOW, false, 3U * 3600U, 3600U, 1800U, 1200,
+     5400U, 0},
+    {"setback", WINDOW_EVAL_SETBACK, false, 8U * 3600U, 3600U, 0U, 1000,
+     18000U, 0},
+    {"ripple", WINDOW_EVAL_RIPPLE, false, 8U * 3600U, 0U, 720U, 0, 0U, 25},
+    {"sun_cloud", WINDOW_EVAL_SUN, false, 4U * 3600U, 2U * 3600U, 900U, 0, 0U,
+     200},
+    {"door_draught", WINDOW_EVAL_DRAUGHT, false, 2U * 3600U, 3600U, 120U, 0,
+     300U, 40},
+    {"quiet_day", WINDOW_EVAL_QUIET, false, 24U * 3600U, 0U, 0U, 0, 0U, 0},
+};
+
+#define WINDOW_EVAL_TRACE_COUNT (sizeof(s_traces) / sizeof(s_traces[0]))
+
+static int32_t triangle(uint32_t t, uint32_t period_s, int32_t amplitude) {
+  const uint32_t phase = t % period_s;
+  const int32_t half = (int32_t)(period_s / 2U);
+  const int32_t x = (phase < (uint32_t)half)
+                        ? (int32_t)phase
+                        : (int32_t)period_s - (int32_t)phase;
+  return -amplitude + (2 * amplitude * x) / half;
+}
+
+/* Room temperature in centidegrees at second @p t of a trace */
+static int32_t room_cdeg(const WindowEvalTrace_t *trace, uint32_t t) {
+  const double base = WINDOW_EVAL_SETPOINT_CDEG;
+  switch (trace->kind) {
+  case WINDOW_EVAL_WINDOW: {
+    if (t < trace->start_s) {
+      return (int32_t)base;
+    }
+    const double out = trace->outside_cdeg;
+    const double open_s = (double)(t - trace->start_s);
+    if (t < trace->start_s + trace->length_s) {
+      return (int32_t)lround(out + (base - out) * exp(-open_s / trace->tau_s));
+    }
+    /* Closed: the walls and the radiator bring the air back within about
+       half an hour */
+    const double closed = out + (base - out) * exp(-(double)trace->length_s /
+                                                   trace->tau_s);
+    const double since = (double)(t - trace->start_s - trace->length_s);
+    return (int32_t)lround(base - (base - closed) * exp(-since / 900.0));
+  }
+  case WINDOW_EVAL_SETBACK:
+    if (t < trace->start_s) {
+      return (int32_t)base;
+    }
+    return (int32_t)lround(trace->outside_cdeg +
+                           (base - trace->outside_cdeg) *
+                               exp(-(double)(t - trace->start_s) /
+                                   trace->tau_s));
+  case WINDOW_EVAL_RIPPLE:
+    return (int32_t)base + triangle(t, trace->length_s, trace->amplitude_cdeg);
+  case WINDOW_EVAL_SUN: {
+    /* Warms by amplitude over the first hour, a cloud takes half of it
+       back within length_s */
+    const int32_t sun = (t < 3600U)
+                            ? (int32_t)((trace->amplitude_cdeg * (int32_t)t) /
+                                        3600)
+                            : trace->amplitude_cdeg;
+    if (t < trace->start_s) {
+      return (int32_t)base + sun;
+    }
+    const uint32_t since = t - trace->start_s;
+    const int32_t cloud =
+        (since < trace->length_s)
+            ? (int32_t)((trace->amplitude_cdeg / 2) * (int32_t)since /
+                        (int32_t)trace->length_s)
+            : trace->amplitude_cdeg / 2;
+    return (int32_t)base + sun - cloud;
+  }
+  case WINDOW_EVAL_DRAUGHT: {
+    /* Falls by amplitude within length_s, back within tau_s */
+    if (t < trace->start_s) {
+      return (int32_t)base;
+    }
+    const uint32_t since = t - trace->start_s;
+    if (since < trace->length_s) {
+      return (int32_t)base - (trace->amplitude_cdeg * (int32_t)since) /
+                                 (int32_t)trace->length_s;
+    }
+    if (since < trace->length_s + trace->tau_s) {
+      return (int32_t)base - trace->amplitude_cdeg +
+             (trace->amplitude_cdeg * (int32_t)(since - trace->length_s)) /
+                 (int32_t)trace->tau_s;
+    }
+    return (int32_t)base;
+  }
+  case WINDOW_EVAL_QUIET:
+  default:
+    return (int32_t)base;
+  }
+}
+
+/* What the sensor task would compute from one ADC sequence: the die
+   temperature is quantised by the 12-bit conversion and dithered by a
+   deterministic +-1 LSB of noise, as in sampling_eval.c */
+static int32_t measure_cdeg(int32_t room, uint32_t *noise_state) {
+  const int32_t ts_cal1 = (int32_t)*TEMPSENSOR_CAL1_ADDR;
+  const int32_t ts_cal2 = (int32_t)*TEMPSENSOR_CAL2_ADDR;
+  const int32_t cal_span =
+      (int32_t)(TEMPSENSOR_CAL2_TEMP - TEMPSENSOR_CAL1_TEMP) * 100;
+  const int32_t scaled =
+      ts_cal1 + ((room - (int32_t)TEMPSENSOR_CAL1_TEMP * 100) *
+                 (ts_cal2 - ts_cal1)) /
+                    cal_span;
+  *noise_state = *noise_state * 1103515245U + 12345U;
+  const int32_t noise = (int32_t)((*noise_state >> 16) % 3U) - 1;
+  const int32_t raw = (scaled * (int32_t)TEMPSENSOR_CAL_VREFANALOG) /
+                          (int32_t)WINDOW_EVAL_VDDA_MV +
+                      noise;
+  return SensorCalc_TemperatureCenti((uint16_t)raw, WINDOW_EVAL_VDDA_MV);
+}
+
+static void run(const WindowEvalTrace_t *trace, uint32_t seed,
+                WindowEvalResult_t *result) {
+  SensorFilter_t filter;
+  SensorSampling_t sampling;
+  WindowSlope_t slope;
+  WindowDetect_t detect;
+  SensorFilter_Init(&filter, NULL);
+  SensorSampling_Init(&sampling);
+  WindowSlope_Init(&slope);
+  WindowDetect_Init(&detect);
+
+  const bool window = (trace->kind == WINDOW_EVAL_WINDOW);
+  const uint32_t close_s = trace->start_s + trace->length_s;
+  uint32_t noise_state = seed;
+  uint32_t next_sample_ms = 0U;
+  uint32_t last_sample_ms = 0U;
+  int32_t published = 0;
+  int16_t published_slope = WINDOW_DETECT_NO_SLOPE;
+  bool open = false;
+
+  result->detected_s = WINDOW_EVAL_NO_TIME;
+  result->resumed_s = WINDOW_EVAL_NO_TIME;
+  result->timeout = false;
+  result->false_reports = 0U;
+
+  for (uint32_t t = 0U; t < trace->duration_s; t++) {
+    const uint32_t t_ms = t * 1000U;
+
+    /* Sensor task: measure, filter, publish the slope, pick the period */
+    if (t_ms >= next_sample_ms) {
+      published = SensorFilter_Update(
+          &filter, measure_cdeg(room_cdeg(trace, t), &noise_state),
+          t_ms - last_sample_ms);
+      last_sample_ms = t_ms;
+      WindowSlope_Add(&slope, t_ms, published);
+      published_slope = WindowSlope_Get(&slope);
+      const SensorSamplingInput_t input = {
+          .temperature_cdeg = published,
+          .setpoint_cdeg = open ? 450 : WINDOW_EVAL_SETPOINT_CDEG,
+          .soc = WINDOW_EVAL_SOC,
+          .user_active = false,
+      };
+      next_sample_ms = t_ms + SensorSampling_Update(&sampling, &input, t_ms);
+    }
+
+    /* System state machine */
+    const WindowDetectEvent_t event =
+        WindowDetect_Update(&detect, t_ms, published, published_slope);
+    if (event == WINDOW_DETECT_OPENED) {
+      open = true;
+      const bool during =
+          window && t >= trace->start_s && t < close_s + WINDOW_EVAL_LATE_S;
+      if (during && result->detected_s == WINDOW_EVAL_NO_TIME) {
+        result->detected_s = t - trace->start_s;
+      } else if (!during) {
+        result->false_reports++;
+      }
+    } else if (event == WINDOW_DETECT_CLOSED ||
+               event == WINDOW_DETECT_TIMEOUT) {
+      open = false;
+      if (window && t >= close_s && result->detected_s != WINDOW_EVAL_NO_TIME &&
+          result->resumed_s == WINDOW_EVAL_NO_TIME) {
+        result->resumed_s = t - close_s;
+        result->timeout = (event == WINDOW_DETECT_TIMEOUT);
+      }
+    }
+  }
+}
+
+int HostSim_WindowEval(void) {
+  uint32_t false_reports = 0U;
+  uint64_t negative_s = 0U;
+  bool ok = true;
+
+  printf("Window evaluation: drop %d cdeg/min over %lu s, recover %d cdeg, "
+         "timeout %lu s, %u noise seeds\n",
+         (int)WINDOW_DETECT_DROP_CDEG_PER_MIN,
+         (unsigned long)(WINDOW_DETECT_SPAN_MS / 1000U),
+         (int)WINDOW_DETECT_RECOVER_CDEG,
+         (unsigned long)(WINDOW_DETECT_TIMEOUT_MS / 1000U),
+         (unsigned)WINDOW_EVAL_SEEDS);
+  printf("%-16s %6s %8s %8s %8s %8s %6s\n", "trace", "missed", "detected",
+         "worst", "resumed", "timeouts", "false");
+  for (uint32_t i = 0U; i < WINDOW_EVAL_TRACE_COUNT; i++) {
+    const WindowEvalTrace_t *trace = &s_traces[i];
+    const bool window = (trace->kind == WINDOW_EVAL_WINDOW);
+    uint32_t missed = 0U;
+    uint32_t detected = 0U;
+    uint64_t detected_sum_s = 0U;
+    uint32_t detected_max_s = 0U;
+    uint32_t resumed = 0U;
+    uint64_t resumed_sum_s = 0U;
+    uint32_t timeouts = 0U;
+    uint32_t trace_false = 0U;
+
+    for (uint32_t seed = 1U; seed <= WINDOW_EVAL_SEEDS; seed++) {
+      WindowEvalResult_t r;
+      run(trace, seed, &r);
+      trace_false += r.false_reports;
+      if (window && r.detected_s == WINDOW_EVAL_NO_TIME) {
+        missed++;
+      } else if (window) {
+        detected++;
+        detected_sum_s += r.detected_s;
+        if (r.detected_s > detected_max_s) {
+          detected_max_s = r.detected_s;
+        }
+      }
+      if (r.resumed_s != WINDOW_EVAL_NO_TIME) {
+        resumed++;
+        resumed_sum_s += r.resumed_s;
+        timeouts += r.timeout ? 1U : 0U;
+      }
+    }
+
+    const double mean_detected_s =
+        (detected != 0U) ? (double)detected_sum_s / detected : 0.0;
+    const double mean_resumed_s =
+        (resumed != 0U) ? (double)resumed_sum_s / resumed : 0.0;
+    if (window) {
+      printf("%-16s %6lu %8.0f %8lu %8.0f %8lu %6lu\n", trace->name,
+             (unsigned long)missed, mean_detected_s,
+             (unsigned long)detected_max_s, mean_resumed_s,
+             (unsigned long)timeouts, (unsigned long)trace_false);
+    } else {
+      printf("%-16s %6s %8s %8s %8s %8s %6lu\n", trace->name, "", "", "", "",
+             "", (unsigned long)trace_false);
+    }
+    printf("WINDOW {\"trace\":\"%s\",\"window\":%s,\"required\":%s,"
+           "\"runs\":%u,\"missed\":%lu,\"mean_detected_s\":%.0f,"
+           "\"max_detected_s\":%lu,\"mean_resumed_s\":%.0f,"
+           "\"timeouts\":%lu,\"false_reports\":%lu}\n",
+           trace->name, window ? "true" : "false",
+           trace->required ? "true" : "false", (unsigned)WINDOW_EVAL_SEEDS,
+           (unsigned long)missed, mean_detected_s,
+           (unsigned long)detected_max_s, mean_resumed_s,
+           (unsigned long)timeouts, (unsigned long)trace_false);
+
+    false_reports += trace_false;
+    if (window) {
+      ok = ok && (!trace->required ||
+                  (missed == 0U &&
+                   detected_max_s <= WINDOW_EVAL_MAX_LATENCY_S));
+      negative_s += (uint64_t)WINDOW_EVAL_SEEDS *
+                    (trace->duration_s - trace->length_s - WINDOW_EVAL_LATE_S);
+    } else {
+      negative_s += (uint64_t)WINDOW_EVAL_SEEDS * trace->duration_s;
+    }
+  }
+
+  const double days = (double)negative_s / 86400.0;
+  const double per_day = (double)false_reports / days;
+  printf("false reports: %lu in %.1f simulated days (%.3f per day)\n",
+         (unsigned long)false_reports, days, per_day);
+  ok = ok && per_day <= WINDOW_EVAL_MAX_FALSE_PER_DAY;
+  printf("window eval: %s\n", ok ? "PASS" : "FAIL");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
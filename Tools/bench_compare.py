@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 MiraTherm.
+# This file is licensed under GPL-3.0 License.
+# For details, see the LICENSE file in the project root directory.
+#
+"""Compare BENCH lines (Core/Inc/benchmarks.h) with stored baselines.
+
+Reads a UART log or the output of the host build's --bench option, prints
+the cycles per call of every kernel next to its baseline and exits with
+status 1 if any kernel is slower than the baseline by more than the
+platform tolerance, or if a CHECK line reports mismatches:
+
+    ./build/Host/miratherm-radiator-thermostat-software --bench | \\
+        python3 Tools/bench_compare.py
+    python3 Tools/bench_compare.py uart.log --update
+"""
+
+import argparse
+import json
+import os
+import sys
+
+DEFAULT_BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "bench_baseline.json")
+# Relative slow-down flagged as a regression unless the baseline file sets
+# its own; DWT counts on target are exact, host timings are noisy
+DEFAULT_TOLERANCE = {"stm32wb55": 0.05, "host": 0.50}
+
+
+def parse(line, tag):
+    start = line.find(tag + " {")
+    if start < 0:
+        return None
+    try:
+        return json.loads(line[start + len(tag) + 1:])
+    except json.JSONDecodeError:
+        return None
+
+
+def read_results(stream):
+    results, failed_checks = {}, []
+    for line in stream:
+        entry = parse(line, "BENCH")
+        if entry is not None:
+            platform = results.setdefault(entry["platform"], {})
+            platform[entry["kernel"]] = float(entry["cycles_per_call"])
+            continue
+        check = parse(line, "CHECK")
+        if check is not None and check["mismatches"]:
+            failed_checks.append(check)
+    return results, failed_checks
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="?", default="-",
+                        help="log with BENCH lines (default: stdin)")
+    parser.add_argument("-b", "--baseline", default=DEFAULT_BASELINE,
+                        help="baseline JSON file (default: %(default)s)")
+    parser.add_argument("-u", "--update", action="store_true",
+                        help="store the results as the new baselines")
+    args = parser.parse_args()
+
+    log = sys.stdin if args.log == "-" else open(args.log, encoding="utf-8",
+                                                 errors="replace")
+    with log:
+        results, failed_checks = read_results(log)
+    if not results:
+        sys.exit("bench_compare: no BENCH lines found")
+
+    try:
+        with open(args.baseline, encoding="utf-8") as f:
+            baseline = json.load(f)
+    except FileNotFoundError:
+        baseline = {}
+
+    if args.update:
+        for platform, kernels in results.items():
+            stored = baseline.setdefault(platform, {})
+            stored.setdefault("tolerance",
+                              DEFAULT_TOLERANCE.get(platform, 0.10))
+            stored.setdefault("cycles_per_call", {}).update(kernels)
+        with open(args.baseline, "w", encoding="utf-8") as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print(f"bench_compare: baselines updated in {args.baseline}")
+        return
+
+    regressions = 0
+    for platform, kernels in sorted(results.items()):
+        stored = baseline.get(platform, {})
+        tolerance = stored.get("tolerance",
+                               DEFAULT_TOLERANCE.get(platform, 0.10))
+        reference = stored.get("cycles_per_call", {})
+        print(f"{platform} (tolerance {tolerance:.0%})")
+        print(f"  {'kernel':<18} {'cycles/call':>12} {'baseline':>10} "
+              f"{'change':>8}")
+        for kernel, value in sorted(kernels.items()):
+            base = reference.get(kernel)
+            if base is None:
+                print(f"  {kernel:<18} {value:>12.3f} {'-':>10} {'new':>8}")
+                continue
+            change = (value - base) / base if base > 0 else 0.0
+            flag = ""
+            if change > tolerance:
+                flag = "  REGRESSION"
+                regressions += 1
+            print(f"  {kernel:<18} {value:>12.3f} {base:>10.3f} "
+                  f"{change:>+8.1%}{flag}")
+
+    for check in failed_checks:
+        print(f"bench_compare: check {check['check']} on {check['platform']}: "
+              f"{check['mismatches']} of {check['cases']} cases differ")
+    if regressions:
+        print(f"bench_compare: {regressions} regression(s)")
+    if regressions or failed_checks:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
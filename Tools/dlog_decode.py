@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 MiraTherm.
+# This file is licensed under GPL-3.0 License.
+# For details, see the LICENSE file in the project root directory.
+#
+"""Decode DEFERRED_LOG_BINARY output (Core/Inc/log_task.h) back to text.
+
+Reads a UART log, replaces every "DL <tick> <fmt> <args...>" line with the
+formatted message and passes all other lines through unchanged. Format
+strings and %s arguments are read from the firmware ELF, which must be the
+exact build that produced the log:
+
+    python3 Tools/dlog_decode.py build/Debug/miratherm-radiator-thermostat-software.elf uart.log
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SPEC = re.compile(
+    r"%([-+ #0]*)(\d+)?(?:\.(\d+))?(?:hh|h|ll|l|L|q|j|z|t)?([diouxXeEfFgGcsp%])")
+DL_LINE = re.compile(r"^DL ([0-9a-f]+) ([0-9a-f]+)((?: [0-9a-f]+)*)\s*$")
+
+
+class Elf:
+    """Loadable sections of an ELF file, enough to read constant strings."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError(f"{path} is not an ELF file")
+        is64 = self.data[4] == 2
+        if self.data[5] != 1:
+            raise ValueError("only little-endian ELF files are supported")
+
+        if is64:
+            shoff, = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x3A)
+            header = "<IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+            header = "<IIIIIIIIII"
+
+        self.sections = []
+        for i in range(shnum):
+            fields = struct.unpack_from(header, self.data, shoff + i * shentsize)
+            sh_type, sh_addr, sh_offset, sh_size = (fields[1], fields[3],
+                                                    fields[4], fields[5])
+            # Skip SHT_NULL and SHT_NOBITS (.bss), keep sections with an address
+            if sh_type not in (0, 8) and sh_addr != 0:
+                self.sections.append((sh_addr, sh_size, sh_offset))
+
+    def string(self, address):
+        for sh_addr, sh_size, sh_offset in self.sections:
+            if sh_addr <= address < sh_addr + sh_size:
+                start = sh_offset + (address - sh_addr)
+                end = self.data.index(b"\0", start)
+                return self.data[start:end].decode("utf-8", "replace")
+        raise KeyError(f"address 0x{address:x} not in the ELF")
+
+
+def to_float(word):
+    return struct.unpack("<f", struct.pack("<I", word & 0xFFFFFFFF))[0]
+
+
+def to_int32(word):
+    word &= 0xFFFFFFFF
+    return word - (1 << 32) if word & 0x80000000 else word
+
+
+def format_message(elf, fmt, args):
+    args = iter(args)
+
+    def convert(match):
+        flags, width, precision, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        word = next(args, 0)
+        spec = "%" + flags + (width or "")
+        if precision is not None:
+            spec += "." + precision
+        if conversion in "di":
+            return (spec + "d") % to_int32(word)
+        if conversion == "u":
+            return (spec + "d") % (word & 0xFFFFFFFF)
+        if conversion in "xXo":
+            return (spec + conversion) % (word & 0xFFFFFFFF)
+        if conversion in "eEfFgG":
+            return (spec + conversion) % to_float(word)
+        if conversion == "c":
+            return (spec + "c") % chr(word & 0xFF)
+        if conversion == "s":
+            try:
+                return (spec + "s") % elf.string(word)
+            except KeyError:
+                return f"<str@0x{word:x}>"
+        return (spec + "s") % f"0x{word:x}"  # %p
+
+    return SPEC.sub(convert, fmt)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware ELF matching the log")
+    parser.add_argument("log", nargs="?", default="-",
+                        help="UART log (default: stdin)")
+    parser.add_argument("-t", "--ticks", action="store_true",
+                        help="prefix decoded messages with the HAL tick")
+    args = parser.parse_args()
+
+    try:
+        elf = Elf(args.elf)
+    except (OSError, ValueError) as error:
+        sys.exit(f"dlog_decode: {error}")
+
+    log = sys.stdin if args.log == "-" else open(args.log, encoding="utf-8",
+                                                 errors="replace")
+    with log:
+        for line in log:
+            match = DL_LINE.match(line)
+            if not match:
+                sys.stdout.write(line)
+                continue
+            tick = int(match.group(1), 16)
+            words = [int(w, 16) for w in match.group(3).split()]
+            try:
+                text = format_message(elf, elf.string(int(match.group(2), 16)),
+                                      words)
+            except KeyError as error:
+                text = f"<undecodable: {error}>\n"
+            if args.ticks:
+                text = f"[{tick:>8}] {text}"
+            sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
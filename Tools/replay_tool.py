@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 MiraTherm.
+# This file is licensed under GPL-3.0 License.
+# For details, see the LICENSE file in the project root directory.
+#
+"""Extract and inspect record/replay traces (Core/Inc/replay.h).
+
+"extract" collects the "RPL <hex>" lines of a UART log recorded with
+REPLAY_RECORD_ENABLED into a binary trace for the host build's --replay
+option; "show" prints the records of a trace, one per line:
+
+    python3 Tools/replay_tool.py extract uart.log -o field.rpl
+    python3 Tools/replay_tool.py show field.rpl
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MAGIC = 0x5052544D  # "MTRP"
+VERSION = 2
+HEADER = struct.Struct("<IHHI")
+RECORD = struct.Struct("<BH")
+RPL_LINE = re.compile(r"RPL ([0-9a-f]+)\s*$")
+
+INPUT_NAMES = {0: "left", 1: "middle", 2: "right", 3: "wheel"}
+WEEKDAYS = {1: "Mon", 2: "Tue", 3: "Wed", 4: "Thu", 5: "Fri", 6: "Sat",
+            7: "Sun"}
+
+
+def payload_size(record_type, config_size):
+    return {1: 6, 2: 8, 3: 7, 4: 1 + config_size, 5: 4, 6: 4,
+            7: 10}.get(record_type)
+
+
+def describe(record_type, payload):
+    if record_type == 1:
+        event, action, delta, age = struct.unpack("<BBhH", payload)
+        name = INPUT_NAMES.get(event, f"input{event}")
+        if event == 3:
+            return f"input {name} {delta:+d} (age {age} ms)"
+        state = "pressed" if action else "released"
+        return f"input {name} {state} (age {age} ms)"
+    if record_type == 2:
+        vref, motor, temp, vbat = struct.unpack("<4H", payload)
+        return f"adc vref={vref} motor={motor} temp={temp} vbat={vbat}"
+    if record_type == 3:
+        hour, minute, second, weekday, day, month, year = payload
+        return (f"rtc 20{year:02d}-{month:02d}-{day:02d} "
+                f"{WEEKDAYS.get(weekday, '?')} {hour:02d}:{minute:02d}:"
+                f"{second:02d}")
+    if record_type == 4:
+        state = "valid" if payload[0] else "none (defaults)"
+        return f"config {state}, {len(payload) - 1} bytes"
+    if record_type == 5:
+        return "tick"
+    if record_type == 7:
+        period, cpu, display, motor = struct.unpack("<IHHH", payload)
+        return (f"activity {period} ms cpu={cpu / 10:.1f}% "
+                f"display={display} B/s motor={motor} mA")
+    return f"drop {struct.unpack('<I', payload)[0]} bytes lost"
+
+
+def show(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        sys.exit("replay_tool: trace too short")
+    magic, version, config_size, tick_hz = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        sys.exit(f"replay_tool: {path} is not a version {VERSION} trace")
+    print(f"# version {version}, config {config_size} bytes, "
+          f"tick {tick_hz} Hz")
+
+    offset, tick = HEADER.size, 0
+    while offset + RECORD.size <= len(data):
+        record_type, delta = RECORD.unpack_from(data, offset)
+        size = payload_size(record_type, config_size)
+        start = offset + RECORD.size
+        if size is None or start + size > len(data):
+            sys.exit(f"replay_tool: bad record at offset {offset}")
+        payload = data[start:start + size]
+        tick = (struct.unpack("<I", payload)[0] if record_type == 5
+                else tick + delta)
+        print(f"{tick:>10} {describe(record_type, payload)}")
+        offset = start + size
+
+
+def extract(log_path, out_path):
+    log = sys.stdin if log_path == "-" else open(log_path, encoding="utf-8",
+                                                 errors="replace")
+    trace = bytearray()
+    with log:
+        for line in log:
+            match = RPL_LINE.search(line)
+            if match:
+                trace += bytes.fromhex(match.group(1))
+    if len(trace) < HEADER.size or HEADER.unpack_from(trace)[0] != MAGIC:
+        sys.exit("replay_tool: no trace header in the log (RPL lines must "
+                 "start at boot)")
+    with open(out_path, "wb") as f:
+        f.write(trace)
+    print(f"{out_path}: {len(trace)} bytes")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+    extract_parser = commands.add_parser("extract",
+                                         help="UART log to binary trace")
+    extract_parser.add_argument("log", nargs="?", default="-",
+                                help="UART log (default: stdin)")
+    extract_parser.add_argument("-o", "--output", required=True,
+                                help="binary trace to write")
+    show_parser = commands.add_parser("show", help="print a trace")
+    show_parser.add_argument("trace", help="binary trace")
+    args = parser.parse_args()
+
+    if args.command == "extract":
+        extract(args.log, args.output)
+    else:
+        show(args.trace)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 MiraTherm.
+# This file is licensed under GPL-3.0 License.
+# For details, see the LICENSE file in the project root directory.
+#
+"""Convert a MiraTherm trace ring (Core/Inc/trace.h) to Chrome trace JSON.
+
+Input is either a UART log containing a Trace_Dump() block (the last
+complete TRACE BEGIN ... TRACE END block is used) or a binary RAM dump that
+contains g_trace_ring, e.g. from GDB:
+
+    dump binary value trace.bin g_trace_ring
+
+Open the output in chrome://tracing or https://ui.perfetto.dev.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+MAGIC = b"MTTR"
+HEADER = struct.Struct("<IHHIIIIHBB")
+EVENT = struct.Struct("<IHBB")
+
+# Fallback for RAM dumps, keep in sync with TraceId_t in trace.h
+SPAN_NAMES = [
+    "SystemSM_Run",
+    "Router_HandleEvent",
+    "Router_OnTick",
+    "lv_timer_handler",
+    "flush_cb",
+    "SensorLoop",
+    "write_config_to_flash",
+    "MutexWait",
+]
+MUTEX_WAIT = SPAN_NAMES.index("MutexWait")
+PHASES = {0: "B", 1: "E", 2: "i"}
+
+
+class Trace:
+    def __init__(self):
+        self.cpu_hz = 0
+        self.spans = dict(enumerate(SPAN_NAMES))
+        self.tasks = {}
+        self.objects = {}
+        self.events = []  # (cycles, arg, id, task byte), oldest first
+
+
+def c_string(raw):
+    return raw.split(b"\0", 1)[0].decode("ascii", "replace")
+
+
+def parse_ram_dump(data):
+    offset = data.find(MAGIC)
+    if offset < 0:
+        raise ValueError("no trace ring (magic MTTR) in dump")
+    (_, version, event_size, capacity, cpu_hz, count, _, name_len, max_tasks,
+     max_objects) = HEADER.unpack_from(data, offset)
+    if version != 1 or event_size != EVENT.size:
+        raise ValueError(f"unsupported trace ring v{version}/{event_size}")
+
+    trace = Trace()
+    trace.cpu_hz = cpu_hz
+    pos = offset + HEADER.size
+    for i in range(max_tasks):
+        name = c_string(data[pos:pos + name_len])
+        if name:
+            trace.tasks[i] = name
+        pos += name_len
+    for i in range(max_objects):
+        name = c_string(data[pos:pos + name_len])
+        if name:
+            trace.objects[i] = name
+        pos += name_len
+
+    if pos + capacity * event_size > len(data):
+        raise ValueError("dump is shorter than the trace ring")
+    first = max(0, count - capacity)
+    for n in range(first, count):
+        slot = pos + (n & (capacity - 1)) * event_size
+        trace.events.append(EVENT.unpack_from(data, slot))
+    return trace
+
+
+def parse_uart_log(text):
+    blocks = re.findall(r"TRACE BEGIN(.*?)TRACE END", text, re.S)
+    if not blocks:
+        raise ValueError("no complete TRACE BEGIN ... TRACE END block")
+
+    trace = Trace()
+    block = blocks[-1]
+    header = dict(re.findall(r"(\w+)=(\d+)", block.splitlines()[0]))
+    trace.cpu_hz = int(header["hz"])
+    if int(header.get("size", EVENT.size)) != EVENT.size:
+        raise ValueError("unsupported event size")
+
+    for line in block.splitlines()[1:]:
+        match = re.search(r"TRACE (SPAN|TASK|OBJ|DATA) (.*)", line)
+        if not match:
+            continue
+        kind, rest = match.group(1), match.group(2).strip()
+        if kind == "DATA":
+            raw = bytes.fromhex(rest)
+            trace.events.extend(
+                EVENT.unpack_from(raw, i)
+                for i in range(0, len(raw) - EVENT.size + 1, EVENT.size))
+        else:
+            index, _, name = rest.partition(" ")
+            table = {"SPAN": trace.spans, "TASK": trace.tasks,
+                     "OBJ": trace.objects}[kind]
+            table[int(index)] = name
+    return trace
+
+
+def to_chrome(trace):
+    if trace.cpu_hz == 0:
+        raise ValueError("trace was never started (cpu_hz=0)")
+
+    out = []
+    for tid, name in sorted(trace.tasks.items()):
+        out.append({"ph": "M", "name": "thread_name", "pid": 1, "tid": tid,
+                    "args": {"name": name}})
+
+    # Unwrap the 32-bit cycle counter; events reserved concurrently may be
+    # slightly out of order, hence the signed delta
+    cycles = 0
+    previous = None
+    open_spans = {}
+    for raw_cycles, arg, span, task_byte in trace.events:
+        if previous is not None:
+            delta = (raw_cycles - previous) & 0xFFFFFFFF
+            cycles += delta - (1 << 32) if delta & 0x80000000 else delta
+        previous = raw_cycles
+
+        tid = task_byte >> 2
+        phase = PHASES.get(task_byte & 0x3)
+        if phase is None:
+            continue
+        event = {"name": trace.spans.get(span, f"span{span}"), "ph": phase,
+                 "ts": cycles * 1e6 / trace.cpu_hz, "pid": 1, "tid": tid}
+
+        stack = open_spans.setdefault((tid, span), [])
+        if phase == "B":
+            stack.append(event)
+            if span == MUTEX_WAIT:
+                event["args"] = {"mutex": trace.objects.get(arg, f"#{arg}")}
+            else:
+                event["args"] = {"arg": arg}
+        elif phase == "E":
+            if not stack:
+                continue  # begin event already overwritten in the ring
+            stack.pop()
+            if span == MUTEX_WAIT:
+                event["args"] = {"acquired": bool(arg)}
+            else:
+                event["args"] = {"arg": arg}
+        else:
+            event["s"] = "t"
+            event["args"] = {"arg": arg}
+        out.append(event)
+
+    start = min((e["ts"] for e in out if "ts" in e), default=0.0)
+    for event in out:
+        if "ts" in event:
+            event["ts"] = round(event["ts"] - start, 3)
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="UART log or binary RAM dump")
+    parser.add_argument("-o", "--output", default="-",
+                        help="output JSON file (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    try:
+        if MAGIC in data:
+            trace = parse_ram_dump(data)
+        else:
+            trace = parse_uart_log(data.decode("utf-8", "replace"))
+        chrome = to_chrome(trace)
+    except ValueError as error:
+        sys.exit(f"trace2chrome: {error}")
+
+    if args.output == "-":
+        json.dump(chrome, sys.stdout)
+    else:
+        with open(args.output, "w") as f:
+            json.dump(chrome, f)
+    print(f"trace2chrome: {len(trace.events)} events, "
+          f"{len(trace.tasks)} tasks", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()